@@ -78,13 +78,14 @@ void vStartDeviceDefenderDemo( void )
 
 static void prvDefenderDemo( void * param )
 {
-    DefenderMetric_t xMetricsList[ 1 ];
+    DefenderMetric_t xMetricsList[ 2 ];
     int32_t lReportPeriodSec = 300;
     DefenderErr_t eInitStatus;
     DefenderErr_t ePeriodStatus;
     DefenderErr_t eStartStatus;
 
     xMetricsList[ 0 ] = xDefenderTCPConnections;
+    xMetricsList[ 1 ] = xDefenderListeningTCPPorts;
 
     /* Silence warning about unused param */
     ( void ) param;
@@ -48,4 +48,14 @@ BaseType_t xLoggingTaskInitialize( uint16_t usStackSize,
 void vLoggingPrintf( const char * pcFormat,
                      ... );
 
+/*
+ * Sends a string, without formatting, from an interrupt to the logging task.
+ * Only available when configLOGGING_ISR_RING_SLOTS is set to a power of two in
+ * FreeRTOSConfig.h, and only from interrupts of a single priority.  The string
+ * is truncated to configLOGGING_MAX_MESSAGE_LENGTH, and dropped if the logging
+ * task has too many strings from interrupts still to print.
+ */
+void vLoggingPrintFromISR( const char * pcMessage,
+                           BaseType_t * pxHigherPriorityTaskWoken );
+
 #endif /* AWS_LOGGING_TASK_H */
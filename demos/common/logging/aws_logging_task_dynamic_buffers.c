@@ -63,6 +63,24 @@
     #error configLOGGING_INCLUDE_TIME_AND_TASK_NAME must be defined in FreeRTOSConfig.h to use this logging file.  Set configLOGGING_INCLUDE_TIME_AND_TASK_NAME to 1 to prepend a time stamp, message number and the name of the calling task to each logged message.  Otherwise set to 0.
 #endif
 
+/* Messages logged from interrupts are passed to the logging task through a
+single producer single consumer ring of configLOGGING_ISR_RING_SLOTS slots,
+which must be a power of two, rather than through the queue.  Set to 0 to
+leave out vLoggingPrintFromISR(). */
+#ifndef configLOGGING_ISR_RING_SLOTS
+    #define configLOGGING_ISR_RING_SLOTS 0
+#endif
+
+/* The notification index on which the logging task waits for messages when
+the ring is used. */
+#ifndef configLOGGING_ISR_RING_NOTIFY_INDEX
+    #define configLOGGING_ISR_RING_NOTIFY_INDEX tskDEFAULT_INDEX_TO_NOTIFY
+#endif
+
+#if ( configLOGGING_ISR_RING_SLOTS > 0 )
+    #include "aws_spsc_ring.h"
+#endif
+
 /* A block time of 0 just means don't block. */
 #define loggingDONT_BLOCK 0
 
@@ -82,6 +100,11 @@
  */
 static void prvLoggingTask( void * pvParameters );
 
+/*
+ * Queues a log message for the logging task.
+ */
+static BaseType_t prvSendToLoggingTask( char *pcPrintString );
+
 /*-----------------------------------------------------------*/
 
 /*
@@ -90,6 +113,25 @@ static void prvLoggingTask( void * pvParameters );
  */
 static QueueHandle_t xQueue = NULL;
 
+#if ( configLOGGING_ISR_RING_SLOTS > 0 )
+
+    /*
+     * The ring used to pass messages from interrupts to the logging task.  The
+     * messages are copied into fixed size slots, so neither a heap allocation
+     * nor a queue operation is needed in the interrupt.  Only one interrupt
+     * priority may log, as the ring takes a single producer.
+     */
+    static SPSCRing_t xIsrRing;
+    static char cIsrSlots[ configLOGGING_ISR_RING_SLOTS ][ configLOGGING_MAX_MESSAGE_LENGTH ];
+
+#endif
+
+/*
+ * The logging task.  When the ring is used, task level senders notify it after
+ * queueing a message, as it waits on the ring rather than on the queue.
+ */
+static TaskHandle_t xLoggingTask = NULL;
+
 /*-----------------------------------------------------------*/
 
 BaseType_t xLoggingTaskInitialize( uint16_t usStackSize, UBaseType_t uxPriority, UBaseType_t uxQueueLength )
@@ -104,7 +146,13 @@ BaseType_t xLoggingTaskInitialize( uint16_t usStackSize, UBaseType_t uxPriority,
 
         if( xQueue != NULL )
         {
-            if( xTaskCreate( prvLoggingTask, "Logging", usStackSize, NULL, uxPriority, NULL ) == pdPASS )
+            #if ( configLOGGING_ISR_RING_SLOTS > 0 )
+            {
+                SPSCRING_Init( &xIsrRing, cIsrSlots, sizeof( cIsrSlots[ 0 ] ), configLOGGING_ISR_RING_SLOTS );
+            }
+            #endif
+
+            if( xTaskCreate( prvLoggingTask, "Logging", usStackSize, NULL, uxPriority, &xLoggingTask ) == pdPASS )
             {
                 xReturn = pdPASS;
             }
@@ -120,6 +168,38 @@ BaseType_t xLoggingTaskInitialize( uint16_t usStackSize, UBaseType_t uxPriority,
 }
 /*-----------------------------------------------------------*/
 
+#if ( configLOGGING_ISR_RING_SLOTS > 0 )
+
+static void prvLoggingTask( void *pvParameters )
+{
+    char *pcReceivedString = NULL;
+
+    /* Messages from interrupts wake this task through the ring, and messages
+    from tasks through a notification on the same index. */
+    SPSCRING_SetConsumer( &xIsrRing, xTaskGetCurrentTaskHandle(), configLOGGING_ISR_RING_NOTIFY_INDEX, 1 );
+
+    for( ;; )
+    {
+        ( void ) SPSCRING_Wait( &xIsrRing, portMAX_DELAY );
+
+        /* The messages are printed straight from the slots they were written
+        into. */
+        while( ( pcReceivedString = ( char * ) SPSCRING_AcquireRead( &xIsrRing ) ) != NULL )
+        {
+            configPRINT_STRING( pcReceivedString );
+            SPSCRING_ReleaseRead( &xIsrRing );
+        }
+
+        while( xQueueReceive( xQueue, &pcReceivedString, loggingDONT_BLOCK ) == pdPASS )
+        {
+            configPRINT_STRING( pcReceivedString );
+            vPortFree( ( void * ) pcReceivedString );
+        }
+    }
+}
+
+#else /* configLOGGING_ISR_RING_SLOTS */
+
 static void prvLoggingTask( void *pvParameters )
 {
     char *pcReceivedString = NULL;
@@ -134,6 +214,27 @@ static void prvLoggingTask( void *pvParameters )
         }
     }
 }
+
+#endif /* configLOGGING_ISR_RING_SLOTS */
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvSendToLoggingTask( char *pcPrintString )
+{
+    BaseType_t xReturn;
+
+    xReturn = xQueueSend( xQueue, &pcPrintString, loggingDONT_BLOCK );
+
+    #if ( configLOGGING_ISR_RING_SLOTS > 0 )
+    {
+        if( xReturn == pdPASS )
+        {
+            ( void ) xTaskNotifyGiveIndexed( xLoggingTask, configLOGGING_ISR_RING_NOTIFY_INDEX );
+        }
+    }
+    #endif
+
+    return xReturn;
+}
 /*-----------------------------------------------------------*/
 
 /*!
@@ -222,7 +323,7 @@ void vLoggingPrintf( const char *pcFormat, ... )
         if( xLength > 0 )
         {
             /* Send the string to the logging task for IO. */
-            if( xQueueSend( xQueue, &pcPrintString, loggingDONT_BLOCK ) != pdPASS )
+            if( prvSendToLoggingTask( pcPrintString ) != pdPASS )
             {
                 /* The buffer was not sent so must be freed again. */
                 vPortFree( ( void * ) pcPrintString );
@@ -255,10 +356,35 @@ void vLoggingPrint( const char * pcMessage )
         strncpy( pcPrintString, pcMessage, xLength );
 
         /* Send the string to the logging task for IO. */
-        if( xQueueSend( xQueue, &pcPrintString, loggingDONT_BLOCK ) != pdPASS )
+        if( prvSendToLoggingTask( pcPrintString ) != pdPASS )
         {
             /* The buffer was not sent so must be freed again. */
             vPortFree( ( void * ) pcPrintString );
         }
     }
 }
+/*-----------------------------------------------------------*/
+
+#if ( configLOGGING_ISR_RING_SLOTS > 0 )
+
+void vLoggingPrintFromISR( const char * pcMessage,
+                           BaseType_t * pxHigherPriorityTaskWoken )
+{
+    char * pcSlot;
+
+    /* The ring is initialized by xLoggingTaskInitialize(). */
+    configASSERT( xQueue );
+
+    pcSlot = ( char * ) SPSCRING_AcquireWrite( &xIsrRing );
+
+    /* The message is dropped if the ring is full, as an interrupt can not
+    wait for the logging task. */
+    if( pcSlot != NULL )
+    {
+        strncpy( pcSlot, pcMessage, configLOGGING_MAX_MESSAGE_LENGTH - 1 );
+        pcSlot[ configLOGGING_MAX_MESSAGE_LENGTH - 1 ] = '\0';
+        SPSCRING_CommitWriteFromISR( &xIsrRing, pxHigherPriorityTaskWoken );
+    }
+}
+
+#endif /* configLOGGING_ISR_RING_SLOTS */
@@ -76,10 +76,8 @@ typedef struct pthread_mutex_internal
  */
 typedef struct pthread_cond_internal
 {
-    BaseType_t xIsInitialized;            /**< Set to pdTRUE if this condition variable is initialized, pdFALSE otherwise. */
-    StaticSemaphore_t xCondMutex;         /**< Prevents concurrent accesses to iWaitingThreads. */
-    StaticSemaphore_t xCondWaitSemaphore; /**< Threads block on this semaphore in pthread_cond_wait. */
-    int iWaitingThreads;                  /**< The number of threads currently waiting on this condition variable. */
+    BaseType_t xIsInitialized; /**< Set to pdTRUE if this condition variable is initialized, pdFALSE otherwise. */
+    Link_t xWaitList;          /**< Threads waiting on this condition variable, newest first. */
 } pthread_cond_internal_t;
 
 /**
@@ -89,11 +87,46 @@ typedef struct pthread_cond_internal
     ( &( ( pthread_cond_internal_t )    \
     {                                   \
         .xIsInitialized = pdFALSE,      \
-        .xCondMutex = { { 0 } },        \
-        .xCondWaitSemaphore = { { 0 } },\
-        .iWaitingThreads = 0            \
+        .xWaitList = { 0 }              \
     }                                   \
          )                              \
     )
 
+#if posixconfigENABLE_PTHREAD_RWLOCK_T == 1
+/**
+ * @brief Read-write lock.
+ *
+ * Readers are counted in uxReaders and take no kernel object when no writer
+ * holds or waits for the lock. Writers serialize on xWriterMutex, a FreeRTOS
+ * mutex, so that threads blocked behind a writer raise its priority.
+ */
+typedef struct pthread_rwlock_internal
+{
+    BaseType_t xIsInitialized;        /**< Set to pdTRUE if this read-write lock is initialized, pdFALSE otherwise. */
+    StaticSemaphore_t xWriterMutex;   /**< Held by the writer; readers queue on it while uxWriters is nonzero. */
+    StaticSemaphore_t xReadersDone;   /**< Given by the last reader to unlock while a writer waits. */
+    UBaseType_t uxReaders;            /**< Number of threads holding a read lock. */
+    UBaseType_t uxWriters;            /**< Number of threads holding or waiting for the write lock. */
+    BaseType_t xWriterWaiting;        /**< Set to pdTRUE while the writer waits for readers to unlock. */
+    TaskHandle_t xWriter;             /**< Thread holding the write lock. */
+} pthread_rwlock_internal_t;
+
+/**
+ * @brief Compile-time initializer of pthread_rwlock_internal_t.
+ */
+#define FREERTOS_POSIX_RWLOCK_INITIALIZER \
+    ( &( ( pthread_rwlock_internal_t )    \
+    {                                     \
+        .xIsInitialized = pdFALSE,        \
+        .xWriterMutex = { { 0 } },        \
+        .xReadersDone = { { 0 } },        \
+        .uxReaders = 0,                   \
+        .uxWriters = 0,                   \
+        .xWriterWaiting = pdFALSE,        \
+        .xWriter = NULL                   \
+    }                                     \
+          )                               \
+    )
+#endif
+
 #endif /* _FREERTOS_POSIX_INTERNAL_H_ */
@@ -45,6 +45,20 @@
     #define posixconfigTIMER_NAME    "timer"
 #endif
 
+/**
+ * @brief The task notification index on which threads wait for a condition
+ * variable.
+ *
+ * When the kernel has more than one index per task, index 0 is left to the
+ * application, so that a signal is not consumed by an unrelated notification.
+ * Index 1 may be shared with the MQTT agent and FreeRTOS+TCP, as all of them
+ * ignore wake-ups they did not ask for.  This header is included before
+ * FreeRTOSConfig.h, so the choice is made where the index is used.
+ */
+#ifndef posixconfigNOTIFICATION_INDEX
+    #define posixconfigNOTIFICATION_INDEX    ( ( configTASK_NOTIFICATION_ARRAY_ENTRIES > 1 ) ? 1 : tskDEFAULT_INDEX_TO_NOTIFY )
+#endif
+
 /**
  * @defgroup Defaults for POSIX message queue implementation.
  */
@@ -56,6 +70,10 @@
 #ifndef posixconfigMQ_MAX_SIZE
     #define posixconfigMQ_MAX_SIZE    128 /**< Maximum size (in bytes) of each message. */
 #endif
+
+#ifndef posixconfigMQ_HASH_TABLE_SIZE
+    #define posixconfigMQ_HASH_TABLE_SIZE    8 /**< Number of buckets used to look up mqs by name and by descriptor. */
+#endif
 /**@} */
 
 /**
@@ -73,6 +91,9 @@
 #ifndef SEM_VALUE_MAX
     #define SEM_VALUE_MAX        0xFFFFU                                          /**< Maximum value of a sem_t. */
 #endif
+#ifndef MQ_PRIO_MAX
+    #define MQ_PRIO_MAX          32                                               /**< Number of message priorities supported, at most 32. */
+#endif
 /**@} */
 
 /**
@@ -109,6 +130,12 @@
 #ifndef posixconfigENABLE_PTHREAD_MUTEXATTR_T
     #define posixconfigENABLE_PTHREAD_MUTEXATTR_T    1 /**< pthread_mutexattr_t in sys/types.h */
 #endif
+#ifndef posixconfigENABLE_PTHREAD_RWLOCK_T
+    #define posixconfigENABLE_PTHREAD_RWLOCK_T       1 /**< pthread_rwlock_t in sys/types.h */
+#endif
+#ifndef posixconfigENABLE_PTHREAD_RWLOCKATTR_T
+    #define posixconfigENABLE_PTHREAD_RWLOCKATTR_T   1 /**< pthread_rwlockattr_t in sys/types.h */
+#endif
 #ifndef posixconfigENABLE_PTHREAD_T
     #define posixconfigENABLE_PTHREAD_T              1 /**< pthread_t in sys/types.h */
 #endif
@@ -38,11 +38,18 @@
 #include "FreeRTOS_POSIX/mqueue.h"
 #include "FreeRTOS_POSIX/utils.h"
 
+#if ( MQ_PRIO_MAX < 1 ) || ( MQ_PRIO_MAX > 32 )
+    #error MQ_PRIO_MAX must be between 1 and 32.
+#endif
+
 /**
- * @brief Element of the FreeRTOS queues that store mq data.
+ * @brief A message stored in an mq.
+ *
+ * The message data is allocated together with this header, right after it.
  */
 typedef struct QueueElement
 {
+    Link_t xLink;     /**< Link in the list of messages of the same priority. */
     char * pcData;    /**< Data in queue. Type char* to match msg_ptr. */
     size_t xDataSize; /**< Size of data pointed by pcData. */
 } QueueElement_t;
@@ -51,16 +58,25 @@ typedef struct QueueElement
  * @brief Data structure of an mq.
  *
  * FreeRTOS isn't guaranteed to have a file-like abstraction, so message
- * queues in this implementation are stored as a linked list (in RAM).
+ * queues in this implementation are stored in a hash table (in RAM).
+ *
+ * Messages are kept in one FIFO list per priority. Bit n of ulReadyPriorities
+ * is set while the list of priority n is not empty, so the highest priority
+ * message is found without looking at the messages themselves.
  */
 typedef struct QueueListElement
 {
-    Link_t xLink;              /**< Pointer to the next element in the list. */
-    QueueHandle_t xQueue;      /**< FreeRTOS queue handle. */
-    size_t xOpenDescriptors;   /**< Number of threads that have opened this queue. */
-    char * pcName;             /**< Null-terminated queue name. */
-    struct mq_attr xAttr;      /**< Queue attibutes. */
-    BaseType_t xPendingUnlink; /**< If pdTRUE, this queue will be unlinked once all descriptors close. */
+    Link_t xLink;                             /**< Link in the hash bucket of pcName. */
+    Link_t xDescriptorLink;                   /**< Link in the hash bucket of the descriptor. */
+    StaticSemaphore_t xMessagesWaiting;       /**< Counts the messages in the queue. */
+    StaticSemaphore_t xSpacesAvailable;       /**< Counts the free message slots. */
+    Link_t xMessageLists[ MQ_PRIO_MAX ];      /**< Messages, newest first, per priority. */
+    uint32_t ulReadyPriorities;               /**< Bitmap of the non-empty xMessageLists. */
+    size_t xOpenDescriptors;                  /**< Number of threads that have opened this queue. */
+    char * pcName;                            /**< Null-terminated queue name. */
+    uint32_t ulNameHash;                      /**< Hash of pcName. */
+    struct mq_attr xAttr;                     /**< Queue attibutes. */
+    BaseType_t xPendingUnlink;                /**< If pdTRUE, this queue will be unlinked once all descriptors close. */
 } QueueListElement_t;
 
 /*-----------------------------------------------------------*/
@@ -107,7 +123,8 @@ static void prvDeleteMessageQueue( const QueueListElement_t * const pxMessageQue
 /**
  * @brief Attempt to find the queue identified by pcName or xMqId in the queue list.
  *
- * Matches queues by pcName first; if pcName is NULL, matches by xMqId.
+ * Matches queues by pcName first; if pcName is NULL, matches by xMqId. Only
+ * the hash bucket of pcName or xMqId is searched.
  * @param[out] ppxQueueListElement Output parameter set when queue is found.
  * @param[in] pcName A queue name to match.
  * @param[in] xMessageQueueDescriptor A queue descriptor to match.
@@ -121,12 +138,65 @@ static BaseType_t prvFindQueueInList( QueueListElement_t ** const ppxQueueListEl
 /**
  * @brief Initialize the queue list.
  *
- * Performs initialization of the queue list mutex and queue list head.
+ * Performs initialization of the queue list mutex and hash table buckets.
  *
  * @return nothing
  */
 static void prvInitializeQueueList( void );
 
+/**
+ * @brief Calculate the hash of a queue name.
+ *
+ * @param[in] pcName The name to hash.
+ *
+ * @return The 32-bit FNV-1a hash of pcName.
+ */
+static uint32_t prvHashQueueName( const char * const pcName );
+
+/**
+ * @brief Get the hash table bucket of a queue descriptor.
+ *
+ * @param[in] xMessageQueueDescriptor The descriptor.
+ *
+ * @return Head of the bucket.
+ */
+static Link_t * prvDescriptorBucket( mqd_t xMessageQueueDescriptor );
+
+/**
+ * @brief Find the highest priority with pending messages.
+ *
+ * Takes the same number of steps regardless of the bitmap contents.
+ *
+ * @param[in] ulReadyPriorities Bitmap of non-empty priorities; must not be 0.
+ *
+ * @return The index of the most significant bit set in ulReadyPriorities.
+ */
+static UBaseType_t prvHighestReadyPriority( uint32_t ulReadyPriorities );
+
+/**
+ * @brief Add a message to the list of its priority.
+ *
+ * @param[in] pxMessageQueue The queue to add to.
+ * @param[in] pxQueueElement The message.
+ * @param[in] uxPriority The priority of the message.
+ *
+ * @return nothing
+ */
+static void prvEnqueueMessage( QueueListElement_t * const pxMessageQueue,
+                               QueueElement_t * const pxQueueElement,
+                               UBaseType_t uxPriority );
+
+/**
+ * @brief Remove the oldest message of the highest priority.
+ *
+ * @param[in] pxMessageQueue The queue to remove from; must not be empty.
+ * @param[out] puxPriority Output parameter for the priority of the message.
+ *
+ * @return The message.
+ */
+static QueueElement_t * prvDequeueMessage( QueueListElement_t * const pxMessageQueue,
+                                           UBaseType_t * puxPriority );
+
 /**
  * @brief Checks that pcName is a valid name for a message queue.
  *
@@ -145,9 +215,14 @@ static BaseType_t prvValidateQueueName( const char * const pcName,
 static StaticSemaphore_t xQueueListMutex = { { 0 }, .u = { 0 } };
 
 /**
- * @brief Head of the linked list of queues.
+ * @brief Hash table of queues, keyed by name.
+ */
+static Link_t xQueueNameTable[ posixconfigMQ_HASH_TABLE_SIZE ] = { { 0 } };
+
+/**
+ * @brief Hash table of queues, keyed by descriptor.
  */
-static Link_t xQueueListHead = { 0 };
+static Link_t xQueueDescriptorTable[ posixconfigMQ_HASH_TABLE_SIZE ] = { { 0 } };
 
 /*-----------------------------------------------------------*/
 
@@ -198,6 +273,7 @@ static BaseType_t prvCreateNewMessageQueue( QueueListElement_t ** ppxMessageQueu
                                             size_t xNameLength )
 {
     BaseType_t xStatus = pdTRUE;
+    UBaseType_t uxPriority = 0;
 
     /* Allocate space for a new queue element. */
     *ppxMessageQueue = pvPortMalloc( sizeof( QueueListElement_t ) );
@@ -208,20 +284,6 @@ static BaseType_t prvCreateNewMessageQueue( QueueListElement_t ** ppxMessageQueu
         xStatus = pdFALSE;
     }
 
-    /* Create the FreeRTOS queue. */
-    if( xStatus == pdTRUE )
-    {
-        ( *ppxMessageQueue )->xQueue =
-            xQueueCreate( pxAttr->mq_maxmsg, sizeof( QueueElement_t ) );
-
-        /* Check that queue creation succeeded. */
-        if( ( *ppxMessageQueue )->xQueue == NULL )
-        {
-            vPortFree( *ppxMessageQueue );
-            xStatus = pdFALSE;
-        }
-    }
-
     if( xStatus == pdTRUE )
     {
         /* Allocate space for the queue name plus null-terminator. */
@@ -230,7 +292,6 @@ static BaseType_t prvCreateNewMessageQueue( QueueListElement_t ** ppxMessageQueu
         /* Check that memory was successfully allocated for queue name. */
         if( ( *ppxMessageQueue )->pcName == NULL )
         {
-            vQueueDelete( ( *ppxMessageQueue )->xQueue );
             vPortFree( *ppxMessageQueue );
             xStatus = pdFALSE;
         }
@@ -244,6 +305,23 @@ static BaseType_t prvCreateNewMessageQueue( QueueListElement_t ** ppxMessageQueu
 
     if( xStatus == pdTRUE )
     {
+        /* Create the semaphores that senders and receivers block on. These
+         * calls will not fail because their storage is already allocated. */
+        ( void ) xSemaphoreCreateCountingStatic( ( UBaseType_t ) pxAttr->mq_maxmsg,
+                                                 0,
+                                                 &( *ppxMessageQueue )->xMessagesWaiting );
+        ( void ) xSemaphoreCreateCountingStatic( ( UBaseType_t ) pxAttr->mq_maxmsg,
+                                                 ( UBaseType_t ) pxAttr->mq_maxmsg,
+                                                 &( *ppxMessageQueue )->xSpacesAvailable );
+
+        /* Start with no messages at any priority. */
+        for( uxPriority = 0; uxPriority < MQ_PRIO_MAX; uxPriority++ )
+        {
+            listINIT_HEAD( &( *ppxMessageQueue )->xMessageLists[ uxPriority ] );
+        }
+
+        ( *ppxMessageQueue )->ulReadyPriorities = 0;
+
         /* Copy attributes. */
         ( *ppxMessageQueue )->xAttr = *pxAttr;
 
@@ -253,8 +331,12 @@ static BaseType_t prvCreateNewMessageQueue( QueueListElement_t ** ppxMessageQueu
         /* A newly-created queue will not be pending unlink. */
         ( *ppxMessageQueue )->xPendingUnlink = pdFALSE;
 
-        /* Add the new queue to the list. */
-        listADD( &xQueueListHead, &( *ppxMessageQueue )->xLink );
+        /* Add the new queue to both hash tables. */
+        ( *ppxMessageQueue )->ulNameHash = prvHashQueueName( pcName );
+        listADD( &xQueueNameTable[ ( *ppxMessageQueue )->ulNameHash % posixconfigMQ_HASH_TABLE_SIZE ],
+                 &( *ppxMessageQueue )->xLink );
+        listADD( prvDescriptorBucket( ( mqd_t ) *ppxMessageQueue ),
+                 &( *ppxMessageQueue )->xDescriptorLink );
     }
 
     return xStatus;
@@ -264,19 +346,22 @@ static BaseType_t prvCreateNewMessageQueue( QueueListElement_t ** ppxMessageQueu
 
 static void prvDeleteMessageQueue( const QueueListElement_t * const pxMessageQueue )
 {
-    QueueElement_t xQueueElement = { 0 };
+    UBaseType_t uxPriority = 0;
+    Link_t * pxMessageLink = NULL, * pxTempLink = NULL;
 
     /* Free all data in the queue. It's assumed that no more data will be added
-     * to the queue, so xQueueReceive does not block. */
-    while( xQueueReceive( pxMessageQueue->xQueue,
-                          ( void * ) &xQueueElement,
-                          0 ) == pdTRUE )
+     * to the queue, so the lists may be walked without a critical section. */
+    for( uxPriority = 0; uxPriority < MQ_PRIO_MAX; uxPriority++ )
     {
-        vPortFree( xQueueElement.pcData );
+        listFOR_EACH_SAFE( pxMessageLink, pxTempLink, &pxMessageQueue->xMessageLists[ uxPriority ] )
+        {
+            vPortFree( listCONTAINER( pxMessageLink, QueueElement_t, xLink ) );
+        }
     }
 
     /* Free memory used by this message queue. */
-    vQueueDelete( pxMessageQueue->xQueue );
+    vSemaphoreDelete( ( SemaphoreHandle_t ) &pxMessageQueue->xMessagesWaiting );
+    vSemaphoreDelete( ( SemaphoreHandle_t ) &pxMessageQueue->xSpacesAvailable );
     vPortFree( ( void * ) pxMessageQueue->pcName );
     vPortFree( ( void * ) pxMessageQueue );
 }
@@ -290,21 +375,35 @@ static BaseType_t prvFindQueueInList( QueueListElement_t ** const ppxQueueListEl
     Link_t * pxQueueListLink = NULL;
     QueueListElement_t * pxMessageQueue = NULL;
     BaseType_t xQueueFound = pdFALSE;
+    uint32_t ulNameHash = 0;
 
-    /* Iterate through the list of queues. */
-    listFOR_EACH( pxQueueListLink, &xQueueListHead )
+    /* Match by name first if provided. */
+    if( pcName != NULL )
     {
-        pxMessageQueue = listCONTAINER( pxQueueListLink, QueueListElement_t, xLink );
+        ulNameHash = prvHashQueueName( pcName );
 
-        /* Match by name first if provided. */
-        if( ( pcName != NULL ) && ( strcmp( pxMessageQueue->pcName, pcName ) == 0 ) )
+        /* Iterate through the queues whose names share a bucket. */
+        listFOR_EACH( pxQueueListLink, &xQueueNameTable[ ulNameHash % posixconfigMQ_HASH_TABLE_SIZE ] )
         {
-            xQueueFound = pdTRUE;
-            break;
+            pxMessageQueue = listCONTAINER( pxQueueListLink, QueueListElement_t, xLink );
+
+            /* Only compare the strings when the full hashes match. */
+            if( ( pxMessageQueue->ulNameHash == ulNameHash ) &&
+                ( strcmp( pxMessageQueue->pcName, pcName ) == 0 ) )
+            {
+                xQueueFound = pdTRUE;
+                break;
+            }
         }
-        /* If name doesn't match, match by descriptor. */
-        else
+    }
+    /* Otherwise, match by descriptor. */
+    else
+    {
+        /* Iterate through the queues whose descriptors share a bucket. */
+        listFOR_EACH( pxQueueListLink, prvDescriptorBucket( xMessageQueueDescriptor ) )
         {
+            pxMessageQueue = listCONTAINER( pxQueueListLink, QueueListElement_t, xDescriptorLink );
+
             if( ( mqd_t ) pxMessageQueue == xMessageQueueDescriptor )
             {
                 xQueueFound = pdTRUE;
@@ -328,6 +427,7 @@ static void prvInitializeQueueList( void )
 {
     /* Keep track of whether the queue list has been initialized. */
     static BaseType_t xQueueListInitialized = pdFALSE;
+    size_t xBucket = 0;
 
     /* Check if queue list needs to be initialized. */
     if( xQueueListInitialized == pdFALSE )
@@ -341,9 +441,15 @@ static void prvInitializeQueueList( void )
          * section. */
         if( xQueueListInitialized == pdFALSE )
         {
-            /* Initialize the queue list mutex and list head. */
+            /* Initialize the queue list mutex and hash table buckets. */
             ( void ) xSemaphoreCreateMutexStatic( &xQueueListMutex );
-            listINIT_HEAD( &xQueueListHead );
+
+            for( xBucket = 0; xBucket < posixconfigMQ_HASH_TABLE_SIZE; xBucket++ )
+            {
+                listINIT_HEAD( &xQueueNameTable[ xBucket ] );
+                listINIT_HEAD( &xQueueDescriptorTable[ xBucket ] );
+            }
+
             xQueueListInitialized = pdTRUE;
         }
 
@@ -354,6 +460,120 @@ static void prvInitializeQueueList( void )
 
 /*-----------------------------------------------------------*/
 
+static uint32_t prvHashQueueName( const char * const pcName )
+{
+    uint32_t ulHash = 2166136261UL;
+    const char * pcCharacter = pcName;
+
+    /* FNV-1a: cheap, and good enough to spread short names over the buckets. */
+    while( *pcCharacter != '\0' )
+    {
+        ulHash ^= ( uint32_t ) ( uint8_t ) *pcCharacter;
+        ulHash *= 16777619UL;
+        pcCharacter++;
+    }
+
+    return ulHash;
+}
+
+/*-----------------------------------------------------------*/
+
+static Link_t * prvDescriptorBucket( mqd_t xMessageQueueDescriptor )
+{
+    /* Descriptors are heap pointers, so the low bits carry no information. */
+    uintptr_t uxKey = ( uintptr_t ) xMessageQueueDescriptor >> 3;
+
+    return &xQueueDescriptorTable[ uxKey % posixconfigMQ_HASH_TABLE_SIZE ];
+}
+
+/*-----------------------------------------------------------*/
+
+static UBaseType_t prvHighestReadyPriority( uint32_t ulReadyPriorities )
+{
+    UBaseType_t uxPriority = 0;
+
+    /* Binary search for the most significant bit set. */
+    if( ( ulReadyPriorities & 0xFFFF0000UL ) != 0 )
+    {
+        ulReadyPriorities >>= 16;
+        uxPriority += 16;
+    }
+
+    if( ( ulReadyPriorities & 0xFF00UL ) != 0 )
+    {
+        ulReadyPriorities >>= 8;
+        uxPriority += 8;
+    }
+
+    if( ( ulReadyPriorities & 0xF0UL ) != 0 )
+    {
+        ulReadyPriorities >>= 4;
+        uxPriority += 4;
+    }
+
+    if( ( ulReadyPriorities & 0xCUL ) != 0 )
+    {
+        ulReadyPriorities >>= 2;
+        uxPriority += 2;
+    }
+
+    if( ( ulReadyPriorities & 0x2UL ) != 0 )
+    {
+        uxPriority += 1;
+    }
+
+    return uxPriority;
+}
+
+/*-----------------------------------------------------------*/
+
+static void prvEnqueueMessage( QueueListElement_t * const pxMessageQueue,
+                               QueueElement_t * const pxQueueElement,
+                               UBaseType_t uxPriority )
+{
+    /* The lists are also modified by receivers, which do not hold
+     * xQueueListMutex while doing so. The critical section is short and its
+     * length doesn't depend on the number of messages. */
+    taskENTER_CRITICAL();
+    {
+        /* New messages are added at the head; the oldest one is at the tail. */
+        listADD( &pxMessageQueue->xMessageLists[ uxPriority ], &pxQueueElement->xLink );
+        pxMessageQueue->ulReadyPriorities |= ( 1UL << uxPriority );
+    }
+    taskEXIT_CRITICAL();
+}
+
+/*-----------------------------------------------------------*/
+
+static QueueElement_t * prvDequeueMessage( QueueListElement_t * const pxMessageQueue,
+                                           UBaseType_t * puxPriority )
+{
+    Link_t * pxMessageList = NULL, * pxOldestLink = NULL;
+    UBaseType_t uxPriority = 0;
+
+    taskENTER_CRITICAL();
+    {
+        uxPriority = prvHighestReadyPriority( pxMessageQueue->ulReadyPriorities );
+        pxMessageList = &pxMessageQueue->xMessageLists[ uxPriority ];
+
+        /* Remove the oldest message of this priority from the tail. */
+        pxOldestLink = pxMessageList->pxPrev;
+        listREMOVE( pxOldestLink );
+
+        if( listIS_EMPTY( pxMessageList ) )
+        {
+            pxMessageQueue->ulReadyPriorities &= ~( 1UL << uxPriority );
+        }
+    }
+    taskEXIT_CRITICAL();
+
+    *puxPriority = uxPriority;
+
+    return listCONTAINER( pxOldestLink, QueueElement_t, xLink );
+}
+
+/*-----------------------------------------------------------*/
+
 static BaseType_t prvValidateQueueName( const char * const pcName,
                                         size_t * pxNameLength )
 {
@@ -417,6 +637,7 @@ int mq_close( mqd_t mqdes )
             if( pxMessageQueue->xPendingUnlink == pdTRUE )
             {
                 listREMOVE( &pxMessageQueue->xLink );
+                listREMOVE( &pxMessageQueue->xDescriptorLink );
 
                 /* Set the flag to delete the queue. Deleting the queue is deferred
                  * until xQueueListMutex is released. */
@@ -465,7 +686,8 @@ int mq_getattr( mqd_t mqdes,
     {
         /* Update the number of messages in the queue and copy the attributes
          * into mqstat. */
-        pxMessageQueue->xAttr.mq_curmsgs = ( long ) uxQueueMessagesWaiting( pxMessageQueue->xQueue );
+        pxMessageQueue->xAttr.mq_curmsgs =
+            ( long ) uxSemaphoreGetCount( ( SemaphoreHandle_t ) &pxMessageQueue->xMessagesWaiting );
         *mqstat = pxMessageQueue->xAttr;
     }
     else
@@ -630,10 +852,8 @@ ssize_t mq_timedreceive( mqd_t mqdes,
     int iCalculateTimeoutReturn = 0;
     TickType_t xTimeoutTicks = 0;
     QueueListElement_t * pxMessageQueue = ( QueueListElement_t * ) mqdes;
-    QueueElement_t xReceiveData = { 0 };
-
-    /* Silence warnings about unused parameters. */
-    ( void ) msg_prio;
+    QueueElement_t * pxReceiveData = NULL;
+    UBaseType_t uxPriority = 0;
 
     /* Lock the mutex that guards access to the queue list. This call will
      * never fail because it blocks forever. */
@@ -677,10 +897,9 @@ ssize_t mq_timedreceive( mqd_t mqdes,
 
     if( xStatus == 0 )
     {
-        /* Receive data from the FreeRTOS queue. */
-        if( xQueueReceive( pxMessageQueue->xQueue,
-                           &xReceiveData,
-                           xTimeoutTicks ) == pdFALSE )
+        /* Wait for a message to be available. */
+        if( xSemaphoreTake( ( SemaphoreHandle_t ) &pxMessageQueue->xMessagesWaiting,
+                            xTimeoutTicks ) == pdFALSE )
         {
             /* If queue receive fails, set the appropriate errno. */
             if( pxMessageQueue->xAttr.mq_flags & O_NONBLOCK )
@@ -700,12 +919,21 @@ ssize_t mq_timedreceive( mqd_t mqdes,
 
     if( xStatus == 0 )
     {
+        /* Take the oldest message of the highest priority and free its slot. */
+        pxReceiveData = prvDequeueMessage( pxMessageQueue, &uxPriority );
+        ( void ) xSemaphoreGive( ( SemaphoreHandle_t ) &pxMessageQueue->xSpacesAvailable );
+
         /* Get the length of data for return value. */
-        xStatus = ( ssize_t ) xReceiveData.xDataSize;
+        xStatus = ( ssize_t ) pxReceiveData->xDataSize;
 
         /* Copy received data into given buffer, then free it. */
-        ( void ) memcpy( msg_ptr, xReceiveData.pcData, xReceiveData.xDataSize );
-        vPortFree( xReceiveData.pcData );
+        ( void ) memcpy( msg_ptr, pxReceiveData->pcData, pxReceiveData->xDataSize );
+        vPortFree( pxReceiveData );
+
+        if( msg_prio != NULL )
+        {
+            *msg_prio = ( unsigned ) uxPriority;
+        }
     }
 
     return xStatus;
@@ -722,10 +950,7 @@ int mq_timedsend( mqd_t mqdes,
     int iStatus = 0, iCalculateTimeoutReturn = 0;
     TickType_t xTimeoutTicks = 0;
     QueueListElement_t * pxMessageQueue = ( QueueListElement_t * ) mqdes;
-    QueueElement_t xSendData = { 0 };
-
-    /* Silence warnings about unused parameters. */
-    ( void ) msg_prio;
+    QueueElement_t * pxSendData = NULL;
 
     /* Lock the mutex that guards access to the queue list. This call will
      * never fail because it blocks forever. */
@@ -750,6 +975,16 @@ int mq_timedsend( mqd_t mqdes,
         }
     }
 
+    /* Verify that msg_prio is supported. */
+    if( iStatus == 0 )
+    {
+        if( msg_prio >= MQ_PRIO_MAX )
+        {
+            errno = EINVAL;
+            iStatus = -1;
+        }
+    }
+
     if( iStatus == 0 )
     {
         /* Convert abstime to a tick timeout. */
@@ -767,14 +1002,13 @@ int mq_timedsend( mqd_t mqdes,
     /* Release the mutex protecting the queue list. */
     ( void ) xSemaphoreGive( ( SemaphoreHandle_t ) &xQueueListMutex );
 
-    /* Allocate memory for the message. */
+    /* Allocate memory for the message, together with its header. */
     if( iStatus == 0 )
     {
-        xSendData.xDataSize = msg_len;
-        xSendData.pcData = pvPortMalloc( msg_len );
+        pxSendData = pvPortMalloc( sizeof( QueueElement_t ) + msg_len );
 
         /* Check that memory allocation succeeded. */
-        if( xSendData.pcData == NULL )
+        if( pxSendData == NULL )
         {
             /* msg_len too large. */
             errno = EMSGSIZE;
@@ -783,16 +1017,17 @@ int mq_timedsend( mqd_t mqdes,
         else
         {
             /* Copy the data to send. */
-            ( void ) memcpy( xSendData.pcData, msg_ptr, msg_len );
+            pxSendData->xDataSize = msg_len;
+            pxSendData->pcData = ( char * ) ( pxSendData + 1 );
+            ( void ) memcpy( pxSendData->pcData, msg_ptr, msg_len );
         }
     }
 
     if( iStatus == 0 )
     {
-        /* Send data to the FreeRTOS queue. */
-        if( xQueueSend( pxMessageQueue->xQueue,
-                        &xSendData,
-                        xTimeoutTicks ) == pdFALSE )
+        /* Wait for a free message slot. */
+        if( xSemaphoreTake( ( SemaphoreHandle_t ) &pxMessageQueue->xSpacesAvailable,
+                            xTimeoutTicks ) == pdFALSE )
         {
             /* If queue send fails, set the appropriate errno. */
             if( pxMessageQueue->xAttr.mq_flags & O_NONBLOCK )
@@ -807,12 +1042,19 @@ int mq_timedsend( mqd_t mqdes,
             }
 
             /* Free the allocated queue data. */
-            vPortFree( xSendData.pcData );
+            vPortFree( pxSendData );
 
             iStatus = -1;
         }
     }
 
+    if( iStatus == 0 )
+    {
+        /* Queue the message, then wake up a receiver. */
+        prvEnqueueMessage( pxMessageQueue, pxSendData, ( UBaseType_t ) msg_prio );
+        ( void ) xSemaphoreGive( ( SemaphoreHandle_t ) &pxMessageQueue->xMessagesWaiting );
+    }
+
     return iStatus;
 }
 
@@ -850,6 +1092,7 @@ int mq_unlink( const char * name )
             if( pxMessageQueue->xOpenDescriptors == 0 )
             {
                 listREMOVE( &pxMessageQueue->xLink );
+                listREMOVE( &pxMessageQueue->xDescriptorLink );
 
                 /* Set the flag to delete the queue. Deleting the queue is deferred
                  * until xQueueListMutex is released. */
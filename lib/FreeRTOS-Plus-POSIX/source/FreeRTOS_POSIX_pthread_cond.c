@@ -28,15 +28,25 @@
  * @brief Implementation of condition variable functions in pthread.h
  */
 
-/* C standard library includes. */
-#include <limits.h>
-
 /* FreeRTOS+POSIX includes. */
 #include "FreeRTOS_POSIX.h"
 #include "FreeRTOS_POSIX/errno.h"
 #include "FreeRTOS_POSIX/pthread.h"
 #include "FreeRTOS_POSIX/utils.h"
 
+/**
+ * @brief A thread waiting on a condition variable.
+ *
+ * Lives on the stack of the waiting thread for the duration of its wait. All
+ * accesses to the wait list and xSignaled happen with the scheduler suspended.
+ */
+typedef struct CondWaiter
+{
+    Link_t xLink;                  /**< Link in the wait list of the condition variable. */
+    TaskHandle_t xTask;            /**< The waiting task; it is woken by a task notification. */
+    volatile BaseType_t xSignaled; /**< Set to pdTRUE when the waiter is removed by a signal or broadcast. */
+} CondWaiter_t;
+
 /**
  * @brief Initialize a PTHREAD_COND_INITIALIZER cond.
  *
@@ -48,6 +58,16 @@
  */
 static void prvInitializeStaticCond( pthread_cond_internal_t * pxCond );
 
+/**
+ * @brief Wake the oldest waiter of a cond.
+ *
+ * Must be called with the scheduler suspended and a non-empty wait list.
+ * @param[in] pxCond The cond whose waiter to wake.
+ *
+ * @return nothing
+ */
+static void prvWakeOldestWaiter( pthread_cond_internal_t * pxCond );
+
 /*-----------------------------------------------------------*/
 
 static void prvInitializeStaticCond( pthread_cond_internal_t * pxCond )
@@ -64,12 +84,9 @@ static void prvInitializeStaticCond( pthread_cond_internal_t * pxCond )
          * section. */
         if( pxCond->xIsInitialized == pdFALSE )
         {
-            /* Set the members of the cond. The semaphore create calls will never fail
-             * when their arguments aren't NULL. */
+            /* Set the members of the cond. */
+            listINIT_HEAD( &pxCond->xWaitList );
             pxCond->xIsInitialized = pdTRUE;
-            ( void ) xSemaphoreCreateMutexStatic( &pxCond->xCondMutex );
-            ( void ) xSemaphoreCreateCountingStatic( INT_MAX, 0U, &pxCond->xCondWaitSemaphore );
-            pxCond->iWaitingThreads = 0;
         }
 
         /* Exit the critical section. */
@@ -79,30 +96,46 @@ static void prvInitializeStaticCond( pthread_cond_internal_t * pxCond )
 
 /*-----------------------------------------------------------*/
 
+static void prvWakeOldestWaiter( pthread_cond_internal_t * pxCond )
+{
+    Link_t * pxOldestLink = pxCond->xWaitList.pxPrev;
+    CondWaiter_t * pxWaiter = listCONTAINER( pxOldestLink, CondWaiter_t, xLink );
+
+    /* Waiters are added at the head, so the oldest one is at the tail. Once
+     * removed and marked, a waiter that times out will still report success,
+     * so the signal is never lost. */
+    listREMOVE( pxOldestLink );
+    pxWaiter->xSignaled = pdTRUE;
+
+    /* The waiter cannot return and reuse its stack until the scheduler is
+     * resumed, so pxWaiter->xTask is still valid here. */
+    ( void ) xTaskNotifyGiveIndexed( pxWaiter->xTask, posixconfigNOTIFICATION_INDEX );
+}
+
+/*-----------------------------------------------------------*/
+
 int pthread_cond_broadcast( pthread_cond_t * cond )
 {
-    int i = 0;
     pthread_cond_internal_t * pxCond = ( pthread_cond_internal_t * ) ( *cond );
 
     /* If the cond is uninitialized, perform initialization. */
     prvInitializeStaticCond( pxCond );
 
-    /* Lock xCondMutex to protect access to iWaitingThreads.
-     * This call will never fail because it blocks forever. */
-    ( void ) xSemaphoreTake( ( SemaphoreHandle_t ) &pxCond->xCondMutex, portMAX_DELAY );
-
-    /* Unblock all threads waiting on this condition variable. */
-    for( i = 0; i < pxCond->iWaitingThreads; i++ )
+    /* Nothing to do if no thread is waiting. */
+    if( listIS_EMPTY( &pxCond->xWaitList ) == pdFALSE )
     {
-        ( void ) xSemaphoreGive( ( SemaphoreHandle_t ) &pxCond->xCondWaitSemaphore );
+        /* Unblock all threads waiting on this condition variable in one pass.
+         * Context switches are held off until every waiter has been woken. */
+        vTaskSuspendAll();
+        {
+            while( listIS_EMPTY( &pxCond->xWaitList ) == pdFALSE )
+            {
+                prvWakeOldestWaiter( pxCond );
+            }
+        }
+        ( void ) xTaskResumeAll();
     }
 
-    /* All threads were unblocked, set waiting threads to 0. */
-    pxCond->iWaitingThreads = 0;
-
-    /* Release xCondMutex. */
-    ( void ) xSemaphoreGive( ( SemaphoreHandle_t ) &pxCond->xCondMutex );
-
     return 0;
 }
 
@@ -113,8 +146,6 @@ int pthread_cond_destroy( pthread_cond_t * cond )
     pthread_cond_internal_t * pxCond = ( pthread_cond_internal_t * ) ( *cond );
 
     /* Free all resources in use by the cond. */
-    vSemaphoreDelete( ( SemaphoreHandle_t ) &pxCond->xCondMutex );
-    vSemaphoreDelete( ( SemaphoreHandle_t ) &pxCond->xCondWaitSemaphore );
     vPortFree( pxCond );
 
     return 0;
@@ -140,12 +171,9 @@ int pthread_cond_init( pthread_cond_t * cond,
 
     if( iStatus == 0 )
     {
-        /* Set the members of the cond. The semaphore create calls will never fail
-         * when their arguments aren't NULL. */
+        /* Set the members of the cond. */
+        listINIT_HEAD( &pxCond->xWaitList );
         pxCond->xIsInitialized = pdTRUE;
-        ( void ) xSemaphoreCreateMutexStatic( &pxCond->xCondMutex );
-        ( void ) xSemaphoreCreateCountingStatic( INT_MAX, 0U, &pxCond->xCondWaitSemaphore );
-        pxCond->iWaitingThreads = 0;
 
         /* Set the output. */
         *cond = pxCond;
@@ -164,24 +192,18 @@ int pthread_cond_signal( pthread_cond_t * cond )
     prvInitializeStaticCond( pxCond );
 
     /* Check that at least one thread is waiting for a signal. */
-    if( pxCond->iWaitingThreads > 0 )
+    if( listIS_EMPTY( &pxCond->xWaitList ) == pdFALSE )
     {
-        /* Lock xCondMutex to protect access to iWaitingThreads.
-         * This call will never fail because it blocks forever. */
-        ( void ) xSemaphoreTake( ( SemaphoreHandle_t ) &pxCond->xCondMutex, portMAX_DELAY );
-
-        /* Check again that at least one thread is waiting for a signal after
-         * taking xCondMutex. If so, unblock it. */
-        if( pxCond->iWaitingThreads > 0 )
+        vTaskSuspendAll();
         {
-            ( void ) xSemaphoreGive( ( SemaphoreHandle_t ) &pxCond->xCondWaitSemaphore );
-
-            /* Decrease the number of waiting threads. */
-            pxCond->iWaitingThreads--;
+            /* Check again with the scheduler suspended. If a thread is still
+             * waiting, unblock exactly one. */
+            if( listIS_EMPTY( &pxCond->xWaitList ) == pdFALSE )
+            {
+                prvWakeOldestWaiter( pxCond );
+            }
         }
-
-        /* Release xCondMutex. */
-        ( void ) xSemaphoreGive( ( SemaphoreHandle_t ) &pxCond->xCondMutex );
+        ( void ) xTaskResumeAll();
     }
 
     return 0;
@@ -196,6 +218,8 @@ int pthread_cond_timedwait( pthread_cond_t * cond,
     int iStatus = 0;
     pthread_cond_internal_t * pxCond = ( pthread_cond_internal_t * ) ( *cond );
     TickType_t xDelay = portMAX_DELAY;
+    TimeOut_t xTimeOut = { 0 };
+    CondWaiter_t xWaiter = { { 0 } };
 
     /* If the cond is uninitialized, perform initialization. */
     prvInitializeStaticCond( pxCond );
@@ -206,35 +230,72 @@ int pthread_cond_timedwait( pthread_cond_t * cond,
         iStatus = UTILS_AbsoluteTimespecToTicks( abstime, &xDelay );
     }
 
-    /* Increase the counter of threads blocking on condition variable, then
-     * unlock mutex. */
+    /* Add this thread to the wait list, then unlock mutex. The thread is on
+     * the list before mutex is released, so no signal can be missed. */
     if( iStatus == 0 )
     {
-        ( void ) xSemaphoreTake( ( SemaphoreHandle_t ) &pxCond->xCondMutex, portMAX_DELAY );
-        pxCond->iWaitingThreads++;
-        ( void ) xSemaphoreGive( ( SemaphoreHandle_t ) &pxCond->xCondMutex );
+        xWaiter.xTask = xTaskGetCurrentTaskHandle();
+        xWaiter.xSignaled = pdFALSE;
+
+        vTaskSuspendAll();
+        {
+            listADD( &pxCond->xWaitList, &xWaiter.xLink );
+        }
+        ( void ) xTaskResumeAll();
 
         iStatus = pthread_mutex_unlock( mutex );
+
+        if( iStatus != 0 )
+        {
+            /* The caller did not own mutex; leave without waiting. */
+            vTaskSuspendAll();
+            {
+                if( xWaiter.xSignaled == pdFALSE )
+                {
+                    listREMOVE( &xWaiter.xLink );
+                }
+            }
+            ( void ) xTaskResumeAll();
+        }
     }
 
     /* Wait on the condition variable. */
     if( iStatus == 0 )
     {
-        if( xSemaphoreTake( ( SemaphoreHandle_t ) &pxCond->xCondWaitSemaphore,
-                            xDelay ) == pdPASS )
+        vTaskSetTimeOutState( &xTimeOut );
+
+        /* A notification may have been left over from an earlier wait or
+         * sent for some other reason, so only xSignaled ends the wait. */
+        while( xWaiter.xSignaled == pdFALSE )
+        {
+            if( xTaskCheckForTimeOut( &xTimeOut, &xDelay ) == pdTRUE )
+            {
+                break;
+            }
+
+            ( void ) ulTaskNotifyTakeIndexed( posixconfigNOTIFICATION_INDEX, pdTRUE, xDelay );
+        }
+
+        /* A signal that arrives while timing out is still consumed by this
+         * thread, so it is never lost for the other waiters. */
+        vTaskSuspendAll();
+        {
+            if( xWaiter.xSignaled == pdFALSE )
+            {
+                listREMOVE( &xWaiter.xLink );
+                iStatus = ETIMEDOUT;
+            }
+        }
+        ( void ) xTaskResumeAll();
+
+        /* Relock mutex. */
+        if( iStatus == 0 )
         {
-            /* When successful, relock mutex. */
             iStatus = pthread_mutex_lock( mutex );
         }
         else
         {
-            /* Timeout. Relock mutex and decrement number of waiting threads. */
-            iStatus = ETIMEDOUT;
             ( void ) pthread_mutex_lock( mutex );
-
-            ( void ) xSemaphoreTake( ( SemaphoreHandle_t ) &pxCond->xCondMutex, portMAX_DELAY );
-            pxCond->iWaitingThreads--;
-            ( void ) xSemaphoreGive( ( SemaphoreHandle_t ) &pxCond->xCondMutex );
         }
     }
 
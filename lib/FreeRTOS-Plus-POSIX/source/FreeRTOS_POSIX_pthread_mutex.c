@@ -291,15 +291,19 @@ int pthread_mutex_unlock( pthread_mutex_t * mutex )
         if( pxMutex->xAttr.iType == PTHREAD_MUTEX_RECURSIVE )
         {
             ( void ) xSemaphoreGiveRecursive( ( SemaphoreHandle_t ) &pxMutex->xMutex );
+
+            /* Update the owner of the mutex. A recursive mutex may still have
+             * an owner, so it should be updated with xSemaphoreGetMutexHolder. */
+            pxMutex->xTaskOwner = xSemaphoreGetMutexHolder( ( SemaphoreHandle_t ) &pxMutex->xMutex );
         }
         else
         {
+            /* Clear the owner before releasing the mutex, as a waiting thread
+             * sets itself as the owner as soon as it takes the mutex. The
+             * holder does not have to be read back from the kernel. */
+            pxMutex->xTaskOwner = NULL;
             ( void ) xSemaphoreGive( ( SemaphoreHandle_t ) &pxMutex->xMutex );
         }
-
-        /* Update the owner of the mutex. A recursive mutex may still have an
-         * owner, so it should be updated with xSemaphoreGetMutexHolder. */
-        pxMutex->xTaskOwner = xSemaphoreGetMutexHolder( ( SemaphoreHandle_t ) &pxMutex->xMutex );
     }
 
     return iStatus;
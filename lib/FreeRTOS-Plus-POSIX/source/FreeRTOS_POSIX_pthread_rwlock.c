@@ -0,0 +1,515 @@
+/*
+ * Amazon FreeRTOS+POSIX V1.0.1
+ * Copyright (C) 2018 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+/**
+ * @file FreeRTOS_POSIX_pthread_rwlock.c
+ * @brief Implementation of read-write lock functions in pthread.h
+ */
+
+/* C standard library includes. */
+#include <stddef.h>
+#include <string.h>
+
+/* FreeRTOS+POSIX includes. */
+#include "FreeRTOS_POSIX.h"
+#include "FreeRTOS_POSIX/errno.h"
+#include "FreeRTOS_POSIX/pthread.h"
+#include "FreeRTOS_POSIX/utils.h"
+
+/**
+ * @brief Initialize a PTHREAD_RWLOCK_INITIALIZER read-write lock.
+ *
+ * PTHREAD_RWLOCK_INITIALIZER sets a flag for a read-write lock to be
+ * initialized later. This function performs the initialization.
+ * @param[in] pxRwlock The read-write lock to initialize.
+ *
+ * @return nothing
+ */
+static void prvInitializeStaticRwlock( pthread_rwlock_internal_t * pxRwlock );
+
+/**
+ * @brief Convert an optional absolute timeout to a delay in ticks.
+ *
+ * @param[in] abstime The absolute timeout, or NULL to wait forever.
+ * @param[out] pxDelay The delay in ticks. 0 if abstime has already passed.
+ *
+ * @return 0 on success; EINVAL if abstime is invalid.
+ */
+static int prvAbsoluteTimespecToDelay( const struct timespec * abstime,
+                                       TickType_t * pxDelay );
+
+/**
+ * @brief Take the writer mutex, blocking for at most xDelay ticks.
+ *
+ * @param[in] pxRwlock The read-write lock.
+ * @param[in] xDelay The maximum time to block.
+ *
+ * @return pdPASS if the writer mutex was taken; pdFAIL otherwise.
+ */
+static BaseType_t prvTakeWriterMutex( pthread_rwlock_internal_t * pxRwlock,
+                                      TickType_t xDelay );
+
+/**
+ * @brief Give the writer mutex.
+ *
+ * @param[in] pxRwlock The read-write lock.
+ *
+ * @return nothing
+ */
+static void prvGiveWriterMutex( pthread_rwlock_internal_t * pxRwlock );
+
+/**
+ * @brief Wait for the threads holding a read lock to unlock.
+ *
+ * Called by the writer, with the writer mutex held and xWriterWaiting set.
+ * @param[in] pxRwlock The read-write lock.
+ * @param[in] pxTimeOut Set when the writer started waiting for the lock.
+ * @param[in] xDelay The timeout of the writer, in ticks.
+ *
+ * @return 0 once the last reader has unlocked; ETIMEDOUT otherwise.
+ */
+static int prvWaitForReaders( pthread_rwlock_internal_t * pxRwlock,
+                              TimeOut_t * pxTimeOut,
+                              TickType_t xDelay );
+
+/*-----------------------------------------------------------*/
+
+static void prvInitializeStaticRwlock( pthread_rwlock_internal_t * pxRwlock )
+{
+    /* Check if the read-write lock needs to be initialized. */
+    if( pxRwlock->xIsInitialized == pdFALSE )
+    {
+        /* Initialization must be in a critical section to prevent two threads
+         * from initializing the read-write lock at the same time. */
+        taskENTER_CRITICAL();
+
+        /* Check again that the read-write lock is still uninitialized, i.e. it
+         * wasn't initialized while this function was waiting to enter the
+         * critical section. */
+        if( pxRwlock->xIsInitialized == pdFALSE )
+        {
+            /* These calls will not fail when their arguments aren't NULL. */
+            ( void ) xSemaphoreCreateMutexStatic( &pxRwlock->xWriterMutex );
+            ( void ) xSemaphoreCreateBinaryStatic( &pxRwlock->xReadersDone );
+
+            pxRwlock->xIsInitialized = pdTRUE;
+        }
+
+        /* Exit the critical section. */
+        taskEXIT_CRITICAL();
+    }
+}
+
+/*-----------------------------------------------------------*/
+
+static int prvAbsoluteTimespecToDelay( const struct timespec * abstime,
+                                       TickType_t * pxDelay )
+{
+    int iStatus = 0;
+
+    *pxDelay = portMAX_DELAY;
+
+    if( abstime != NULL )
+    {
+        iStatus = UTILS_AbsoluteTimespecToTicks( abstime, pxDelay );
+
+        /* If abstime was in the past, still attempt to take the lock without
+         * blocking, per POSIX spec. */
+        if( iStatus == ETIMEDOUT )
+        {
+            *pxDelay = 0;
+            iStatus = 0;
+        }
+    }
+
+    return iStatus;
+}
+
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvTakeWriterMutex( pthread_rwlock_internal_t * pxRwlock,
+                                      TickType_t xDelay )
+{
+    /* Block in the kernel, which raises the priority of the writer mutex
+     * holder to that of this thread if it is higher. */
+    return xSemaphoreTake( ( SemaphoreHandle_t ) &pxRwlock->xWriterMutex, xDelay );
+}
+
+/*-----------------------------------------------------------*/
+
+static void prvGiveWriterMutex( pthread_rwlock_internal_t * pxRwlock )
+{
+    ( void ) xSemaphoreGive( ( SemaphoreHandle_t ) &pxRwlock->xWriterMutex );
+}
+
+/*-----------------------------------------------------------*/
+
+static int prvWaitForReaders( pthread_rwlock_internal_t * pxRwlock,
+                              TimeOut_t * pxTimeOut,
+                              TickType_t xDelay )
+{
+    int iStatus = 0;
+    BaseType_t xTimedOut = pdFALSE;
+
+    /* Only wait for the part of the timeout not already spent on the writer
+     * mutex. */
+    if( xTaskCheckForTimeOut( pxTimeOut, &xDelay ) == pdTRUE )
+    {
+        xDelay = 0;
+    }
+
+    if( xSemaphoreTake( ( SemaphoreHandle_t ) &pxRwlock->xReadersDone, xDelay ) != pdPASS )
+    {
+        taskENTER_CRITICAL();
+
+        /* If the last reader unlocked after the timeout expired, it has
+         * already cleared xWriterWaiting and will give xReadersDone. */
+        if( pxRwlock->xWriterWaiting == pdTRUE )
+        {
+            pxRwlock->xWriterWaiting = pdFALSE;
+            xTimedOut = pdTRUE;
+        }
+
+        taskEXIT_CRITICAL();
+
+        if( xTimedOut == pdTRUE )
+        {
+            iStatus = ETIMEDOUT;
+        }
+        else
+        {
+            ( void ) xSemaphoreTake( ( SemaphoreHandle_t ) &pxRwlock->xReadersDone, portMAX_DELAY );
+        }
+    }
+
+    return iStatus;
+}
+
+/*-----------------------------------------------------------*/
+
+int pthread_rwlock_destroy( pthread_rwlock_t * rwlock )
+{
+    int iStatus = 0;
+    pthread_rwlock_internal_t * pxRwlock = ( pthread_rwlock_internal_t * ) ( *rwlock );
+
+    /* A read-write lock that is held or waited for may not be destroyed. */
+    if( ( pxRwlock->uxReaders != 0 ) || ( pxRwlock->uxWriters != 0 ) )
+    {
+        iStatus = EBUSY;
+    }
+
+    /* Free resources in use by the read-write lock. */
+    if( iStatus == 0 )
+    {
+        if( pxRwlock->xIsInitialized == pdTRUE )
+        {
+            vSemaphoreDelete( ( SemaphoreHandle_t ) &pxRwlock->xWriterMutex );
+            vSemaphoreDelete( ( SemaphoreHandle_t ) &pxRwlock->xReadersDone );
+        }
+
+        vPortFree( pxRwlock );
+    }
+
+    return iStatus;
+}
+
+/*-----------------------------------------------------------*/
+
+int pthread_rwlock_init( pthread_rwlock_t * rwlock,
+                         const pthread_rwlockattr_t * attr )
+{
+    int iStatus = 0;
+    pthread_rwlock_internal_t * pxRwlock = NULL;
+
+    /* Silence warnings about unused parameters. */
+    ( void ) attr;
+
+    /* Allocate memory for new read-write lock object. */
+    pxRwlock = ( pthread_rwlock_internal_t * ) pvPortMalloc( sizeof( pthread_rwlock_internal_t ) );
+
+    if( pxRwlock == NULL )
+    {
+        /* No memory. */
+        iStatus = ENOMEM;
+    }
+
+    if( iStatus == 0 )
+    {
+        /* Clear the newly-allocated read-write lock, then create its FreeRTOS
+         * semaphores. */
+        ( void ) memset( pxRwlock, 0x00, sizeof( pthread_rwlock_internal_t ) );
+        prvInitializeStaticRwlock( pxRwlock );
+
+        /* Set output parameter. */
+        *rwlock = ( pthread_rwlock_t ) pxRwlock;
+    }
+
+    return iStatus;
+}
+
+/*-----------------------------------------------------------*/
+
+int pthread_rwlock_rdlock( pthread_rwlock_t * rwlock )
+{
+    return pthread_rwlock_timedrdlock( rwlock, NULL );
+}
+
+/*-----------------------------------------------------------*/
+
+int pthread_rwlock_timedrdlock( pthread_rwlock_t * rwlock,
+                                const struct timespec * abstime )
+{
+    int iStatus = 0;
+    pthread_rwlock_internal_t * pxRwlock = ( pthread_rwlock_internal_t * ) ( *rwlock );
+    TickType_t xDelay = portMAX_DELAY;
+    BaseType_t xLocked = pdFALSE;
+
+    /* If the read-write lock is uninitialized, perform initialization. */
+    prvInitializeStaticRwlock( pxRwlock );
+
+    /* If no writer holds or waits for the lock, the reader only needs to be
+     * counted. */
+    taskENTER_CRITICAL();
+
+    if( pxRwlock->uxWriters == 0 )
+    {
+        pxRwlock->uxReaders++;
+        xLocked = pdTRUE;
+    }
+
+    taskEXIT_CRITICAL();
+
+    if( xLocked == pdFALSE )
+    {
+        iStatus = prvAbsoluteTimespecToDelay( abstime, &xDelay );
+
+        /* Otherwise queue behind the writers on the writer mutex. Only one
+         * thread can hold it, so no writer can take the lock while this
+         * thread is counted as a reader. */
+        if( iStatus == 0 )
+        {
+            if( prvTakeWriterMutex( pxRwlock, xDelay ) == pdPASS )
+            {
+                taskENTER_CRITICAL();
+                pxRwlock->uxReaders++;
+                taskEXIT_CRITICAL();
+
+                prvGiveWriterMutex( pxRwlock );
+            }
+            else
+            {
+                iStatus = ETIMEDOUT;
+            }
+        }
+    }
+
+    return iStatus;
+}
+
+/*-----------------------------------------------------------*/
+
+int pthread_rwlock_timedwrlock( pthread_rwlock_t * rwlock,
+                                const struct timespec * abstime )
+{
+    int iStatus = 0;
+    pthread_rwlock_internal_t * pxRwlock = ( pthread_rwlock_internal_t * ) ( *rwlock );
+    TickType_t xDelay = portMAX_DELAY;
+    TimeOut_t xTimeOut;
+    BaseType_t xWaitForReaders = pdFALSE;
+
+    /* If the read-write lock is uninitialized, perform initialization. */
+    prvInitializeStaticRwlock( pxRwlock );
+
+    iStatus = prvAbsoluteTimespecToDelay( abstime, &xDelay );
+
+    /* Check if trying to lock a read-write lock already held for writing by
+     * this thread. */
+    if( ( iStatus == 0 ) &&
+        ( pxRwlock->xWriter == xTaskGetCurrentTaskHandle() ) )
+    {
+        iStatus = EDEADLK;
+    }
+
+    if( iStatus == 0 )
+    {
+        /* Count this thread as a writer before blocking, so that new readers
+         * queue behind it instead of starving it. */
+        taskENTER_CRITICAL();
+        pxRwlock->uxWriters++;
+        taskEXIT_CRITICAL();
+
+        vTaskSetTimeOutState( &xTimeOut );
+
+        if( prvTakeWriterMutex( pxRwlock, xDelay ) == pdPASS )
+        {
+            /* No new reader can be counted while the writer mutex is held.
+             * Wait for the current readers to unlock. */
+            taskENTER_CRITICAL();
+
+            if( pxRwlock->uxReaders != 0 )
+            {
+                pxRwlock->xWriterWaiting = pdTRUE;
+                xWaitForReaders = pdTRUE;
+            }
+
+            taskEXIT_CRITICAL();
+
+            if( xWaitForReaders == pdTRUE )
+            {
+                iStatus = prvWaitForReaders( pxRwlock, &xTimeOut, xDelay );
+
+                if( iStatus != 0 )
+                {
+                    prvGiveWriterMutex( pxRwlock );
+                }
+            }
+        }
+        else
+        {
+            iStatus = ETIMEDOUT;
+        }
+
+        if( iStatus == 0 )
+        {
+            pxRwlock->xWriter = xTaskGetCurrentTaskHandle();
+        }
+        else
+        {
+            taskENTER_CRITICAL();
+            pxRwlock->uxWriters--;
+            taskEXIT_CRITICAL();
+        }
+    }
+
+    return iStatus;
+}
+
+/*-----------------------------------------------------------*/
+
+int pthread_rwlock_tryrdlock( pthread_rwlock_t * rwlock )
+{
+    int iStatus = 0;
+    struct timespec xTimeout =
+    {
+        .tv_sec  = 0,
+        .tv_nsec = 0
+    };
+
+    /* Attempt to lock with no timeout. */
+    iStatus = pthread_rwlock_timedrdlock( rwlock, &xTimeout );
+
+    /* POSIX specifies that this function should return EBUSY instead of
+     * ETIMEDOUT for attempting to lock a locked read-write lock. */
+    if( iStatus == ETIMEDOUT )
+    {
+        iStatus = EBUSY;
+    }
+
+    return iStatus;
+}
+
+/*-----------------------------------------------------------*/
+
+int pthread_rwlock_trywrlock( pthread_rwlock_t * rwlock )
+{
+    int iStatus = 0;
+    struct timespec xTimeout =
+    {
+        .tv_sec  = 0,
+        .tv_nsec = 0
+    };
+
+    /* Attempt to lock with no timeout. */
+    iStatus = pthread_rwlock_timedwrlock( rwlock, &xTimeout );
+
+    /* POSIX specifies that this function should return EBUSY instead of
+     * ETIMEDOUT for attempting to lock a locked read-write lock. */
+    if( iStatus == ETIMEDOUT )
+    {
+        iStatus = EBUSY;
+    }
+
+    return iStatus;
+}
+
+/*-----------------------------------------------------------*/
+
+int pthread_rwlock_unlock( pthread_rwlock_t * rwlock )
+{
+    int iStatus = 0;
+    pthread_rwlock_internal_t * pxRwlock = ( pthread_rwlock_internal_t * ) ( *rwlock );
+    BaseType_t xIsWriter = pdFALSE;
+    BaseType_t xWakeWriter = pdFALSE;
+
+    taskENTER_CRITICAL();
+
+    if( ( pxRwlock->xWriter != NULL ) &&
+        ( pxRwlock->xWriter == xTaskGetCurrentTaskHandle() ) )
+    {
+        /* Release the write lock. */
+        pxRwlock->xWriter = NULL;
+        pxRwlock->uxWriters--;
+        xIsWriter = pdTRUE;
+    }
+    else if( pxRwlock->uxReaders != 0 )
+    {
+        /* Release a read lock. The last reader wakes a waiting writer. */
+        pxRwlock->uxReaders--;
+
+        if( ( pxRwlock->uxReaders == 0 ) && ( pxRwlock->xWriterWaiting == pdTRUE ) )
+        {
+            pxRwlock->xWriterWaiting = pdFALSE;
+            xWakeWriter = pdTRUE;
+        }
+    }
+    else
+    {
+        /* The lock is not held. */
+        iStatus = EPERM;
+    }
+
+    taskEXIT_CRITICAL();
+
+    if( xIsWriter == pdTRUE )
+    {
+        prvGiveWriterMutex( pxRwlock );
+    }
+
+    if( xWakeWriter == pdTRUE )
+    {
+        ( void ) xSemaphoreGive( ( SemaphoreHandle_t ) &pxRwlock->xReadersDone );
+    }
+
+    return iStatus;
+}
+
+/*-----------------------------------------------------------*/
+
+int pthread_rwlock_wrlock( pthread_rwlock_t * rwlock )
+{
+    return pthread_rwlock_timedwrlock( rwlock, NULL );
+}
+
+/*-----------------------------------------------------------*/
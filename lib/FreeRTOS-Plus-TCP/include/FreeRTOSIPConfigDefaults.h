@@ -273,6 +273,16 @@ from the FreeRTOSIPConfig.h configuration header file. */
 	#define ipconfigARP_CACHE_ENTRIES		10
 #endif
 
+/* The ARP cache is indexed by a hash of the IP address.  The number of buckets
+must be a power of 2, not larger than 256. */
+#ifndef ipconfigARP_CACHE_HASH_BUCKETS
+	#define ipconfigARP_CACHE_HASH_BUCKETS	16
+#endif
+
+#if( ( ipconfigARP_CACHE_HASH_BUCKETS & ( ipconfigARP_CACHE_HASH_BUCKETS - 1 ) ) != 0 ) || ( ipconfigARP_CACHE_HASH_BUCKETS > 256 )
+	#error ipconfigARP_CACHE_HASH_BUCKETS must be a power of 2, not larger than 256
+#endif
+
 #ifndef ipconfigMAX_ARP_RETRANSMISSIONS
 	#define ipconfigMAX_ARP_RETRANSMISSIONS ( 5u )
 #endif
@@ -329,6 +339,17 @@ from the FreeRTOSIPConfig.h configuration header file. */
 	#define ipconfigUSE_DHCP_HOOK		0
 #endif
 
+#ifndef ipconfigDHCP_USE_LEASE_STORE
+	/*
+	 * Only applicable when DHCP is in use:
+	 * The application stores the lease in vApplicationDHCPStoreLease().  When
+	 * the network comes up, xApplicationDHCPLoadLease() is asked for a lease
+	 * that is still valid, and the address is requested again (INIT-REBOOT)
+	 * before going through the discover/offer exchange.
+	 */
+	#define ipconfigDHCP_USE_LEASE_STORE		( 0 )
+#endif
+
 #ifndef ipconfigDHCP_FALL_BACK_AUTO_IP
 	/*
 	 * Only applicable when DHCP is in use:
@@ -397,6 +418,26 @@ from the FreeRTOSIPConfig.h configuration header file. */
 	#ifndef ipconfigDNS_CACHE_ENTRIES
 		#define ipconfigDNS_CACHE_ENTRIES			1
 	#endif
+
+	/* The number of IPv4 addresses stored for one name.  Each address has its
+	own TTL, and the addresses are handed out in turn. */
+	#ifndef ipconfigDNS_CACHE_ADDRESSES_PER_ENTRY
+		#define ipconfigDNS_CACHE_ADDRESSES_PER_ENTRY	1
+	#endif
+
+	#if( ipconfigDNS_CACHE_ADDRESSES_PER_ENTRY < 1 ) || ( ipconfigDNS_CACHE_ADDRESSES_PER_ENTRY > 255 )
+		#error ipconfigDNS_CACHE_ADDRESSES_PER_ENTRY must be in the range 1 to 255
+	#endif
+
+	/* The DNS cache is indexed by a hash of the name.  The number of buckets
+	must be a power of 2. */
+	#ifndef ipconfigDNS_CACHE_HASH_BUCKETS
+		#define ipconfigDNS_CACHE_HASH_BUCKETS		8
+	#endif
+
+	#if( ( ipconfigDNS_CACHE_HASH_BUCKETS & ( ipconfigDNS_CACHE_HASH_BUCKETS - 1 ) ) != 0 )
+		#error ipconfigDNS_CACHE_HASH_BUCKETS must be a power of 2
+	#endif
 #endif /* ipconfigUSE_DNS_CACHE != 0 */
 
 #ifndef ipconfigCHECK_IP_QUEUE_SPACE
@@ -487,6 +528,84 @@ from the FreeRTOSIPConfig.h configuration header file. */
 	#define ipconfigZERO_COPY_RX_DRIVER		( 0 )
 #endif
 
+/* When non-zero, FreeRTOS_send() accepts the FREERTOS_ZERO_COPY flag for TCP
+sockets.  The application fills a buffer obtained from
+FreeRTOS_GetTCPPayloadBuffer(), and the TCP window keeps that buffer until its
+data has been acknowledged, so the payload is neither copied into txStream nor
+out of it again. */
+#ifndef ipconfigTCP_ZERO_COPY_TX
+	#define ipconfigTCP_ZERO_COPY_TX		( 0 )
+#endif
+
+#if( ( ipconfigTCP_ZERO_COPY_TX != 0 ) && ( ( ipconfigUSE_TCP == 0 ) || ( ipconfigUSE_TCP_WIN == 0 ) ) )
+	#error ipconfigTCP_ZERO_COPY_TX requires ipconfigUSE_TCP and ipconfigUSE_TCP_WIN
+#endif
+
+/* Set to 1 when the project is built with BufferAllocation_3.c.  The network
+buffers are then taken from static slabs in three size classes, and the batch
+functions declared in NetworkBufferManagement.h become available.  The number
+of buffers of all classes together is ipconfigNUM_NETWORK_BUFFER_DESCRIPTORS. */
+#ifndef ipconfigBUFFER_ALLOCATION_SLABS
+	#define ipconfigBUFFER_ALLOCATION_SLABS		( 0 )
+#endif
+
+#if( ipconfigBUFFER_ALLOCATION_SLABS != 0 )
+	/* Small buffers, e.g. for ARP, ACK's and DNS requests. */
+	#ifndef ipconfigBUFFER_SLAB_SMALL_SIZE
+		#define ipconfigBUFFER_SLAB_SMALL_SIZE		( 128 )
+	#endif
+
+	#ifndef ipconfigBUFFER_SLAB_SMALL_COUNT
+		#define ipconfigBUFFER_SLAB_SMALL_COUNT		( ipconfigNUM_NETWORK_BUFFER_DESCRIPTORS / 4 )
+	#endif
+
+	#ifndef ipconfigBUFFER_SLAB_MEDIUM_SIZE
+		#define ipconfigBUFFER_SLAB_MEDIUM_SIZE		( 640 )
+	#endif
+
+	#ifndef ipconfigBUFFER_SLAB_MEDIUM_COUNT
+		#define ipconfigBUFFER_SLAB_MEDIUM_COUNT	( ipconfigNUM_NETWORK_BUFFER_DESCRIPTORS / 4 )
+	#endif
+
+	/* The large buffers can hold a complete Ethernet frame, all remaining
+	descriptors get a large buffer. */
+	#define ipconfigBUFFER_SLAB_LARGE_COUNT			( ipconfigNUM_NETWORK_BUFFER_DESCRIPTORS - ( ipconfigBUFFER_SLAB_SMALL_COUNT + ipconfigBUFFER_SLAB_MEDIUM_COUNT ) )
+
+	#if( ipconfigBUFFER_SLAB_LARGE_COUNT < 1 )
+		#error At least one network buffer must be able to hold a complete Ethernet frame
+	#endif
+#endif /* ipconfigBUFFER_ALLOCATION_SLABS */
+
+/* When non-zero, the network interface may pass a chain of received packets,
+linked through pxNextBuffer, to the IP-task in a single eNetworkRxEvent. */
+#ifndef ipconfigUSE_LINKED_RX_MESSAGES
+	#define ipconfigUSE_LINKED_RX_MESSAGES	( 0 )
+#endif
+
+/* The number of TCP sockets that can have an ACK pending while a chain of
+received packets is being processed.  Once the table is full, ACK's are sent
+immediately as usual. */
+#ifndef ipconfigTCP_RX_BATCH_ACK_SOCKETS
+	#define ipconfigTCP_RX_BATCH_ACK_SOCKETS	( 8 )
+#endif
+
+/* Used while walking a chain of received packets, to load the headers of the
+next packet into the cache while the current one is being processed. */
+#ifndef ipconfigPREFETCH
+	#if defined( __GNUC__ )
+		#define ipconfigPREFETCH( pvAddress )	__builtin_prefetch( ( pvAddress ) )
+	#else
+		#define ipconfigPREFETCH( pvAddress )
+	#endif
+#endif
+
+/* Set to 1 when the port supplies its own ullChecksumSumWords(), e.g. the
+version in portable/Checksum/ARM_CM_GCC.  The portable C version in
+FreeRTOS_IP.c will then be excluded. */
+#ifndef ipconfigPORT_CHECKSUM_SUM_WORDS
+	#define ipconfigPORT_CHECKSUM_SUM_WORDS	0
+#endif
+
 #ifndef ipconfigDRIVER_INCLUDED_TX_IP_CHECKSUM
 	#define ipconfigDRIVER_INCLUDED_TX_IP_CHECKSUM 0
 #endif
@@ -515,10 +634,62 @@ from the FreeRTOSIPConfig.h configuration header file. */
 	#define ipconfigTCP_KEEP_ALIVE 0
 #endif
 
+/* The task notification index on which a task that calls into the stack waits
+for the IP-task to answer, e.g. in FreeRTOS_GetTCPConnections().  When the
+kernel has more than one index per task, index 0 is left to the application,
+so that the stack does not consume notifications meant for it.  Index 1 may be
+shared with the MQTT agent, as both ignore wake-ups they did not ask for. */
+#ifndef ipconfigNOTIFICATION_INDEX
+	#if( configTASK_NOTIFICATION_ARRAY_ENTRIES > 1 )
+		#define ipconfigNOTIFICATION_INDEX	( 1 )
+	#else
+		#define ipconfigNOTIFICATION_INDEX	( tskDEFAULT_INDEX_TO_NOTIFY )
+	#endif
+#endif
+
+/* When ipconfigTCP_CONNECTION_STATS is non-zero, every TCP socket counts the
+bytes and segments it sends and receives, as well as its retransmissions.  The
+counters are only written by the IP-task.  See FreeRTOS_GetTCPStats() and
+FreeRTOS_GetTCPConnections(). */
+#ifndef ipconfigTCP_CONNECTION_STATS
+	#define ipconfigTCP_CONNECTION_STATS 1
+#endif
+
+/* When ipconfigCACHE_STATS is non-zero, the ARP and DNS caches count their
+look-ups, hits, the number of entries compared and the number of entries that
+were replaced while still in use.  See FreeRTOS_GetARPCacheStats() and
+FreeRTOS_GetDNSCacheStats(). */
+#ifndef ipconfigCACHE_STATS
+	#define ipconfigCACHE_STATS 1
+#endif
+
 #ifndef ipconfigDNS_USE_CALLBACKS
 	#define ipconfigDNS_USE_CALLBACKS 0
 #endif
 
+/* When ipconfigDNS_USE_RESOLVER is non-zero, the IP-task resolves host names
+on a single UDP socket.  Up to ipconfigDNS_RESOLVER_QUERIES names can be looked
+up at the same time, callers asking for a name that is already being looked up
+wait for the same reply.  A query is sent again after ipconfigDNS_RESOLVER_RETRY_MS
+milliseconds, at most ipconfigDNS_REQUEST_ATTEMPTS times. */
+#ifndef ipconfigDNS_USE_RESOLVER
+	#define ipconfigDNS_USE_RESOLVER 0
+#endif
+
+#if( ipconfigDNS_USE_RESOLVER != 0 )
+	#if( ipconfigDNS_USE_CALLBACKS == 0 ) || ( ipconfigUSE_DNS_CACHE == 0 )
+		#error ipconfigDNS_USE_RESOLVER requires ipconfigDNS_USE_CALLBACKS and ipconfigUSE_DNS_CACHE
+	#endif
+
+	#ifndef ipconfigDNS_RESOLVER_QUERIES
+		#define ipconfigDNS_RESOLVER_QUERIES 4
+	#endif
+
+	#ifndef ipconfigDNS_RESOLVER_RETRY_MS
+		#define ipconfigDNS_RESOLVER_RETRY_MS 500
+	#endif
+#endif /* ipconfigDNS_USE_RESOLVER */
+
 #ifndef ipconfigSUPPORT_SIGNALS
 	#define ipconfigSUPPORT_SIGNALS				0
 #endif
@@ -121,6 +121,14 @@ void vARPGenerateRequestPacket( NetworkBufferDescriptor_t * const pxNetworkBuffe
  */
 void vARPSendGratuitous( void );
 
+#if( ipconfigCACHE_STATS != 0 )
+	/*
+	 * Copy the counters of the ARP cache.  The counters are only written by
+	 * the IP-task, so no lock is taken.
+	 */
+	void FreeRTOS_GetARPCacheStats( IPCacheStats_t *pxStats );
+#endif /* ipconfigCACHE_STATS */
+
 #ifdef __cplusplus
 } // extern "C"
 #endif
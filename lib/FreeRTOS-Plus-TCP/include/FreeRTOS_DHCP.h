@@ -52,6 +52,18 @@ typedef enum eDHCP_ANSWERS
 	eDHCPStopNoChanges,		/* Stop DHCP and continue with current settings. */
 } eDHCPCallbackAnswer_t;
 
+/* Used by the lease store hooks if ipconfigDHCP_USE_LEASE_STORE is set to 1.
+All addresses are in network byte order. */
+typedef struct xDHCP_LEASE
+{
+	uint32_t ulIPAddress;			/* The address that was leased. */
+	uint32_t ulServerAddress;		/* The DHCP server that granted the lease. */
+	uint32_t ulNetMask;
+	uint32_t ulGatewayAddress;
+	uint32_t ulDNSServerAddress;
+	uint32_t ulRenewalSeconds;		/* Seconds after which the lease must be renewed. */
+} DHCPLease_t;
+
 /*
  * NOT A PUBLIC API FUNCTION.
  */
@@ -67,6 +79,16 @@ http://www.FreeRTOS.org/FreeRTOS-Plus/FreeRTOS_Plus_TCP/TCP_IP_Configuration.htm
 */
 eDHCPCallbackAnswer_t xApplicationDHCPHook( eDHCPCallbackPhase_t eDHCPPhase, uint32_t ulIPAddress );
 
+/* Prototypes of the hook functions that must be provided by the application if
+ipconfigDHCP_USE_LEASE_STORE is set to 1.  xApplicationDHCPStoreLease() is
+called when a lease was acknowledged, and with NULL when the server refused the
+address.  xApplicationDHCPLoadLease() returns pdTRUE when it filled in a lease
+that has not expired yet, the application must keep the time for that. */
+#if( ipconfigDHCP_USE_LEASE_STORE != 0 )
+	void vApplicationDHCPStoreLease( const DHCPLease_t *pxLease );
+	BaseType_t xApplicationDHCPLoadLease( DHCPLease_t *pxLease );
+#endif /* ipconfigDHCP_USE_LEASE_STORE */
+
 #ifdef __cplusplus
 }	/* extern "C" */
 #endif
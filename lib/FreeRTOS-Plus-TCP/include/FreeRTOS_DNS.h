@@ -86,6 +86,14 @@ uint32_t ulDNSHandlePacket( NetworkBufferDescriptor_t *pxNetworkBuffer );
 
 	uint32_t FreeRTOS_dnslookup( const char *pcHostName );
 
+	#if( ipconfigCACHE_STATS != 0 )
+		/*
+		 * Copy the counters of the DNS cache.  Look-ups are done by the tasks
+		 * calling FreeRTOS_gethostbyname(), so the counters may be slightly off.
+		 */
+		void FreeRTOS_GetDNSCacheStats( IPCacheStats_t *pxStats );
+	#endif /* ipconfigCACHE_STATS */
+
 #endif /* ipconfigUSE_DNS_CACHE != 0 */
 
 #if( ipconfigDNS_USE_CALLBACKS != 0 )
@@ -105,6 +113,21 @@ uint32_t ulDNSHandlePacket( NetworkBufferDescriptor_t *pxNetworkBuffer );
 
 #endif
 
+#if( ipconfigDNS_USE_RESOLVER != 0 )
+
+	/*
+	 * Send the queries that are due and read the replies that were received.
+	 * Called by the IP-task on an eDNSEvent and when the DNS timer expires.
+	 */
+	void vDNSResolverProcess( void );
+
+	/*
+	 * Returns pdTRUE if xSocket is the socket of the DNS resolver.
+	 */
+	BaseType_t xIsDNSSocket( Socket_t xSocket );
+
+#endif /* ipconfigDNS_USE_RESOLVER */
+
 /*
  * FULL, UP-TO-DATE AND MAINTAINED REFERENCE DOCUMENTATION FOR ALL THESE
  * FUNCTIONS IS AVAILABLE ON THE FOLLOWING URL:
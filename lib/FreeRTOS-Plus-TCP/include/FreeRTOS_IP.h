@@ -108,6 +108,20 @@ struct xMAC_ADDRESS
 
 typedef struct xMAC_ADDRESS MACAddress_t;
 
+#if( ipconfigCACHE_STATS != 0 )
+	/* Counters of the ARP or the DNS cache.  Every search of the cache counts,
+	also the ones done to refresh or add an entry.  The hit rate is ulHits /
+	ulLookups, the average cost of a look-up is ulProbes / ulLookups.  The
+	counters wrap at 2^32. */
+	typedef struct xIP_CACHE_STATS
+	{
+		uint32_t ulLookups;			/* Number of look-ups. */
+		uint32_t ulHits;			/* Look-ups that found the IP address or name. */
+		uint32_t ulProbes;			/* Entries compared while looking up. */
+		uint32_t ulEvictions;		/* Entries replaced while still in use. */
+	} IPCacheStats_t;
+#endif /* ipconfigCACHE_STATS */
+
 typedef enum eNETWORK_EVENTS
 {
 	eNetworkUp,		/* The network is configured. */
@@ -254,6 +254,8 @@ typedef enum
 	eSocketCloseEvent,		/* 9: Send a message to the IP-task to close a socket. */
 	eSocketSelectEvent,		/*10: Send a message to the IP-task for select(). */
 	eSocketSignalEvent,		/*11: A socket must be signalled. */
+	eTCPConnectionsEvent,	/*12: IP-task is asked to take a snapshot of all TCP sockets. */
+	eDNSEvent,				/*13: Process the DNS resolver. */
 } eIPEvent_t;
 
 typedef struct IP_TASK_COMMANDS
@@ -435,6 +437,21 @@ eFrameProcessingResult_t eConsiderFrameForProcessing( const uint8_t * const pucE
  */
 uint16_t usGenerateChecksum( uint32_t ulSum, const uint8_t * pucNextData, size_t uxDataLengthBytes );
 
+/*
+ * Add uxWordCount 32-bit words to ullSum, without folding the carries.  Used
+ * by usGenerateChecksum() for the aligned bulk of the data.  A port can
+ * provide its own version by setting ipconfigPORT_CHECKSUM_SUM_WORDS to 1.
+ */
+uint64_t ullChecksumSumWords( uint64_t ullSum, const uint32_t *pulWords, size_t uxWordCount );
+
+/*
+ * Incremental update of an Internet checksum as described in RFC 1624, after
+ * a 16-bit or a 32-bit field in the packet has been changed from the old to
+ * the new value.  All values are passed as they are stored in the packet.
+ */
+uint16_t usChecksumUpdate16( uint16_t usChecksum, uint16_t usOldValue, uint16_t usNewValue );
+uint16_t usChecksumUpdate32( uint16_t usChecksum, uint32_t ulOldValue, uint32_t ulNewValue );
+
 /* Socket related private functions. */
 
 /* 
@@ -468,11 +485,35 @@ BaseType_t xIPIsNetworkTaskReady( void );
 	 */
 	void vTCPNetStat( void );
 
+	/*
+	 * Passed to the IP-task along with eTCPConnectionsEvent, see
+	 * FreeRTOS_GetTCPConnections().
+	 */
+	typedef struct xTCP_CONNECTIONS_REQUEST
+	{
+		TCPConnectionInfo_t *pxTable;	/* Table to be filled in. */
+		BaseType_t xMaxEntries;			/* Number of entries in pxTable. */
+		BaseType_t xCount;				/* Set to the total number of TCP sockets. */
+		TaskHandle_t xTaskToNotify;		/* Task that waits for the result, or NULL. */
+		volatile BaseType_t xDone;		/* Set to pdTRUE when the table has been filled in. */
+	} TCPConnectionsRequest_t;
+
+	/*
+	 * Called by the IP-task to fill in a table of TCP sockets.
+	 */
+	void vTCPConnectionsSnapshot( TCPConnectionsRequest_t *pxRequest );
+
 	/*
 	 * At least one socket needs to check for timeouts
 	 */
 	TickType_t xTCPTimerCheck( BaseType_t xWillSleep );
 
+	/*
+	 * Return the number of clock ticks before xTCPTimerCheck() has work to do,
+	 * or portMAX_DELAY when no TCP socket has an active timer.
+	 */
+	TickType_t xTCPTimerNextExpiry( void );
+
 	/* Every TCP socket has a buffer space just big enough to store
 	the last TCP header received.
 	As a reference of this field may be passed to DMA, force the
@@ -531,15 +572,20 @@ BaseType_t xIPIsNetworkTaskReady( void );
 				bFinLast : 1,		/* The last ACK (after FIN and FIN+ACK) has been sent or will be sent by the peer */
 				bRxStopped : 1,		/* Application asked to temporarily stop reception */
 				bMallocError : 1,	/* There was an error allocating a stream */
+				bTxPayloadSum : 1,	/* usTxPayloadSum holds the sum of the data in the packet being sent */
+				#if( ipconfigTCP_ZERO_COPY_TX != 0 )
+					bTxSegmentBuffer : 1,	/* The packet being sent is the buffer of a TX segment, it may not be released after sending */
+				#endif /* ipconfigTCP_ZERO_COPY_TX */
 				bWinScaling : 1;	/* A TCP-Window Scaling option was offered and accepted in the SYN phase. */
 		} bits;
 		uint32_t ulHighestRxAllowed;
 								/* The highest sequence number that we can receive at any moment */
-		uint16_t usTimeout;		/* Time (in ticks) after which this socket needs attention */
+		uint16_t usTimeout;		/* Time (in ticks) after which this socket needs attention, as set by vTCPTimerSchedule() */
 		uint16_t usCurMSS;		/* Current Maximum Segment Size */
 		uint16_t usInitMSS;		/* Initial maximum segment Size */
 		uint16_t usChildCount;	/* In case of a listening socket: number of connections on this port number */
 		uint16_t usBacklog;		/* In case of a listening socket: maximum number of concurrent connections on this port number */
+		uint16_t usTxPayloadSum;/* Checksum of the TCP payload as prepared by prvTCPPrepareSend(), valid when bTxPayloadSum is set */
 		uint8_t ucRepCount;		/* Send repeat count, for retransmissions
 								 * This counter is separate from the xmitCount in the
 								 * TCP win segments */
@@ -561,6 +607,12 @@ BaseType_t xIPIsNetworkTaskReady( void );
 		#if( ipconfigUSE_TCP_WIN == 1 )
 			NetworkBufferDescriptor_t *pxAckMessage;
 		#endif /* ipconfigUSE_TCP_WIN */
+		#if( ipconfigTCP_ZERO_COPY_TX != 0 )
+			/* Buffers passed to FreeRTOS_send() with FREERTOS_ZERO_COPY that
+			have not yet been handed to the TCP window.  The item value is the
+			position in txStream where their data starts. */
+			List_t xZeroCopyTxList;
+		#endif /* ipconfigTCP_ZERO_COPY_TX */
 		/* Buffer space to store the last TCP header received. */
 		LastTCPPacket_t xPacket;
 		uint8_t tcpflags;		/* TCP flags */
@@ -580,6 +632,19 @@ BaseType_t xIPIsNetworkTaskReady( void );
 		uint32_t ulRxCurWinSize;	/* Constantly changing: this is the current size available for data reception */
 		size_t uxRxWinSize;	/* Fixed value: size of the TCP reception window */
 		size_t uxTxWinSize;	/* Fixed value: size of the TCP transmit window */
+		#if( ipconfigTCP_CONNECTION_STATS != 0 )
+			/* Traffic counters, only written by the IP-task.  The number of
+			retransmissions is kept in xTCPWindow. */
+			uint32_t ulBytesIn;
+			uint32_t ulBytesOut;
+			uint32_t ulSegmentsIn;
+			uint32_t ulSegmentsOut;
+		#endif /* ipconfigTCP_CONNECTION_STATS */
+
+		/* The IP-task only looks at sockets in these lists, see xTCPTimerCheck(). */
+		ListItem_t xTimerListItem;	/* Entry in the list of active timers, the item value is the deadline */
+		ListItem_t xWakeUpListItem;	/* Entry in the list of sockets with events for the owner */
+		ListItem_t xAttendListItem;	/* Entry in the list of sockets that other tasks want attended */
 
 		TCPWindow_t xTCPWindow;
 	} IPTCPSocket_t;
@@ -638,6 +703,8 @@ typedef struct XSOCKET
 		/* These bits indicate the events which have actually occurred.
 		They are maintained by the IP-task */
 		EventBits_t xSocketBits;
+		/* Entry in the ready list of 'pxSocketSet'. */
+		ListItem_t xSelectListItem;
 	#endif /* ipconfigSUPPORT_SELECT_FUNCTION */
 	/* TCP/UDP specific fields: */
 	/* Before accessing any member of this structure, it should be confirmed */
@@ -662,6 +729,40 @@ typedef struct XSOCKET
 	 */
 	FreeRTOS_Socket_t *pxTCPSocketLookup( uint32_t ulLocalIP, UBaseType_t uxLocalPort, uint32_t ulRemoteIP, UBaseType_t uxRemotePort );
 
+	/*
+	 * Set the time (in ticks) after which the IP-task will attend to a TCP
+	 * socket, or stop its timer if xTimeout is zero.  When called from another
+	 * task, the IP-task applies the new value during its next xTCPTimerCheck().
+	 */
+	void vTCPTimerSchedule( FreeRTOS_Socket_t *pxSocket, TickType_t xTimeout );
+
+	/*
+	 * Ask the IP-task to attend to a TCP socket as soon as possible.  May be
+	 * called from any task, returns pdFAIL if the IP-task could not be woken up.
+	 */
+	BaseType_t xTCPTimerWakeUp( FreeRTOS_Socket_t *pxSocket );
+
+	/*
+	 * Called by the IP-task after setting xEventBits of a TCP socket: the
+	 * socket's owner will be woken up just before the IP-task blocks.
+	 */
+	void vSocketWakeUpUserDeferred( FreeRTOS_Socket_t *pxSocket );
+
+	#if( ( ipconfigUSE_LINKED_RX_MESSAGES != 0 ) && ( ipconfigUSE_TCP_WIN == 1 ) )
+		/*
+		 * Called by the IP-task before and after it processes a chain of
+		 * received packets.  In between, ACK's that would be sent immediately
+		 * are collected, vTCPRxBatchEnd() sends at most one ACK per socket.
+		 */
+		void vTCPRxBatchBegin( void );
+		void vTCPRxBatchEnd( void );
+
+		/*
+		 * A socket is being closed, remove it from the current batch.
+		 */
+		void vTCPRxBatchForget( FreeRTOS_Socket_t *pxSocket );
+	#endif
+
 #endif /* ipconfigUSE_TCP */
 
 /*
@@ -791,10 +892,17 @@ typedef struct xSOCKET_SET
 	EventGroupHandle_t xSelectGroup;
 	BaseType_t bApiCalled;	/* True if the API was calling  the private vSocketSelect */
 	FreeRTOS_Socket_t *pxSocket;
+	List_t xReadyList;		/* Sockets that may be ready, only these are checked by vSocketSelect() */
 } SocketSelect_t;
 
 extern void vSocketSelect( SocketSelect_t *pxSocketSelect );
 
+/*
+ * Called when a socket got an event that may make it ready: add it to the
+ * ready list of its socket set, unless it is already there.
+ */
+void vSocketSelectReady( FreeRTOS_Socket_t *pxSocket );
+
 #endif /* ipconfigSUPPORT_SELECT_FUNCTION */
 
 void vIPSetDHCPTimerEnableState( BaseType_t xEnableState );
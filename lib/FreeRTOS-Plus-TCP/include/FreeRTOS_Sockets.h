@@ -287,6 +287,58 @@ FreeRTOS_rx_size(). */
  */
 uint8_t *FreeRTOS_get_tx_head( Socket_t xSocket, BaseType_t *pxLength );
 
+#if( ipconfigTCP_ZERO_COPY_TX != 0 )
+	/*
+	 * Zero-copy transmission: obtain a buffer for at most '*pxMaxLength' bytes
+	 * (the MSS of the connection), fill it and pass it to FreeRTOS_send() with
+	 * the FREERTOS_ZERO_COPY flag.  When FreeRTOS_send() returns the number of
+	 * bytes, the buffer is owned by the IP-stack.  Otherwise it still belongs
+	 * to the application, which may try again or call
+	 * FreeRTOS_ReleaseTCPPayloadBuffer().
+	 */
+	void *FreeRTOS_GetTCPPayloadBuffer( Socket_t xSocket, size_t *pxMaxLength, TickType_t xBlockTimeTicks );
+	void FreeRTOS_ReleaseTCPPayloadBuffer( void *pvBuffer );
+#endif /* ipconfigTCP_ZERO_COPY_TX */
+
+#if( ipconfigTCP_CONNECTION_STATS != 0 )
+	/* Traffic counters of a TCP connection.  Byte counts only include the TCP
+	payload.  The counters are only written by the IP-task and wrap at 2^32. */
+	typedef struct xTCP_CONNECTION_STATS
+	{
+		uint32_t ulBytesIn;			/* Payload bytes received. */
+		uint32_t ulBytesOut;		/* Payload bytes sent, retransmissions included. */
+		uint32_t ulSegmentsIn;		/* Segments received. */
+		uint32_t ulSegmentsOut;		/* Segments sent, retransmissions and pure ACK's included. */
+		uint32_t ulRetransmits;		/* Segments sent again after a time-out or a fast retransmit. */
+	} TCPConnectionStats_t;
+
+	/* Copy the counters of a socket owned by the caller.  The counters are
+	32-bit words with a single writer, so no lock is taken. */
+	BaseType_t FreeRTOS_GetTCPStats( Socket_t xSocket, TCPConnectionStats_t *pxStats );
+#endif /* ipconfigTCP_CONNECTION_STATS */
+
+/* One entry of the table filled in by FreeRTOS_GetTCPConnections(). */
+typedef struct xTCP_CONNECTION_INFO
+{
+	uint32_t ulRemoteIP;		/* IP address of the peer, host-endian, 0 when not connected. */
+	uint16_t usRemotePort;		/* Port number of the peer, host-endian. */
+	uint16_t usLocalPort;		/* Local port number, host-endian. */
+	uint8_t ucTCPState;			/* One of the eTCP_STATE values, e.g. eESTABLISHED or eTCP_LISTEN. */
+	#if( ipconfigTCP_CONNECTION_STATS != 0 )
+		TCPConnectionStats_t xStats;
+	#endif
+} TCPConnectionInfo_t;
+
+/*
+ * Take a consistent snapshot of all bound TCP sockets.  The IP-task copies the
+ * sockets into pxTable in between two of its events, so there is no need to
+ * lock the socket list or to suspend the IP-task.  At most xMaxEntries entries
+ * are written.  Returns the total number of TCP sockets, which may be larger
+ * than xMaxEntries, or -pdFREERTOS_ERRNO_EWOULDBLOCK when the request could not
+ * be passed to the IP-task within xBlockTimeTicks.
+ */
+BaseType_t FreeRTOS_GetTCPConnections( TCPConnectionInfo_t *pxTable, BaseType_t xMaxEntries, TickType_t xBlockTimeTicks );
+
 #endif /* ipconfigUSE_TCP */
 
 /*
@@ -370,6 +422,7 @@ void FreeRTOS_netstat( void );
 	void FreeRTOS_FD_CLR( Socket_t xSocket, SocketSet_t xSocketSet, EventBits_t xBitsToClear );
 	EventBits_t FreeRTOS_FD_ISSET( Socket_t xSocket, SocketSet_t xSocketSet );
 	BaseType_t FreeRTOS_select( SocketSet_t xSocketSet, TickType_t xBlockTimeTicks );
+	BaseType_t FreeRTOS_GetReadySockets( SocketSet_t xSocketSet, Socket_t *pxSockets, BaseType_t xMaxSockets );
 
 #endif /* ipconfigSUPPORT_SELECT_FUNCTION */
 
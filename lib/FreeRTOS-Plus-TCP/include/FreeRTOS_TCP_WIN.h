@@ -48,6 +48,7 @@ typedef struct xTCP_SEGMENT
 	int32_t lMaxLength;				/* Maximum space, number of bytes which can be stored in this segment */
 	int32_t lDataLength;			/* Actual number of bytes */
 	int32_t lStreamPos;				/* reference to the [t|r]xStream of the socket */
+	uint16_t usPayloadSum;			/* Checksum of the data, calculated when first transmitted and used again for retransmissions */
 	TCPTimer_t xTransmitTimer;		/* saves a timestamp at the moment this segment gets transmitted (TX only) */
 	union
 	{
@@ -58,10 +59,14 @@ typedef struct xTCP_SEGMENT
 				ucDupAckCount : 8,	/* Counts the number of times that a higher segment was ACK'd. After 3 times a Fast Retransmission takes place */
 				bOutstanding : 1,	/* It the peer's turn, we're just waiting for an ACK */
 				bAcked : 1,			/* This segment has been acknowledged */
-				bIsForRx : 1;		/* pdTRUE if segment is used for reception */
+				bIsForRx : 1,		/* pdTRUE if segment is used for reception */
+				bPayloadSum : 1;	/* usPayloadSum is valid (TX only) */
 		} bits;
 		uint32_t ulFlags;
 	} u;
+#if( ipconfigTCP_ZERO_COPY_TX != 0 )
+	struct xNETWORK_BUFFER *pxBuffer;	/* TX only: network buffer which holds the payload of this segment, or NULL when the data is in txStream */
+#endif
 #if( ipconfigUSE_TCP_WIN != 0 )
 	struct xLIST_ITEM xQueueItem;	/* TX only: segments can be linked in one of three queues: xPriorityQueue, xTxQueue, and xWaitQueue */
 	struct xLIST_ITEM xListItem;	/* With this item the segment can be connected to a list, depending on who is owning it */
@@ -118,11 +123,15 @@ typedef struct xTCP_WINDOW
 	uint32_t ulNextTxSequenceNumber;	/* The sequence number given to the next byte to be added for transmission */
 	int32_t lSRTT;						/* Smoothed Round Trip Time, it may increment quickly and it decrements slower */
 	uint8_t ucOptionLength;				/* Number of valid bytes in ulOptionsData[] */
+#if( ipconfigTCP_CONNECTION_STATS != 0 )
+	uint32_t ulRetransmitCount;			/* Number of segments that were sent again */
+#endif
 #if( ipconfigUSE_TCP_WIN == 1 )
 	List_t xPriorityQueue;				/* Priority queue: segments which must be sent immediately */
 	List_t xTxQueue;					/* Transmit queue: segments queued for transmission */
 	List_t xWaitQueue;					/* Waiting queue:  outstanding segments */
 	TCPSegment_t *pxHeadSegment;		/* points to a segment which has not been transmitted and it's size is still growing (user data being added) */
+	TCPSegment_t *pxTxSegment;			/* The segment returned by the last successful call to ulTCPWindowTxGet(), or NULL */
 	uint32_t ulOptionsData[ipSIZE_TCP_OPTIONS/sizeof(uint32_t)];	/* Contains the options we send out */
 	List_t xTxSegments;					/* A linked list of all transmission segments, sorted on sequence number */
 	List_t xRxSegments;					/* A linked list of reception segments, order depends on sequence of arrival */
@@ -187,6 +196,13 @@ void vTCPWinShowSegments( TCPWindow_t *pxWindow, BaseType_t bForRx );
 /* Adds data to the Tx-window */
 int32_t lTCPWindowTxAdd( TCPWindow_t *pxWindow, uint32_t ulLength, int32_t lPosition, int32_t lMax );
 
+#if( ipconfigTCP_ZERO_COPY_TX != 0 )
+	/* Adds a segment whose payload is stored in a network buffer.  The window
+	 * takes ownership of the buffer, it will be released once the segment
+	 * has been acknowledged.  Returns pdFAIL if no segment was available. */
+	BaseType_t xTCPWindowTxAddBuffer( TCPWindow_t *pxWindow, struct xNETWORK_BUFFER *pxBuffer, uint32_t ulLength, int32_t lPosition );
+#endif
+
 /* Check data to be sent and calculate the time period we may sleep */
 BaseType_t xTCPWindowTxHasData( TCPWindow_t *pxWindow, uint32_t ulWindowSize, TickType_t *pulDelay );
 
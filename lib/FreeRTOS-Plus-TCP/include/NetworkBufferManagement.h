@@ -54,6 +54,23 @@ In case BufferAllocation_2.c is used, the new space must be allocated. */
 NetworkBufferDescriptor_t *pxResizeNetworkBufferWithDescriptor( NetworkBufferDescriptor_t * pxNetworkBuffer,
 	size_t xNewSizeBytes );
 
+#if( ipconfigBUFFER_ALLOCATION_SLABS != 0 )
+	/* Only available with BufferAllocation_3.c.  Get up to 'uxCount' network
+	buffers of at least 'xRequestedSizeBytes' bytes while taking the lock only
+	once.  Doesn't block, returns the number of buffers stored in ppxBuffers[]. */
+	UBaseType_t uxGetNetworkBuffersWithDescriptor( NetworkBufferDescriptor_t **ppxBuffers, UBaseType_t uxCount,
+		size_t xRequestedSizeBytes );
+
+	/* Release 'uxCount' network buffers while taking the lock only once.  NULL
+	entries are skipped. */
+	void vReleaseNetworkBuffersAndDescriptors( NetworkBufferDescriptor_t * const *ppxBuffers, UBaseType_t uxCount );
+
+	/* Let a driver reuse a buffer that it owns, e.g. after dropping a received
+	frame, without returning it to the pool.  xDataLength is set to the full
+	size of the buffer. */
+	void vNetworkBufferRecycle( NetworkBufferDescriptor_t * const pxNetworkBuffer );
+#endif /* ipconfigBUFFER_ALLOCATION_SLABS */
+
 #if ipconfigTCP_IP_SANITY
 	/*
 	 * Check if an address is a valid pointer to a network descriptor
@@ -64,11 +64,43 @@ entry is still valid and can therefore be refreshed. */
  */
 static eARPLookupResult_t prvCacheLookup( uint32_t ulAddressToLookup, MACAddress_t * const pxMACAddress );
 
+/*
+ * Return the hash bucket of an IP address.
+ */
+static BaseType_t prvHashIPAddress( uint32_t ulIPAddress );
+
+/*
+ * Find the row of the ARP cache that holds ulIPAddress, or -1.
+ */
+static BaseType_t prvFindCacheEntry( uint32_t ulIPAddress );
+
+/*
+ * Change the IP address of a row of the ARP cache, and move the row to the
+ * hash bucket of the new address.
+ */
+static void prvSetCacheEntryAddress( BaseType_t xEntry, uint32_t ulIPAddress );
+
+/*
+ * Remove a row from the hash index and clear it.
+ */
+static void prvClearCacheEntry( BaseType_t xEntry );
+
 /*-----------------------------------------------------------*/
 
 /* The ARP cache. */
 static ARPCacheRow_t xARPCache[ ipconfigARP_CACHE_ENTRIES ];
 
+/* The hash index of the ARP cache.  A bucket holds the index plus one of the
+first row with that hash, rows are chained through usARPHashNext[].  Zero marks
+the end of a chain, so a cleared index is empty.  Rows with a zero IP address
+are not in the index. */
+static uint16_t usARPHashHeads[ ipconfigARP_CACHE_HASH_BUCKETS ];
+static uint16_t usARPHashNext[ ipconfigARP_CACHE_ENTRIES ];
+
+#if( ipconfigCACHE_STATS != 0 )
+	static IPCacheStats_t xARPCacheStats;
+#endif
+
 /* The time at which the last gratuitous ARP was sent.  Gratuitous ARPs are used
 to ensure ARP tables are up to date and to detect IP address conflicts. */
 static TickType_t xLastGratuitousARPTime = ( TickType_t ) 0;
@@ -198,7 +230,7 @@ uint32_t ulTargetProtocolAddress, ulSenderProtocolAddress;
 			if( ( memcmp( xARPCache[ x ].xMACAddress.ucBytes, pxMACAddress->ucBytes, sizeof( pxMACAddress->ucBytes ) ) == 0 ) )
 			{
 				lResult = xARPCache[ x ].ulIPAddress;
-				memset( &xARPCache[ x ], '\0', sizeof( xARPCache[ x ] ) );
+				prvClearCacheEntry( x );
 				break;
 			}
 		}
@@ -236,40 +268,40 @@ uint8_t ucMinAgeFound = 0U;
 		/* Start with the maximum possible number. */
 		ucMinAgeFound--;
 
-		/* For each entry in the ARP cache table. */
-		for( x = 0; x < ipconfigARP_CACHE_ENTRIES; x++ )
+		/* Does the cache table hold an entry for the IP address being
+		queried? */
+		xIpEntry = prvFindCacheEntry( ulIPAddress );
+
+		if( ( xIpEntry >= 0 ) && ( pxMACAddress != NULL ) )
 		{
-			/* Does this line in the cache table hold an entry for the IP
-			address	being queried? */
-			if( xARPCache[ x ].ulIPAddress == ulIPAddress )
+			/* See if the MAC-address also matches. */
+			if( memcmp( xARPCache[ xIpEntry ].xMACAddress.ucBytes, pxMACAddress->ucBytes, sizeof( pxMACAddress->ucBytes ) ) == 0 )
 			{
-				if( pxMACAddress == NULL )
-				{
-					/* In case the parameter pxMACAddress is NULL, an entry will be reserved to
-					indicate that there is an outstanding ARP request, This entry will have
-					"ucValid == pdFALSE". */
-					xIpEntry = x;
-					break;
-				}
+				/* This function will be called for each received packet
+				As this is by far the most common path the coding standard
+				is relaxed in this case and a return is permitted as an
+				optimisation. */
+				xARPCache[ xIpEntry ].ucAge = ( uint8_t ) ipconfigMAX_ARP_AGE;
+				xARPCache[ xIpEntry ].ucValid = ( uint8_t ) pdTRUE;
+				return;
+			}
 
-				/* See if the MAC-address also matches. */
-				if( memcmp( xARPCache[ x ].xMACAddress.ucBytes, pxMACAddress->ucBytes, sizeof( pxMACAddress->ucBytes ) ) == 0 )
-				{
-					/* This function will be called for each received packet
-					As this is by far the most common path the coding standard
-					is relaxed in this case and a return is permitted as an
-					optimisation. */
-					xARPCache[ x ].ucAge = ( uint8_t ) ipconfigMAX_ARP_AGE;
-					xARPCache[ x ].ucValid = ( uint8_t ) pdTRUE;
-					return;
-				}
+			/* Found an entry containing ulIPAddress, but the MAC address
+			doesn't match.  Might be an entry with ucValid=pdFALSE, waiting
+			for an ARP reply.  Still want to see if there is match with the
+			given MAC address.ucBytes.  If found, either of the two entries
+			must be cleared. */
+		}
 
-				/* Found an entry containing ulIPAddress, but the MAC address
-				doesn't match.  Might be an entry with ucValid=pdFALSE, waiting
-				for an ARP reply.  Still want to see if there is match with the
-				given MAC address.ucBytes.  If found, either of the two entries
-				must be cleared. */
-				xIpEntry = x;
+		/* For each entry in the ARP cache table, look for an entry with the
+		same MAC address, and remember the oldest entry. */
+		for( x = 0; x < ipconfigARP_CACHE_ENTRIES; x++ )
+		{
+			if( x == xIpEntry )
+			{
+				/* In case the parameter pxMACAddress is NULL, this entry is
+				reserved to indicate that there is an outstanding ARP request.
+				This entry will have "ucValid == pdFALSE". */
 			}
 			else if( ( pxMACAddress != NULL ) && ( memcmp( xARPCache[ x ].xMACAddress.ucBytes, pxMACAddress->ucBytes, sizeof( pxMACAddress->ucBytes ) ) == 0 ) )
 			{
@@ -313,7 +345,7 @@ uint8_t ucMinAgeFound = 0U;
 				/* Both the MAC address as well as the IP address were found in
 				different locations: clear the entry which matches the
 				IP-address */
-				memset( &xARPCache[ xIpEntry ], '\0', sizeof( xARPCache[ xIpEntry ] ) );
+				prvClearCacheEntry( xIpEntry );
 			}
 		}
 		else if( xIpEntry >= 0 )
@@ -321,9 +353,20 @@ uint8_t ucMinAgeFound = 0U;
 			/* An entry containing the IP-address was found, but it had a different MAC address */
 			xUseEntry = xIpEntry;
 		}
+		else
+		{
+			#if( ipconfigCACHE_STATS != 0 )
+			{
+				if( ( xARPCache[ xUseEntry ].ulIPAddress != 0UL ) && ( xARPCache[ xUseEntry ].ucAge > 0U ) )
+				{
+					xARPCacheStats.ulEvictions++;
+				}
+			}
+			#endif /* ipconfigCACHE_STATS */
+		}
 
 		/* If the entry was not found, we use the oldest entry and set the IPaddress */
-		xARPCache[ xUseEntry ].ulIPAddress = ulIPAddress;
+		prvSetCacheEntryAddress( xUseEntry, ulIPAddress );
 
 		if( pxMACAddress != NULL )
 		{
@@ -463,30 +506,113 @@ static eARPLookupResult_t prvCacheLookup( uint32_t ulAddressToLookup, MACAddress
 BaseType_t x;
 eARPLookupResult_t eReturn = eARPCacheMiss;
 
-	/* Loop through each entry in the ARP cache. */
-	for( x = 0; x < ipconfigARP_CACHE_ENTRIES; x++ )
+	/* Does a row in the ARP cache table hold an entry for the IP address being
+	queried? */
+	x = prvFindCacheEntry( ulAddressToLookup );
+
+	if( x >= 0 )
 	{
-		/* Does this row in the ARP cache table hold an entry for the IP address
-		being queried? */
-		if( xARPCache[ x ].ulIPAddress == ulAddressToLookup )
+		/* A matching valid entry was found. */
+		if( xARPCache[ x ].ucValid == ( uint8_t ) pdFALSE )
 		{
-			/* A matching valid entry was found. */
-			if( xARPCache[ x ].ucValid == ( uint8_t ) pdFALSE )
+			/* This entry is waiting an ARP reply, so is not valid. */
+			eReturn = eCantSendPacket;
+		}
+		else
+		{
+			/* A valid entry was found. */
+			memcpy( pxMACAddress->ucBytes, xARPCache[ x ].xMACAddress.ucBytes, sizeof( MACAddress_t ) );
+			eReturn = eARPCacheHit;
+		}
+	}
+
+	return eReturn;
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvHashIPAddress( uint32_t ulIPAddress )
+{
+	/* The addresses of local peers mostly differ in their last byte.  The
+	multiplication spreads every byte over the top bits of the product. */
+	return ( BaseType_t ) ( ( ( uint32_t ) ( ulIPAddress * 0x9E3779B1UL ) ) >> 24 ) & ( ipconfigARP_CACHE_HASH_BUCKETS - 1 );
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvFindCacheEntry( uint32_t ulIPAddress )
+{
+BaseType_t xReturn = -1;
+uint16_t usNext;
+
+	#if( ipconfigCACHE_STATS != 0 )
+	{
+		xARPCacheStats.ulLookups++;
+	}
+	#endif /* ipconfigCACHE_STATS */
+
+	for( usNext = usARPHashHeads[ prvHashIPAddress( ulIPAddress ) ]; usNext != 0U; usNext = usARPHashNext[ usNext - 1U ] )
+	{
+		#if( ipconfigCACHE_STATS != 0 )
+		{
+			xARPCacheStats.ulProbes++;
+		}
+		#endif /* ipconfigCACHE_STATS */
+
+		if( xARPCache[ usNext - 1U ].ulIPAddress == ulIPAddress )
+		{
+			xReturn = ( BaseType_t ) usNext - 1;
+
+			#if( ipconfigCACHE_STATS != 0 )
 			{
-				/* This entry is waiting an ARP reply, so is not valid. */
-				eReturn = eCantSendPacket;
+				xARPCacheStats.ulHits++;
 			}
-			else
+			#endif /* ipconfigCACHE_STATS */
+			break;
+		}
+	}
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+static void prvSetCacheEntryAddress( BaseType_t xEntry, uint32_t ulIPAddress )
+{
+uint16_t *pusLink;
+
+	if( xARPCache[ xEntry ].ulIPAddress != ulIPAddress )
+	{
+		if( xARPCache[ xEntry ].ulIPAddress != 0UL )
+		{
+			/* Unlink the row from the bucket of its current address. */
+			pusLink = &( usARPHashHeads[ prvHashIPAddress( xARPCache[ xEntry ].ulIPAddress ) ] );
+
+			while( *pusLink != 0U )
 			{
-				/* A valid entry was found. */
-				memcpy( pxMACAddress->ucBytes, xARPCache[ x ].xMACAddress.ucBytes, sizeof( MACAddress_t ) );
-				eReturn = eARPCacheHit;
+				if( *pusLink == ( uint16_t ) ( xEntry + 1 ) )
+				{
+					*pusLink = usARPHashNext[ xEntry ];
+					break;
+				}
+
+				pusLink = &( usARPHashNext[ *pusLink - 1U ] );
 			}
-			break;
+		}
+
+		xARPCache[ xEntry ].ulIPAddress = ulIPAddress;
+
+		if( ulIPAddress != 0UL )
+		{
+			pusLink = &( usARPHashHeads[ prvHashIPAddress( ulIPAddress ) ] );
+			usARPHashNext[ xEntry ] = *pusLink;
+			*pusLink = ( uint16_t ) ( xEntry + 1 );
 		}
 	}
+}
+/*-----------------------------------------------------------*/
 
-	return eReturn;
+static void prvClearCacheEntry( BaseType_t xEntry )
+{
+	prvSetCacheEntryAddress( xEntry, 0UL );
+	memset( &xARPCache[ xEntry ], '\0', sizeof( xARPCache[ xEntry ] ) );
 }
 /*-----------------------------------------------------------*/
 
@@ -527,7 +653,7 @@ TickType_t xTimeNow;
 			{
 				/* The entry is no longer valid.  Wipe it out. */
 				iptraceARP_TABLE_ENTRY_EXPIRED( xARPCache[ x ].ulIPAddress );
-				xARPCache[ x ].ulIPAddress = 0UL;
+				prvSetCacheEntryAddress( x, 0UL );
 			}
 		}
 	}
@@ -618,9 +744,21 @@ ARPPacket_t *pxARPPacket;
 void FreeRTOS_ClearARP( void )
 {
 	memset( xARPCache, '\0', sizeof( xARPCache ) );
+	memset( usARPHashHeads, '\0', sizeof( usARPHashHeads ) );
+	memset( usARPHashNext, '\0', sizeof( usARPHashNext ) );
 }
 /*-----------------------------------------------------------*/
 
+#if( ipconfigCACHE_STATS != 0 )
+
+	void FreeRTOS_GetARPCacheStats( IPCacheStats_t *pxStats )
+	{
+		*pxStats = xARPCacheStats;
+	}
+
+#endif /* ipconfigCACHE_STATS */
+/*-----------------------------------------------------------*/
+
 #if( ipconfigHAS_PRINTF != 0 ) || ( ipconfigHAS_DEBUG_PRINTF != 0 )
 
 	void FreeRTOS_PrintARPCache( void )
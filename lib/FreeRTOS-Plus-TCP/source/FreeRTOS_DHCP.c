@@ -62,6 +62,13 @@
 	#define dhcpINITIAL_DHCP_TX_PERIOD			( pdMS_TO_TICKS( 5000 ) )
 #endif
 
+/* A stored lease is requested with a shorter period, and only for a few
+seconds, before falling back to the discover/offer exchange. */
+#ifndef dhcpINIT_REBOOT_TX_PERIOD
+	#define dhcpINIT_REBOOT_TX_PERIOD			( pdMS_TO_TICKS( 1000 ) )
+	#define dhcpINIT_REBOOT_MAX_TX_PERIOD		( pdMS_TO_TICKS( 4000 ) )
+#endif
+
 /* Codes of interest found in the DHCP options field. */
 #define dhcpZERO_PAD_OPTION_CODE				( 0u )
 #define dhcpSUBNET_MASK_OPTION_CODE				( 1u )
@@ -174,6 +181,8 @@ struct xDHCP_DATA
 	TickType_t xDHCPTxPeriod;
 	/* Try both without and with the broadcast flag */
 	BaseType_t xUseBroadcast;
+	/* Requesting a stored lease, without naming the server (INIT-REBOOT). */
+	BaseType_t xInitReboot;
 	/* Maintains the DHCP state machine state. */
 	eDHCPState_t eDHCPState;
 	/* The UDP socket used for all incoming and outgoing DHCP traffic. */
@@ -227,6 +236,21 @@ static uint8_t *prvCreatePartDHCPMessage( struct freertos_sockaddr *pxAddress, B
  */
 static void prvCreateDHCPSocket( void );
 
+/*
+ * Request the address of a lease that was stored by the application.  Returns
+ * pdTRUE when the request was sent.
+ */
+#if( ipconfigDHCP_USE_LEASE_STORE != 0 )
+	static BaseType_t prvStartInitReboot( void );
+#endif
+
+/*
+ * Pass the lease that was just acknowledged to the application.
+ */
+#if( ipconfigDHCP_USE_LEASE_STORE != 0 )
+	static void prvStoreLease( void );
+#endif
+
 /*
  * After DHCP has failed to answer, prepare everything to start searching
  * for (trying-out) LinkLayer IP-addresses, using the random method: Send
@@ -271,6 +295,17 @@ BaseType_t xGivingUp = pdFALSE;
 	if( xReset != pdFALSE )
 	{
 		xDHCPData.eDHCPState = eWaitingSendFirstDiscover;
+
+		#if( ipconfigDHCP_USE_LEASE_STORE != 0 )
+		{
+			/* Ask for the previous address first.  If it is not acknowledged
+			in time, eWaitingAcknowledge starts the discover phase. */
+			if( prvStartInitReboot() != pdFALSE )
+			{
+				xDHCPData.eDHCPState = eWaitingAcknowledge;
+			}
+		}
+		#endif /* ipconfigDHCP_USE_LEASE_STORE */
 	}
 
 	switch( xDHCPData.eDHCPState )
@@ -438,6 +473,13 @@ BaseType_t xGivingUp = pdFALSE;
 					/* The lease time is already valid. */
 				}
 
+				#if( ipconfigDHCP_USE_LEASE_STORE != 0 )
+				{
+					xDHCPData.xInitReboot = pdFALSE;
+					prvStoreLease();
+				}
+				#endif /* ipconfigDHCP_USE_LEASE_STORE */
+
 				/* Check for clashes. */
 				vARPSendGratuitous();
 				vIPReloadDHCPTimer( xDHCPData.ulLeaseTime );
@@ -447,11 +489,23 @@ BaseType_t xGivingUp = pdFALSE;
 				/* Is it time to send another Discover? */
 				if( ( xTaskGetTickCount() - xDHCPData.xDHCPTxTime ) > xDHCPData.xDHCPTxPeriod )
 				{
+				TickType_t xMaximumPeriod = ipconfigMAXIMUM_DISCOVER_TX_PERIOD;
+
+					#if( ipconfigDHCP_USE_LEASE_STORE != 0 )
+					{
+						if( xDHCPData.xInitReboot != pdFALSE )
+						{
+							/* Do not wait long for the stored address. */
+							xMaximumPeriod = dhcpINIT_REBOOT_MAX_TX_PERIOD;
+						}
+					}
+					#endif /* ipconfigDHCP_USE_LEASE_STORE */
+
 					/* Increase the time period, and if it has not got to the
 					point of giving up - send another request. */
 					xDHCPData.xDHCPTxPeriod <<= 1;
 
-					if( xDHCPData.xDHCPTxPeriod <= ipconfigMAXIMUM_DISCOVER_TX_PERIOD )
+					if( xDHCPData.xDHCPTxPeriod <= xMaximumPeriod )
 					{
 						xDHCPData.xDHCPTxTime = xTaskGetTickCount();
 						prvSendDHCPRequest( );
@@ -600,6 +654,7 @@ static void prvInitialiseDHCP( void )
 	if( 0 != xDHCPData.ulTransactionId )
 	{
 		xDHCPData.xUseBroadcast = 0;
+		xDHCPData.xInitReboot = pdFALSE;
 		xDHCPData.ulOfferedIPAddress = 0UL;
 		xDHCPData.ulDHCPServerAddress = 0UL;
 		xDHCPData.xDHCPTxPeriod = dhcpINITIAL_DHCP_TX_PERIOD;
@@ -711,6 +766,13 @@ const uint32_t ulMandatoryOptions = 2ul; /* DHCP server address, and the correct
 								{
 									/* Start again. */
 									xDHCPData.eDHCPState = eWaitingSendFirstDiscover;
+
+									#if( ipconfigDHCP_USE_LEASE_STORE != 0 )
+									{
+										/* The address may not be used any more. */
+										vApplicationDHCPStoreLease( NULL );
+									}
+									#endif /* ipconfigDHCP_USE_LEASE_STORE */
 								}
 							}
 							else
@@ -755,6 +817,13 @@ const uint32_t ulMandatoryOptions = 2ul; /* DHCP server address, and the correct
 									ulProcessed++;
 									xDHCPData.ulDHCPServerAddress = ulParameter;
 								}
+								else if( xDHCPData.xInitReboot != pdFALSE )
+								{
+									/* The request did not name a server,
+									remember the one that acknowledged it. */
+									ulProcessed++;
+									xDHCPData.ulDHCPServerAddress = ulParameter;
+								}
 								else
 								{
 									/* The ack must come from the expected server. */
@@ -913,16 +982,39 @@ static const uint8_t ucDHCPRequestOptions[] =
 };
 size_t xOptionsLength = sizeof( ucDHCPRequestOptions );
 
-	pucUDPPayloadBuffer = prvCreatePartDHCPMessage( &xAddress, dhcpREQUEST_OPCODE, ucDHCPRequestOptions, &xOptionsLength );
+#if( ipconfigDHCP_USE_LEASE_STORE != 0 )
+	/* An INIT-REBOOT request must not name the server, and asks for the
+	parameters because there was no offer. */
+	static const uint8_t ucDHCPInitRebootOptions[] =
+	{
+		/* Do not change the ordering without also changing
+		dhcpCLIENT_IDENTIFIER_OFFSET and dhcpREQUESTED_IP_ADDRESS_OFFSET. */
+		dhcpMESSAGE_TYPE_OPTION_CODE, 1, dhcpMESSAGE_TYPE_REQUEST,		/* Message type option. */
+		dhcpCLIENT_IDENTIFIER_OPTION_CODE, 6, 0, 0, 0, 0, 0, 0,			/* Client identifier. */
+		dhcpREQUEST_IP_ADDRESS_OPTION_CODE, 4, 0, 0, 0, 0,				/* The IP address being requested. */
+		dhcpPARAMETER_REQUEST_OPTION_CODE, 3, dhcpSUBNET_MASK_OPTION_CODE, dhcpGATEWAY_OPTION_CODE, dhcpDNS_SERVER_OPTIONS_CODE,	/* Parameter request option. */
+		dhcpOPTION_END_BYTE
+	};
+
+	if( xDHCPData.xInitReboot != pdFALSE )
+	{
+		xOptionsLength = sizeof( ucDHCPInitRebootOptions );
+		pucUDPPayloadBuffer = prvCreatePartDHCPMessage( &xAddress, dhcpREQUEST_OPCODE, ucDHCPInitRebootOptions, &xOptionsLength );
+	}
+	else
+#endif /* ipconfigDHCP_USE_LEASE_STORE */
+	{
+		pucUDPPayloadBuffer = prvCreatePartDHCPMessage( &xAddress, dhcpREQUEST_OPCODE, ucDHCPRequestOptions, &xOptionsLength );
+
+		/* Copy in the address of the DHCP server being used. */
+		memcpy( ( void * ) &( pucUDPPayloadBuffer[ dhcpFIRST_OPTION_BYTE_OFFSET + dhcpDHCP_SERVER_IP_ADDRESS_OFFSET ] ),
+			( void * ) &( xDHCPData.ulDHCPServerAddress ), sizeof( xDHCPData.ulDHCPServerAddress ) );
+	}
 
 	/* Copy in the IP address being requested. */
 	memcpy( ( void * ) &( pucUDPPayloadBuffer[ dhcpFIRST_OPTION_BYTE_OFFSET + dhcpREQUESTED_IP_ADDRESS_OFFSET ] ),
 		( void * ) &( xDHCPData.ulOfferedIPAddress ), sizeof( xDHCPData.ulOfferedIPAddress ) );
 
-	/* Copy in the address of the DHCP server being used. */
-	memcpy( ( void * ) &( pucUDPPayloadBuffer[ dhcpFIRST_OPTION_BYTE_OFFSET + dhcpDHCP_SERVER_IP_ADDRESS_OFFSET ] ),
-		( void * ) &( xDHCPData.ulDHCPServerAddress ), sizeof( xDHCPData.ulDHCPServerAddress ) );
-
 	FreeRTOS_debug_printf( ( "vDHCPProcess: reply %lxip\n", FreeRTOS_ntohl( xDHCPData.ulOfferedIPAddress ) ) );
 	iptraceSENDING_DHCP_REQUEST();
 
@@ -963,6 +1055,67 @@ size_t xOptionsLength = sizeof( ucDHCPDiscoverOptions );
 }
 /*-----------------------------------------------------------*/
 
+#if( ipconfigDHCP_USE_LEASE_STORE != 0 )
+
+	static BaseType_t prvStartInitReboot( void )
+	{
+	DHCPLease_t xLease;
+	BaseType_t xReturn = pdFALSE;
+
+		memset( ( void * ) &xLease, 0x00, sizeof( xLease ) );
+
+		if( ( xApplicationDHCPLoadLease( &xLease ) != pdFALSE ) && ( xLease.ulIPAddress != 0UL ) )
+		{
+		#if( ipconfigUSE_DHCP_HOOK != 0 )
+			/* Ask the user if the stored address may be requested. */
+			if( xApplicationDHCPHook( eDHCPPhasePreRequest, xLease.ulIPAddress ) == eDHCPContinue )
+		#endif	/* ipconfigUSE_DHCP_HOOK */
+			{
+				prvInitialiseDHCP();
+
+				if( ( xDHCPData.xDHCPSocket != NULL ) && ( xDHCPData.ulTransactionId != 0UL ) )
+				{
+					/* The parameters of the lease are used until the
+					acknowledgement brings new ones. */
+					xNetworkAddressing.ulNetMask = xLease.ulNetMask;
+					xNetworkAddressing.ulGatewayAddress = xLease.ulGatewayAddress;
+					xNetworkAddressing.ulDNSServerAddress = xLease.ulDNSServerAddress;
+
+					*ipLOCAL_IP_ADDRESS_POINTER = 0UL;
+
+					FreeRTOS_debug_printf( ( "vDHCPProcess: init-reboot %lxip\n", FreeRTOS_ntohl( xLease.ulIPAddress ) ) );
+
+					xDHCPData.xInitReboot = pdTRUE;
+					xDHCPData.ulOfferedIPAddress = xLease.ulIPAddress;
+					xDHCPData.xDHCPTxTime = xTaskGetTickCount();
+					xDHCPData.xDHCPTxPeriod = dhcpINIT_REBOOT_TX_PERIOD;
+					prvSendDHCPRequest( );
+					xReturn = pdTRUE;
+				}
+			}
+		}
+
+		return xReturn;
+	}
+	/*-----------------------------------------------------------*/
+
+	static void prvStoreLease( void )
+	{
+	DHCPLease_t xLease;
+
+		xLease.ulIPAddress = xDHCPData.ulOfferedIPAddress;
+		xLease.ulServerAddress = xDHCPData.ulDHCPServerAddress;
+		xLease.ulNetMask = xNetworkAddressing.ulNetMask;
+		xLease.ulGatewayAddress = xNetworkAddressing.ulGatewayAddress;
+		xLease.ulDNSServerAddress = xNetworkAddressing.ulDNSServerAddress;
+		xLease.ulRenewalSeconds = xDHCPData.ulLeaseTime / configTICK_RATE_HZ;
+
+		vApplicationDHCPStoreLease( &xLease );
+	}
+
+#endif /* ipconfigDHCP_USE_LEASE_STORE */
+/*-----------------------------------------------------------*/
+
 #if( ipconfigDHCP_FALL_BACK_AUTO_IP != 0 )
 
 	static void prvPrepareLinkLayerIPLookUp( void )
@@ -142,17 +142,45 @@ static uint32_t prvGetHostByName( const char *pcHostName, TickType_t xIdentifier
 	static uint8_t *prvReadNameField( uint8_t *pucByte, size_t xSourceLen, char *pcName, size_t xLen );
 	static void prvProcessDNSCache( const char *pcName, uint32_t *pulIP, uint32_t ulTTL, BaseType_t xLookUp );
 
+	static uint32_t prvHashName( const char *pcName );
+	static BaseType_t prvFindCacheEntry( const char *pcName, uint32_t ulNameHash );
+	static void prvUnlinkCacheEntry( BaseType_t xEntry );
+	static BaseType_t prvNewCacheEntry( const char *pcName, uint32_t ulNameHash );
+
 	typedef struct xDNS_CACHE_TABLE_ROW
 	{
-		uint32_t ulIPAddress;		/* The IP address of an ARP cache entry. */
-		char pcName[ ipconfigDNS_CACHE_NAME_LENGTH ];  /* The name of the host */
-		uint32_t ulTTL; /* Time-to-Live (in seconds) from the DNS server. */
-		uint32_t ulTimeWhenAddedInSeconds;
+		uint32_t ulIPAddresses[ ipconfigDNS_CACHE_ADDRESSES_PER_ENTRY ];	/* The IP addresses of the host. */
+		uint32_t ulExpiryTimes[ ipconfigDNS_CACHE_ADDRESSES_PER_ENTRY ];	/* The time (in seconds) at which each address expires. */
+		uint32_t ulNameHash;		/* The hash of pcName, compared before the name itself. */
+		uint32_t ulLastUsed;		/* The value of ulDNSCacheClock when the entry was last used. */
+		uint16_t usHashNext;		/* The index plus one of the next entry in the same hash bucket, or zero. */
+		uint8_t ucNumIPAddresses;	/* The number of valid addresses in ulIPAddresses[]. */
+		uint8_t ucCurrentIPAddress;	/* The address that will be handed out by the next look-up. */
+		char pcName[ ipconfigDNS_CACHE_NAME_LENGTH ];  /* The name of the host, empty when the entry is free. */
 	} DNSCacheRow_t;
 
 	static DNSCacheRow_t xDNSCache[ ipconfigDNS_CACHE_ENTRIES ];
+
+	/* The hash index of the DNS cache.  A bucket holds the index plus one of
+	the first entry with that hash, zero when the bucket is empty. */
+	static uint16_t usDNSHashHeads[ ipconfigDNS_CACHE_HASH_BUCKETS ];
+
+	/* Counts the uses of the cache, to find the least recently used entry. */
+	static uint32_t ulDNSCacheClock = 0UL;
+
+	#if( ipconfigCACHE_STATS != 0 )
+		static IPCacheStats_t xDNSCacheStats;
+	#endif
 #endif /* ipconfigUSE_DNS_CACHE == 1 */
 
+/* When the cache can store more than one address per name, all A records of a
+reply are read. */
+#if( ipconfigUSE_DNS_CACHE == 1 ) && ( ipconfigDNS_CACHE_ADDRESSES_PER_ENTRY > 1 )
+	#define dnsREAD_ALL_A_RECORDS		1
+#else
+	#define dnsREAD_ALL_A_RECORDS		0
+#endif
+
 #if( ipconfigUSE_LLMNR == 1 )
 	const MACAddress_t xLLMNR_MacAdress = { { 0x01, 0x00, 0x5e, 0x00, 0x00, 0xfc } };
 #endif	/* ipconfigUSE_LLMNR == 1 */
@@ -259,9 +287,69 @@ typedef struct xDNSAnswerRecord DNSAnswerRecord_t;
 		prvProcessDNSCache( pcHostName, &ulIPAddress, 0, pdTRUE );
 		return ulIPAddress;
 	}
+/*-----------------------------------------------------------*/
+
+	#if( ipconfigCACHE_STATS != 0 )
+		void FreeRTOS_GetDNSCacheStats( IPCacheStats_t *pxStats )
+		{
+			*pxStats = xDNSCacheStats;
+		}
+	#endif /* ipconfigCACHE_STATS */
 #endif /* ipconfigUSE_DNS_CACHE == 1 */
 /*-----------------------------------------------------------*/
 
+#if( ipconfigDNS_USE_RESOLVER != 0 )
+	/*
+	 * Start looking up a name in the IP-task, or join a look-up of the same
+	 * name that is already in progress.  Returns pdFALSE when all query slots
+	 * are in use, the caller must then send its own DNS request.
+	 */
+	static BaseType_t prvStartQuery( const char *pcHostName, FOnDNSEvent pCallback, void *pvSearchID, TickType_t xTimeout );
+
+	/*
+	 * Look up a name in the IP-task and block until the reply was received.
+	 * Returns pdFALSE when no query could be started.
+	 */
+	static BaseType_t prvWaitForQuery( const char *pcHostName, uint32_t *pulIPAddress );
+
+	/*
+	 * Send the queries that are due, or give up on the queries that have been
+	 * sent ipconfigDNS_REQUEST_ATTEMPTS times.
+	 */
+	static void prvSendQueries( void );
+
+	/*
+	 * Read the replies that were received on the resolver socket.
+	 */
+	static void prvReadReplies( void );
+
+	/* A name that is being looked up by the resolver. */
+	typedef struct xDNS_QUERY
+	{
+		TimeOut_t xTimeOut;				/* Set when the query was sent. */
+		TickType_t xRemainingTime;		/* Time before the query is sent again, zero to send it now. */
+		uint16_t usIdentifier;			/* The identifier of the DNS message, zero when the slot is free. */
+		uint8_t ucAttemptsLeft;			/* The number of times the query may still be sent. */
+		char pcName[ ipconfigDNS_CACHE_NAME_LENGTH ];
+	} DNSQuery_t;
+
+	/* A task that called FreeRTOS_gethostbyname() waits on one of these. */
+	typedef struct xDNS_WAITER
+	{
+		TaskHandle_t xTask;
+		uint32_t ulIPAddress;
+		volatile BaseType_t xDone;
+	} DNSWaiter_t;
+
+	/* The queries are added by the calling tasks, and removed by the IP-task,
+	both while the scheduler is suspended. */
+	static DNSQuery_t xDNSQueries[ ipconfigDNS_RESOLVER_QUERIES ];
+	static UBaseType_t uxActiveQueries = 0U;
+
+	/* The socket is owned by the IP-task. */
+	static Socket_t xResolverSocket = NULL;
+#endif /* ipconfigDNS_USE_RESOLVER */
+
 #if( ipconfigDNS_USE_CALLBACKS != 0 )
 
 	typedef struct xDNS_Callback {
@@ -275,6 +363,9 @@ typedef struct xDNSAnswerRecord DNSAnswerRecord_t;
 
 	static List_t xCallbackList;
 
+	/* Stop the DNS timer when there is nothing left to check. */
+	static void prvCheckDNSTimer( void );
+
 	/* Define FreeRTOS_gethostbyname() as a normal blocking call. */
 	uint32_t FreeRTOS_gethostbyname( const char *pcHostName )
 	{
@@ -325,10 +416,7 @@ typedef struct xDNSAnswerRecord DNSAnswerRecord_t;
 		}
 		xTaskResumeAll();
 
-		if( listLIST_IS_EMPTY( &xCallbackList ) )
-		{
-			vIPSetDnsTimerEnableState( pdFALSE );
-		}
+		prvCheckDNSTimer();
 	}
 	/*-----------------------------------------------------------*/
 
@@ -372,8 +460,10 @@ typedef struct xDNSAnswerRecord DNSAnswerRecord_t;
 	}
 	/*-----------------------------------------------------------*/
 
-	/* A DNS reply was received, see if there is any matching entry and
-	call the handler. */
+	/* A DNS reply was received, see if there are any matching entries and
+	call their handlers.  Only the 16-bit identifier is sent in the DNS
+	message.  More than one entry may match when the resolver has joined
+	look-ups of the same name. */
 	static void vDNSDoCallback( TickType_t xIdentifier, const char *pcName, uint32_t ulIPAddress );
 	static void vDNSDoCallback( TickType_t xIdentifier, const char *pcName, uint32_t ulIPAddress )
 	{
@@ -384,26 +474,406 @@ typedef struct xDNSAnswerRecord DNSAnswerRecord_t;
 		{
 			for( pxIterator  = ( const ListItem_t * ) listGET_NEXT( xEnd );
 				 pxIterator != ( const ListItem_t * ) xEnd;
-				 pxIterator  = ( const ListItem_t * ) listGET_NEXT( pxIterator ) )
+				  )
 			{
-				if( listGET_LIST_ITEM_VALUE( pxIterator ) == xIdentifier )
+				DNSCallback_t *pxCallback = ( DNSCallback_t * ) listGET_LIST_ITEM_OWNER( pxIterator );
+				/* Move to the next item because we might remove this item */
+				pxIterator  = ( const ListItem_t * ) listGET_NEXT( pxIterator );
+				if( ( uint16_t ) listGET_LIST_ITEM_VALUE( &( pxCallback->xListItem ) ) == ( uint16_t ) xIdentifier )
 				{
-					DNSCallback_t *pxCallback = ( DNSCallback_t * ) listGET_LIST_ITEM_OWNER( pxIterator );
 					pxCallback->pCallbackFunction( pcName, pxCallback->pvSearchID, ulIPAddress );
 					uxListRemove( &pxCallback->xListItem );
 					vPortFree( pxCallback );
-					if( listLIST_IS_EMPTY( &xCallbackList ) )
+				}
+			}
+		}
+		xTaskResumeAll();
+
+		prvCheckDNSTimer();
+	}
+	/*-----------------------------------------------------------*/
+
+	static void prvCheckDNSTimer( void )
+	{
+	BaseType_t xIdle = listLIST_IS_EMPTY( &xCallbackList );
+
+		#if( ipconfigDNS_USE_RESOLVER != 0 )
+		{
+			/* Queries that are in progress are re-sent from the DNS timer. */
+			if( uxActiveQueries != 0U )
+			{
+				xIdle = pdFALSE;
+			}
+		}
+		#endif /* ipconfigDNS_USE_RESOLVER */
+
+		if( xIdle != pdFALSE )
+		{
+			vIPSetDnsTimerEnableState( pdFALSE );
+		}
+	}
+
+#endif	/* ipconfigDNS_USE_CALLBACKS != 0 */
+/*-----------------------------------------------------------*/
+
+#if( ipconfigDNS_USE_RESOLVER != 0 )
+
+	BaseType_t xIsDNSSocket( Socket_t xSocket )
+	{
+	BaseType_t xReturn;
+
+		if( ( xResolverSocket != NULL ) && ( xResolverSocket == xSocket ) )
+		{
+			xReturn = pdTRUE;
+		}
+		else
+		{
+			xReturn = pdFALSE;
+		}
+
+		return xReturn;
+	}
+	/*-----------------------------------------------------------*/
+
+	static DNSQuery_t *prvFindQuery( uint16_t usIdentifier )
+	{
+	DNSQuery_t *pxReturn = NULL;
+	BaseType_t x;
+
+		for( x = 0; x < ipconfigDNS_RESOLVER_QUERIES; x++ )
+		{
+			if( ( xDNSQueries[ x ].usIdentifier != 0U ) && ( xDNSQueries[ x ].usIdentifier == usIdentifier ) )
+			{
+				pxReturn = &( xDNSQueries[ x ] );
+				break;
+			}
+		}
+
+		return pxReturn;
+	}
+	/*-----------------------------------------------------------*/
+
+	static BaseType_t prvStartQuery( const char *pcHostName, FOnDNSEvent pCallback, void *pvSearchID, TickType_t xTimeout )
+	{
+	DNSQuery_t *pxQuery = NULL, *pxFree = NULL;
+	BaseType_t x, xIsNew = pdFALSE;
+	uint16_t usIdentifier;
+
+		if( strlen( pcHostName ) < ( size_t ) ipconfigDNS_CACHE_NAME_LENGTH )
+		{
+			vTaskSuspendAll();
+			{
+				for( x = 0; x < ipconfigDNS_RESOLVER_QUERIES; x++ )
+				{
+					if( xDNSQueries[ x ].usIdentifier == 0U )
+					{
+						if( pxFree == NULL )
+						{
+							pxFree = &( xDNSQueries[ x ] );
+						}
+					}
+					else if( strcmp( xDNSQueries[ x ].pcName, pcHostName ) == 0 )
 					{
-						vIPSetDnsTimerEnableState( pdFALSE );
+						/* The name is being looked up already, wait for the same
+						reply. */
+						pxQuery = &( xDNSQueries[ x ] );
+						break;
 					}
+				}
+
+				if( ( pxQuery == NULL ) && ( pxFree != NULL ) )
+				{
+					do
+					{
+						usIdentifier = ( uint16_t ) ipconfigRAND32();
+					} while( ( usIdentifier == 0U ) || ( prvFindQuery( usIdentifier ) != NULL ) );
+
+					pxQuery = pxFree;
+					strcpy( pxQuery->pcName, pcHostName );
+					pxQuery->ucAttemptsLeft = ( uint8_t ) ipconfigDNS_REQUEST_ATTEMPTS;
+					pxQuery->xRemainingTime = ( TickType_t ) 0;
+					vTaskSetTimeOutState( &( pxQuery->xTimeOut ) );
+					pxQuery->usIdentifier = usIdentifier;
+					uxActiveQueries++;
+					xIsNew = pdTRUE;
+				}
+
+				if( pxQuery != NULL )
+				{
+					/* Register the call-back before the IP-task can see the
+					reply. */
+					vDNSSetCallBack( pcHostName, pvSearchID, pCallback, xTimeout, ( TickType_t ) pxQuery->usIdentifier );
+				}
+			}
+			xTaskResumeAll();
+
+			if( xIsNew != pdFALSE )
+			{
+				xSendEventToIPTask( eDNSEvent );
+			}
+		}
+
+		return ( pxQuery != NULL ) ? pdTRUE : pdFALSE;
+	}
+	/*-----------------------------------------------------------*/
+
+	static void prvWakeUpWaiter( const char *pcName, void *pvSearchID, uint32_t ulIPAddress )
+	{
+	DNSWaiter_t *pxWaiter = ( DNSWaiter_t * ) pvSearchID;
+
+		( void ) pcName;
+
+		pxWaiter->ulIPAddress = ulIPAddress;
+		pxWaiter->xDone = pdTRUE;
+		xTaskNotifyGiveIndexed( pxWaiter->xTask, ipconfigNOTIFICATION_INDEX );
+	}
+	/*-----------------------------------------------------------*/
+
+	static BaseType_t prvWaitForQuery( const char *pcHostName, uint32_t *pulIPAddress )
+	{
+	DNSWaiter_t xWaiter;
+	TimeOut_t xTimeOut;
+	TickType_t xRemainingTime;
+	BaseType_t xReturn;
+
+		xWaiter.xTask = xTaskGetCurrentTaskHandle();
+		xWaiter.ulIPAddress = 0UL;
+		xWaiter.xDone = pdFALSE;
+
+		/* The resolver gives up after ipconfigDNS_REQUEST_ATTEMPTS retries,
+		the time-outs below are only a safety net. */
+		xReturn = prvStartQuery( pcHostName, prvWakeUpWaiter, ( void * ) &xWaiter,
+			( TickType_t ) ( ipconfigDNS_RESOLVER_RETRY_MS * ( ipconfigDNS_REQUEST_ATTEMPTS + 1 ) ) );
+
+		if( xReturn != pdFALSE )
+		{
+			xRemainingTime = pdMS_TO_TICKS( ipconfigDNS_RESOLVER_RETRY_MS * ( ipconfigDNS_REQUEST_ATTEMPTS + 2 ) );
+			vTaskSetTimeOutState( &xTimeOut );
+
+			while( xWaiter.xDone == pdFALSE )
+			{
+				if( xTaskCheckForTimeOut( &xTimeOut, &xRemainingTime ) != pdFALSE )
+				{
+					/* Make sure the call-back can not run after returning. */
+					FreeRTOS_gethostbyname_cancel( ( void * ) &xWaiter );
 					break;
 				}
+
+				/* Wait on the index of the stack, so that notifications the
+				application sends to this task on the default index are neither
+				consumed nor cleared here.  'xDone' protects against wake-ups
+				that were meant for something else, and a notification given
+				after the last wait is ignored by the next user of the index. */
+				( void ) ulTaskNotifyTakeIndexed( ipconfigNOTIFICATION_INDEX, pdTRUE, xRemainingTime );
+			}
+
+			*pulIPAddress = xWaiter.ulIPAddress;
+		}
+
+		return xReturn;
+	}
+	/*-----------------------------------------------------------*/
+
+	static void prvCreateResolverSocket( void )
+	{
+	struct freertos_sockaddr xAddress;
+	BaseType_t xReturn;
+	TickType_t xTimeoutTime = ( TickType_t ) 0;
+
+		xResolverSocket = FreeRTOS_socket( FREERTOS_AF_INET, FREERTOS_SOCK_DGRAM, FREERTOS_IPPROTO_UDP );
+		if( xResolverSocket != FREERTOS_INVALID_SOCKET )
+		{
+			/* Ensure the Rx and Tx timeouts are zero as the resolver executes
+			in the context of the IP task. */
+			FreeRTOS_setsockopt( xResolverSocket, 0, FREERTOS_SO_RCVTIMEO, ( void * ) &xTimeoutTime, sizeof( TickType_t ) );
+			FreeRTOS_setsockopt( xResolverSocket, 0, FREERTOS_SO_SNDTIMEO, ( void * ) &xTimeoutTime, sizeof( TickType_t ) );
+
+			/* Auto bind the port. */
+			xAddress.sin_port = 0u;
+			xReturn = vSocketBind( xResolverSocket, &xAddress, sizeof( xAddress ), pdFALSE );
+			if( xReturn != 0 )
+			{
+				/* Binding failed, close the socket again. */
+				vSocketClose( xResolverSocket );
+				xResolverSocket = NULL;
 			}
 		}
+		else
+		{
+			/* Change to NULL for easier testing. */
+			xResolverSocket = NULL;
+		}
+	}
+	/*-----------------------------------------------------------*/
+
+	static void prvFinishQuery( DNSQuery_t *pxQuery, uint32_t ulIPAddress )
+	{
+		vTaskSuspendAll();
+		{
+			/* Call the call-backs that have not been called yet, also those
+			that joined while the reply was being parsed.  Then free the slot
+			while no task can join. */
+			vDNSDoCallback( ( TickType_t ) pxQuery->usIdentifier, pxQuery->pcName, ulIPAddress );
+			pxQuery->usIdentifier = 0U;
+			uxActiveQueries--;
+		}
 		xTaskResumeAll();
 	}
+	/*-----------------------------------------------------------*/
 
-#endif	/* ipconfigDNS_USE_CALLBACKS != 0 */
+	static void prvReadReplies( void )
+	{
+	struct freertos_sockaddr xAddress;
+	uint32_t ulAddressLength = sizeof( xAddress );
+	uint8_t *pucUDPPayloadBuffer;
+	DNSQuery_t *pxQuery;
+	uint16_t usIdentifier;
+	uint32_t ulIPAddress;
+	int32_t lBytes;
+
+		for( ;; )
+		{
+			lBytes = FreeRTOS_recvfrom( xResolverSocket, &pucUDPPayloadBuffer, 0, FREERTOS_ZERO_COPY, &xAddress, &ulAddressLength );
+
+			if( lBytes <= 0 )
+			{
+				break;
+			}
+
+			if( ( size_t ) lBytes >= sizeof( DNSMessage_t ) )
+			{
+				usIdentifier = ( ( DNSMessage_t * ) pucUDPPayloadBuffer )->usIdentifier;
+				pxQuery = prvFindQuery( usIdentifier );
+
+				if( pxQuery != NULL )
+				{
+					/* prvParseDNSReply() stores the addresses in the cache and
+					calls the call-backs when an address was found. */
+					ulIPAddress = prvParseDNSReply( pucUDPPayloadBuffer, ( size_t ) lBytes, ( TickType_t ) usIdentifier );
+					prvFinishQuery( pxQuery, ulIPAddress );
+				}
+			}
+
+			FreeRTOS_ReleaseUDPPayloadBuffer( ( void * ) pucUDPPayloadBuffer );
+		}
+	}
+	/*-----------------------------------------------------------*/
+
+	static void prvSendQuery( DNSQuery_t *pxQuery )
+	{
+	struct freertos_sockaddr xAddress;
+	uint8_t *pucUDPPayloadBuffer;
+	size_t xPayloadLength, xExpectedPayloadLength;
+	uint32_t ulIPAddress;
+	BaseType_t xUseLLMNR = pdFALSE;
+
+		#if( ipconfigUSE_LLMNR == 1 )
+		{
+			/* Names without a '.' are looked up with LLMNR. */
+			if( strchr( pxQuery->pcName, '.' ) == NULL )
+			{
+				xUseLLMNR = pdTRUE;
+			}
+		}
+		#endif /* ipconfigUSE_LLMNR == 1 */
+
+		/* Obtain the DNS server address. */
+		FreeRTOS_GetAddressConfiguration( NULL, NULL, NULL, &ulIPAddress );
+
+		if( ( xResolverSocket != NULL ) && ( ( ulIPAddress != 0UL ) || ( xUseLLMNR != pdFALSE ) ) )
+		{
+			xExpectedPayloadLength = sizeof( DNSMessage_t ) + strlen( pxQuery->pcName ) + sizeof( uint16_t ) + sizeof( uint16_t ) + 2u;
+
+			/* The IP-task must not block. */
+			pucUDPPayloadBuffer = ( uint8_t * ) FreeRTOS_GetUDPPayloadBuffer( xExpectedPayloadLength, 0 );
+
+			if( pucUDPPayloadBuffer != NULL )
+			{
+				xPayloadLength = prvCreateDNSMessage( pucUDPPayloadBuffer, pxQuery->pcName, ( TickType_t ) pxQuery->usIdentifier );
+
+				iptraceSENDING_DNS_REQUEST();
+
+				#if( ipconfigUSE_LLMNR == 1 )
+				if( xUseLLMNR != pdFALSE )
+				{
+					/* Use LLMNR addressing. */
+					( ( DNSMessage_t * ) pucUDPPayloadBuffer) -> usFlags = 0;
+					xAddress.sin_addr = ipLLMNR_IP_ADDR;	/* Is in network byte order. */
+					xAddress.sin_port = FreeRTOS_ntohs( ipLLMNR_PORT );
+				}
+				else
+				#endif
+				{
+					/* Use DNS server. */
+					xAddress.sin_addr = ulIPAddress;
+					xAddress.sin_port = dnsDNS_PORT;
+				}
+
+				if( FreeRTOS_sendto( xResolverSocket, pucUDPPayloadBuffer, xPayloadLength, FREERTOS_ZERO_COPY, &xAddress, sizeof( xAddress ) ) == 0 )
+				{
+					/* The message was not sent so the stack will not be
+					releasing the zero copy - it must be released here. */
+					FreeRTOS_ReleaseUDPPayloadBuffer( ( void * ) pucUDPPayloadBuffer );
+				}
+			}
+		}
+	}
+	/*-----------------------------------------------------------*/
+
+	static void prvSendQueries( void )
+	{
+	DNSQuery_t *pxQuery;
+	BaseType_t x;
+
+		for( x = 0; x < ipconfigDNS_RESOLVER_QUERIES; x++ )
+		{
+			pxQuery = &( xDNSQueries[ x ] );
+
+			if( ( pxQuery->usIdentifier != 0U ) &&
+				( ( pxQuery->xRemainingTime == ( TickType_t ) 0 ) ||
+				  ( xTaskCheckForTimeOut( &( pxQuery->xTimeOut ), &( pxQuery->xRemainingTime ) ) != pdFALSE ) ) )
+			{
+				if( pxQuery->ucAttemptsLeft == 0U )
+				{
+					/* No reply was received, give up. */
+					prvFinishQuery( pxQuery, 0UL );
+				}
+				else
+				{
+					/* An attempt is used up, also when the query could not be
+					sent. */
+					pxQuery->ucAttemptsLeft--;
+					prvSendQuery( pxQuery );
+					pxQuery->xRemainingTime = pdMS_TO_TICKS( ipconfigDNS_RESOLVER_RETRY_MS );
+					vTaskSetTimeOutState( &( pxQuery->xTimeOut ) );
+				}
+			}
+		}
+	}
+	/*-----------------------------------------------------------*/
+
+	void vDNSResolverProcess( void )
+	{
+		if( xResolverSocket == NULL )
+		{
+			prvCreateResolverSocket();
+		}
+
+		if( xResolverSocket != NULL )
+		{
+			prvReadReplies();
+		}
+
+		prvSendQueries();
+
+		if( uxActiveQueries != 0U )
+		{
+			/* Come back when the next query must be re-sent. */
+			vIPReloadDNSTimer( pdMS_TO_TICKS( ipconfigDNS_RESOLVER_RETRY_MS ) );
+		}
+	}
+
+#endif /* ipconfigDNS_USE_RESOLVER */
 /*-----------------------------------------------------------*/
 
 #if( ipconfigDNS_USE_CALLBACKS == 0 )
@@ -449,6 +919,28 @@ TickType_t xIdentifier = 0;
 		xIdentifier = ( TickType_t )ipconfigRAND32( );
 	}
 
+	#if( ipconfigDNS_USE_RESOLVER != 0 )
+	{
+		/* Let the IP-task look up the name.  When all query slots are in use,
+		fall back to sending a request from this task. */
+		if( ( ulIPAddress == 0UL ) && ( 0 != xIdentifier ) )
+		{
+			if( pCallback != NULL )
+			{
+				if( prvStartQuery( pcHostName, pCallback, pvSearchID, xTimeout ) != pdFALSE )
+				{
+					/* The call-back will be called by the IP-task. */
+					xIdentifier = 0;
+				}
+			}
+			else if( prvWaitForQuery( pcHostName, &ulIPAddress ) != pdFALSE )
+			{
+				xIdentifier = 0;
+			}
+		}
+	}
+	#endif /* ipconfigDNS_USE_RESOLVER */
+
 	#if( ipconfigDNS_USE_CALLBACKS != 0 )
 	{
 		if( pCallback != NULL )
@@ -860,6 +1352,7 @@ static uint32_t prvParseDNSReply( uint8_t *pucUDPPayloadBuffer, size_t xBufferLe
 DNSMessage_t *pxDNSMessageHeader;
 DNSAnswerRecord_t *pxDNSAnswerRecord;
 uint32_t ulIPAddress = 0UL;
+uint32_t ulReadIPAddress;
 #if( ipconfigUSE_LLMNR == 1 )
 	char *pcRequestedName = NULL;
 #endif
@@ -973,10 +1466,11 @@ uint16_t x, usDataLength, usQuestions;
 				pucByte = prvSkipNameField( pucByte,
 											xSourceBytesRemaining );
 
-				/* Check for a malformed response. */
+				/* Check for a malformed response.  An address that was read
+				from an earlier record is still returned. */
 				if( NULL == pucByte )
 				{
-					return dnsPARSE_ERROR;
+					return ulIPAddress;
 				}
 				else
 				{
@@ -995,26 +1489,38 @@ uint16_t x, usDataLength, usQuestions;
 					if( FreeRTOS_ntohs( pxDNSAnswerRecord->usDataLength ) == sizeof( uint32_t ) )
 					{
 						/* Copy the IP address out of the record. */
-						memcpy( &ulIPAddress,
+						memcpy( &ulReadIPAddress,
 								pucByte + sizeof( DNSAnswerRecord_t ),
 								sizeof( uint32_t ) );
 
 						#if( ipconfigUSE_DNS_CACHE == 1 )
 						{
-							prvProcessDNSCache( pcName, &ulIPAddress, pxDNSAnswerRecord->ulTTL, pdFALSE );
+							prvProcessDNSCache( pcName, &ulReadIPAddress, pxDNSAnswerRecord->ulTTL, pdFALSE );
 						}
 						#endif /* ipconfigUSE_DNS_CACHE */
-						#if( ipconfigDNS_USE_CALLBACKS != 0 )
+
+						/* The first address is the one returned. */
+						if( ulIPAddress == 0UL )
 						{
-							/* See if any asynchronous call was made to FreeRTOS_gethostbyname_a() */
-							vDNSDoCallback( ( TickType_t ) pxDNSMessageHeader->usIdentifier, pcName, ulIPAddress );
+							ulIPAddress = ulReadIPAddress;
+
+							#if( ipconfigDNS_USE_CALLBACKS != 0 )
+							{
+								/* See if any asynchronous call was made to FreeRTOS_gethostbyname_a() */
+								vDNSDoCallback( ( TickType_t ) pxDNSMessageHeader->usIdentifier, pcName, ulIPAddress );
+							}
+							#endif	/* ipconfigDNS_USE_CALLBACKS != 0 */
 						}
-						#endif	/* ipconfigDNS_USE_CALLBACKS != 0 */
 					}
 
 					pucByte += sizeof( DNSAnswerRecord_t ) + sizeof( uint32_t );
 					xSourceBytesRemaining -= ( sizeof( DNSAnswerRecord_t ) + sizeof( uint32_t ) );
-					break;
+
+					#if( dnsREAD_ALL_A_RECORDS == 0 )
+					{
+						break;
+					}
+					#endif /* dnsREAD_ALL_A_RECORDS */
 				}
 				else if( xSourceBytesRemaining >= sizeof( DNSAnswerRecord_t ) )
 				{
@@ -1035,8 +1541,8 @@ uint16_t x, usDataLength, usQuestions;
 					}
 					else
 					{
-						/* Malformed response. */
-						return dnsPARSE_ERROR;
+						/* Malformed response, see above. */
+						return ulIPAddress;
 					}
 				}
 			}
@@ -1339,69 +1845,101 @@ TickType_t xTimeoutTime = pdMS_TO_TICKS( 200 );
 	static void prvProcessDNSCache( const char *pcName, uint32_t *pulIP, uint32_t ulTTL, BaseType_t xLookUp )
 	{
 	BaseType_t x;
-	BaseType_t xFound = pdFALSE;
+	UBaseType_t uxIndex, uxUse;
+	DNSCacheRow_t *pxRow;
 	uint32_t ulCurrentTimeSeconds = ( xTaskGetTickCount() / portTICK_PERIOD_MS ) / 1000;
-	static BaseType_t xFreeEntry = 0;
+	uint32_t ulNameHash = prvHashName( pcName );
 
-		/* For each entry in the DNS cache table. */
-		for( x = 0; x < ipconfigDNS_CACHE_ENTRIES; x++ )
+		x = prvFindCacheEntry( pcName, ulNameHash );
+
+		/* Is this function called for a lookup or to add/update an IP address? */
+		if( xLookUp != pdFALSE )
 		{
-			if( xDNSCache[ x ].pcName[ 0 ] == 0 )
-			{
-				break;
-			}
+			*pulIP = 0;
 
-			if( 0 == strcmp( xDNSCache[ x ].pcName, pcName ) )
+			if( x >= 0 )
 			{
-				/* Is this function called for a lookup or to add/update an IP address? */
-				if( xLookUp != pdFALSE )
+				pxRow = &( xDNSCache[ x ] );
+
+				/* Age out the addresses whose TTL has passed. */
+				for( uxIndex = 0; uxIndex < ( UBaseType_t ) pxRow->ucNumIPAddresses; )
 				{
-					/* Confirm that the record is still fresh. */
-					if( ulCurrentTimeSeconds < ( xDNSCache[ x ].ulTimeWhenAddedInSeconds + FreeRTOS_ntohl( xDNSCache[ x ].ulTTL ) ) )
+					if( ulCurrentTimeSeconds < pxRow->ulExpiryTimes[ uxIndex ] )
 					{
-						*pulIP = xDNSCache[ x ].ulIPAddress;
+						uxIndex++;
 					}
 					else
 					{
-						/* Age out the old cached record. */
-						xDNSCache[ x ].pcName[ 0 ] = 0;
+						pxRow->ucNumIPAddresses--;
+						pxRow->ulIPAddresses[ uxIndex ] = pxRow->ulIPAddresses[ pxRow->ucNumIPAddresses ];
+						pxRow->ulExpiryTimes[ uxIndex ] = pxRow->ulExpiryTimes[ pxRow->ucNumIPAddresses ];
 					}
 				}
-				else
+
+				if( pxRow->ucNumIPAddresses == 0U )
 				{
-					xDNSCache[ x ].ulIPAddress = *pulIP;
-					xDNSCache[ x ].ulTTL = ulTTL;
-					xDNSCache[ x ].ulTimeWhenAddedInSeconds = ulCurrentTimeSeconds;
+					/* Age out the old cached record. */
+					prvUnlinkCacheEntry( x );
 				}
+				else
+				{
+					/* Hand out the addresses in turn. */
+					if( pxRow->ucCurrentIPAddress >= pxRow->ucNumIPAddresses )
+					{
+						pxRow->ucCurrentIPAddress = 0U;
+					}
 
-				xFound = pdTRUE;
-				break;
+					*pulIP = pxRow->ulIPAddresses[ pxRow->ucCurrentIPAddress ];
+					pxRow->ucCurrentIPAddress++;
+					pxRow->ulLastUsed = ++ulDNSCacheClock;
+				}
 			}
 		}
-
-		if( xFound == pdFALSE )
+		else
 		{
-			if( xLookUp != pdFALSE )
+			if( x < 0 )
 			{
-				*pulIP = 0;
+				/* Add the item. */
+				x = prvNewCacheEntry( pcName, ulNameHash );
 			}
-			else
+
+			if( x >= 0 )
 			{
-				/* Add or update the item. */
-				if( strlen( pcName ) < ipconfigDNS_CACHE_NAME_LENGTH )
+				pxRow = &( xDNSCache[ x ] );
+				uxUse = ( UBaseType_t ) pxRow->ucNumIPAddresses;
+
+				for( uxIndex = 0; uxIndex < ( UBaseType_t ) pxRow->ucNumIPAddresses; uxIndex++ )
 				{
-					strcpy( xDNSCache[ xFreeEntry ].pcName, pcName );
+					if( pxRow->ulIPAddresses[ uxIndex ] == *pulIP )
+					{
+						/* Update the TTL of a known address. */
+						uxUse = uxIndex;
+						break;
+					}
+				}
 
-					xDNSCache[ xFreeEntry ].ulIPAddress = *pulIP;
-					xDNSCache[ xFreeEntry ].ulTTL = ulTTL;
-					xDNSCache[ xFreeEntry ].ulTimeWhenAddedInSeconds = ulCurrentTimeSeconds;
+				if( uxUse == ( UBaseType_t ) ipconfigDNS_CACHE_ADDRESSES_PER_ENTRY )
+				{
+					/* All places are taken: replace the address which expires
+					first. */
+					uxUse = 0;
 
-					xFreeEntry++;
-					if( xFreeEntry == ipconfigDNS_CACHE_ENTRIES )
+					for( uxIndex = 1; uxIndex < ( UBaseType_t ) ipconfigDNS_CACHE_ADDRESSES_PER_ENTRY; uxIndex++ )
 					{
-						xFreeEntry = 0;
+						if( pxRow->ulExpiryTimes[ uxIndex ] < pxRow->ulExpiryTimes[ uxUse ] )
+						{
+							uxUse = uxIndex;
+						}
 					}
 				}
+				else if( uxUse == ( UBaseType_t ) pxRow->ucNumIPAddresses )
+				{
+					pxRow->ucNumIPAddresses++;
+				}
+
+				pxRow->ulIPAddresses[ uxUse ] = *pulIP;
+				pxRow->ulExpiryTimes[ uxUse ] = ulCurrentTimeSeconds + FreeRTOS_ntohl( ulTTL );
+				pxRow->ulLastUsed = ++ulDNSCacheClock;
 			}
 		}
 
@@ -1410,6 +1948,131 @@ TickType_t xTimeoutTime = pdMS_TO_TICKS( 200 );
 			FreeRTOS_debug_printf( ( "prvProcessDNSCache: %s: '%s' @ %lxip\n", xLookUp ? "look-up" : "add", pcName, FreeRTOS_ntohl( *pulIP ) ) );
 		}
 	}
+/*-----------------------------------------------------------*/
+
+	static uint32_t prvHashName( const char *pcName )
+	{
+	uint32_t ulHash = 2166136261UL;
+
+		/* FNV-1a. */
+		while( *pcName != '\0' )
+		{
+			ulHash = ( ulHash ^ ( uint8_t ) *pcName ) * 16777619UL;
+			pcName++;
+		}
+
+		return ulHash;
+	}
+/*-----------------------------------------------------------*/
+
+	static BaseType_t prvFindCacheEntry( const char *pcName, uint32_t ulNameHash )
+	{
+	BaseType_t xReturn = -1;
+	uint16_t usNext;
+
+		#if( ipconfigCACHE_STATS != 0 )
+		{
+			xDNSCacheStats.ulLookups++;
+		}
+		#endif /* ipconfigCACHE_STATS */
+
+		for( usNext = usDNSHashHeads[ ulNameHash & ( ipconfigDNS_CACHE_HASH_BUCKETS - 1 ) ]; usNext != 0U; usNext = xDNSCache[ usNext - 1U ].usHashNext )
+		{
+			#if( ipconfigCACHE_STATS != 0 )
+			{
+				xDNSCacheStats.ulProbes++;
+			}
+			#endif /* ipconfigCACHE_STATS */
+
+			/* Only compare the names when the hashes are equal. */
+			if( ( xDNSCache[ usNext - 1U ].ulNameHash == ulNameHash ) &&
+				( strcmp( xDNSCache[ usNext - 1U ].pcName, pcName ) == 0 ) )
+			{
+				xReturn = ( BaseType_t ) usNext - 1;
+
+				#if( ipconfigCACHE_STATS != 0 )
+				{
+					xDNSCacheStats.ulHits++;
+				}
+				#endif /* ipconfigCACHE_STATS */
+				break;
+			}
+		}
+
+		return xReturn;
+	}
+/*-----------------------------------------------------------*/
+
+	static void prvUnlinkCacheEntry( BaseType_t xEntry )
+	{
+	uint16_t *pusLink = &( usDNSHashHeads[ xDNSCache[ xEntry ].ulNameHash & ( ipconfigDNS_CACHE_HASH_BUCKETS - 1 ) ] );
+
+		while( *pusLink != 0U )
+		{
+			if( *pusLink == ( uint16_t ) ( xEntry + 1 ) )
+			{
+				*pusLink = xDNSCache[ xEntry ].usHashNext;
+				break;
+			}
+
+			pusLink = &( xDNSCache[ *pusLink - 1U ].usHashNext );
+		}
+
+		/* An empty name marks a free entry. */
+		xDNSCache[ xEntry ].pcName[ 0 ] = 0;
+		xDNSCache[ xEntry ].ucNumIPAddresses = 0U;
+	}
+/*-----------------------------------------------------------*/
+
+	static BaseType_t prvNewCacheEntry( const char *pcName, uint32_t ulNameHash )
+	{
+	BaseType_t x, xUse = 0;
+	uint16_t *pusHead;
+
+		if( strlen( pcName ) >= ipconfigDNS_CACHE_NAME_LENGTH )
+		{
+			xUse = -1;
+		}
+		else
+		{
+			/* Take a free entry, or else the least recently used entry. */
+			for( x = 0; x < ipconfigDNS_CACHE_ENTRIES; x++ )
+			{
+				if( xDNSCache[ x ].pcName[ 0 ] == 0 )
+				{
+					xUse = x;
+					break;
+				}
+
+				if( ( ulDNSCacheClock - xDNSCache[ x ].ulLastUsed ) > ( ulDNSCacheClock - xDNSCache[ xUse ].ulLastUsed ) )
+				{
+					xUse = x;
+				}
+			}
+
+			if( xDNSCache[ xUse ].pcName[ 0 ] != 0 )
+			{
+				#if( ipconfigCACHE_STATS != 0 )
+				{
+					xDNSCacheStats.ulEvictions++;
+				}
+				#endif /* ipconfigCACHE_STATS */
+
+				prvUnlinkCacheEntry( xUse );
+			}
+
+			strcpy( xDNSCache[ xUse ].pcName, pcName );
+			xDNSCache[ xUse ].ulNameHash = ulNameHash;
+			xDNSCache[ xUse ].ucNumIPAddresses = 0U;
+			xDNSCache[ xUse ].ucCurrentIPAddress = 0U;
+
+			pusHead = &( usDNSHashHeads[ ulNameHash & ( ipconfigDNS_CACHE_HASH_BUCKETS - 1 ) ] );
+			xDNSCache[ xUse ].usHashNext = *pusHead;
+			*pusHead = ( uint16_t ) ( xUse + 1 );
+		}
+
+		return xUse;
+	}
 
 #endif /* ipconfigUSE_DNS_CACHE */
 
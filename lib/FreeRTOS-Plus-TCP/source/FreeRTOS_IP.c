@@ -500,6 +500,25 @@ struct freertos_sockaddr xAddress;
 				#endif /* ipconfigUSE_TCP */
 				break;
 
+			case eTCPConnectionsEvent:
+				/* FreeRTOS_GetTCPConnections() was called, copy the bound TCP
+				sockets and wake up the caller. */
+				#if( ipconfigUSE_TCP == 1 )
+				{
+					vTCPConnectionsSnapshot( ( TCPConnectionsRequest_t * ) xReceivedEvent.pvData );
+				}
+				#endif /* ipconfigUSE_TCP */
+				break;
+
+			case eDNSEvent:
+				/* A name must be looked up, or a DNS reply was received. */
+				#if( ipconfigDNS_USE_RESOLVER != 0 )
+				{
+					vDNSResolverProcess();
+				}
+				#endif /* ipconfigDNS_USE_RESOLVER */
+				break;
+
 			default :
 				/* Should not get here. */
 				break;
@@ -550,7 +569,15 @@ static void prvHandleEthernetPacket( NetworkBufferDescriptor_t *pxBuffer )
 		network interface can chain received packets together and pass them into
 		the IP task in one go.  The packets are chained using the pxNextBuffer
 		member.  The loop below walks through the chain processing each packet
-		in the chain in turn. */
+		in the chain in turn.  TCP ACK's that must be sent immediately are
+		postponed until the end of the chain, so that a socket sends at most
+		one of them per chain. */
+		#if( ( ipconfigUSE_TCP == 1 ) && ( ipconfigUSE_TCP_WIN == 1 ) )
+		{
+			vTCPRxBatchBegin();
+		}
+		#endif
+
 		do
 		{
 			/* Store a pointer to the buffer after pxBuffer for use later on. */
@@ -559,11 +586,24 @@ static void prvHandleEthernetPacket( NetworkBufferDescriptor_t *pxBuffer )
 			/* Make it NULL to avoid using it later on. */
 			pxBuffer->pxNextBuffer = NULL;
 
+			if( pxNextBuffer != NULL )
+			{
+				/* Fetch the headers of the next packet while this one is being
+				processed. */
+				ipconfigPREFETCH( pxNextBuffer->pucEthernetBuffer );
+			}
+
 			prvProcessEthernetPacket( pxBuffer );
 			pxBuffer = pxNextBuffer;
 
 		/* While there is another packet in the chain. */
 		} while( pxBuffer != NULL );
+
+		#if( ( ipconfigUSE_TCP == 1 ) && ( ipconfigUSE_TCP_WIN == 1 ) )
+		{
+			vTCPRxBatchEnd();
+		}
+		#endif
 	}
 	#endif /* ipconfigUSE_LINKED_RX_MESSAGES */
 }
@@ -599,9 +639,14 @@ TickType_t xMaximumSleepTime;
 
 	#if( ipconfigUSE_TCP == 1 )
 	{
-		if( xTCPTimer.ulRemainingTime < xMaximumSleepTime )
+	TickType_t xTCPSleepTime;
+
+		/* The earliest deadline of all TCP sockets. */
+		xTCPSleepTime = xTCPTimerNextExpiry();
+
+		if( xTCPSleepTime < xMaximumSleepTime )
 		{
-			xMaximumSleepTime = xTCPTimer.ulRemainingTime;
+			xMaximumSleepTime = xTCPSleepTime;
 		}
 	}
 	#endif
@@ -648,6 +693,13 @@ static void prvCheckNetworkTimers( void )
 		if( prvIPTimerCheck( &xDNSTimer ) != pdFALSE )
 		{
 			vDNSCheckCallBack( NULL );
+
+			#if( ipconfigDNS_USE_RESOLVER != 0 )
+			{
+				/* Re-send the queries that have not been answered. */
+				vDNSResolverProcess();
+			}
+			#endif /* ipconfigDNS_USE_RESOLVER */
 		}
 	}
 	#endif /* ipconfigDNS_USE_CALLBACKS */
@@ -667,9 +719,15 @@ static void prvCheckNetworkTimers( void )
 			xWillSleep = pdFALSE;
 		}
 
-		/* Sockets need to be checked if the TCP timer has expired. */
+		/* Sockets need to be checked if the TCP timer has expired, or if the
+		deadline of at least one socket has passed. */
 		xCheckTCPSockets = prvIPTimerCheck( &xTCPTimer );
 
+		if( xTCPTimerNextExpiry() == ( TickType_t ) 0u )
+		{
+			xCheckTCPSockets = pdTRUE;
+		}
+
 		/* Sockets will also be checked if there are TCP messages but the
 		message queue is empty (indicated by xWillSleep being true). */
 		if( ( xProcessedTCPMessage != pdFALSE ) && ( xWillSleep != pdFALSE ) )
@@ -1712,7 +1770,7 @@ uint8_t ucProtocol;
 	{
 	ICMPHeader_t *pxICMPHeader;
 	IPHeader_t *pxIPHeader;
-	uint16_t usRequest;
+	uint16_t usRequest, usReply;
 
 		pxICMPHeader = &( pxICMPPacket->xICMPHeader );
 		pxIPHeader = &( pxICMPPacket->xIPHeader );
@@ -1731,23 +1789,10 @@ uint8_t ucProtocol;
 		/* Update the checksum because the ucTypeOfMessage member in the header
 		has been changed to ipICMP_ECHO_REPLY.  This is faster than calling
 		usGenerateChecksum(). */
+		usRequest = FreeRTOS_htons( ( uint16_t ) ( ( uint16_t ) ipICMP_ECHO_REQUEST << 8 ) );
+		usReply = FreeRTOS_htons( ( uint16_t ) ( ( uint16_t ) ipICMP_ECHO_REPLY << 8 ) );
+		pxICMPHeader->usChecksum = usChecksumUpdate16( pxICMPHeader->usChecksum, usRequest, usReply );
 
-		/* due to compiler warning "integer operation result is out of range" */
-
-		usRequest = ( uint16_t ) ( ( uint16_t )ipICMP_ECHO_REQUEST << 8 );
-
-		if( pxICMPHeader->usChecksum >= FreeRTOS_htons( 0xFFFFu - usRequest ) )
-		{
-			pxICMPHeader->usChecksum = ( uint16_t )
-				( ( ( uint32_t ) pxICMPHeader->usChecksum ) +
-					FreeRTOS_htons( usRequest + 1UL ) );
-		}
-		else
-		{
-			pxICMPHeader->usChecksum = ( uint16_t )
-				( ( ( uint32_t ) pxICMPHeader->usChecksum ) +
-					FreeRTOS_htons( usRequest ) );
-		}
 		return eReturnEthernetFrame;
 	}
 
@@ -2007,15 +2052,17 @@ uint8_t ucProtocol;
  * ((received & calculated) == 0) without applying a bitwise 'not' to the 'calculated' checksum.
  *
  * This logic is optimized for microcontrollers which have limited resources, so the logic looks odd.
- * It iterates over the full range of 16-bit words, but it does so by processing several 32-bit
- * words at once whenever possible. Its first step is to align the memory pointer to a 32-bit boundary,
- * after which it runs a fast loop to process multiple 32-bit words at once and adding their 'carries'.
- * Finally, it finishes up by processing any remaining 16-bit words, and adding up all of the 'carries'.
- * With 32-bit arithmetic, the number of 16-bit 'carries' produced by sequential additions can be found
- * by looking at the 16 most-significant bits of the 32-bit integer, since a 32-bit int will continue
- * counting up instead of overflowing after 16 bits. That is why the actual checksum calculations look like:
+ * It iterates over the full range of 16-bit words, but it does so by processing 32-bit words
+ * whenever possible. Its first step is to align the memory pointer to a 32-bit boundary, after
+ * which ullChecksumSumWords() adds all complete 32-bit words to a 64-bit accumulator. A 64-bit
+ * accumulator can not overflow for any realistic packet size, so no carries have to be counted
+ * inside the loop. Finally, it processes any remaining 16-bit word and byte, and folds the 64-bit
+ * sum back into 16 bits by adding the upper halves to the lower halves:
  *   union.u32 = ( uint32_t ) union.u16[ 0 ] + union.u16[ 1 ];
  *
+ * ullChecksumSumWords() can be replaced by an optimised version for a specific architecture, see
+ * ipconfigPORT_CHECKSUM_SUM_WORDS.
+ *
  * Arguments:
  *   ulSum: This argument provides a value to initialize the progressive summation
  *	 of the header's values to. It is often 0, but protocols like TCP or UDP
@@ -2027,14 +2074,15 @@ uint8_t ucProtocol;
  */
 uint16_t usGenerateChecksum( uint32_t ulSum, const uint8_t * pucNextData, size_t uxDataLengthBytes )
 {
-xUnion32 xSum2, xSum, xTerm;
+xUnion32 xSum, xTerm;
 xUnionPtr xSource;		/* Points to first byte */
-xUnionPtr xLastSource;	/* Points to last byte plus one */
-uint32_t ulAlignBits, ulCarry = 0ul;
+uint64_t ullSum;
+uint32_t ulAlignBits;
+size_t uxWordCount;
 
 	/* Small MCUs often spend up to 30% of the time doing checksum calculations
 	This function is optimised for 32-bit CPUs; Each time it will try to fetch
-	32-bits, sums it with an accumulator and counts the number of carries. */
+	32-bits, and sum it with a 64-bit accumulator. */
 
 	/* Swap the input (little endian platform only). */
 	xSum.u32 = FreeRTOS_ntohs( ulSum );
@@ -2062,58 +2110,16 @@ uint32_t ulAlignBits, ulCarry = 0ul;
 	}
 
 	/* Word (32-bit) aligned, do the most part. */
-	xLastSource.u32ptr = ( xSource.u32ptr + ( uxDataLengthBytes / 4u ) ) - 3u;
-
-	/* In this loop, four 32-bit additions will be done, in total 16 bytes.
-	Indexing with constants (0,1,2,3) gives faster code than using
-	post-increments. */
-	while( xSource.u32ptr < xLastSource.u32ptr )
-	{
-		/* Use a secondary Sum2, just to see if the addition produced an
-		overflow. */
-		xSum2.u32 = xSum.u32 + xSource.u32ptr[ 0 ];
-		if( xSum2.u32 < xSum.u32 )
-		{
-			ulCarry++;
-		}
-
-		/* Now add the secondary sum to the major sum, and remember if there was
-		a carry. */
-		xSum.u32 = xSum2.u32 + xSource.u32ptr[ 1 ];
-		if( xSum2.u32 > xSum.u32 )
-		{
-			ulCarry++;
-		}
-
-		/* And do the same trick once again for indexes 2 and 3 */
-		xSum2.u32 = xSum.u32 + xSource.u32ptr[ 2 ];
-		if( xSum2.u32 < xSum.u32 )
-		{
-			ulCarry++;
-		}
-
-		xSum.u32 = xSum2.u32 + xSource.u32ptr[ 3 ];
-
-		if( xSum2.u32 > xSum.u32 )
-		{
-			ulCarry++;
-		}
-
-		/* And finally advance the pointer 4 * 4 = 16 bytes. */
-		xSource.u32ptr += 4;
-	}
-
-	/* Now add all carries. */
-	xSum.u32 = ( uint32_t )xSum.u16[ 0 ] + xSum.u16[ 1 ] + ulCarry;
-
-	uxDataLengthBytes %= 16u;
-	xLastSource.u8ptr = ( uint8_t * ) ( xSource.u8ptr + ( uxDataLengthBytes & ~( ( size_t ) 1 ) ) );
+	uxWordCount = uxDataLengthBytes / 4u;
+	ullSum = ullChecksumSumWords( ( uint64_t ) xSum.u32, xSource.u32ptr, uxWordCount );
+	xSource.u32ptr += uxWordCount;
+	uxDataLengthBytes %= 4u;
 
 	/* Half-word aligned. */
-	while( xSource.u16ptr < xLastSource.u16ptr )
+	if( uxDataLengthBytes >= 2u )
 	{
-		/* At least one more short. */
-		xSum.u32 += xSource.u16ptr[ 0 ];
+		/* One more short. */
+		ullSum += xSource.u16ptr[ 0 ];
 		xSource.u16ptr++;
 	}
 
@@ -2121,9 +2127,15 @@ uint32_t ulAlignBits, ulCarry = 0ul;
 	{
 		xTerm.u8[ 0 ] = xSource.u8ptr[ 0 ];
 	}
-	xSum.u32 += xTerm.u32;
+	ullSum += xTerm.u32;
+
+	/* Fold the 64-bit sum into 32 bits, twice in case the first addition
+	produced a carry. */
+	ullSum = ( ullSum & 0xffffffffull ) + ( ullSum >> 32 );
+	ullSum = ( ullSum & 0xffffffffull ) + ( ullSum >> 32 );
+	xSum.u32 = ( uint32_t ) ullSum;
 
-	/* Now add all carries again. */
+	/* Now add all carries. */
 	xSum.u32 = ( uint32_t ) xSum.u16[ 0 ] + xSum.u16[ 1 ];
 
 	/* The previous summation might have given a 16-bit carry. */
@@ -2141,6 +2153,64 @@ uint32_t ulAlignBits, ulCarry = 0ul;
 }
 /*-----------------------------------------------------------*/
 
+#if( ipconfigPORT_CHECKSUM_SUM_WORDS == 0 )
+
+	uint64_t ullChecksumSumWords( uint64_t ullSum, const uint32_t *pulWords, size_t uxWordCount )
+	{
+	uint64_t ullSum2 = 0ull;
+
+		/* Portable version: 8 words per iteration, using two accumulators so
+		that the additions do not depend on each other.  Compilers for hosts
+		with SIMD units will vectorise this loop. */
+		while( uxWordCount >= 8u )
+		{
+			ullSum  += pulWords[ 0 ];
+			ullSum2 += pulWords[ 1 ];
+			ullSum  += pulWords[ 2 ];
+			ullSum2 += pulWords[ 3 ];
+			ullSum  += pulWords[ 4 ];
+			ullSum2 += pulWords[ 5 ];
+			ullSum  += pulWords[ 6 ];
+			ullSum2 += pulWords[ 7 ];
+			pulWords += 8;
+			uxWordCount -= 8u;
+		}
+
+		while( uxWordCount > 0u )
+		{
+			ullSum += pulWords[ 0 ];
+			pulWords++;
+			uxWordCount--;
+		}
+
+		return ullSum + ullSum2;
+	}
+
+#endif /* ipconfigPORT_CHECKSUM_SUM_WORDS */
+/*-----------------------------------------------------------*/
+
+uint16_t usChecksumUpdate16( uint16_t usChecksum, uint16_t usOldValue, uint16_t usNewValue )
+{
+uint32_t ulSum;
+
+	/* RFC 1624, eqn. 3: HC' = ~( ~HC + ~m + m' ).  Unlike eqn. 2 of RFC 1141,
+	this can never produce a checksum of 0x0000 where 0xFFFF is expected. */
+	ulSum = ( uint32_t ) ( ( uint16_t ) ~usChecksum ) + ( ( uint16_t ) ~usOldValue ) + usNewValue;
+	ulSum = ( ulSum & 0xffffu ) + ( ulSum >> 16 );
+	ulSum = ( ulSum & 0xffffu ) + ( ulSum >> 16 );
+
+	return ( uint16_t ) ~ulSum;
+}
+/*-----------------------------------------------------------*/
+
+uint16_t usChecksumUpdate32( uint16_t usChecksum, uint32_t ulOldValue, uint32_t ulNewValue )
+{
+	usChecksum = usChecksumUpdate16( usChecksum, ( uint16_t ) ( ulOldValue >> 16 ), ( uint16_t ) ( ulNewValue >> 16 ) );
+
+	return usChecksumUpdate16( usChecksum, ( uint16_t ) ulOldValue, ( uint16_t ) ulNewValue );
+}
+/*-----------------------------------------------------------*/
+
 void vReturnEthernetFrame( NetworkBufferDescriptor_t * pxNetworkBuffer, BaseType_t xReleaseAfterSend )
 {
 EthernetHeader_t *pxEthernetHeader;
@@ -71,10 +71,6 @@ range 1024-65535" excluding those already in use (inbound or outbound). */
 /* A block time of 0 simply means "don't block". */
 #define socketDONT_BLOCK				( ( TickType_t ) 0 )
 
-#if( ( ipconfigUSE_TCP == 1 ) && !defined( ipTCP_TIMER_PERIOD_MS ) )
-	#define ipTCP_TIMER_PERIOD_MS	( 1000 )
-#endif
-
 /* The next private port number to use when binding a client socket is stored in
 the usNextPortToUse[] array - which has either 1 or two indexes depending on
 whether TCP is being supported. */
@@ -89,6 +85,10 @@ respectively. */
 #define socketNEXT_UDP_PORT_NUMBER_INDEX	0
 #define socketNEXT_TCP_PORT_NUMBER_INDEX	1
 
+/* Offset of the payload in a buffer obtained from FreeRTOS_GetTCPPayloadBuffer(),
+the TCP header has no options. */
+#define socketTCP_PAYLOAD_OFFSET		( ipSIZE_OF_ETH_HEADER + ipSIZE_OF_IPv4_HEADER + ipSIZE_OF_TCP_HEADER )
+
 
 /*-----------------------------------------------------------*/
 
@@ -132,6 +132,20 @@ static BaseType_t prvDetermineSocketSize( BaseType_t xDomain, BaseType_t xType,
 	static int32_t prvTCPSendCheck( FreeRTOS_Socket_t *pxSocket, size_t xDataLength );
 #endif /* ipconfigUSE_TCP */
 
+#if( ipconfigTCP_ZERO_COPY_TX != 0 )
+	/*
+	 * Called from FreeRTOS_send() when the FREERTOS_ZERO_COPY flag is used:
+	 * pass a buffer obtained from FreeRTOS_GetTCPPayloadBuffer() to the IP-task.
+	 */
+	static BaseType_t prvTCPSendZeroCopy( FreeRTOS_Socket_t *pxSocket, const void *pvBuffer, size_t uxDataLength, BaseType_t xFlags );
+
+	/*
+	 * Translate a pointer returned by FreeRTOS_GetTCPPayloadBuffer() to its
+	 * network buffer descriptor.
+	 */
+	static NetworkBufferDescriptor_t *prvTCPPayloadBuffer_to_NetworkBuffer( const void *pvBuffer );
+#endif /* ipconfigTCP_ZERO_COPY_TX */
+
 #if( ipconfigUSE_TCP == 1 )
 	/*
 	 * When a child socket gets closed, make sure to update the child-count of the parent
@@ -147,11 +161,37 @@ static BaseType_t prvDetermineSocketSize( BaseType_t xDomain, BaseType_t xType,
 	static BaseType_t prvTCPConnectStart( FreeRTOS_Socket_t *pxSocket, struct freertos_sockaddr *pxAddress );
 #endif /* ipconfigUSE_TCP */
 
+#if( ipconfigUSE_TCP == 1 )
+	/*
+	 * When the tick count has overflowed since the last call, swap the
+	 * current and the overflow timer lists.
+	 */
+	static void prvTCPTimerSwitchLists( TickType_t xNow );
+#endif /* ipconfigUSE_TCP */
+
+#if( ipconfigUSE_TCP == 1 )
+	/*
+	 * Insert a socket in the timer list which holds its deadline.
+	 */
+	static void prvTCPTimerInsert( FreeRTOS_Socket_t *pxSocket, TickType_t xDeadline, TickType_t xNow );
+#endif /* ipconfigUSE_TCP */
+
+#if( ipconfigUSE_TCP == 1 )
+	/*
+	 * Called by other tasks than the IP-task: add a socket to the list of
+	 * sockets which the IP-task must attend to.
+	 */
+	static void prvTCPTimerAttend( FreeRTOS_Socket_t *pxSocket );
+#endif /* ipconfigUSE_TCP */
+
 #if( ipconfigSUPPORT_SELECT_FUNCTION == 1 )
 
 	/* Executed by the IP-task, it will check all sockets belonging to a set */
 	static FreeRTOS_Socket_t *prvFindSelectedSocket( SocketSelect_t *pxSocketSet );
 
+	/* Executed by the IP-task, it checks which select events are true for a socket */
+	static EventBits_t prvSocketSelectBits( FreeRTOS_Socket_t *pxSocket );
+
 #endif /* ipconfigSUPPORT_SELECT_FUNCTION == 1 */
 /*-----------------------------------------------------------*/
 
@@ -161,6 +201,22 @@ List_t xBoundUDPSocketsList;
 
 #if ipconfigUSE_TCP == 1
 	List_t xBoundTCPSocketsList;
+
+	/* The TCP sockets with an active timer, sorted on their deadline.  Like the
+	kernel's delayed task lists, deadlines that lie beyond an overflow of the
+	tick count are kept in a separate list.  Only accessed by the IP-task. */
+	static List_t xTCPTimerLists[ 2 ];
+	static List_t *pxTCPTimerList;
+	static List_t *pxTCPOverflowTimerList;
+	static TickType_t xTCPTimerLastTime;
+
+	/* TCP sockets whose owner must be woken up before the IP-task blocks.  Only
+	accessed by the IP-task. */
+	static List_t xTCPWakeUpList;
+
+	/* TCP sockets that other tasks want attended by the IP-task.  Accesses
+	to this list must be protected by a critical section. */
+	static List_t xTCPAttendList;
 #endif /* ipconfigUSE_TCP == 1 */
 
 /*-----------------------------------------------------------*/
@@ -195,6 +251,13 @@ BaseType_t vNetworkSocketsInit( void )
 	#if( ipconfigUSE_TCP == 1 )
 	{
 		vListInitialise( &xBoundTCPSocketsList );
+		vListInitialise( &( xTCPTimerLists[ 0 ] ) );
+		vListInitialise( &( xTCPTimerLists[ 1 ] ) );
+		pxTCPTimerList = &( xTCPTimerLists[ 0 ] );
+		pxTCPOverflowTimerList = &( xTCPTimerLists[ 1 ] );
+		xTCPTimerLastTime = xTaskGetTickCount();
+		vListInitialise( &xTCPWakeUpList );
+		vListInitialise( &xTCPAttendList );
 	}
 	#endif  /* ipconfigUSE_TCP == 1 */
 
@@ -316,6 +379,13 @@ Socket_t xReturn;
 			vListInitialiseItem( &( pxSocket->xBoundSocketListItem ) );
 			listSET_LIST_ITEM_OWNER( &( pxSocket->xBoundSocketListItem ), ( void * ) pxSocket );
 
+			#if( ipconfigSUPPORT_SELECT_FUNCTION == 1 )
+			{
+				vListInitialiseItem( &( pxSocket->xSelectListItem ) );
+				listSET_LIST_ITEM_OWNER( &( pxSocket->xSelectListItem ), ( void * ) pxSocket );
+			}
+			#endif /* ipconfigSUPPORT_SELECT_FUNCTION == 1 */
+
 			pxSocket->xReceiveBlockTime = ipconfigSOCK_DEFAULT_RECEIVE_BLOCK_TIME;
 			pxSocket->xSendBlockTime	= ipconfigSOCK_DEFAULT_SEND_BLOCK_TIME;
 			pxSocket->ucSocketOptions   = ( uint8_t ) FREERTOS_SO_UDPCKSUM_OUT;
@@ -345,6 +415,18 @@ Socket_t xReturn;
 					/* The above values are just defaults, and can be overridden by
 					calling FreeRTOS_setsockopt().  No buffers will be allocated until a
 					socket is connected and data is exchanged. */
+
+					vListInitialiseItem( &( pxSocket->u.xTCP.xTimerListItem ) );
+					listSET_LIST_ITEM_OWNER( &( pxSocket->u.xTCP.xTimerListItem ), ( void * ) pxSocket );
+					vListInitialiseItem( &( pxSocket->u.xTCP.xWakeUpListItem ) );
+					listSET_LIST_ITEM_OWNER( &( pxSocket->u.xTCP.xWakeUpListItem ), ( void * ) pxSocket );
+					vListInitialiseItem( &( pxSocket->u.xTCP.xAttendListItem ) );
+					listSET_LIST_ITEM_OWNER( &( pxSocket->u.xTCP.xAttendListItem ), ( void * ) pxSocket );
+					#if( ipconfigTCP_ZERO_COPY_TX != 0 )
+					{
+						vListInitialise( &( pxSocket->u.xTCP.xZeroCopyTxList ) );
+					}
+					#endif
 				}
 			}
 			#endif  /* ipconfigUSE_TCP == 1 */
@@ -371,6 +453,7 @@ Socket_t xReturn;
 		if( pxSocketSet != NULL )
 		{
 			memset( pxSocketSet, '\0', sizeof( *pxSocketSet ) );
+			vListInitialise( &( pxSocketSet->xReadyList ) );
 			pxSocketSet->xSelectGroup = xEventGroupCreate();
 
 			if( pxSocketSet->xSelectGroup == NULL )
@@ -392,6 +475,16 @@ Socket_t xReturn;
 	{
 		SocketSelect_t *pxSocketSet = ( SocketSelect_t*) xSocketSet;
 
+		/* Detach the sockets that are still in the ready list. */
+		vTaskSuspendAll();
+		{
+			while( listLIST_IS_EMPTY( &( pxSocketSet->xReadyList ) ) == pdFALSE )
+			{
+				uxListRemove( listGET_HEAD_ENTRY( &( pxSocketSet->xReadyList ) ) );
+			}
+		}
+		xTaskResumeAll();
+
 		vEventGroupDelete( pxSocketSet->xSelectGroup );
 		vPortFree( ( void* ) pxSocketSet );
 	}
@@ -416,8 +509,22 @@ Socket_t xReturn;
 
 		if( ( pxSocket->xSelectBits & eSELECT_ALL ) != 0 )
 		{
-			/* Adding a socket to a socket set. */
-			pxSocket->pxSocketSet = ( SocketSelect_t * ) xSocketSet;
+			/* Adding a socket to a socket set.  It may be ready already, so it
+			is put in the ready list of the set to get checked. */
+			vTaskSuspendAll();
+			{
+				if( ( listLIST_ITEM_CONTAINER( &( pxSocket->xSelectListItem ) ) != NULL ) &&
+					( pxSocket->pxSocketSet != pxSocketSet ) )
+				{
+					/* It moves away from another socket set. */
+					uxListRemove( &( pxSocket->xSelectListItem ) );
+				}
+
+				pxSocket->pxSocketSet = ( SocketSelect_t * ) xSocketSet;
+			}
+			xTaskResumeAll();
+
+			vSocketSelectReady( pxSocket );
 
 			/* Now have the IP-task call vSocketSelect() to see if the set contains
 			any sockets which are 'ready' and set the proper bits.
@@ -449,7 +556,17 @@ Socket_t xReturn;
 		else
 		{
 			/* disconnect it from the socket set */
-			pxSocket->pxSocketSet = ( SocketSelect_t *)NULL;
+			vTaskSuspendAll();
+			{
+				if( listLIST_ITEM_CONTAINER( &( pxSocket->xSelectListItem ) ) != NULL )
+				{
+					uxListRemove( &( pxSocket->xSelectListItem ) );
+				}
+
+				pxSocket->pxSocketSet = ( SocketSelect_t *)NULL;
+				pxSocket->xSocketBits = 0;
+			}
+			xTaskResumeAll();
 		}
 	}
 
@@ -545,6 +662,47 @@ Socket_t xReturn;
 #endif /* ipconfigSUPPORT_SELECT_FUNCTION */
 /*-----------------------------------------------------------*/
 
+#if( ipconfigSUPPORT_SELECT_FUNCTION == 1 )
+
+	/* After a call to FreeRTOS_select(), copy the sockets of the set that are
+	ready to 'pxSockets', and return their number.  Only the ready list of the
+	set is visited, not all sockets. */
+	BaseType_t FreeRTOS_GetReadySockets( SocketSet_t xSocketSet, Socket_t *pxSockets, BaseType_t xMaxSockets )
+	{
+	SocketSelect_t *pxSocketSet = ( SocketSelect_t * ) xSocketSet;
+	const MiniListItem_t *pxEnd;
+	const ListItem_t *pxIterator;
+	FreeRTOS_Socket_t *pxSocket;
+	BaseType_t xCount = 0;
+
+		configASSERT( xSocketSet != NULL );
+		configASSERT( pxSockets != NULL );
+
+		vTaskSuspendAll();
+		{
+			pxEnd = ( const MiniListItem_t* )listGET_END_MARKER( &( pxSocketSet->xReadyList ) );
+
+			for( pxIterator = ( const ListItem_t * ) listGET_NEXT( pxEnd );
+				 ( pxIterator != ( const ListItem_t * ) pxEnd ) && ( xCount < xMaxSockets );
+				 pxIterator = ( const ListItem_t * ) listGET_NEXT( pxIterator ) )
+			{
+				pxSocket = ( FreeRTOS_Socket_t * ) listGET_LIST_ITEM_OWNER( pxIterator );
+
+				if( ( pxSocket->xSocketBits & eSELECT_ALL ) != 0 )
+				{
+					pxSockets[ xCount ] = ( Socket_t ) pxSocket;
+					xCount++;
+				}
+			}
+		}
+		xTaskResumeAll();
+
+		return xCount;
+	}
+
+#endif /* ipconfigSUPPORT_SELECT_FUNCTION */
+/*-----------------------------------------------------------*/
+
 #if( ipconfigSUPPORT_SELECT_FUNCTION == 1 )
 
 	/* Send a message to the IP-task to have it check all sockets belonging to
@@ -1060,6 +1218,16 @@ List_t *pxSocketList;
 				}
 				#endif /* ipconfigETHERNET_DRIVER_FILTERS_PACKETS */
 			}
+
+			#if( ipconfigUSE_TCP == 1 )
+			{
+				/* A timer that was set before binding becomes active now. */
+				if( ( pxSocket->ucProtocol == ( uint8_t ) FREERTOS_IPPROTO_TCP ) && ( pxSocket->u.xTCP.usTimeout != 0u ) )
+				{
+					vTCPTimerSchedule( pxSocket, ( TickType_t ) pxSocket->u.xTCP.usTimeout );
+				}
+			}
+			#endif /* ipconfigUSE_TCP == 1 */
 		}
 	}
 	else
@@ -1149,11 +1317,33 @@ NetworkBufferDescriptor_t *pxNetworkBuffer;
 				{
 					vReleaseNetworkBufferAndDescriptor( pxSocket->u.xTCP.pxAckMessage );
 				}
+
+				#if( ipconfigUSE_LINKED_RX_MESSAGES != 0 )
+				{
+					/* The socket might be closed while the IP-task is processing
+					a chain of packets. */
+					vTCPRxBatchForget( pxSocket );
+				}
+				#endif
+
 				/* Free the resources which were claimed by the tcpWin member */
 				vTCPWindowDestroy( &pxSocket->u.xTCP.xTCPWindow );
 			}
 			#endif /* ipconfigUSE_TCP_WIN */
 
+			#if( ipconfigTCP_ZERO_COPY_TX != 0 )
+			{
+				/* Release the buffers that were sent but not yet handed to the
+				TCP window. */
+				while( listLIST_IS_EMPTY( &( pxSocket->u.xTCP.xZeroCopyTxList ) ) == pdFALSE )
+				{
+					pxNetworkBuffer = ( NetworkBufferDescriptor_t * ) listGET_OWNER_OF_HEAD_ENTRY( &( pxSocket->u.xTCP.xZeroCopyTxList ) );
+					uxListRemove( &( pxNetworkBuffer->xBufferListItem ) );
+					vReleaseNetworkBufferAndDescriptor( pxNetworkBuffer );
+				}
+			}
+			#endif /* ipconfigTCP_ZERO_COPY_TX */
+
 			/* Free the input and output streams */
 			if( pxSocket->u.xTCP.rxStream != NULL )
 			{
@@ -1168,10 +1358,44 @@ NetworkBufferDescriptor_t *pxNetworkBuffer;
 			/* In case this is a child socket, make sure the child-count of the
 			parent socket is decreased. */
 			prvTCPSetSocketCount( pxSocket );
+
+			/* The IP-task must not visit this socket anymore. */
+			if( listLIST_ITEM_CONTAINER( &( pxSocket->u.xTCP.xTimerListItem ) ) != NULL )
+			{
+				uxListRemove( &( pxSocket->u.xTCP.xTimerListItem ) );
+			}
+
+			if( listLIST_ITEM_CONTAINER( &( pxSocket->u.xTCP.xWakeUpListItem ) ) != NULL )
+			{
+				uxListRemove( &( pxSocket->u.xTCP.xWakeUpListItem ) );
+			}
+
+			taskENTER_CRITICAL();
+			{
+				if( listLIST_ITEM_CONTAINER( &( pxSocket->u.xTCP.xAttendListItem ) ) != NULL )
+				{
+					uxListRemove( &( pxSocket->u.xTCP.xAttendListItem ) );
+				}
+			}
+			taskEXIT_CRITICAL();
 		}
 	}
 	#endif  /* ipconfigUSE_TCP == 1 */
 
+	#if( ipconfigSUPPORT_SELECT_FUNCTION == 1 )
+	{
+		/* Make sure the socket won't be checked by vSocketSelect() anymore. */
+		vTaskSuspendAll();
+		{
+			if( listLIST_ITEM_CONTAINER( &( pxSocket->xSelectListItem ) ) != NULL )
+			{
+				uxListRemove( &( pxSocket->xSelectListItem ) );
+			}
+		}
+		xTaskResumeAll();
+	}
+	#endif /* ipconfigSUPPORT_SELECT_FUNCTION == 1 */
+
 	/* Socket must be unbound first, to ensure no more packets are queued on
 	it. */
 	if( socketSOCKET_IS_BOUND( pxSocket ) != pdFALSE )
@@ -1564,8 +1788,7 @@ FreeRTOS_Socket_t *pxSocket;
 						( pxSocket->u.xTCP.ucTCPState >= eESTABLISHED ) &&
 						( FreeRTOS_outstanding( pxSocket ) != 0 ) )
 					{
-						pxSocket->u.xTCP.usTimeout = 1u; /* to set/clear bSendFullSize */
-						xSendEventToIPTask( eTCPTimerEvent );
+						xTCPTimerWakeUp( pxSocket ); /* to set/clear bSendFullSize */
 					}
 				}
 				xReturn = 0;
@@ -1588,8 +1811,7 @@ FreeRTOS_Socket_t *pxSocket;
 					}
 
 					pxSocket->u.xTCP.bits.bWinChange = pdTRUE_UNSIGNED;
-					pxSocket->u.xTCP.usTimeout = 1u; /* to set/clear bRxStopped */
-					xSendEventToIPTask( eTCPTimerEvent );
+					xTCPTimerWakeUp( pxSocket ); /* to set/clear bRxStopped */
 				}
 				xReturn = 0;
 				break;
@@ -1835,6 +2057,24 @@ FreeRTOS_Socket_t *pxSocket = ( FreeRTOS_Socket_t * ) xSocket;
 
 /*-----------------------------------------------------------*/
 
+#if( ipconfigUSE_TCP == 1 )
+
+	void vSocketWakeUpUserDeferred( FreeRTOS_Socket_t *pxSocket )
+	{
+		if( xIsCallingFromIPTask() == pdFALSE )
+		{
+			/* The list of sockets to be woken up belongs to the IP-task. */
+			vSocketWakeUpUser( pxSocket );
+		}
+		else if( listLIST_ITEM_CONTAINER( &( pxSocket->u.xTCP.xWakeUpListItem ) ) == NULL )
+		{
+			vListInsertEnd( &xTCPWakeUpList, &( pxSocket->u.xTCP.xWakeUpListItem ) );
+		}
+	}
+
+#endif /* ipconfigUSE_TCP */
+/*-----------------------------------------------------------*/
+
 void vSocketWakeUpUser( FreeRTOS_Socket_t *pxSocket )
 {
 /* _HT_ must work this out, now vSocketWakeUpUser will be called for any important
@@ -1865,6 +2105,7 @@ void vSocketWakeUpUser( FreeRTOS_Socket_t *pxSocket )
 			if( xSelectBits != 0ul )
 			{
 				pxSocket->xSocketBits |= xSelectBits;
+				vSocketSelectReady( pxSocket );
 				xEventGroupSetBits( pxSocket->pxSocketSet->xSelectGroup, xSelectBits );
 			}
 		}
@@ -1976,9 +2217,7 @@ void vSocketWakeUpUser( FreeRTOS_Socket_t *pxSocket )
 				vTCPStateChange( pxSocket, eCONNECT_SYN );
 
 				/* To start an active connect. */
-				pxSocket->u.xTCP.usTimeout = 1u;
-
-				if( xSendEventToIPTask( eTCPTimerEvent ) != pdPASS )
+				if( xTCPTimerWakeUp( pxSocket ) != pdPASS )
 				{
 					xResult = -pdFREERTOS_ERRNO_ECANCELED;
 				}
@@ -2339,8 +2578,7 @@ void vSocketWakeUpUser( FreeRTOS_Socket_t *pxSocket )
 						{
 							pxSocket->u.xTCP.bits.bLowWater = pdFALSE_UNSIGNED;
 							pxSocket->u.xTCP.bits.bWinChange = pdTRUE_UNSIGNED;
-							pxSocket->u.xTCP.usTimeout = 1u; /* because bLowWater is cleared. */
-							xSendEventToIPTask( eTCPTimerEvent );
+							xTCPTimerWakeUp( pxSocket ); /* because bLowWater is cleared. */
 						}
 					}
 				}
@@ -2451,9 +2689,14 @@ void vSocketWakeUpUser( FreeRTOS_Socket_t *pxSocket )
 	TimeOut_t xTimeOut;
 	BaseType_t xCloseAfterSend;
 
-		/* Prevent compiler warnings about unused parameters.  The parameter
-		may be used in future versions. */
-		( void ) xFlags;
+		#if( ipconfigTCP_ZERO_COPY_TX != 0 )
+		{
+			if( ( xFlags & FREERTOS_ZERO_COPY ) != 0 )
+			{
+				return prvTCPSendZeroCopy( pxSocket, pvBuffer, uxDataLength, xFlags );
+			}
+		}
+		#endif /* ipconfigTCP_ZERO_COPY_TX */
 
 		xByteCount = ( BaseType_t ) prvTCPSendCheck( pxSocket, uxDataLength );
 
@@ -2515,15 +2758,9 @@ void vSocketWakeUpUser( FreeRTOS_Socket_t *pxSocket )
 					}
 
 					/* Send a message to the IP-task so it can work on this
-					socket.  Data is sent, let the IP-task work on it. */
-					pxSocket->u.xTCP.usTimeout = 1u;
-
-					if( xIsCallingFromIPTask() == pdFALSE )
-					{
-						/* Only send a TCP timer event when not called from the
-						IP-task. */
-						xSendEventToIPTask( eTCPTimerEvent );
-					}
+					socket.  Data is sent, let the IP-task work on it.  Only
+					a TCP timer event is sent when not called from the IP-task. */
+					xTCPTimerWakeUp( pxSocket );
 
 					xBytesLeft -= xByteCount;
 
@@ -2619,187 +2856,575 @@ void vSocketWakeUpUser( FreeRTOS_Socket_t *pxSocket )
 #endif /* ipconfigUSE_TCP */
 /*-----------------------------------------------------------*/
 
-#if( ipconfigUSE_TCP == 1 )
+#if( ipconfigTCP_ZERO_COPY_TX != 0 )
 
-	/*
-	 * Request to put a socket in listen mode
-	 */
-	BaseType_t FreeRTOS_listen( Socket_t xSocket, BaseType_t xBacklog )
+	static NetworkBufferDescriptor_t *prvTCPPayloadBuffer_to_NetworkBuffer( const void *pvBuffer )
 	{
-	FreeRTOS_Socket_t *pxSocket;
-	BaseType_t xResult = 0;
-
-		pxSocket = ( FreeRTOS_Socket_t * ) xSocket;
+	const uint8_t *pucBuffer;
+	NetworkBufferDescriptor_t *pxResult;
 
-		/* listen() is allowed for a valid TCP socket in Closed state and already
-		bound. */
-		if( prvValidSocket( pxSocket, FREERTOS_IPPROTO_TCP, pdTRUE ) == pdFALSE )
-		{
-			xResult = -pdFREERTOS_ERRNO_EOPNOTSUPP;
-		}
-		else if( ( pxSocket->u.xTCP.ucTCPState != eCLOSED ) && ( pxSocket->u.xTCP.ucTCPState != eCLOSE_WAIT ) )
+		if( pvBuffer == NULL )
 		{
-			/* Socket is in a wrong state. */
-			xResult = -pdFREERTOS_ERRNO_EOPNOTSUPP;
+			pxResult = NULL;
 		}
 		else
 		{
-			/* Backlog is interpreted here as "the maximum number of child
-			sockets. */
-			pxSocket->u.xTCP.usBacklog = ( uint16_t )FreeRTOS_min_int32( ( int32_t ) 0xffff, ( int32_t ) xBacklog );
+			/* Like with UDP, a pointer to the descriptor is stored in the
+			padding space in front of the Ethernet header. */
+			pucBuffer = ( ( const uint8_t * ) pvBuffer ) - ( socketTCP_PAYLOAD_OFFSET + ipBUFFER_PADDING );
 
-			/* This cleaning is necessary only if a listening socket is being
-			reused as it might have had a previous connection. */
-			if( pxSocket->u.xTCP.bits.bReuseSocket )
+			if( ( ( ( size_t ) pucBuffer ) & ( sizeof( pucBuffer ) - 1u ) ) == 0u )
 			{
-				if( pxSocket->u.xTCP.rxStream != NULL )
-				{
-					vStreamBufferClear( pxSocket->u.xTCP.rxStream );
-				}
-
-				if( pxSocket->u.xTCP.txStream != NULL )
-				{
-					vStreamBufferClear( pxSocket->u.xTCP.txStream );
-				}
-
-				memset( pxSocket->u.xTCP.xPacket.u.ucLastPacket, '\0', sizeof( pxSocket->u.xTCP.xPacket.u.ucLastPacket ) );
-				memset( &pxSocket->u.xTCP.xTCPWindow, '\0', sizeof( pxSocket->u.xTCP.xTCPWindow ) );
-				memset( &pxSocket->u.xTCP.bits, '\0', sizeof( pxSocket->u.xTCP.bits ) );
-
-				/* Now set the bReuseSocket flag again, because the bits have
-				just been cleared. */
-				pxSocket->u.xTCP.bits.bReuseSocket = pdTRUE_UNSIGNED;
+				pxResult = * ( ( NetworkBufferDescriptor_t * const * ) pucBuffer );
+			}
+			else
+			{
+				pxResult = NULL;
 			}
-
-			vTCPStateChange( pxSocket, eTCP_LISTEN );
 		}
 
-		return xResult;
+		return pxResult;
 	}
 
-#endif /* ipconfigUSE_TCP */
+#endif /* ipconfigTCP_ZERO_COPY_TX */
 /*-----------------------------------------------------------*/
 
-#if( ipconfigUSE_TCP == 1 )
+#if( ipconfigTCP_ZERO_COPY_TX != 0 )
 
-	/* shutdown - shut down part of a full-duplex connection */
-	BaseType_t FreeRTOS_shutdown( Socket_t xSocket, BaseType_t xHow )
+	void *FreeRTOS_GetTCPPayloadBuffer( Socket_t xSocket, size_t *pxMaxLength, TickType_t xBlockTimeTicks )
 	{
 	FreeRTOS_Socket_t *pxSocket = ( FreeRTOS_Socket_t * ) xSocket;
-	BaseType_t xResult;
+	NetworkBufferDescriptor_t *pxNetworkBuffer = NULL;
+	size_t uxMSS = 0u;
+	void *pvReturn = NULL;
 
-		if( prvValidSocket( pxSocket, FREERTOS_IPPROTO_TCP, pdTRUE ) == pdFALSE )
+		if( prvValidSocket( pxSocket, FREERTOS_IPPROTO_TCP, pdFALSE ) != pdFALSE )
 		{
-			/*_RB_ Is this comment correct?  The socket is not of a type that
-			supports the listen() operation. */
-			xResult = -pdFREERTOS_ERRNO_EOPNOTSUPP;
+			/* A segment never carries more than MSS bytes.  The buffer must also
+			be large enough to hold the socket's packet header, which may be
+			padded to the minimum Ethernet packet size when sending. */
+			uxMSS = ( size_t ) pxSocket->u.xTCP.usCurMSS;
+			pxNetworkBuffer = pxGetNetworkBufferWithDescriptor(
+				FreeRTOS_max_uint32( ( uint32_t ) sizeof( pxSocket->u.xTCP.xPacket.u.ucLastPacket ), ( uint32_t ) ( socketTCP_PAYLOAD_OFFSET + uxMSS ) ),
+				xBlockTimeTicks );
 		}
-		else if ( pxSocket->u.xTCP.ucTCPState != eESTABLISHED )
+
+		if( pxNetworkBuffer != NULL )
 		{
-			/*_RB_ Is this comment correct?  The socket is not of a type that
-			supports the listen() operation. */
-			xResult = -pdFREERTOS_ERRNO_EOPNOTSUPP;
+			pvReturn = ( void * ) &( pxNetworkBuffer->pucEthernetBuffer[ socketTCP_PAYLOAD_OFFSET ] );
 		}
 		else
 		{
-			pxSocket->u.xTCP.bits.bUserShutdown = pdTRUE_UNSIGNED;
+			uxMSS = 0u;
+		}
 
-			/* Let the IP-task perform the shutdown of the connection. */
-			pxSocket->u.xTCP.usTimeout = 1u;
-			xSendEventToIPTask( eTCPTimerEvent );
-			xResult = 0;
+		if( pxMaxLength != NULL )
+		{
+			*pxMaxLength = uxMSS;
 		}
-		(void) xHow;
 
-		return xResult;
+		return pvReturn;
 	}
 
-#endif /* ipconfigUSE_TCP */
+#endif /* ipconfigTCP_ZERO_COPY_TX */
 /*-----------------------------------------------------------*/
 
-#if( ipconfigUSE_TCP == 1 )
+#if( ipconfigTCP_ZERO_COPY_TX != 0 )
 
-	/*
-	 * A TCP timer has expired, now check all TCP sockets for:
-	 * - Active connect
-	 * - Send a delayed ACK
-	 * - Send new data
-	 * - Send a keep-alive packet
-	 * - Check for timeout (in non-connected states only)
-	 */
-	TickType_t xTCPTimerCheck( BaseType_t xWillSleep )
+	void FreeRTOS_ReleaseTCPPayloadBuffer( void *pvBuffer )
 	{
-	FreeRTOS_Socket_t *pxSocket;
-	TickType_t xShortest = pdMS_TO_TICKS( ( TickType_t ) ipTCP_TIMER_PERIOD_MS );
-	TickType_t xNow = xTaskGetTickCount();
-	static TickType_t xLastTime = 0u;
-	TickType_t xDelta = xNow - xLastTime;
-	ListItem_t* pxEnd = ( ListItem_t * ) listGET_END_MARKER( &xBoundTCPSocketsList );
-	ListItem_t *pxIterator = ( ListItem_t * ) listGET_HEAD_ENTRY( &xBoundTCPSocketsList );
+	NetworkBufferDescriptor_t *pxNetworkBuffer = prvTCPPayloadBuffer_to_NetworkBuffer( pvBuffer );
+
+		if( pxNetworkBuffer != NULL )
+		{
+			vReleaseNetworkBufferAndDescriptor( pxNetworkBuffer );
+		}
+	}
+
+#endif /* ipconfigTCP_ZERO_COPY_TX */
+/*-----------------------------------------------------------*/
+
+#if( ipconfigTCP_ZERO_COPY_TX != 0 )
+
+	static BaseType_t prvTCPSendZeroCopy( FreeRTOS_Socket_t *pxSocket, const void *pvBuffer, size_t uxDataLength, BaseType_t xFlags )
+	{
+	BaseType_t xResult;
+	NetworkBufferDescriptor_t *pxNetworkBuffer;
+	StreamBuffer_t *pxStream;
+	TickType_t xRemainingTime;
+	TimeOut_t xTimeOut;
+
+		pxNetworkBuffer = prvTCPPayloadBuffer_to_NetworkBuffer( pvBuffer );
 
-		xLastTime = xNow;
+		if( pxNetworkBuffer == NULL )
+		{
+			xResult = -pdFREERTOS_ERRNO_EINVAL;
+		}
+		else
+		{
+			xResult = ( BaseType_t ) prvTCPSendCheck( pxSocket, uxDataLength );
+		}
 
-		if( xDelta == 0u )
+		if( ( xResult > 0 ) && ( uxDataLength > ( size_t ) pxSocket->u.xTCP.usCurMSS ) )
 		{
-			xDelta = 1u;
+			/* The data must fit in a single segment.  The MSS may have
+			decreased since the buffer was obtained, the caller can still send
+			the data with a normal FreeRTOS_send(). */
+			xResult = -pdFREERTOS_ERRNO_EINVAL;
 		}
 
-		while( pxIterator != pxEnd )
+		if( xResult > 0 )
 		{
-			pxSocket = ( FreeRTOS_Socket_t * )listGET_LIST_ITEM_OWNER( pxIterator );
-			pxIterator = ( ListItem_t * ) listGET_NEXT( pxIterator );
+			pxStream = pxSocket->u.xTCP.txStream;
+			xRemainingTime = pxSocket->xSendBlockTime;
 
-			/* Sockets with 'tmout == 0' do not need any regular attention. */
-			if( pxSocket->u.xTCP.usTimeout == 0u )
+			#if( ipconfigUSE_CALLBACKS != 0 )
 			{
-				continue;
+				if( xIsCallingFromIPTask() != pdFALSE )
+				{
+					/* Don't let the IP-task wait for itself. */
+					xRemainingTime = ( TickType_t ) 0;
+				}
 			}
+			#endif /* ipconfigUSE_CALLBACKS */
 
-			if( xDelta < ( TickType_t ) pxSocket->u.xTCP.usTimeout )
+			if( ( xFlags & FREERTOS_MSG_DONTWAIT ) != 0 )
 			{
-				pxSocket->u.xTCP.usTimeout = ( uint16_t ) ( ( ( TickType_t ) pxSocket->u.xTCP.usTimeout ) - xDelta );
+				xRemainingTime = ( TickType_t ) 0;
 			}
-			else
-			{
-			int rc ;
-				pxSocket->u.xTCP.usTimeout = 0u;
-				rc = xTCPSocketCheck( pxSocket );
 
-				/* Within this function, the socket might want to send a delayed
-				ack or send out data or whatever it needs to do. */
-				if( rc < 0 )
-				{
-					/* Continue because the socket was deleted. */
-					continue;
-				}
-			}
+			vTaskSetTimeOutState( &xTimeOut );
 
-			/* In xEventBits the driver may indicate that the socket has
-			important events for the user.  These are only done just before the
-			IP-task goes to sleep. */
-			if( pxSocket->xEventBits != 0u )
+			/* txStream keeps the administration of all outgoing bytes, so it
+			must have space for the complete segment, although its data will
+			never be copied. */
+			while( uxStreamBufferGetSpace( pxStream ) < uxDataLength )
 			{
-				if( xWillSleep != pdFALSE )
+				if( ( xRemainingTime == ( TickType_t ) 0 ) || ( xTaskCheckForTimeOut( &xTimeOut, &xRemainingTime ) != pdFALSE ) )
 				{
-					/* The IP-task is about to go to sleep, so messages can be
-					sent to the socket owners. */
-					vSocketWakeUpUser( pxSocket );
+					break;
+				}
+
+				xEventGroupWaitBits( pxSocket->xEventGroup, eSOCKET_SEND | eSOCKET_CLOSED,
+					pdTRUE /*xClearOnExit*/, pdFALSE /*xWaitAllBits*/, xRemainingTime );
+			}
+
+			if( uxStreamBufferGetSpace( pxStream ) < uxDataLength )
+			{
+				if( pxSocket->u.xTCP.ucTCPState > eESTABLISHED )
+				{
+					xResult = -pdFREERTOS_ERRNO_ENOTCONN;
+				}
+				else
+				{
+					xResult = -pdFREERTOS_ERRNO_ENOSPC;
+				}
+			}
+			else
+			{
+				/* The IP-task looks up the buffers by their position in txStream.
+				The buffer must be queued before the head of txStream is
+				advanced, so it will be found together with its bytes. */
+				pxNetworkBuffer->xDataLength = uxDataLength;
+				listSET_LIST_ITEM_VALUE( &( pxNetworkBuffer->xBufferListItem ), ( TickType_t ) pxStream->uxHead );
+
+				taskENTER_CRITICAL();
+				{
+					vListInsertEnd( &( pxSocket->u.xTCP.xZeroCopyTxList ), &( pxNetworkBuffer->xBufferListItem ) );
+
+					if( pxSocket->u.xTCP.bits.bCloseAfterSend != pdFALSE_UNSIGNED )
+					{
+						pxSocket->u.xTCP.bits.bCloseRequested = pdTRUE_UNSIGNED;
+					}
+
+					( void ) uxStreamBufferAdd( pxStream, 0u, NULL, uxDataLength );
+				}
+				taskEXIT_CRITICAL();
+
+				xTCPTimerWakeUp( pxSocket );
+
+				xResult = ( BaseType_t ) uxDataLength;
+			}
+		}
+
+		return xResult;
+	}
+
+#endif /* ipconfigTCP_ZERO_COPY_TX */
+/*-----------------------------------------------------------*/
+
+#if( ipconfigUSE_TCP == 1 )
+
+	/*
+	 * Request to put a socket in listen mode
+	 */
+	BaseType_t FreeRTOS_listen( Socket_t xSocket, BaseType_t xBacklog )
+	{
+	FreeRTOS_Socket_t *pxSocket;
+	BaseType_t xResult = 0;
+
+		pxSocket = ( FreeRTOS_Socket_t * ) xSocket;
+
+		/* listen() is allowed for a valid TCP socket in Closed state and already
+		bound. */
+		if( prvValidSocket( pxSocket, FREERTOS_IPPROTO_TCP, pdTRUE ) == pdFALSE )
+		{
+			xResult = -pdFREERTOS_ERRNO_EOPNOTSUPP;
+		}
+		else if( ( pxSocket->u.xTCP.ucTCPState != eCLOSED ) && ( pxSocket->u.xTCP.ucTCPState != eCLOSE_WAIT ) )
+		{
+			/* Socket is in a wrong state. */
+			xResult = -pdFREERTOS_ERRNO_EOPNOTSUPP;
+		}
+		else
+		{
+			/* Backlog is interpreted here as "the maximum number of child
+			sockets. */
+			pxSocket->u.xTCP.usBacklog = ( uint16_t )FreeRTOS_min_int32( ( int32_t ) 0xffff, ( int32_t ) xBacklog );
+
+			/* This cleaning is necessary only if a listening socket is being
+			reused as it might have had a previous connection. */
+			if( pxSocket->u.xTCP.bits.bReuseSocket )
+			{
+				if( pxSocket->u.xTCP.rxStream != NULL )
+				{
+					vStreamBufferClear( pxSocket->u.xTCP.rxStream );
+				}
+
+				if( pxSocket->u.xTCP.txStream != NULL )
+				{
+					vStreamBufferClear( pxSocket->u.xTCP.txStream );
+				}
+
+				memset( pxSocket->u.xTCP.xPacket.u.ucLastPacket, '\0', sizeof( pxSocket->u.xTCP.xPacket.u.ucLastPacket ) );
+				memset( &pxSocket->u.xTCP.xTCPWindow, '\0', sizeof( pxSocket->u.xTCP.xTCPWindow ) );
+				memset( &pxSocket->u.xTCP.bits, '\0', sizeof( pxSocket->u.xTCP.bits ) );
+
+				/* Now set the bReuseSocket flag again, because the bits have
+				just been cleared. */
+				pxSocket->u.xTCP.bits.bReuseSocket = pdTRUE_UNSIGNED;
+			}
+
+			vTCPStateChange( pxSocket, eTCP_LISTEN );
+		}
+
+		return xResult;
+	}
+
+#endif /* ipconfigUSE_TCP */
+/*-----------------------------------------------------------*/
+
+#if( ipconfigUSE_TCP == 1 )
+
+	/* shutdown - shut down part of a full-duplex connection */
+	BaseType_t FreeRTOS_shutdown( Socket_t xSocket, BaseType_t xHow )
+	{
+	FreeRTOS_Socket_t *pxSocket = ( FreeRTOS_Socket_t * ) xSocket;
+	BaseType_t xResult;
+
+		if( prvValidSocket( pxSocket, FREERTOS_IPPROTO_TCP, pdTRUE ) == pdFALSE )
+		{
+			/*_RB_ Is this comment correct?  The socket is not of a type that
+			supports the listen() operation. */
+			xResult = -pdFREERTOS_ERRNO_EOPNOTSUPP;
+		}
+		else if ( pxSocket->u.xTCP.ucTCPState != eESTABLISHED )
+		{
+			/*_RB_ Is this comment correct?  The socket is not of a type that
+			supports the listen() operation. */
+			xResult = -pdFREERTOS_ERRNO_EOPNOTSUPP;
+		}
+		else
+		{
+			pxSocket->u.xTCP.bits.bUserShutdown = pdTRUE_UNSIGNED;
+
+			/* Let the IP-task perform the shutdown of the connection. */
+			xTCPTimerWakeUp( pxSocket );
+			xResult = 0;
+		}
+		(void) xHow;
+
+		return xResult;
+	}
+
+#endif /* ipconfigUSE_TCP */
+/*-----------------------------------------------------------*/
+
+#if( ipconfigUSE_TCP == 1 )
+
+	static void prvTCPTimerSwitchLists( TickType_t xNow )
+	{
+	List_t *pxTemp;
+	ListItem_t *pxItem;
+
+		if( xNow < xTCPTimerLastTime )
+		{
+			/* The tick count has overflowed.  The deadlines left in the current
+			list have all passed: give them the lowest possible value and move
+			them to the overflow list, which now becomes the current list. */
+			while( listLIST_IS_EMPTY( pxTCPTimerList ) == pdFALSE )
+			{
+				pxItem = ( ListItem_t * ) listGET_HEAD_ENTRY( pxTCPTimerList );
+				uxListRemove( pxItem );
+				listSET_LIST_ITEM_VALUE( pxItem, ( TickType_t ) 0u );
+				vListInsert( pxTCPOverflowTimerList, pxItem );
+			}
+
+			pxTemp = pxTCPTimerList;
+			pxTCPTimerList = pxTCPOverflowTimerList;
+			pxTCPOverflowTimerList = pxTemp;
+		}
+
+		xTCPTimerLastTime = xNow;
+	}
+
+#endif /* ipconfigUSE_TCP */
+/*-----------------------------------------------------------*/
+
+#if( ipconfigUSE_TCP == 1 )
+
+	static void prvTCPTimerInsert( FreeRTOS_Socket_t *pxSocket, TickType_t xDeadline, TickType_t xNow )
+	{
+		listSET_LIST_ITEM_VALUE( &( pxSocket->u.xTCP.xTimerListItem ), xDeadline );
+
+		if( xDeadline < xNow )
+		{
+			/* The deadline lies beyond the next overflow of the tick count. */
+			vListInsert( pxTCPOverflowTimerList, &( pxSocket->u.xTCP.xTimerListItem ) );
+		}
+		else
+		{
+			vListInsert( pxTCPTimerList, &( pxSocket->u.xTCP.xTimerListItem ) );
+		}
+	}
+
+#endif /* ipconfigUSE_TCP */
+/*-----------------------------------------------------------*/
+
+#if( ipconfigUSE_TCP == 1 )
+
+	static void prvTCPTimerAttend( FreeRTOS_Socket_t *pxSocket )
+	{
+		taskENTER_CRITICAL();
+		{
+			if( listLIST_ITEM_CONTAINER( &( pxSocket->u.xTCP.xAttendListItem ) ) == NULL )
+			{
+				vListInsertEnd( &xTCPAttendList, &( pxSocket->u.xTCP.xAttendListItem ) );
+			}
+		}
+		taskEXIT_CRITICAL();
+	}
+
+#endif /* ipconfigUSE_TCP */
+/*-----------------------------------------------------------*/
+
+#if( ipconfigUSE_TCP == 1 )
+
+	void vTCPTimerSchedule( FreeRTOS_Socket_t *pxSocket, TickType_t xTimeout )
+	{
+	TickType_t xNow;
+
+		pxSocket->u.xTCP.usTimeout = ( uint16_t ) xTimeout;
+
+		if( xIsCallingFromIPTask() == pdFALSE )
+		{
+			/* The timer lists belong to the IP-task, which will pick up the
+			new value of 'usTimeout' during its next call to xTCPTimerCheck(). */
+			prvTCPTimerAttend( pxSocket );
+		}
+		else
+		{
+			if( listLIST_ITEM_CONTAINER( &( pxSocket->u.xTCP.xTimerListItem ) ) != NULL )
+			{
+				uxListRemove( &( pxSocket->u.xTCP.xTimerListItem ) );
+			}
+
+			/* A socket that is not bound yet will be added by vSocketBind(). */
+			if( ( pxSocket->u.xTCP.usTimeout != 0u ) && ( socketSOCKET_IS_BOUND( pxSocket ) != pdFALSE ) )
+			{
+				xNow = xTaskGetTickCount();
+				prvTCPTimerSwitchLists( xNow );
+				prvTCPTimerInsert( pxSocket, xNow + ( TickType_t ) pxSocket->u.xTCP.usTimeout, xNow );
+			}
+		}
+	}
+
+#endif /* ipconfigUSE_TCP */
+/*-----------------------------------------------------------*/
+
+#if( ipconfigUSE_TCP == 1 )
+
+	BaseType_t xTCPTimerWakeUp( FreeRTOS_Socket_t *pxSocket )
+	{
+	BaseType_t xReturn = pdPASS;
+
+		if( xIsCallingFromIPTask() != pdFALSE )
+		{
+			vTCPTimerSchedule( pxSocket, ( TickType_t ) 1u );
+		}
+		else
+		{
+			pxSocket->u.xTCP.usTimeout = 1u;
+			prvTCPTimerAttend( pxSocket );
+
+			/* Send a message to the IP-task so it can work on this socket. */
+			xReturn = xSendEventToIPTask( eTCPTimerEvent );
+		}
+
+		return xReturn;
+	}
+
+#endif /* ipconfigUSE_TCP */
+/*-----------------------------------------------------------*/
+
+#if( ipconfigUSE_TCP == 1 )
+
+	TickType_t xTCPTimerNextExpiry( void )
+	{
+	TickType_t xReturn = portMAX_DELAY;
+	TickType_t xNow;
+
+		if( ( listLIST_IS_EMPTY( &xTCPWakeUpList ) == pdFALSE ) ||
+			( listLIST_IS_EMPTY( &xTCPAttendList ) == pdFALSE ) )
+		{
+			xReturn = ( TickType_t ) 0u;
+		}
+		else
+		{
+			xNow = xTaskGetTickCount();
+
+			if( xNow < xTCPTimerLastTime )
+			{
+				/* The tick count has overflowed, let xTCPTimerCheck() switch
+				the lists. */
+				xReturn = ( TickType_t ) 0u;
+			}
+			else if( listLIST_IS_EMPTY( pxTCPTimerList ) == pdFALSE )
+			{
+				if( listGET_ITEM_VALUE_OF_HEAD_ENTRY( pxTCPTimerList ) > xNow )
+				{
+					xReturn = listGET_ITEM_VALUE_OF_HEAD_ENTRY( pxTCPTimerList ) - xNow;
+				}
+				else
+				{
+					xReturn = ( TickType_t ) 0u;
+				}
+			}
+			else if( listLIST_IS_EMPTY( pxTCPOverflowTimerList ) == pdFALSE )
+			{
+				/* Unsigned arithmetic takes care of the overflow. */
+				xReturn = listGET_ITEM_VALUE_OF_HEAD_ENTRY( pxTCPOverflowTimerList ) - xNow;
+			}
+			else
+			{
+				/* No TCP socket has an active timer. */
+			}
+		}
+
+		return xReturn;
+	}
+
+#endif /* ipconfigUSE_TCP */
+/*-----------------------------------------------------------*/
+
+#if( ipconfigUSE_TCP == 1 )
+
+	/*
+	 * A TCP timer has expired, now check the TCP sockets whose deadline has
+	 * passed for:
+	 * - Active connect
+	 * - Send a delayed ACK
+	 * - Send new data
+	 * - Send a keep-alive packet
+	 * - Check for timeout (in non-connected states only)
+	 * Sockets without an active timer are not visited at all.
+	 */
+	TickType_t xTCPTimerCheck( BaseType_t xWillSleep )
+	{
+	FreeRTOS_Socket_t *pxSocket;
+	TickType_t xNow = xTaskGetTickCount();
+
+		prvTCPTimerSwitchLists( xNow );
+
+		/* First take over the sockets that other tasks want attended to. */
+		for( ;; )
+		{
+			taskENTER_CRITICAL();
+			{
+				if( listLIST_IS_EMPTY( &xTCPAttendList ) != pdFALSE )
+				{
+					pxSocket = NULL;
 				}
 				else
 				{
-					/* Or else make sure this will be called again to wake-up
-					the sockets' owner. */
-					xShortest = ( TickType_t ) 0;
+					pxSocket = ( FreeRTOS_Socket_t * ) listGET_OWNER_OF_HEAD_ENTRY( &xTCPAttendList );
+					uxListRemove( &( pxSocket->u.xTCP.xAttendListItem ) );
 				}
 			}
+			taskEXIT_CRITICAL();
+
+			if( pxSocket == NULL )
+			{
+				break;
+			}
 
-			if( ( pxSocket->u.xTCP.usTimeout != 0u ) && ( xShortest > ( TickType_t ) pxSocket->u.xTCP.usTimeout ) )
+			if( pxSocket->u.xTCP.usTimeout != 0u )
+			{
+				/* The socket will be checked right now. */
+				if( listLIST_ITEM_CONTAINER( &( pxSocket->u.xTCP.xTimerListItem ) ) != NULL )
+				{
+					uxListRemove( &( pxSocket->u.xTCP.xTimerListItem ) );
+				}
+
+				if( socketSOCKET_IS_BOUND( pxSocket ) != pdFALSE )
+				{
+					prvTCPTimerInsert( pxSocket, xNow, xNow );
+				}
+			}
+			else
 			{
-				xShortest = ( TickType_t ) pxSocket->u.xTCP.usTimeout;
+				vTCPTimerSchedule( pxSocket, ( TickType_t ) 0u );
 			}
 		}
 
-		return xShortest;
+		/* Now visit the sockets whose deadline has passed. */
+		while( listLIST_IS_EMPTY( pxTCPTimerList ) == pdFALSE )
+		{
+			if( listGET_ITEM_VALUE_OF_HEAD_ENTRY( pxTCPTimerList ) > xNow )
+			{
+				break;
+			}
+
+			pxSocket = ( FreeRTOS_Socket_t * ) listGET_OWNER_OF_HEAD_ENTRY( pxTCPTimerList );
+			uxListRemove( &( pxSocket->u.xTCP.xTimerListItem ) );
+			pxSocket->u.xTCP.usTimeout = 0u;
+
+			/* Within this function, the socket might want to send a delayed
+			ack or send out data or whatever it needs to do.  It may also set
+			a new timer, or delete the socket, in which case it has been
+			removed from all lists. */
+			( void ) xTCPSocketCheck( pxSocket );
+		}
+
+		/* In xEventBits the driver may indicate that the socket has important
+		events for the user.  These are only done just before the IP-task goes
+		to sleep, otherwise xTCPTimerNextExpiry() makes sure that this function
+		is called again. */
+		if( xWillSleep != pdFALSE )
+		{
+			while( listLIST_IS_EMPTY( &xTCPWakeUpList ) == pdFALSE )
+			{
+				pxSocket = ( FreeRTOS_Socket_t * ) listGET_OWNER_OF_HEAD_ENTRY( &xTCPWakeUpList );
+				uxListRemove( &( pxSocket->u.xTCP.xWakeUpListItem ) );
+
+				if( pxSocket->xEventBits != 0u )
+				{
+					vSocketWakeUpUser( pxSocket );
+				}
+			}
+		}
+
+		return xTCPTimerNextExpiry();
 	}
 
 #endif /* ipconfigUSE_TCP */
@@ -3045,8 +3670,7 @@ void vSocketWakeUpUser( FreeRTOS_Socket_t *pxSocket )
 						pxSocket->u.xTCP.bits.bWinChange = pdTRUE_UNSIGNED;
 
 						/* bLowWater was reached, send the changed window size. */
-						pxSocket->u.xTCP.usTimeout = 1u;
-						xSendEventToIPTask( eTCPTimerEvent );
+						xTCPTimerWakeUp( pxSocket );
 					}
 				}
 
@@ -3062,6 +3686,8 @@ void vSocketWakeUpUser( FreeRTOS_Socket_t *pxSocket )
 					}
 				}
 				#endif
+
+				vSocketWakeUpUserDeferred( pxSocket );
 			}
 		}
 
@@ -3401,135 +4027,305 @@ void vSocketWakeUpUser( FreeRTOS_Socket_t *pxSocket )
 #endif /* ( ( ipconfigHAS_PRINTF != 0 ) && ( ipconfigUSE_TCP == 1 ) ) */
 /*-----------------------------------------------------------*/
 
-#if( ipconfigSUPPORT_SELECT_FUNCTION == 1 )
+#if( ( ipconfigUSE_TCP == 1 ) && ( ipconfigTCP_CONNECTION_STATS != 0 ) )
 
-	void vSocketSelect( SocketSelect_t *pxSocketSet )
+	BaseType_t FreeRTOS_GetTCPStats( Socket_t xSocket, TCPConnectionStats_t *pxStats )
 	{
-	BaseType_t xRound;
-	EventBits_t xSocketBits, xBitsToClear;
-	#if ipconfigUSE_TCP == 1
-		BaseType_t xLastRound = 1;
-	#else
-		BaseType_t xLastRound = 0;
-	#endif
+	FreeRTOS_Socket_t *pxSocket = ( FreeRTOS_Socket_t * ) xSocket;
+	BaseType_t xResult;
 
-		/* These flags will be switched on after checking the socket status. */
-		EventBits_t xGroupBits = 0;
-		pxSocketSet->pxSocket = NULL;
+		if( ( pxStats == NULL ) || ( prvValidSocket( pxSocket, FREERTOS_IPPROTO_TCP, pdFALSE ) == pdFALSE ) )
+		{
+			xResult = -pdFREERTOS_ERRNO_EINVAL;
+		}
+		else
+		{
+			/* The IP-task is the only writer and each counter is a single
+			aligned 32-bit word, so every value read is a value that has
+			actually been stored. */
+			pxStats->ulBytesIn = pxSocket->u.xTCP.ulBytesIn;
+			pxStats->ulBytesOut = pxSocket->u.xTCP.ulBytesOut;
+			pxStats->ulSegmentsIn = pxSocket->u.xTCP.ulSegmentsIn;
+			pxStats->ulSegmentsOut = pxSocket->u.xTCP.ulSegmentsOut;
+			pxStats->ulRetransmits = pxSocket->u.xTCP.xTCPWindow.ulRetransmitCount;
+			xResult = 0;
+		}
+
+		return xResult;
+	}
 
-		for( xRound = 0; xRound <= xLastRound; xRound++ )
+#endif /* ( ipconfigUSE_TCP == 1 ) && ( ipconfigTCP_CONNECTION_STATS != 0 ) */
+/*-----------------------------------------------------------*/
+
+#if( ipconfigUSE_TCP == 1 )
+
+	BaseType_t FreeRTOS_GetTCPConnections( TCPConnectionInfo_t *pxTable, BaseType_t xMaxEntries, TickType_t xBlockTimeTicks )
+	{
+	TCPConnectionsRequest_t xRequest;
+	IPStackEvent_t xAskEvent;
+	BaseType_t xResult;
+
+		xRequest.pxTable = pxTable;
+		xRequest.xMaxEntries = ( pxTable != NULL ) ? xMaxEntries : 0;
+		xRequest.xCount = 0;
+		xRequest.xDone = pdFALSE;
+
+		if( xIsCallingFromIPTask() != pdFALSE )
 		{
-			const ListItem_t *pxIterator;
-			const MiniListItem_t *pxEnd;
-			if( xRound == 0 )
+			/* The list of bound sockets may be accessed directly. */
+			xRequest.xTaskToNotify = NULL;
+			vTCPConnectionsSnapshot( &xRequest );
+			xResult = xRequest.xCount;
+		}
+		else
+		{
+			xRequest.xTaskToNotify = xTaskGetCurrentTaskHandle();
+			xAskEvent.eEventType = eTCPConnectionsEvent;
+			xAskEvent.pvData = ( void * ) &xRequest;
+
+			if( xSendEventStructToIPTask( &xAskEvent, xBlockTimeTicks ) == pdFAIL )
 			{
-				pxEnd = ( const MiniListItem_t* )listGET_END_MARKER( &xBoundUDPSocketsList );
+				FreeRTOS_debug_printf( ( "FreeRTOS_GetTCPConnections: send event failed\n" ) );
+				xResult = -pdFREERTOS_ERRNO_EWOULDBLOCK;
 			}
-		#if ipconfigUSE_TCP == 1
 			else
 			{
-				pxEnd = ( const MiniListItem_t* )listGET_END_MARKER( &xBoundTCPSocketsList );
+				/* Once the event has been queued, the IP-task will write to
+				'xRequest', which lives on this stack, so it must be waited
+				for.  'xDone' protects against notifications that were meant
+				for something else. */
+				while( xRequest.xDone == pdFALSE )
+				{
+					( void ) ulTaskNotifyTakeIndexed( ipconfigNOTIFICATION_INDEX, pdTRUE, portMAX_DELAY );
+				}
+
+				xResult = xRequest.xCount;
 			}
-		#endif /* ipconfigUSE_TCP == 1 */
-			for( pxIterator = ( const ListItem_t * ) ( listGET_NEXT( pxEnd ) );
+		}
+
+		return xResult;
+	}
+	/*-----------------------------------------------------------*/
+
+	void vTCPConnectionsSnapshot( TCPConnectionsRequest_t *pxRequest )
+	{
+	const ListItem_t *pxIterator;
+	const MiniListItem_t *pxEnd = ( const MiniListItem_t* )listGET_END_MARKER( &xBoundTCPSocketsList );
+	TCPConnectionInfo_t *pxInfo;
+	BaseType_t xCount = 0;
+	TaskHandle_t xTaskToNotify = pxRequest->xTaskToNotify;
+
+		/* Only the IP-task adds sockets to or removes sockets from
+		xBoundTCPSocketsList, so the list can not change while it is walked. */
+		if( listLIST_IS_INITIALISED( &xBoundTCPSocketsList ) != pdFALSE )
+		{
+			for( pxIterator  = ( const ListItem_t * ) listGET_NEXT( pxEnd );
 				 pxIterator != ( const ListItem_t * ) pxEnd;
-				 pxIterator = ( const ListItem_t * ) listGET_NEXT( pxIterator ) )
+				 pxIterator  = ( const ListItem_t * ) listGET_NEXT( pxIterator ) )
 			{
 				FreeRTOS_Socket_t *pxSocket = ( FreeRTOS_Socket_t * ) listGET_LIST_ITEM_OWNER( pxIterator );
-				if( pxSocket->pxSocketSet != pxSocketSet )
+
+				if( xCount < pxRequest->xMaxEntries )
 				{
-					/* Socket does not belong to this select group. */
-					continue;
+					pxInfo = &( pxRequest->pxTable[ xCount ] );
+					pxInfo->ulRemoteIP = pxSocket->u.xTCP.ulRemoteIP;
+					pxInfo->usRemotePort = pxSocket->u.xTCP.usRemotePort;
+					pxInfo->usLocalPort = pxSocket->usLocalPort;
+					pxInfo->ucTCPState = pxSocket->u.xTCP.ucTCPState;
+
+					#if( ipconfigTCP_CONNECTION_STATS != 0 )
+					{
+						pxInfo->xStats.ulBytesIn = pxSocket->u.xTCP.ulBytesIn;
+						pxInfo->xStats.ulBytesOut = pxSocket->u.xTCP.ulBytesOut;
+						pxInfo->xStats.ulSegmentsIn = pxSocket->u.xTCP.ulSegmentsIn;
+						pxInfo->xStats.ulSegmentsOut = pxSocket->u.xTCP.ulSegmentsOut;
+						pxInfo->xStats.ulRetransmits = pxSocket->u.xTCP.xTCPWindow.ulRetransmitCount;
+					}
+					#endif
 				}
-				xSocketBits = 0;
 
-				#if( ipconfigUSE_TCP == 1 )
-					if( pxSocket->ucProtocol == FREERTOS_IPPROTO_TCP )
+				xCount++;
+			}
+		}
+
+		pxRequest->xCount = xCount;
+
+		/* The request lives on the stack of the caller, which may return as
+		soon as 'xDone' is set, e.g. after a stray notification.  Do not access
+		'*pxRequest' after this store. */
+		pxRequest->xDone = pdTRUE;
+
+		if( xTaskToNotify != NULL )
+		{
+			xTaskNotifyGiveIndexed( xTaskToNotify, ipconfigNOTIFICATION_INDEX );
+		}
+	}
+
+#endif /* ipconfigUSE_TCP */
+/*-----------------------------------------------------------*/
+
+#if( ipconfigSUPPORT_SELECT_FUNCTION == 1 )
+
+	/* Return the select events that are currently true for a socket. */
+	static EventBits_t prvSocketSelectBits( FreeRTOS_Socket_t *pxSocket )
+	{
+	EventBits_t xSocketBits = 0;
+
+		#if( ipconfigUSE_TCP == 1 )
+			if( pxSocket->ucProtocol == FREERTOS_IPPROTO_TCP )
+			{
+				/* Check if the socket has already been accepted by the
+				owner.  If not, it is useless to return it from a
+				select(). */
+				BaseType_t bAccepted = pdFALSE;
+
+				if( pxSocket->u.xTCP.bits.bPassQueued == pdFALSE_UNSIGNED )
+				{
+					if( pxSocket->u.xTCP.bits.bPassAccept == pdFALSE_UNSIGNED )
 					{
-						/* Check if the socket has already been accepted by the
-						owner.  If not, it is useless to return it from a
-						select(). */
-						BaseType_t bAccepted = pdFALSE;
+						bAccepted = pdTRUE;
+					}
+				}
 
-						if( pxSocket->u.xTCP.bits.bPassQueued == pdFALSE_UNSIGNED )
+				/* Is the set owner interested in READ events? */
+				if( ( pxSocket->xSelectBits & eSELECT_READ ) != 0 )
+				{
+					if( pxSocket->u.xTCP.ucTCPState == eTCP_LISTEN )
+					{
+						if( ( pxSocket->u.xTCP.pxPeerSocket != NULL ) && ( pxSocket->u.xTCP.pxPeerSocket->u.xTCP.bits.bPassAccept != 0 ) )
 						{
-							if( pxSocket->u.xTCP.bits.bPassAccept == pdFALSE_UNSIGNED )
-							{
-								bAccepted = pdTRUE;
-							}
+							xSocketBits |= eSELECT_READ;
 						}
+					}
+					else if( ( pxSocket->u.xTCP.bits.bReuseSocket != pdFALSE_UNSIGNED ) && ( pxSocket->u.xTCP.bits.bPassAccept != pdFALSE_UNSIGNED ) )
+					{
+						/* This socket has the re-use flag. After connecting it turns into
+						aconnected socket. Set the READ event, so that accept() will be called. */
+						xSocketBits |= eSELECT_READ;
+					}
+					else if( ( bAccepted != 0 ) && ( FreeRTOS_recvcount( pxSocket ) > 0 ) )
+					{
+						xSocketBits |= eSELECT_READ;
+					}
+				}
+				/* Is the set owner interested in EXCEPTION events? */
+				if( ( pxSocket->xSelectBits & eSELECT_EXCEPT ) != 0 )
+				{
+					if( ( pxSocket->u.xTCP.ucTCPState == eCLOSE_WAIT ) || ( pxSocket->u.xTCP.ucTCPState == eCLOSED ) )
+					{
+						xSocketBits |= eSELECT_EXCEPT;
+					}
+				}
 
-						/* Is the set owner interested in READ events? */
-						if( ( pxSocket->xSelectBits & eSELECT_READ ) != 0 )
+				/* Is the set owner interested in WRITE events? */
+				if( ( pxSocket->xSelectBits & eSELECT_WRITE ) != 0 )
+				{
+					BaseType_t bMatch = pdFALSE;
+
+					if( bAccepted != 0 )
+					{
+						if( FreeRTOS_tx_space( pxSocket ) > 0 )
 						{
-							if( pxSocket->u.xTCP.ucTCPState == eTCP_LISTEN )
-							{
-								if( ( pxSocket->u.xTCP.pxPeerSocket != NULL ) && ( pxSocket->u.xTCP.pxPeerSocket->u.xTCP.bits.bPassAccept != 0 ) )
-								{
-									xSocketBits |= eSELECT_READ;
-								}
-							}
-							else if( ( pxSocket->u.xTCP.bits.bReuseSocket != pdFALSE_UNSIGNED ) && ( pxSocket->u.xTCP.bits.bPassAccept != pdFALSE_UNSIGNED ) )
-							{
-								/* This socket has the re-use flag. After connecting it turns into
-								aconnected socket. Set the READ event, so that accept() will be called. */
-								xSocketBits |= eSELECT_READ;
-							}
-							else if( ( bAccepted != 0 ) && ( FreeRTOS_recvcount( pxSocket ) > 0 ) )
-							{
-								xSocketBits |= eSELECT_READ;
-							}
+							bMatch = pdTRUE;
 						}
-						/* Is the set owner interested in EXCEPTION events? */
-						if( ( pxSocket->xSelectBits & eSELECT_EXCEPT ) != 0 )
+					}
+
+					if( bMatch == pdFALSE )
+					{
+						if( ( pxSocket->u.xTCP.bits.bConnPrepared != pdFALSE_UNSIGNED ) &&
+							( pxSocket->u.xTCP.ucTCPState >= eESTABLISHED ) &&
+							( pxSocket->u.xTCP.bits.bConnPassed == pdFALSE_UNSIGNED ) )
 						{
-							if( ( pxSocket->u.xTCP.ucTCPState == eCLOSE_WAIT ) || ( pxSocket->u.xTCP.ucTCPState == eCLOSED ) )
-							{
-								xSocketBits |= eSELECT_EXCEPT;
-							}
+							pxSocket->u.xTCP.bits.bConnPassed = pdTRUE_UNSIGNED;
+							bMatch = pdTRUE;
 						}
+					}
 
-						/* Is the set owner interested in WRITE events? */
-						if( ( pxSocket->xSelectBits & eSELECT_WRITE ) != 0 )
-						{
-							BaseType_t bMatch = pdFALSE;
+					if( bMatch != pdFALSE )
+					{
+						xSocketBits |= eSELECT_WRITE;
+					}
+				}
+			}
+			else
+		#endif /* ipconfigUSE_TCP == 1 */
+		{
+			/* Select events for UDP are simpler. */
+			if( ( ( pxSocket->xSelectBits & eSELECT_READ ) != 0 ) &&
+				( listCURRENT_LIST_LENGTH( &( pxSocket->u.xUDP.xWaitingPacketsList ) ) > 0U ) )
+			{
+				xSocketBits |= eSELECT_READ;
+			}
+			/* The WRITE and EXCEPT bits are not used for UDP */
+		}	/* if( pxSocket->ucProtocol == FREERTOS_IPPROTO_TCP ) */
 
-							if( bAccepted != 0 )
-							{
-								if( FreeRTOS_tx_space( pxSocket ) > 0 )
-								{
-									bMatch = pdTRUE;
-								}
-							}
+		return xSocketBits;
+	}
 
-							if( bMatch == pdFALSE )
-							{
-								if( ( pxSocket->u.xTCP.bits.bConnPrepared != pdFALSE_UNSIGNED ) &&
-									( pxSocket->u.xTCP.ucTCPState >= eESTABLISHED ) &&
-									( pxSocket->u.xTCP.bits.bConnPassed == pdFALSE_UNSIGNED ) )
-								{
-									pxSocket->u.xTCP.bits.bConnPassed = pdTRUE_UNSIGNED;
-									bMatch = pdTRUE;
-								}
-							}
+#endif /* ipconfigSUPPORT_SELECT_FUNCTION == 1 */
+/*-----------------------------------------------------------*/
 
-							if( bMatch != pdFALSE )
-							{
-								xSocketBits |= eSELECT_WRITE;
-							}
-						}
-					}
-					else
-				#endif /* ipconfigUSE_TCP == 1 */
+#if( ipconfigSUPPORT_SELECT_FUNCTION == 1 )
+
+	void vSocketSelectReady( FreeRTOS_Socket_t *pxSocket )
+	{
+		/* The ready lists are also changed by the API's FreeRTOS_FD_SET() and
+		FreeRTOS_FD_CLR(), so the scheduler is suspended while accessing them. */
+		vTaskSuspendAll();
+		{
+			if( ( pxSocket->pxSocketSet != NULL ) &&
+				( listLIST_ITEM_CONTAINER( &( pxSocket->xSelectListItem ) ) == NULL ) )
+			{
+				vListInsertEnd( &( pxSocket->pxSocketSet->xReadyList ), &( pxSocket->xSelectListItem ) );
+			}
+		}
+		xTaskResumeAll();
+	}
+
+#endif /* ipconfigSUPPORT_SELECT_FUNCTION == 1 */
+/*-----------------------------------------------------------*/
+
+#if( ipconfigSUPPORT_SELECT_FUNCTION == 1 )
+
+	void vSocketSelect( SocketSelect_t *pxSocketSet )
+	{
+	EventBits_t xSocketBits, xBitsToClear;
+	const MiniListItem_t *pxEnd;
+	ListItem_t *pxIterator, *pxNext;
+	FreeRTOS_Socket_t *pxSocket;
+
+		/* These flags will be switched on after checking the socket status. */
+		EventBits_t xGroupBits = 0;
+		pxSocketSet->pxSocket = NULL;
+
+		/* Only the sockets in the ready list are checked: they either got an
+		event since the previous call, or they were still ready at that time.
+		Sockets that are not ready anymore are removed from the list. */
+		vTaskSuspendAll();
+		{
+			pxEnd = ( const MiniListItem_t* )listGET_END_MARKER( &( pxSocketSet->xReadyList ) );
+
+			for( pxIterator = ( ListItem_t * ) listGET_NEXT( pxEnd );
+				 pxIterator != ( const ListItem_t * ) pxEnd;
+				 pxIterator = pxNext )
+			{
+				pxNext = ( ListItem_t * ) listGET_NEXT( pxIterator );
+				pxSocket = ( FreeRTOS_Socket_t * ) listGET_LIST_ITEM_OWNER( pxIterator );
+
+				if( socketSOCKET_IS_BOUND( pxSocket ) == pdFALSE )
+				{
+					/* Not bound yet, keep it in the list. */
+					xSocketBits = 0;
+				}
+				else
 				{
-					/* Select events for UDP are simpler. */
-					if( ( ( pxSocket->xSelectBits & eSELECT_READ ) != 0 ) &&
-						( listCURRENT_LIST_LENGTH( &( pxSocket->u.xUDP.xWaitingPacketsList ) ) > 0U ) )
+					xSocketBits = prvSocketSelectBits( pxSocket );
+
+					if( xSocketBits == 0 )
 					{
-						xSocketBits |= eSELECT_READ;
+						uxListRemove( pxIterator );
 					}
-					/* The WRITE and EXCEPT bits are not used for UDP */
-				}	/* if( pxSocket->ucProtocol == FREERTOS_IPPROTO_TCP ) */
+				}
 
 				/* Each socket keeps its own event flags, which are looked-up
 				by FreeRTOS_FD_ISSSET() */
@@ -3538,9 +4334,9 @@ void vSocketWakeUpUser( FreeRTOS_Socket_t *pxSocket )
 				/* The ORed value will be used to set the bits in the event
 				group. */
 				xGroupBits |= xSocketBits;
-
-			}	/* for( pxIterator ... ) */
-		}	/* for( xRound = 0; xRound <= xLastRound; xRound++ ) */
+			}
+		}
+		xTaskResumeAll();
 
 		xBitsToClear = xEventGroupGetBits( pxSocketSet->xSelectGroup );
 
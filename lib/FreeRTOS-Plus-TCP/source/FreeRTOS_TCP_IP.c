@@ -201,6 +201,14 @@ static int32_t prvTCPSendRepeated( FreeRTOS_Socket_t *pxSocket, NetworkBufferDes
 /*
  * Return or send a packet to the other party.
  */
+#if( ipconfigDRIVER_INCLUDED_TX_IP_CHECKSUM == 0 )
+	/*
+	 * Set the TCP checksum of an outgoing packet of which the sum of the
+	 * payload is already known.  ulIPLength is the length of the IP packet.
+	 */
+	static void prvTCPChecksumWithPayloadSum( TCPPacket_t *pxTCPPacket, uint32_t ulIPLength, uint16_t usPayloadSum );
+#endif
+
 static void prvTCPReturnPacket( FreeRTOS_Socket_t *pxSocket, NetworkBufferDescriptor_t *pxNetworkBuffer,
 	uint32_t ulLen, BaseType_t xReleaseAfterSend );
 
@@ -246,6 +254,22 @@ static void prvTCPTouchSocket( FreeRTOS_Socket_t *pxSocket );
  */
 static int32_t prvTCPPrepareSend( FreeRTOS_Socket_t *pxSocket, NetworkBufferDescriptor_t **ppxNetworkBuffer, UBaseType_t uxOptionsLength );
 
+#if( ipconfigTCP_ZERO_COPY_TX != 0 )
+	/*
+	 * Let prvTCPPrepareSend() send the network buffer that holds the payload of
+	 * 'pxSegment'.  The headers are copied from 'pxNetworkBuffer', which is
+	 * released.
+	 */
+	static NetworkBufferDescriptor_t *prvTCPSegmentBuffer( FreeRTOS_Socket_t *pxSocket, NetworkBufferDescriptor_t *pxNetworkBuffer,
+		TCPSegment_t *pxSegment, UBaseType_t uxOptionsLength );
+
+	/*
+	 * After sending the buffer of a TX segment, make sure that the caller won't
+	 * use or release it.
+	 */
+	static void prvTCPForgetSegmentBuffer( FreeRTOS_Socket_t *pxSocket, NetworkBufferDescriptor_t **ppxNetworkBuffer );
+#endif
+
 /*
  * Calculate when this socket needs to be checked to do (re-)transmissions.
  */
@@ -257,6 +281,12 @@ static TickType_t prvTCPNextTimeout( FreeRTOS_Socket_t *pxSocket );
  */
 static void prvTCPAddTxData( FreeRTOS_Socket_t *pxSocket );
 
+/*
+ * Pass 'lLength' bytes from txStream, starting at uxMid, to the sliding window.
+ * Returns the number of bytes that were added.
+ */
+static int32_t prvTCPAddTxStreamData( FreeRTOS_Socket_t *pxSocket, int32_t lLength );
+
 /*
  *  Called to handle the closure of a TCP connection.
  */
@@ -349,6 +379,15 @@ static NetworkBufferDescriptor_t *prvTCPBufferResize( FreeRTOS_Socket_t *pxSocke
 	static uint8_t prvWinScaleFactor( FreeRTOS_Socket_t *pxSocket );
 #endif
 
+#if( ( ipconfigUSE_LINKED_RX_MESSAGES != 0 ) && ( ipconfigUSE_TCP_WIN == 1 ) )
+	/*
+	 * While a chain of received packets is being processed, register a socket
+	 * that has an ACK pending.  Returns pdFALSE when the table is full, the ACK
+	 * must then be sent immediately.
+	 */
+	static BaseType_t prvTCPRxBatchAddSocket( FreeRTOS_Socket_t *pxSocket );
+#endif
+
 /*
  * Generate a randomized TCP Initial Sequence Number per RFC.
  */
@@ -357,6 +396,16 @@ extern uint32_t ulApplicationGetNextSequenceNumber( uint32_t ulSourceAddress,
 													uint32_t ulDestinationAddress,
 													uint16_t usDestinationPort );
 
+#if( ( ipconfigUSE_LINKED_RX_MESSAGES != 0 ) && ( ipconfigUSE_TCP_WIN == 1 ) )
+	/* Set to pdTRUE by vTCPRxBatchBegin() while the IP-task is processing a
+	chain of received packets. */
+	static BaseType_t xTCPRxBatchActive = pdFALSE;
+
+	/* The sockets that have an ACK pending until the end of the batch. */
+	static FreeRTOS_Socket_t *pxTCPRxBatchSockets[ ipconfigTCP_RX_BATCH_ACK_SOCKETS ];
+	static BaseType_t xTCPRxBatchCount = 0;
+#endif
+
 /*-----------------------------------------------------------*/
 
 /* prvTCPSocketIsActive() returns true if the socket must be checked.
@@ -659,6 +708,12 @@ int32_t xSendLength;
 		}
 		#endif /* ipconfigZERO_COPY_TX_DRIVER */
 
+		#if( ipconfigTCP_ZERO_COPY_TX != 0 )
+		{
+			prvTCPForgetSegmentBuffer( pxSocket, ppxNetworkBuffer );
+		}
+		#endif /* ipconfigTCP_ZERO_COPY_TX */
+
 		lResult += xSendLength;
 	}
 
@@ -673,6 +728,36 @@ int32_t xSendLength;
  * called 'xTCP.xPacket'.   A temporary xNetworkBuffer will be used to pass
  * the data to the NIC.
  */
+#if( ipconfigDRIVER_INCLUDED_TX_IP_CHECKSUM == 0 )
+
+	static void prvTCPChecksumWithPayloadSum( TCPPacket_t *pxTCPPacket, uint32_t ulIPLength, uint16_t usPayloadSum )
+	{
+	uint32_t ulSum;
+	size_t uxHeaderLength;
+	uint16_t usChecksum;
+
+		/* The length of the TCP header, including options. */
+		uxHeaderLength = ( size_t ) ( ( pxTCPPacket->xTCPHeader.ucTCPOffset >> 4 ) * 4u );
+
+		/* Start with the pseudo header fields protocol and TCP length, plus the
+		sum of the payload.  The payload starts at an even offset from the
+		IP-addresses, so its sum can be added as is. */
+		ulSum = ( ulIPLength - ipSIZE_OF_IPv4_HEADER ) + ( uint32_t ) ipPROTOCOL_TCP + ( uint32_t ) usPayloadSum;
+		ulSum = ( ulSum & 0xffffu ) + ( ulSum >> 16 );
+		ulSum = ( ulSum & 0xffffu ) + ( ulSum >> 16 );
+
+		/* Continue at the IPv4 source and destination addresses, followed by the
+		TCP header. */
+		pxTCPPacket->xTCPHeader.usChecksum = 0u;
+		usChecksum = ( uint16_t ) ~usGenerateChecksum( ulSum, ( uint8_t * ) &( pxTCPPacket->xIPHeader.ulSourceIPAddress ),
+			( 2u * sizeof( pxTCPPacket->xIPHeader.ulSourceIPAddress ) ) + uxHeaderLength );
+
+		pxTCPPacket->xTCPHeader.usChecksum = FreeRTOS_htons( usChecksum );
+	}
+
+#endif /* ipconfigDRIVER_INCLUDED_TX_IP_CHECKSUM == 0 */
+/*-----------------------------------------------------------*/
+
 static void prvTCPReturnPacket( FreeRTOS_Socket_t *pxSocket, NetworkBufferDescriptor_t *pxNetworkBuffer, uint32_t ulLen, BaseType_t xReleaseAfterSend )
 {
 TCPPacket_t * pxTCPPacket;
@@ -696,6 +781,14 @@ NetworkBufferDescriptor_t xTempBuffer;
 		xTempBuffer.xDataLength = sizeof( pxSocket->u.xTCP.xPacket.u.ucLastPacket );
 		xReleaseAfterSend = pdFALSE;
 	}
+	#if( ipconfigTCP_ZERO_COPY_TX != 0 )
+	else if( ( pxSocket != NULL ) && ( pxSocket->u.xTCP.bits.bTxSegmentBuffer != pdFALSE_UNSIGNED ) )
+	{
+		/* The buffer belongs to a TX segment, which needs it in case the data
+		must be retransmitted. */
+		xReleaseAfterSend = pdFALSE;
+	}
+	#endif /* ipconfigTCP_ZERO_COPY_TX */
 
 	#if( ipconfigZERO_COPY_TX_DRIVER != 0 )
 	{
@@ -845,6 +938,16 @@ NetworkBufferDescriptor_t xTempBuffer;
 
 			/* Tell which sequence number is expected next time */
 			pxTCPPacket->xTCPHeader.ulAckNr = FreeRTOS_htonl( pxTCPWindow->rx.ulCurrentSequenceNumber );
+
+			#if( ipconfigTCP_CONNECTION_STATS != 0 )
+			{
+				/* Count the payload only: 'ulLen' also includes the IP-header,
+				the TCP-header and the TCP options. */
+				pxSocket->u.xTCP.ulSegmentsOut++;
+				pxSocket->u.xTCP.ulBytesOut += ulLen - ( uint32_t ) ( ipSIZE_OF_IPv4_HEADER +
+					( ( pxTCPPacket->xTCPHeader.ucTCPOffset & VALID_BITS_IN_TCP_OFFSET_BYTE ) >> 2 ) );
+			}
+			#endif
 		}
 		else
 		{
@@ -884,7 +987,16 @@ NetworkBufferDescriptor_t xTempBuffer;
 			pxIPHeader->usHeaderChecksum = ~FreeRTOS_htons( pxIPHeader->usHeaderChecksum );
 
 			/* calculate the TCP checksum for an outgoing packet. */
-			usGenerateProtocolChecksum( (uint8_t*)pxTCPPacket, pxNetworkBuffer->xDataLength, pdTRUE );
+			if( ( pxSocket != NULL ) && ( pxSocket->u.xTCP.bits.bTxPayloadSum != pdFALSE_UNSIGNED ) )
+			{
+				/* The sum of the payload is known, only sum the headers. */
+				prvTCPChecksumWithPayloadSum( pxTCPPacket, ulLen, pxSocket->u.xTCP.usTxPayloadSum );
+				pxSocket->u.xTCP.bits.bTxPayloadSum = pdFALSE_UNSIGNED;
+			}
+			else
+			{
+				usGenerateProtocolChecksum( (uint8_t*)pxTCPPacket, pxNetworkBuffer->xDataLength, pdTRUE );
+			}
 
 			/* A calculated checksum of 0 must be inverted as 0 means the checksum
 			is disabled. */
@@ -1291,6 +1403,8 @@ UBaseType_t uxNewMSS;
 							}
 							#endif
 
+							vSocketWakeUpUserDeferred( pxSocket );
+
 							/* In case the socket owner has installed an OnSent handler,
 							call it now. */
 							#if( ipconfigUSE_CALLBACKS == 1 )
@@ -1544,7 +1658,16 @@ BaseType_t bAfter  = ( BaseType_t ) NOW_CONNECTED( eTCPState );						/* Is it co
 			won't need further attention of the IP-task.
 			Setting time-out to zero means that the socket won't get checked during
 			timer events. */
-			pxSocket->u.xTCP.usTimeout = 0u;
+			vTCPTimerSchedule( pxSocket, ( TickType_t ) 0u );
+		}
+
+		/* The socket owners will be woken up just before the IP-task goes
+		to sleep. */
+		vSocketWakeUpUserDeferred( pxSocket );
+
+		if( xParent != NULL )
+		{
+			vSocketWakeUpUserDeferred( xParent );
 		}
 	}
 	else
@@ -1668,6 +1791,62 @@ BaseType_t xResize;
 }
 /*-----------------------------------------------------------*/
 
+#if( ipconfigTCP_ZERO_COPY_TX != 0 )
+
+	static NetworkBufferDescriptor_t *prvTCPSegmentBuffer( FreeRTOS_Socket_t *pxSocket, NetworkBufferDescriptor_t *pxNetworkBuffer,
+		TCPSegment_t *pxSegment, UBaseType_t uxOptionsLength )
+	{
+	NetworkBufferDescriptor_t *pxReturn = pxSegment->pxBuffer;
+	const uint8_t *pucHeaders;
+
+		/* The payload of a zero-copy segment starts right after the TCP header,
+		data is only sent without TCP options. */
+		configASSERT( uxOptionsLength == 0u );
+		( void ) uxOptionsLength;
+
+		/* Copy the headers in front of the payload, either from the network
+		buffer supplied or from the socket field 'xTCP.xPacket'. */
+		if( pxNetworkBuffer != NULL )
+		{
+			pucHeaders = pxNetworkBuffer->pucEthernetBuffer;
+		}
+		else
+		{
+			pucHeaders = pxSocket->u.xTCP.xPacket.u.ucLastPacket;
+		}
+
+		memcpy( pxReturn->pucEthernetBuffer, pucHeaders, ipSIZE_OF_ETH_HEADER + ipSIZE_OF_IPv4_HEADER + ipSIZE_OF_TCP_HEADER );
+		pxReturn->xDataLength = ( size_t ) ( ipSIZE_OF_ETH_HEADER + ipSIZE_OF_IPv4_HEADER + ipSIZE_OF_TCP_HEADER ) + ( size_t ) pxSegment->lDataLength;
+
+		if( pxNetworkBuffer != NULL )
+		{
+			vReleaseNetworkBufferAndDescriptor( pxNetworkBuffer );
+		}
+
+		/* The segment keeps its buffer until the data has been acknowledged,
+		it may not be released after sending. */
+		pxSocket->u.xTCP.bits.bTxSegmentBuffer = pdTRUE_UNSIGNED;
+
+		return pxReturn;
+	}
+
+#endif /* ipconfigTCP_ZERO_COPY_TX */
+/*-----------------------------------------------------------*/
+
+#if( ipconfigTCP_ZERO_COPY_TX != 0 )
+
+	static void prvTCPForgetSegmentBuffer( FreeRTOS_Socket_t *pxSocket, NetworkBufferDescriptor_t **ppxNetworkBuffer )
+	{
+		if( pxSocket->u.xTCP.bits.bTxSegmentBuffer != pdFALSE_UNSIGNED )
+		{
+			pxSocket->u.xTCP.bits.bTxSegmentBuffer = pdFALSE_UNSIGNED;
+			*ppxNetworkBuffer = NULL;
+		}
+	}
+
+#endif /* ipconfigTCP_ZERO_COPY_TX */
+/*-----------------------------------------------------------*/
+
 /*
  * Prepare an outgoing message, in case anything has to be sent.
  */
@@ -1698,6 +1877,12 @@ int32_t lStreamPos;
 	lDataLen = 0;
 	lStreamPos = 0;
 	pxTCPPacket->xTCPHeader.ucTCPFlags |= ipTCP_FLAG_ACK;
+	pxSocket->u.xTCP.bits.bTxPayloadSum = pdFALSE_UNSIGNED;
+	#if( ipconfigTCP_ZERO_COPY_TX != 0 )
+	{
+		pxSocket->u.xTCP.bits.bTxSegmentBuffer = pdFALSE_UNSIGNED;
+	}
+	#endif
 
 	if( pxSocket->u.xTCP.txStream != NULL )
 	{
@@ -1712,9 +1897,20 @@ int32_t lStreamPos;
 
 		if( lDataLen > 0 )
 		{
-			/* Check if the current network buffer is big enough, if not,
-			resize it. */
-			pxNewBuffer = prvTCPBufferResize( pxSocket, *ppxNetworkBuffer, lDataLen, uxOptionsLength );
+			#if( ipconfigTCP_ZERO_COPY_TX != 0 )
+			if( ( pxTCPWindow->pxTxSegment != NULL ) && ( pxTCPWindow->pxTxSegment->pxBuffer != NULL ) )
+			{
+				/* The data of this segment is stored in a network buffer
+				already, send that buffer. */
+				pxNewBuffer = prvTCPSegmentBuffer( pxSocket, *ppxNetworkBuffer, pxTCPWindow->pxTxSegment, uxOptionsLength );
+			}
+			else
+			#endif /* ipconfigTCP_ZERO_COPY_TX */
+			{
+				/* Check if the current network buffer is big enough, if not,
+				resize it. */
+				pxNewBuffer = prvTCPBufferResize( pxSocket, *ppxNetworkBuffer, lDataLen, uxOptionsLength );
+			}
 
 			if( pxNewBuffer != NULL )
 			{
@@ -1724,13 +1920,24 @@ int32_t lStreamPos;
 
 				pucSendData = pucEthernetBuffer + ipSIZE_OF_ETH_HEADER + ipSIZE_OF_IPv4_HEADER + ipSIZE_OF_TCP_HEADER + uxOptionsLength;
 
-				/* Translate the position in txStream to an offset from the tail
-				marker. */
-				uxOffset = uxStreamBufferDistance( pxSocket->u.xTCP.txStream, pxSocket->u.xTCP.txStream->uxTail, ( size_t ) lStreamPos );
-
-				/* Here data is copied from the txStream in 'peek' mode.  Only
-				when the packets are acked, the tail marker will be updated. */
-				ulDataGot = ( uint32_t ) uxStreamBufferGet( pxSocket->u.xTCP.txStream, uxOffset, pucSendData, ( size_t ) lDataLen, pdTRUE );
+				#if( ipconfigTCP_ZERO_COPY_TX != 0 )
+				if( pxSocket->u.xTCP.bits.bTxSegmentBuffer != pdFALSE_UNSIGNED )
+				{
+					/* The data is in place, there is nothing to copy. */
+					ulDataGot = ( uint32_t ) lDataLen;
+				}
+				else
+				#endif /* ipconfigTCP_ZERO_COPY_TX */
+				{
+					/* Translate the position in txStream to an offset from the
+					tail marker. */
+					uxOffset = uxStreamBufferDistance( pxSocket->u.xTCP.txStream, pxSocket->u.xTCP.txStream->uxTail, ( size_t ) lStreamPos );
+
+					/* Here data is copied from the txStream in 'peek' mode.  Only
+					when the packets are acked, the tail marker will be
+					updated. */
+					ulDataGot = ( uint32_t ) uxStreamBufferGet( pxSocket->u.xTCP.txStream, uxOffset, pucSendData, ( size_t ) lDataLen, pdTRUE );
+				}
 
 				#if( ipconfigHAS_DEBUG_PRINTF != 0 )
 				{
@@ -1742,6 +1949,27 @@ int32_t lStreamPos;
 				}
 				#endif
 
+				#if( ( ipconfigUSE_TCP_WIN == 1 ) && ( ipconfigDRIVER_INCLUDED_TX_IP_CHECKSUM == 0 ) )
+				{
+				TCPSegment_t *pxSegment = pxTCPWindow->pxTxSegment;
+
+					/* The data of a segment doesn't change once it has been
+					transmitted.  Its sum is calculated only once, a
+					retransmission only needs to sum the headers. */
+					if( ( pxSegment != NULL ) && ( ulDataGot == ( uint32_t ) pxSegment->lDataLength ) )
+					{
+						if( pxSegment->u.bits.bPayloadSum == pdFALSE_UNSIGNED )
+						{
+							pxSegment->usPayloadSum = usGenerateChecksum( 0UL, pucSendData, ( size_t ) ulDataGot );
+							pxSegment->u.bits.bPayloadSum = pdTRUE_UNSIGNED;
+						}
+
+						pxSocket->u.xTCP.usTxPayloadSum = pxSegment->usPayloadSum;
+						pxSocket->u.xTCP.bits.bTxPayloadSum = pdTRUE_UNSIGNED;
+					}
+				}
+				#endif /* ( ipconfigUSE_TCP_WIN == 1 ) && ( ipconfigDRIVER_INCLUDED_TX_IP_CHECKSUM == 0 ) */
+
 				/* If the owner of the socket requests a closure, add the FIN
 				flag to the last packet. */
 				if( ( pxSocket->u.xTCP.bits.bCloseRequested != pdFALSE_UNSIGNED ) && ( pxSocket->u.xTCP.bits.bFinSent == pdFALSE_UNSIGNED ) )
@@ -1822,7 +2050,7 @@ int32_t lStreamPos;
 							pxSocket->u.xTCP.usRemotePort,
 							pxSocket->u.xTCP.ucKeepRepCount ) );
 					pxSocket->u.xTCP.bits.bSendKeepAlive = pdTRUE_UNSIGNED;
-					pxSocket->u.xTCP.usTimeout = ( ( uint16_t ) pdMS_TO_TICKS( 2500 ) );
+					vTCPTimerSchedule( pxSocket, pdMS_TO_TICKS( 2500 ) );
 					pxSocket->u.xTCP.ucKeepRepCount++;
 				}
 			}
@@ -1885,7 +2113,7 @@ TickType_t ulDelayMs = ( TickType_t ) tcpMAXIMUM_TCP_WAKEUP_TIME_MS;
 		FreeRTOS_debug_printf( ( "Connect[%lxip:%u]: next timeout %u: %lu ms\n",
 			pxSocket->u.xTCP.ulRemoteIP, pxSocket->u.xTCP.usRemotePort,
 			pxSocket->u.xTCP.ucRepCount, ulDelayMs ) );
-		pxSocket->u.xTCP.usTimeout = ( uint16_t )pdMS_TO_MIN_TICKS( ulDelayMs );
+		vTCPTimerSchedule( pxSocket, ( TickType_t ) pdMS_TO_MIN_TICKS( ulDelayMs ) );
 	}
 	else if( pxSocket->u.xTCP.usTimeout == 0u )
 	{
@@ -1906,7 +2134,7 @@ TickType_t ulDelayMs = ( TickType_t ) tcpMAXIMUM_TCP_WAKEUP_TIME_MS;
 		{
 			/* ulDelayMs contains the time to wait before a re-transmission. */
 		}
-		pxSocket->u.xTCP.usTimeout = ( uint16_t )pdMS_TO_MIN_TICKS( ulDelayMs );
+		vTCPTimerSchedule( pxSocket, ( TickType_t ) pdMS_TO_MIN_TICKS( ulDelayMs ) );
 	}
 	else
 	{
@@ -1921,7 +2149,12 @@ TickType_t ulDelayMs = ( TickType_t ) tcpMAXIMUM_TCP_WAKEUP_TIME_MS;
 
 static void prvTCPAddTxData( FreeRTOS_Socket_t *pxSocket )
 {
-int32_t lCount, lLength;
+int32_t lLength;
+#if( ipconfigTCP_ZERO_COPY_TX != 0 )
+	NetworkBufferDescriptor_t *pxZeroCopyBuffer;
+	size_t uxPosition;
+	int32_t lCount, lBufferLength;
+#endif
 
 	/* A txStream has been created already, see if the socket has new data for
 	the sliding window.
@@ -1931,6 +2164,87 @@ int32_t lCount, lLength;
 	data not-yet-confirmed can be found at rxTail. */
 	lLength = ( int32_t ) uxStreamBufferMidSpace( pxSocket->u.xTCP.txStream );
 
+	#if( ipconfigTCP_ZERO_COPY_TX != 0 )
+	{
+		/* Some of the new bytes may belong to buffers that were passed with
+		FREERTOS_ZERO_COPY.  FreeRTOS_send() queues such a buffer before it
+		advances uxHead, so all buffers within 'lLength' are visible now.
+		The bytes in front of a buffer are added as usual, the buffer itself
+		becomes a segment of its own. */
+		while( lLength > 0 )
+		{
+			pxZeroCopyBuffer = NULL;
+			uxPosition = 0u;
+
+			taskENTER_CRITICAL();
+			{
+				if( listLIST_IS_EMPTY( &( pxSocket->u.xTCP.xZeroCopyTxList ) ) == pdFALSE )
+				{
+					pxZeroCopyBuffer = ( NetworkBufferDescriptor_t * ) listGET_OWNER_OF_HEAD_ENTRY( &( pxSocket->u.xTCP.xZeroCopyTxList ) );
+					uxPosition = ( size_t ) listGET_LIST_ITEM_VALUE( &( pxZeroCopyBuffer->xBufferListItem ) );
+				}
+			}
+			taskEXIT_CRITICAL();
+
+			if( pxZeroCopyBuffer == NULL )
+			{
+				break;
+			}
+
+			lCount = ( int32_t ) uxStreamBufferDistance( pxSocket->u.xTCP.txStream, pxSocket->u.xTCP.txStream->uxMid, uxPosition );
+
+			if( lCount >= lLength )
+			{
+				/* Queued after uxHead was read, it will be handled next time. */
+				break;
+			}
+
+			if( lCount > 0 )
+			{
+				lCount = prvTCPAddTxStreamData( pxSocket, lCount );
+				lLength -= lCount;
+
+				if( pxSocket->u.xTCP.txStream->uxMid != uxPosition )
+				{
+					/* Ran out of segments. */
+					lLength = 0;
+					break;
+				}
+			}
+
+			lBufferLength = ( int32_t ) pxZeroCopyBuffer->xDataLength;
+
+			if( xTCPWindowTxAddBuffer( &( pxSocket->u.xTCP.xTCPWindow ), pxZeroCopyBuffer, ( uint32_t ) lBufferLength, ( int32_t ) uxPosition ) == pdFAIL )
+			{
+				/* Ran out of segments, the buffer stays queued. */
+				lLength = 0;
+				break;
+			}
+
+			/* The TCP window owns the buffer now. */
+			taskENTER_CRITICAL();
+			{
+				( void ) uxListRemove( &( pxZeroCopyBuffer->xBufferListItem ) );
+			}
+			taskEXIT_CRITICAL();
+
+			vStreamBufferMoveMid( pxSocket->u.xTCP.txStream, ( size_t ) lBufferLength );
+			lLength -= lBufferLength;
+		}
+	}
+	#endif /* ipconfigTCP_ZERO_COPY_TX */
+
+	if( lLength > 0 )
+	{
+		( void ) prvTCPAddTxStreamData( pxSocket, lLength );
+	}
+}
+/*-----------------------------------------------------------*/
+
+static int32_t prvTCPAddTxStreamData( FreeRTOS_Socket_t *pxSocket, int32_t lLength )
+{
+int32_t lCount;
+
 	if( lLength > 0 )
 	{
 		/* All data between txMid and rxHead will now be passed to the sliding
@@ -1949,7 +2263,17 @@ int32_t lCount, lLength;
 		{
 			vStreamBufferMoveMid( pxSocket->u.xTCP.txStream, ( size_t ) lCount );
 		}
+		else
+		{
+			lCount = 0;
+		}
 	}
+	else
+	{
+		lCount = 0;
+	}
+
+	return lCount;
 }
 /*-----------------------------------------------------------*/
 
@@ -2399,6 +2723,9 @@ int32_t lDistance, lSendResult;
 					}
 				}
 				#endif
+
+				vSocketWakeUpUserDeferred( pxSocket );
+
 				/* In case the socket owner has installed an OnSent handler,
 				call it now. */
 				#if( ipconfigUSE_CALLBACKS == 1 )
@@ -2579,14 +2906,14 @@ int32_t lRxSpace;
 			if( ( ulReceiveLength < ( uint32_t ) pxSocket->u.xTCP.usCurMSS ) ||	/* Received a small message. */
 				( lRxSpace < ( int32_t ) ( 2U * pxSocket->u.xTCP.usCurMSS ) ) )	/* There are less than 2 x MSS space in the Rx buffer. */
 			{
-				pxSocket->u.xTCP.usTimeout = ( uint16_t ) pdMS_TO_MIN_TICKS( DELAYED_ACK_SHORT_DELAY_MS );
+				vTCPTimerSchedule( pxSocket, ( TickType_t ) pdMS_TO_MIN_TICKS( DELAYED_ACK_SHORT_DELAY_MS ) );
 			}
 			else
 			{
 				/* Normally a delayed ACK should wait 200 ms for a next incoming
 				packet.  Only wait 20 ms here to gain performance.  A slow ACK
 				for full-size message. */
-				pxSocket->u.xTCP.usTimeout = ( uint16_t ) pdMS_TO_MIN_TICKS( DELAYED_ACK_LONGER_DELAY_MS );
+				vTCPTimerSchedule( pxSocket, ( TickType_t ) pdMS_TO_MIN_TICKS( DELAYED_ACK_LONGER_DELAY_MS ) );
 			}
 
 			if( ( xTCPWindowLoggingLevel > 1 ) && ( ipconfigTCP_MAY_LOG_PORT( pxSocket->usLocalPort ) != pdFALSE ) )
@@ -2603,6 +2930,32 @@ int32_t lRxSpace;
 			*ppxNetworkBuffer = NULL;
 			xSendLength = 0;
 		}
+		#if( ipconfigUSE_LINKED_RX_MESSAGES != 0 )
+		else if( ( xTCPRxBatchActive != pdFALSE ) &&
+			( ulReceiveLength > 0 ) &&
+			( pxSocket->u.xTCP.bits.bFinSent == pdFALSE_UNSIGNED ) &&
+			( xSendLength == ( ipSIZE_OF_IPv4_HEADER + ipSIZE_OF_TCP_HEADER ) ) &&
+			( pxSocket->u.xTCP.ucTCPState == eESTABLISHED ) &&
+			( pxTCPHeader->ucTCPFlags == ipTCP_FLAG_ACK ) &&
+			( prvTCPRxBatchAddSocket( pxSocket ) != pdFALSE ) )
+		{
+			/* The ACK should be sent now, but more packets for this socket may
+			follow in the same chain.  Only the latest ACK is kept, it will be
+			sent by vTCPRxBatchEnd() when the whole chain has been processed. */
+			if( pxSocket->u.xTCP.pxAckMessage != *ppxNetworkBuffer )
+			{
+				if( pxSocket->u.xTCP.pxAckMessage != NULL )
+				{
+					vReleaseNetworkBufferAndDescriptor( pxSocket->u.xTCP.pxAckMessage );
+				}
+
+				pxSocket->u.xTCP.pxAckMessage = *ppxNetworkBuffer;
+			}
+
+			*ppxNetworkBuffer = NULL;
+			xSendLength = 0;
+		}
+		#endif /* ipconfigUSE_LINKED_RX_MESSAGES */
 		else if( pxSocket->u.xTCP.pxAckMessage != NULL )
 		{
 			/* As an ACK is not being delayed, remove any earlier delayed ACK
@@ -2645,6 +2998,11 @@ int32_t lRxSpace;
 			*ppxNetworkBuffer = NULL;
 		}
 		#endif
+		#if( ipconfigTCP_ZERO_COPY_TX != 0 )
+		{
+			prvTCPForgetSegmentBuffer( pxSocket, ppxNetworkBuffer );
+		}
+		#endif
 	}
 
 	return xSendLength;
@@ -2689,6 +3047,13 @@ TCPWindow_t *pxTCPWindow = &( pxSocket->u.xTCP.xTCPWindow );
 	pucRecvData will point to the first byte of the TCP payload. */
 	ulReceiveLength = ( uint32_t ) prvCheckRxData( *ppxNetworkBuffer, &pucRecvData );
 
+	#if( ipconfigTCP_CONNECTION_STATS != 0 )
+	{
+		pxSocket->u.xTCP.ulSegmentsIn++;
+		pxSocket->u.xTCP.ulBytesIn += ulReceiveLength;
+	}
+	#endif
+
 	if( pxSocket->u.xTCP.ucTCPState >= eESTABLISHED )
 	{
 		if ( pxTCPWindow->rx.ulCurrentSequenceNumber == ulSequenceNumber + 1u )
@@ -3300,6 +3665,107 @@ BaseType_t xResult = pdFALSE;
 }
 /*-----------------------------------------------------------*/
 
+#if( ( ipconfigUSE_LINKED_RX_MESSAGES != 0 ) && ( ipconfigUSE_TCP_WIN == 1 ) )
+
+	static BaseType_t prvTCPRxBatchAddSocket( FreeRTOS_Socket_t *pxSocket )
+	{
+	BaseType_t xIndex;
+	BaseType_t xResult = pdFALSE;
+
+		for( xIndex = 0; xIndex < xTCPRxBatchCount; xIndex++ )
+		{
+			if( pxTCPRxBatchSockets[ xIndex ] == pxSocket )
+			{
+				xResult = pdTRUE;
+				break;
+			}
+		}
+
+		if( ( xResult == pdFALSE ) && ( xTCPRxBatchCount < ( BaseType_t ) ipconfigTCP_RX_BATCH_ACK_SOCKETS ) )
+		{
+			pxTCPRxBatchSockets[ xTCPRxBatchCount ] = pxSocket;
+			xTCPRxBatchCount++;
+			xResult = pdTRUE;
+		}
+
+		return xResult;
+	}
+
+#endif /* ( ipconfigUSE_LINKED_RX_MESSAGES != 0 ) && ( ipconfigUSE_TCP_WIN == 1 ) */
+/*-----------------------------------------------------------*/
+
+#if( ( ipconfigUSE_LINKED_RX_MESSAGES != 0 ) && ( ipconfigUSE_TCP_WIN == 1 ) )
+
+	void vTCPRxBatchBegin( void )
+	{
+		xTCPRxBatchCount = 0;
+		xTCPRxBatchActive = pdTRUE;
+	}
+
+#endif /* ( ipconfigUSE_LINKED_RX_MESSAGES != 0 ) && ( ipconfigUSE_TCP_WIN == 1 ) */
+/*-----------------------------------------------------------*/
+
+#if( ( ipconfigUSE_LINKED_RX_MESSAGES != 0 ) && ( ipconfigUSE_TCP_WIN == 1 ) )
+
+	void vTCPRxBatchEnd( void )
+	{
+	BaseType_t xIndex;
+	FreeRTOS_Socket_t *pxSocket;
+
+		xTCPRxBatchActive = pdFALSE;
+
+		for( xIndex = 0; xIndex < xTCPRxBatchCount; xIndex++ )
+		{
+			pxSocket = pxTCPRxBatchSockets[ xIndex ];
+
+			/* The ACK may have been sent already, along with data, while
+			processing a later packet of the chain. */
+			if( ( pxSocket->u.xTCP.pxAckMessage != NULL ) &&
+				( pxSocket->u.xTCP.ucTCPState == eESTABLISHED ) )
+			{
+				prvTCPReturnPacket( pxSocket, pxSocket->u.xTCP.pxAckMessage, ipSIZE_OF_IPv4_HEADER + ipSIZE_OF_TCP_HEADER, ipconfigZERO_COPY_TX_DRIVER );
+
+				#if( ipconfigZERO_COPY_TX_DRIVER != 0 )
+				{
+					/* The ownership has been passed to the SEND routine. */
+					pxSocket->u.xTCP.pxAckMessage = NULL;
+				}
+				#else
+				{
+					vReleaseNetworkBufferAndDescriptor( pxSocket->u.xTCP.pxAckMessage );
+					pxSocket->u.xTCP.pxAckMessage = NULL;
+				}
+				#endif /* ipconfigZERO_COPY_TX_DRIVER */
+			}
+		}
+
+		xTCPRxBatchCount = 0;
+	}
+
+#endif /* ( ipconfigUSE_LINKED_RX_MESSAGES != 0 ) && ( ipconfigUSE_TCP_WIN == 1 ) */
+/*-----------------------------------------------------------*/
+
+#if( ( ipconfigUSE_LINKED_RX_MESSAGES != 0 ) && ( ipconfigUSE_TCP_WIN == 1 ) )
+
+	void vTCPRxBatchForget( FreeRTOS_Socket_t *pxSocket )
+	{
+	BaseType_t xIndex;
+
+		for( xIndex = 0; xIndex < xTCPRxBatchCount; xIndex++ )
+		{
+			if( pxTCPRxBatchSockets[ xIndex ] == pxSocket )
+			{
+				/* Replace it with the last entry. */
+				xTCPRxBatchCount--;
+				pxTCPRxBatchSockets[ xIndex ] = pxTCPRxBatchSockets[ xTCPRxBatchCount ];
+				break;
+			}
+		}
+	}
+
+#endif /* ( ipconfigUSE_LINKED_RX_MESSAGES != 0 ) && ( ipconfigUSE_TCP_WIN == 1 ) */
+/*-----------------------------------------------------------*/
+
 #endif /* ipconfigUSE_TCP == 1 */
 
 /* Provide access to private members for testing. */
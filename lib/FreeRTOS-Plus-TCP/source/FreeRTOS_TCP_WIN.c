@@ -535,6 +535,17 @@ void vListInsertGeneric( List_t * const pxList, ListItem_t * const pxNewListItem
 		pxSegment->lDataLength = 0l;
 		pxSegment->u.ulFlags = 0u;
 
+		#if( ipconfigTCP_ZERO_COPY_TX != 0 )
+		{
+			/* The segment owns the buffer that holds its payload. */
+			if( pxSegment->pxBuffer != NULL )
+			{
+				vReleaseNetworkBufferAndDescriptor( pxSegment->pxBuffer );
+				pxSegment->pxBuffer = NULL;
+			}
+		}
+		#endif
+
 		/* Take it out of xRxSegments/xTxSegments */
 		if( listLIST_ITEM_CONTAINER( &( pxSegment->xListItem ) ) != NULL )
 		{
@@ -1025,6 +1036,7 @@ const int32_t l500ms = 500;
 					lToWrite = FreeRTOS_min_int32( lBytesLeft, pxSegment->lMaxLength - pxSegment->lDataLength );
 
 					pxSegment->lDataLength += lToWrite;
+					pxSegment->u.bits.bPayloadSum = pdFALSE_UNSIGNED;
 
 					if( pxSegment->lDataLength >= pxSegment->lMaxLength )
 					{
@@ -1126,6 +1138,51 @@ const int32_t l500ms = 500;
 #endif /* ipconfigUSE_TCP_WIN == 1 */
 /*-----------------------------------------------------------*/
 
+#if( ( ipconfigUSE_TCP_WIN == 1 ) && ( ipconfigTCP_ZERO_COPY_TX != 0 ) )
+
+	BaseType_t xTCPWindowTxAddBuffer( TCPWindow_t *pxWindow, NetworkBufferDescriptor_t *pxBuffer, uint32_t ulLength, int32_t lPosition )
+	{
+	TCPSegment_t *pxSegment;
+	BaseType_t xReturn;
+
+		/* The payload is already stored in a network buffer, so it gets a
+		segment of its own, which will never be extended with more data.
+		The bytes in txStream at 'lPosition' are only used for the sequence
+		administration, they will never be copied. */
+		pxSegment = xTCPWindowTxNew( pxWindow, pxWindow->ulNextTxSequenceNumber, ( int32_t ) ulLength );
+
+		if( pxSegment != NULL )
+		{
+			pxSegment->lStreamPos = lPosition;
+			pxSegment->pxBuffer = pxBuffer;
+			pxWindow->ulNextTxSequenceNumber += ulLength;
+
+			/* Data added later on must not be appended to an earlier segment. */
+			pxWindow->pxHeadSegment = NULL;
+
+			vListInsertFifo( &( pxWindow->xTxQueue ), &( pxSegment->xQueueItem ) );
+
+			if( ( xTCPWindowLoggingLevel >= 2 ) && ( ipconfigTCP_MAY_LOG_PORT( pxWindow->usOurPortNumber ) != 0 ) )
+			{
+				FreeRTOS_debug_printf( ( "xTCPWindowTxAddBuffer: %4lu bytes for seqNr %lu pos %lu\n",
+					ulLength,
+					pxSegment->ulSequenceNumber - pxWindow->tx.ulFirstSequenceNumber,
+					pxSegment->lStreamPos ) );
+				FreeRTOS_flush_logging( );
+			}
+			xReturn = pdPASS;
+		}
+		else
+		{
+			xReturn = pdFAIL;
+		}
+
+		return xReturn;
+	}
+
+#endif /* ( ipconfigUSE_TCP_WIN == 1 ) && ( ipconfigTCP_ZERO_COPY_TX != 0 ) */
+/*-----------------------------------------------------------*/
+
 #if( ipconfigUSE_TCP_WIN == 1 )
 
 	BaseType_t xTCPWindowTxDone( TCPWindow_t *pxWindow )
@@ -1284,6 +1341,7 @@ const int32_t l500ms = 500;
 
 		Priority messages: segments with a resend need no check current sliding
 		window size. */
+		pxWindow->pxTxSegment = NULL;
 		pxSegment = xTCPWindowGetHead( &( pxWindow->xPriorityQueue ) );
 		pxWindow->ulOurSequenceNumber = pxWindow->tx.ulHighestSequenceNumber;
 
@@ -1306,6 +1364,12 @@ const int32_t l500ms = 500;
 					pxSegment = xTCPWindowGetHead( &( pxWindow->xWaitQueue ) );
 					pxSegment->u.bits.ucDupAckCount = pdFALSE_UNSIGNED;
 
+					#if( ipconfigTCP_CONNECTION_STATS != 0 )
+					{
+						pxWindow->ulRetransmitCount++;
+					}
+					#endif
+
 					/* Some detailed logging. */
 					if( ( xTCPWindowLoggingLevel != 0 ) && ( ipconfigTCP_MAY_LOG_PORT( pxWindow->usOurPortNumber ) != 0 ) )
 					{
@@ -1428,6 +1492,7 @@ const int32_t l500ms = 500;
 
 			/* Inform the caller where to find the data within the queue. */
 			*plPosition = pxSegment->lStreamPos;
+			pxWindow->pxTxSegment = pxSegment;
 
 			/* And return the length of the data segment */
 			ulReturn = ( uint32_t ) pxSegment->lDataLength;
@@ -1640,6 +1705,12 @@ const int32_t l500ms = 500;
 				retransmitted immediately. */
 				vListInsertFifo( &( pxWindow->xPriorityQueue ), &( pxSegment->xQueueItem ) );
 				ulCount++;
+
+				#if( ipconfigTCP_CONNECTION_STATS != 0 )
+				{
+					pxWindow->ulRetransmitCount++;
+				}
+				#endif
 			}
 		}
 
@@ -1820,6 +1891,15 @@ const int32_t l500ms = 500;
 
 			if( ulLength != 0ul )
 			{
+				#if( ipconfigTCP_CONNECTION_STATS != 0 )
+				{
+					if( pxSegment->u.bits.bOutstanding != pdFALSE_UNSIGNED )
+					{
+						/* The time-out expired, the segment is sent again. */
+						pxWindow->ulRetransmitCount++;
+					}
+				}
+				#endif
 				pxSegment->u.bits.bOutstanding = pdTRUE_UNSIGNED;
 				pxSegment->u.bits.ucTransmitCount++;
 				vTCPTimerSet (&pxSegment->xTransmitTimer);
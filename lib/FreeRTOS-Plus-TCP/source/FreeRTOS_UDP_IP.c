@@ -318,6 +318,7 @@ UDPPacket_t *pxUDPPacket = (UDPPacket_t *) pxNetworkBuffer->pucEthernetBuffer;
 			{
 				if( ( pxSocket->pxSocketSet != NULL ) && ( ( pxSocket->xSelectBits & eSELECT_READ ) != 0 ) )
 				{
+					vSocketSelectReady( pxSocket );
 					xEventGroupSetBits( pxSocket->pxSocketSet->xSelectGroup, eSELECT_READ );
 				}
 			}
@@ -340,6 +341,15 @@ UDPPacket_t *pxUDPPacket = (UDPPacket_t *) pxNetworkBuffer->pucEthernetBuffer;
 				}
 			}
 			#endif
+
+			#if( ipconfigDNS_USE_RESOLVER != 0 )
+			{
+				if( xIsDNSSocket( pxSocket ) )
+				{
+					xSendEventToIPTask( eDNSEvent );
+				}
+			}
+			#endif
 		}
 	}
 	else
@@ -0,0 +1,671 @@
+/*
+ * FreeRTOS+TCP V2.0.8
+ * Copyright (C) 2017 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/******************************************************************************
+ *
+ * See the following web page for essential buffer allocation scheme usage and
+ * configuration details:
+ * http://www.FreeRTOS.org/FreeRTOS-Plus/FreeRTOS_Plus_TCP/Embedded_Ethernet_Buffer_Management.html
+ *
+ ******************************************************************************/
+
+/* This scheme takes the network buffers from static slabs, in three classes of
+different sizes.  Every descriptor owns one buffer for its whole life, so the
+heap is never used.  A request is served from the smallest class that is large
+enough, or from a larger class when that one is exhausted.
+
+A buffer is taken or returned within a single critical section, the counting
+semaphore of the other schemes is only used when a task must wait for a buffer.
+Drivers can get and release a batch of buffers in one go.
+
+Set ipconfigBUFFER_ALLOCATION_SLABS to 1 in FreeRTOSIPConfig.h when using this
+file, see FreeRTOSIPConfigDefaults.h for the sizes of the classes. */
+
+/* Standard includes. */
+#include <stdint.h>
+#include <string.h>
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+#include "semphr.h"
+
+/* FreeRTOS+TCP includes. */
+#include "FreeRTOS_IP.h"
+#include "FreeRTOS_IP_Private.h"
+#include "NetworkInterface.h"
+#include "NetworkBufferManagement.h"
+
+#if( ipconfigBUFFER_ALLOCATION_SLABS != 0 )
+
+/* The obtained network buffer must be large enough to hold a packet that might
+replace the packet that was requested to be sent. */
+#if ipconfigUSE_TCP == 1
+	#define baMINIMAL_BUFFER_SIZE		sizeof( TCPPacket_t )
+#else
+	#define baMINIMAL_BUFFER_SIZE		sizeof( ARPPacket_t )
+#endif /* ipconfigUSE_TCP == 1 */
+
+/* For an Ethernet interrupt to be able to obtain a network buffer there must
+be at least this number of buffers available. */
+#define baINTERRUPT_BUFFER_GET_THRESHOLD	( 3 )
+
+#define baNUMBER_OF_CLASSES			( 3 )
+
+/* The space taken by one buffer in a slab: the padding, in which a pointer to
+the descriptor is stored, plus the buffer itself, rounded up to 8 bytes. */
+#define baSLAB_STRIDE( xSize )		( ( ( ( size_t ) ( xSize ) ) + ipBUFFER_PADDING + 7u ) & ~( ( size_t ) 7u ) )
+
+#define baSMALL_STRIDE				baSLAB_STRIDE( ipconfigBUFFER_SLAB_SMALL_SIZE )
+#define baMEDIUM_STRIDE				baSLAB_STRIDE( ipconfigBUFFER_SLAB_MEDIUM_SIZE )
+#define baLARGE_STRIDE				baSLAB_STRIDE( ipTOTAL_ETHERNET_FRAME_SIZE )
+
+/* The user can define their own ipconfigBUFFER_ALLOC_LOCK() and
+ipconfigBUFFER_ALLOC_UNLOCK() macros, especially for use form an ISR.  If these
+are not defined then default them to call the normal enter/exit critical
+section macros. */
+#if !defined( ipconfigBUFFER_ALLOC_LOCK )
+
+	#define ipconfigBUFFER_ALLOC_INIT( ) do {} while (0)
+	#define ipconfigBUFFER_ALLOC_LOCK_FROM_ISR()		\
+		UBaseType_t uxSavedInterruptStatus = ( UBaseType_t ) portSET_INTERRUPT_MASK_FROM_ISR(); \
+		{
+
+	#define ipconfigBUFFER_ALLOC_UNLOCK_FROM_ISR()		\
+			portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedInterruptStatus ); \
+		}
+
+	#define ipconfigBUFFER_ALLOC_LOCK()					taskENTER_CRITICAL()
+	#define ipconfigBUFFER_ALLOC_UNLOCK()				taskEXIT_CRITICAL()
+
+#endif /* ipconfigBUFFER_ALLOC_LOCK */
+
+/* One size class: the free descriptors and the size of their buffers. */
+typedef struct xBUFFER_SLAB_CLASS
+{
+	List_t xFreeList;				/* The free descriptors of this class. */
+	size_t uxBufferSize;			/* The number of bytes available in each buffer. */
+	UBaseType_t uxFirst;			/* Index of the first descriptor in xNetworkBuffers[]. */
+	UBaseType_t uxCount;			/* Number of descriptors in this class. */
+} BufferSlabClass_t;
+
+/* The slabs.  uint64_t is used to get storage which is aligned well enough to
+store a pointer at the start of each buffer. */
+static uint64_t ullSmallSlab[ ( ipconfigBUFFER_SLAB_SMALL_COUNT * baSMALL_STRIDE ) / sizeof( uint64_t ) ];
+static uint64_t ullMediumSlab[ ( ipconfigBUFFER_SLAB_MEDIUM_COUNT * baMEDIUM_STRIDE ) / sizeof( uint64_t ) ];
+static uint64_t ullLargeSlab[ ( ipconfigBUFFER_SLAB_LARGE_COUNT * baLARGE_STRIDE ) / sizeof( uint64_t ) ];
+
+/* All descriptors, ordered by class: small, medium, large. */
+static NetworkBufferDescriptor_t xNetworkBuffers[ ipconfigNUM_NETWORK_BUFFER_DESCRIPTORS ];
+
+static BufferSlabClass_t xSlabClasses[ baNUMBER_OF_CLASSES ];
+
+/* The number of free buffers of all classes together, and the lowest value it
+has had. */
+static UBaseType_t uxFreeNetworkBuffers = 0u;
+static UBaseType_t uxMinimumFreeNetworkBuffers = 0u;
+
+/* The number of tasks waiting in pxGetNetworkBufferWithDescriptor(). */
+static UBaseType_t uxWaitingTasks = 0u;
+
+/* Given when a buffer is released while a task is waiting for one.  A waiting
+task may find that another task was faster, it will then wait again. */
+static SemaphoreHandle_t xNetworkBufferReleased = NULL;
+
+/* This constant is defined as false to let FreeRTOS_TCP_IP.c know that the
+network buffers have a variable size: resizing may be necessary */
+const BaseType_t xBufferAllocFixedSize = pdFALSE;
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Find the class of a descriptor, or NULL if it is not one of ours.
+ */
+static BufferSlabClass_t *prvGetClass( const NetworkBufferDescriptor_t *pxNetworkBuffer );
+
+/*
+ * Find the smallest class whose buffers can hold 'xRequestedSizeBytes'.  Returns
+ * baNUMBER_OF_CLASSES when the size is too big.
+ */
+static UBaseType_t prvSizeToClass( size_t xRequestedSizeBytes );
+
+/*
+ * Take a descriptor from class 'uxClass' or a larger one.  Must be called with
+ * the lock taken.
+ */
+static NetworkBufferDescriptor_t *prvTakeBuffer( UBaseType_t uxClass, size_t xRequestedSizeBytes );
+
+/*
+ * Return a descriptor to its free list.  Must be called with the lock taken.
+ * Returns pdFALSE if it was free already or is not valid.
+ */
+static BaseType_t prvPutBuffer( NetworkBufferDescriptor_t * const pxNetworkBuffer );
+
+/*-----------------------------------------------------------*/
+
+BaseType_t xNetworkBuffersInitialise( void )
+{
+BaseType_t xReturn;
+UBaseType_t uxClass, uxIndex, uxFirst = 0u;
+uint8_t *pucSlab;
+size_t uxStride;
+
+	/* Only initialise the buffers and their associated kernel objects if they
+	have not been initialised before. */
+	if( xNetworkBufferReleased == NULL )
+	{
+		/* In case alternative locking is used, the mutexes can be initialised
+		here */
+		ipconfigBUFFER_ALLOC_INIT();
+
+		configASSERT( ipconfigBUFFER_SLAB_SMALL_SIZE >= baMINIMAL_BUFFER_SIZE );
+		configASSERT( ipconfigBUFFER_SLAB_MEDIUM_SIZE >= ipconfigBUFFER_SLAB_SMALL_SIZE );
+		configASSERT( ipTOTAL_ETHERNET_FRAME_SIZE >= ipconfigBUFFER_SLAB_MEDIUM_SIZE );
+
+		xNetworkBufferReleased = xSemaphoreCreateCounting( ( UBaseType_t ) ipconfigNUM_NETWORK_BUFFER_DESCRIPTORS, 0u );
+		configASSERT( xNetworkBufferReleased );
+
+		if( xNetworkBufferReleased != NULL )
+		{
+			#if ( configQUEUE_REGISTRY_SIZE > 0 )
+			{
+				vQueueAddToRegistry( xNetworkBufferReleased, "NetBufRel" );
+			}
+			#endif /* configQUEUE_REGISTRY_SIZE */
+
+			xSlabClasses[ 0 ].uxBufferSize = ( size_t ) ipconfigBUFFER_SLAB_SMALL_SIZE;
+			xSlabClasses[ 0 ].uxCount = ( UBaseType_t ) ipconfigBUFFER_SLAB_SMALL_COUNT;
+			xSlabClasses[ 1 ].uxBufferSize = ( size_t ) ipconfigBUFFER_SLAB_MEDIUM_SIZE;
+			xSlabClasses[ 1 ].uxCount = ( UBaseType_t ) ipconfigBUFFER_SLAB_MEDIUM_COUNT;
+			xSlabClasses[ 2 ].uxBufferSize = ( size_t ) ipTOTAL_ETHERNET_FRAME_SIZE;
+			xSlabClasses[ 2 ].uxCount = ( UBaseType_t ) ipconfigBUFFER_SLAB_LARGE_COUNT;
+
+			for( uxClass = 0u; uxClass < ( UBaseType_t ) baNUMBER_OF_CLASSES; uxClass++ )
+			{
+				switch( uxClass )
+				{
+					case 0:  pucSlab = ( uint8_t * ) ullSmallSlab;  break;
+					case 1:  pucSlab = ( uint8_t * ) ullMediumSlab; break;
+					default: pucSlab = ( uint8_t * ) ullLargeSlab;  break;
+				}
+
+				uxStride = baSLAB_STRIDE( xSlabClasses[ uxClass ].uxBufferSize );
+				xSlabClasses[ uxClass ].uxFirst = uxFirst;
+				vListInitialise( &( xSlabClasses[ uxClass ].xFreeList ) );
+
+				for( uxIndex = uxFirst; uxIndex < ( uxFirst + xSlabClasses[ uxClass ].uxCount ); uxIndex++ )
+				{
+					/* Store a pointer to the descriptor in the padding space, in
+					front of the Ethernet buffer. */
+					*( ( NetworkBufferDescriptor_t ** ) pucSlab ) = &( xNetworkBuffers[ uxIndex ] );
+					xNetworkBuffers[ uxIndex ].pucEthernetBuffer = pucSlab + ipBUFFER_PADDING;
+					pucSlab += uxStride;
+
+					/* Initialise and set the owner of the buffer list items. */
+					vListInitialiseItem( &( xNetworkBuffers[ uxIndex ].xBufferListItem ) );
+					listSET_LIST_ITEM_OWNER( &( xNetworkBuffers[ uxIndex ].xBufferListItem ), &xNetworkBuffers[ uxIndex ] );
+
+					/* Currently, all buffers are available for use. */
+					vListInsertEnd( &( xSlabClasses[ uxClass ].xFreeList ), &( xNetworkBuffers[ uxIndex ].xBufferListItem ) );
+				}
+
+				uxFirst += xSlabClasses[ uxClass ].uxCount;
+			}
+
+			uxFreeNetworkBuffers = ( UBaseType_t ) ipconfigNUM_NETWORK_BUFFER_DESCRIPTORS;
+			uxMinimumFreeNetworkBuffers = ( UBaseType_t ) ipconfigNUM_NETWORK_BUFFER_DESCRIPTORS;
+		}
+	}
+
+	if( xNetworkBufferReleased == NULL )
+	{
+		xReturn = pdFAIL;
+	}
+	else
+	{
+		xReturn = pdPASS;
+	}
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+static BufferSlabClass_t *prvGetClass( const NetworkBufferDescriptor_t *pxNetworkBuffer )
+{
+BufferSlabClass_t *pxReturn = NULL;
+UBaseType_t uxIndex, uxClass;
+size_t uxOffset;
+
+	uxOffset = ( size_t ) ( ( ( const uint8_t * ) pxNetworkBuffer ) - ( ( const uint8_t * ) xNetworkBuffers ) );
+
+	if( ( pxNetworkBuffer >= xNetworkBuffers ) &&
+		( uxOffset < sizeof( xNetworkBuffers ) ) &&
+		( ( uxOffset % sizeof( xNetworkBuffers[ 0 ] ) ) == 0u ) )
+	{
+		uxIndex = ( UBaseType_t ) ( pxNetworkBuffer - xNetworkBuffers );
+
+		for( uxClass = 0u; uxClass < ( UBaseType_t ) baNUMBER_OF_CLASSES; uxClass++ )
+		{
+			if( uxIndex < ( xSlabClasses[ uxClass ].uxFirst + xSlabClasses[ uxClass ].uxCount ) )
+			{
+				pxReturn = &( xSlabClasses[ uxClass ] );
+				break;
+			}
+		}
+	}
+
+	return pxReturn;
+}
+/*-----------------------------------------------------------*/
+
+static UBaseType_t prvSizeToClass( size_t xRequestedSizeBytes )
+{
+UBaseType_t uxClass;
+
+	for( uxClass = 0u; uxClass < ( UBaseType_t ) baNUMBER_OF_CLASSES; uxClass++ )
+	{
+		if( xRequestedSizeBytes <= xSlabClasses[ uxClass ].uxBufferSize )
+		{
+			break;
+		}
+	}
+
+	return uxClass;
+}
+/*-----------------------------------------------------------*/
+
+static NetworkBufferDescriptor_t *prvTakeBuffer( UBaseType_t uxClass, size_t xRequestedSizeBytes )
+{
+NetworkBufferDescriptor_t *pxReturn = NULL;
+
+	/* When the class is exhausted, a bigger buffer is better than none. */
+	for( ; uxClass < ( UBaseType_t ) baNUMBER_OF_CLASSES; uxClass++ )
+	{
+		if( listLIST_IS_EMPTY( &( xSlabClasses[ uxClass ].xFreeList ) ) == pdFALSE )
+		{
+			pxReturn = ( NetworkBufferDescriptor_t * ) listGET_OWNER_OF_HEAD_ENTRY( &( xSlabClasses[ uxClass ].xFreeList ) );
+			uxListRemove( &( pxReturn->xBufferListItem ) );
+
+			uxFreeNetworkBuffers--;
+			if( uxMinimumFreeNetworkBuffers > uxFreeNetworkBuffers )
+			{
+				uxMinimumFreeNetworkBuffers = uxFreeNetworkBuffers;
+			}
+
+			pxReturn->xDataLength = xRequestedSizeBytes;
+
+			#if( ipconfigUSE_LINKED_RX_MESSAGES != 0 )
+			{
+				/* make sure the buffer is not linked */
+				pxReturn->pxNextBuffer = NULL;
+			}
+			#endif /* ipconfigUSE_LINKED_RX_MESSAGES */
+
+			break;
+		}
+	}
+
+	return pxReturn;
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvPutBuffer( NetworkBufferDescriptor_t * const pxNetworkBuffer )
+{
+BufferSlabClass_t *pxClass = prvGetClass( pxNetworkBuffer );
+BaseType_t xReturn = pdFALSE;
+
+	if( ( pxClass != NULL ) &&
+		( listIS_CONTAINED_WITHIN( &( pxClass->xFreeList ), &( pxNetworkBuffer->xBufferListItem ) ) == pdFALSE ) )
+	{
+		vListInsertEnd( &( pxClass->xFreeList ), &( pxNetworkBuffer->xBufferListItem ) );
+		uxFreeNetworkBuffers++;
+		xReturn = pdTRUE;
+	}
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+uint8_t *pucGetNetworkBuffer( size_t *pxRequestedSizeBytes )
+{
+NetworkBufferDescriptor_t *pxNetworkBuffer;
+uint8_t *pucEthernetBuffer = NULL;
+
+	/* The buffer comes with a descriptor, which is found back through the
+	pointer stored in front of the buffer when it is released. */
+	pxNetworkBuffer = pxGetNetworkBufferWithDescriptor( *pxRequestedSizeBytes, ( TickType_t ) 0 );
+
+	if( pxNetworkBuffer != NULL )
+	{
+		*pxRequestedSizeBytes = prvGetClass( pxNetworkBuffer )->uxBufferSize;
+		pucEthernetBuffer = pxNetworkBuffer->pucEthernetBuffer;
+	}
+
+	return pucEthernetBuffer;
+}
+/*-----------------------------------------------------------*/
+
+void vReleaseNetworkBuffer( uint8_t *pucEthernetBuffer )
+{
+	if( pucEthernetBuffer != NULL )
+	{
+		vReleaseNetworkBufferAndDescriptor( *( ( NetworkBufferDescriptor_t ** ) ( pucEthernetBuffer - ipBUFFER_PADDING ) ) );
+	}
+}
+/*-----------------------------------------------------------*/
+
+NetworkBufferDescriptor_t *pxGetNetworkBufferWithDescriptor( size_t xRequestedSizeBytes, TickType_t xBlockTimeTicks )
+{
+NetworkBufferDescriptor_t *pxReturn = NULL;
+UBaseType_t uxClass;
+TimeOut_t xTimeOut;
+BaseType_t xWait;
+
+	/* ARP packets can replace application packets, so the storage must be at
+	least large enough to hold an ARP.  A request for zero bytes also gets the
+	smallest buffer. */
+	uxClass = prvSizeToClass( xRequestedSizeBytes );
+
+	if( ( xNetworkBufferReleased != NULL ) && ( uxClass < ( UBaseType_t ) baNUMBER_OF_CLASSES ) )
+	{
+		vTaskSetTimeOutState( &xTimeOut );
+
+		for( ;; )
+		{
+			xWait = pdFALSE;
+
+			ipconfigBUFFER_ALLOC_LOCK();
+			{
+				pxReturn = prvTakeBuffer( uxClass, xRequestedSizeBytes );
+
+				if( ( pxReturn == NULL ) && ( xBlockTimeTicks != ( TickType_t ) 0 ) )
+				{
+					uxWaitingTasks++;
+					xWait = pdTRUE;
+				}
+			}
+			ipconfigBUFFER_ALLOC_UNLOCK();
+
+			if( xWait == pdFALSE )
+			{
+				break;
+			}
+
+			/* Wait until some buffer is released, then try again. */
+			( void ) xSemaphoreTake( xNetworkBufferReleased, xBlockTimeTicks );
+
+			ipconfigBUFFER_ALLOC_LOCK();
+			{
+				uxWaitingTasks--;
+			}
+			ipconfigBUFFER_ALLOC_UNLOCK();
+
+			if( xTaskCheckForTimeOut( &xTimeOut, &xBlockTimeTicks ) != pdFALSE )
+			{
+				/* Try one last time without waiting. */
+				xBlockTimeTicks = ( TickType_t ) 0;
+			}
+		}
+	}
+
+	if( pxReturn == NULL )
+	{
+		iptraceFAILED_TO_OBTAIN_NETWORK_BUFFER();
+	}
+	else
+	{
+		iptraceNETWORK_BUFFER_OBTAINED( pxReturn );
+	}
+
+	return pxReturn;
+}
+/*-----------------------------------------------------------*/
+
+NetworkBufferDescriptor_t *pxNetworkBufferGetFromISR( size_t xRequestedSizeBytes )
+{
+NetworkBufferDescriptor_t *pxReturn = NULL;
+UBaseType_t uxClass = prvSizeToClass( xRequestedSizeBytes );
+
+	if( uxClass < ( UBaseType_t ) baNUMBER_OF_CLASSES )
+	{
+		ipconfigBUFFER_ALLOC_LOCK_FROM_ISR();
+		{
+			/* Only take a buffer if there are at least
+			baINTERRUPT_BUFFER_GET_THRESHOLD buffers remaining, so a rapidly
+			executing interrupt can not exhaust the pool. */
+			if( uxFreeNetworkBuffers > ( UBaseType_t ) baINTERRUPT_BUFFER_GET_THRESHOLD )
+			{
+				pxReturn = prvTakeBuffer( uxClass, xRequestedSizeBytes );
+			}
+		}
+		ipconfigBUFFER_ALLOC_UNLOCK_FROM_ISR();
+	}
+
+	if( pxReturn == NULL )
+	{
+		iptraceFAILED_TO_OBTAIN_NETWORK_BUFFER_FROM_ISR();
+	}
+	else
+	{
+		iptraceNETWORK_BUFFER_OBTAINED_FROM_ISR( pxReturn );
+	}
+
+	return pxReturn;
+}
+/*-----------------------------------------------------------*/
+
+UBaseType_t uxGetNetworkBuffersWithDescriptor( NetworkBufferDescriptor_t **ppxBuffers, UBaseType_t uxCount,
+	size_t xRequestedSizeBytes )
+{
+UBaseType_t uxIndex = 0u;
+UBaseType_t uxClass = prvSizeToClass( xRequestedSizeBytes );
+
+	if( uxClass < ( UBaseType_t ) baNUMBER_OF_CLASSES )
+	{
+		ipconfigBUFFER_ALLOC_LOCK();
+		{
+			for( ; uxIndex < uxCount; uxIndex++ )
+			{
+				ppxBuffers[ uxIndex ] = prvTakeBuffer( uxClass, xRequestedSizeBytes );
+
+				if( ppxBuffers[ uxIndex ] == NULL )
+				{
+					break;
+				}
+			}
+		}
+		ipconfigBUFFER_ALLOC_UNLOCK();
+	}
+
+	if( uxIndex < uxCount )
+	{
+		iptraceFAILED_TO_OBTAIN_NETWORK_BUFFER();
+	}
+
+	return uxIndex;
+}
+/*-----------------------------------------------------------*/
+
+void vReleaseNetworkBufferAndDescriptor( NetworkBufferDescriptor_t * const pxNetworkBuffer )
+{
+BaseType_t xReleased;
+BaseType_t xWakeUp = pdFALSE;
+
+	ipconfigBUFFER_ALLOC_LOCK();
+	{
+		xReleased = prvPutBuffer( pxNetworkBuffer );
+
+		if( ( xReleased != pdFALSE ) && ( uxWaitingTasks > 0u ) )
+		{
+			xWakeUp = pdTRUE;
+		}
+	}
+	ipconfigBUFFER_ALLOC_UNLOCK();
+
+	if( xReleased == pdFALSE )
+	{
+		FreeRTOS_debug_printf( ( "vReleaseNetworkBufferAndDescriptor: %p invalid or already released\n", pxNetworkBuffer ) );
+	}
+
+	if( xWakeUp != pdFALSE )
+	{
+		( void ) xSemaphoreGive( xNetworkBufferReleased );
+	}
+
+	iptraceNETWORK_BUFFER_RELEASED( pxNetworkBuffer );
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t vNetworkBufferReleaseFromISR( NetworkBufferDescriptor_t * const pxNetworkBuffer )
+{
+BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+BaseType_t xWakeUp = pdFALSE;
+
+	ipconfigBUFFER_ALLOC_LOCK_FROM_ISR();
+	{
+		if( ( prvPutBuffer( pxNetworkBuffer ) != pdFALSE ) && ( uxWaitingTasks > 0u ) )
+		{
+			xWakeUp = pdTRUE;
+		}
+	}
+	ipconfigBUFFER_ALLOC_UNLOCK_FROM_ISR();
+
+	if( xWakeUp != pdFALSE )
+	{
+		( void ) xSemaphoreGiveFromISR( xNetworkBufferReleased, &xHigherPriorityTaskWoken );
+	}
+
+	iptraceNETWORK_BUFFER_RELEASED( pxNetworkBuffer );
+
+	return xHigherPriorityTaskWoken;
+}
+/*-----------------------------------------------------------*/
+
+void vReleaseNetworkBuffersAndDescriptors( NetworkBufferDescriptor_t * const *ppxBuffers, UBaseType_t uxCount )
+{
+UBaseType_t uxIndex, uxWakeUp = 0u;
+
+	ipconfigBUFFER_ALLOC_LOCK();
+	{
+		for( uxIndex = 0u; uxIndex < uxCount; uxIndex++ )
+		{
+			if( ( ppxBuffers[ uxIndex ] != NULL ) && ( prvPutBuffer( ppxBuffers[ uxIndex ] ) != pdFALSE ) )
+			{
+				uxWakeUp++;
+			}
+		}
+
+		/* No need to wake up more tasks than are waiting. */
+		if( uxWakeUp > uxWaitingTasks )
+		{
+			uxWakeUp = uxWaitingTasks;
+		}
+	}
+	ipconfigBUFFER_ALLOC_UNLOCK();
+
+	while( uxWakeUp > 0u )
+	{
+		( void ) xSemaphoreGive( xNetworkBufferReleased );
+		uxWakeUp--;
+	}
+
+	for( uxIndex = 0u; uxIndex < uxCount; uxIndex++ )
+	{
+		if( ppxBuffers[ uxIndex ] != NULL )
+		{
+			iptraceNETWORK_BUFFER_RELEASED( ppxBuffers[ uxIndex ] );
+		}
+	}
+}
+/*-----------------------------------------------------------*/
+
+void vNetworkBufferRecycle( NetworkBufferDescriptor_t * const pxNetworkBuffer )
+{
+BufferSlabClass_t *pxClass = prvGetClass( pxNetworkBuffer );
+
+	configASSERT( pxClass != NULL );
+
+	if( pxClass != NULL )
+	{
+		/* The buffer stays with its owner, only reset what the IP-stack may
+		have changed. */
+		pxNetworkBuffer->xDataLength = pxClass->uxBufferSize;
+
+		#if( ipconfigUSE_LINKED_RX_MESSAGES != 0 )
+		{
+			pxNetworkBuffer->pxNextBuffer = NULL;
+		}
+		#endif /* ipconfigUSE_LINKED_RX_MESSAGES */
+	}
+}
+/*-----------------------------------------------------------*/
+
+UBaseType_t uxGetNumberOfFreeNetworkBuffers( void )
+{
+	return uxFreeNetworkBuffers;
+}
+/*-----------------------------------------------------------*/
+
+UBaseType_t uxGetMinimumFreeNetworkBuffers( void )
+{
+	return uxMinimumFreeNetworkBuffers;
+}
+/*-----------------------------------------------------------*/
+
+NetworkBufferDescriptor_t *pxResizeNetworkBufferWithDescriptor( NetworkBufferDescriptor_t * pxNetworkBuffer, size_t xNewSizeBytes )
+{
+NetworkBufferDescriptor_t *pxReturn = pxNetworkBuffer;
+BufferSlabClass_t *pxClass = prvGetClass( pxNetworkBuffer );
+size_t uxCopyLength;
+
+	if( ( pxClass == NULL ) || ( xNewSizeBytes > pxClass->uxBufferSize ) )
+	{
+		/* A buffer can not grow, the data is moved to a buffer of a larger
+		class, which comes with a different descriptor. */
+		pxReturn = pxGetNetworkBufferWithDescriptor( xNewSizeBytes, ( TickType_t ) 0 );
+
+		if( pxReturn != NULL )
+		{
+			uxCopyLength = FreeRTOS_min_uint32( ( uint32_t ) pxNetworkBuffer->xDataLength, ( uint32_t ) xNewSizeBytes );
+			memcpy( pxReturn->pucEthernetBuffer, pxNetworkBuffer->pucEthernetBuffer, uxCopyLength );
+			pxReturn->ulIPAddress = pxNetworkBuffer->ulIPAddress;
+			pxReturn->usPort = pxNetworkBuffer->usPort;
+			pxReturn->usBoundPort = pxNetworkBuffer->usBoundPort;
+			vReleaseNetworkBufferAndDescriptor( pxNetworkBuffer );
+		}
+	}
+	else
+	{
+		pxReturn->xDataLength = xNewSizeBytes;
+	}
+
+	return pxReturn;
+}
+/*-----------------------------------------------------------*/
+
+#endif /* ipconfigBUFFER_ALLOCATION_SLABS */
@@ -0,0 +1,91 @@
+/*
+ * FreeRTOS+TCP V2.0.8
+ * Copyright (C) 2017 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/*
+ * ullChecksumSumWords() for Cortex-M3, M4 and M7, built with GCC.  Set
+ * ipconfigPORT_CHECKSUM_SUM_WORDS to 1 in FreeRTOSIPConfig.h when adding this
+ * file to a project.
+ *
+ * The words are summed with a chain of ADCS instructions, the carry of each
+ * addition is added back in by the next one, so no carries need to be counted.
+ * The 32-bit result with an end-around carry is congruent to the full sum
+ * modulo 0xFFFF, which is all that matters for the Internet checksum.
+ */
+
+/* Standard includes. */
+#include <stdint.h>
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+
+/* FreeRTOS+TCP includes. */
+#include "FreeRTOS_IP.h"
+#include "FreeRTOS_IP_Private.h"
+
+#if( ipconfigPORT_CHECKSUM_SUM_WORDS == 0 )
+	#error Set ipconfigPORT_CHECKSUM_SUM_WORDS to 1 when using this file
+#endif
+
+uint64_t ullChecksumSumWords( uint64_t ullSum, const uint32_t *pulWords, size_t uxWordCount )
+{
+uint32_t ulSum = 0ul;
+uint32_t ulWord0, ulWord1, ulWord2, ulWord3;
+
+	while( uxWordCount >= 4u )
+	{
+		/* The compiler is free to combine these loads into LDM or LDRD. */
+		ulWord0 = pulWords[ 0 ];
+		ulWord1 = pulWords[ 1 ];
+		ulWord2 = pulWords[ 2 ];
+		ulWord3 = pulWords[ 3 ];
+
+		__asm volatile
+		(
+			"	adds	%[sum], %[sum], %[w0]	\n"
+			"	adcs	%[sum], %[sum], %[w1]	\n"
+			"	adcs	%[sum], %[sum], %[w2]	\n"
+			"	adcs	%[sum], %[sum], %[w3]	\n"
+			"	adc		%[sum], %[sum], #0		\n"
+			: [sum] "+r" ( ulSum )
+			: [w0] "r" ( ulWord0 ), [w1] "r" ( ulWord1 ), [w2] "r" ( ulWord2 ), [w3] "r" ( ulWord3 )
+			: "cc"
+		);
+
+		pulWords += 4;
+		uxWordCount -= 4u;
+	}
+
+	while( uxWordCount > 0u )
+	{
+		ullSum += pulWords[ 0 ];
+		pulWords++;
+		uxWordCount--;
+	}
+
+	return ullSum + ulSum;
+}
+/*-----------------------------------------------------------*/
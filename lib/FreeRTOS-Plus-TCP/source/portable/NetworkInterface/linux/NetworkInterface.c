@@ -0,0 +1,902 @@
+/*
+FreeRTOS+TCP V2.0.8
+Copyright (C) 2017 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so,
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+ http://aws.amazon.com/freertos
+ http://www.FreeRTOS.org
+*/
+
+/*
+ * A network interface for running FreeRTOS+TCP as a process on a Linux host.
+ * Frames are exchanged through one of the following back-ends, selected with
+ * configLINUX_NETWORK_BACKEND in FreeRTOSConfig.h:
+ *
+ * niLINUX_BACKEND_TAP      - a TAP device, e.g. "tap0", which can be bridged
+ *                            to a real network by the host.
+ * niLINUX_BACKEND_PACKET   - an AF_PACKET raw socket bound to an existing
+ *                            interface, e.g. "eth0" (needs CAP_NET_RAW).
+ * niLINUX_BACKEND_WIRE     - an in-memory "wire" between two processes, each
+ *                            running one instance of the stack.  Frames are
+ *                            passed as AF_UNIX datagrams and never touch a
+ *                            real network, which makes throughput measurements
+ *                            repeatable.
+ * niLINUX_BACKEND_LOOPBACK - frames sent to the own MAC address are returned
+ *                            to the stack, all other frames are dropped.
+ *
+ * When configLINUX_PCAP_CAPTURE_FILE is defined as a file name, all frames
+ * sent and received are written to that file in pcap format.
+ *
+ * Tests can call vLinuxNetworkDropFrames() to lose frames on purpose,
+ * vLinuxNetworkLoopBroadcasts() to let the loopback back-end also return
+ * broadcast frames, e.g. for a DHCP server that runs on the stack itself, and
+ * vLinuxNetworkHoldFrames() to pass a burst of received frames on at once.
+ */
+
+/* Standard includes. */
+#include <stdio.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <signal.h>
+#include <pthread.h>
+#include <sys/ioctl.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include <net/if.h>
+#include <arpa/inet.h>
+#include <linux/if_tun.h>
+#include <linux/if_packet.h>
+#include <linux/if_ether.h>
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+
+/* FreeRTOS+TCP includes. */
+#include "FreeRTOS_IP.h"
+#include "FreeRTOS_IP_Private.h"
+#include "NetworkBufferManagement.h"
+
+/* Thread-safe circular buffers are being used to pass data to and from the
+Linux threads that access the network: a stream buffer for the frames to
+send, and a ring of frame sized slots, into which the frames are received in
+place, for the frames received. */
+#include "FreeRTOS_Stream_Buffer.h"
+#include "aws_spsc_ring.h"
+
+/* The back-ends that can be selected with configLINUX_NETWORK_BACKEND. */
+#define niLINUX_BACKEND_TAP			0
+#define niLINUX_BACKEND_PACKET		1
+#define niLINUX_BACKEND_WIRE		2
+#define niLINUX_BACKEND_LOOPBACK	3
+
+#ifndef configLINUX_NETWORK_BACKEND
+	#define configLINUX_NETWORK_BACKEND			niLINUX_BACKEND_TAP
+#endif
+
+/* The name of the TAP device or of the interface to bind to.  For the wire
+back-end, both processes must use the same name. */
+#ifndef configLINUX_NETWORK_INTERFACE_NAME
+	#define configLINUX_NETWORK_INTERFACE_NAME	"tap0"
+#endif
+
+/* For the wire back-end: one process uses side 0, the other side 1. */
+#ifndef configLINUX_NETWORK_WIRE_SIDE
+	#define configLINUX_NETWORK_WIRE_SIDE		0
+#endif
+
+#ifndef configMAC_ISR_SIMULATOR_PRIORITY
+	#define configMAC_ISR_SIMULATOR_PRIORITY	( configMAX_PRIORITIES - 1 )
+#endif
+
+#ifndef configLINUX_MAC_INTERRUPT_SIMULATOR_DELAY
+	#define configLINUX_MAC_INTERRUPT_SIMULATOR_DELAY	( ( TickType_t ) 1 )
+#endif
+
+/* The maximum number of frames that are passed to the IP-task in a single
+event, when ipconfigUSE_LINKED_RX_MESSAGES is enabled. */
+#ifndef niRX_BATCH_SIZE
+	#define niRX_BATCH_SIZE		16
+#endif
+
+/* When non-zero, the number of frames per second passed to the IP-task and
+the average number of frames per event are printed with this period.  Compare
+the figures with ipconfigUSE_LINKED_RX_MESSAGES set to 0 and to 1 to measure
+the effect of batching. */
+#ifndef configLINUX_NETWORK_STATS_PERIOD_MS
+	#define configLINUX_NETWORK_STATS_PERIOD_MS	0
+#endif
+
+/* Sizes of the thread safe circular buffers used to pass data to and from the
+Linux threads.  The number of receive slots must be a power of two. */
+#define niSEND_BUFFER_SIZE	65536
+#define niRECV_RING_SLOTS	64
+
+/* The largest frame that is exchanged with the host. */
+#define niMAX_FRAME_SIZE	( ipconfigNETWORK_MTU + ipSIZE_OF_ETH_HEADER )
+
+/* If ipconfigETHERNET_DRIVER_FILTERS_FRAME_TYPES is set to 1, then the Ethernet
+driver will filter incoming packets and only pass the stack those packets it
+considers need processing. */
+#if( ipconfigETHERNET_DRIVER_FILTERS_FRAME_TYPES == 0 )
+	#define ipCONSIDER_FRAME_FOR_PROCESSING( pucEthernetBuffer ) eProcessBuffer
+#else
+	#define ipCONSIDER_FRAME_FOR_PROCESSING( pucEthernetBuffer ) eConsiderFrameForProcessing( ( pucEthernetBuffer ) )
+#endif
+
+/*-----------------------------------------------------------*/
+
+/* A slot of the receive ring.  The frame is read into ucFrame, which is large
+enough to tell frames that are too long from frames that fit. */
+typedef struct xRECV_SLOT
+{
+	size_t xLength;
+	uint8_t ucFrame[ ipTOTAL_ETHERNET_FRAME_SIZE ];
+} RecvSlot_t;
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Linux threads that are outside of the control of the FreeRTOS scheduler are
+ * used to read from and write to the host network.
+ */
+static void *prvLinuxRecvThread( void *pvParam );
+static void *prvLinuxSendThread( void *pvParam );
+
+/*
+ * Open the back-end selected by configLINUX_NETWORK_BACKEND, returns a file
+ * descriptor, or -1 in case of an error.
+ */
+static int prvOpenBackend( void );
+
+/*
+ * Create the buffers that are used to pass data between the FreeRTOS tasks and
+ * the Linux threads.
+ */
+static void prvCreateThreadSafeBuffers( void );
+
+/*
+ * Start a Linux thread with all signals blocked, so it won't interfere with
+ * the signals used by the FreeRTOS port.
+ */
+static void prvStartLinuxThread( void *( *pxFunction )( void * ) );
+
+/*
+ * Add a frame to the receive ring that is read by the interrupt simulator.
+ */
+static void prvPassFrameToStack( const uint8_t *pucFrame, size_t xLength );
+
+/*
+ * Check the length of a received frame.
+ */
+static BaseType_t prvIsValidFrameLength( size_t xLength );
+
+/*
+ * A function that simulates Ethernet interrupts by checking the circular
+ * buffer for new frames, and passing them to the IP-task.
+ */
+static void prvInterruptSimulatorTask( void *pvParameters );
+
+#ifdef configLINUX_PCAP_CAPTURE_FILE
+	/*
+	 * Write a frame to the pcap capture file, called from both Linux threads.
+	 */
+	static void prvCaptureFrame( const uint8_t *pucFrame, size_t xLength );
+#endif
+
+#if( configLINUX_NETWORK_STATS_PERIOD_MS > 0 )
+	/*
+	 * Count the frames and events passed to the IP-task, and print the rates
+	 * once every configLINUX_NETWORK_STATS_PERIOD_MS.
+	 */
+	static void prvUpdateRxStatistics( BaseType_t xFrames, BaseType_t xEvents );
+#endif
+
+/*-----------------------------------------------------------*/
+
+/* The file descriptor of the TAP device or socket. */
+static int iNetworkFd = -1;
+
+/* Used to wake up the Linux thread that sends data. */
+static pthread_mutex_t xSendMutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t xSendCondition = PTHREAD_COND_INITIALIZER;
+
+/* Circular buffers used by the Linux threads.  The receive ring has a single
+producer, the thread that receives, or in the loopback back-end the thread
+that sends, and a single consumer, the interrupt simulator.  As the producer
+can not call FreeRTOS functions, the ring has no consumer task to notify and
+the interrupt simulator polls it. */
+static StreamBuffer_t *xSendBuffer = NULL;
+static SPSCRing_t xRecvRing;
+static RecvSlot_t xRecvSlots[ niRECV_RING_SLOTS ];
+
+#if( configLINUX_NETWORK_BACKEND == niLINUX_BACKEND_WIRE )
+	/* The address of the process at the other end of the wire. */
+	static struct sockaddr_un xWirePeerAddress;
+	static socklen_t xWirePeerAddressLength;
+#endif
+
+#ifdef configLINUX_PCAP_CAPTURE_FILE
+	static FILE *pxCaptureFile = NULL;
+	static pthread_mutex_t xCaptureMutex = PTHREAD_MUTEX_INITIALIZER;
+#endif
+
+/* Logs the number of failures, for viewing in the debugger only. */
+static volatile uint32_t ulLinuxSendFailures = 0;
+static volatile uint32_t ulLinuxRecvDropped = 0;
+
+/* The number of frames still to be dropped by the Linux thread that sends, see
+vLinuxNetworkDropFrames(). */
+static uint32_t ulLinuxFramesToDrop = 0;
+
+/* Non-zero when the loopback back-end also returns broadcast frames, see
+vLinuxNetworkLoopBroadcasts(). */
+static uint32_t ulLinuxLoopBroadcasts = 0;
+
+/* Non-zero while the received frames are left in the receive ring, see
+vLinuxNetworkHoldFrames(). */
+static uint32_t ulLinuxHoldFrames = 0;
+
+/*-----------------------------------------------------------*/
+
+BaseType_t xNetworkInterfaceInitialise( void )
+{
+static BaseType_t xThreadsStarted = pdFALSE;
+BaseType_t xReturn = pdFALSE;
+
+	if( ( iNetworkFd < 0 ) && ( configLINUX_NETWORK_BACKEND != niLINUX_BACKEND_LOOPBACK ) )
+	{
+		iNetworkFd = prvOpenBackend();
+	}
+
+	if( ( iNetworkFd >= 0 ) || ( configLINUX_NETWORK_BACKEND == niLINUX_BACKEND_LOOPBACK ) )
+	{
+		if( xThreadsStarted == pdFALSE )
+		{
+			xThreadsStarted = pdTRUE;
+			prvCreateThreadSafeBuffers();
+
+			#ifdef configLINUX_PCAP_CAPTURE_FILE
+			{
+			/* The pcap global header: magic, version 2.4, time zone, accuracy,
+			snap length, and link type Ethernet. */
+			const uint32_t ulHeader[ 6 ] = { 0xa1b2c3d4UL, 0x00040002UL, 0UL, 0UL, 65535UL, 1UL };
+
+				pxCaptureFile = fopen( configLINUX_PCAP_CAPTURE_FILE, "wb" );
+
+				if( pxCaptureFile != NULL )
+				{
+					fwrite( ulHeader, sizeof( ulHeader ), 1, pxCaptureFile );
+				}
+			}
+			#endif
+
+			if( configLINUX_NETWORK_BACKEND != niLINUX_BACKEND_LOOPBACK )
+			{
+				prvStartLinuxThread( prvLinuxRecvThread );
+			}
+
+			prvStartLinuxThread( prvLinuxSendThread );
+
+			/* Create a task that simulates an interrupt in a real system.  This
+			will wait for packets, then send a message to the IP task when data
+			is available. */
+			xTaskCreate( prvInterruptSimulatorTask, "MAC_ISR", configMINIMAL_STACK_SIZE, NULL, configMAC_ISR_SIMULATOR_PRIORITY, NULL );
+		}
+
+		xReturn = pdPASS;
+	}
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+static int prvOpenBackend( void )
+{
+int iFd;
+
+	#if( configLINUX_NETWORK_BACKEND == niLINUX_BACKEND_TAP )
+	{
+	struct ifreq xRequest;
+
+		iFd = open( "/dev/net/tun", O_RDWR );
+
+		if( iFd >= 0 )
+		{
+			memset( &xRequest, '\0', sizeof( xRequest ) );
+
+			/* A TAP device exchanges Ethernet frames, without an extra header. */
+			xRequest.ifr_flags = IFF_TAP | IFF_NO_PI;
+			strncpy( xRequest.ifr_name, configLINUX_NETWORK_INTERFACE_NAME, IFNAMSIZ - 1 );
+
+			if( ioctl( iFd, TUNSETIFF, ( void * ) &xRequest ) < 0 )
+			{
+				close( iFd );
+				iFd = -1;
+			}
+		}
+	}
+	#elif( configLINUX_NETWORK_BACKEND == niLINUX_BACKEND_PACKET )
+	{
+	struct sockaddr_ll xAddress;
+	struct packet_mreq xMembership;
+
+		iFd = socket( AF_PACKET, SOCK_RAW, htons( ETH_P_ALL ) );
+
+		if( iFd >= 0 )
+		{
+			memset( &xAddress, '\0', sizeof( xAddress ) );
+			xAddress.sll_family = AF_PACKET;
+			xAddress.sll_protocol = htons( ETH_P_ALL );
+			xAddress.sll_ifindex = ( int ) if_nametoindex( configLINUX_NETWORK_INTERFACE_NAME );
+
+			/* Open in promiscuous mode as the MAC and IP address of the stack
+			are not the ones of the host. */
+			memset( &xMembership, '\0', sizeof( xMembership ) );
+			xMembership.mr_ifindex = xAddress.sll_ifindex;
+			xMembership.mr_type = PACKET_MR_PROMISC;
+
+			if( ( xAddress.sll_ifindex == 0 ) ||
+				( bind( iFd, ( struct sockaddr * ) &xAddress, sizeof( xAddress ) ) < 0 ) ||
+				( setsockopt( iFd, SOL_PACKET, PACKET_ADD_MEMBERSHIP, &xMembership, sizeof( xMembership ) ) < 0 ) )
+			{
+				close( iFd );
+				iFd = -1;
+			}
+		}
+	}
+	#elif( configLINUX_NETWORK_BACKEND == niLINUX_BACKEND_WIRE )
+	{
+	struct sockaddr_un xAddress;
+	socklen_t xLength;
+
+		iFd = socket( AF_UNIX, SOCK_DGRAM, 0 );
+
+		if( iFd >= 0 )
+		{
+			/* Both ends use an address in the abstract name space, so nothing
+			is left behind in the file system. */
+			memset( &xAddress, '\0', sizeof( xAddress ) );
+			xAddress.sun_family = AF_UNIX;
+			xLength = ( socklen_t ) ( offsetof( struct sockaddr_un, sun_path ) + 1u +
+				( size_t ) snprintf( xAddress.sun_path + 1, sizeof( xAddress.sun_path ) - 1u, "freertos-wire-%s-%d",
+				configLINUX_NETWORK_INTERFACE_NAME, configLINUX_NETWORK_WIRE_SIDE ) );
+
+			memset( &xWirePeerAddress, '\0', sizeof( xWirePeerAddress ) );
+			xWirePeerAddress.sun_family = AF_UNIX;
+			xWirePeerAddressLength = ( socklen_t ) ( offsetof( struct sockaddr_un, sun_path ) + 1u +
+				( size_t ) snprintf( xWirePeerAddress.sun_path + 1, sizeof( xWirePeerAddress.sun_path ) - 1u, "freertos-wire-%s-%d",
+				configLINUX_NETWORK_INTERFACE_NAME, 1 - configLINUX_NETWORK_WIRE_SIDE ) );
+
+			if( bind( iFd, ( struct sockaddr * ) &xAddress, xLength ) < 0 )
+			{
+				close( iFd );
+				iFd = -1;
+			}
+		}
+	}
+	#else
+	{
+		iFd = -1;
+	}
+	#endif
+
+	if( iFd < 0 )
+	{
+		FreeRTOS_printf( ( "xNetworkInterfaceInitialise: can not open '%s': %s\n", configLINUX_NETWORK_INTERFACE_NAME, strerror( errno ) ) );
+	}
+
+	return iFd;
+}
+/*-----------------------------------------------------------*/
+
+static void prvCreateThreadSafeBuffers( void )
+{
+	/* The buffer used to pass data to be transmitted from a FreeRTOS task to
+	the Linux thread that sends it. */
+	if( xSendBuffer == NULL )
+	{
+		xSendBuffer = ( StreamBuffer_t * ) malloc( sizeof( *xSendBuffer ) - sizeof( xSendBuffer->ucArray ) + niSEND_BUFFER_SIZE + 1 );
+		configASSERT( xSendBuffer );
+		memset( xSendBuffer, '\0', sizeof( *xSendBuffer ) - sizeof( xSendBuffer->ucArray ) );
+		xSendBuffer->LENGTH = niSEND_BUFFER_SIZE + 1;
+	}
+
+	/* The ring used to pass received frames from the Linux thread that
+	receives them to the FreeRTOS task.  This is only called once, before the
+	threads are started. */
+	SPSCRING_Init( &xRecvRing, xRecvSlots, sizeof( xRecvSlots[ 0 ] ), niRECV_RING_SLOTS );
+}
+/*-----------------------------------------------------------*/
+
+static void prvStartLinuxThread( void *( *pxFunction )( void * ) )
+{
+pthread_t xThread;
+sigset_t xAllSignals, xOldSignals;
+
+	/* The new thread inherits the signal mask of the calling thread. */
+	sigfillset( &xAllSignals );
+	pthread_sigmask( SIG_SETMASK, &xAllSignals, &xOldSignals );
+
+	if( pthread_create( &xThread, NULL, pxFunction, NULL ) == 0 )
+	{
+		pthread_detach( xThread );
+	}
+	else
+	{
+		configASSERT( 0 );
+	}
+
+	pthread_sigmask( SIG_SETMASK, &xOldSignals, NULL );
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xNetworkInterfaceOutput( NetworkBufferDescriptor_t * const pxNetworkBuffer, BaseType_t bReleaseAfterSend )
+{
+size_t xSpace;
+
+	iptraceNETWORK_INTERFACE_TRANSMIT();
+	configASSERT( xIsCallingFromIPTask() == pdTRUE );
+
+	/* Both the length of the data being sent and the actual data being sent
+	are placed in the thread safe buffer used to pass data between the FreeRTOS
+	tasks and the Linux thread that sends data.  Drop the packet if there is
+	insufficient space in the buffer to hold both. */
+	xSpace = uxStreamBufferGetSpace( xSendBuffer );
+
+	if( ( pxNetworkBuffer->xDataLength <= niMAX_FRAME_SIZE ) &&
+		( xSpace >= ( pxNetworkBuffer->xDataLength + sizeof( pxNetworkBuffer->xDataLength ) ) ) )
+	{
+		/* First write in the length of the data, then write in the data
+		itself. */
+		uxStreamBufferAdd( xSendBuffer, 0, ( const uint8_t * ) &( pxNetworkBuffer->xDataLength ), sizeof( pxNetworkBuffer->xDataLength ) );
+		uxStreamBufferAdd( xSendBuffer, 0, ( const uint8_t * ) pxNetworkBuffer->pucEthernetBuffer, pxNetworkBuffer->xDataLength );
+	}
+	else
+	{
+		FreeRTOS_debug_printf( ( "xNetworkInterfaceOutput: send buffers full to store %lu\n", ( unsigned long ) pxNetworkBuffer->xDataLength ) );
+	}
+
+	/* Kick the Tx thread in either case in case it doesn't know the buffer is
+	full. */
+	pthread_mutex_lock( &xSendMutex );
+	pthread_cond_signal( &xSendCondition );
+	pthread_mutex_unlock( &xSendMutex );
+
+	/* The buffer has been sent so can be released. */
+	if( bReleaseAfterSend != pdFALSE )
+	{
+		vReleaseNetworkBufferAndDescriptor( pxNetworkBuffer );
+	}
+
+	return pdPASS;
+}
+/*-----------------------------------------------------------*/
+
+void vLinuxNetworkDropFrames( uint32_t ulCount )
+{
+	/* Frames are never lost on the loopback back-end, a test can call this
+	to drop the next 'ulCount' frames sent and provoke retransmissions. */
+	__atomic_store_n( &ulLinuxFramesToDrop, ulCount, __ATOMIC_RELAXED );
+}
+/*-----------------------------------------------------------*/
+
+void vLinuxNetworkLoopBroadcasts( uint32_t ulEnable )
+{
+	/* Broadcasts are dropped by default, otherwise the stack would see its
+	own ARP requests. */
+	__atomic_store_n( &ulLinuxLoopBroadcasts, ulEnable, __ATOMIC_RELAXED );
+}
+/*-----------------------------------------------------------*/
+
+void vLinuxNetworkHoldFrames( uint32_t ulHold )
+{
+	/* While held, received frames queue up in the receive ring.  Once
+	released, up to niRX_BATCH_SIZE of them are passed to the IP-task together,
+	as a single chain when ipconfigUSE_LINKED_RX_MESSAGES is enabled. */
+	__atomic_store_n( &ulLinuxHoldFrames, ulHold, __ATOMIC_RELAXED );
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvIsValidFrameLength( size_t xLength )
+{
+	return ( ( xLength >= sizeof( EthernetHeader_t ) ) && ( xLength <= niMAX_FRAME_SIZE ) ) ? pdTRUE : pdFALSE;
+}
+/*-----------------------------------------------------------*/
+
+static void prvPassFrameToStack( const uint8_t *pucFrame, size_t xLength )
+{
+RecvSlot_t *pxSlot = NULL;
+
+	/* THIS IS CALLED FROM A LINUX THREAD - DO NOT ATTEMPT ANY FREERTOS CALLS
+	HERE. */
+
+	if( prvIsValidFrameLength( xLength ) != pdFALSE )
+	{
+		pxSlot = ( RecvSlot_t * ) SPSCRING_AcquireWrite( &xRecvRing );
+	}
+
+	if( pxSlot != NULL )
+	{
+		memcpy( pxSlot->ucFrame, pucFrame, xLength );
+		pxSlot->xLength = xLength;
+		SPSCRING_CommitWrite( &xRecvRing );
+	}
+	else
+	{
+		ulLinuxRecvDropped++;
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void *prvLinuxRecvThread( void *pvParam )
+{
+uint8_t ucDiscard[ ipTOTAL_ETHERNET_FRAME_SIZE ];
+RecvSlot_t *pxSlot = NULL;
+uint8_t *pucFrame;
+ssize_t xLength;
+
+	/* THIS IS A LINUX THREAD - DO NOT ATTEMPT ANY FREERTOS CALLS HERE. */
+	( void ) pvParam;
+
+	for( ;; )
+	{
+		/* Frames are read straight into a slot of the receive ring.  A slot
+		that was acquired but not committed is kept for the next frame.  When
+		the ring is full the frame is still read, to be dropped. */
+		if( pxSlot == NULL )
+		{
+			pxSlot = ( RecvSlot_t * ) SPSCRING_AcquireWrite( &xRecvRing );
+		}
+
+		pucFrame = ( pxSlot != NULL ) ? pxSlot->ucFrame : ucDiscard;
+
+		/* Block until the host has a frame for us. */
+		xLength = read( iNetworkFd, pucFrame, sizeof( ucDiscard ) );
+
+		if( xLength > 0 )
+		{
+			#ifdef configLINUX_PCAP_CAPTURE_FILE
+			{
+				prvCaptureFrame( pucFrame, ( size_t ) xLength );
+			}
+			#endif
+
+			if( ( pxSlot != NULL ) && ( prvIsValidFrameLength( ( size_t ) xLength ) != pdFALSE ) )
+			{
+				pxSlot->xLength = ( size_t ) xLength;
+				SPSCRING_CommitWrite( &xRecvRing );
+				pxSlot = NULL;
+			}
+			else
+			{
+				ulLinuxRecvDropped++;
+			}
+		}
+		else if( ( xLength < 0 ) && ( errno != EINTR ) && ( errno != EAGAIN ) )
+		{
+			/* Avoid spinning on a device that went away. */
+			usleep( 1000 );
+		}
+	}
+
+	return NULL;
+}
+/*-----------------------------------------------------------*/
+
+static void *prvLinuxSendThread( void *pvParam )
+{
+size_t xLength;
+uint8_t ucBuffer[ niMAX_FRAME_SIZE ];
+struct timespec xDeadline;
+ssize_t xSent;
+uint32_t ulDrop;
+
+	/* THIS IS A LINUX THREAD - DO NOT ATTEMPT ANY FREERTOS CALLS HERE. */
+	( void ) pvParam;
+
+	for( ;; )
+	{
+		/* Wait until notified of something to send, or at most a second. */
+		pthread_mutex_lock( &xSendMutex );
+
+		if( uxStreamBufferGetSize( xSendBuffer ) <= sizeof( xLength ) )
+		{
+			clock_gettime( CLOCK_REALTIME, &xDeadline );
+			xDeadline.tv_sec += 1;
+			pthread_cond_timedwait( &xSendCondition, &xSendMutex, &xDeadline );
+		}
+
+		pthread_mutex_unlock( &xSendMutex );
+
+		/* Is there more than the length value stored in the circular buffer
+		used to pass data from the FreeRTOS tasks into this Linux thread? */
+		while( uxStreamBufferGetSize( xSendBuffer ) > sizeof( xLength ) )
+		{
+			uxStreamBufferGet( xSendBuffer, 0, ( uint8_t * ) &xLength, sizeof( xLength ), pdFALSE );
+			uxStreamBufferGet( xSendBuffer, 0, ucBuffer, xLength, pdFALSE );
+
+			/* The frame is lost on the wire when a test asked for that.  Only
+			this thread decrements the count, a new count stored in between
+			makes the exchange fail and the frame is sent. */
+			ulDrop = __atomic_load_n( &ulLinuxFramesToDrop, __ATOMIC_RELAXED );
+
+			if( ( ulDrop != 0u ) &&
+				( __atomic_compare_exchange_n( &ulLinuxFramesToDrop, &ulDrop, ulDrop - 1u, pdFALSE, __ATOMIC_RELAXED, __ATOMIC_RELAXED ) != pdFALSE ) )
+			{
+				continue;
+			}
+
+			#ifdef configLINUX_PCAP_CAPTURE_FILE
+			{
+				prvCaptureFrame( ucBuffer, xLength );
+			}
+			#endif
+
+			#if( configLINUX_NETWORK_BACKEND == niLINUX_BACKEND_LOOPBACK )
+			{
+				/* Only frames addressed to the own MAC address come back,
+				and broadcasts when a test asked for them. */
+				if( ( memcmp( ucBuffer, ipLOCAL_MAC_ADDRESS, ipMAC_ADDRESS_LENGTH_BYTES ) == 0 ) ||
+					( ( __atomic_load_n( &ulLinuxLoopBroadcasts, __ATOMIC_RELAXED ) != 0u ) &&
+					  ( memcmp( ucBuffer, xBroadcastMACAddress.ucBytes, ipMAC_ADDRESS_LENGTH_BYTES ) == 0 ) ) )
+				{
+					prvPassFrameToStack( ucBuffer, xLength );
+				}
+				xSent = ( ssize_t ) xLength;
+			}
+			#elif( configLINUX_NETWORK_BACKEND == niLINUX_BACKEND_WIRE )
+			{
+				/* The frame is lost when the other end is not running. */
+				xSent = sendto( iNetworkFd, ucBuffer, xLength, 0, ( struct sockaddr * ) &xWirePeerAddress, xWirePeerAddressLength );
+			}
+			#else
+			{
+				xSent = write( iNetworkFd, ucBuffer, xLength );
+			}
+			#endif
+
+			if( xSent != ( ssize_t ) xLength )
+			{
+				ulLinuxSendFailures++;
+			}
+		}
+	}
+
+	return NULL;
+}
+/*-----------------------------------------------------------*/
+
+#ifdef configLINUX_PCAP_CAPTURE_FILE
+
+	static void prvCaptureFrame( const uint8_t *pucFrame, size_t xLength )
+	{
+	struct timeval xNow;
+	uint32_t ulRecord[ 4 ];
+
+		if( pxCaptureFile != NULL )
+		{
+			gettimeofday( &xNow, NULL );
+
+			/* Seconds, micro-seconds, captured length, original length. */
+			ulRecord[ 0 ] = ( uint32_t ) xNow.tv_sec;
+			ulRecord[ 1 ] = ( uint32_t ) xNow.tv_usec;
+			ulRecord[ 2 ] = ( uint32_t ) xLength;
+			ulRecord[ 3 ] = ( uint32_t ) xLength;
+
+			pthread_mutex_lock( &xCaptureMutex );
+			fwrite( ulRecord, sizeof( ulRecord ), 1, pxCaptureFile );
+			fwrite( pucFrame, xLength, 1, pxCaptureFile );
+			fflush( pxCaptureFile );
+			pthread_mutex_unlock( &xCaptureMutex );
+		}
+	}
+
+#endif /* configLINUX_PCAP_CAPTURE_FILE */
+/*-----------------------------------------------------------*/
+
+static void prvInterruptSimulatorTask( void *pvParameters )
+{
+size_t xLength;
+BaseType_t xCount;
+RecvSlot_t *pxSlot;
+NetworkBufferDescriptor_t *pxNetworkBuffer;
+IPStackEvent_t xRxEvent = { eNetworkRxEvent, NULL };
+#if( ipconfigUSE_LINKED_RX_MESSAGES != 0 )
+	NetworkBufferDescriptor_t *pxFirstBuffer, *pxLastBuffer, *pxNextBuffer;
+#endif
+
+	/* Remove compiler warnings about unused parameters. */
+	( void ) pvParameters;
+
+	for( ;; )
+	{
+		xCount = 0;
+
+		if( __atomic_load_n( &ulLinuxHoldFrames, __ATOMIC_RELAXED ) != 0u )
+		{
+			/* A test holds the received frames back, see
+			vLinuxNetworkHoldFrames(). */
+			vTaskDelay( configLINUX_MAC_INTERRUPT_SIMULATOR_DELAY );
+			continue;
+		}
+
+		#if( ipconfigUSE_LINKED_RX_MESSAGES != 0 )
+		{
+			pxFirstBuffer = NULL;
+			pxLastBuffer = NULL;
+		}
+		#endif
+
+		/* Take up to niRX_BATCH_SIZE frames from the receive ring. */
+		while( xCount < niRX_BATCH_SIZE )
+		{
+			pxSlot = ( RecvSlot_t * ) SPSCRING_AcquireRead( &xRecvRing );
+
+			if( pxSlot == NULL )
+			{
+				break;
+			}
+
+			xCount++;
+			xLength = pxSlot->xLength;
+
+			iptraceNETWORK_INTERFACE_RECEIVE();
+
+			/* Obtain a buffer into which the data can be placed.  This is only
+			an interrupt simulator, not a real interrupt, so it is ok to call
+			the task level function here. */
+			pxNetworkBuffer = pxGetNetworkBufferWithDescriptor( xLength, 0 );
+
+			if( pxNetworkBuffer == NULL )
+			{
+				/* Drop the frame. */
+				SPSCRING_ReleaseRead( &xRecvRing );
+				iptraceETHERNET_RX_EVENT_LOST();
+				continue;
+			}
+
+			/* The frame is copied only once, from the slot it was received
+			into straight into the network buffer. */
+			memcpy( pxNetworkBuffer->pucEthernetBuffer, pxSlot->ucFrame, xLength );
+			SPSCRING_ReleaseRead( &xRecvRing );
+			pxNetworkBuffer->xDataLength = xLength;
+
+			if( ipCONSIDER_FRAME_FOR_PROCESSING( pxNetworkBuffer->pucEthernetBuffer ) != eProcessBuffer )
+			{
+				vReleaseNetworkBufferAndDescriptor( pxNetworkBuffer );
+				continue;
+			}
+
+			#if( ipconfigUSE_LINKED_RX_MESSAGES != 0 )
+			{
+				/* Chain the frames, they will be passed to the IP-task in a
+				single message. */
+				pxNetworkBuffer->pxNextBuffer = NULL;
+
+				if( pxFirstBuffer == NULL )
+				{
+					pxFirstBuffer = pxNetworkBuffer;
+				}
+				else
+				{
+					pxLastBuffer->pxNextBuffer = pxNetworkBuffer;
+				}
+
+				pxLastBuffer = pxNetworkBuffer;
+			}
+			#else
+			{
+				xRxEvent.pvData = ( void * ) pxNetworkBuffer;
+
+				/* Data was received and stored.  Send a message to the IP task
+				to let it know. */
+				if( xSendEventStructToIPTask( &xRxEvent, ( TickType_t ) 0 ) == pdFAIL )
+				{
+					vReleaseNetworkBufferAndDescriptor( pxNetworkBuffer );
+					iptraceETHERNET_RX_EVENT_LOST();
+				}
+			}
+			#endif /* ipconfigUSE_LINKED_RX_MESSAGES */
+		}
+
+		#if( configLINUX_NETWORK_STATS_PERIOD_MS > 0 )
+		{
+			#if( ipconfigUSE_LINKED_RX_MESSAGES != 0 )
+			{
+				prvUpdateRxStatistics( xCount, ( xCount > 0 ) ? 1 : 0 );
+			}
+			#else
+			{
+				prvUpdateRxStatistics( xCount, xCount );
+			}
+			#endif
+		}
+		#endif /* configLINUX_NETWORK_STATS_PERIOD_MS */
+
+		#if( ipconfigUSE_LINKED_RX_MESSAGES != 0 )
+		{
+			if( pxFirstBuffer != NULL )
+			{
+				xRxEvent.pvData = ( void * ) pxFirstBuffer;
+
+				if( xSendEventStructToIPTask( &xRxEvent, ( TickType_t ) 0 ) == pdFAIL )
+				{
+					/* Release the whole chain. */
+					while( pxFirstBuffer != NULL )
+					{
+						pxNextBuffer = pxFirstBuffer->pxNextBuffer;
+						vReleaseNetworkBufferAndDescriptor( pxFirstBuffer );
+						pxFirstBuffer = pxNextBuffer;
+					}
+
+					iptraceETHERNET_RX_EVENT_LOST();
+				}
+			}
+		}
+		#endif /* ipconfigUSE_LINKED_RX_MESSAGES */
+
+		if( xCount == 0 )
+		{
+			/* There is no real way of simulating an interrupt.  Make sure
+			other tasks can run. */
+			vTaskDelay( configLINUX_MAC_INTERRUPT_SIMULATOR_DELAY );
+		}
+	}
+}
+/*-----------------------------------------------------------*/
+
+#if( configLINUX_NETWORK_STATS_PERIOD_MS > 0 )
+
+	static void prvUpdateRxStatistics( BaseType_t xFrames, BaseType_t xEvents )
+	{
+	static uint32_t ulFrameCount = 0, ulEventCount = 0;
+	static TickType_t xPeriodStart = 0;
+	const TickType_t xPeriod = pdMS_TO_TICKS( configLINUX_NETWORK_STATS_PERIOD_MS );
+	TickType_t xNow, xElapsed;
+
+		ulFrameCount += ( uint32_t ) xFrames;
+		ulEventCount += ( uint32_t ) xEvents;
+
+		xNow = xTaskGetTickCount();
+		xElapsed = xNow - xPeriodStart;
+
+		if( xElapsed >= xPeriod )
+		{
+			FreeRTOS_printf( ( "Linux RX: %lu frames/sec, %lu events/sec, %lu.%02lu frames/event\n",
+				( unsigned long ) ( ( ( uint64_t ) ulFrameCount * configTICK_RATE_HZ ) / xElapsed ),
+				( unsigned long ) ( ( ( uint64_t ) ulEventCount * configTICK_RATE_HZ ) / xElapsed ),
+				( unsigned long ) ( ( ulEventCount != 0 ) ? ( ulFrameCount / ulEventCount ) : 0 ),
+				( unsigned long ) ( ( ulEventCount != 0 ) ? ( ( 100 * ( ulFrameCount % ulEventCount ) ) / ulEventCount ) : 0 ) ) );
+
+			ulFrameCount = 0;
+			ulEventCount = 0;
+			xPeriodStart = xNow;
+		}
+	}
+
+#endif /* configLINUX_NETWORK_STATS_PERIOD_MS */
+/*-----------------------------------------------------------*/
@@ -86,8 +86,10 @@ void vPortFree( void *pv )
 	{
 		vTaskSuspendAll();
 		{
-			free( pv );
+			/* Trace the block while the pointer is still valid, as the
+			other heaps do before the block is returned. */
 			traceFREE( pv, 0 );
+			free( pv );
 		}
 		( void ) xTaskResumeAll();
 	}
@@ -0,0 +1,429 @@
+/*
+ * FreeRTOS Kernel V10.0.1
+ * Copyright (C) 2017 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/*
+ * A port that runs the kernel as a process on a POSIX host, such as Linux.
+ *
+ * Each task runs in its own host thread, but only one of these threads runs at
+ * any time: a thread that gives up the processor wakes the thread of the next
+ * task and then waits until it is woken itself.  The tick interrupt is the
+ * SIGALRM signal of an interval timer.  Only the thread of the running task
+ * leaves SIGALRM unblocked, so the tick handler always runs in the context of
+ * the running task, as an interrupt would on a target.  Critical sections
+ * block the signal.
+ *
+ * Host library functions that take locks, such as printf() and malloc(), must
+ * not be interrupted by a task switch.  Call them from within a critical
+ * section or with the scheduler suspended, as heap_3.c does.
+ */
+
+/* Standard includes. */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <signal.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/time.h>
+
+/* Scheduler includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+
+#define portNO_CRITICAL_NESTING 		( ( UBaseType_t ) 0 )
+
+/* The signal that is used as the tick interrupt. */
+#define portTICK_SIGNAL					SIGALRM
+
+/* The host thread of a task, and the event on which it waits while it does not
+run.  This structure is stored at the top of the task's stack, the thread
+itself runs on a stack that is allocated by the host. */
+typedef struct THREAD
+{
+	pthread_t xThread;
+	TaskFunction_t pxCode;
+	void *pvParameters;
+	pthread_mutex_t xMutex;
+	pthread_cond_t xCondition;
+	BaseType_t xRunning;			/* Set to let the thread run. */
+	volatile BaseType_t xDying;		/* Set when the task was deleted. */
+} Thread_t;
+
+/*
+ * The function that every task thread starts in.  It waits until the
+ * scheduler selects the task, then calls the task function.
+ */
+static void *prvTaskThread( void *pvParameters );
+
+/*
+ * Let the thread of another task run, and wait until this thread is allowed to
+ * run again.
+ */
+static void prvResumeThread( Thread_t *pxThread );
+static void prvSuspendSelf( Thread_t *pxThread );
+
+/*
+ * Select the next task to run and switch to its thread.  Called with the tick
+ * signal blocked.
+ */
+static void prvSwitchTask( void );
+
+/*
+ * The tick interrupt.
+ */
+static void prvTickSignalHandler( int iSignal );
+
+/*
+ * Start or stop the interval timer that generates the tick signal.
+ */
+static void prvSetupTimerInterrupt( TickType_t xPeriodTicks );
+
+/*-----------------------------------------------------------*/
+
+/* Every thread counts its own nesting, a thread that yields within a critical
+section keeps it when another task runs. */
+static __thread UBaseType_t uxCriticalNesting = portNO_CRITICAL_NESTING;
+
+/* The thread that called vTaskStartScheduler() waits until the scheduler is
+ended. */
+static pthread_mutex_t xEndMutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t xEndCondition = PTHREAD_COND_INITIALIZER;
+static BaseType_t xSchedulerEnded = pdFALSE;
+
+/* The start of the run time counter. */
+static struct timespec xStartTime;
+
+/* The TCB of the running task. */
+extern void * volatile pxCurrentTCB;
+
+/*-----------------------------------------------------------*/
+
+static Thread_t *prvGetThreadFromTask( void *pvTCB )
+{
+	/* The first member of a TCB is the top of stack pointer, which points to
+	the thread structure. */
+	return *( ( Thread_t ** ) pvTCB );
+}
+/*-----------------------------------------------------------*/
+
+/*
+ * See header file for description.
+ */
+StackType_t *pxPortInitialiseStack( StackType_t *pxTopOfStack, TaskFunction_t pxCode, void *pvParameters )
+{
+Thread_t *pxThread;
+sigset_t xAllSignals, xOldSignals;
+int iResult;
+
+	/* Store the thread structure at the top of the stack.  The stack is not
+	used otherwise. */
+	pxThread = ( Thread_t * ) ( ( ( portPOINTER_SIZE_TYPE ) ( pxTopOfStack + 1 ) - sizeof( Thread_t ) ) & ~( ( portPOINTER_SIZE_TYPE ) portBYTE_ALIGNMENT_MASK ) );
+
+	memset( ( void * ) pxThread, 0, sizeof( *pxThread ) );
+	pxThread->pxCode = pxCode;
+	pxThread->pvParameters = pvParameters;
+	pxThread->xRunning = pdFALSE;
+	pxThread->xDying = pdFALSE;
+	pthread_mutex_init( &( pxThread->xMutex ), NULL );
+	pthread_cond_init( &( pxThread->xCondition ), NULL );
+
+	/* The new thread inherits a signal mask that blocks all signals, it
+	unblocks the tick signal when the task starts running.  Blocking the
+	signals also keeps the calling task from being switched out while the
+	host library creates the thread. */
+	sigfillset( &xAllSignals );
+	pthread_sigmask( SIG_SETMASK, &xAllSignals, &xOldSignals );
+	iResult = pthread_create( &( pxThread->xThread ), NULL, prvTaskThread, ( void * ) pxThread );
+	pthread_sigmask( SIG_SETMASK, &xOldSignals, NULL );
+
+	configASSERT( iResult == 0 );
+	( void ) iResult;
+
+	return ( StackType_t * ) pxThread;
+}
+/*-----------------------------------------------------------*/
+
+static void *prvTaskThread( void *pvParameters )
+{
+Thread_t *pxThread = ( Thread_t * ) pvParameters;
+
+	/* Wait until the scheduler selects this task for the first time. */
+	prvSuspendSelf( pxThread );
+
+	/* A task starts with interrupts enabled. */
+	uxCriticalNesting = portNO_CRITICAL_NESTING;
+	vPortEnableInterrupts();
+
+	pxThread->pxCode( pxThread->pvParameters );
+
+	/* A task must not return from its implementing function. */
+	configASSERT( pdFALSE );
+	vTaskDelete( NULL );
+
+	return NULL;
+}
+/*-----------------------------------------------------------*/
+
+static void prvResumeThread( Thread_t *pxThread )
+{
+	pthread_mutex_lock( &( pxThread->xMutex ) );
+	pxThread->xRunning = pdTRUE;
+	pthread_cond_signal( &( pxThread->xCondition ) );
+	pthread_mutex_unlock( &( pxThread->xMutex ) );
+}
+/*-----------------------------------------------------------*/
+
+static void prvSuspendSelf( Thread_t *pxThread )
+{
+	pthread_mutex_lock( &( pxThread->xMutex ) );
+
+	while( ( pxThread->xRunning == pdFALSE ) && ( pxThread->xDying == pdFALSE ) )
+	{
+		pthread_cond_wait( &( pxThread->xCondition ), &( pxThread->xMutex ) );
+	}
+
+	pxThread->xRunning = pdFALSE;
+	pthread_mutex_unlock( &( pxThread->xMutex ) );
+
+	if( pxThread->xDying != pdFALSE )
+	{
+		/* The task was deleted, vPortDeleteThread() joins this thread. */
+		pthread_exit( NULL );
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvSwitchTask( void )
+{
+Thread_t *pxOldThread, *pxNewThread;
+
+	pxOldThread = prvGetThreadFromTask( pxCurrentTCB );
+	vTaskSwitchContext();
+	pxNewThread = prvGetThreadFromTask( pxCurrentTCB );
+
+	if( pxNewThread != pxOldThread )
+	{
+		prvResumeThread( pxNewThread );
+		prvSuspendSelf( pxOldThread );
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvTickSignalHandler( int iSignal )
+{
+	( void ) iSignal;
+
+	/* The handler runs with the tick signal blocked, as if in a critical
+	section.  Count it, so the thread keeps the signal blocked if it is
+	switched out here and a critical section is entered and left. */
+	uxCriticalNesting++;
+	{
+		if( xTaskIncrementTick() != pdFALSE )
+		{
+			prvSwitchTask();
+		}
+	}
+	uxCriticalNesting--;
+}
+/*-----------------------------------------------------------*/
+
+static void prvSetupTimerInterrupt( TickType_t xPeriodTicks )
+{
+struct itimerval xTimer;
+suseconds_t xMicroSeconds = ( suseconds_t ) ( ( 1000000UL / configTICK_RATE_HZ ) * xPeriodTicks );
+
+	xTimer.it_value.tv_sec = xMicroSeconds / 1000000L;
+	xTimer.it_value.tv_usec = xMicroSeconds % 1000000L;
+	xTimer.it_interval = xTimer.it_value;
+
+	setitimer( ITIMER_REAL, &xTimer, NULL );
+}
+/*-----------------------------------------------------------*/
+
+/*
+ * See header file for description.
+ */
+BaseType_t xPortStartScheduler( void )
+{
+struct sigaction xTickAction;
+sigset_t xTickSignal;
+
+	clock_gettime( CLOCK_MONOTONIC, &xStartTime );
+
+	/* The calling thread does not run a task, it must never handle the tick. */
+	sigemptyset( &xTickSignal );
+	sigaddset( &xTickSignal, portTICK_SIGNAL );
+	pthread_sigmask( SIG_BLOCK, &xTickSignal, NULL );
+
+	memset( ( void * ) &xTickAction, 0, sizeof( xTickAction ) );
+	xTickAction.sa_handler = prvTickSignalHandler;
+	xTickAction.sa_flags = SA_RESTART;
+	sigfillset( &xTickAction.sa_mask );
+	sigaction( portTICK_SIGNAL, &xTickAction, NULL );
+
+	prvSetupTimerInterrupt( ( TickType_t ) 1 );
+
+	/* Start the first task. */
+	prvResumeThread( prvGetThreadFromTask( pxCurrentTCB ) );
+
+	/* Wait until vPortEndScheduler() is called. */
+	pthread_mutex_lock( &xEndMutex );
+
+	while( xSchedulerEnded == pdFALSE )
+	{
+		pthread_cond_wait( &xEndCondition, &xEndMutex );
+	}
+
+	pthread_mutex_unlock( &xEndMutex );
+
+	return pdFALSE;
+}
+/*-----------------------------------------------------------*/
+
+void vPortEndScheduler( void )
+{
+sigset_t xAllSignals;
+
+	prvSetupTimerInterrupt( ( TickType_t ) 0 );
+
+	pthread_mutex_lock( &xEndMutex );
+	xSchedulerEnded = pdTRUE;
+	pthread_cond_signal( &xEndCondition );
+	pthread_mutex_unlock( &xEndMutex );
+
+	/* The thread that started the scheduler continues, the tasks do not run
+	any more. */
+	sigfillset( &xAllSignals );
+	pthread_sigmask( SIG_SETMASK, &xAllSignals, NULL );
+
+	for( ;; )
+	{
+		pause();
+	}
+}
+/*-----------------------------------------------------------*/
+
+void vPortYield( void )
+{
+	vPortEnterCritical();
+	{
+		prvSwitchTask();
+	}
+	vPortExitCritical();
+}
+/*-----------------------------------------------------------*/
+
+void vPortDisableInterrupts( void )
+{
+sigset_t xTickSignal;
+
+	sigemptyset( &xTickSignal );
+	sigaddset( &xTickSignal, portTICK_SIGNAL );
+	pthread_sigmask( SIG_BLOCK, &xTickSignal, NULL );
+}
+/*-----------------------------------------------------------*/
+
+void vPortEnableInterrupts( void )
+{
+sigset_t xTickSignal;
+
+	sigemptyset( &xTickSignal );
+	sigaddset( &xTickSignal, portTICK_SIGNAL );
+	pthread_sigmask( SIG_UNBLOCK, &xTickSignal, NULL );
+}
+/*-----------------------------------------------------------*/
+
+void vPortEnterCritical( void )
+{
+	if( uxCriticalNesting == portNO_CRITICAL_NESTING )
+	{
+		vPortDisableInterrupts();
+	}
+
+	uxCriticalNesting++;
+}
+/*-----------------------------------------------------------*/
+
+void vPortExitCritical( void )
+{
+	if( uxCriticalNesting > portNO_CRITICAL_NESTING )
+	{
+		uxCriticalNesting--;
+
+		if( uxCriticalNesting == portNO_CRITICAL_NESTING )
+		{
+			vPortEnableInterrupts();
+		}
+	}
+}
+/*-----------------------------------------------------------*/
+
+void vPortCloseRunningThread( void *pvTaskToDelete, volatile BaseType_t *pxPendYield )
+{
+	/* The thread of a task that deletes itself exits when it is switched out,
+	the kernel yields straight after calling this function. */
+	prvGetThreadFromTask( pvTaskToDelete )->xDying = pdTRUE;
+	*pxPendYield = pdTRUE;
+}
+/*-----------------------------------------------------------*/
+
+void vPortDeleteThread( void *pvTaskToDelete )
+{
+Thread_t *pxThread = prvGetThreadFromTask( pvTaskToDelete );
+sigset_t xAllSignals, xOldSignals;
+
+	/* The TCB and the stack, which holds the thread structure, are freed after
+	this function returns, so wait until the thread has exited. */
+	sigfillset( &xAllSignals );
+	pthread_sigmask( SIG_SETMASK, &xAllSignals, &xOldSignals );
+	{
+		pthread_mutex_lock( &( pxThread->xMutex ) );
+		pxThread->xDying = pdTRUE;
+		pthread_cond_signal( &( pxThread->xCondition ) );
+		pthread_mutex_unlock( &( pxThread->xMutex ) );
+
+		pthread_join( pxThread->xThread, NULL );
+
+		pthread_cond_destroy( &( pxThread->xCondition ) );
+		pthread_mutex_destroy( &( pxThread->xMutex ) );
+	}
+	pthread_sigmask( SIG_SETMASK, &xOldSignals, NULL );
+}
+/*-----------------------------------------------------------*/
+
+unsigned long ulPortGetRunTime( void )
+{
+struct timespec xNow;
+
+	clock_gettime( CLOCK_MONOTONIC, &xNow );
+
+	return ( unsigned long ) ( ( xNow.tv_sec - xStartTime.tv_sec ) * 1000000L +
+							   ( xNow.tv_nsec - xStartTime.tv_nsec ) / 1000L );
+}
+/*-----------------------------------------------------------*/
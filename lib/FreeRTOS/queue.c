@@ -52,6 +52,11 @@ privileged Vs unprivileged linkage and placement. */
 #define queueUNLOCKED					( ( int8_t ) -1 )
 #define queueLOCKED_UNMODIFIED			( ( int8_t ) 0 )
 
+/* The largest count that the cRxLock and cTxLock members can hold.  An ISR that
+moves several items at once while the queue is locked adds the number of items
+to the lock count, but never beyond this value. */
+#define queueMAX_LOCK_COUNT				( ( int8_t ) 127 )
+
 /* When the Queue_t structure is used to represent a base queue its pcHead and
 pcTail members are used as pointers into the queue storage area.  When the
 Queue_t structure is used to represent a mutex pcHead and pcTail pointers are
@@ -190,6 +195,31 @@ static BaseType_t prvCopyDataToQueue( Queue_t * const pxQueue, const void *pvIte
  */
 static void prvCopyDataFromQueue( Queue_t * const pxQueue, void * const pvBuffer ) PRIVILEGED_FUNCTION;
 
+/*
+ * Copies uxCount items to the back of the queue, or out of the front of the
+ * queue, using at most two memcpy() calls each.  The caller must have checked
+ * that there is enough space or enough items.
+ */
+static void prvCopyItemsToQueue( Queue_t * const pxQueue, const uint8_t *pucItems, const UBaseType_t uxCount ) PRIVILEGED_FUNCTION;
+static void prvCopyItemsFromQueue( Queue_t * const pxQueue, uint8_t *pucBuffer, const UBaseType_t uxCount ) PRIVILEGED_FUNCTION;
+
+/*
+ * Called after uxCount items were added to (removed from) the queue to unblock
+ * up to uxCount tasks that are waiting to receive from (send to) the queue.  If
+ * the queue is a member of a queue set, the queue set is notified once for each
+ * item added instead.  Must be called from a critical section.
+ *
+ * @return pdTRUE if a task with a priority above that of the calling task was
+ * unblocked, otherwise pdFALSE.
+ */
+static BaseType_t prvUnblockTasksAfterSend( Queue_t * const pxQueue, UBaseType_t uxCount ) PRIVILEGED_FUNCTION;
+static BaseType_t prvUnblockTasksAfterReceive( Queue_t * const pxQueue, UBaseType_t uxCount ) PRIVILEGED_FUNCTION;
+
+/*
+ * Adds uxCount to a cRxLock or cTxLock value, limited to queueMAX_LOCK_COUNT.
+ */
+static int8_t prvAddToLockCount( const int8_t cLock, const UBaseType_t uxCount ) PRIVILEGED_FUNCTION;
+
 #if ( configUSE_QUEUE_SETS == 1 )
 	/*
 	 * Checks to see if a queue is a member of a queue set, and if so, notifies
@@ -1838,6 +1868,374 @@ Queue_t * const pxQueue = ( Queue_t * ) xQueue;
 }
 /*-----------------------------------------------------------*/
 
+size_t xQueueSendMultiple( QueueHandle_t xQueue, const void * const pvItems, size_t xItemCount, TickType_t xTicksToWait )
+{
+BaseType_t xEntryTimeSet = pdFALSE;
+TimeOut_t xTimeOut;
+UBaseType_t uxCount;
+Queue_t * const pxQueue = ( Queue_t * ) xQueue;
+
+	configASSERT( pxQueue );
+	configASSERT( !( ( pvItems == NULL ) && ( xItemCount != ( size_t ) 0 ) ) );
+
+	/* Semaphores and mutexes do not hold items that can be copied. */
+	configASSERT( pxQueue->uxItemSize != ( UBaseType_t ) 0U );
+	#if ( ( INCLUDE_xTaskGetSchedulerState == 1 ) || ( configUSE_TIMERS == 1 ) )
+	{
+		configASSERT( !( ( xTaskGetSchedulerState() == taskSCHEDULER_SUSPENDED ) && ( xTicksToWait != 0 ) ) );
+	}
+	#endif
+
+	/* This function follows xQueueGenericSend(), but copies as many items as
+	there is space for in one go, and only blocks while the queue is full. */
+	for( ;; )
+	{
+		taskENTER_CRITICAL();
+		{
+			uxCount = pxQueue->uxLength - pxQueue->uxMessagesWaiting;
+
+			if( ( size_t ) uxCount > xItemCount )
+			{
+				uxCount = ( UBaseType_t ) xItemCount;
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+
+			if( uxCount > ( UBaseType_t ) 0 )
+			{
+				traceQUEUE_SEND( pxQueue );
+				prvCopyItemsToQueue( pxQueue, ( const uint8_t * ) pvItems, uxCount );
+
+				/* Unblock one waiting task per item, and yield once if any of
+				them has a priority above our own. */
+				if( prvUnblockTasksAfterSend( pxQueue, uxCount ) != pdFALSE )
+				{
+					queueYIELD_IF_USING_PREEMPTION();
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+
+				taskEXIT_CRITICAL();
+				return ( size_t ) uxCount;
+			}
+			else
+			{
+				if( ( xTicksToWait == ( TickType_t ) 0 ) || ( xItemCount == ( size_t ) 0 ) )
+				{
+					/* The queue was full and no block time is specified (or
+					the block time has expired) so leave now. */
+					taskEXIT_CRITICAL();
+					traceQUEUE_SEND_FAILED( pxQueue );
+					return ( size_t ) 0;
+				}
+				else if( xEntryTimeSet == pdFALSE )
+				{
+					vTaskInternalSetTimeOutState( &xTimeOut );
+					xEntryTimeSet = pdTRUE;
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+			}
+		}
+		taskEXIT_CRITICAL();
+
+		vTaskSuspendAll();
+		prvLockQueue( pxQueue );
+
+		if( xTaskCheckForTimeOut( &xTimeOut, &xTicksToWait ) == pdFALSE )
+		{
+			if( prvIsQueueFull( pxQueue ) != pdFALSE )
+			{
+				traceBLOCKING_ON_QUEUE_SEND( pxQueue );
+				vTaskPlaceOnEventList( &( pxQueue->xTasksWaitingToSend ), xTicksToWait );
+				prvUnlockQueue( pxQueue );
+
+				if( xTaskResumeAll() == pdFALSE )
+				{
+					portYIELD_WITHIN_API();
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+			}
+			else
+			{
+				/* Try again. */
+				prvUnlockQueue( pxQueue );
+				( void ) xTaskResumeAll();
+			}
+		}
+		else
+		{
+			/* The timeout has expired. */
+			prvUnlockQueue( pxQueue );
+			( void ) xTaskResumeAll();
+
+			traceQUEUE_SEND_FAILED( pxQueue );
+			return ( size_t ) 0;
+		}
+	}
+}
+/*-----------------------------------------------------------*/
+
+size_t xQueueSendMultipleFromISR( QueueHandle_t xQueue, const void * const pvItems, size_t xItemCount, BaseType_t * const pxHigherPriorityTaskWoken )
+{
+UBaseType_t uxCount;
+UBaseType_t uxSavedInterruptStatus;
+Queue_t * const pxQueue = ( Queue_t * ) xQueue;
+
+	configASSERT( pxQueue );
+	configASSERT( !( ( pvItems == NULL ) && ( xItemCount != ( size_t ) 0 ) ) );
+	configASSERT( pxQueue->uxItemSize != ( UBaseType_t ) 0U );
+
+	/* See the comments in xQueueGenericSendFromISR(). */
+	portASSERT_IF_INTERRUPT_PRIORITY_INVALID();
+
+	uxSavedInterruptStatus = portSET_INTERRUPT_MASK_FROM_ISR();
+	{
+		uxCount = pxQueue->uxLength - pxQueue->uxMessagesWaiting;
+
+		if( ( size_t ) uxCount > xItemCount )
+		{
+			uxCount = ( UBaseType_t ) xItemCount;
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		if( uxCount > ( UBaseType_t ) 0 )
+		{
+			const int8_t cTxLock = pxQueue->cTxLock;
+
+			traceQUEUE_SEND_FROM_ISR( pxQueue );
+			prvCopyItemsToQueue( pxQueue, ( const uint8_t * ) pvItems, uxCount );
+
+			/* The event list is not altered if the queue is locked.  This will
+			be done when the queue is unlocked later. */
+			if( cTxLock == queueUNLOCKED )
+			{
+				if( ( prvUnblockTasksAfterSend( pxQueue, uxCount ) != pdFALSE ) && ( pxHigherPriorityTaskWoken != NULL ) )
+				{
+					*pxHigherPriorityTaskWoken = pdTRUE;
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+			}
+			else
+			{
+				/* Let the task that unlocks the queue know how many items were
+				posted while it was locked. */
+				pxQueue->cTxLock = prvAddToLockCount( cTxLock, uxCount );
+			}
+		}
+		else
+		{
+			traceQUEUE_SEND_FROM_ISR_FAILED( pxQueue );
+		}
+	}
+	portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedInterruptStatus );
+
+	return ( size_t ) uxCount;
+}
+/*-----------------------------------------------------------*/
+
+size_t xQueueReceiveMultiple( QueueHandle_t xQueue, void * const pvBuffer, size_t xBufferItems, TickType_t xTicksToWait )
+{
+BaseType_t xEntryTimeSet = pdFALSE;
+TimeOut_t xTimeOut;
+UBaseType_t uxCount;
+Queue_t * const pxQueue = ( Queue_t * ) xQueue;
+
+	configASSERT( pxQueue );
+	configASSERT( !( ( pvBuffer == NULL ) && ( xBufferItems != ( size_t ) 0 ) ) );
+	configASSERT( pxQueue->uxItemSize != ( UBaseType_t ) 0U );
+	#if ( ( INCLUDE_xTaskGetSchedulerState == 1 ) || ( configUSE_TIMERS == 1 ) )
+	{
+		configASSERT( !( ( xTaskGetSchedulerState() == taskSCHEDULER_SUSPENDED ) && ( xTicksToWait != 0 ) ) );
+	}
+	#endif
+
+	/* This function follows xQueueReceive(), but copies out as many items as
+	are available in one go, and only blocks while the queue is empty. */
+	for( ;; )
+	{
+		taskENTER_CRITICAL();
+		{
+			uxCount = pxQueue->uxMessagesWaiting;
+
+			if( ( size_t ) uxCount > xBufferItems )
+			{
+				uxCount = ( UBaseType_t ) xBufferItems;
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+
+			if( uxCount > ( UBaseType_t ) 0 )
+			{
+				prvCopyItemsFromQueue( pxQueue, ( uint8_t * ) pvBuffer, uxCount );
+				traceQUEUE_RECEIVE( pxQueue );
+
+				/* There is now space for uxCount items, so unblock as many
+				tasks that are waiting to post to the queue. */
+				if( prvUnblockTasksAfterReceive( pxQueue, uxCount ) != pdFALSE )
+				{
+					queueYIELD_IF_USING_PREEMPTION();
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+
+				taskEXIT_CRITICAL();
+				return ( size_t ) uxCount;
+			}
+			else
+			{
+				if( ( xTicksToWait == ( TickType_t ) 0 ) || ( xBufferItems == ( size_t ) 0 ) )
+				{
+					/* The queue was empty and no block time is specified (or
+					the block time has expired) so leave now. */
+					taskEXIT_CRITICAL();
+					traceQUEUE_RECEIVE_FAILED( pxQueue );
+					return ( size_t ) 0;
+				}
+				else if( xEntryTimeSet == pdFALSE )
+				{
+					vTaskInternalSetTimeOutState( &xTimeOut );
+					xEntryTimeSet = pdTRUE;
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+			}
+		}
+		taskEXIT_CRITICAL();
+
+		vTaskSuspendAll();
+		prvLockQueue( pxQueue );
+
+		if( xTaskCheckForTimeOut( &xTimeOut, &xTicksToWait ) == pdFALSE )
+		{
+			if( prvIsQueueEmpty( pxQueue ) != pdFALSE )
+			{
+				traceBLOCKING_ON_QUEUE_RECEIVE( pxQueue );
+				vTaskPlaceOnEventList( &( pxQueue->xTasksWaitingToReceive ), xTicksToWait );
+				prvUnlockQueue( pxQueue );
+
+				if( xTaskResumeAll() == pdFALSE )
+				{
+					portYIELD_WITHIN_API();
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+			}
+			else
+			{
+				/* The queue contains data again.  Loop back to try and read the
+				data. */
+				prvUnlockQueue( pxQueue );
+				( void ) xTaskResumeAll();
+			}
+		}
+		else
+		{
+			/* Timed out.  If there is no data in the queue exit, otherwise loop
+			back and attempt to read the data. */
+			prvUnlockQueue( pxQueue );
+			( void ) xTaskResumeAll();
+
+			if( prvIsQueueEmpty( pxQueue ) != pdFALSE )
+			{
+				traceQUEUE_RECEIVE_FAILED( pxQueue );
+				return ( size_t ) 0;
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+	}
+}
+/*-----------------------------------------------------------*/
+
+size_t xQueueReceiveMultipleFromISR( QueueHandle_t xQueue, void * const pvBuffer, size_t xBufferItems, BaseType_t * const pxHigherPriorityTaskWoken )
+{
+UBaseType_t uxCount;
+UBaseType_t uxSavedInterruptStatus;
+Queue_t * const pxQueue = ( Queue_t * ) xQueue;
+
+	configASSERT( pxQueue );
+	configASSERT( !( ( pvBuffer == NULL ) && ( xBufferItems != ( size_t ) 0 ) ) );
+	configASSERT( pxQueue->uxItemSize != ( UBaseType_t ) 0U );
+
+	/* See the comments in xQueueReceiveFromISR(). */
+	portASSERT_IF_INTERRUPT_PRIORITY_INVALID();
+
+	uxSavedInterruptStatus = portSET_INTERRUPT_MASK_FROM_ISR();
+	{
+		uxCount = pxQueue->uxMessagesWaiting;
+
+		if( ( size_t ) uxCount > xBufferItems )
+		{
+			uxCount = ( UBaseType_t ) xBufferItems;
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		if( uxCount > ( UBaseType_t ) 0 )
+		{
+			const int8_t cRxLock = pxQueue->cRxLock;
+
+			traceQUEUE_RECEIVE_FROM_ISR( pxQueue );
+			prvCopyItemsFromQueue( pxQueue, ( uint8_t * ) pvBuffer, uxCount );
+
+			/* If the queue is locked the event list will not be modified.
+			Instead update the lock count so the task that unlocks the queue
+			will know how many items an ISR has removed. */
+			if( cRxLock == queueUNLOCKED )
+			{
+				if( ( prvUnblockTasksAfterReceive( pxQueue, uxCount ) != pdFALSE ) && ( pxHigherPriorityTaskWoken != NULL ) )
+				{
+					*pxHigherPriorityTaskWoken = pdTRUE;
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+			}
+			else
+			{
+				pxQueue->cRxLock = prvAddToLockCount( cRxLock, uxCount );
+			}
+		}
+		else
+		{
+			traceQUEUE_RECEIVE_FROM_ISR_FAILED( pxQueue );
+		}
+	}
+	portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedInterruptStatus );
+
+	return ( size_t ) uxCount;
+}
+/*-----------------------------------------------------------*/
+
 BaseType_t xQueuePeekFromISR( QueueHandle_t xQueue,  void * const pvBuffer )
 {
 BaseType_t xReturn;
@@ -2134,6 +2532,194 @@ static void prvCopyDataFromQueue( Queue_t * const pxQueue, void * const pvBuffer
 }
 /*-----------------------------------------------------------*/
 
+static void prvCopyItemsToQueue( Queue_t * const pxQueue, const uint8_t *pucItems, const UBaseType_t uxCount )
+{
+size_t xBytes, xFirstBytes;
+
+	/* This function is called from a critical section. */
+
+	xBytes = ( size_t ) uxCount * ( size_t ) pxQueue->uxItemSize;
+
+	/* Copy up to the end of the storage area, then wrap around to its start. */
+	xFirstBytes = ( size_t ) ( pxQueue->pcTail - pxQueue->pcWriteTo );
+
+	if( xFirstBytes > xBytes )
+	{
+		xFirstBytes = xBytes;
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	( void ) memcpy( ( void * ) pxQueue->pcWriteTo, ( const void * ) pucItems, xFirstBytes );
+
+	if( xBytes > xFirstBytes )
+	{
+		( void ) memcpy( ( void * ) pxQueue->pcHead, ( const void * ) ( pucItems + xFirstBytes ), xBytes - xFirstBytes );
+		pxQueue->pcWriteTo = pxQueue->pcHead + ( xBytes - xFirstBytes );
+	}
+	else
+	{
+		pxQueue->pcWriteTo += xFirstBytes;
+
+		if( pxQueue->pcWriteTo >= pxQueue->pcTail ) /*lint !e946 MISRA exception justified as comparison of pointers is the cleanest solution. */
+		{
+			pxQueue->pcWriteTo = pxQueue->pcHead;
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+
+	pxQueue->uxMessagesWaiting += uxCount;
+}
+/*-----------------------------------------------------------*/
+
+static void prvCopyItemsFromQueue( Queue_t * const pxQueue, uint8_t *pucBuffer, const UBaseType_t uxCount )
+{
+size_t xBytes, xFirstBytes;
+int8_t *pcNextItem;
+
+	/* This function is called from a critical section.  pcReadFrom points to
+	the last item read, so the first item to copy follows it. */
+
+	xBytes = ( size_t ) uxCount * ( size_t ) pxQueue->uxItemSize;
+	pcNextItem = pxQueue->u.pcReadFrom + pxQueue->uxItemSize;
+
+	if( pcNextItem >= pxQueue->pcTail ) /*lint !e946 MISRA exception justified as use of the relational operator is the cleanest solutions. */
+	{
+		pcNextItem = pxQueue->pcHead;
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	xFirstBytes = ( size_t ) ( pxQueue->pcTail - pcNextItem );
+
+	if( xFirstBytes > xBytes )
+	{
+		xFirstBytes = xBytes;
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	( void ) memcpy( ( void * ) pucBuffer, ( void * ) pcNextItem, xFirstBytes );
+
+	if( xBytes > xFirstBytes )
+	{
+		( void ) memcpy( ( void * ) ( pucBuffer + xFirstBytes ), ( void * ) pxQueue->pcHead, xBytes - xFirstBytes );
+		pxQueue->u.pcReadFrom = pxQueue->pcHead + ( xBytes - xFirstBytes ) - pxQueue->uxItemSize;
+	}
+	else
+	{
+		pxQueue->u.pcReadFrom = pcNextItem + xFirstBytes - pxQueue->uxItemSize;
+	}
+
+	pxQueue->uxMessagesWaiting -= uxCount;
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvUnblockTasksAfterSend( Queue_t * const pxQueue, UBaseType_t uxCount )
+{
+BaseType_t xReturn = pdFALSE;
+
+	#if ( configUSE_QUEUE_SETS == 1 )
+	{
+		if( pxQueue->pxQueueSetContainer != NULL )
+		{
+			/* The queue set holds one handle for each item in its member
+			queues. */
+			for( ; uxCount > ( UBaseType_t ) 0; uxCount-- )
+			{
+				if( prvNotifyQueueSetContainer( pxQueue, queueSEND_TO_BACK ) != pdFALSE )
+				{
+					xReturn = pdTRUE;
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+			}
+		}
+		else
+		{
+			for( ; ( uxCount > ( UBaseType_t ) 0 ) && ( listLIST_IS_EMPTY( &( pxQueue->xTasksWaitingToReceive ) ) == pdFALSE ); uxCount-- )
+			{
+				if( xTaskRemoveFromEventList( &( pxQueue->xTasksWaitingToReceive ) ) != pdFALSE )
+				{
+					xReturn = pdTRUE;
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+			}
+		}
+	}
+	#else /* configUSE_QUEUE_SETS */
+	{
+		for( ; ( uxCount > ( UBaseType_t ) 0 ) && ( listLIST_IS_EMPTY( &( pxQueue->xTasksWaitingToReceive ) ) == pdFALSE ); uxCount-- )
+		{
+			if( xTaskRemoveFromEventList( &( pxQueue->xTasksWaitingToReceive ) ) != pdFALSE )
+			{
+				xReturn = pdTRUE;
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+	}
+	#endif /* configUSE_QUEUE_SETS */
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvUnblockTasksAfterReceive( Queue_t * const pxQueue, UBaseType_t uxCount )
+{
+BaseType_t xReturn = pdFALSE;
+
+	for( ; ( uxCount > ( UBaseType_t ) 0 ) && ( listLIST_IS_EMPTY( &( pxQueue->xTasksWaitingToSend ) ) == pdFALSE ); uxCount-- )
+	{
+		if( xTaskRemoveFromEventList( &( pxQueue->xTasksWaitingToSend ) ) != pdFALSE )
+		{
+			xReturn = pdTRUE;
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+static int8_t prvAddToLockCount( const int8_t cLock, const UBaseType_t uxCount )
+{
+int8_t cReturn;
+
+	if( uxCount < ( UBaseType_t ) ( queueMAX_LOCK_COUNT - cLock ) )
+	{
+		cReturn = ( int8_t ) ( cLock + ( int8_t ) uxCount );
+	}
+	else
+	{
+		/* The count only limits the number of tasks that are unblocked when
+		the queue is unlocked, and there will not be this many tasks waiting. */
+		cReturn = queueMAX_LOCK_COUNT;
+	}
+
+	return cReturn;
+}
+/*-----------------------------------------------------------*/
+
 static void prvUnlockQueue( Queue_t * const pxQueue )
 {
 	/* THIS FUNCTION MUST BE CALLED WITH THE SCHEDULER SUSPENDED. */
@@ -228,6 +228,17 @@ count overflows. */
 
 /*-----------------------------------------------------------*/
 
+#if( configUSE_DELAYED_TASK_WHEEL == 1 )
+
+	/* A wake time is hashed into the delayed task wheel by masking off its
+	high bits, so the slot for tick xTime is
+	xDelayedTaskWheel[ xTime & taskDELAYED_TASK_WHEEL_MASK ]. */
+	#define taskDELAYED_TASK_WHEEL_MASK		( ( TickType_t ) configDELAYED_TASK_WHEEL_SIZE - ( TickType_t ) 1 )
+
+#endif /* configUSE_DELAYED_TASK_WHEEL */
+
+/*-----------------------------------------------------------*/
+
 /*
  * Place the task represented by pxTCB into the appropriate ready list for
  * the task.  It is inserted at the end of the list.
@@ -322,8 +333,8 @@ typedef struct tskTaskControlBlock
 	#endif
 
 	#if( configUSE_TASK_NOTIFICATIONS == 1 )
-		volatile uint32_t ulNotifiedValue;
-		volatile uint8_t ucNotifyState;
+		volatile uint32_t ulNotifiedValue[ configTASK_NOTIFICATION_ARRAY_ENTRIES ];
+		volatile uint8_t ucNotifyState[ configTASK_NOTIFICATION_ARRAY_ENTRIES ];
 	#endif
 
 	/* See the comments above the definition of
@@ -359,6 +370,19 @@ PRIVILEGED_DATA static List_t * volatile pxDelayedTaskList;				/*< Points to the
 PRIVILEGED_DATA static List_t * volatile pxOverflowDelayedTaskList;		/*< Points to the delayed task list currently being used to hold tasks that have overflowed the current tick count. */
 PRIVILEGED_DATA static List_t xPendingReadyList;						/*< Tasks that have been readied while the scheduler was suspended.  They will be moved to the ready list when the scheduler is resumed. */
 
+#if( configUSE_DELAYED_TASK_WHEEL == 1 )
+
+	/* Tasks that block for fewer than configDELAYED_TASK_WHEEL_SIZE ticks are
+	not inserted into the sorted delayed lists, which takes time proportional to
+	the number of blocked tasks, but appended to the slot of the wheel that
+	corresponds to their wake time.  Every wake time held in the wheel falls
+	within configDELAYED_TASK_WHEEL_SIZE ticks of the tick count, so all the
+	tasks referenced from one slot share the same wake time. */
+	PRIVILEGED_DATA static List_t xDelayedTaskWheel[ configDELAYED_TASK_WHEEL_SIZE ];	/*< Tasks due to wake within configDELAYED_TASK_WHEEL_SIZE ticks. */
+	PRIVILEGED_DATA static volatile TickType_t xNextDelayedTaskWheelTime;				/*< The earliest wake time held in the wheel that has not overflowed the tick count, or portMAX_DELAY. */
+
+#endif
+
 #if( INCLUDE_vTaskDelete == 1 )
 
 	PRIVILEGED_DATA static List_t xTasksWaitingTermination;				/*< Tasks that have been deleted - but their memory not yet freed. */
@@ -545,6 +569,30 @@ static void prvAddCurrentTaskToDelayedList( TickType_t xTicksToWait, const BaseT
  */
 static void prvResetNextTaskUnblockTime( void );
 
+#if( configUSE_DELAYED_TASK_WHEEL == 1 )
+
+	/*
+	 * Place the calling task into the slot of the delayed task wheel that
+	 * corresponds to xTimeToWake, which must be less than
+	 * configDELAYED_TASK_WHEEL_SIZE ticks after xConstTickCount.
+	 */
+	static void prvAddCurrentTaskToDelayedTaskWheel( const TickType_t xTimeToWake, const TickType_t xConstTickCount ) PRIVILEGED_FUNCTION;
+
+	/*
+	 * Return the earliest wake time held in the delayed task wheel that has not
+	 * overflowed the tick count, or portMAX_DELAY if there is none.
+	 */
+	static TickType_t prvGetNextDelayedTaskWheelTime( void ) PRIVILEGED_FUNCTION;
+
+	/*
+	 * Move every task in the slot of the delayed task wheel that corresponds to
+	 * xTimeToWake into the ready list.  Returns pdTRUE if one of the unblocked
+	 * tasks should preempt the running task.
+	 */
+	static BaseType_t prvUnblockDelayedTaskWheelSlot( const TickType_t xTimeToWake ) PRIVILEGED_FUNCTION;
+
+#endif
+
 #if ( ( configUSE_TRACE_FACILITY == 1 ) && ( configUSE_STATS_FORMATTING_FUNCTIONS > 0 ) )
 
 	/*
@@ -990,8 +1038,11 @@ UBaseType_t x;
 
 	#if ( configUSE_TASK_NOTIFICATIONS == 1 )
 	{
-		pxNewTCB->ulNotifiedValue = 0;
-		pxNewTCB->ucNotifyState = taskNOT_WAITING_NOTIFICATION;
+		for( x = 0; x < ( UBaseType_t ) configTASK_NOTIFICATION_ARRAY_ENTRIES; x++ )
+		{
+			pxNewTCB->ulNotifiedValue[ x ] = 0;
+			pxNewTCB->ucNotifyState[ x ] = taskNOT_WAITING_NOTIFICATION;
+		}
 	}
 	#endif
 
@@ -1369,6 +1420,15 @@ static void prvAddNewTaskToReadyList( TCB_t *pxNewTCB )
 				eReturn = eBlocked;
 			}
 
+			#if( configUSE_DELAYED_TASK_WHEEL == 1 )
+				else if( ( pxStateList >= &( xDelayedTaskWheel[ 0 ] ) ) && ( pxStateList <= &( xDelayedTaskWheel[ configDELAYED_TASK_WHEEL_SIZE - 1 ] ) ) )
+				{
+					/* The task being queried is referenced from a slot of the
+					delayed task wheel. */
+					eReturn = eBlocked;
+				}
+			#endif
+
 			#if ( INCLUDE_vTaskSuspend == 1 )
 				else if( pxStateList == &xSuspendedTaskList )
 				{
@@ -1675,11 +1735,16 @@ static void prvAddNewTaskToReadyList( TCB_t *pxNewTCB )
 
 			#if( configUSE_TASK_NOTIFICATIONS == 1 )
 			{
-				if( pxTCB->ucNotifyState == taskWAITING_NOTIFICATION )
+			UBaseType_t x;
+
+				for( x = 0; x < ( UBaseType_t ) configTASK_NOTIFICATION_ARRAY_ENTRIES; x++ )
 				{
-					/* The task was blocked to wait for a notification, but is
-					now suspended, so no notification was received. */
-					pxTCB->ucNotifyState = taskNOT_WAITING_NOTIFICATION;
+					if( pxTCB->ucNotifyState[ x ] == taskWAITING_NOTIFICATION )
+					{
+						/* The task was blocked to wait for a notification, but is
+						now suspended, so no notification was received. */
+						pxTCB->ucNotifyState[ x ] = taskNOT_WAITING_NOTIFICATION;
+					}
 				}
 			}
 			#endif
@@ -2402,6 +2467,9 @@ TCB_t *pxTCB;
 	{
 	UBaseType_t uxQueue = configMAX_PRIORITIES;
 	TCB_t* pxTCB;
+	#if( configUSE_DELAYED_TASK_WHEEL == 1 )
+		UBaseType_t uxSlot;
+	#endif
 
 		/* Task names will be truncated to configMAX_TASK_NAME_LEN - 1 bytes. */
 		configASSERT( strlen( pcNameToQuery ) < configMAX_TASK_NAME_LEN );
@@ -2433,6 +2501,15 @@ TCB_t *pxTCB;
 				pxTCB = prvSearchForNameWithinSingleList( ( List_t * ) pxOverflowDelayedTaskList, pcNameToQuery );
 			}
 
+			#if( configUSE_DELAYED_TASK_WHEEL == 1 )
+			{
+				for( uxSlot = ( UBaseType_t ) 0U; ( uxSlot < ( UBaseType_t ) configDELAYED_TASK_WHEEL_SIZE ) && ( pxTCB == NULL ); uxSlot++ )
+				{
+					pxTCB = prvSearchForNameWithinSingleList( &( xDelayedTaskWheel[ uxSlot ] ), pcNameToQuery );
+				}
+			}
+			#endif
+
 			#if ( INCLUDE_vTaskSuspend == 1 )
 			{
 				if( pxTCB == NULL )
@@ -2466,6 +2543,9 @@ TCB_t *pxTCB;
 	UBaseType_t uxTaskGetSystemState( TaskStatus_t * const pxTaskStatusArray, const UBaseType_t uxArraySize, uint32_t * const pulTotalRunTime )
 	{
 	UBaseType_t uxTask = 0, uxQueue = configMAX_PRIORITIES;
+	#if( configUSE_DELAYED_TASK_WHEEL == 1 )
+		UBaseType_t uxSlot;
+	#endif
 
 		vTaskSuspendAll();
 		{
@@ -2486,6 +2566,15 @@ TCB_t *pxTCB;
 				uxTask += prvListTasksWithinSingleList( &( pxTaskStatusArray[ uxTask ] ), ( List_t * ) pxDelayedTaskList, eBlocked );
 				uxTask += prvListTasksWithinSingleList( &( pxTaskStatusArray[ uxTask ] ), ( List_t * ) pxOverflowDelayedTaskList, eBlocked );
 
+				#if( configUSE_DELAYED_TASK_WHEEL == 1 )
+				{
+					for( uxSlot = ( UBaseType_t ) 0U; uxSlot < ( UBaseType_t ) configDELAYED_TASK_WHEEL_SIZE; uxSlot++ )
+					{
+						uxTask += prvListTasksWithinSingleList( &( pxTaskStatusArray[ uxTask ] ), &( xDelayedTaskWheel[ uxSlot ] ), eBlocked );
+					}
+				}
+				#endif
+
 				#if( INCLUDE_vTaskDelete == 1 )
 				{
 					/* Fill in an TaskStatus_t structure with information on
@@ -2678,6 +2767,42 @@ BaseType_t xSwitchRequired = pdFALSE;
 		look any further down the list. */
 		if( xConstTickCount >= xNextTaskUnblockTime )
 		{
+			#if( configUSE_DELAYED_TASK_WHEEL == 1 )
+			{
+				/* Tasks held in the wheel are found by their wake time rather
+				than by walking a list.  xNextDelayedTaskWheelTime is normally
+				this tick, but can be the previous tick if vTaskStepTick()
+				moved the tick count directly onto a wake time, so both slots
+				are emptied. */
+				if( xConstTickCount >= xNextDelayedTaskWheelTime )
+				{
+					if( prvUnblockDelayedTaskWheelSlot( xNextDelayedTaskWheelTime ) != pdFALSE )
+					{
+						xSwitchRequired = pdTRUE;
+					}
+					else
+					{
+						mtCOVERAGE_TEST_MARKER();
+					}
+
+					if( prvUnblockDelayedTaskWheelSlot( xConstTickCount ) != pdFALSE )
+					{
+						xSwitchRequired = pdTRUE;
+					}
+					else
+					{
+						mtCOVERAGE_TEST_MARKER();
+					}
+
+					xNextDelayedTaskWheelTime = prvGetNextDelayedTaskWheelTime();
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+			}
+			#endif /* configUSE_DELAYED_TASK_WHEEL */
+
 			for( ;; )
 			{
 				if( listLIST_IS_EMPTY( pxDelayedTaskList ) != pdFALSE )
@@ -2752,6 +2877,20 @@ BaseType_t xSwitchRequired = pdFALSE;
 					#endif /* configUSE_PREEMPTION */
 				}
 			}
+
+			#if( configUSE_DELAYED_TASK_WHEEL == 1 )
+			{
+				/* The loop above only considered the sorted delayed list. */
+				if( xNextDelayedTaskWheelTime < xNextTaskUnblockTime )
+				{
+					xNextTaskUnblockTime = xNextDelayedTaskWheelTime;
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+			}
+			#endif /* configUSE_DELAYED_TASK_WHEEL */
 		}
 
 		/* Tasks of equal priority to the currently running task will share
@@ -3507,6 +3646,9 @@ static portTASK_FUNCTION( prvIdleTask, pvParameters )
 static void prvInitialiseTaskLists( void )
 {
 UBaseType_t uxPriority;
+#if( configUSE_DELAYED_TASK_WHEEL == 1 )
+	UBaseType_t uxSlot;
+#endif
 
 	for( uxPriority = ( UBaseType_t ) 0U; uxPriority < ( UBaseType_t ) configMAX_PRIORITIES; uxPriority++ )
 	{
@@ -3517,6 +3659,17 @@ UBaseType_t uxPriority;
 	vListInitialise( &xDelayedTaskList2 );
 	vListInitialise( &xPendingReadyList );
 
+	#if( configUSE_DELAYED_TASK_WHEEL == 1 )
+	{
+		for( uxSlot = ( UBaseType_t ) 0U; uxSlot < ( UBaseType_t ) configDELAYED_TASK_WHEEL_SIZE; uxSlot++ )
+		{
+			vListInitialise( &( xDelayedTaskWheel[ uxSlot ] ) );
+		}
+
+		xNextDelayedTaskWheelTime = portMAX_DELAY;
+	}
+	#endif /* configUSE_DELAYED_TASK_WHEEL */
+
 	#if ( INCLUDE_vTaskDelete == 1 )
 	{
 		vListInitialise( &xTasksWaitingTermination );
@@ -3819,9 +3972,149 @@ TCB_t *pxTCB;
 		( pxTCB ) = ( TCB_t * ) listGET_OWNER_OF_HEAD_ENTRY( pxDelayedTaskList );
 		xNextTaskUnblockTime = listGET_LIST_ITEM_VALUE( &( ( pxTCB )->xStateListItem ) );
 	}
+
+	#if( configUSE_DELAYED_TASK_WHEEL == 1 )
+	{
+		/* The wheel may hold a task that is due to wake before the task at the
+		head of the delayed list. */
+		xNextDelayedTaskWheelTime = prvGetNextDelayedTaskWheelTime();
+
+		if( xNextDelayedTaskWheelTime < xNextTaskUnblockTime )
+		{
+			xNextTaskUnblockTime = xNextDelayedTaskWheelTime;
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+	#endif /* configUSE_DELAYED_TASK_WHEEL */
 }
 /*-----------------------------------------------------------*/
 
+#if( configUSE_DELAYED_TASK_WHEEL == 1 )
+
+	static void prvAddCurrentTaskToDelayedTaskWheel( const TickType_t xTimeToWake, const TickType_t xConstTickCount )
+	{
+		/* Appending to the slot takes the same time however many tasks are
+		blocked.  The list item value still holds the wake time so the task can
+		be moved between lists in the same way as a task in a delayed list. */
+		vListInsertEnd( &( xDelayedTaskWheel[ xTimeToWake & taskDELAYED_TASK_WHEEL_MASK ] ), &( pxCurrentTCB->xStateListItem ) );
+
+		/* A wake time that has overflowed is not considered until the tick
+		count overflows too, in the same way as the overflow delayed list. */
+		if( xTimeToWake > xConstTickCount )
+		{
+			if( xTimeToWake < xNextDelayedTaskWheelTime )
+			{
+				xNextDelayedTaskWheelTime = xTimeToWake;
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+
+			if( xTimeToWake < xNextTaskUnblockTime )
+			{
+				xNextTaskUnblockTime = xTimeToWake;
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+	/*-----------------------------------------------------------*/
+
+	static TickType_t prvGetNextDelayedTaskWheelTime( void )
+	{
+	const TickType_t xConstTickCount = xTickCount;
+	TickType_t xTime = xConstTickCount;
+	TickType_t xReturn = portMAX_DELAY;
+	UBaseType_t uxSlotsChecked;
+
+		/* Every wake time held in the wheel is within
+		configDELAYED_TASK_WHEEL_SIZE ticks of the tick count, so the slots are
+		checked in wake time order starting from the slot of the current tick.
+		That slot can only be occupied if vTaskStepTick() moved the tick count
+		onto a wake time that has not been processed yet.  The search stops at
+		the first wake time that overflows the tick count. */
+		for( uxSlotsChecked = ( UBaseType_t ) 0U; uxSlotsChecked < ( UBaseType_t ) configDELAYED_TASK_WHEEL_SIZE; uxSlotsChecked++ )
+		{
+			if( xTime < xConstTickCount )
+			{
+				break;
+			}
+			else if( listLIST_IS_EMPTY( &( xDelayedTaskWheel[ xTime & taskDELAYED_TASK_WHEEL_MASK ] ) ) == pdFALSE )
+			{
+				xReturn = xTime;
+				break;
+			}
+			else
+			{
+				xTime++;
+			}
+		}
+
+		return xReturn;
+	}
+	/*-----------------------------------------------------------*/
+
+	static BaseType_t prvUnblockDelayedTaskWheelSlot( const TickType_t xTimeToWake )
+	{
+	List_t * const pxSlot = &( xDelayedTaskWheel[ xTimeToWake & taskDELAYED_TASK_WHEEL_MASK ] );
+	TCB_t *pxTCB;
+	BaseType_t xSwitchRequired = pdFALSE;
+
+		/* All the tasks in the slot share the same wake time, so they are all
+		unblocked, in the order in which they entered the Blocked state. */
+		while( listLIST_IS_EMPTY( pxSlot ) == pdFALSE )
+		{
+			pxTCB = ( TCB_t * ) listGET_OWNER_OF_HEAD_ENTRY( pxSlot );
+			configASSERT( listGET_LIST_ITEM_VALUE( &( pxTCB->xStateListItem ) ) == xTimeToWake );
+
+			( void ) uxListRemove( &( pxTCB->xStateListItem ) );
+
+			/* Is the task waiting on an event also?  If so remove it from the
+			event list. */
+			if( listLIST_ITEM_CONTAINER( &( pxTCB->xEventListItem ) ) != NULL )
+			{
+				( void ) uxListRemove( &( pxTCB->xEventListItem ) );
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+
+			prvAddTaskToReadyList( pxTCB );
+
+			#if (  configUSE_PREEMPTION == 1 )
+			{
+				/* A context switch should only be performed if the unblocked
+				task has a priority that is equal to or higher than the
+				currently executing task. */
+				if( pxTCB->uxPriority >= pxCurrentTCB->uxPriority )
+				{
+					xSwitchRequired = pdTRUE;
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+			}
+			#endif /* configUSE_PREEMPTION */
+		}
+
+		return xSwitchRequired;
+	}
+
+#endif /* configUSE_DELAYED_TASK_WHEEL */
+/*-----------------------------------------------------------*/
+
 #if ( ( INCLUDE_xTaskGetCurrentTaskHandle == 1 ) || ( configUSE_MUTEXES == 1 ) )
 
 	TaskHandle_t xTaskGetCurrentTaskHandle( void )
@@ -4483,17 +4776,19 @@ TickType_t uxReturn;
 
 #if( configUSE_TASK_NOTIFICATIONS == 1 )
 
-	uint32_t ulTaskNotifyTake( BaseType_t xClearCountOnExit, TickType_t xTicksToWait )
+	uint32_t ulTaskGenericNotifyTake( UBaseType_t uxIndexToWait, BaseType_t xClearCountOnExit, TickType_t xTicksToWait )
 	{
 	uint32_t ulReturn;
 
+		configASSERT( uxIndexToWait < configTASK_NOTIFICATION_ARRAY_ENTRIES );
+
 		taskENTER_CRITICAL();
 		{
 			/* Only block if the notification count is not already non-zero. */
-			if( pxCurrentTCB->ulNotifiedValue == 0UL )
+			if( pxCurrentTCB->ulNotifiedValue[ uxIndexToWait ] == 0UL )
 			{
 				/* Mark this task as waiting for a notification. */
-				pxCurrentTCB->ucNotifyState = taskWAITING_NOTIFICATION;
+				pxCurrentTCB->ucNotifyState[ uxIndexToWait ] = taskWAITING_NOTIFICATION;
 
 				if( xTicksToWait > ( TickType_t ) 0 )
 				{
@@ -4521,17 +4816,17 @@ TickType_t uxReturn;
 		taskENTER_CRITICAL();
 		{
 			traceTASK_NOTIFY_TAKE();
-			ulReturn = pxCurrentTCB->ulNotifiedValue;
+			ulReturn = pxCurrentTCB->ulNotifiedValue[ uxIndexToWait ];
 
 			if( ulReturn != 0UL )
 			{
 				if( xClearCountOnExit != pdFALSE )
 				{
-					pxCurrentTCB->ulNotifiedValue = 0UL;
+					pxCurrentTCB->ulNotifiedValue[ uxIndexToWait ] = 0UL;
 				}
 				else
 				{
-					pxCurrentTCB->ulNotifiedValue = ulReturn - ( uint32_t ) 1;
+					pxCurrentTCB->ulNotifiedValue[ uxIndexToWait ] = ulReturn - ( uint32_t ) 1;
 				}
 			}
 			else
@@ -4539,7 +4834,7 @@ TickType_t uxReturn;
 				mtCOVERAGE_TEST_MARKER();
 			}
 
-			pxCurrentTCB->ucNotifyState = taskNOT_WAITING_NOTIFICATION;
+			pxCurrentTCB->ucNotifyState[ uxIndexToWait ] = taskNOT_WAITING_NOTIFICATION;
 		}
 		taskEXIT_CRITICAL();
 
@@ -4551,22 +4846,24 @@ TickType_t uxReturn;
 
 #if( configUSE_TASK_NOTIFICATIONS == 1 )
 
-	BaseType_t xTaskNotifyWait( uint32_t ulBitsToClearOnEntry, uint32_t ulBitsToClearOnExit, uint32_t *pulNotificationValue, TickType_t xTicksToWait )
+	BaseType_t xTaskGenericNotifyWait( UBaseType_t uxIndexToWait, uint32_t ulBitsToClearOnEntry, uint32_t ulBitsToClearOnExit, uint32_t *pulNotificationValue, TickType_t xTicksToWait )
 	{
 	BaseType_t xReturn;
 
+		configASSERT( uxIndexToWait < configTASK_NOTIFICATION_ARRAY_ENTRIES );
+
 		taskENTER_CRITICAL();
 		{
 			/* Only block if a notification is not already pending. */
-			if( pxCurrentTCB->ucNotifyState != taskNOTIFICATION_RECEIVED )
+			if( pxCurrentTCB->ucNotifyState[ uxIndexToWait ] != taskNOTIFICATION_RECEIVED )
 			{
 				/* Clear bits in the task's notification value as bits may get
 				set	by the notifying task or interrupt.  This can be used to
 				clear the value to zero. */
-				pxCurrentTCB->ulNotifiedValue &= ~ulBitsToClearOnEntry;
+				pxCurrentTCB->ulNotifiedValue[ uxIndexToWait ] &= ~ulBitsToClearOnEntry;
 
 				/* Mark this task as waiting for a notification. */
-				pxCurrentTCB->ucNotifyState = taskWAITING_NOTIFICATION;
+				pxCurrentTCB->ucNotifyState[ uxIndexToWait ] = taskWAITING_NOTIFICATION;
 
 				if( xTicksToWait > ( TickType_t ) 0 )
 				{
@@ -4599,14 +4896,14 @@ TickType_t uxReturn;
 			{
 				/* Output the current notification value, which may or may not
 				have changed. */
-				*pulNotificationValue = pxCurrentTCB->ulNotifiedValue;
+				*pulNotificationValue = pxCurrentTCB->ulNotifiedValue[ uxIndexToWait ];
 			}
 
 			/* If ucNotifyValue is set then either the task never entered the
 			blocked state (because a notification was already pending) or the
 			task unblocked because of a notification.  Otherwise the task
 			unblocked because of a timeout. */
-			if( pxCurrentTCB->ucNotifyState != taskNOTIFICATION_RECEIVED )
+			if( pxCurrentTCB->ucNotifyState[ uxIndexToWait ] != taskNOTIFICATION_RECEIVED )
 			{
 				/* A notification was not received. */
 				xReturn = pdFALSE;
@@ -4615,11 +4912,11 @@ TickType_t uxReturn;
 			{
 				/* A notification was already pending or a notification was
 				received while the task was waiting. */
-				pxCurrentTCB->ulNotifiedValue &= ~ulBitsToClearOnExit;
+				pxCurrentTCB->ulNotifiedValue[ uxIndexToWait ] &= ~ulBitsToClearOnExit;
 				xReturn = pdTRUE;
 			}
 
-			pxCurrentTCB->ucNotifyState = taskNOT_WAITING_NOTIFICATION;
+			pxCurrentTCB->ucNotifyState[ uxIndexToWait ] = taskNOT_WAITING_NOTIFICATION;
 		}
 		taskEXIT_CRITICAL();
 
@@ -4631,12 +4928,13 @@ TickType_t uxReturn;
 
 #if( configUSE_TASK_NOTIFICATIONS == 1 )
 
-	BaseType_t xTaskGenericNotify( TaskHandle_t xTaskToNotify, uint32_t ulValue, eNotifyAction eAction, uint32_t *pulPreviousNotificationValue )
+	BaseType_t xTaskGenericNotify( TaskHandle_t xTaskToNotify, UBaseType_t uxIndexToNotify, uint32_t ulValue, eNotifyAction eAction, uint32_t *pulPreviousNotificationValue )
 	{
 	TCB_t * pxTCB;
 	BaseType_t xReturn = pdPASS;
 	uint8_t ucOriginalNotifyState;
 
+		configASSERT( uxIndexToNotify < configTASK_NOTIFICATION_ARRAY_ENTRIES );
 		configASSERT( xTaskToNotify );
 		pxTCB = ( TCB_t * ) xTaskToNotify;
 
@@ -4644,31 +4942,31 @@ TickType_t uxReturn;
 		{
 			if( pulPreviousNotificationValue != NULL )
 			{
-				*pulPreviousNotificationValue = pxTCB->ulNotifiedValue;
+				*pulPreviousNotificationValue = pxTCB->ulNotifiedValue[ uxIndexToNotify ];
 			}
 
-			ucOriginalNotifyState = pxTCB->ucNotifyState;
+			ucOriginalNotifyState = pxTCB->ucNotifyState[ uxIndexToNotify ];
 
-			pxTCB->ucNotifyState = taskNOTIFICATION_RECEIVED;
+			pxTCB->ucNotifyState[ uxIndexToNotify ] = taskNOTIFICATION_RECEIVED;
 
 			switch( eAction )
 			{
 				case eSetBits	:
-					pxTCB->ulNotifiedValue |= ulValue;
+					pxTCB->ulNotifiedValue[ uxIndexToNotify ] |= ulValue;
 					break;
 
 				case eIncrement	:
-					( pxTCB->ulNotifiedValue )++;
+					( pxTCB->ulNotifiedValue[ uxIndexToNotify ] )++;
 					break;
 
 				case eSetValueWithOverwrite	:
-					pxTCB->ulNotifiedValue = ulValue;
+					pxTCB->ulNotifiedValue[ uxIndexToNotify ] = ulValue;
 					break;
 
 				case eSetValueWithoutOverwrite :
 					if( ucOriginalNotifyState != taskNOTIFICATION_RECEIVED )
 					{
-						pxTCB->ulNotifiedValue = ulValue;
+						pxTCB->ulNotifiedValue[ uxIndexToNotify ] = ulValue;
 					}
 					else
 					{
@@ -4737,13 +5035,14 @@ TickType_t uxReturn;
 
 #if( configUSE_TASK_NOTIFICATIONS == 1 )
 
-	BaseType_t xTaskGenericNotifyFromISR( TaskHandle_t xTaskToNotify, uint32_t ulValue, eNotifyAction eAction, uint32_t *pulPreviousNotificationValue, BaseType_t *pxHigherPriorityTaskWoken )
+	BaseType_t xTaskGenericNotifyFromISR( TaskHandle_t xTaskToNotify, UBaseType_t uxIndexToNotify, uint32_t ulValue, eNotifyAction eAction, uint32_t *pulPreviousNotificationValue, BaseType_t *pxHigherPriorityTaskWoken )
 	{
 	TCB_t * pxTCB;
 	uint8_t ucOriginalNotifyState;
 	BaseType_t xReturn = pdPASS;
 	UBaseType_t uxSavedInterruptStatus;
 
+		configASSERT( uxIndexToNotify < configTASK_NOTIFICATION_ARRAY_ENTRIES );
 		configASSERT( xTaskToNotify );
 
 		/* RTOS ports that support interrupt nesting have the concept of a
@@ -4770,30 +5069,30 @@ TickType_t uxReturn;
 		{
 			if( pulPreviousNotificationValue != NULL )
 			{
-				*pulPreviousNotificationValue = pxTCB->ulNotifiedValue;
+				*pulPreviousNotificationValue = pxTCB->ulNotifiedValue[ uxIndexToNotify ];
 			}
 
-			ucOriginalNotifyState = pxTCB->ucNotifyState;
-			pxTCB->ucNotifyState = taskNOTIFICATION_RECEIVED;
+			ucOriginalNotifyState = pxTCB->ucNotifyState[ uxIndexToNotify ];
+			pxTCB->ucNotifyState[ uxIndexToNotify ] = taskNOTIFICATION_RECEIVED;
 
 			switch( eAction )
 			{
 				case eSetBits	:
-					pxTCB->ulNotifiedValue |= ulValue;
+					pxTCB->ulNotifiedValue[ uxIndexToNotify ] |= ulValue;
 					break;
 
 				case eIncrement	:
-					( pxTCB->ulNotifiedValue )++;
+					( pxTCB->ulNotifiedValue[ uxIndexToNotify ] )++;
 					break;
 
 				case eSetValueWithOverwrite	:
-					pxTCB->ulNotifiedValue = ulValue;
+					pxTCB->ulNotifiedValue[ uxIndexToNotify ] = ulValue;
 					break;
 
 				case eSetValueWithoutOverwrite :
 					if( ucOriginalNotifyState != taskNOTIFICATION_RECEIVED )
 					{
-						pxTCB->ulNotifiedValue = ulValue;
+						pxTCB->ulNotifiedValue[ uxIndexToNotify ] = ulValue;
 					}
 					else
 					{
@@ -4861,12 +5160,13 @@ TickType_t uxReturn;
 
 #if( configUSE_TASK_NOTIFICATIONS == 1 )
 
-	void vTaskNotifyGiveFromISR( TaskHandle_t xTaskToNotify, BaseType_t *pxHigherPriorityTaskWoken )
+	void vTaskGenericNotifyGiveFromISR( TaskHandle_t xTaskToNotify, UBaseType_t uxIndexToNotify, BaseType_t *pxHigherPriorityTaskWoken )
 	{
 	TCB_t * pxTCB;
 	uint8_t ucOriginalNotifyState;
 	UBaseType_t uxSavedInterruptStatus;
 
+		configASSERT( uxIndexToNotify < configTASK_NOTIFICATION_ARRAY_ENTRIES );
 		configASSERT( xTaskToNotify );
 
 		/* RTOS ports that support interrupt nesting have the concept of a
@@ -4891,12 +5191,12 @@ TickType_t uxReturn;
 
 		uxSavedInterruptStatus = portSET_INTERRUPT_MASK_FROM_ISR();
 		{
-			ucOriginalNotifyState = pxTCB->ucNotifyState;
-			pxTCB->ucNotifyState = taskNOTIFICATION_RECEIVED;
+			ucOriginalNotifyState = pxTCB->ucNotifyState[ uxIndexToNotify ];
+			pxTCB->ucNotifyState[ uxIndexToNotify ] = taskNOTIFICATION_RECEIVED;
 
 			/* 'Giving' is equivalent to incrementing a count in a counting
 			semaphore. */
-			( pxTCB->ulNotifiedValue )++;
+			( pxTCB->ulNotifiedValue[ uxIndexToNotify ] )++;
 
 			traceTASK_NOTIFY_GIVE_FROM_ISR();
 
@@ -4950,20 +5250,22 @@ TickType_t uxReturn;
 
 #if( configUSE_TASK_NOTIFICATIONS == 1 )
 
-	BaseType_t xTaskNotifyStateClear( TaskHandle_t xTask )
+	BaseType_t xTaskGenericNotifyStateClear( TaskHandle_t xTask, UBaseType_t uxIndexToClear )
 	{
 	TCB_t *pxTCB;
 	BaseType_t xReturn;
 
+		configASSERT( uxIndexToClear < configTASK_NOTIFICATION_ARRAY_ENTRIES );
+
 		/* If null is passed in here then it is the calling task that is having
 		its notification state cleared. */
 		pxTCB = prvGetTCBFromHandle( xTask );
 
 		taskENTER_CRITICAL();
 		{
-			if( pxTCB->ucNotifyState == taskNOTIFICATION_RECEIVED )
+			if( pxTCB->ucNotifyState[ uxIndexToClear ] == taskNOTIFICATION_RECEIVED )
 			{
-				pxTCB->ucNotifyState = taskNOT_WAITING_NOTIFICATION;
+				pxTCB->ucNotifyState[ uxIndexToClear ] = taskNOT_WAITING_NOTIFICATION;
 				xReturn = pdPASS;
 			}
 			else
@@ -4979,6 +5281,34 @@ TickType_t uxReturn;
 #endif /* configUSE_TASK_NOTIFICATIONS */
 /*-----------------------------------------------------------*/
 
+#if( configUSE_TASK_NOTIFICATIONS == 1 )
+
+	uint32_t ulTaskGenericNotifyValueClear( TaskHandle_t xTask, UBaseType_t uxIndexToClear, uint32_t ulBitsToClear )
+	{
+	TCB_t *pxTCB;
+	uint32_t ulReturn;
+
+		configASSERT( uxIndexToClear < configTASK_NOTIFICATION_ARRAY_ENTRIES );
+
+		/* If null is passed in here then it is the calling task that is having
+		its notification value cleared. */
+		pxTCB = prvGetTCBFromHandle( xTask );
+
+		taskENTER_CRITICAL();
+		{
+			/* Return the notification as it was before the bits were cleared,
+			then clear the bit mask. */
+			ulReturn = pxTCB->ulNotifiedValue[ uxIndexToClear ];
+			pxTCB->ulNotifiedValue[ uxIndexToClear ] &= ~ulBitsToClear;
+		}
+		taskEXIT_CRITICAL();
+
+		return ulReturn;
+	}
+
+#endif /* configUSE_TASK_NOTIFICATIONS */
+/*-----------------------------------------------------------*/
+
 
 static void prvAddCurrentTaskToDelayedList( TickType_t xTicksToWait, const BaseType_t xCanBlockIndefinitely )
 {
@@ -5026,6 +5356,14 @@ const TickType_t xConstTickCount = xTickCount;
 			/* The list item will be inserted in wake time order. */
 			listSET_LIST_ITEM_VALUE( &( pxCurrentTCB->xStateListItem ), xTimeToWake );
 
+			#if( configUSE_DELAYED_TASK_WHEEL == 1 )
+				if( ( xTicksToWait != ( TickType_t ) 0 ) && ( xTicksToWait <= taskDELAYED_TASK_WHEEL_MASK ) )
+				{
+					/* The task will wake within the horizon of the wheel. */
+					prvAddCurrentTaskToDelayedTaskWheel( xTimeToWake, xConstTickCount );
+				}
+				else
+			#endif
 			if( xTimeToWake < xConstTickCount )
 			{
 				/* Wake time has overflowed.  Place this item in the overflow
@@ -5062,6 +5400,14 @@ const TickType_t xConstTickCount = xTickCount;
 		/* The list item will be inserted in wake time order. */
 		listSET_LIST_ITEM_VALUE( &( pxCurrentTCB->xStateListItem ), xTimeToWake );
 
+		#if( configUSE_DELAYED_TASK_WHEEL == 1 )
+			if( ( xTicksToWait != ( TickType_t ) 0 ) && ( xTicksToWait <= taskDELAYED_TASK_WHEEL_MASK ) )
+			{
+				/* The task will wake within the horizon of the wheel. */
+				prvAddCurrentTaskToDelayedTaskWheel( xTimeToWake, xConstTickCount );
+			}
+			else
+		#endif
 		if( xTimeToWake < xConstTickCount )
 		{
 			/* Wake time has overflowed.  Place this item in the overflow list. */
@@ -57,6 +57,8 @@ CBORHandle_t CBOR_New( cbor_ssize_t xSize )
     xNewCborData->pxCursor = pxNew_buffer;
     xNewCborData->pxBufferEnd = &pxNew_buffer[ xSize - 1 ];
     xNewCborData->pxMapEnd = &pxNew_buffer[ 1 ];
+    xNewCborData->xError = eCborErrNoError;
+    CBOR_InvalidateKeyIndex( xNewCborData );
 
     return xNewCborData;
 }
@@ -103,14 +105,10 @@ bool CBOR_FindKey( CBORHandle_t xCborData,
         return false;
     }
 
-    ( xCborData->pxCursor ) = ( xCborData->pxBufferStart );
-    CBOR_OpenMap( xCborData );
-    CBOR_SearchForKey( xCborData, pcKey );
-    bool xFound = false;
+    bool xFound = CBOR_IndexedSearchForKey( xCborData, pcKey );
 
-    if( CBOR_KeyIsMatch( xCborData, pcKey ) )
+    if( xFound )
     {
-        xFound = true;
         CBOR_Next( xCborData );
     }
 
@@ -0,0 +1,218 @@
+/*
+ * Amazon FreeRTOS CBOR Library V1.0.1
+ * Copyright (C) 2018 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+#include "aws_cbor_internals.h"
+#include <assert.h>
+
+/** Marks an unused slot in the key index */
+#define CBOR_KEY_INDEX_EMPTY       ( -1 )
+
+/** Maximum number of keys indexed, keeps probe sequences short */
+#define CBOR_KEY_INDEX_MAX_KEYS    ( ( CBOR_KEY_INDEX_SLOTS * 3 ) / 4 )
+
+/** FNV-1a 32-bit offset basis */
+#define CBOR_FNV_OFFSET_BASIS      ( 2166136261UL )
+
+/** FNV-1a 32-bit prime */
+#define CBOR_FNV_PRIME             ( 16777619UL )
+
+/**
+ * @brief Feeds one byte into an FNV-1a hash
+ */
+static uint32_t CBOR_HashByte( uint32_t ulHash,
+                               cbor_byte_t xByte )
+{
+    ulHash ^= xByte;
+    ulHash *= CBOR_FNV_PRIME;
+
+    return ulHash;
+}
+
+/**
+ * @brief Folds a 32-bit hash into the 16 bits stored in the key index
+ */
+static uint16_t CBOR_FoldHash( uint32_t ulHash )
+{
+    return ( uint16_t ) ( ( ulHash >> 16 ) ^ ( ulHash & UINT16_MAX ) );
+}
+
+/**
+ * @brief Hashes a zero terminated string
+ */
+static uint16_t CBOR_HashString( const char * pcKey )
+{
+    uint32_t ulHash = CBOR_FNV_OFFSET_BASIS;
+
+    while( '\0' != *pcKey )
+    {
+        ulHash = CBOR_HashByte( ulHash, ( cbor_byte_t ) *pcKey++ );
+    }
+
+    return CBOR_FoldHash( ulHash );
+}
+
+/**
+ * @brief Hashes the CBOR string data item at the pointer
+ *
+ * Produces the same hash as CBOR_HashString() for the same characters.
+ */
+static uint16_t CBOR_HashKeyAtPtr( const cbor_byte_t * pxPtr )
+{
+    assert( NULL != pxPtr );
+
+    cbor_byte_t xAdditional_info = *pxPtr & CBOR_ADDITIONAL_DATA_MASK;
+    cbor_ssize_t xHeader_size = CBOR_SMALL_INT_SIZE;
+
+    if( CBOR_INT8_FOLLOWS == xAdditional_info )
+    {
+        xHeader_size = CBOR_INT8_SIZE;
+    }
+    else if( CBOR_INT16_FOLLOWS == xAdditional_info )
+    {
+        xHeader_size = CBOR_INT16_SIZE;
+    }
+
+    cbor_ssize_t xLength = CBOR_StringSize( pxPtr ) - xHeader_size;
+    uint32_t ulHash = CBOR_FNV_OFFSET_BASIS;
+
+    pxPtr += xHeader_size;
+
+    for( cbor_ssize_t xI = 0; xI < xLength; xI++ )
+    {
+        ulHash = CBOR_HashByte( ulHash, *pxPtr++ );
+    }
+
+    return CBOR_FoldHash( ulHash );
+}
+
+/**
+ * @brief Walks the top level of the map once and records each key
+ *
+ * Keys are inserted with linear probing in map order, so a lookup finds the
+ * first of any duplicated keys, matching CBOR_SearchForKey().
+ */
+static void CBOR_BuildKeyIndex( CBORHandle_t xCborData )
+{
+    assert( NULL != xCborData );
+
+    for( cbor_ssize_t xI = 0; xI < CBOR_KEY_INDEX_SLOTS; xI++ )
+    {
+        xCborData->xKeyIndex[ xI ].xKeyOffset = CBOR_KEY_INDEX_EMPTY;
+    }
+
+    xCborData->ucKeyIndexState = eCborKeyIndexUnusable;
+    xCborData->xKeyIndexMapEnd =
+        xCborData->pxMapEnd - xCborData->pxBufferStart;
+
+    const cbor_byte_t * pxPtr = xCborData->pxBufferStart;
+
+    if( CBOR_MAP_OPEN != *pxPtr )
+    {
+        return;
+    }
+
+    pxPtr = CBOR_NextPtr( pxPtr );
+    cbor_ssize_t xKey_count = 0;
+
+    while( CBOR_BREAK != *pxPtr )
+    {
+        cbor_byte_t xMajor_type = *pxPtr & CBOR_MAJOR_TYPE_MASK;
+
+        if( ( CBOR_STRING != xMajor_type ) ||
+            ( CBOR_KEY_INDEX_MAX_KEYS < ++xKey_count ) )
+        {
+            return;
+        }
+
+        uint16_t usHash = CBOR_HashKeyAtPtr( pxPtr );
+        cbor_ssize_t xSlot = usHash % CBOR_KEY_INDEX_SLOTS;
+
+        while( CBOR_KEY_INDEX_EMPTY != xCborData->xKeyIndex[ xSlot ].xKeyOffset )
+        {
+            xSlot = ( xSlot + 1 ) % CBOR_KEY_INDEX_SLOTS;
+        }
+
+        xCborData->xKeyIndex[ xSlot ].xKeyOffset =
+            pxPtr - xCborData->pxBufferStart;
+        xCborData->xKeyIndex[ xSlot ].usHash = usHash;
+
+        pxPtr = CBOR_NextKeyPtr( pxPtr );
+    }
+
+    xCborData->ucKeyIndexState = eCborKeyIndexValid;
+}
+
+void CBOR_InvalidateKeyIndex( CBORHandle_t xCborData )
+{
+    assert( NULL != xCborData );
+
+    xCborData->ucKeyIndexState = eCborKeyIndexInvalid;
+}
+
+bool CBOR_IndexedSearchForKey( CBORHandle_t xCborData,
+                               const char * pcKey )
+{
+    assert( NULL != xCborData );
+    assert( NULL != pcKey );
+
+    /* Writes made by the caller directly into the buffer do not pass through
+     * CBOR_InvalidateKeyIndex(), but do move the map end. */
+    if( ( eCborKeyIndexInvalid == xCborData->ucKeyIndexState ) ||
+        ( xCborData->xKeyIndexMapEnd !=
+          xCborData->pxMapEnd - xCborData->pxBufferStart ) )
+    {
+        CBOR_BuildKeyIndex( xCborData );
+    }
+
+    if( eCborKeyIndexValid != xCborData->ucKeyIndexState )
+    {
+        xCborData->pxCursor = CBOR_NextPtr( xCborData->pxBufferStart );
+        CBOR_SearchForKey( xCborData, pcKey );
+
+        return CBOR_KeyIsMatch( xCborData, pcKey );
+    }
+
+    uint16_t usHash = CBOR_HashString( pcKey );
+    cbor_ssize_t xSlot = usHash % CBOR_KEY_INDEX_SLOTS;
+
+    while( CBOR_KEY_INDEX_EMPTY != xCborData->xKeyIndex[ xSlot ].xKeyOffset )
+    {
+        if( usHash == xCborData->xKeyIndex[ xSlot ].usHash )
+        {
+            xCborData->pxCursor = xCborData->pxBufferStart +
+                                  xCborData->xKeyIndex[ xSlot ].xKeyOffset;
+
+            if( CBOR_KeyIsMatch( xCborData, pcKey ) )
+            {
+                return true;
+            }
+        }
+
+        xSlot = ( xSlot + 1 ) % CBOR_KEY_INDEX_SLOTS;
+    }
+
+    xCborData->pxCursor = xCborData->pxMapEnd;
+
+    return false;
+}
@@ -0,0 +1,75 @@
+/*
+ * Amazon FreeRTOS
+ * Copyright (C) 2018 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+#ifndef AWS_CBOR_INDEX_H
+#define AWS_CBOR_INDEX_H
+
+/**
+ * @file
+ * @brief Key index for O(1) average lookup of top level map keys
+ *
+ * The index is built lazily on the first lookup after a write.  It stores the
+ * offset and hash of each top level key, so repeated reads from the same
+ * handle do not walk the map again.
+ */
+
+#include "aws_cbor.h"
+#include <stdbool.h>
+
+/**
+ * @brief States of the key index
+ */
+typedef enum
+{
+    /** Index must be rebuilt before use */
+    eCborKeyIndexInvalid = 0,
+    /** Index holds every top level key in the map */
+    eCborKeyIndexValid,
+    /** Map cannot be indexed (too many keys or non-string keys) */
+    eCborKeyIndexUnusable,
+} cborKeyIndexState_t;
+
+/**
+ * @brief Marks the key index as stale
+ *
+ * Called on every write to the CBOR buffer.
+ *
+ * @param CBORHandle_t Handle for the CBOR data struct.
+ */
+void CBOR_InvalidateKeyIndex( CBORHandle_t /*xCborData*/ );
+
+/**
+ * @brief Searches for a top level key, using the key index when possible
+ *
+ * Leaves the cursor pointing at the key if it is found, or at the end of the
+ * map otherwise.  Falls back to CBOR_SearchForKey() if the map can not be
+ * indexed.
+ *
+ * @param CBORHandle_t Handle for the CBOR data struct.
+ * @param "const char *" Key to search for
+ * @return True if the key was found
+ */
+bool CBOR_IndexedSearchForKey( CBORHandle_t /*xCborData*/, const char * /*key*/ );
+
+#endif /* end of include guard: AWS_CBOR_INDEX_H */
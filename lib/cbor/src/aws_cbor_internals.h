@@ -32,6 +32,7 @@
  */
 
 #include "aws_cbor_alloc.h"
+#include "aws_cbor_index.h"
 #include "aws_cbor_int.h"
 #include "aws_cbor_iter.h"
 #include "aws_cbor_jump_table.h"
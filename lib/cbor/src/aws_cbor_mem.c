@@ -153,6 +153,7 @@ void CBOR_AssignAndIncrementCursor( CBORHandle_t xCborData,
 
     *( xCborData->pxCursor )++ = xInput;
     ( xCborData->xError ) = eCborErrNoError;
+    CBOR_InvalidateKeyIndex( xCborData );
 }
 
 void CBOR_AssignAndDecrementCursor( CBORHandle_t xCborData,
@@ -173,6 +174,7 @@ void CBOR_AssignAndDecrementCursor( CBORHandle_t xCborData,
 
     *( xCborData->pxCursor )-- = xInput;
     ( xCborData->xError ) = eCborErrNoError;
+    CBOR_InvalidateKeyIndex( xCborData );
 }
 
 void CBOR_MemCopy( CBORHandle_t xCborData,
@@ -256,5 +258,6 @@ void CBOR_ValueResize( CBORHandle_t xCborData,
     xCborData->pxCursor = pxKey_position;
     CBOR_MemCopy( xCborData, pxNext_key, xRemaining_length );
     assert( eCborErrNoError == xCborData->xError );
+    xCborData->pxMapEnd = xCborData->pxCursor - 1;
     xCborData->pxCursor = pxCurrent_place;
 }
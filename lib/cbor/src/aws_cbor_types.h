@@ -33,6 +33,28 @@
 #include "aws_cbor.h"
 #include <stdint.h>
 
+/**
+ * @brief Number of slots in the key index hash table
+ *
+ * The key index is used by CBOR_FindKey() to look up top level keys without
+ * rescanning the map.  Maps with more keys than three quarters of the slots
+ * are searched linearly instead.
+ */
+#ifndef CBOR_KEY_INDEX_SLOTS
+    #define CBOR_KEY_INDEX_SLOTS    ( 16 )
+#endif
+
+/**
+ * @brief Entry in the key index hash table
+ */
+typedef struct CborKeyIndexEntry_s
+{
+    /** Offset of the key from the start of the CBOR buffer, or -1 if unused */
+    cbor_ssize_t xKeyOffset;
+    /** Hash of the key string */
+    uint16_t usHash;
+} CborKeyIndexEntry_t;
+
 /**
  * @brief Pointer to a CBOR Data Struct
  */
@@ -52,6 +74,16 @@ struct CborData_s
     cbor_byte_t * pxCursor;
     /** Current error code status */
     cborError_t xError;
+
+    /**
+     * State of the key index.  Any write to the buffer resets this to
+     * eCborKeyIndexInvalid, so the index is rebuilt on the next lookup. */
+    uint8_t ucKeyIndexState;
+
+    /** Offset of the map end when the key index was built */
+    cbor_ssize_t xKeyIndexMapEnd;
+    /** Hash table of the top level keys in the map */
+    CborKeyIndexEntry_t xKeyIndex[ CBOR_KEY_INDEX_SLOTS ];
 };
 
 #endif /* ifndef AWS_CBOR_TYPES_H */
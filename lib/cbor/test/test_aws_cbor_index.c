@@ -0,0 +1,211 @@
+/*
+ * Amazon FreeRTOS CBOR Library V1.0.0
+ * Copyright (C) 2018 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+#include "assert_override.h"
+#include "aws_cbor_internals.h"
+#include "unity_fixture.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+CBORHandle_t xCborData;
+
+TEST_GROUP( aws_cbor_index );
+
+TEST_SETUP( aws_cbor_index )
+{
+    xCborData = CBOR_New( 0 );
+}
+
+TEST_TEAR_DOWN( aws_cbor_index )
+{
+    CBOR_Delete( &xCborData );
+}
+
+TEST_GROUP_RUNNER( aws_cbor_index )
+{
+    RUN_TEST_CASE( aws_cbor_index, New_starts_with_invalid_index );
+    RUN_TEST_CASE( aws_cbor_index, FindKey_builds_index );
+    RUN_TEST_CASE( aws_cbor_index, FindKey_reads_every_key_through_index );
+    RUN_TEST_CASE( aws_cbor_index, FindKey_reuses_index_across_reads );
+    RUN_TEST_CASE( aws_cbor_index, FindKey_returns_false_and_points_at_map_end );
+    RUN_TEST_CASE( aws_cbor_index, Write_invalidates_index );
+    RUN_TEST_CASE( aws_cbor_index, FindKey_sees_value_written_after_index_built );
+    RUN_TEST_CASE( aws_cbor_index, FindKey_skips_nested_map_keys );
+    RUN_TEST_CASE( aws_cbor_index, FindKey_returns_first_duplicate_key );
+    RUN_TEST_CASE( aws_cbor_index, FindKey_falls_back_when_map_has_too_many_keys );
+    RUN_TEST_CASE( aws_cbor_index, FindKey_rebuilds_when_map_end_moved );
+}
+
+TEST( aws_cbor_index, New_starts_with_invalid_index )
+{
+    TEST_ASSERT_EQUAL( eCborKeyIndexInvalid, xCborData->ucKeyIndexState );
+}
+
+TEST( aws_cbor_index, FindKey_builds_index )
+{
+    CBOR_AppendKeyWithInt( xCborData, "answer", 42 );
+
+    TEST_ASSERT_TRUE( CBOR_FindKey( xCborData, "answer" ) );
+    TEST_ASSERT_EQUAL( eCborKeyIndexValid, xCborData->ucKeyIndexState );
+}
+
+TEST( aws_cbor_index, FindKey_reads_every_key_through_index )
+{
+    CBOR_AppendKeyWithString( xCborData, "hello", "world" );
+    CBOR_AppendKeyWithInt( xCborData, "answer", 42 );
+    CBOR_AppendKeyWithInt( xCborData, "prime", 1033 );
+    CBOR_AppendKeyWithString( xCborData, "a", "b" );
+
+    TEST_ASSERT_EQUAL( 1033, CBOR_FromKeyReadInt( xCborData, "prime" ) );
+    TEST_ASSERT_EQUAL( 42, CBOR_FromKeyReadInt( xCborData, "answer" ) );
+
+    char * pcValue = CBOR_FromKeyReadString( xCborData, "hello" );
+    TEST_ASSERT_EQUAL_STRING( "world", pcValue );
+    free( pcValue );
+
+    pcValue = CBOR_FromKeyReadString( xCborData, "a" );
+    TEST_ASSERT_EQUAL_STRING( "b", pcValue );
+    free( pcValue );
+}
+
+TEST( aws_cbor_index, FindKey_reuses_index_across_reads )
+{
+    CBOR_AppendKeyWithInt( xCborData, "one", 1 );
+    CBOR_AppendKeyWithInt( xCborData, "two", 2 );
+
+    TEST_ASSERT_TRUE( CBOR_FindKey( xCborData, "one" ) );
+
+    /* Corrupt a stored hash.  If the index were rebuilt, the lookup would
+     * still succeed, so a failed lookup shows the index was reused. */
+    for( int lI = 0; lI < CBOR_KEY_INDEX_SLOTS; lI++ )
+    {
+        xCborData->xKeyIndex[ lI ].usHash ^= 0xFFFF;
+    }
+
+    TEST_ASSERT_FALSE( CBOR_FindKey( xCborData, "two" ) );
+}
+
+TEST( aws_cbor_index, FindKey_returns_false_and_points_at_map_end )
+{
+    CBOR_AppendKeyWithInt( xCborData, "one", 1 );
+
+    TEST_ASSERT_FALSE( CBOR_FindKey( xCborData, "three" ) );
+    TEST_ASSERT_EQUAL_PTR( xCborData->pxMapEnd, xCborData->pxCursor );
+    TEST_ASSERT_EQUAL_HEX8( CBOR_BREAK, *( xCborData->pxCursor ) );
+}
+
+TEST( aws_cbor_index, Write_invalidates_index )
+{
+    CBOR_AppendKeyWithInt( xCborData, "one", 1 );
+    CBOR_FindKey( xCborData, "one" );
+
+    CBOR_AssignKeyWithInt( xCborData, "one", 1000 );
+
+    TEST_ASSERT_EQUAL( eCborKeyIndexInvalid, xCborData->ucKeyIndexState );
+}
+
+TEST( aws_cbor_index, FindKey_sees_value_written_after_index_built )
+{
+    CBOR_AppendKeyWithInt( xCborData, "one", 1 );
+    CBOR_AppendKeyWithInt( xCborData, "two", 2 );
+    TEST_ASSERT_EQUAL( 2, CBOR_FromKeyReadInt( xCborData, "two" ) );
+
+    /* Growing the first value shifts the second key */
+    CBOR_AssignKeyWithInt( xCborData, "one", 0x10000 );
+    CBOR_AppendKeyWithInt( xCborData, "three", 3 );
+
+    TEST_ASSERT_EQUAL( 2, CBOR_FromKeyReadInt( xCborData, "two" ) );
+    TEST_ASSERT_EQUAL( 3, CBOR_FromKeyReadInt( xCborData, "three" ) );
+    TEST_ASSERT_EQUAL( 0x10000, CBOR_FromKeyReadInt( xCborData, "one" ) );
+}
+
+TEST( aws_cbor_index, FindKey_skips_nested_map_keys )
+{
+    CBORHandle_t xInner = CBOR_New( 0 );
+
+    CBOR_AppendKeyWithInt( xInner, "inner", 7 );
+    CBOR_AppendKeyWithMap( xCborData, "map", xInner );
+    CBOR_AppendKeyWithInt( xCborData, "outer", 8 );
+    CBOR_Delete( &xInner );
+
+    TEST_ASSERT_FALSE( CBOR_FindKey( xCborData, "inner" ) );
+    TEST_ASSERT_EQUAL( 8, CBOR_FromKeyReadInt( xCborData, "outer" ) );
+
+    xInner = CBOR_FromKeyReadMap( xCborData, "map" );
+    TEST_ASSERT_EQUAL( 7, CBOR_FromKeyReadInt( xInner, "inner" ) );
+    CBOR_Delete( &xInner );
+}
+
+TEST( aws_cbor_index, FindKey_returns_first_duplicate_key )
+{
+    CBOR_AppendKeyWithInt( xCborData, "dup", 1 );
+    CBOR_AppendKeyWithInt( xCborData, "dup", 2 );
+
+    TEST_ASSERT_EQUAL( 1, CBOR_FromKeyReadInt( xCborData, "dup" ) );
+}
+
+TEST( aws_cbor_index, FindKey_falls_back_when_map_has_too_many_keys )
+{
+    char cKey[ 8 ];
+
+    for( int lI = 0; lI < CBOR_KEY_INDEX_SLOTS; lI++ )
+    {
+        snprintf( cKey, sizeof( cKey ), "k%d", lI );
+        CBOR_AppendKeyWithInt( xCborData, cKey, lI );
+    }
+
+    for( int lI = CBOR_KEY_INDEX_SLOTS - 1; lI >= 0; lI-- )
+    {
+        snprintf( cKey, sizeof( cKey ), "k%d", lI );
+        TEST_ASSERT_EQUAL( lI, CBOR_FromKeyReadInt( xCborData, cKey ) );
+    }
+
+    TEST_ASSERT_EQUAL( eCborKeyIndexUnusable, xCborData->ucKeyIndexState );
+    TEST_ASSERT_FALSE( CBOR_FindKey( xCborData, "missing" ) );
+}
+
+TEST( aws_cbor_index, FindKey_rebuilds_when_map_end_moved )
+{
+    uint8_t ucMap[] =
+    {
+        0xBF, /* 0  Open Map         */
+        0x61, /* 1  Key of length 1  */
+        'a',  /* 2                   */
+        0x01, /* 3  Small int        */
+        0x61, /* 4  Key of length 1  */
+        'b',  /* 5                   */
+        0x02, /* 6  Small int        */
+        0xFF, /* 7  End of Map       */
+    };
+
+    CBOR_AppendKeyWithInt( xCborData, "a", 1 );
+    TEST_ASSERT_FALSE( CBOR_FindKey( xCborData, "b" ) );
+
+    /* Buffer written directly, bypassing the write functions */
+    memcpy( xCborData->pxBufferStart, ucMap, sizeof( ucMap ) );
+    xCborData->pxMapEnd = xCborData->pxBufferStart + sizeof( ucMap ) - 1;
+
+    TEST_ASSERT_EQUAL( 2, CBOR_FromKeyReadInt( xCborData, "b" ) );
+}
@@ -29,6 +29,7 @@ static void runAllTests()
     RUN_TEST_GROUP(aws_cbor);
     RUN_TEST_GROUP(aws_cbor_acceptance);
     RUN_TEST_GROUP(aws_cbor_alloc);
+    RUN_TEST_GROUP(aws_cbor_index);
     RUN_TEST_GROUP(aws_cbor_int);
     RUN_TEST_GROUP(aws_cbor_iter);
     RUN_TEST_GROUP(aws_cbor_map);
@@ -23,9 +23,6 @@
  * http://www.FreeRTOS.org
  */
 
-#include "aws_cbor.h"
-#include "aws_cbor_alloc.h"
-#include "aws_cbor_print.h"
 #include "aws_defender_internals.h"
 
 #include "FreeRTOS.h"
@@ -58,15 +55,19 @@ static MQTTAgentHandle_t xDefenderMQTTAgent;
 static TaskHandle_t xDefenderTaskHandle = NULL;
 /* Timeout period for MQTT connections. */
 static TickType_t xMQTTTimeoutPeriodTicks = pdMS_TO_TICKS( 10U * 1000U );
+/* Buffer each metrics report is encoded into, reused for every report. */
+static uint8_t ucDefenderReportBuffer[ DEFENDER_REPORT_MAX_SIZE ];
 
 /**
  * @brief      Publishes metrics report to service
  *
- * @param[in]  xReport  The metrics report
+ * @param[in]  pucReport     The encoded metrics report
+ * @param[in]  xReportSize   Size of the report in bytes
  *
  * @return     Returns true if error occurred, false (0) on success
  */
-static DEFENDERBool_t prvPublishCborToDevDef( CBORHandle_t xReport );
+static DEFENDERBool_t prvPublishCborToDevDef( uint8_t const * pucReport,
+                                              size_t xReportSize );
 
 /**
  * @brief      Subscribes to the report accept topic
@@ -357,17 +358,19 @@ static MQTTBool_t prvRejectCallback( void * pxPvPublishCallbackContext,
 
 static DefenderState_t prvStateCreateReport( void )
 {
-    CBORHandle_t xReport;
+    size_t xReportSize = 0;
 
-    xReport = CreateReport();
+    UpdateMetrics();
 
-    if( NULL == xReport )
+    if( CborNoError != CreateReport( ucDefenderReportBuffer,
+                                     sizeof( ucDefenderReportBuffer ),
+                                     &xReportSize ) )
     {
         return eDefenderStateSubmitReportFailed;
     }
 
-    DEFENDERBool_t xError = prvPublishCborToDevDef( xReport );
-    CBOR_Delete( &xReport );
+    DEFENDERBool_t xError =
+        prvPublishCborToDevDef( ucDefenderReportBuffer, xReportSize );
 
     /* Wait for ack from service */
     vTaskDelay( pdMS_TO_TICKS( 10000 ) );
@@ -380,7 +383,8 @@ static DefenderState_t prvStateCreateReport( void )
     return eDefenderStateSubmitReportSuccess;
 }
 
-static DEFENDERBool_t prvPublishCborToDevDef( CBORHandle_t xReport )
+static DEFENDERBool_t prvPublishCborToDevDef( uint8_t const * pucReport,
+                                              size_t xReportSize )
 {
     MQTTAgentPublishParams_t xPubRecParams =
     {
@@ -394,15 +398,13 @@ static DEFENDERBool_t prvPublishCborToDevDef( CBORHandle_t xReport )
                          "$aws/things/"
                          clientcredentialIOT_THING_NAME
                          "/defender/metrics/cbor";
-    uint8_t const * pucBuffer = CBOR_GetRawBuffer( xReport );
-    int32_t lBufLen = CBOR_GetBufferSize( xReport );
     MQTTAgentReturnCode_t xPublishResult = 0;
 
     /* Initialize non-static field values. */
     xPubRecParams.pucTopic = pucTopic;
     xPubRecParams.usTopicLength = ( uint16_t ) strlen( ( char * ) pucTopic );
-    xPubRecParams.pvData = pucBuffer;
-    xPubRecParams.ulDataLength = lBufLen;
+    xPubRecParams.pvData = pucReport;
+    xPubRecParams.ulDataLength = ( uint32_t ) xReportSize;
 
     xPublishResult = MQTT_AGENT_Publish( xDefenderMQTTAgent,
                                          &xPubRecParams,
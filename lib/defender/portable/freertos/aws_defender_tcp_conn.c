@@ -23,36 +23,97 @@
  * http://www.FreeRTOS.org
  */
 #include "FreeRTOS.h"
-#include "list.h"
+#include "task.h"
+
+#include "FreeRTOS_IP.h"
+#include "FreeRTOS_Sockets.h"
+#include "FreeRTOS_TCP_IP.h"
 
 #include "aws_defender_tcp_conn.h"
 
-extern List_t xBoundTCPSocketsList;
-static int32_t lDefenderTCPConnCount;
+/**
+ * Number of TCP sockets copied out of the IP stack per refresh.  Listening,
+ * established and all other sockets share this table.
+ */
+#ifndef DEFENDER_TCP_SOCKETS_MAX
+    #define DEFENDER_TCP_SOCKETS_MAX    ( 2 * DEFENDER_TCP_CONN_MAX )
+#endif
+
+/** How long to wait for room in the IP task's event queue */
+#define DEFENDER_TCP_CONN_BLOCK_TIME    pdMS_TO_TICKS( 1000 )
+
+static TCPConnectionInfo_t xTCPSocketTable[ DEFENDER_TCP_SOCKETS_MAX ];
+static DefenderTcpConnSnapshot_t xDefenderTCPConnSnapshot;
 
 int32_t TcpConnGet( void )
 {
-    return lDefenderTCPConnCount;
+    return xDefenderTCPConnSnapshot.lEstablishedTotal;
+}
+
+DefenderTcpConnSnapshot_t const * TcpConnSnapshotGet( void )
+{
+    return &xDefenderTCPConnSnapshot;
 }
 
 void TcpConnRefresh( void )
 {
-    int32_t lTCPConnCount[ 2 ];
-    int32_t lTries = 10;
+    DefenderTcpConnSnapshot_t * pxSnapshot = &xDefenderTCPConnSnapshot;
+    BaseType_t xSocketCount;
+    BaseType_t xIndex;
+
+    pxSnapshot->lEstablishedTotal = 0;
+    pxSnapshot->lListeningTotal = 0;
+    pxSnapshot->lConnCount = 0;
+    pxSnapshot->lPortCount = 0;
+
+    /* The IP task copies its socket list in one go, so the table is
+     * consistent without locking the stack. */
+    xSocketCount = FreeRTOS_GetTCPConnections( xTCPSocketTable,
+                                               DEFENDER_TCP_SOCKETS_MAX,
+                                               DEFENDER_TCP_CONN_BLOCK_TIME );
 
-    do
+    if( xSocketCount < 0 )
     {
-        lTCPConnCount[ 0 ] = listCURRENT_LIST_LENGTH( &xBoundTCPSocketsList );
-        lTCPConnCount[ 1 ] = listCURRENT_LIST_LENGTH( &xBoundTCPSocketsList );
-        lTries--;
+        pxSnapshot->lEstablishedTotal = -1;
+        pxSnapshot->lListeningTotal = -1;
 
-        if( 0 == lTries )
+        return;
+    }
+
+    if( xSocketCount > DEFENDER_TCP_SOCKETS_MAX )
+    {
+        xSocketCount = DEFENDER_TCP_SOCKETS_MAX;
+    }
+
+    for( xIndex = 0; xIndex < xSocketCount; xIndex++ )
+    {
+        TCPConnectionInfo_t const * pxInfo = &xTCPSocketTable[ xIndex ];
+
+        if( eESTABLISHED == pxInfo->ucTCPState )
         {
-            lDefenderTCPConnCount = -1;
+            if( pxSnapshot->lConnCount < DEFENDER_TCP_CONN_MAX )
+            {
+                DefenderTcpConn_t * pxConn =
+                    &pxSnapshot->xConns[ pxSnapshot->lConnCount ];
+
+                pxConn->ulRemoteIP = pxInfo->ulRemoteIP;
+                pxConn->usRemotePort = pxInfo->usRemotePort;
+                pxConn->usLocalPort = pxInfo->usLocalPort;
+                pxSnapshot->lConnCount++;
+            }
 
-            return;
+            pxSnapshot->lEstablishedTotal++;
         }
-    } while( lTCPConnCount[ 0 ] != lTCPConnCount[ 1 ] );
+        else if( eTCP_LISTEN == pxInfo->ucTCPState )
+        {
+            if( pxSnapshot->lPortCount < DEFENDER_TCP_CONN_MAX )
+            {
+                pxSnapshot->usListeningPorts[ pxSnapshot->lPortCount ] =
+                    pxInfo->usLocalPort;
+                pxSnapshot->lPortCount++;
+            }
 
-    lDefenderTCPConnCount = lTCPConnCount[ 0 ];
+            pxSnapshot->lListeningTotal++;
+        }
+    }
 }
@@ -24,11 +24,18 @@
  */
 #include "aws_defender_tcp_conn.h"
 
+static DefenderTcpConnSnapshot_t xDefenderTCPConnSnapshot;
+
 int32_t TcpConnGet( void )
 {
     return 0;
 }
 
+DefenderTcpConnSnapshot_t const * TcpConnSnapshotGet( void )
+{
+    return &xDefenderTCPConnSnapshot;
+}
+
 void TcpConnRefresh( void )
 {
 }
@@ -31,6 +31,13 @@ int32_t TcpConnGet( void )
     return -1;
 }
 
+DefenderTcpConnSnapshot_t const * TcpConnSnapshotGet( void )
+{
+    #error Return the established connections and listening ports
+
+    return NULL;
+}
+
 void TcpConnRefresh( void )
 {
     #error Caluculate and store the count of TCP connections
@@ -25,14 +25,19 @@
 #include "aws_defender_tcp_conn.h"
 
 int32_t lDefenderCurrentTCPConnCount;
-static int32_t lDefenderTCPConnCount;
+static DefenderTcpConnSnapshot_t xDefenderTCPConnSnapshot;
 
 int32_t TcpConnGet( void )
 {
-    return xDefenderTCPConnCount;
+    return xDefenderTCPConnSnapshot.lEstablishedTotal;
+}
+
+DefenderTcpConnSnapshot_t const * TcpConnSnapshotGet( void )
+{
+    return &xDefenderTCPConnSnapshot;
 }
 
 void TcpConnRefresh( void )
 {
-    xDefenderTCPConnCount = xDefenderCurrentTCPConnCount;
+    xDefenderTCPConnSnapshot.lEstablishedTotal = lDefenderCurrentTCPConnCount;
 }
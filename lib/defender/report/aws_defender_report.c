@@ -52,45 +52,88 @@ DefenderErr_t DEFENDER_MetricsInitFunc( DefenderMetric_t * xMetrics,
     return eDefenderErrSuccess;
 }
 
-CBORHandle_t CreateReport( void )
+void UpdateMetrics( void )
 {
-    /*Create new empty report*/
-    CBORHandle_t xReport = CBOR_New( 0 );
-    /*Create new report header*/
-    CBORHandle_t xHeader = GetHeader();
-
-    /*Copy header to the report*/
-    CBOR_AppendKeyWithMap( xReport, DEFENDER_HEADER_TAG, xHeader );
-    /*Delete the header*/
-    CBOR_Delete( &xHeader );
-    /*Create new empty metrics document*/
-    CBORHandle_t xMetrics = CBOR_New( 0 );
-
-    /*For each metric, append it to the metrics document*/
     for( int32_t lI = 0; lI < lMetricsCount; ++lI )
     {
-        /*Update the date for the metric*/
-        xMetricsList[ lI ]->UpdateMetric();
-        /*Get report from the metric*/
-        CBORHandle_t xMetric = xMetricsList[ lI ]->ReportMetric();
-        /*Copy the metric to the metrics document*/
-        CBOR_AppendMap( xMetrics, xMetric );
-        /*Delete the metric document*/
-        CBOR_Delete( &xMetric );
+        bool xRefreshed = false;
+
+        /*Skip the metrics whose data an earlier metric already refreshed*/
+        for( int32_t lJ = 0; lJ < lI; ++lJ )
+        {
+            if( xMetricsList[ lJ ]->UpdateMetric == xMetricsList[ lI ]->UpdateMetric )
+            {
+                xRefreshed = true;
+                break;
+            }
+        }
+
+        if( !xRefreshed )
+        {
+            xMetricsList[ lI ]->UpdateMetric();
+        }
+    }
+}
+
+CborError CreateReport( uint8_t * pucBuffer,
+                        size_t xBufferSize,
+                        size_t * pxReportSize )
+{
+    CborEncoder xEncoder, xReportMap, xMetricsMap;
+    CborError xCborResult;
+
+    /*Start the report at the beginning of the caller's buffer*/
+    cbor_encoder_init( &xEncoder, pucBuffer, xBufferSize, 0 );
+    /*Report holds two keys: header and metrics*/
+    xCborResult = cbor_encoder_create_map( &xEncoder, &xReportMap, 2 );
+
+    /*Encode the report header*/
+    if( CborNoError == xCborResult )
+    {
+        xCborResult = GetHeader( &xReportMap );
+    }
+
+    if( CborNoError == xCborResult )
+    {
+        xCborResult = cbor_encode_text_stringz(
+            &xReportMap,
+            DEFENDER_METRICS_TAG );
     }
 
-    /*Copy the metrics document to the report*/
-    CBOR_AppendKeyWithMap( xReport, DEFENDER_METRICS_TAG, xMetrics );
-    /*Delete the metrics document*/
-    CBOR_Delete( &xMetrics );
+    /*Each metric contributes exactly one key to the metrics map*/
+    if( CborNoError == xCborResult )
+    {
+        xCborResult = cbor_encoder_create_map( &xReportMap, &xMetricsMap,
+                                               ( size_t ) lMetricsCount );
+    }
+
+    /*For each metric, encode it directly into the metrics map*/
+    for( int32_t lI = 0;
+         ( lI < lMetricsCount ) && ( CborNoError == xCborResult );
+         ++lI )
+    {
+        xCborResult = xMetricsList[ lI ]->ReportMetric( &xMetricsMap );
+    }
+
+    if( CborNoError == xCborResult )
+    {
+        xCborResult = cbor_encoder_close_container_checked(
+            &xReportMap,
+            &xMetricsMap );
+    }
+
+    if( CborNoError == xCborResult )
+    {
+        xCborResult = cbor_encoder_close_container_checked(
+            &xEncoder,
+            &xReportMap );
+    }
 
-    /*If an error occurred */
-    if( eCborErrNoError != CBOR_CheckError( xReport ) )
+    /*Return the size of the encoded report*/
+    if( CborNoError == xCborResult )
     {
-        /*Delete the report*/
-        CBOR_Delete( &xReport );
+        *pxReportSize = cbor_encoder_get_buffer_size( &xEncoder, pucBuffer );
     }
 
-    /*Return the report*/
-    return xReport;
+    return xCborResult;
 }
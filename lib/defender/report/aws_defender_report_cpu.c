@@ -32,11 +32,16 @@ struct DefenderMetric_s xDefenderMetricCpu_s =
 
 DefenderMetric_t xDEFENDER_metric_cpu = &xDefenderMetricCpu_s;
 
-CBORHandle_t CpuReportGet( void )
+CborError CpuReportGet( CborEncoder * pxMetricsMap )
 {
-    CBORHandle_t xCpuMetrics = CBOR_New( 0 );
+    CborError xCborResult;
 
-    CBOR_AssignKeyWithInt( xCpuMetrics, "cpu", CpuLoadGet() );
+    xCborResult = cbor_encode_text_stringz( pxMetricsMap, "cpu" );
 
-    return xCpuMetrics;
+    if( CborNoError == xCborResult )
+    {
+        xCborResult = cbor_encode_int( pxMetricsMap, CpuLoadGet() );
+    }
+
+    return xCborResult;
 }
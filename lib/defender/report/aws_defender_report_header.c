@@ -40,17 +40,53 @@ static uint32_t prvDEFENDER_ReportIdInit( void )
     return ulId;
 }
 
-CBORHandle_t GetHeader( void )
+CborError GetHeader( CborEncoder * pxReportMap )
 {
+    CborEncoder xHeaderMap;
+    CborError xCborResult;
+
     lReportId = lReportId == 0 ? prvDEFENDER_ReportIdInit() : lReportId;
 
-    CBORHandle_t xHeader = CBOR_New( 0 );
+    xCborResult = cbor_encode_text_stringz( pxReportMap, DEFENDER_HEADER_TAG );
+
+    if( CborNoError == xCborResult )
+    {
+        xCborResult = cbor_encoder_create_map( pxReportMap, &xHeaderMap, 2 );
+    }
+
+    if( CborNoError == xCborResult )
+    {
+        xCborResult = cbor_encode_text_stringz(
+            &xHeaderMap,
+            DEFENDER_REPORT_ID_TAG );
+    }
+
+    if( CborNoError == xCborResult )
+    {
+        xCborResult = cbor_encode_int( &xHeaderMap, ++lReportId );
+    }
+
+    if( CborNoError == xCborResult )
+    {
+        xCborResult = cbor_encode_text_stringz(
+            &xHeaderMap,
+            DEFENDER_VERSION_TAG );
+    }
+
+    if( CborNoError == xCborResult )
+    {
+        xCborResult = cbor_encode_text_stringz( &xHeaderMap,
+                                                pcDEFENDER_METRICS_VERSION );
+    }
 
-    CBOR_AssignKeyWithInt( xHeader, DEFENDER_REPORT_ID_TAG, ++lReportId );
-    CBOR_AssignKeyWithString(
-        xHeader, DEFENDER_VERSION_TAG, pcDEFENDER_METRICS_VERSION );
+    if( CborNoError == xCborResult )
+    {
+        xCborResult = cbor_encoder_close_container_checked(
+            pxReportMap,
+            &xHeaderMap );
+    }
 
-    return xHeader;
+    return xCborResult;
 }
 
 int32_t GetLastReportId( void )
@@ -24,6 +24,11 @@
  */
 #include "aws_defender_internals.h"
 
+#include <stdio.h>
+
+/** Longest remote address, including the terminating NUL */
+#define DEFENDER_REMOTE_ADDR_MAX_LENGTH    ( sizeof( "255.255.255.255:65535" ) )
+
 static struct DefenderMetric_s xDefenderTCPConnectionsS =
 {
     TcpConnRefresh,
@@ -32,20 +37,257 @@ static struct DefenderMetric_s xDefenderTCPConnectionsS =
 
 DefenderMetric_t xDefenderTCPConnections = &xDefenderTCPConnectionsS;
 
-CBORHandle_t TcpConnReportGet( void )
+static struct DefenderMetric_s xDefenderListeningTCPPortsS =
+{
+    TcpConnRefresh,
+    TcpPortsReportGet,
+};
+
+DefenderMetric_t xDefenderListeningTCPPorts = &xDefenderListeningTCPPortsS;
+
+static CborError prvEncodeConnection( CborEncoder * pxConnArray,
+                                      DefenderTcpConn_t const * pxConn )
+{
+    CborEncoder xConnMap;
+    CborError xCborResult;
+    char cRemoteAddr[ DEFENDER_REMOTE_ADDR_MAX_LENGTH ];
+
+    ( void ) snprintf( cRemoteAddr,
+                       sizeof( cRemoteAddr ),
+                       "%u.%u.%u.%u:%u",
+                       ( unsigned int ) ( ( pxConn->ulRemoteIP >> 24 ) & 0xFFUL ),
+                       ( unsigned int ) ( ( pxConn->ulRemoteIP >> 16 ) & 0xFFUL ),
+                       ( unsigned int ) ( ( pxConn->ulRemoteIP >> 8 ) & 0xFFUL ),
+                       ( unsigned int ) ( pxConn->ulRemoteIP & 0xFFUL ),
+                       ( unsigned int ) pxConn->usRemotePort );
+
+    xCborResult = cbor_encoder_create_map( pxConnArray, &xConnMap, 2 );
+
+    if( CborNoError == xCborResult )
+    {
+        xCborResult = cbor_encode_text_stringz(
+            &xConnMap,
+            DEFENDER_REMOTE_ADDR_TAG );
+    }
+
+    if( CborNoError == xCborResult )
+    {
+        xCborResult = cbor_encode_text_stringz( &xConnMap, cRemoteAddr );
+    }
+
+    if( CborNoError == xCborResult )
+    {
+        xCborResult = cbor_encode_text_stringz(
+            &xConnMap,
+            DEFENDER_LOCAL_PORT_TAG );
+    }
+
+    if( CborNoError == xCborResult )
+    {
+        xCborResult = cbor_encode_uint( &xConnMap, pxConn->usLocalPort );
+    }
+
+    if( CborNoError == xCborResult )
+    {
+        xCborResult = cbor_encoder_close_container_checked(
+            pxConnArray,
+            &xConnMap );
+    }
+
+    return xCborResult;
+}
+
+static CborError prvEncodePort( CborEncoder * pxPortArray,
+                                uint16_t usPort )
+{
+    CborEncoder xPortMap;
+    CborError xCborResult;
+
+    xCborResult = cbor_encoder_create_map( pxPortArray, &xPortMap, 1 );
+
+    if( CborNoError == xCborResult )
+    {
+        xCborResult = cbor_encode_text_stringz( &xPortMap, DEFENDER_PORT_TAG );
+    }
+
+    if( CborNoError == xCborResult )
+    {
+        xCborResult = cbor_encode_uint( &xPortMap, usPort );
+    }
+
+    if( CborNoError == xCborResult )
+    {
+        xCborResult = cbor_encoder_close_container_checked(
+            pxPortArray,
+            &xPortMap );
+    }
+
+    return xCborResult;
+}
+
+CborError TcpConnReportGet( CborEncoder * pxMetricsMap )
+{
+    DefenderTcpConnSnapshot_t const * pxSnapshot = TcpConnSnapshotGet();
+    CborEncoder xTcpConnMap, xEstConnMap, xConnArray;
+    CborError xCborResult;
+    int32_t lIndex;
+
+    xCborResult = cbor_encode_text_stringz(
+        pxMetricsMap,
+        DEFENDER_TCP_CONN_TAG );
+
+    if( CborNoError == xCborResult )
+    {
+        xCborResult = cbor_encoder_create_map( pxMetricsMap, &xTcpConnMap, 1 );
+    }
+
+    if( CborNoError == xCborResult )
+    {
+        xCborResult = cbor_encode_text_stringz(
+            &xTcpConnMap,
+            DEFENDER_EST_CONN_TAG );
+    }
+
+    /* The list of connections is left out when there is nothing to list. */
+    if( CborNoError == xCborResult )
+    {
+        xCborResult = cbor_encoder_create_map(
+            &xTcpConnMap,
+            &xEstConnMap,
+            ( pxSnapshot->lConnCount > 0 ) ? 2 : 1 );
+    }
+
+    if( ( CborNoError == xCborResult ) && ( pxSnapshot->lConnCount > 0 ) )
+    {
+        xCborResult = cbor_encode_text_stringz(
+            &xEstConnMap,
+            DEFENDER_CONNECTIONS_TAG );
+
+        if( CborNoError == xCborResult )
+        {
+            xCborResult = cbor_encoder_create_array(
+                &xEstConnMap,
+                &xConnArray,
+                ( size_t ) pxSnapshot->lConnCount );
+        }
+
+        for( lIndex = 0;
+             ( CborNoError == xCborResult ) && ( lIndex < pxSnapshot->lConnCount );
+             lIndex++ )
+        {
+            xCborResult = prvEncodeConnection(
+                &xConnArray,
+                &pxSnapshot->xConns[ lIndex ] );
+        }
+
+        if( CborNoError == xCborResult )
+        {
+            xCborResult = cbor_encoder_close_container_checked(
+                &xEstConnMap,
+                &xConnArray );
+        }
+    }
+
+    if( CborNoError == xCborResult )
+    {
+        xCborResult = cbor_encode_text_stringz(
+            &xEstConnMap,
+            DEFENDER_TOTAL_TAG );
+    }
+
+    if( CborNoError == xCborResult )
+    {
+        xCborResult = cbor_encode_int( &xEstConnMap, TcpConnGet() );
+    }
+
+    if( CborNoError == xCborResult )
+    {
+        xCborResult = cbor_encoder_close_container_checked(
+            &xTcpConnMap,
+            &xEstConnMap );
+    }
+
+    if( CborNoError == xCborResult )
+    {
+        xCborResult = cbor_encoder_close_container_checked(
+            pxMetricsMap,
+            &xTcpConnMap );
+    }
+
+    return xCborResult;
+}
+
+CborError TcpPortsReportGet( CborEncoder * pxMetricsMap )
 {
-    CBORHandle_t xEstConn = CBOR_New( 0 );
+    DefenderTcpConnSnapshot_t const * pxSnapshot = TcpConnSnapshotGet();
+    CborEncoder xTcpPortsMap, xPortArray;
+    CborError xCborResult;
+    int32_t lIndex;
+
+    xCborResult = cbor_encode_text_stringz(
+        pxMetricsMap,
+        DEFENDER_TCP_PORTS_TAG );
+
+    /* The list of ports is left out when there is nothing to list. */
+    if( CborNoError == xCborResult )
+    {
+        xCborResult = cbor_encoder_create_map(
+            pxMetricsMap,
+            &xTcpPortsMap,
+            ( pxSnapshot->lPortCount > 0 ) ? 2 : 1 );
+    }
+
+    if( ( CborNoError == xCborResult ) && ( pxSnapshot->lPortCount > 0 ) )
+    {
+        xCborResult = cbor_encode_text_stringz(
+            &xTcpPortsMap,
+            DEFENDER_PORTS_TAG );
+
+        if( CborNoError == xCborResult )
+        {
+            xCborResult = cbor_encoder_create_array(
+                &xTcpPortsMap,
+                &xPortArray,
+                ( size_t ) pxSnapshot->lPortCount );
+        }
+
+        for( lIndex = 0;
+             ( CborNoError == xCborResult ) && ( lIndex < pxSnapshot->lPortCount );
+             lIndex++ )
+        {
+            xCborResult = prvEncodePort(
+                &xPortArray,
+                pxSnapshot->usListeningPorts[ lIndex ] );
+        }
+
+        if( CborNoError == xCborResult )
+        {
+            xCborResult = cbor_encoder_close_container_checked(
+                &xTcpPortsMap,
+                &xPortArray );
+        }
+    }
 
-    CBOR_AssignKeyWithInt( xEstConn, DEFENDER_TOTAL_TAG, TcpConnGet() );
+    if( CborNoError == xCborResult )
+    {
+        xCborResult = cbor_encode_text_stringz(
+            &xTcpPortsMap,
+            DEFENDER_TOTAL_TAG );
+    }
 
-    CBORHandle_t xTcpConnMetrics = CBOR_New( 0 );
-    CBOR_AssignKeyWithMap( xTcpConnMetrics, DEFENDER_EST_CONN_TAG, xEstConn );
-    CBOR_Delete( &xEstConn );
+    if( CborNoError == xCborResult )
+    {
+        xCborResult = cbor_encode_int(
+            &xTcpPortsMap,
+            pxSnapshot->lListeningTotal );
+    }
 
-    CBORHandle_t xTcpConnReport = CBOR_New( 0 );
-    CBOR_AssignKeyWithMap(
-        xTcpConnReport, DEFENDER_TCP_CONN_TAG, xTcpConnMetrics );
-    CBOR_Delete( &xTcpConnMetrics );
+    if( CborNoError == xCborResult )
+    {
+        xCborResult = cbor_encoder_close_container_checked(
+            pxMetricsMap,
+            &xTcpPortsMap );
+    }
 
-    return xTcpConnReport;
+    return xCborResult;
 }
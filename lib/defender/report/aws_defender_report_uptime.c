@@ -32,11 +32,16 @@ static struct DefenderMetric_s xDefenderMetricUptimeS =
 
 DefenderMetric_t xDefenderMetricUptime = &xDefenderMetricUptimeS;
 
-CBORHandle_t UptimeReportGet( void )
+CborError UptimeReportGet( CborEncoder * pxMetricsMap )
 {
-    CBORHandle_t xUptimeMetrics = CBOR_New( 0 );
+    CborError xCborResult;
 
-    CBOR_AppendKeyWithInt( xUptimeMetrics, "ut", UptimeSecondsGet() );
+    xCborResult = cbor_encode_text_stringz( pxMetricsMap, "ut" );
 
-    return xUptimeMetrics;
+    if( CborNoError == xCborResult )
+    {
+        xCborResult = cbor_encode_int( pxMetricsMap, UptimeSecondsGet() );
+    }
+
+    return xCborResult;
 }
@@ -48,6 +48,7 @@
 #include "jsmn.h"
 
 /* Standard includes. */
+#include <stddef.h>
 #include <stdlib.h>
 #include <string.h>
 
@@ -104,6 +105,19 @@
  */
 #define ggdLOOP_BACK_IP            "127.0.0.1"
 
+/**
+ * @brief Marks an initialized discovery cache.
+ */
+#define ggdCACHE_MAGIC             ( 0x43444747UL )
+
+/**
+ * @brief Parameters of the FNV-1a hash used as the cache checksum.
+ */
+/** @{ */
+#define ggdCACHE_FNV_OFFSET_BASIS  ( 2166136261UL )
+#define ggdCACHE_FNV_PRIME         ( 16777619UL )
+/** @} */
+
 /**
  * @brief JSON parsing helper functions.
  *
@@ -154,21 +168,61 @@ static BaseType_t prvIsIPvalid( const char * pcIP,
 static BaseType_t prvCheckForContentLengthString( uint8_t * pucIndex,
                                                   const char cNewChar ); /*lint !e971 can use char without signed/unsigned. */
 
+/**
+ * @brief Make the discovery request and retrieve the complete JSON file.
+ */
+static BaseType_t prvGGDGetJSON( char * pcBuffer, /*lint !e971 can use char without signed/unsigned. */
+                                 const uint32_t ulBufferSize,
+                                 uint32_t * pulJSONFileSize );
+
+/**
+ * @brief Discovery cache helper functions.
+ */
+/** @{ */
+static void prvCacheAddHost( GGD_DiscoveryCache_t * pxCache,
+                             const GGD_HostAddressData_t * pxHostAddressData );
+static void prvCacheSortHosts( GGD_DiscoveryCache_t * pxCache );
+static uint32_t prvCacheChecksum( const GGD_DiscoveryCache_t * pxCache );
+static void prvCacheUpdate( GGD_DiscoveryCache_t * pxCache );
+/** @} */
+
 /*-----------------------------------------------------------*/
 
 BaseType_t GGD_GetGGCIPandCertificate( char * pcBuffer, /*lint !e971 can use char without signed/unsigned. */
                                        const uint32_t ulBufferSize,
                                        GGD_HostAddressData_t * pxHostAddressData )
 {
-    Socket_t xSocket;
     uint32_t ulJSONFileSize = 0;
-    BaseType_t xJSONFileRetrieveCompleted = pdFALSE;
-    uint32_t ulByteRead = 0;
     BaseType_t xStatus;
 
     configASSERT( pxHostAddressData != NULL );
     configASSERT( pcBuffer != NULL );
 
+    xStatus = prvGGDGetJSON( pcBuffer, ulBufferSize, &ulJSONFileSize );
+
+    if( xStatus == pdPASS )
+    {
+        xStatus = GGD_GetIPandCertificateFromJSON( pcBuffer,
+                                                   ulJSONFileSize,
+                                                   NULL,
+                                                   pxHostAddressData,
+                                                   pdTRUE );
+    }
+
+    return xStatus;
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvGGDGetJSON( char * pcBuffer, /*lint !e971 can use char without signed/unsigned. */
+                                 const uint32_t ulBufferSize,
+                                 uint32_t * pulJSONFileSize )
+{
+    Socket_t xSocket;
+    uint32_t ulJSONFileSize = 0;
+    BaseType_t xJSONFileRetrieveCompleted = pdFALSE;
+    uint32_t ulByteRead = 0;
+    BaseType_t xStatus;
+
     xStatus = GGD_JSONRequestStart( &xSocket );
 
     if( xStatus == pdPASS )
@@ -211,13 +265,44 @@ BaseType_t GGD_GetGGCIPandCertificate( char * pcBuffer, /*lint !e971 can use cha
         }
     }
 
-    if( xStatus == pdPASS )
+    *pulJSONFileSize = ulJSONFileSize;
+
+    return xStatus;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t GGD_GetGGCIPandCertificateCached( char * pcBuffer, /*lint !e971 can use char without signed/unsigned. */
+                                             const uint32_t ulBufferSize,
+                                             GGD_DiscoveryCache_t * pxCache,
+                                             GGD_HostAddressData_t * pxHostAddressData )
+{
+    uint32_t ulJSONFileSize = 0;
+    BaseType_t xStatus = pdFAIL;
+
+    configASSERT( pcBuffer != NULL );
+    configASSERT( pxCache != NULL );
+    configASSERT( pxHostAddressData != NULL );
+
+    if( GGD_CacheIsValid( pxCache ) == pdTRUE )
     {
-        xStatus = GGD_GetIPandCertificateFromJSON( pcBuffer,
-                                                   ulJSONFileSize,
-                                                   NULL,
-                                                   pxHostAddressData,
-                                                   pdTRUE );
+        xStatus = GGD_CacheConnect( pxCache, pxHostAddressData, NULL );
+    }
+
+    if( xStatus == pdFAIL )
+    {
+        ggdconfigPRINT( "GGD - No cached core to connect to, making the discovery request\r\n" );
+
+        xStatus = prvGGDGetJSON( pcBuffer, ulBufferSize, &ulJSONFileSize );
+
+        if( xStatus == pdPASS )
+        {
+            xStatus = GGD_CacheFromJSON( pcBuffer, ulJSONFileSize, pxCache );
+        }
+
+        if( xStatus == pdPASS )
+        {
+            xStatus = GGD_CacheConnect( pxCache, pxHostAddressData, NULL );
+        }
     }
 
     return xStatus;
@@ -585,6 +670,342 @@ BaseType_t GGD_GetIPandCertificateFromJSON( char * pcJSONFile, /*lint !e971 can
 }
 /*-----------------------------------------------------------*/
 
+BaseType_t GGD_CacheFromJSON( char * pcJSONFile, /*lint !e971 can use char without signed/unsigned. */
+                              const uint32_t ulJSONFileSize,
+                              GGD_DiscoveryCache_t * pxCache )
+{
+    BaseType_t xStatus = pdPASS;
+    jsmn_parser xParser;
+    jsmntok_t pxTok[ ggdconfigJSON_MAX_TOKENS ];
+    int32_t lNbTokens;
+    uint32_t ulTokenIndex = 0;
+    uint8_t ucCurrentInterface = 0, ucTargetInterface = 1;
+    GGD_HostAddressData_t xHostAddressData;
+
+    configASSERT( pcJSONFile != NULL );
+    configASSERT( pxCache != NULL );
+
+    /* Padding included, so that the checksum only depends on the content. */
+    memset( pxCache, 0, sizeof( *pxCache ) );
+
+    jsmn_init( &xParser );
+    lNbTokens = ( int32_t ) jsmn_parse( &xParser,
+                                        pcJSONFile, /*lint !e971 can use char without signed/unsigned. */
+                                        ( size_t ) ulJSONFileSize,
+                                        pxTok,
+                                        ( unsigned int ) ggdconfigJSON_MAX_TOKENS ); /*lint !e961 redundant casting only when int = int32_t. */
+
+    if( lNbTokens < 0 )
+    {
+        ggdconfigPRINT( "JSON parsing: Failed to parse JSON\r\n" );
+
+        xStatus = pdFAIL;
+    }
+
+    if( xStatus == pdPASS )
+    {
+        if( prvGGDGetCertificate( pcJSONFile,
+                                  NULL,
+                                  pdTRUE,
+                                  pxTok,
+                                  ( uint32_t ) lNbTokens,
+                                  &xHostAddressData ) == pdFAIL )
+        {
+            ggdconfigPRINT( "JSON parsing: Couldn't find certificate\r\n" );
+
+            xStatus = pdFAIL;
+        }
+        else if( xHostAddressData.ulCertificateSize > ( uint32_t ) sizeof( pxCache->cCertificate ) )
+        {
+            ggdconfigPRINT( "GGD - Certificate too large for the cache, %lu bytes\r\n",
+                            ( unsigned long ) xHostAddressData.ulCertificateSize );
+
+            xStatus = pdFAIL;
+        }
+        else
+        {
+            memcpy( pxCache->cCertificate, xHostAddressData.pcCertificate, xHostAddressData.ulCertificateSize );
+            pxCache->ulCertificateSize = xHostAddressData.ulCertificateSize;
+        }
+    }
+
+    if( xStatus == pdPASS )
+    {
+        /* Keep every connectivity entry of every core, in the order of the
+         * file, as the auto select option would try them. */
+        while( prvGGDGetIPOnInterface( pcJSONFile,
+                                       ucTargetInterface,
+                                       pxTok,
+                                       ( uint32_t ) lNbTokens,
+                                       &xHostAddressData,
+                                       &ulTokenIndex,
+                                       &ucCurrentInterface ) == pdPASS )
+        {
+            prvCacheAddHost( pxCache, &xHostAddressData );
+            ucTargetInterface++;
+        }
+
+        if( pxCache->ulHostCount == ( uint32_t ) 0 )
+        {
+            ggdconfigPRINT( "GGD - No greengrass Core to cache\r\n" );
+
+            xStatus = pdFAIL;
+        }
+    }
+
+    if( xStatus == pdPASS )
+    {
+        pxCache->ulMagic = ggdCACHE_MAGIC;
+        pxCache->ulSize = ( uint32_t ) sizeof( *pxCache );
+
+        #if ( ggdconfigCACHE_MAX_AGE_SECONDS > 0 )
+            {
+                pxCache->ulStoredTime = ( uint32_t ) ggdconfigCACHE_TIME_SECONDS();
+            }
+        #endif
+    }
+    else
+    {
+        memset( pxCache, 0, sizeof( *pxCache ) );
+    }
+
+    prvCacheUpdate( pxCache );
+
+    return xStatus;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t GGD_CacheIsValid( const GGD_DiscoveryCache_t * pxCache )
+{
+    BaseType_t xValid = pdFALSE;
+
+    configASSERT( pxCache != NULL );
+
+    if( ( pxCache->ulMagic == ggdCACHE_MAGIC ) &&
+        ( pxCache->ulSize == ( uint32_t ) sizeof( *pxCache ) ) &&
+        ( pxCache->ulChecksum == prvCacheChecksum( pxCache ) ) &&
+        ( pxCache->ulHostCount > ( uint32_t ) 0 ) &&
+        ( pxCache->ulHostCount <= ( uint32_t ) ggdconfigCACHE_MAX_HOSTS ) &&
+        ( pxCache->ulFailedConnects < ( uint32_t ) ggdconfigCACHE_MAX_FAILED_CONNECTS ) )
+    {
+        xValid = pdTRUE;
+
+        #if ( ggdconfigCACHE_MAX_AGE_SECONDS > 0 )
+            {
+                if( ( ( uint32_t ) ggdconfigCACHE_TIME_SECONDS() - pxCache->ulStoredTime ) >=
+                    ( uint32_t ) ggdconfigCACHE_MAX_AGE_SECONDS )
+                {
+                    xValid = pdFALSE;
+                }
+            }
+        #endif
+    }
+
+    return xValid;
+}
+/*-----------------------------------------------------------*/
+
+void GGD_CacheInvalidate( GGD_DiscoveryCache_t * pxCache )
+{
+    configASSERT( pxCache != NULL );
+
+    memset( pxCache, 0, sizeof( *pxCache ) );
+    prvCacheUpdate( pxCache );
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t GGD_CacheConnect( GGD_DiscoveryCache_t * pxCache,
+                             GGD_HostAddressData_t * pxHostAddressData,
+                             Socket_t * pxSocket )
+{
+    GGD_HostAddressData_t xHosts[ ggdconfigCACHE_MAX_HOSTS ];
+    BaseType_t xConnectFailed[ ggdconfigCACHE_MAX_HOSTS ];
+    GGD_CachedHost_t xWinner;
+    Socket_t xSocket = SOCKETS_INVALID_SOCKET;
+    BaseType_t xWinnerIndex = -1;
+    BaseType_t xStatus = pdFAIL;
+    uint32_t ulIndex;
+
+    configASSERT( pxCache != NULL );
+    configASSERT( pxHostAddressData != NULL );
+
+    if( GGD_CacheIsValid( pxCache ) == pdTRUE )
+    {
+        for( ulIndex = 0; ulIndex < pxCache->ulHostCount; ulIndex++ )
+        {
+            xHosts[ ulIndex ].pcHostAddress = pxCache->xHosts[ ulIndex ].cHostAddress;
+            xHosts[ ulIndex ].usPort = pxCache->xHosts[ ulIndex ].usPort;
+            xHosts[ ulIndex ].pcCertificate = pxCache->cCertificate;
+            xHosts[ ulIndex ].ulCertificateSize = pxCache->ulCertificateSize;
+        }
+
+        xWinnerIndex = GGD_SecureConnect_ConnectFirst( xHosts,
+                                                       pxCache->ulHostCount,
+                                                       &xSocket,
+                                                       xConnectFailed,
+                                                       ggdconfigTCP_RECEIVE_TIMEOUT_MS,
+                                                       ggdconfigTCP_SEND_TIMEOUT_MS );
+
+        for( ulIndex = 0; ulIndex < pxCache->ulHostCount; ulIndex++ )
+        {
+            if( ( xConnectFailed[ ulIndex ] == pdTRUE ) &&
+                ( pxCache->xHosts[ ulIndex ].usFailedConnects < ( uint16_t ) 0xFFFF ) )
+            {
+                pxCache->xHosts[ ulIndex ].usFailedConnects++;
+            }
+        }
+
+        if( xWinnerIndex >= 0 )
+        {
+            /* The host connected to is tried first next time. */
+            xWinner = pxCache->xHosts[ xWinnerIndex ];
+            xWinner.usFailedConnects = 0;
+            memmove( &pxCache->xHosts[ 1 ],
+                     &pxCache->xHosts[ 0 ],
+                     ( size_t ) xWinnerIndex * sizeof( pxCache->xHosts[ 0 ] ) );
+            pxCache->xHosts[ 0 ] = xWinner;
+            pxCache->ulFailedConnects = 0;
+
+            xStatus = pdPASS;
+        }
+        else
+        {
+            ggdconfigPRINT( "GGD - Can't connect to any cached greengrass Core\r\n" );
+
+            pxCache->ulFailedConnects++;
+        }
+
+        prvCacheSortHosts( pxCache );
+        prvCacheUpdate( pxCache );
+    }
+
+    if( xStatus == pdPASS )
+    {
+        pxHostAddressData->pcHostAddress = pxCache->xHosts[ 0 ].cHostAddress;
+        pxHostAddressData->usPort = pxCache->xHosts[ 0 ].usPort;
+        pxHostAddressData->pcCertificate = pxCache->cCertificate;
+        pxHostAddressData->ulCertificateSize = pxCache->ulCertificateSize;
+
+        if( pxSocket == NULL )
+        {
+            GGD_SecureConnect_Disconnect( &xSocket );
+        }
+    }
+
+    if( pxSocket != NULL )
+    {
+        *pxSocket = xSocket;
+    }
+
+    return xStatus;
+}
+/*-----------------------------------------------------------*/
+
+static void prvCacheAddHost( GGD_DiscoveryCache_t * pxCache,
+                             const GGD_HostAddressData_t * pxHostAddressData )
+{
+    size_t xLength = strlen( pxHostAddressData->pcHostAddress );
+    uint32_t ulIndex;
+    BaseType_t xKeep = pdTRUE;
+
+    /* Secure sockets only connects over IPv4. */
+    if( ( prvIsIPvalid( pxHostAddressData->pcHostAddress, ( uint32_t ) xLength ) == pdFALSE ) ||
+        ( strchr( pxHostAddressData->pcHostAddress, ( int ) ':' ) != NULL ) )
+    {
+        xKeep = pdFALSE;
+    }
+    else if( xLength > ( size_t ) ggdconfigCACHE_MAX_HOST_LENGTH )
+    {
+        ggdconfigPRINT( "GGD - Host address too long for the cache: %s\r\n", pxHostAddressData->pcHostAddress );
+        xKeep = pdFALSE;
+    }
+    else if( pxCache->ulHostCount == ( uint32_t ) ggdconfigCACHE_MAX_HOSTS )
+    {
+        ggdconfigPRINT( "GGD - Cache full, host left out: %s\r\n", pxHostAddressData->pcHostAddress );
+        xKeep = pdFALSE;
+    }
+    else
+    {
+        /* Several cores may list the same address. */
+        for( ulIndex = 0; ulIndex < pxCache->ulHostCount; ulIndex++ )
+        {
+            if( ( strcmp( pxCache->xHosts[ ulIndex ].cHostAddress, pxHostAddressData->pcHostAddress ) == 0 ) &&
+                ( pxCache->xHosts[ ulIndex ].usPort == pxHostAddressData->usPort ) )
+            {
+                xKeep = pdFALSE;
+                break;
+            }
+        }
+    }
+
+    if( xKeep == pdTRUE )
+    {
+        memcpy( pxCache->xHosts[ pxCache->ulHostCount ].cHostAddress, pxHostAddressData->pcHostAddress, xLength + ( size_t ) 1 );
+        pxCache->xHosts[ pxCache->ulHostCount ].usPort = pxHostAddressData->usPort;
+        pxCache->ulHostCount++;
+    }
+}
+/*-----------------------------------------------------------*/
+
+static void prvCacheSortHosts( GGD_DiscoveryCache_t * pxCache )
+{
+    GGD_CachedHost_t xHost;
+    uint32_t ulIndex, ulPosition;
+
+    /* Insertion sort by the number of failed connections, which keeps the
+     * order of the hosts that failed as often. */
+    for( ulIndex = 1; ulIndex < pxCache->ulHostCount; ulIndex++ )
+    {
+        xHost = pxCache->xHosts[ ulIndex ];
+
+        for( ulPosition = ulIndex;
+             ( ulPosition > ( uint32_t ) 0 ) &&
+             ( pxCache->xHosts[ ulPosition - ( uint32_t ) 1 ].usFailedConnects > xHost.usFailedConnects );
+             ulPosition-- )
+        {
+            pxCache->xHosts[ ulPosition ] = pxCache->xHosts[ ulPosition - ( uint32_t ) 1 ];
+        }
+
+        pxCache->xHosts[ ulPosition ] = xHost;
+    }
+}
+/*-----------------------------------------------------------*/
+
+static uint32_t prvCacheChecksum( const GGD_DiscoveryCache_t * pxCache )
+{
+    const uint8_t * pucBytes = ( const uint8_t * ) pxCache;
+    const size_t xChecksumStart = offsetof( GGD_DiscoveryCache_t, ulChecksum );
+    const size_t xChecksumEnd = xChecksumStart + sizeof( pxCache->ulChecksum );
+    uint32_t ulHash = ggdCACHE_FNV_OFFSET_BASIS;
+    size_t xIndex;
+
+    /* FNV-1a over the whole cache except the checksum itself. */
+    for( xIndex = 0; xIndex < sizeof( *pxCache ); xIndex++ )
+    {
+        if( ( xIndex < xChecksumStart ) || ( xIndex >= xChecksumEnd ) )
+        {
+            ulHash ^= ( uint32_t ) pucBytes[ xIndex ];
+            ulHash *= ggdCACHE_FNV_PRIME;
+        }
+    }
+
+    return ulHash;
+}
+/*-----------------------------------------------------------*/
+
+static void prvCacheUpdate( GGD_DiscoveryCache_t * pxCache )
+{
+    uint32_t ulChecksum = prvCacheChecksum( pxCache );
+
+    /* Only write to non-volatile memory when the content changed. */
+    if( ulChecksum != pxCache->ulChecksum )
+    {
+        pxCache->ulChecksum = ulChecksum;
+        ggdconfigCACHE_SAVE( pxCache );
+    }
+}
+/*-----------------------------------------------------------*/
+
 /* Return true if the string " pcString" is found inside the token pxTok in JSON file pcJson. */
 static BaseType_t prvGGDJsoneq( const char * pcJson,    /*lint !e971 can use char without signed/unsigned. */
                                 const jsmntok_t * const pxTok,
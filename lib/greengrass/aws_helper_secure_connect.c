@@ -48,11 +48,59 @@
 
 #define helperMAX_IP_ADDRESS_OCTETS    4u
 
+/**
+ * @brief A connection attempted by GGD_SecureConnect_ConnectFirst().
+ */
+typedef struct ConnectAttempt
+{
+    struct ConnectRace * pxRace;            /**< The race the attempt belongs to. */
+    GGD_HostAddressData_t xHostAddressData; /**< Points at copies owned by the race. */
+    BaseType_t xFailed;                     /**< pdTRUE once the connection failed. */
+} ConnectAttempt_t;
+
+/**
+ * @brief State shared by GGD_SecureConnect_ConnectFirst() and its tasks.
+ *
+ * Allocated in one block with the attempts and the copies of the host
+ * addresses and the certificate.  The caller returns as soon as a connection
+ * succeeds while the other attempts finish in their own time, so the block is
+ * freed by whichever lets go of it last.
+ */
+typedef struct ConnectRace
+{
+    SemaphoreHandle_t xAttemptDone;  /**< Given by each attempt when it finishes. */
+    UBaseType_t uxReferences;        /**< The caller and the attempts still running. */
+    BaseType_t xAbandoned;           /**< pdTRUE once the caller returned. */
+    volatile BaseType_t xWinner;     /**< Index of the first host connected to, or -1. */
+    Socket_t xWinnerSocket;          /**< The socket connected to that host. */
+    uint32_t ulReceiveTimeOut;       /**< Receive timeout of the sockets, in milliseconds. */
+    uint32_t ulSendTimeOut;          /**< Send timeout of the sockets, in milliseconds. */
+    ConnectAttempt_t * pxAttempts;   /**< One attempt per host. */
+} ConnectRace_t;
+
 /**
  * @brief This function return non 0 if it is an IP and 0 if it isn't
  */
 static uint32_t prvIsIPaddress( const char * pcIPAddress );
 
+/**
+ * @brief Allocates a race and copies the hosts into it.
+ */
+static ConnectRace_t * prvCreateRace( const GGD_HostAddressData_t * pxHostAddressData,
+                                      const uint32_t ulHostCount,
+                                      uint32_t ulReceiveTimeOut,
+                                      uint32_t ulSendTimeOut );
+
+/**
+ * @brief Drops a reference to a race, and frees it with the last one.
+ */
+static void prvReleaseRace( ConnectRace_t * pxRace );
+
+/**
+ * @brief Task that attempts one connection of a race.
+ */
+static void prvConnectTask( void * pvParameters );
+
 /*-----------------------------------------------------------*/
 
 BaseType_t GGD_SecureConnect_Connect( const GGD_HostAddressData_t * pxHostAddressData,
@@ -179,6 +227,245 @@ BaseType_t GGD_SecureConnect_Connect( const GGD_HostAddressData_t * pxHostAddres
 }
 /*-----------------------------------------------------------*/
 
+BaseType_t GGD_SecureConnect_ConnectFirst( const GGD_HostAddressData_t * pxHostAddressData,
+                                           const uint32_t ulHostCount,
+                                           Socket_t * pxSocket,
+                                           BaseType_t * pxConnectFailed,
+                                           uint32_t ulReceiveTimeOut,
+                                           uint32_t ulSendTimeOut )
+{
+    ConnectRace_t * pxRace;
+    uint32_t ulStarted = 0, ulFinished = 0, ulIndex;
+    TickType_t xTicksToWait;
+    BaseType_t xWinner = -1;
+
+    configASSERT( pxHostAddressData != NULL );
+    configASSERT( ulHostCount > ( uint32_t ) 0 );
+    configASSERT( pxSocket != NULL );
+    configASSERT( pxConnectFailed != NULL );
+
+    *pxSocket = SOCKETS_INVALID_SOCKET;
+
+    for( ulIndex = 0; ulIndex < ulHostCount; ulIndex++ )
+    {
+        pxConnectFailed[ ulIndex ] = pdFALSE;
+    }
+
+    pxRace = prvCreateRace( pxHostAddressData, ulHostCount, ulReceiveTimeOut, ulSendTimeOut );
+
+    if( pxRace == NULL )
+    {
+        ggdconfigPRINT( "SecureConnect - not enough memory to start the connections\r\n" );
+    }
+    else
+    {
+        while( ( pxRace->xWinner < 0 ) &&
+               ( ( ulStarted < ulHostCount ) || ( ulFinished < ulStarted ) ) )
+        {
+            xTicksToWait = portMAX_DELAY;
+
+            if( ( ulStarted < ulHostCount ) &&
+                ( ( ulStarted - ulFinished ) < ( uint32_t ) ggdconfigCONNECT_MAX_PARALLEL ) )
+            {
+                /* The task holds a reference until it finishes. */
+                taskENTER_CRITICAL();
+                pxRace->uxReferences++;
+                taskEXIT_CRITICAL();
+
+                if( xTaskCreate( prvConnectTask,
+                                 "GGDConnect",
+                                 ggdconfigCONNECT_TASK_STACK_SIZE,
+                                 &pxRace->pxAttempts[ ulStarted ],
+                                 ggdconfigCONNECT_TASK_PRIORITY,
+                                 NULL ) == pdPASS )
+                {
+                    xTicksToWait = pdMS_TO_TICKS( ggdconfigCONNECT_ATTEMPT_DELAY_MS );
+                }
+                else
+                {
+                    /* Count the attempt as a failed one. */
+                    pxRace->pxAttempts[ ulStarted ].xFailed = pdTRUE;
+                    prvReleaseRace( pxRace );
+                    ulFinished++;
+                    xTicksToWait = 0;
+                }
+
+                ulStarted++;
+            }
+
+            /* Wait for an attempt to finish, or for the time to start the
+             * next one. */
+            if( ( xTicksToWait > ( TickType_t ) 0 ) &&
+                ( xSemaphoreTake( pxRace->xAttemptDone, xTicksToWait ) == pdTRUE ) )
+            {
+                ulFinished++;
+            }
+        }
+
+        /* From now on the attempts that connect close their connection. */
+        taskENTER_CRITICAL();
+        {
+            pxRace->xAbandoned = pdTRUE;
+            xWinner = pxRace->xWinner;
+
+            for( ulIndex = 0; ulIndex < ulHostCount; ulIndex++ )
+            {
+                pxConnectFailed[ ulIndex ] = pxRace->pxAttempts[ ulIndex ].xFailed;
+            }
+        }
+        taskEXIT_CRITICAL();
+
+        if( xWinner >= 0 )
+        {
+            *pxSocket = pxRace->xWinnerSocket;
+        }
+
+        prvReleaseRace( pxRace );
+    }
+
+    return xWinner;
+}
+/*-----------------------------------------------------------*/
+
+static ConnectRace_t * prvCreateRace( const GGD_HostAddressData_t * pxHostAddressData,
+                                      const uint32_t ulHostCount,
+                                      uint32_t ulReceiveTimeOut,
+                                      uint32_t ulSendTimeOut )
+{
+    ConnectRace_t * pxRace;
+    ConnectAttempt_t * pxAttempt;
+    char * pcCopy; /*lint !e971 can use char without signed/unsigned. */
+    char * pcCertificate = NULL; /*lint !e971 can use char without signed/unsigned. */
+    size_t xSize;
+    uint32_t ulIndex;
+
+    /* The race, the attempts, and the strings after them. */
+    xSize = sizeof( ConnectRace_t ) + ( ( size_t ) ulHostCount * sizeof( ConnectAttempt_t ) );
+
+    for( ulIndex = 0; ulIndex < ulHostCount; ulIndex++ )
+    {
+        configASSERT( pxHostAddressData[ ulIndex ].pcCertificate == pxHostAddressData[ 0 ].pcCertificate );
+        xSize += strlen( pxHostAddressData[ ulIndex ].pcHostAddress ) + ( size_t ) 1;
+    }
+
+    if( pxHostAddressData[ 0 ].pcCertificate != NULL )
+    {
+        xSize += ( size_t ) pxHostAddressData[ 0 ].ulCertificateSize;
+    }
+
+    pxRace = ( ConnectRace_t * ) pvPortMalloc( xSize );
+
+    if( pxRace != NULL )
+    {
+        pxRace->xAttemptDone = xSemaphoreCreateCounting( ( UBaseType_t ) ulHostCount, 0 );
+
+        if( pxRace->xAttemptDone == NULL )
+        {
+            vPortFree( pxRace );
+            pxRace = NULL;
+        }
+    }
+
+    if( pxRace != NULL )
+    {
+        pxRace->uxReferences = 1;
+        pxRace->xAbandoned = pdFALSE;
+        pxRace->xWinner = -1;
+        pxRace->xWinnerSocket = SOCKETS_INVALID_SOCKET;
+        pxRace->ulReceiveTimeOut = ulReceiveTimeOut;
+        pxRace->ulSendTimeOut = ulSendTimeOut;
+        pxRace->pxAttempts = ( ConnectAttempt_t * ) &pxRace[ 1 ];
+        pcCopy = ( char * ) &pxRace->pxAttempts[ ulHostCount ];
+
+        if( pxHostAddressData[ 0 ].pcCertificate != NULL )
+        {
+            pcCertificate = pcCopy;
+            memcpy( pcCertificate, pxHostAddressData[ 0 ].pcCertificate, pxHostAddressData[ 0 ].ulCertificateSize );
+            pcCopy += pxHostAddressData[ 0 ].ulCertificateSize;
+        }
+
+        for( ulIndex = 0; ulIndex < ulHostCount; ulIndex++ )
+        {
+            pxAttempt = &pxRace->pxAttempts[ ulIndex ];
+            pxAttempt->pxRace = pxRace;
+            pxAttempt->xFailed = pdFALSE;
+            pxAttempt->xHostAddressData = pxHostAddressData[ ulIndex ];
+            pxAttempt->xHostAddressData.pcCertificate = pcCertificate;
+
+            xSize = strlen( pxHostAddressData[ ulIndex ].pcHostAddress ) + ( size_t ) 1;
+            memcpy( pcCopy, pxHostAddressData[ ulIndex ].pcHostAddress, xSize );
+            pxAttempt->xHostAddressData.pcHostAddress = pcCopy;
+            pcCopy += xSize;
+        }
+    }
+
+    return pxRace;
+}
+/*-----------------------------------------------------------*/
+
+static void prvReleaseRace( ConnectRace_t * pxRace )
+{
+    UBaseType_t uxReferences;
+
+    taskENTER_CRITICAL();
+    {
+        pxRace->uxReferences--;
+        uxReferences = pxRace->uxReferences;
+    }
+    taskEXIT_CRITICAL();
+
+    if( uxReferences == ( UBaseType_t ) 0 )
+    {
+        vSemaphoreDelete( pxRace->xAttemptDone );
+        vPortFree( pxRace );
+    }
+}
+/*-----------------------------------------------------------*/
+
+static void prvConnectTask( void * pvParameters )
+{
+    ConnectAttempt_t * pxAttempt = ( ConnectAttempt_t * ) pvParameters;
+    ConnectRace_t * pxRace = pxAttempt->pxRace;
+    Socket_t xSocket;
+    BaseType_t xStatus;
+    BaseType_t xWon = pdFALSE;
+
+    xStatus = GGD_SecureConnect_Connect( &pxAttempt->xHostAddressData,
+                                         &xSocket,
+                                         pxRace->ulReceiveTimeOut,
+                                         pxRace->ulSendTimeOut );
+
+    taskENTER_CRITICAL();
+    {
+        if( xStatus == pdFAIL )
+        {
+            pxAttempt->xFailed = pdTRUE;
+        }
+        else if( ( pxRace->xWinner < 0 ) && ( pxRace->xAbandoned == pdFALSE ) )
+        {
+            pxRace->xWinner = ( BaseType_t ) ( pxAttempt - pxRace->pxAttempts );
+            pxRace->xWinnerSocket = xSocket;
+            xWon = pdTRUE;
+        }
+        else
+        {
+            /* Another host won, or the caller gave up. */
+        }
+    }
+    taskEXIT_CRITICAL();
+
+    if( ( xStatus == pdPASS ) && ( xWon == pdFALSE ) )
+    {
+        GGD_SecureConnect_Disconnect( &xSocket );
+    }
+
+    ( void ) xSemaphoreGive( pxRace->xAttemptDone );
+    prvReleaseRace( pxRace );
+
+    vTaskDelete( NULL );
+}
+/*-----------------------------------------------------------*/
+
 void GGD_SecureConnect_Disconnect( Socket_t * pxSocket )
 {
     const TickType_t xShortDelay = pdMS_TO_TICKS( 10 );
@@ -85,7 +85,8 @@ mqd_t mq_open( const char * name,
  *
  * http://pubs.opengroup.org/onlinepubs/9699919799/functions/mq_receive.html
  *
- * @note msg_prio is ignored. Messages are not checked for corruption.
+ * @note The oldest message of the highest priority is received. Messages are
+ * not checked for corruption.
  */
 ssize_t mq_receive( mqd_t mqdes,
                     char * msg_ptr,
@@ -97,7 +98,7 @@ ssize_t mq_receive( mqd_t mqdes,
  *
  * http://pubs.opengroup.org/onlinepubs/9699919799/functions/mq_send.html
  *
- * @note msg_prio is ignored.
+ * @note msg_prio must be less than MQ_PRIO_MAX.
  */
 int mq_send( mqd_t mqdes,
              const char * msg_ptr,
@@ -109,7 +110,8 @@ int mq_send( mqd_t mqdes,
  *
  * http://pubs.opengroup.org/onlinepubs/9699919799/functions/mq_timedreceive.html
  *
- * @note msg_prio is ignored. Messages are not checked for corruption.
+ * @note The oldest message of the highest priority is received. Messages are
+ * not checked for corruption.
  */
 ssize_t mq_timedreceive( mqd_t mqdes,
                          char * msg_ptr,
@@ -122,7 +124,7 @@ ssize_t mq_timedreceive( mqd_t mqdes,
  *
  * http://pubs.opengroup.org/onlinepubs/9699919799/functions/mq_timedsend.html
  *
- * @note msg_prio is ignored.
+ * @note msg_prio must be less than MQ_PRIO_MAX.
  */
 int mq_timedsend( mqd_t mqdes,
                   const char * msg_ptr,
@@ -83,6 +83,10 @@
     #define PTHREAD_MUTEX_INITIALIZER    FREERTOS_POSIX_MUTEX_INITIALIZER /**< pthread_mutex_t. */
 #endif
 
+#if posixconfigENABLE_PTHREAD_RWLOCK_T == 1
+    #define PTHREAD_RWLOCK_INITIALIZER    FREERTOS_POSIX_RWLOCK_INITIALIZER /**< pthread_rwlock_t. */
+#endif
+
 /**@} */
 
 /**
@@ -344,6 +348,80 @@ int pthread_mutexattr_init( pthread_mutexattr_t * attr );
 int pthread_mutexattr_settype( pthread_mutexattr_t * attr,
                                int type );
 
+/**
+ * @brief Destroy a read-write lock object.
+ *
+ * http://pubs.opengroup.org/onlinepubs/9699919799/functions/pthread_rwlock_destroy.html
+ *
+ * @note Returns EBUSY if the lock is held.
+ */
+int pthread_rwlock_destroy( pthread_rwlock_t * rwlock );
+
+/**
+ * @brief Initialize a read-write lock object.
+ *
+ * http://pubs.opengroup.org/onlinepubs/9699919799/functions/pthread_rwlock_init.html
+ *
+ * @note attr is ignored. Writers are preferred: once a writer is waiting, new
+ * readers block until it has unlocked. A thread that already holds a read
+ * lock must not take another one, as it may deadlock with a waiting writer.
+ */
+int pthread_rwlock_init( pthread_rwlock_t * rwlock,
+                         const pthread_rwlockattr_t * attr );
+
+/**
+ * @brief Lock a read-write lock object for reading.
+ *
+ * http://pubs.opengroup.org/onlinepubs/9699919799/functions/pthread_rwlock_rdlock.html
+ */
+int pthread_rwlock_rdlock( pthread_rwlock_t * rwlock );
+
+/**
+ * @brief Lock a read-write lock for reading with timeout.
+ *
+ * http://pubs.opengroup.org/onlinepubs/9699919799/functions/pthread_rwlock_timedrdlock.html
+ */
+int pthread_rwlock_timedrdlock( pthread_rwlock_t * rwlock,
+                                const struct timespec * abstime );
+
+/**
+ * @brief Lock a read-write lock for writing with timeout.
+ *
+ * http://pubs.opengroup.org/onlinepubs/9699919799/functions/pthread_rwlock_timedwrlock.html
+ */
+int pthread_rwlock_timedwrlock( pthread_rwlock_t * rwlock,
+                                const struct timespec * abstime );
+
+/**
+ * @brief Attempt to lock a read-write lock object for reading. Fail immediately
+ * if a writer holds or waits for the lock.
+ *
+ * http://pubs.opengroup.org/onlinepubs/9699919799/functions/pthread_rwlock_tryrdlock.html
+ */
+int pthread_rwlock_tryrdlock( pthread_rwlock_t * rwlock );
+
+/**
+ * @brief Attempt to lock a read-write lock object for writing. Fail immediately
+ * if the lock is held.
+ *
+ * http://pubs.opengroup.org/onlinepubs/9699919799/functions/pthread_rwlock_trywrlock.html
+ */
+int pthread_rwlock_trywrlock( pthread_rwlock_t * rwlock );
+
+/**
+ * @brief Unlock a read-write lock object.
+ *
+ * http://pubs.opengroup.org/onlinepubs/9699919799/functions/pthread_rwlock_unlock.html
+ */
+int pthread_rwlock_unlock( pthread_rwlock_t * rwlock );
+
+/**
+ * @brief Lock a read-write lock object for writing.
+ *
+ * http://pubs.opengroup.org/onlinepubs/9699919799/functions/pthread_rwlock_wrlock.html
+ */
+int pthread_rwlock_wrlock( pthread_rwlock_t * rwlock );
+
 /**
  * @brief Get the calling thread ID.
  *
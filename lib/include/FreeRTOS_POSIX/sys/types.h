@@ -109,6 +109,20 @@ typedef void                * pthread_barrierattr_t;
     typedef void            * pthread_mutexattr_t;
 #endif
 
+/**
+ * @brief Used for read-write locks.
+ */
+#if !defined( posixconfigENABLE_PTHREAD_RWLOCK_T ) || ( posixconfigENABLE_PTHREAD_RWLOCK_T == 1 )
+    typedef void            * pthread_rwlock_t;
+#endif
+
+/**
+ * @brief Used for read-write lock attributes.
+ */
+#if !defined( posixconfigENABLE_PTHREAD_RWLOCKATTR_T ) || ( posixconfigENABLE_PTHREAD_RWLOCKATTR_T == 1 )
+    typedef void            * pthread_rwlockattr_t;
+#endif
+
 /**
  * @brief Used to identify a thread.
  */
@@ -85,11 +85,15 @@ typedef enum
 } DefenderReportStatus_t;
 
 /** Maximum number of reportable metrics */
-#define DEFENDER_MAX_METRICS_COUNT    ( 1 )
+#define DEFENDER_MAX_METRICS_COUNT    ( 2 )
 
-/** Provides a count of established tcp connections */
+/** Provides the established tcp connections, with their remote address and
+ * local port, and a count of them */
 extern DefenderMetric_t xDefenderTCPConnections;
 
+/** Provides the tcp ports in the listening state and a count of them */
+extern DefenderMetric_t xDefenderListeningTCPPorts;
+
 /**
  * @param pxMetricsList List of the metrics to put in the report
  * @return DefenderErr_t
@@ -33,6 +33,8 @@
 #include "FreeRTOS.h"
 #include "aws_clientcredential.h"
 #include "aws_secure_sockets.h"
+#include "aws_ggd_config.h"
+#include "aws_ggd_config_defaults.h"
 
 /**
  * @brief Input from user to locate GGC inside JSON file.
@@ -64,6 +66,40 @@ typedef struct
     uint16_t usPort;            /**< Port to connect to the GGC. */
 } GGD_HostAddressData_t;
 
+/**
+ * @brief A Green Grass Core connectivity entry kept in the discovery cache.
+ */
+typedef struct
+{
+    char cHostAddress[ ggdconfigCACHE_MAX_HOST_LENGTH + 1 ]; /**< Host address, could be IP or hostname. */
+    uint16_t usPort;                                         /**< Port to connect to the GGC. */
+    uint16_t usFailedConnects;                               /**< Connections in a row that failed to this host. */
+} GGD_CachedHost_t;
+
+/**
+ * @brief Result of a discovery, kept so that reconnecting needs neither the
+ * discovery request nor the parsing of the JSON file.
+ *
+ * Allocated by the user.  It holds no pointers, so it can be written to
+ * non-volatile memory as it is (see ggdconfigCACHE_SAVE) and read back after
+ * a reset; a checksum makes a cache that was not written completely, or that
+ * was written by firmware with other cache sizes, invalid.  The hosts are kept
+ * in the order in which they are tried: the last one connected to first, the
+ * ones that failed most last.
+ */
+typedef struct
+{
+    uint32_t ulMagic;                                         /**< Marks an initialized cache. */
+    uint32_t ulChecksum;                                      /**< Checksum of the whole cache. */
+    uint32_t ulSize;                                          /**< Size of the cache, which changes with the configuration. */
+    uint32_t ulStoredTime;                                    /**< ggdconfigCACHE_TIME_SECONDS() at the discovery. */
+    uint32_t ulFailedConnects;                                /**< Connections in a row that failed to every host. */
+    uint32_t ulHostCount;                                     /**< Number of hosts. */
+    uint32_t ulCertificateSize;                               /**< Size of the certificate, including the null. */
+    GGD_CachedHost_t xHosts[ ggdconfigCACHE_MAX_HOSTS ];      /**< The hosts. */
+    char cCertificate[ ggdconfigCACHE_MAX_CERTIFICATE_SIZE ]; /**< Certificate of the group, in PEM format. */
+} GGD_DiscoveryCache_t;
+
 /*
  * @brief Connect directly to the green grass core.
  *
@@ -218,4 +254,99 @@ BaseType_t GGD_GetIPandCertificateFromJSON( char * pcJSONFile,
                                             const HostParameters_t * pxHostParameters,
                                             GGD_HostAddressData_t * pxHostAddressData,
                                             const BaseType_t xAutoSelectFlag );
+
+/*
+ * @brief Connect to the green grass core, with the discovery result cached.
+ *
+ * Same as GGD_GetGGCIPandCertificate, but when pxCache is valid the hosts it
+ * holds are tried first with GGD_CacheConnect, and the discovery request is
+ * only made when the cache is not valid or none of its hosts can be connected
+ * to.  The result of that request then replaces the content of the cache.
+ *
+ * @note pxCache must be initialized before the first call, either read back
+ * from non-volatile memory or cleared with GGD_CacheInvalidate.
+ *
+ * @param [in] pcBuffer: Memory buffer provided by the user, for the JSON file.
+ *
+ * @param [in] ulBufferSize: Size of the memory buffer.
+ *
+ * @param [in, out] pxCache: The discovery cache.
+ *
+ * @param [out] pxHostAddressData : host address data, which points into
+ * pxCache.
+ *
+ * @return If connection was successful then pdPASS is
+ * returned.  Otherwise pdFAIL is returned.
+ */
+BaseType_t GGD_GetGGCIPandCertificateCached( char * pcBuffer,
+                                             const uint32_t ulBufferSize,
+                                             GGD_DiscoveryCache_t * pxCache,
+                                             GGD_HostAddressData_t * pxHostAddressData );
+
+/*
+ * @brief Fill the discovery cache from a JSON file.
+ *
+ * The JSON file is parsed once, and every connectivity entry of every core
+ * is kept, up to ggdconfigCACHE_MAX_HOSTS, as with the auto select option of
+ * GGD_GetIPandCertificateFromJSON.  Loopback and IPv6 addresses are left out.
+ *
+ * @param [in] pcJSONFile: Pointer to the JSON file. WARNING, will be modified
+ * to format the certificate.
+ *
+ * @param [in] ulJSONFileSize: Size in byte of the array.
+ *
+ * @param [out] pxCache: The discovery cache, which is invalid if the function
+ * fails.
+ *
+ * @return pdPASS if a certificate and at least one host were found.
+ * Otherwise pdFAIL is returned.
+ */
+BaseType_t GGD_CacheFromJSON( char * pcJSONFile,
+                              const uint32_t ulJSONFileSize,
+                              GGD_DiscoveryCache_t * pxCache );
+
+/*
+ * @brief Check whether the discovery cache can be used.
+ *
+ * The cache is valid if it was filled by GGD_CacheFromJSON with the current
+ * configuration and was not modified since, if fewer than
+ * ggdconfigCACHE_MAX_FAILED_CONNECTS connections in a row failed to all its
+ * hosts, and if it is younger than ggdconfigCACHE_MAX_AGE_SECONDS.
+ *
+ * @param [in] pxCache: The discovery cache.
+ *
+ * @return pdTRUE if the cache is valid, pdFALSE otherwise.
+ */
+BaseType_t GGD_CacheIsValid( const GGD_DiscoveryCache_t * pxCache );
+
+/*
+ * @brief Make the discovery cache invalid, so that the next connection
+ * makes the discovery request.
+ *
+ * @param [out] pxCache: The discovery cache.
+ */
+void GGD_CacheInvalidate( GGD_DiscoveryCache_t * pxCache );
+
+/*
+ * @brief Connect to the first cached host that answers.
+ *
+ * The hosts are raced with GGD_SecureConnect_ConnectFirst, in the order of
+ * the cache.  The host connected to moves to the front of the cache, and the
+ * hosts that failed move towards the back.  When every host fails, the
+ * failure counts towards the validity of the cache.
+ *
+ * @param [in, out] pxCache: A valid discovery cache.
+ *
+ * @param [out] pxHostAddressData : host address data of the host connected
+ * to, which points into pxCache.
+ *
+ * @param [out] pxSocket: If not NULL, the socket connected to the host, which
+ * the user closes with SOCKETS_Shutdown and SOCKETS_Close.  If NULL, the
+ * connection is closed before returning.
+ *
+ * @return pdPASS if a host was connected to.  Otherwise pdFAIL is returned.
+ */
+BaseType_t GGD_CacheConnect( GGD_DiscoveryCache_t * pxCache,
+                             GGD_HostAddressData_t * pxHostAddressData,
+                             Socket_t * pxSocket );
 #endif /* _AWS_GREENGRASS_DISCOVERY_H_ */
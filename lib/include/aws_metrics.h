@@ -0,0 +1,88 @@
+/*
+ * Amazon FreeRTOS
+ * Copyright (C) 2018 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+/**
+ * @file aws_metrics.h
+ * @brief Metrics Publisher Interface.
+ *
+ * A low priority task that periodically samples the run time figures of the
+ * kernel, the heap, the network buffers and the MQTT and OTA agents, encodes
+ * them in CBOR and publishes them through the MQTT agent, so that changes in
+ * the performance of a fleet of devices can be watched from the cloud.  The
+ * report format is described in aws_metrics_report.h.
+ */
+
+#ifndef _AWS_METRICS_H_
+#define _AWS_METRICS_H_
+
+#include <stdint.h>
+
+/* MQTT agent include. */
+#include "aws_mqtt_agent.h"
+
+/* Library initialization definition include */
+#include "aws_lib_init.h"
+
+/**
+ * @brief Counters kept by the metrics publisher.
+ */
+typedef struct MetricsStats
+{
+    uint32_t ulReportsPublished; /**< Reports handed to the MQTT agent. */
+    uint32_t ulReportsFailed;    /**< Reports that could not be encoded or published. */
+    uint32_t ulLastReportSize;   /**< The size of the last report, in bytes. */
+} MetricsStats_t;
+
+/**
+ * @brief Creates the metrics task.
+ *
+ * The task does not publish anything until it is given a connection with
+ * METRICS_SetConnection().  Calls after the first one do nothing and return
+ * pdPASS.
+ *
+ * @return pdPASS if the task is running, pdFAIL otherwise.
+ */
+lib_initDECLARE_LIB_INIT( METRICS_Init );
+
+/**
+ * @brief Sets the MQTT connection the reports are published on.
+ *
+ * The connection is shared with the application, which remains responsible
+ * for connecting and disconnecting it.  Reports are published with QoS 0 and
+ * a short timeout, so a busy or broken connection delays the metrics task but
+ * nothing else.
+ *
+ * @param[in] xMQTTHandle A connected MQTT client, or NULL to stop publishing.
+ */
+void METRICS_SetConnection( MQTTAgentHandle_t xMQTTHandle );
+
+/**
+ * @brief Reads the metrics publisher counters.
+ *
+ * @param[out] pxStats Filled in with the current counters.
+ */
+void METRICS_GetStats( MetricsStats_t * pxStats );
+
+#endif /* _AWS_METRICS_H_ */
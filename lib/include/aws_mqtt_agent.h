@@ -186,6 +186,19 @@ typedef struct MQTTAgentPublishParams
     uint32_t ulDataLength;    /**< Length of the data. */
 } MQTTAgentPublishParams_t;
 
+/**
+ * @brief Counters kept by the MQTT agent, over all connections.
+ *
+ * The counters start at zero and wrap around.
+ */
+typedef struct MQTTAgentStats
+{
+    uint32_t ulPublishesSent;     /**< Publish messages passed to the network. */
+    uint32_t ulPublishesFailed;   /**< Publish requests that could not be sent. */
+    uint32_t ulPublishesReceived; /**< Publish messages received from brokers. */
+    uint32_t ulPacketsDropped;    /**< Received packets dropped for want of a buffer. */
+} MQTTAgentStats_t;
+
 /**
  * @brief MQTT library Init function.
  *
@@ -356,4 +369,11 @@ MQTTAgentReturnCode_t MQTT_AGENT_Publish( MQTTAgentHandle_t xMQTTHandle,
 MQTTAgentReturnCode_t MQTT_AGENT_ReturnBuffer( MQTTAgentHandle_t xMQTTHandle,
                                                MQTTBufferHandle_t xBufferHandle );
 
+/**
+ * @brief Reads the MQTT agent counters.
+ *
+ * @param[out] pxStats Filled in with the current counters.
+ */
+void MQTT_AGENT_GetStats( MQTTAgentStats_t * pxStats );
+
 #endif /* _AWS_MQTT_AGENT_H_ */
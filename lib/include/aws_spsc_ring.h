@@ -0,0 +1,193 @@
+/*
+ * Amazon FreeRTOS
+ * Copyright (C) 2018 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+/**
+ * @file aws_spsc_ring.h
+ * @brief Single Producer Single Consumer Ring Interface.
+ *
+ * A ring of fixed size slots that passes data from one producer, typically an
+ * interrupt or a thread outside the scheduler, to one consumer task.  Neither
+ * side takes a lock or masks interrupts: the producer only writes the head
+ * index and the consumer only writes the tail index, with memory barriers
+ * ordering the accesses to the slots against the accesses to the indexes.
+ *
+ * Data is written and read in place.  The producer acquires free slots, fills
+ * them and commits them, all at once, so an interrupt that receives several
+ * items pays for the barriers and the wake up once; the consumer acquires the
+ * oldest committed slot, uses it and releases it.
+ *
+ * The consumer can block until a number of slots are committed.  The
+ * producer only gives it a task notification when it is blocked and the count
+ * has reached that threshold, rather than for every slot.
+ */
+
+#ifndef _AWS_SPSC_RING_H_
+#define _AWS_SPSC_RING_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+
+/**
+ * @brief A ring.
+ *
+ * Allocated by the user, typically statically, and only accessed through the
+ * functions below.
+ */
+typedef struct SPSCRing
+{
+    uint8_t * pucStorage;         /**< The slots, one after the other. */
+    size_t xSlotSize;             /**< The size of a slot in bytes. */
+    uint32_t ulMask;              /**< The number of slots minus one. */
+    volatile uint32_t ulHead;     /**< Slots committed, ever.  Written by the producer only. */
+    volatile uint32_t ulTail;     /**< Slots released, ever.  Written by the consumer only. */
+    TaskHandle_t xConsumer;       /**< The task to notify, or NULL. */
+    UBaseType_t uxNotifyIndex;    /**< The notification index used to wake xConsumer. */
+    uint32_t ulWakeThreshold;     /**< The count at which xConsumer is notified. */
+    uint32_t ulAcquired;          /**< Slots acquired and not yet committed.  Producer only. */
+    volatile BaseType_t xWaiting; /**< pdTRUE while xConsumer waits in SPSCRING_Wait(). */
+} SPSCRing_t;
+
+/**
+ * @brief Initializes a ring.
+ *
+ * Must be called before the producer or the consumer use the ring.
+ *
+ * @param[out] pxRing The ring.
+ * @param[in] pvStorage The memory for the slots, ulSlotCount * xSlotSize
+ * bytes.  Slots are as aligned as pvStorage is and as xSlotSize allows.
+ * @param[in] xSlotSize The size of a slot in bytes.
+ * @param[in] ulSlotCount The number of slots, which must be a power of two.
+ */
+void SPSCRING_Init( SPSCRing_t * pxRing,
+                    void * pvStorage,
+                    size_t xSlotSize,
+                    uint32_t ulSlotCount );
+
+/**
+ * @brief Sets the task that SPSCRING_Wait() wakes up.
+ *
+ * Must be called before the producer starts, or while it is stopped.  A ring
+ * without a consumer task never notifies, so its producer may run where no
+ * FreeRTOS function can be called, such as a thread outside the scheduler;
+ * the consumer then has to poll.
+ *
+ * @param[in] pxRing The ring.
+ * @param[in] xConsumer The consumer task, or NULL to stop the notifications.
+ * @param[in] uxIndexToNotify The notification index used.  Other tasks may
+ * notify the consumer on it to end SPSCRING_Wait() early.
+ * @param[in] ulWakeThreshold The number of committed slots at which the
+ * consumer is woken, at least 1.  A larger threshold saves wake ups when data
+ * comes in bursts, at the cost of latency for the first slots of a burst.
+ */
+void SPSCRING_SetConsumer( SPSCRing_t * pxRing,
+                           TaskHandle_t xConsumer,
+                           UBaseType_t uxIndexToNotify,
+                           uint32_t ulWakeThreshold );
+
+/**
+ * @brief Acquires the next free slot, producer side.
+ *
+ * Each call acquires one more slot, until the slots acquired are committed.
+ * A producer that may not fill a slot it acquired keeps it for next time.
+ *
+ * @param[in] pxRing The ring.
+ *
+ * @return The slot, or NULL if the ring is full.
+ */
+void * SPSCRING_AcquireWrite( SPSCRing_t * pxRing );
+
+/**
+ * @brief Commits the slots acquired with SPSCRING_AcquireWrite(), from a
+ * task.
+ *
+ * @param[in] pxRing The ring.
+ */
+void SPSCRING_CommitWrite( SPSCRing_t * pxRing );
+
+/**
+ * @brief Commits the slots acquired with SPSCRING_AcquireWrite(), from an
+ * interrupt.
+ *
+ * @param[in] pxRing The ring.
+ * @param[out] pxHigherPriorityTaskWoken Set to pdTRUE if the consumer was
+ * woken and has a priority above the interrupted task, in which case a
+ * context switch should be requested before the interrupt exits.
+ */
+void SPSCRING_CommitWriteFromISR( SPSCRing_t * pxRing,
+                                  BaseType_t * pxHigherPriorityTaskWoken );
+
+/**
+ * @brief Acquires the oldest committed slot, consumer side.
+ *
+ * The same slot is returned until it is released.
+ *
+ * @param[in] pxRing The ring.
+ *
+ * @return The slot, or NULL if the ring is empty.
+ */
+void * SPSCRING_AcquireRead( SPSCRing_t * pxRing );
+
+/**
+ * @brief Releases the slot returned by SPSCRING_AcquireRead(), so that the
+ * producer can use it again.
+ *
+ * @param[in] pxRing The ring.
+ */
+void SPSCRING_ReleaseRead( SPSCRing_t * pxRing );
+
+/**
+ * @brief Returns the number of committed slots not yet released.
+ *
+ * The count may change as soon as it is read, unless it is read by the
+ * producer, for which it can only go down, or by the consumer, for which it
+ * can only go up.
+ *
+ * @param[in] pxRing The ring.
+ *
+ * @return The number of slots.
+ */
+uint32_t SPSCRING_GetCount( const SPSCRing_t * pxRing );
+
+/**
+ * @brief Waits until the wake threshold is reached, consumer side.
+ *
+ * Must be called by the task set with SPSCRING_SetConsumer().  The wait also
+ * ends when the consumer is notified on the ring's index, so a task can wait
+ * for the ring and for other events at once; it then has to check both.
+ *
+ * @param[in] pxRing The ring.
+ * @param[in] xTicksToWait The longest time to wait.
+ *
+ * @return The number of committed slots, which is below the threshold if the
+ * wait timed out or was ended by a notification from elsewhere.
+ */
+uint32_t SPSCRING_Wait( SPSCRing_t * pxRing,
+                        TickType_t xTicksToWait );
+
+#endif /* _AWS_SPSC_RING_H_ */
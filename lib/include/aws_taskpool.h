@@ -0,0 +1,155 @@
+/*
+ * Amazon FreeRTOS
+ * Copyright (C) 2018 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+/**
+ * @file aws_taskpool.h
+ * @brief Task Pool Interface.
+ *
+ * A fixed set of worker tasks that run short jobs on behalf of other tasks,
+ * so that a slow job does not hold up the task that submitted it.
+ */
+
+#ifndef _AWS_TASKPOOL_H_
+#define _AWS_TASKPOOL_H_
+
+#include <stdint.h>
+#include "aws_lib_init.h"
+
+/**
+ * @brief The function run by a job.
+ *
+ * The same prototype as PendedFunction_t, so a job carries a pointer and a
+ * 32-bit value and needs no memory of its own.
+ *
+ * @param[in] pvParameter1 The first parameter given to the submit function.
+ * @param[in] ulParameter2 The second parameter given to the submit function.
+ */
+typedef void ( * TaskPoolFunction_t )( void * pvParameter1,
+                                       uint32_t ulParameter2 );
+
+/**
+ * @brief The lanes a job can be submitted to.
+ *
+ * Every worker runs all the jobs waiting in the high lane, its own and those
+ * it can steal, before any job waiting in the normal lane.
+ */
+typedef enum
+{
+    eTaskPoolLaneHigh = 0, /**< Jobs that must not wait behind routine work. */
+    eTaskPoolLaneNormal    /**< Everything else. */
+} TaskPoolLane_t;
+
+/**
+ * @brief Counters kept by the task pool.
+ */
+typedef struct TaskPoolStats
+{
+    uint32_t ulJobsRun;      /**< Jobs that have completed. */
+    uint32_t ulJobsStolen;   /**< Jobs that a worker took from another worker's queue. */
+    uint32_t ulJobsRejected; /**< Submissions that failed because a queue was full. */
+} TaskPoolStats_t;
+
+/**
+ * @brief Creates the worker tasks.
+ *
+ * This function must be called before any other task pool function.  The
+ * libraries that use the pool call it from their own initialization, so
+ * calls after the first one do nothing and return pdPASS.
+ *
+ * @return pdPASS if the workers are running, pdFAIL otherwise.
+ */
+lib_initDECLARE_LIB_INIT( TASKPOOL_Init );
+
+/**
+ * @brief Queues a job to run on any worker.
+ *
+ * A job submitted from a worker is queued on that worker, otherwise the
+ * workers are used in turn.  A worker with nothing to do steals the most
+ * recently queued job from a busy worker, so jobs submitted with this function
+ * can run in any order and at the same time as each other.
+ *
+ * @param[in] pxFunction The function to run.
+ * @param[in] pvParameter1 Passed to pxFunction as it is.
+ * @param[in] ulParameter2 Passed to pxFunction as it is.
+ * @param[in] eLane The lane to queue the job in.
+ *
+ * @return pdPASS if the job was queued, pdFAIL if the lane is full on every
+ * worker.  The call never blocks.
+ */
+BaseType_t TASKPOOL_Submit( TaskPoolFunction_t pxFunction,
+                            void * pvParameter1,
+                            uint32_t ulParameter2,
+                            TaskPoolLane_t eLane );
+
+/**
+ * @brief Queues a job to run on one particular worker.
+ *
+ * The job cannot be stolen, so jobs submitted to the same worker in the same
+ * lane run one after another in the order in which they were submitted.  Use
+ * this for callbacks that were written to run on a single task.
+ *
+ * @param[in] uxWorker The worker, less than taskpoolconfigNUM_WORKERS.
+ * @param[in] pxFunction The function to run.
+ * @param[in] pvParameter1 Passed to pxFunction as it is.
+ * @param[in] ulParameter2 Passed to pxFunction as it is.
+ * @param[in] eLane The lane to queue the job in.
+ *
+ * @return pdPASS if the job was queued, pdFAIL if the lane of that worker is
+ * full.  The call never blocks.
+ */
+BaseType_t TASKPOOL_SubmitToWorker( UBaseType_t uxWorker,
+                                    TaskPoolFunction_t pxFunction,
+                                    void * pvParameter1,
+                                    uint32_t ulParameter2,
+                                    TaskPoolLane_t eLane );
+
+/**
+ * @brief A version of TASKPOOL_Submit() that can be called from an interrupt.
+ *
+ * @param[in] pxFunction The function to run.
+ * @param[in] pvParameter1 Passed to pxFunction as it is.
+ * @param[in] ulParameter2 Passed to pxFunction as it is.
+ * @param[in] eLane The lane to queue the job in.
+ * @param[out] pxHigherPriorityTaskWoken Set to pdTRUE if a worker with a
+ * priority above the interrupted task was woken, in which case a context switch
+ * should be requested before the interrupt exits.
+ *
+ * @return pdPASS if the job was queued, pdFAIL if the lane is full on every
+ * worker.
+ */
+BaseType_t TASKPOOL_SubmitFromISR( TaskPoolFunction_t pxFunction,
+                                   void * pvParameter1,
+                                   uint32_t ulParameter2,
+                                   TaskPoolLane_t eLane,
+                                   BaseType_t * pxHigherPriorityTaskWoken );
+
+/**
+ * @brief Reads the task pool counters.
+ *
+ * @param[out] pxStats Filled in with the current counters.
+ */
+void TASKPOOL_GetStats( TaskPoolStats_t * pxStats );
+
+#endif /* _AWS_TASKPOOL_H_ */
@@ -0,0 +1,141 @@
+/*
+ * Amazon FreeRTOS
+ * Copyright (C) 2018 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+/**
+ * @file aws_trace_ring.h
+ * @brief Trace Ring Interface.
+ *
+ * An always on record of what the scheduler did recently.  The kernel trace
+ * macros in aws_trace_ring_hooks.h write fixed size binary records into a
+ * statically allocated ring buffer, overwriting the oldest records once it is
+ * full.  TRACERING_Dump() writes the ring out on demand, for example from a
+ * console command or before a watchdog reset, and tools/trace_ring decodes the
+ * dump into scheduler latency histograms and per task timelines.
+ *
+ * The dump is a TraceRingHeader_t, followed by one TraceRingTask_t and a task
+ * name of usTaskNameLength bytes for each task that exists at the time of the
+ * dump, followed by the records, oldest first.  All fields are in the byte
+ * order of the target.
+ */
+
+#ifndef _AWS_TRACE_RING_H_
+#define _AWS_TRACE_RING_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+
+/* The event values. */
+#include "aws_trace_ring_hooks.h"
+
+/**
+ * @brief The first field of a dump, "FRTR" when read as bytes on a little
+ * endian target.
+ */
+#define traceringMAGIC      ( 0x52545246UL )
+
+/**
+ * @brief The version of the dump format.
+ */
+#define traceringVERSION    ( 1 )
+
+/**
+ * @brief The start of a dump.
+ */
+typedef struct TraceRingHeader
+{
+    uint32_t ulMagic;          /**< traceringMAGIC. */
+    uint16_t usVersion;        /**< traceringVERSION. */
+    uint16_t usRecordSize;     /**< sizeof( TraceRingRecord_t ). */
+    uint32_t ulTimestampHz;    /**< The number of timestamp units per second. */
+    uint32_t ulRecordCount;    /**< The number of records in the dump. */
+    uint32_t ulRecordsLost;    /**< Records overwritten or dropped since the ring was cleared. */
+    uint16_t usTaskCount;      /**< The number of task descriptions in the dump. */
+    uint16_t usTaskNameLength; /**< The length of the name that follows each task description. */
+} TraceRingHeader_t;
+
+/**
+ * @brief A task description in a dump.
+ */
+typedef struct TraceRingTask
+{
+    uint32_t ulTaskNumber; /**< The task's number, as in the records. */
+    uint32_t ulPriority;   /**< The task's base priority. */
+} TraceRingTask_t;
+
+/**
+ * @brief One event.
+ */
+typedef struct TraceRingRecord
+{
+    uint32_t ulTimestamp; /**< When the event happened, in units of ulTimestampHz. */
+    uint16_t usTask;      /**< The number of the task the event is about, 0 before the first task was created. */
+    uint8_t ucEvent;      /**< One of the traceringEVENT_ values. */
+    uint8_t ucReserved;   /**< Always 0. */
+    uint32_t ulArg1;      /**< Event specific. */
+    uint32_t ulArg2;      /**< Event specific. */
+} TraceRingRecord_t;
+
+/**
+ * @brief The function TRACERING_Dump() writes the dump to, in pieces.
+ *
+ * @param[in] pvContext The context given to TRACERING_Dump().
+ * @param[in] pvData The next piece of the dump.
+ * @param[in] xLength The length of pvData in bytes.
+ *
+ * @return pdPASS to continue, pdFAIL to abandon the dump.
+ */
+typedef BaseType_t ( * TraceRingWriter_t )( void * pvContext,
+                                            const void * pvData,
+                                            size_t xLength );
+
+/**
+ * @brief Writes the contents of the ring out.
+ *
+ * Recording stops while the dump is written, so the dump is consistent and
+ * does not contain its own allocations.  Events that happen in the meantime
+ * are counted as lost.  The ring is not cleared.
+ *
+ * Must be called from a task, with the scheduler running.
+ *
+ * @param[in] pxWriter Called with each piece of the dump.
+ * @param[in] pvContext Passed to pxWriter as it is.
+ *
+ * @return pdPASS if the whole dump was written, pdFAIL if pxWriter failed or
+ * there was not enough memory to list the tasks.
+ */
+BaseType_t TRACERING_Dump( TraceRingWriter_t pxWriter,
+                           void * pvContext );
+
+/**
+ * @brief Discards all records and resets the lost record count.
+ *
+ * Must be called from a task.
+ */
+void TRACERING_Clear( void );
+
+#endif /* _AWS_TRACE_RING_H_ */
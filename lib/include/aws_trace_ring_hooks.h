@@ -0,0 +1,157 @@
+/*
+ * Amazon FreeRTOS
+ * Copyright (C) 2018 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+/**
+ * @file aws_trace_ring_hooks.h
+ * @brief Kernel trace macros that record into the trace ring.
+ *
+ * Include this file at the bottom of FreeRTOSConfig.h to feed the trace ring
+ * described in aws_trace_ring.h.  It only defines the trace macros that the
+ * application has not already defined, and it needs nothing but the standard
+ * integer types, because FreeRTOSConfig.h is included before any of the kernel
+ * types are declared.
+ *
+ * Every macro expands to a call to TRACERING_Record(), which is short enough
+ * to be called from within the scheduler and from interrupts.
+ */
+
+#ifndef _AWS_TRACE_RING_HOOKS_H_
+#define _AWS_TRACE_RING_HOOKS_H_
+
+#include <stdint.h>
+
+/**
+ * @defgroup TraceRingEvents The events kept in the trace ring.
+ *
+ * These values are part of the dump format read by tools/trace_ring, so
+ * existing values must never change.
+ */
+/** @{ */
+#define traceringEVENT_TASK_SWITCHED_IN                    ( 1 )  /**< Task started running.  Arg1: its priority. */
+#define traceringEVENT_TASK_READY                          ( 2 )  /**< Task entered the Ready state.  Arg1: its priority. */
+#define traceringEVENT_QUEUE_SEND                          ( 3 )  /**< Task wrote to a queue or gave a semaphore.  Arg1: the queue. */
+#define traceringEVENT_BLOCKING_ON_QUEUE_RECEIVE           ( 4 )  /**< Task blocked reading a queue.  Arg1: the queue. */
+#define traceringEVENT_BLOCKING_ON_QUEUE_PEEK              ( 5 )  /**< Task blocked peeking a queue.  Arg1: the queue. */
+#define traceringEVENT_BLOCKING_ON_QUEUE_SEND              ( 6 )  /**< Task blocked writing a full queue.  Arg1: the queue. */
+#define traceringEVENT_BLOCKING_ON_STREAM_BUFFER_RECEIVE   ( 7 )  /**< Task blocked reading a stream buffer.  Arg1: the buffer. */
+#define traceringEVENT_BLOCKING_ON_STREAM_BUFFER_SEND      ( 8 )  /**< Task blocked writing a stream buffer.  Arg1: the buffer. */
+#define traceringEVENT_MALLOC                              ( 9 )  /**< Task allocated memory.  Arg1: the block, Arg2: its size. */
+#define traceringEVENT_FREE                                ( 10 ) /**< Task freed memory.  Arg1: the block, Arg2: its size if known. */
+#define traceringEVENT_PRIORITY_INHERIT                    ( 11 ) /**< A mutex holder inherited a priority.  Arg1: the new priority. */
+#define traceringEVENT_PRIORITY_DISINHERIT                 ( 12 ) /**< A mutex holder dropped back.  Arg1: the restored priority. */
+/** @} */
+
+/**
+ * @brief Adds one event to the trace ring.
+ *
+ * Called by the trace macros below, it should not be called directly.
+ *
+ * @param[in] ucEvent One of the traceringEVENT_ values.
+ * @param[in] pvTask The task the event is about, or NULL for the calling task.
+ * @param[in] ulArg1 First event argument, see the event values.
+ * @param[in] ulArg2 Second event argument, see the event values.
+ */
+void TRACERING_Record( uint8_t ucEvent,
+                       void * pvTask,
+                       uint32_t ulArg1,
+                       uint32_t ulArg2 );
+
+/**
+ * @brief Addresses are recorded as their low 32 bits, which is enough to tell
+ * the queues and the memory blocks apart.
+ */
+#define traceringADDRESS( pv )    ( ( uint32_t ) ( uintptr_t ) ( pv ) )
+
+/* The task macros are expanded within tasks.c, where the TCB is visible.
+ * Records name tasks by the number that uxTaskGetTaskNumber() returns, which
+ * is set to the number in the TCB when the task is created.  An application
+ * that uses vTaskSetTaskNumber() for its own purposes must define
+ * traceTASK_CREATE() itself. */
+#ifndef traceTASK_CREATE
+    #define traceTASK_CREATE( pxNewTCB ) \
+    ( pxNewTCB )->uxTaskNumber = ( pxNewTCB )->uxTCBNumber
+#endif
+
+#ifndef traceTASK_SWITCHED_IN
+    #define traceTASK_SWITCHED_IN() \
+    TRACERING_Record( traceringEVENT_TASK_SWITCHED_IN, pxCurrentTCB, ( uint32_t ) pxCurrentTCB->uxPriority, 0 )
+#endif
+
+#ifndef traceMOVED_TASK_TO_READY_STATE
+    #define traceMOVED_TASK_TO_READY_STATE( pxTCB ) \
+    TRACERING_Record( traceringEVENT_TASK_READY, ( pxTCB ), ( uint32_t ) ( pxTCB )->uxPriority, 0 )
+#endif
+
+#ifndef traceTASK_PRIORITY_INHERIT
+    #define traceTASK_PRIORITY_INHERIT( pxTCBOfMutexHolder, uxInheritedPriority ) \
+    TRACERING_Record( traceringEVENT_PRIORITY_INHERIT, ( pxTCBOfMutexHolder ), ( uint32_t ) ( uxInheritedPriority ), 0 )
+#endif
+
+#ifndef traceTASK_PRIORITY_DISINHERIT
+    #define traceTASK_PRIORITY_DISINHERIT( pxTCBOfMutexHolder, uxOriginalPriority ) \
+    TRACERING_Record( traceringEVENT_PRIORITY_DISINHERIT, ( pxTCBOfMutexHolder ), ( uint32_t ) ( uxOriginalPriority ), 0 )
+#endif
+
+#ifndef traceQUEUE_SEND
+    #define traceQUEUE_SEND( pxQueue ) \
+    TRACERING_Record( traceringEVENT_QUEUE_SEND, NULL, traceringADDRESS( pxQueue ), 0 )
+#endif
+
+#ifndef traceBLOCKING_ON_QUEUE_RECEIVE
+    #define traceBLOCKING_ON_QUEUE_RECEIVE( pxQueue ) \
+    TRACERING_Record( traceringEVENT_BLOCKING_ON_QUEUE_RECEIVE, NULL, traceringADDRESS( pxQueue ), 0 )
+#endif
+
+#ifndef traceBLOCKING_ON_QUEUE_PEEK
+    #define traceBLOCKING_ON_QUEUE_PEEK( pxQueue ) \
+    TRACERING_Record( traceringEVENT_BLOCKING_ON_QUEUE_PEEK, NULL, traceringADDRESS( pxQueue ), 0 )
+#endif
+
+#ifndef traceBLOCKING_ON_QUEUE_SEND
+    #define traceBLOCKING_ON_QUEUE_SEND( pxQueue ) \
+    TRACERING_Record( traceringEVENT_BLOCKING_ON_QUEUE_SEND, NULL, traceringADDRESS( pxQueue ), 0 )
+#endif
+
+#ifndef traceBLOCKING_ON_STREAM_BUFFER_RECEIVE
+    #define traceBLOCKING_ON_STREAM_BUFFER_RECEIVE( xStreamBuffer ) \
+    TRACERING_Record( traceringEVENT_BLOCKING_ON_STREAM_BUFFER_RECEIVE, NULL, traceringADDRESS( xStreamBuffer ), 0 )
+#endif
+
+#ifndef traceBLOCKING_ON_STREAM_BUFFER_SEND
+    #define traceBLOCKING_ON_STREAM_BUFFER_SEND( xStreamBuffer ) \
+    TRACERING_Record( traceringEVENT_BLOCKING_ON_STREAM_BUFFER_SEND, NULL, traceringADDRESS( xStreamBuffer ), 0 )
+#endif
+
+#ifndef traceMALLOC
+    #define traceMALLOC( pvAddress, uiSize ) \
+    TRACERING_Record( traceringEVENT_MALLOC, NULL, traceringADDRESS( pvAddress ), ( uint32_t ) ( uiSize ) )
+#endif
+
+#ifndef traceFREE
+    #define traceFREE( pvAddress, uiSize ) \
+    TRACERING_Record( traceringEVENT_FREE, NULL, traceringADDRESS( pvAddress ), ( uint32_t ) ( uiSize ) )
+#endif
+
+#endif /* _AWS_TRACE_RING_HOOKS_H_ */
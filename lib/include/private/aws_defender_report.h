@@ -25,14 +25,51 @@
 #ifndef AWS_DEFENDER_REPORT_H /* Guards against multiple inclusion */
 #define AWS_DEFENDER_REPORT_H
 
-#include "aws_cbor.h"
+#include "cbor.h"
 #include "aws_defender_report_utils.h"
+#include <stddef.h>
+#include <stdint.h>
 
 #define DEFENDER_HEADER_TAG     DEFENDER_SelectTag( "header", "hed" )
 #define DEFENDER_METRICS_TAG    DEFENDER_SelectTag( "metrics", "met" )
 #define DEFENDER_TOTAL_TAG      DEFENDER_SelectTag( "total", "t" )
 
-CBORHandle_t CreateReport( void );
+/**
+ * @brief Size (in bytes) of the buffer the agent encodes each report into
+ *
+ * The buffer is allocated statically by the agent, so building a report does
+ * not use the heap.  Increase this if more metrics are enabled.
+ */
+#ifndef DEFENDER_REPORT_MAX_SIZE
+    #define DEFENDER_REPORT_MAX_SIZE    ( 1024 )
+#endif
+
+/**
+ * @brief Takes a new snapshot of the data of every metric
+ *
+ * Metrics that share their data, such as the TCP connections and the
+ * listening ports, refresh it once, so that they report the same snapshot.
+ * Refreshing may block, e.g. to ask the IP task for its sockets, so this must
+ * not be called with the scheduler suspended.
+ */
+void UpdateMetrics( void );
+
+/**
+ * @brief Encodes the header and all metrics into the caller's buffer
+ *
+ * The metrics are encoded as seen by the last call to UpdateMetrics.  The
+ * report is written in a single pass, does not block and no memory is
+ * allocated.
+ *
+ * @param pucBuffer     Buffer to encode the report into
+ * @param xBufferSize   Size of the buffer in bytes
+ * @param pxReportSize  Receives the size of the encoded report in bytes
+ * @return CborNoError on success, CborErrorOutOfMemory if the buffer is too
+ *     small
+ */
+CborError CreateReport( uint8_t * /*pucBuffer*/,
+                        size_t /*xBufferSize*/,
+                        size_t * /*pxReportSize*/ );
 
 #endif /* ifndef AWS_DEFENDER_REPORT_H */
 
@@ -25,8 +25,8 @@
 #ifndef AWS_DEFENDER_REPORT_CPU_H /* Guards against multiple inclusion */
 #define AWS_DEFENDER_REPORT_CPU_H
 
-#include "aws_cbor.h"
+#include "cbor.h"
 
-CBORHandle_t CpuReportGet( void );
+CborError CpuReportGet( CborEncoder * /*pxMetricsMap*/ );
 
 #endif /* ifndef AWS_DEFENDER_CPU_H */
@@ -25,13 +25,21 @@
 #ifndef AWS_DEFENDER_REPORT_TCP_CONN_H
 #define AWS_DEFENDER_REPORT_TCP_CONN_H
 
-#include "aws_cbor.h"
+#include "cbor.h"
 #include "aws_defender_report_utils.h"
 
 #define DEFENDER_TCP_CONN_TAG    DEFENDER_SelectTag( "tcp_connections", "tc" )
 #define DEFENDER_EST_CONN_TAG \
     DEFENDER_SelectTag( "established_connections", "ec" )
+#define DEFENDER_CONNECTIONS_TAG    DEFENDER_SelectTag( "connections", "cs" )
+#define DEFENDER_REMOTE_ADDR_TAG    DEFENDER_SelectTag( "remote_addr", "rad" )
+#define DEFENDER_LOCAL_PORT_TAG     DEFENDER_SelectTag( "local_port", "lp" )
+#define DEFENDER_TCP_PORTS_TAG \
+    DEFENDER_SelectTag( "listening_tcp_ports", "tp" )
+#define DEFENDER_PORTS_TAG          DEFENDER_SelectTag( "ports", "pts" )
+#define DEFENDER_PORT_TAG           DEFENDER_SelectTag( "port", "pt" )
 
-CBORHandle_t TcpConnReportGet( void );
+CborError TcpConnReportGet( CborEncoder * /*pxMetricsMap*/ );
+CborError TcpPortsReportGet( CborEncoder * /*pxMetricsMap*/ );
 
 #endif /* end of include guard: AWS_DEFENDER_REPORT_TCP_CONN_H */
@@ -25,10 +25,16 @@
 #ifndef AWS_REPORT_TYPES_H
 #define AWS_REPORT_TYPES_H
 
-#include "aws_cbor.h"
+#include "cbor.h"
 
 typedef void (* UpdateMetric_t)( void );
-typedef CBORHandle_t (* ReportMetric_t)( void );
+
+/**
+ * @brief Encodes one metric into the metrics map of the report
+ *
+ * Each metric writes exactly one key/value pair into the map.
+ */
+typedef CborError (* ReportMetric_t)( CborEncoder * /*pxMetricsMap*/ );
 
 struct DefenderMetric_s
 {
@@ -25,7 +25,45 @@
 #ifndef AWS_DEFENDER_TCP_CONN_H
 #define AWS_DEFENDER_TCP_CONN_H
 
+#include <stdint.h>
+
+/**
+ * Maximum number of established connections and of listening ports whose
+ * details are kept for a report.  Totals are still counted beyond this limit.
+ */
+#ifndef DEFENDER_TCP_CONN_MAX
+    #define DEFENDER_TCP_CONN_MAX    ( 8 )
+#endif
+
+/** An established TCP connection */
+typedef struct DefenderTcpConn_s
+{
+    uint32_t ulRemoteIP;   /**< IPv4 address of the peer, host byte order */
+    uint16_t usRemotePort; /**< Port of the peer */
+    uint16_t usLocalPort;  /**< Local port */
+} DefenderTcpConn_t;
+
+/** TCP sockets as seen by the last call to TcpConnRefresh */
+typedef struct DefenderTcpConnSnapshot_s
+{
+    int32_t lEstablishedTotal;  /**< Established connections, -1 if unknown */
+    int32_t lListeningTotal;    /**< Listening ports, -1 if unknown */
+    int32_t lConnCount;         /**< Valid entries in xConns */
+    int32_t lPortCount;         /**< Valid entries in usListeningPorts */
+    DefenderTcpConn_t xConns[ DEFENDER_TCP_CONN_MAX ];
+    uint16_t usListeningPorts[ DEFENDER_TCP_CONN_MAX ];
+} DefenderTcpConnSnapshot_t;
+
+/**
+ * @return Count of established TCP connections, -1 if unknown
+ */
 int32_t TcpConnGet( void );
+
+/**
+ * @return The snapshot taken by the last call to TcpConnRefresh
+ */
+DefenderTcpConnSnapshot_t const * TcpConnSnapshotGet( void );
+
 void TcpConnRefresh( void );
 
 #endif /* end of include guard: AWS_DEFENDER_TCP_CONN_H */
@@ -77,6 +77,93 @@
     #define ggdconfigJSON_MAX_TOKENS    ( 128 )        /* Size of the array used by jsmn to store the tokens. */
 #endif
 
+/**
+ * @brief Number of connections that GGD_SecureConnect_ConnectFirst() attempts
+ * at the same time.
+ *
+ * Each attempt runs in a task of its own.  Set to 1 if the Secure Sockets
+ * implementation can not connect from several tasks at once, which makes the
+ * attempts sequential.
+ */
+#ifndef ggdconfigCONNECT_MAX_PARALLEL
+    #define ggdconfigCONNECT_MAX_PARALLEL    ( 3 )
+#endif
+
+/**
+ * @brief Time in milliseconds that GGD_SecureConnect_ConnectFirst() gives an
+ * attempt before starting the next one, unless it fails sooner.
+ */
+#ifndef ggdconfigCONNECT_ATTEMPT_DELAY_MS
+    #define ggdconfigCONNECT_ATTEMPT_DELAY_MS    ( 250 )
+#endif
+
+/**
+ * @brief Stack size and priority of the tasks that attempt the connections.
+ *
+ * The stack must be large enough for a TLS handshake.
+ */
+/** @{ */
+#ifndef ggdconfigCONNECT_TASK_STACK_SIZE
+    #define ggdconfigCONNECT_TASK_STACK_SIZE    ( configMINIMAL_STACK_SIZE * 16 )
+#endif
+#ifndef ggdconfigCONNECT_TASK_PRIORITY
+    #define ggdconfigCONNECT_TASK_PRIORITY      ( tskIDLE_PRIORITY + 1 )
+#endif
+/** @} */
+
+/**
+ * @brief Sizes of the discovery cache.
+ *
+ * Connectivity entries beyond ggdconfigCACHE_MAX_HOSTS, or with a host
+ * address longer than ggdconfigCACHE_MAX_HOST_LENGTH, are left out of the
+ * cache.  A group certificate larger than ggdconfigCACHE_MAX_CERTIFICATE_SIZE,
+ * including its terminating null, can not be cached.
+ */
+/** @{ */
+#ifndef ggdconfigCACHE_MAX_HOSTS
+    #define ggdconfigCACHE_MAX_HOSTS               ( 8 )
+#endif
+#ifndef ggdconfigCACHE_MAX_HOST_LENGTH
+    #define ggdconfigCACHE_MAX_HOST_LENGTH         ( 64 )
+#endif
+#ifndef ggdconfigCACHE_MAX_CERTIFICATE_SIZE
+    #define ggdconfigCACHE_MAX_CERTIFICATE_SIZE    ( 2048 )
+#endif
+/** @} */
+
+/**
+ * @brief Number of connections in a row that may fail to every cached host
+ * before the discovery cache is no longer valid.
+ */
+#ifndef ggdconfigCACHE_MAX_FAILED_CONNECTS
+    #define ggdconfigCACHE_MAX_FAILED_CONNECTS    ( 3 )
+#endif
+
+/**
+ * @brief Age in seconds after which the discovery cache is no longer valid,
+ * or 0 for no limit.
+ *
+ * A limit needs ggdconfigCACHE_TIME_SECONDS() to return the time in seconds
+ * from a clock that keeps counting across resets, such as a RTC or SNTP.
+ */
+#ifndef ggdconfigCACHE_MAX_AGE_SECONDS
+    #define ggdconfigCACHE_MAX_AGE_SECONDS    ( 0 )
+#endif
+
+#if ( ggdconfigCACHE_MAX_AGE_SECONDS > 0 ) && !defined( ggdconfigCACHE_TIME_SECONDS )
+    #error "ggdconfigCACHE_TIME_SECONDS() must be defined to limit the age of the discovery cache."
+#endif
+
+/**
+ * @brief Called with a pointer to the discovery cache whenever it changes, to
+ * write it to non-volatile memory.
+ *
+ * The cache holds no pointers, so it can be written and read back as it is.
+ */
+#ifndef ggdconfigCACHE_SAVE
+    #define ggdconfigCACHE_SAVE( pxCache )
+#endif
+
 #ifndef ggdconfigPRINT
     #define ggdconfigPRINT    vLoggingPrintf
 #endif
@@ -54,6 +54,42 @@ BaseType_t GGD_SecureConnect_Connect( const GGD_HostAddressData_t * pxHostAddres
                                       uint32_t ulReceiveTimeOut,
                                       uint32_t ulSendTimeOut );
 
+/*
+ * @brief Start secure connections to several hosts, the first to connect wins.
+ *
+ * The connections are attempted by tasks of their own, up to
+ * ggdconfigCONNECT_MAX_PARALLEL at a time, in the order of the hosts.  The
+ * next attempt starts when one fails, or ggdconfigCONNECT_ATTEMPT_DELAY_MS
+ * after the previous one started, so a host that answers is not held up by
+ * the timeouts of the hosts before it that do not.  The function returns as
+ * soon as a connection succeeds; the attempts still running then close their
+ * connection when they finish.
+ *
+ * @param [in] pxHostAddressData : The hosts, which must all use the same
+ * certificate.  They are copied, so they need not outlive the call.
+ *
+ * @param [in] ulHostCount : Number of hosts.
+ *
+ * @param [out] pxSocket : The socket of the winning connection, or
+ * SOCKETS_INVALID_SOCKET.
+ *
+ * @param [out] pxConnectFailed : For each host, pdTRUE if the connection to it
+ * was attempted and failed before the function returned.
+ *
+ * @param [in] ulReceiveTimeOut : Receive Timeout in millisecond.
+ *
+ * @param [in] ulSendTimeOut : Send Timeout in millisecond
+ *
+ * @return The index of the host connected to, or -1 if no connection
+ * succeeded.
+ */
+BaseType_t GGD_SecureConnect_ConnectFirst( const GGD_HostAddressData_t * pxHostAddressData,
+                                           const uint32_t ulHostCount,
+                                           Socket_t * pxSocket,
+                                           BaseType_t * pxConnectFailed,
+                                           uint32_t ulReceiveTimeOut,
+                                           uint32_t ulSendTimeOut );
+
 /*
  * @briefstop a secure connection with host.
  *
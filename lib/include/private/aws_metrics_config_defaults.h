@@ -0,0 +1,118 @@
+/*
+ * Amazon FreeRTOS
+ * Copyright (C) 2018 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+/**
+ * @file aws_metrics_config_defaults.h
+ * @brief Metrics publisher default config options.
+ *
+ * Ensures that the config options for the metrics publisher are set to
+ * sensible default values if the user does not provide one.
+ */
+
+#ifndef _AWS_METRICS_CONFIG_DEFAULTS_H_
+#define _AWS_METRICS_CONFIG_DEFAULTS_H_
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+
+/**
+ * @brief The time between two reports, in milliseconds.
+ */
+#ifndef metricsconfigREPORT_PERIOD_MS
+    #define metricsconfigREPORT_PERIOD_MS    ( 60000 )
+#endif
+
+/**
+ * @brief The size of the buffer a report is encoded into.
+ *
+ * Each task takes up to about ( configMAX_TASK_NAME_LEN + 12 ) bytes, the rest
+ * of the report less than 64 bytes.  The buffer is allocated statically.
+ */
+#ifndef metricsconfigREPORT_BUFFER_SIZE
+    #define metricsconfigREPORT_BUFFER_SIZE    ( 512 )
+#endif
+
+/**
+ * @brief The largest number of tasks listed in a report.
+ *
+ * The task figures are sampled into a static array of this many entries.  If
+ * there are more tasks, the report only gives their number.
+ */
+#ifndef metricsconfigMAX_TASKS
+    #define metricsconfigMAX_TASKS    ( 16 )
+#endif
+
+/**
+ * @brief The topic the reports are published on.
+ */
+#ifndef metricsconfigTOPIC
+    #define metricsconfigTOPIC    "freertos/metrics/" clientcredentialIOT_THING_NAME
+#endif
+
+/**
+ * @brief How long a report may wait for the MQTT agent, in milliseconds.
+ */
+#ifndef metricsconfigPUBLISH_TIMEOUT_MS
+    #define metricsconfigPUBLISH_TIMEOUT_MS    ( 2000 )
+#endif
+
+/**
+ * @defgroup MetricsTask Metrics task configuration parameters.
+ */
+/** @{ */
+#ifndef metricsconfigTASK_STACK_DEPTH
+    #define metricsconfigTASK_STACK_DEPTH    ( configMINIMAL_STACK_SIZE * 4 )
+#endif
+
+#ifndef metricsconfigTASK_PRIORITY
+    #define metricsconfigTASK_PRIORITY    ( tskIDLE_PRIORITY )
+#endif
+/** @} */
+
+/**
+ * @defgroup MetricsSources The figures included in a report.
+ *
+ * Set a source to 0 if the library it comes from is not part of the build.
+ */
+/** @{ */
+#ifndef metricsconfigINCLUDE_HEAP
+    #define metricsconfigINCLUDE_HEAP    ( 1 ) /* Needs heap_4 or heap_5 for the minimum ever free heap. */
+#endif
+
+#ifndef metricsconfigINCLUDE_NETWORK_BUFFERS
+    #define metricsconfigINCLUDE_NETWORK_BUFFERS    ( 1 )
+#endif
+
+#ifndef metricsconfigINCLUDE_MQTT
+    #define metricsconfigINCLUDE_MQTT    ( 1 )
+#endif
+
+#ifndef metricsconfigINCLUDE_OTA
+    #define metricsconfigINCLUDE_OTA    ( 1 )
+#endif
+/** @} */
+
+#endif /* _AWS_METRICS_CONFIG_DEFAULTS_H_ */
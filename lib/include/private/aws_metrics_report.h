@@ -0,0 +1,97 @@
+/*
+ * Amazon FreeRTOS
+ * Copyright (C) 2018 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+/**
+ * @file aws_metrics_report.h
+ * @brief Encoding of the reports sent by the metrics publisher.
+ *
+ * A report is a CBOR map with short text keys, each present only when the
+ * figure it holds is enabled in aws_metrics_config.h:
+ *
+ * - "v": the report format version, metricsREPORT_VERSION.
+ * - "up": the time since the scheduler started, in milliseconds.
+ * - "rt": the run time counter ticks since the previous report.
+ * - "t": an array with one entry per task, each an array of the task's name,
+ *   its run time counter ticks since the previous report (if run time stats
+ *   are enabled), and its stack high water mark in words.
+ * - "tx": the number of tasks, instead of "t", if there are more tasks than
+ *   metricsconfigMAX_TASKS.
+ * - "h": the free heap and the minimum ever free heap, in bytes.
+ * - "nb": the free network buffers and the minimum ever free.
+ * - "mq": the MQTT agent publishes sent, publishes failed, publishes received
+ *   and packets dropped, as totals.
+ * - "ota": the OTA agent packets received, queued, processed and dropped, as
+ *   totals.
+ *
+ * Counters are sent as totals, so that a lost report loses nothing; the CPU
+ * figures are sent as deltas, as the counters behind them wrap quickly.
+ */
+
+#ifndef _AWS_METRICS_REPORT_H_
+#define _AWS_METRICS_REPORT_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+
+/**
+ * @brief The version of the report format.
+ */
+#define metricsREPORT_VERSION    ( 1 )
+
+/**
+ * @defgroup MetricsReportKeys The keys of the report map.
+ */
+/** @{ */
+#define metricsKEY_VERSION            "v"
+#define metricsKEY_UPTIME             "up"
+#define metricsKEY_RUN_TIME           "rt"
+#define metricsKEY_TASKS              "t"
+#define metricsKEY_TASK_COUNT         "tx"
+#define metricsKEY_HEAP               "h"
+#define metricsKEY_NETWORK_BUFFERS    "nb"
+#define metricsKEY_MQTT               "mq"
+#define metricsKEY_OTA                "ota"
+/** @} */
+
+/**
+ * @brief Samples the metrics and encodes them into a report.
+ *
+ * The run time deltas are relative to the previous successful call, so this
+ * function must only be called from one task.  Nothing is allocated.
+ *
+ * @param[in] pucBuffer The buffer to encode the report into.
+ * @param[in] xBufferSize The size of pucBuffer in bytes.
+ * @param[out] pxReportSize The size of the report in bytes.
+ *
+ * @return pdPASS if the report was encoded, pdFAIL if pucBuffer is too small.
+ */
+BaseType_t METRICS_CreateReport( uint8_t * pucBuffer,
+                                 size_t xBufferSize,
+                                 size_t * pxReportSize );
+
+#endif /* _AWS_METRICS_REPORT_H_ */
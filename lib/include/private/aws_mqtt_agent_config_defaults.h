@@ -120,6 +120,22 @@
 #endif
 /** @} */
 
+/**
+ * @brief The task notification index on which the MQTT task acknowledges
+ * commands to the task that sent them.
+ *
+ * When the kernel provides more than one notification index per task, the
+ * agent uses index 1 so that the replies it waits for cannot be mixed up with
+ * notifications the application sends to the same task on the default index.
+ */
+#ifndef mqttconfigNOTIFICATION_INDEX
+    #if ( configTASK_NOTIFICATION_ARRAY_ENTRIES > 1 )
+        #define mqttconfigNOTIFICATION_INDEX    ( 1 )
+    #else
+        #define mqttconfigNOTIFICATION_INDEX    ( tskDEFAULT_INDEX_TO_NOTIFY )
+    #endif
+#endif
+
 /**
  * @brief Maximum number of MQTT clients that can exist simultaneously.
  */
@@ -134,6 +150,30 @@
     #define mqttconfigMAX_PARALLEL_OPS    ( 5 )
 #endif
 
+/**
+ * @brief Set to 1 to run the generic connection callback on the task pool
+ * instead of on the MQTT task.
+ *
+ * A slow callback then delays only the callbacks of its own connection, not
+ * the processing of incoming packets and keep alive messages.  The callbacks
+ * of one connection always run on the same worker, so they still run one at a
+ * time and in the order in which the events were received.  Topic specific
+ * callbacks registered with MQTT_AGENT_Subscribe() still run on the MQTT task.
+ */
+#ifndef mqttconfigUSE_TASK_POOL
+    #define mqttconfigUSE_TASK_POOL    ( 0 )
+#endif
+
+/**
+ * @brief Maximum number of callbacks waiting to run on the task pool.
+ *
+ * Only used if mqttconfigUSE_TASK_POOL is 1.  When all of them are in use the
+ * next callback runs on the MQTT task as if the task pool was not used.
+ */
+#ifndef mqttconfigMAX_DEFERRED_CALLBACKS
+    #define mqttconfigMAX_DEFERRED_CALLBACKS    ( 4 )
+#endif
+
 /**
  * @brief Time in milliseconds after which the TCP send operation should timeout.
  */
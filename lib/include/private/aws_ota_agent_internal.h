@@ -39,6 +39,12 @@
 #define BITS_PER_BYTE           ( 1UL << LOG2_BITS_PER_BYTE )   /* Number of bits in a byte. This is used by the block bitmap implementation. */
 #define OTA_FILE_BLOCK_SIZE     ( 1UL << otaconfigLOG2_FILE_BLOCK_SIZE ) /* Data section size of the file data block message (excludes the header). */
 
+/* Set otaconfigUSE_TASK_POOL to 1 in aws_ota_agent_config.h to call the job complete callback
+ * from the task pool, so that a slow callback does not hold up the OTA task. */
+#ifndef otaconfigUSE_TASK_POOL
+    #define otaconfigUSE_TASK_POOL  0
+#endif
+
 typedef enum
 {
     eIngest_Result_FileComplete = -1,      /* The file transfer is complete and the signature check passed. */
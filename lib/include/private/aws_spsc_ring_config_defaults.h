@@ -0,0 +1,71 @@
+/*
+ * Amazon FreeRTOS
+ * Copyright (C) 2018 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+/**
+ * @file aws_spsc_ring_config_defaults.h
+ * @brief SPSC ring default config options.
+ *
+ * Ensures that the config options for the SPSC ring are set to sensible
+ * default values if the user does not provide one.
+ */
+
+#ifndef _AWS_SPSC_RING_CONFIG_DEFAULTS_H_
+#define _AWS_SPSC_RING_CONFIG_DEFAULTS_H_
+
+/**
+ * @defgroup SPSCRingBarriers Memory barriers, for the compiler and the CPU.
+ *
+ * The acquire barrier keeps the memory accesses after it from being done
+ * before the loads before it; the release barrier keeps the memory accesses
+ * before it from being done after the stores after it; the full barrier also
+ * keeps a store before it from being done after a load after it.
+ *
+ * On a single core where the producer is an interrupt, compiler barriers
+ * would do for all three, but a producer on another core or in a host thread
+ * needs the CPU to order its accesses as well.  The GCC defaults cost nothing
+ * on a CPU that keeps loads and stores in order, such as x86, for the acquire
+ * and release barriers.
+ */
+/** @{ */
+#if defined( __GNUC__ )
+    #ifndef spscringconfigACQUIRE_BARRIER
+        #define spscringconfigACQUIRE_BARRIER()    __atomic_thread_fence( __ATOMIC_ACQUIRE )
+    #endif
+
+    #ifndef spscringconfigRELEASE_BARRIER
+        #define spscringconfigRELEASE_BARRIER()    __atomic_thread_fence( __ATOMIC_RELEASE )
+    #endif
+
+    #ifndef spscringconfigMEMORY_BARRIER
+        #define spscringconfigMEMORY_BARRIER()    __atomic_thread_fence( __ATOMIC_SEQ_CST )
+    #endif
+#endif
+
+#if !defined( spscringconfigACQUIRE_BARRIER ) || !defined( spscringconfigRELEASE_BARRIER ) || !defined( spscringconfigMEMORY_BARRIER )
+    #error "Define the SPSC ring barriers in aws_spsc_ring_config.h for this compiler."
+#endif
+/** @} */
+
+#endif /* _AWS_SPSC_RING_CONFIG_DEFAULTS_H_ */
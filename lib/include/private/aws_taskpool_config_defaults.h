@@ -0,0 +1,85 @@
+/*
+ * Amazon FreeRTOS
+ * Copyright (C) 2018 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+/**
+ * @file aws_taskpool_config_defaults.h
+ * @brief Task pool default config options.
+ *
+ * Ensures that the config options for the task pool are set to sensible
+ * default values if the user does not provide one.
+ */
+
+#ifndef _AWS_TASKPOOL_CONFIG_DEFAULTS_H_
+#define _AWS_TASKPOOL_CONFIG_DEFAULTS_H_
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+
+/**
+ * @brief The number of worker tasks.
+ */
+#ifndef taskpoolconfigNUM_WORKERS
+    #define taskpoolconfigNUM_WORKERS    ( 2 )
+#endif
+
+/**
+ * @brief The number of jobs each worker can hold in each lane.
+ *
+ * Submissions fail rather than block once a lane is full, so this bounds the
+ * memory used and the time a job can wait.
+ */
+#ifndef taskpoolconfigQUEUE_LENGTH
+    #define taskpoolconfigQUEUE_LENGTH    ( 8 )
+#endif
+
+/**
+ * @defgroup TaskPoolWorker Worker task configuration parameters.
+ *
+ * The workers should not have a higher priority than the tasks that submit
+ * jobs to them, otherwise a submitting task is preempted by every job it
+ * submits.
+ */
+/** @{ */
+#ifndef taskpoolconfigWORKER_STACK_DEPTH
+    #define taskpoolconfigWORKER_STACK_DEPTH    ( configMINIMAL_STACK_SIZE * 4 )
+#endif
+
+#ifndef taskpoolconfigWORKER_PRIORITY
+    #define taskpoolconfigWORKER_PRIORITY    ( tskIDLE_PRIORITY )
+#endif
+/** @} */
+
+/**
+ * @brief The task notification index on which an idle worker waits for jobs.
+ *
+ * Jobs run on the workers, so a job that waits for a notification on the same
+ * index could consume the wake up meant for the worker.
+ */
+#ifndef taskpoolconfigNOTIFICATION_INDEX
+    #define taskpoolconfigNOTIFICATION_INDEX    ( configTASK_NOTIFICATION_ARRAY_ENTRIES - 1 )
+#endif
+
+#endif /* _AWS_TASKPOOL_CONFIG_DEFAULTS_H_ */
@@ -0,0 +1,67 @@
+/*
+ * Amazon FreeRTOS
+ * Copyright (C) 2018 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+/**
+ * @file aws_trace_ring_config_defaults.h
+ * @brief Trace ring default config options.
+ *
+ * Ensures that the config options for the trace ring are set to sensible
+ * default values if the user does not provide one.
+ */
+
+#ifndef _AWS_TRACE_RING_CONFIG_DEFAULTS_H_
+#define _AWS_TRACE_RING_CONFIG_DEFAULTS_H_
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+
+/**
+ * @brief The number of records kept, which must be a power of two.
+ *
+ * Each record takes 16 bytes of RAM.
+ */
+#ifndef traceringconfigNUM_RECORDS
+    #define traceringconfigNUM_RECORDS    ( 512 )
+#endif
+
+/**
+ * @defgroup TraceRingTimestamp Timestamp configuration parameters.
+ *
+ * The tick count is always available but far too coarse to measure scheduler
+ * latency.  Where the port has a free running counter, for example the one
+ * behind the run time stats, use it instead and give its frequency.
+ */
+/** @{ */
+#ifndef traceringconfigGET_TIMESTAMP
+    #define traceringconfigGET_TIMESTAMP()    ( ( uint32_t ) xTaskGetTickCountFromISR() )
+#endif
+
+#ifndef traceringconfigTIMESTAMP_HZ
+    #define traceringconfigTIMESTAMP_HZ    ( configTICK_RATE_HZ )
+#endif
+/** @} */
+
+#endif /* _AWS_TRACE_RING_CONFIG_DEFAULTS_H_ */
@@ -1382,6 +1382,177 @@ BaseType_t xQueueGiveFromISR( QueueHandle_t xQueue, BaseType_t * const pxHigherP
  */
 BaseType_t xQueueReceiveFromISR( QueueHandle_t xQueue, void * const pvBuffer, BaseType_t * const pxHigherPriorityTaskWoken ) PRIVILEGED_FUNCTION;
 
+/**
+ * queue. h
+ * <pre>
+ size_t xQueueSendMultiple(
+							   QueueHandle_t xQueue,
+							   const void * pvItems,
+							   size_t xItemCount,
+							   TickType_t xTicksToWait
+						   );
+ * </pre>
+ *
+ * Post up to xItemCount items to the back of a queue.  The items are copied
+ * into the queue under a single critical section, and the tasks waiting to
+ * receive from the queue are only scanned once, so sending a batch of items is
+ * considerably cheaper than calling xQueueSend() once for each item.
+ *
+ * As many items as there is space for are posted.  The calling task only
+ * blocks while the queue is completely full, so fewer than xItemCount items
+ * may be posted - the return value must be checked, and the remaining items
+ * posted by another call if required.
+ *
+ * This function must not be used with semaphores or mutexes, and must not be
+ * called from an interrupt service routine.  See xQueueSendMultipleFromISR()
+ * for an alternative which may be used in an ISR.
+ *
+ * @param xQueue The handle to the queue on which the items are to be posted.
+ *
+ * @param pvItems A pointer to an array of xItemCount items.  The size of each
+ * item was defined when the queue was created.
+ *
+ * @param xItemCount The number of items in the pvItems array.
+ *
+ * @param xTicksToWait The maximum amount of time the task should block waiting
+ * for space to become available on the queue, should it be full.
+ *
+ * @return The number of items posted to the queue.  Zero is returned if the
+ * queue remained full for xTicksToWait ticks.
+ *
+ * Example usage:
+   <pre>
+ void vADCTask( void *pvParameters )
+ {
+ uint16_t usSamples[ 16 ];
+ size_t xPosted, xTotal;
+
+	for( ;; )
+	{
+		vReadADCSamples( usSamples, 16 );
+
+		// Post all sixteen samples, blocking while the queue is full.
+		for( xTotal = 0; xTotal < 16; xTotal += xPosted )
+		{
+			xPosted = xQueueSendMultiple( xQueue, &( usSamples[ xTotal ] ), 16 - xTotal, portMAX_DELAY );
+		}
+	}
+ }
+ </pre>
+ * \defgroup xQueueSendMultiple xQueueSendMultiple
+ * \ingroup QueueManagement
+ */
+size_t xQueueSendMultiple( QueueHandle_t xQueue, const void * const pvItems, size_t xItemCount, TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
+
+/**
+ * queue. h
+ * <pre>
+ size_t xQueueSendMultipleFromISR(
+									  QueueHandle_t xQueue,
+									  const void * pvItems,
+									  size_t xItemCount,
+									  BaseType_t *pxHigherPriorityTaskWoken
+								  );
+ * </pre>
+ *
+ * A version of xQueueSendMultiple() that can be called from an interrupt
+ * service routine.  As many of the items as there is space for are posted to
+ * the back of the queue.
+ *
+ * @param xQueue The handle to the queue on which the items are to be posted.
+ *
+ * @param pvItems A pointer to an array of xItemCount items.
+ *
+ * @param xItemCount The number of items in the pvItems array.
+ *
+ * @param pxHigherPriorityTaskWoken xQueueSendMultipleFromISR() will set
+ * *pxHigherPriorityTaskWoken to pdTRUE if posting the items unblocked a task
+ * that has a priority higher than the currently running task.  If
+ * xQueueSendMultipleFromISR() sets this value to pdTRUE then a context switch
+ * should be requested before the interrupt is exited.
+ *
+ * @return The number of items posted to the queue, which is zero if the queue
+ * was full.
+ *
+ * \defgroup xQueueSendMultipleFromISR xQueueSendMultipleFromISR
+ * \ingroup QueueManagement
+ */
+size_t xQueueSendMultipleFromISR( QueueHandle_t xQueue, const void * const pvItems, size_t xItemCount, BaseType_t * const pxHigherPriorityTaskWoken ) PRIVILEGED_FUNCTION;
+
+/**
+ * queue. h
+ * <pre>
+ size_t xQueueReceiveMultiple(
+								  QueueHandle_t xQueue,
+								  void *pvBuffer,
+								  size_t xBufferItems,
+								  TickType_t xTicksToWait
+							  );
+ * </pre>
+ *
+ * Receive up to xBufferItems items from a queue.  The items are copied out of
+ * the queue under a single critical section, and the tasks waiting to post to
+ * the queue are only scanned once.
+ *
+ * All the items available in the queue, up to xBufferItems, are received.  The
+ * calling task only blocks while the queue is empty, so the function returns as
+ * soon as at least one item can be received.
+ *
+ * This function must not be used with semaphores or mutexes, and must not be
+ * called from an interrupt service routine.  See
+ * xQueueReceiveMultipleFromISR() for an alternative which may be used in an
+ * ISR.
+ *
+ * @param xQueue The handle to the queue from which the items are to be
+ * received.
+ *
+ * @param pvBuffer Pointer to a buffer large enough to hold xBufferItems items.
+ *
+ * @param xBufferItems The number of items pvBuffer can hold.
+ *
+ * @param xTicksToWait The maximum amount of time the task should block waiting
+ * for an item to receive should the queue be empty.
+ *
+ * @return The number of items received.  Zero is returned if the queue
+ * remained empty for xTicksToWait ticks.
+ *
+ * \defgroup xQueueReceiveMultiple xQueueReceiveMultiple
+ * \ingroup QueueManagement
+ */
+size_t xQueueReceiveMultiple( QueueHandle_t xQueue, void * const pvBuffer, size_t xBufferItems, TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
+
+/**
+ * queue. h
+ * <pre>
+ size_t xQueueReceiveMultipleFromISR(
+										 QueueHandle_t xQueue,
+										 void *pvBuffer,
+										 size_t xBufferItems,
+										 BaseType_t *pxHigherPriorityTaskWoken
+									 );
+ * </pre>
+ *
+ * A version of xQueueReceiveMultiple() that can be called from an interrupt
+ * service routine.
+ *
+ * @param xQueue The handle to the queue from which the items are to be
+ * received.
+ *
+ * @param pvBuffer Pointer to a buffer large enough to hold xBufferItems items.
+ *
+ * @param xBufferItems The number of items pvBuffer can hold.
+ *
+ * @param pxHigherPriorityTaskWoken xQueueReceiveMultipleFromISR() will set
+ * *pxHigherPriorityTaskWoken to pdTRUE if receiving the items unblocked a task
+ * that has a priority higher than the currently running task.
+ *
+ * @return The number of items received, which is zero if the queue was empty.
+ *
+ * \defgroup xQueueReceiveMultipleFromISR xQueueReceiveMultipleFromISR
+ * \ingroup QueueManagement
+ */
+size_t xQueueReceiveMultipleFromISR( QueueHandle_t xQueue, void * const pvBuffer, size_t xBufferItems, BaseType_t * const pxHigherPriorityTaskWoken ) PRIVILEGED_FUNCTION;
+
 /*
  * Utilities to query queues that are safe to use from an ISR.  These utilities
  * should be used only from witin an ISR, or within a critical section.
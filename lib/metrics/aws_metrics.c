@@ -0,0 +1,228 @@
+/*
+ * Amazon FreeRTOS
+ * Copyright (C) 2018 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+/**
+ * @file aws_metrics.c
+ * @brief The metrics publisher task.
+ */
+
+/* Standard includes. */
+#include <string.h>
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+
+/* Credentials include, for the thing name in the default topic. */
+#include "aws_clientcredential.h"
+
+/* Metrics includes. */
+#include "aws_metrics.h"
+#include "aws_metrics_config.h"
+#include "aws_metrics_config_defaults.h"
+#include "aws_metrics_report.h"
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief The buffer the reports are encoded into.
+ */
+static uint8_t ucReportBuffer[ metricsconfigREPORT_BUFFER_SIZE ];
+
+/**
+ * @brief The connection the reports are published on, or NULL.
+ */
+static MQTTAgentHandle_t xConnection = NULL;
+
+/**
+ * @brief Counters returned by METRICS_GetStats().
+ */
+static MetricsStats_t xStats;
+
+/**
+ * @brief Set once METRICS_Init() has created the task.
+ */
+static BaseType_t xMetricsInitialized = pdFALSE;
+
+#if ( configSUPPORT_STATIC_ALLOCATION == 1 )
+
+/**
+ * @brief Holds the metrics task's TCB.
+ */
+    static StaticTask_t xTaskBuffer;
+
+/**
+ * @brief The metrics task's stack.
+ */
+    static StackType_t xTaskStack[ metricsconfigTASK_STACK_DEPTH ];
+#endif
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief The function run by the metrics task.
+ *
+ * @param[in] pvParameters Not used.
+ */
+static void prvMetricsTask( void * pvParameters );
+
+/**
+ * @brief Encodes a report and publishes it on the current connection.
+ *
+ * @param[in] xMQTTHandle The connection to publish on.
+ */
+static void prvPublishReport( MQTTAgentHandle_t xMQTTHandle );
+/*-----------------------------------------------------------*/
+
+static void prvPublishReport( MQTTAgentHandle_t xMQTTHandle )
+{
+    MQTTAgentPublishParams_t xPublishParams;
+    BaseType_t xResult;
+    size_t xReportSize = 0;
+
+    xResult = METRICS_CreateReport( ucReportBuffer, sizeof( ucReportBuffer ), &xReportSize );
+
+    if( xResult == pdPASS )
+    {
+        memset( &xPublishParams, 0, sizeof( xPublishParams ) );
+        xPublishParams.pucTopic = ( const uint8_t * ) metricsconfigTOPIC;
+        xPublishParams.usTopicLength = ( uint16_t ) ( sizeof( metricsconfigTOPIC ) - 1 );
+        xPublishParams.xQoS = eMQTTQoS0;
+        xPublishParams.pvData = ucReportBuffer;
+        xPublishParams.ulDataLength = ( uint32_t ) xReportSize;
+
+        if( MQTT_AGENT_Publish( xMQTTHandle,
+                                &xPublishParams,
+                                pdMS_TO_TICKS( metricsconfigPUBLISH_TIMEOUT_MS ) ) != eMQTTAgentSuccess )
+        {
+            xResult = pdFAIL;
+        }
+    }
+    else
+    {
+        configPRINTF( ( "Metrics report does not fit in %d bytes.\r\n", metricsconfigREPORT_BUFFER_SIZE ) );
+    }
+
+    taskENTER_CRITICAL();
+    {
+        if( xResult == pdPASS )
+        {
+            xStats.ulReportsPublished++;
+            xStats.ulLastReportSize = ( uint32_t ) xReportSize;
+        }
+        else
+        {
+            xStats.ulReportsFailed++;
+        }
+    }
+    taskEXIT_CRITICAL();
+}
+/*-----------------------------------------------------------*/
+
+static void prvMetricsTask( void * pvParameters )
+{
+    TickType_t xLastWakeTime = xTaskGetTickCount();
+    MQTTAgentHandle_t xMQTTHandle;
+
+    ( void ) pvParameters;
+
+    for( ; ; )
+    {
+        vTaskDelayUntil( &xLastWakeTime, pdMS_TO_TICKS( metricsconfigREPORT_PERIOD_MS ) );
+
+        taskENTER_CRITICAL();
+        {
+            xMQTTHandle = xConnection;
+        }
+        taskEXIT_CRITICAL();
+
+        /* Without a connection no report is made, so the CPU figures of the
+         * first report after a connection is set cover the time since the
+         * last report made, which may be long. */
+        if( xMQTTHandle != NULL )
+        {
+            prvPublishReport( xMQTTHandle );
+        }
+    }
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t METRICS_Init( void )
+{
+    BaseType_t xReturn = pdPASS;
+    TaskHandle_t xTask = NULL;
+
+    if( xMetricsInitialized == pdFALSE )
+    {
+        memset( &xStats, 0, sizeof( xStats ) );
+
+        #if ( configSUPPORT_STATIC_ALLOCATION == 1 )
+            xTask = xTaskCreateStatic( prvMetricsTask,
+                                       "Metrics",
+                                       metricsconfigTASK_STACK_DEPTH,
+                                       NULL,
+                                       metricsconfigTASK_PRIORITY,
+                                       xTaskStack,
+                                       &xTaskBuffer );
+        #else
+            ( void ) xTaskCreate( prvMetricsTask,
+                                  "Metrics",
+                                  metricsconfigTASK_STACK_DEPTH,
+                                  NULL,
+                                  metricsconfigTASK_PRIORITY,
+                                  &xTask );
+        #endif
+
+        if( xTask == NULL )
+        {
+            xReturn = pdFAIL;
+        }
+        else
+        {
+            xMetricsInitialized = pdTRUE;
+        }
+    }
+
+    return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+void METRICS_SetConnection( MQTTAgentHandle_t xMQTTHandle )
+{
+    taskENTER_CRITICAL();
+    {
+        xConnection = xMQTTHandle;
+    }
+    taskEXIT_CRITICAL();
+}
+/*-----------------------------------------------------------*/
+
+void METRICS_GetStats( MetricsStats_t * pxStats )
+{
+    taskENTER_CRITICAL();
+    {
+        *pxStats = xStats;
+    }
+    taskEXIT_CRITICAL();
+}
+/*-----------------------------------------------------------*/
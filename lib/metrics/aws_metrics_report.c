@@ -0,0 +1,410 @@
+/*
+ * Amazon FreeRTOS
+ * Copyright (C) 2018 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+/**
+ * @file aws_metrics_report.c
+ * @brief Sampling and CBOR encoding of the metrics reports.
+ *
+ * The task figures are sampled into static arrays and encoded straight into
+ * the caller's buffer, so that the cost of a report does not depend on the
+ * heap and is bounded by metricsconfigMAX_TASKS.
+ */
+
+/* Standard includes. */
+#include <string.h>
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+
+/* Metrics includes. */
+#include "aws_metrics_config.h"
+#include "aws_metrics_config_defaults.h"
+#include "aws_metrics_report.h"
+
+/* Sources of the figures. */
+#if ( metricsconfigINCLUDE_NETWORK_BUFFERS == 1 )
+    #include "FreeRTOS_IP.h"
+    #include "NetworkBufferManagement.h"
+#endif
+
+#if ( metricsconfigINCLUDE_MQTT == 1 )
+    #include "aws_mqtt_agent.h"
+#endif
+
+#if ( metricsconfigINCLUDE_OTA == 1 )
+    #include "aws_ota_agent.h"
+#endif
+
+/* CBOR encoder. */
+#include "cbor.h"
+
+#if ( configUSE_TRACE_FACILITY != 1 )
+    #error "The metrics report needs configUSE_TRACE_FACILITY set to 1, to list the tasks."
+#endif
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief The figures of the tasks, as sampled for the current report.
+ */
+static TaskStatus_t xTaskStatus[ metricsconfigMAX_TASKS ];
+
+#if ( configGENERATE_RUN_TIME_STATS == 1 )
+
+/**
+ * @brief The run time counters of the tasks at the previous report, so that
+ * each report gives the CPU time used since the previous one.
+ */
+    static struct
+    {
+        UBaseType_t uxTaskNumber;
+        uint32_t ulRunTime;
+    } xPreviousRunTime[ metricsconfigMAX_TASKS ];
+
+/**
+ * @brief The number of valid entries in xPreviousRunTime.
+ */
+    static UBaseType_t uxPreviousTasks = 0;
+
+/**
+ * @brief The total run time counter at the previous report.
+ */
+    static uint32_t ulPreviousTotalRunTime = 0;
+
+/**
+ * @brief The total run time counter and the number of tasks sampled for the
+ * current report.  They only become the baselines of the next report if the
+ * current one is created, so a failed report does not lose CPU time.
+ */
+    static uint32_t ulSampledTotalRunTime = 0;
+    static UBaseType_t uxSampledTasks = 0;
+#endif /* configGENERATE_RUN_TIME_STATS */
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Encodes an array of 32-bit counters.
+ *
+ * @param[in] pxMap The report map.
+ * @param[in] pcKey The key of the array.
+ * @param[in] pulValues The counters.
+ * @param[in] xCount The number of counters.
+ *
+ * @return The first error met, or CborNoError.
+ */
+static CborError prvEncodeCounters( CborEncoder * pxMap,
+                                    const char * pcKey,
+                                    const uint32_t * pulValues,
+                                    size_t xCount );
+
+/**
+ * @brief Samples the tasks and encodes their figures.
+ *
+ * @param[in] pxMap The report map.
+ *
+ * @return The first error met, or CborNoError.
+ */
+static CborError prvEncodeTasks( CborEncoder * pxMap );
+
+#if ( configGENERATE_RUN_TIME_STATS == 1 )
+
+/**
+ * @brief Finds the run time of a task at the previous report.
+ *
+ * @param[in] uxTaskNumber The task.
+ *
+ * @return The run time counter of the task, or 0 for a new task.
+ */
+    static uint32_t prvPreviousRunTime( UBaseType_t uxTaskNumber );
+
+/**
+ * @brief Makes the figures sampled for the current report the baselines of
+ * the next one.
+ */
+    static void prvUpdatePreviousRunTimes( void );
+#endif
+/*-----------------------------------------------------------*/
+
+static CborError prvEncodeCounters( CborEncoder * pxMap,
+                                    const char * pcKey,
+                                    const uint32_t * pulValues,
+                                    size_t xCount )
+{
+    CborEncoder xArray;
+    CborError xResult;
+    size_t x;
+
+    xResult = cbor_encode_text_stringz( pxMap, pcKey );
+
+    if( xResult == CborNoError )
+    {
+        xResult = cbor_encoder_create_array( pxMap, &xArray, xCount );
+    }
+
+    for( x = 0; ( x < xCount ) && ( xResult == CborNoError ); x++ )
+    {
+        xResult = cbor_encode_uint( &xArray, pulValues[ x ] );
+    }
+
+    if( xResult == CborNoError )
+    {
+        xResult = cbor_encoder_close_container( pxMap, &xArray );
+    }
+
+    return xResult;
+}
+/*-----------------------------------------------------------*/
+
+#if ( configGENERATE_RUN_TIME_STATS == 1 )
+
+    static uint32_t prvPreviousRunTime( UBaseType_t uxTaskNumber )
+    {
+        uint32_t ulRunTime = 0;
+        UBaseType_t x;
+
+        for( x = 0; x < uxPreviousTasks; x++ )
+        {
+            if( xPreviousRunTime[ x ].uxTaskNumber == uxTaskNumber )
+            {
+                ulRunTime = xPreviousRunTime[ x ].ulRunTime;
+                break;
+            }
+        }
+
+        return ulRunTime;
+    }
+
+#endif /* configGENERATE_RUN_TIME_STATS */
+/*-----------------------------------------------------------*/
+
+#if ( configGENERATE_RUN_TIME_STATS == 1 )
+
+    static void prvUpdatePreviousRunTimes( void )
+    {
+        UBaseType_t x;
+
+        /* Tasks missing from this report start again from zero. */
+        for( x = 0; x < uxSampledTasks; x++ )
+        {
+            xPreviousRunTime[ x ].uxTaskNumber = xTaskStatus[ x ].xTaskNumber;
+            xPreviousRunTime[ x ].ulRunTime = xTaskStatus[ x ].ulRunTimeCounter;
+        }
+
+        uxPreviousTasks = uxSampledTasks;
+        ulPreviousTotalRunTime = ulSampledTotalRunTime;
+    }
+
+#endif /* configGENERATE_RUN_TIME_STATS */
+/*-----------------------------------------------------------*/
+
+static CborError prvEncodeTasks( CborEncoder * pxMap )
+{
+    CborEncoder xTasks, xTask;
+    CborError xResult = CborNoError;
+    UBaseType_t uxTasks, x;
+    uint32_t ulTotalRunTime = 0;
+
+    /* Returns 0 if there are more tasks than entries in the array, in which
+     * case only the number of tasks is reported. */
+    uxTasks = uxTaskGetSystemState( xTaskStatus, metricsconfigMAX_TASKS, &ulTotalRunTime );
+
+    #if ( configGENERATE_RUN_TIME_STATS == 1 )
+    {
+        xResult = cbor_encode_text_stringz( pxMap, metricsKEY_RUN_TIME );
+
+        if( xResult == CborNoError )
+        {
+            xResult = cbor_encode_uint( pxMap, ulTotalRunTime - ulPreviousTotalRunTime );
+        }
+
+        ulSampledTotalRunTime = ulTotalRunTime;
+        uxSampledTasks = uxTasks;
+    }
+    #else
+    {
+        ( void ) ulTotalRunTime;
+    }
+    #endif
+
+    if( ( xResult == CborNoError ) && ( uxTasks == 0 ) )
+    {
+        xResult = cbor_encode_text_stringz( pxMap, metricsKEY_TASK_COUNT );
+
+        if( xResult == CborNoError )
+        {
+            xResult = cbor_encode_uint( pxMap, uxTaskGetNumberOfTasks() );
+        }
+    }
+    else if( xResult == CborNoError )
+    {
+        xResult = cbor_encode_text_stringz( pxMap, metricsKEY_TASKS );
+
+        if( xResult == CborNoError )
+        {
+            xResult = cbor_encoder_create_array( pxMap, &xTasks, uxTasks );
+        }
+
+        for( x = 0; ( x < uxTasks ) && ( xResult == CborNoError ); x++ )
+        {
+            #if ( configGENERATE_RUN_TIME_STATS == 1 )
+                xResult = cbor_encoder_create_array( &xTasks, &xTask, 3 );
+            #else
+                xResult = cbor_encoder_create_array( &xTasks, &xTask, 2 );
+            #endif
+
+            if( xResult == CborNoError )
+            {
+                xResult = cbor_encode_text_stringz( &xTask, xTaskStatus[ x ].pcTaskName );
+            }
+
+            #if ( configGENERATE_RUN_TIME_STATS == 1 )
+                if( xResult == CborNoError )
+                {
+                    xResult = cbor_encode_uint( &xTask,
+                                                xTaskStatus[ x ].ulRunTimeCounter -
+                                                prvPreviousRunTime( xTaskStatus[ x ].xTaskNumber ) );
+                }
+            #endif
+
+            if( xResult == CborNoError )
+            {
+                xResult = cbor_encode_uint( &xTask, xTaskStatus[ x ].usStackHighWaterMark );
+            }
+
+            if( xResult == CborNoError )
+            {
+                xResult = cbor_encoder_close_container( &xTasks, &xTask );
+            }
+        }
+
+        if( xResult == CborNoError )
+        {
+            xResult = cbor_encoder_close_container( pxMap, &xTasks );
+        }
+    }
+
+    return xResult;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t METRICS_CreateReport( uint8_t * pucBuffer,
+                                 size_t xBufferSize,
+                                 size_t * pxReportSize )
+{
+    CborEncoder xEncoder, xMap;
+    CborError xResult;
+    uint32_t ulCounters[ 4 ];
+
+    cbor_encoder_init( &xEncoder, pucBuffer, xBufferSize, 0 );
+
+    /* The number of entries depends on the configuration and on the number
+     * of tasks, so the map has an indefinite length. */
+    xResult = cbor_encoder_create_map( &xEncoder, &xMap, CborIndefiniteLength );
+
+    if( xResult == CborNoError )
+    {
+        xResult = cbor_encode_text_stringz( &xMap, metricsKEY_VERSION );
+    }
+
+    if( xResult == CborNoError )
+    {
+        xResult = cbor_encode_uint( &xMap, metricsREPORT_VERSION );
+    }
+
+    if( xResult == CborNoError )
+    {
+        xResult = cbor_encode_text_stringz( &xMap, metricsKEY_UPTIME );
+    }
+
+    if( xResult == CborNoError )
+    {
+        xResult = cbor_encode_uint( &xMap, ( uint64_t ) xTaskGetTickCount() * portTICK_PERIOD_MS );
+    }
+
+    if( xResult == CborNoError )
+    {
+        xResult = prvEncodeTasks( &xMap );
+    }
+
+    #if ( metricsconfigINCLUDE_HEAP == 1 )
+        if( xResult == CborNoError )
+        {
+            ulCounters[ 0 ] = ( uint32_t ) xPortGetFreeHeapSize();
+            ulCounters[ 1 ] = ( uint32_t ) xPortGetMinimumEverFreeHeapSize();
+            xResult = prvEncodeCounters( &xMap, metricsKEY_HEAP, ulCounters, 2 );
+        }
+    #endif
+
+    #if ( metricsconfigINCLUDE_NETWORK_BUFFERS == 1 )
+        if( xResult == CborNoError )
+        {
+            ulCounters[ 0 ] = ( uint32_t ) uxGetNumberOfFreeNetworkBuffers();
+            ulCounters[ 1 ] = ( uint32_t ) uxGetMinimumFreeNetworkBuffers();
+            xResult = prvEncodeCounters( &xMap, metricsKEY_NETWORK_BUFFERS, ulCounters, 2 );
+        }
+    #endif
+
+    #if ( metricsconfigINCLUDE_MQTT == 1 )
+        if( xResult == CborNoError )
+        {
+            MQTTAgentStats_t xMQTTStats;
+
+            MQTT_AGENT_GetStats( &xMQTTStats );
+            ulCounters[ 0 ] = xMQTTStats.ulPublishesSent;
+            ulCounters[ 1 ] = xMQTTStats.ulPublishesFailed;
+            ulCounters[ 2 ] = xMQTTStats.ulPublishesReceived;
+            ulCounters[ 3 ] = xMQTTStats.ulPacketsDropped;
+            xResult = prvEncodeCounters( &xMap, metricsKEY_MQTT, ulCounters, 4 );
+        }
+    #endif
+
+    #if ( metricsconfigINCLUDE_OTA == 1 )
+        if( xResult == CborNoError )
+        {
+            ulCounters[ 0 ] = OTA_GetPacketsReceived();
+            ulCounters[ 1 ] = OTA_GetPacketsQueued();
+            ulCounters[ 2 ] = OTA_GetPacketsProcessed();
+            ulCounters[ 3 ] = OTA_GetPacketsDropped();
+            xResult = prvEncodeCounters( &xMap, metricsKEY_OTA, ulCounters, 4 );
+        }
+    #endif
+
+    ( void ) ulCounters;
+
+    if( xResult == CborNoError )
+    {
+        xResult = cbor_encoder_close_container( &xEncoder, &xMap );
+    }
+
+    if( xResult == CborNoError )
+    {
+        *pxReportSize = cbor_encoder_get_buffer_size( &xEncoder, pucBuffer );
+
+        #if ( configGENERATE_RUN_TIME_STATS == 1 )
+            prvUpdatePreviousRunTimes();
+        #endif
+    }
+
+    return ( xResult == CborNoError ) ? pdPASS : pdFAIL;
+}
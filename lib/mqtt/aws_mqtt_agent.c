@@ -37,6 +37,13 @@
 /* Buffer Pool includes. */
 #include "aws_bufferpool.h"
 
+/* Task pool includes. */
+#if ( mqttconfigUSE_TASK_POOL == 1 )
+    #include "aws_taskpool.h"
+    #include "aws_taskpool_config.h"
+    #include "aws_taskpool_config_defaults.h"
+#endif
+
 /* FreeRTOS includes. */
 #include "FreeRTOS.h"
 #include "task.h"
@@ -219,6 +226,25 @@ typedef struct MQTTBrokerConnection
     BaseType_t xConnectionInUse;                                        /**< Tracks whether or not the connection is in use. It is accessed from application tasks (prvGetFreeConnection and prvReturnConnection) and hence should be accessed in critical section. */
     uint8_t ucRxBuffer[ mqttconfigRX_BUFFER_SIZE ];                     /**< Buffers incoming messages. */
 } MQTTBrokerConnection_t;
+
+#if ( mqttconfigUSE_TASK_POOL == 1 )
+
+/**
+ * @brief A call to the generic connection callback waiting to run on the task
+ * pool.
+ *
+ * The callback and user data are copied so that the call is made with the
+ * values that were current when the event was received.
+ */
+    typedef struct MQTTDeferredCallback
+    {
+        MQTTAgentCallback_t pxCallback;            /**< The callback to invoke. */
+        void * pvUserData;                         /**< User data to be supplied back in the callback as it is. */
+        MQTTAgentCallbackParams_t xCallbackParams; /**< The event and related data. */
+        UBaseType_t uxBrokerNumber;                /**< The connection on which the event was received. */
+        BaseType_t xInUse;                         /**< Set by the MQTT task and cleared by the worker once the callback has returned. Accessed in critical section. */
+    } MQTTDeferredCallback_t;
+#endif
 /*-----------------------------------------------------------*/
 
 /**
@@ -268,6 +294,21 @@ static TaskHandle_t xMQTTTaskHandle = NULL;
  * MQTT task.
  */
 static uint32_t ulQueueMessageIdentifier = 0;
+
+/**
+ * @brief Counters returned by MQTT_AGENT_GetStats().
+ *
+ * Only the MQTT task updates them.
+ */
+static MQTTAgentStats_t xStats;
+
+#if ( mqttconfigUSE_TASK_POOL == 1 )
+
+/**
+ * @brief Callbacks waiting to run on the task pool.
+ */
+    static MQTTDeferredCallback_t xDeferredCallbacks[ mqttconfigMAX_DEFERRED_CALLBACKS ];
+#endif
 /*-----------------------------------------------------------*/
 
 /**
@@ -465,6 +506,39 @@ static void prvProcessReceivedPUBACK( MQTTBrokerConnection_t * const pxConnectio
 static BaseType_t prvProcessReceivedPublish( MQTTBrokerConnection_t * const pxConnection,
                                              const MQTTEventCallbackParams_t * const pxParams );
 
+/**
+ * @brief Invokes the generic callback registered for the connection.
+ *
+ * If mqttconfigUSE_TASK_POOL is 1 the callback is queued on the task pool and
+ * runs after this function returns, unless the task pool is busy in which case
+ * it is invoked directly.
+ *
+ * @param[in] pxConnection The connection on which the event was received. It
+ * must have a callback registered.
+ * @param[in] pxCallbackParams The event and related data.
+ *
+ * @return The value returned by the callback, or pdTRUE if the callback was
+ * queued. In that case the agent keeps the buffer of a received Publish
+ * message until the callback has run.
+ */
+static BaseType_t prvInvokeCallback( MQTTBrokerConnection_t * const pxConnection,
+                                     const MQTTAgentCallbackParams_t * const pxCallbackParams );
+
+#if ( mqttconfigUSE_TASK_POOL == 1 )
+
+/**
+ * @brief Runs a queued callback on a task pool worker.
+ *
+ * Returns the buffer of a received Publish message to the buffer pool if the
+ * callback did not take the ownership of it.
+ *
+ * @param[in] pvParameter1 The MQTTDeferredCallback_t to run.
+ * @param[in] ulParameter2 Not used.
+ */
+    static void prvRunDeferredCallback( void * pvParameter1,
+                                        uint32_t ulParameter2 );
+#endif
+
 /**
  * @brief Notifies the application task about the timeout.
  *
@@ -709,6 +783,7 @@ static MQTTBool_t prvMQTTEventCallback( void * pvCallbackContext,
             break;
 
         case eMQTTPublish:
+            xStats.ulPublishesReceived++;
 
             /* Inform the core library if the user wants to take
              * the ownership of the provided buffer. */
@@ -728,6 +803,7 @@ static MQTTBool_t prvMQTTEventCallback( void * pvCallbackContext,
             break;
 
         case eMQTTPacketDropped:
+            xStats.ulPacketsDropped++;
             mqttconfigDEBUG_LOG( ( "[WARN] MQTT Agent dropped a packet. No buffer available.\r\n" ) );
             mqttconfigDEBUG_LOG( ( "Consider adjusting parameters in aws_bufferpool_config.h.\r\n" ) );
             break;
@@ -1167,13 +1243,111 @@ static BaseType_t prvProcessReceivedPublish( MQTTBrokerConnection_t * const pxCo
         xCallbackParams.xMQTTEvent = eMQTTAgentPublish;
         xCallbackParams.u.xPublishData = pxParams->u.xPublishData;
 
-        xReturn = pxConnection->pxCallback( pxConnection->pvUserData, &( xCallbackParams ) );
+        xReturn = prvInvokeCallback( pxConnection, &( xCallbackParams ) );
     }
 
     return xReturn;
 }
 /*-----------------------------------------------------------*/
 
+static BaseType_t prvInvokeCallback( MQTTBrokerConnection_t * const pxConnection,
+                                     const MQTTAgentCallbackParams_t * const pxCallbackParams )
+{
+    BaseType_t xReturn;
+
+    #if ( mqttconfigUSE_TASK_POOL == 1 )
+        UBaseType_t x;
+        UBaseType_t uxBrokerNumber = ( UBaseType_t ) ( pxConnection - xMQTTConnections );
+        MQTTDeferredCallback_t * pxDeferred = NULL;
+
+        /* Find a free slot to hold the call. */
+        taskENTER_CRITICAL();
+        {
+            for( x = 0; x < ( UBaseType_t ) mqttconfigMAX_DEFERRED_CALLBACKS; x++ )
+            {
+                if( xDeferredCallbacks[ x ].xInUse == pdFALSE )
+                {
+                    pxDeferred = &( xDeferredCallbacks[ x ] );
+                    pxDeferred->xInUse = pdTRUE;
+                    break;
+                }
+            }
+        }
+        taskEXIT_CRITICAL();
+
+        if( pxDeferred != NULL )
+        {
+            pxDeferred->pxCallback = pxConnection->pxCallback;
+            pxDeferred->pvUserData = pxConnection->pvUserData;
+            pxDeferred->xCallbackParams = *pxCallbackParams;
+            pxDeferred->uxBrokerNumber = uxBrokerNumber;
+
+            /* All the callbacks of a connection run on the same worker so
+             * that they are invoked in order and never at the same time. */
+            if( TASKPOOL_SubmitToWorker( uxBrokerNumber % ( UBaseType_t ) taskpoolconfigNUM_WORKERS,
+                                         prvRunDeferredCallback,
+                                         pxDeferred,
+                                         0,
+                                         eTaskPoolLaneNormal ) != pdPASS )
+            {
+                taskENTER_CRITICAL();
+                {
+                    pxDeferred->xInUse = pdFALSE;
+                }
+                taskEXIT_CRITICAL();
+
+                pxDeferred = NULL;
+            }
+        }
+
+        if( pxDeferred != NULL )
+        {
+            /* The worker returns the buffer if the callback does not keep
+             * it. */
+            xReturn = pdTRUE;
+        }
+        else
+        {
+            mqttconfigDEBUG_LOG( ( "Task pool busy, invoking the MQTT callback from the MQTT task.\r\n" ) );
+            xReturn = pxConnection->pxCallback( pxConnection->pvUserData, pxCallbackParams );
+        }
+    #else /* if ( mqttconfigUSE_TASK_POOL == 1 ) */
+        xReturn = pxConnection->pxCallback( pxConnection->pvUserData, pxCallbackParams );
+    #endif /* if ( mqttconfigUSE_TASK_POOL == 1 ) */
+
+    return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+#if ( mqttconfigUSE_TASK_POOL == 1 )
+
+    static void prvRunDeferredCallback( void * pvParameter1,
+                                        uint32_t ulParameter2 )
+    {
+        MQTTDeferredCallback_t * pxDeferred = ( MQTTDeferredCallback_t * ) pvParameter1;
+        BaseType_t xBufferTaken;
+
+        /* Remove compiler warnings about unused parameters. */
+        ( void ) ulParameter2;
+
+        xBufferTaken = pxDeferred->pxCallback( pxDeferred->pvUserData, &( pxDeferred->xCallbackParams ) );
+
+        if( ( pxDeferred->xCallbackParams.xMQTTEvent == eMQTTAgentPublish ) && ( xBufferTaken == pdFALSE ) )
+        {
+            ( void ) MQTT_AGENT_ReturnBuffer( ( MQTTAgentHandle_t ) mqttENCODE_BROKER_NUMBER( pxDeferred->uxBrokerNumber ), /*lint !e923 Opaque pointer. */
+                                              pxDeferred->xCallbackParams.u.xPublishData.xBuffer );
+        }
+
+        taskENTER_CRITICAL();
+        {
+            pxDeferred->xInUse = pdFALSE;
+        }
+        taskEXIT_CRITICAL();
+    }
+
+#endif /* if ( mqttconfigUSE_TASK_POOL == 1 ) */
+/*-----------------------------------------------------------*/
+
 static void prvProcessReceivedTimeout( MQTTBrokerConnection_t * const pxConnection,
                                        const MQTTEventCallbackParams_t * const pxParams )
 {
@@ -1208,7 +1382,7 @@ static void prvProcessReceivedDisconnect( MQTTBrokerConnection_t * const pxConne
         if( pxConnection->pxCallback != NULL )
         {
             xCallbackParams.xMQTTEvent = eMQTTAgentDisconnect;
-            ( void ) pxConnection->pxCallback( pxConnection->pvUserData, &( xCallbackParams ) );
+            ( void ) prvInvokeCallback( pxConnection, &( xCallbackParams ) );
         }
 
         /* Close the connection. */
@@ -1251,7 +1425,7 @@ static void prvNotifyRequestingTask( MQTTNotificationData_t * const pxNotificati
         pxNotificationData->ulMessageIdentifier |= uxStatus;
 
         /* Notify the task. */
-        ( void ) xTaskNotify( pxNotificationData->xTaskToNotify, pxNotificationData->ulMessageIdentifier, eSetValueWithoutOverwrite );
+        ( void ) xTaskNotifyIndexed( pxNotificationData->xTaskToNotify, mqttconfigNOTIFICATION_INDEX, pxNotificationData->ulMessageIdentifier, eSetValueWithoutOverwrite );
 
         /* Free up the buffer for further use. */
         pxNotificationData->xTaskToNotify = NULL;
@@ -1591,6 +1765,7 @@ static void prvInitiateMQTTPublish( MQTTEventData_t * const pxEventData )
         if( MQTT_Publish( &( pxConnection->xMQTTContext ), &( xPublishParams ) ) == eMQTTSuccess )
         {
             xStatus = pdPASS;
+            xStats.ulPublishesSent++;
         }
         else
         {
@@ -1611,6 +1786,8 @@ static void prvInitiateMQTTPublish( MQTTEventData_t * const pxEventData )
 
     if( xStatus == pdFAIL )
     {
+        xStats.ulPublishesFailed++;
+
         /* The Publish was not successful.  Inform the task that initiated
          * the Publish operation. */
         prvNotifyRequestingTask( &( pxEventData->xNotificationData ), eMQTTPUBCouldNotBeSent, pdFAIL );
@@ -1664,9 +1841,10 @@ static MQTTAgentReturnCode_t prvSendCommandToMQTTTask( MQTTEventData_t * pxEvent
         vTaskSetTimeOutState( &( pxEventData->xEventCreationTimestamp ) );
 
         /* The calling task is going to wait for a notification, so clear the
-         * notifications state first.  This is probably not necessary as the task will
-         * wait for a particular notification value, but is for maximum robustness. */
-        ( void ) xTaskNotifyStateClear( NULL );
+         * notification state of the agent's index first.  This is probably not
+         * necessary as the task will wait for a particular notification value,
+         * but is for maximum robustness. */
+        ( void ) xTaskNotifyStateClearIndexed( NULL, mqttconfigNOTIFICATION_INDEX );
 
         /* The MQTT protocol is running in a separate task, to which commands
          * are sent on a queue, and a signal is sent back using a task
@@ -1689,7 +1867,7 @@ static MQTTAgentReturnCode_t prvSendCommandToMQTTTask( MQTTEventData_t * pxEvent
                  * block here forever and rely on the notification from the MQTT task
                  * to unblock us. Return value is ignored because in case of portMAX_DELAY
                  * the function will return only when a notification is received. */
-                ( void ) xTaskNotifyWait( 0UL, 0UL, &ulReceivedMessageIdentifier, portMAX_DELAY );
+                ( void ) xTaskNotifyWaitIndexed( mqttconfigNOTIFICATION_INDEX, 0UL, 0UL, &ulReceivedMessageIdentifier, portMAX_DELAY );
 
                 if( pxEventData->xNotificationData.ulMessageIdentifier == ( ulReceivedMessageIdentifier & mqttMESSAGE_IDENTIFIER_MASK ) )
                 {
@@ -1880,6 +2058,17 @@ BaseType_t MQTT_AGENT_Init( void )
             }
         }
 
+        #if ( mqttconfigUSE_TASK_POOL == 1 )
+            {
+                memset( xDeferredCallbacks, 0x00, sizeof( xDeferredCallbacks ) );
+
+                if( TASKPOOL_Init() != pdPASS )
+                {
+                    xReturnCode = pdFAIL;
+                }
+            }
+        #endif
+
         /* ulQueueMessageIdentifier uses the top 16-bits of a 32-bit value, so
          * initialize it to its start value. */
         ulQueueMessageIdentifier = mqttMESSAGE_IDENTIFIER_MIN;
@@ -2063,3 +2252,13 @@ MQTTAgentReturnCode_t MQTT_AGENT_ReturnBuffer( MQTTAgentHandle_t xMQTTHandle,
     return eMQTTAgentSuccess;
 }
 /*-----------------------------------------------------------*/
+
+void MQTT_AGENT_GetStats( MQTTAgentStats_t * pxStats )
+{
+    taskENTER_CRITICAL();
+    {
+        *pxStats = xStats;
+    }
+    taskEXIT_CRITICAL();
+}
+/*-----------------------------------------------------------*/
@@ -51,6 +51,10 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 /* MQTT includes. */
 #include "aws_mqtt_agent.h"
 
+#if ( otaconfigUSE_TASK_POOL == 1 )
+    #include "aws_taskpool.h"
+#endif
+
 /* JSON job document parser includes. */
 #include "jsmn.h"           /*lint !e537 All headers have multiple inclusion prevention. */
 #include "mbedtls/base64.h"
@@ -339,6 +343,18 @@ static OTA_Err_t prvSetImageStateWithReason (OTA_ImageState_t eState, uint32_t u
 
 static void prvDefaultOTACompleteCallback( OTA_JobEvent_t eEvent );
 
+/* Call the job complete callback, on the task pool if it is enabled. */
+
+static void prvInvokeJobCompleteCallback( OTA_JobEvent_t eEvent );
+
+#if ( otaconfigUSE_TASK_POOL == 1 )
+
+/* Task pool job that calls the job complete callback with the event in ulEvent. */
+
+static void prvRunJobCompleteCallback( void * pvUnused, uint32_t ulEvent );
+
+#endif
+
 /* A helper function to cleanup resources during OTA agent shutdown. */
 
 static void prvAgentShutdownCleanup( OTA_PubMsg_t *pxMsgMetaData );
@@ -457,6 +473,38 @@ static void prvDefaultOTACompleteCallback( OTA_JobEvent_t eEvent )
 }
 
 
+/* If the task pool is enabled, the job complete callback is queued on it so that the OTA task
+ * can carry on with the job status updates while the user code runs. The callback is called
+ * directly if the task pool cannot take the job. */
+
+static void prvInvokeJobCompleteCallback( OTA_JobEvent_t eEvent )
+{
+#if ( otaconfigUSE_TASK_POOL == 1 )
+    DEFINE_OTA_METHOD_NAME("prvInvokeJobCompleteCallback");
+
+    if ( TASKPOOL_Submit( prvRunJobCompleteCallback, NULL, ( uint32_t ) eEvent, eTaskPoolLaneHigh ) != pdPASS )
+    {
+        OTA_LOG_L1("[%s] Task pool busy, calling the job complete callback from the OTA task.\r\n", OTA_METHOD_NAME);
+        xOTA_Agent.pxOTAJobCompleteCallback ( eEvent );
+    }
+#else
+    xOTA_Agent.pxOTAJobCompleteCallback ( eEvent );
+#endif
+}
+
+
+#if ( otaconfigUSE_TASK_POOL == 1 )
+
+static void prvRunJobCompleteCallback( void * pvUnused, uint32_t ulEvent )
+{
+    ( void ) pvUnused;
+
+    xOTA_Agent.pxOTAJobCompleteCallback ( ( OTA_JobEvent_t ) ulEvent );
+}
+
+#endif
+
+
 /* Public API to initialize the OTA Agent.
  *
  * If the Application calls OTA_AgentInit() after it is already initialized, we will
@@ -520,6 +568,12 @@ OTA_State_t OTA_AgentInit(void *pvClient, const uint8_t *pcThingName, pxOTACompl
 	        for (ulIndex = 0; ulIndex < OTA_MAX_FILES; ulIndex++) {
 	            xOTA_Agent.pxOTA_Files[ulIndex].pacFilepath = NULL;
 	        }
+#if ( otaconfigUSE_TASK_POOL == 1 )
+	        if ( TASKPOOL_Init() != pdPASS )
+	        {
+	            OTA_LOG_L1("[%s] Failed to start the task pool.\r\n", OTA_METHOD_NAME);
+	        }
+#endif
 	        xReturn = xTaskCreate(prvOTAUpdateTask, "OTA Task", otaconfigSTACK_SIZE, NULL, otaconfigAGENT_PRIORITY, &pxOTA_TaskHandle);
 	        portEXIT_CRITICAL();                                /* Protected elements are initialized. It's now safe to context switch. */
 	        if (xReturn == pdPASS)
@@ -1340,7 +1394,7 @@ static void prvOTAUpdateTask( void* pvUnused )
 							            /* Check the platform's OTA update image state. It should also be in self test. */
 							            if ( OTA_CheckForSelfTest() == pdTRUE)
 							            {
-							                xOTA_Agent.pxOTAJobCompleteCallback ( eOTA_JobEvent_StartTest );
+							                prvInvokeJobCompleteCallback ( eOTA_JobEvent_StartTest );
 							            }
 							            else {
 							                /* The job is in self test but the platform image state is not so it could be
@@ -1398,7 +1452,7 @@ static void prvOTAUpdateTask( void* pvUnused )
                                         C = NULL;
 
                                         /* Let main application know of our result. */
-                                        xOTA_Agent.pxOTAJobCompleteCallback ((xResult == eIngest_Result_FileComplete) ? eOTA_JobEvent_Activate : eOTA_JobEvent_Fail);
+                                        prvInvokeJobCompleteCallback ((xResult == eIngest_Result_FileComplete) ? eOTA_JobEvent_Activate : eOTA_JobEvent_Fail);
 
                                         /* Free any remaining string memory holding the job name since this job is done. */
                                         if (xOTA_Agent.pcOTA_Singleton_ActiveJobName != NULL)
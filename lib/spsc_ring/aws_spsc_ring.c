@@ -0,0 +1,248 @@
+/*
+ * Amazon FreeRTOS
+ * Copyright (C) 2018 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+/**
+ * @file aws_spsc_ring.c
+ * @brief An implementation of the SPSC ring interface.
+ *
+ * The head and tail are free running counters, so the ring is empty when
+ * they are equal and full when they differ by the number of slots, and every
+ * slot can be used.  Each side reads the other side's counter, then touches
+ * the slot, then writes its own counter, with a barrier between each step:
+ *
+ * - The acquire barrier after reading the other side's counter keeps the slot
+ *   accesses from being done before the counter said the slot was ready.
+ * - The release barrier before writing its own counter keeps the slot
+ *   accesses from being done after the other side has been told the slot is
+ *   ready.
+ *
+ * To wait, the consumer sets a flag and then reads the count; after a commit
+ * the producer reads the flag and then the count, and notifies the consumer
+ * if both say so.  With a barrier between the write and the read on both
+ * sides, at least one of them sees the other's write, so either the consumer
+ * does not block or the producer notifies it.  This needs a full barrier,
+ * which is the expensive one, so it is only used when there is a consumer to
+ * wake.  Task notifications are
+ * latched, so the notification is not lost if the consumer has not blocked
+ * yet.
+ */
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+
+/* SPSC ring includes. */
+#include "aws_spsc_ring.h"
+#include "aws_spsc_ring_config.h"
+#include "aws_spsc_ring_config_defaults.h"
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Publishes the acquired slots to the consumer.
+ *
+ * @param[in] pxRing The ring.
+ *
+ * @return pdTRUE if the consumer waits and the count has reached its wake
+ * threshold, in which case the consumer must be notified.
+ */
+static BaseType_t prvCommit( SPSCRing_t * pxRing );
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvCommit( SPSCRing_t * pxRing )
+{
+    uint32_t ulHead = pxRing->ulHead + pxRing->ulAcquired;
+    BaseType_t xNotify = pdFALSE;
+
+    pxRing->ulAcquired = 0;
+
+    spscringconfigRELEASE_BARRIER();
+    pxRing->ulHead = ulHead;
+
+    if( pxRing->xConsumer != NULL )
+    {
+        /* The head must be visible before the flag is read. */
+        spscringconfigMEMORY_BARRIER();
+
+        /* A tail read before the consumer's latest release only makes the
+         * count look larger, which at worst wakes the consumer early. */
+        if( ( pxRing->xWaiting != pdFALSE ) &&
+            ( ( ulHead - pxRing->ulTail ) >= pxRing->ulWakeThreshold ) )
+        {
+            /* Only notify once per wait. */
+            pxRing->xWaiting = pdFALSE;
+            xNotify = pdTRUE;
+        }
+    }
+
+    return xNotify;
+}
+/*-----------------------------------------------------------*/
+
+void SPSCRING_Init( SPSCRing_t * pxRing,
+                    void * pvStorage,
+                    size_t xSlotSize,
+                    uint32_t ulSlotCount )
+{
+    configASSERT( pvStorage != NULL );
+    configASSERT( xSlotSize > 0 );
+    configASSERT( ( ulSlotCount > 0UL ) && ( ( ulSlotCount & ( ulSlotCount - 1UL ) ) == 0UL ) );
+
+    pxRing->pucStorage = ( uint8_t * ) pvStorage;
+    pxRing->xSlotSize = xSlotSize;
+    pxRing->ulMask = ulSlotCount - 1UL;
+    pxRing->ulHead = 0;
+    pxRing->ulTail = 0;
+    pxRing->xConsumer = NULL;
+    pxRing->uxNotifyIndex = 0;
+    pxRing->ulWakeThreshold = 1;
+    pxRing->ulAcquired = 0;
+    pxRing->xWaiting = pdFALSE;
+}
+/*-----------------------------------------------------------*/
+
+void SPSCRING_SetConsumer( SPSCRing_t * pxRing,
+                           TaskHandle_t xConsumer,
+                           UBaseType_t uxIndexToNotify,
+                           uint32_t ulWakeThreshold )
+{
+    configASSERT( uxIndexToNotify < configTASK_NOTIFICATION_ARRAY_ENTRIES );
+    configASSERT( ( ulWakeThreshold > 0UL ) && ( ulWakeThreshold <= ( pxRing->ulMask + 1UL ) ) );
+
+    pxRing->uxNotifyIndex = uxIndexToNotify;
+    pxRing->ulWakeThreshold = ulWakeThreshold;
+    pxRing->xConsumer = xConsumer;
+}
+/*-----------------------------------------------------------*/
+
+void * SPSCRING_AcquireWrite( SPSCRing_t * pxRing )
+{
+    uint32_t ulNext = pxRing->ulHead + pxRing->ulAcquired;
+    void * pvSlot = NULL;
+
+    if( ( ulNext - pxRing->ulTail ) <= pxRing->ulMask )
+    {
+        spscringconfigACQUIRE_BARRIER();
+        pvSlot = &( pxRing->pucStorage[ ( ulNext & pxRing->ulMask ) * pxRing->xSlotSize ] );
+        pxRing->ulAcquired++;
+    }
+
+    return pvSlot;
+}
+/*-----------------------------------------------------------*/
+
+void SPSCRING_CommitWrite( SPSCRing_t * pxRing )
+{
+    if( prvCommit( pxRing ) != pdFALSE )
+    {
+        ( void ) xTaskNotifyGiveIndexed( pxRing->xConsumer, pxRing->uxNotifyIndex );
+    }
+}
+/*-----------------------------------------------------------*/
+
+void SPSCRING_CommitWriteFromISR( SPSCRing_t * pxRing,
+                                  BaseType_t * pxHigherPriorityTaskWoken )
+{
+    if( prvCommit( pxRing ) != pdFALSE )
+    {
+        vTaskNotifyGiveIndexedFromISR( pxRing->xConsumer, pxRing->uxNotifyIndex, pxHigherPriorityTaskWoken );
+    }
+}
+/*-----------------------------------------------------------*/
+
+void * SPSCRING_AcquireRead( SPSCRing_t * pxRing )
+{
+    uint32_t ulTail = pxRing->ulTail;
+    void * pvSlot = NULL;
+
+    if( pxRing->ulHead != ulTail )
+    {
+        spscringconfigACQUIRE_BARRIER();
+        pvSlot = &( pxRing->pucStorage[ ( ulTail & pxRing->ulMask ) * pxRing->xSlotSize ] );
+    }
+
+    return pvSlot;
+}
+/*-----------------------------------------------------------*/
+
+void SPSCRING_ReleaseRead( SPSCRing_t * pxRing )
+{
+    uint32_t ulTail = pxRing->ulTail + 1UL;
+
+    spscringconfigRELEASE_BARRIER();
+    pxRing->ulTail = ulTail;
+}
+/*-----------------------------------------------------------*/
+
+uint32_t SPSCRING_GetCount( const SPSCRing_t * pxRing )
+{
+    uint32_t ulTail = pxRing->ulTail;
+
+    return pxRing->ulHead - ulTail;
+}
+/*-----------------------------------------------------------*/
+
+uint32_t SPSCRING_Wait( SPSCRing_t * pxRing,
+                        TickType_t xTicksToWait )
+{
+    TimeOut_t xTimeOut;
+    uint32_t ulCount;
+
+    configASSERT( pxRing->xConsumer == xTaskGetCurrentTaskHandle() );
+
+    vTaskSetTimeOutState( &xTimeOut );
+
+    for( ; ; )
+    {
+        /* The flag must be visible before the head is read. */
+        pxRing->xWaiting = pdTRUE;
+        spscringconfigMEMORY_BARRIER();
+
+        ulCount = SPSCRING_GetCount( pxRing );
+
+        if( ulCount >= pxRing->ulWakeThreshold )
+        {
+            break;
+        }
+
+        if( xTaskCheckForTimeOut( &xTimeOut, &xTicksToWait ) != pdFALSE )
+        {
+            break;
+        }
+
+        /* Any notification ends the wait, whether it came from the producer,
+         * was left from an earlier wait, or was sent by another task sharing
+         * the index, so the caller sees the count in all cases. */
+        if( ulTaskNotifyTakeIndexed( pxRing->uxNotifyIndex, pdTRUE, xTicksToWait ) != 0U )
+        {
+            ulCount = SPSCRING_GetCount( pxRing );
+            break;
+        }
+    }
+
+    pxRing->xWaiting = pdFALSE;
+
+    return ulCount;
+}
+/*-----------------------------------------------------------*/
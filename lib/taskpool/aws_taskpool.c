@@ -0,0 +1,477 @@
+/*
+ * Amazon FreeRTOS
+ * Copyright (C) 2018 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+/**
+ * @file aws_taskpool.c
+ * @brief An implementation of the Task Pool interface on statically allocated
+ * worker tasks.
+ *
+ * Each worker owns a bounded queue per lane.  A worker takes jobs from the
+ * front of its own queues, and when they are empty steals from the back of the
+ * queues of the other workers.  The queues are small and only ever touched for
+ * a few instructions, so they are protected by critical sections rather than
+ * by a mutex.
+ */
+
+/* Standard includes. */
+#include <string.h>
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+
+/* Task pool includes. */
+#include "aws_taskpool.h"
+#include "aws_taskpool_config.h"
+#include "aws_taskpool_config_defaults.h"
+
+/**
+ * @brief The number of lanes in TaskPoolLane_t.
+ */
+#define taskpoolNUM_LANES    ( 2 )
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief A queued job.
+ */
+typedef struct TaskPoolJob
+{
+    TaskPoolFunction_t pxFunction; /**< The function to run. */
+    void * pvParameter1;           /**< First parameter of pxFunction. */
+    uint32_t ulParameter2;         /**< Second parameter of pxFunction. */
+    BaseType_t xPinned;            /**< pdTRUE if the job must run on the worker it was queued on. */
+} TaskPoolJob_t;
+
+/**
+ * @brief A bounded double ended queue of jobs.
+ *
+ * The owner takes jobs from the front so that its jobs run in the order in
+ * which they were queued.  Other workers steal from the back.
+ */
+typedef struct TaskPoolDeque
+{
+    TaskPoolJob_t xJobs[ taskpoolconfigQUEUE_LENGTH ]; /**< Ring buffer of jobs. */
+    UBaseType_t uxFront;                               /**< Index of the oldest job. */
+    UBaseType_t uxCount;                               /**< Number of jobs queued. */
+} TaskPoolDeque_t;
+
+/**
+ * @brief The state of a worker task.
+ */
+typedef struct TaskPoolWorker
+{
+    TaskHandle_t xTask;                           /**< The worker task. */
+    TaskPoolDeque_t xDeques[ taskpoolNUM_LANES ]; /**< One queue per lane, in lane order. */
+    BaseType_t xIdle;                             /**< pdTRUE while the worker waits for a job. */
+    #if ( configSUPPORT_STATIC_ALLOCATION == 1 )
+        StaticTask_t xTaskBuffer;                            /**< Holds the worker's TCB. */
+        StackType_t xStack[ taskpoolconfigWORKER_STACK_DEPTH ]; /**< The worker's stack. */
+    #endif
+} TaskPoolWorker_t;
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief The workers.
+ */
+static TaskPoolWorker_t xWorkers[ taskpoolconfigNUM_WORKERS ];
+
+/**
+ * @brief The worker that the next job submitted from outside the pool is
+ * queued on first.
+ */
+static UBaseType_t uxNextWorker = 0;
+
+/**
+ * @brief Counters returned by TASKPOOL_GetStats().
+ */
+static TaskPoolStats_t xStats;
+
+/**
+ * @brief Set once TASKPOOL_Init() has created the workers.
+ */
+static BaseType_t xPoolInitialized = pdFALSE;
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief The function run by each worker task.
+ *
+ * @param[in] pvParameters The worker's TaskPoolWorker_t.
+ */
+static void prvWorkerTask( void * pvParameters );
+
+/**
+ * @brief Takes the next job for a worker.
+ *
+ * Looks at the lanes in priority order.  In each lane, the worker's own queue
+ * is tried first and then the queues of the other workers, starting with the
+ * next one.  If no job is found the worker is marked idle, so that the next
+ * job submitted wakes it.
+ *
+ * @param[in] pxWorker The worker looking for a job.
+ * @param[out] pxJob The job to run.
+ *
+ * @return pdTRUE if a job was taken, pdFALSE otherwise.
+ */
+static BaseType_t prvTakeJob( TaskPoolWorker_t * pxWorker,
+                              TaskPoolJob_t * pxJob );
+
+/**
+ * @brief Queues a job.
+ *
+ * Must be called from a critical section.
+ *
+ * @param[in] pxJob The job to queue.
+ * @param[in] uxWorker The worker to queue the job on, or
+ * taskpoolconfigNUM_WORKERS to choose one.
+ * @param[in] eLane The lane to queue the job in.
+ * @param[out] pxTaskToNotify The worker to wake once the critical section
+ * has been left, or NULL if no worker needs waking.
+ *
+ * @return pdPASS if the job was queued, pdFAIL if the lane was full.
+ */
+static BaseType_t prvQueueJob( const TaskPoolJob_t * pxJob,
+                               UBaseType_t uxWorker,
+                               TaskPoolLane_t eLane,
+                               TaskHandle_t * pxTaskToNotify );
+
+/**
+ * @brief Common part of TASKPOOL_Submit() and TASKPOOL_SubmitToWorker().
+ */
+static BaseType_t prvSubmit( UBaseType_t uxWorker,
+                             TaskPoolFunction_t pxFunction,
+                             void * pvParameter1,
+                             uint32_t ulParameter2,
+                             TaskPoolLane_t eLane );
+/*-----------------------------------------------------------*/
+
+static void prvWorkerTask( void * pvParameters )
+{
+    TaskPoolWorker_t * pxWorker = ( TaskPoolWorker_t * ) pvParameters;
+    TaskPoolJob_t xJob;
+
+    for( ; ; )
+    {
+        if( prvTakeJob( pxWorker, &xJob ) == pdTRUE )
+        {
+            xJob.pxFunction( xJob.pvParameter1, xJob.ulParameter2 );
+
+            taskENTER_CRITICAL();
+            {
+                xStats.ulJobsRun++;
+            }
+            taskEXIT_CRITICAL();
+        }
+        else
+        {
+            /* The count of the notification is not relevant, the queues are
+             * searched again either way. */
+            ( void ) ulTaskNotifyTakeIndexed( taskpoolconfigNOTIFICATION_INDEX, pdTRUE, portMAX_DELAY );
+        }
+    }
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvTakeJob( TaskPoolWorker_t * pxWorker,
+                              TaskPoolJob_t * pxJob )
+{
+    BaseType_t xFound = pdFALSE;
+    UBaseType_t uxLane, uxOffset, uxIndex;
+    UBaseType_t uxSelf = ( UBaseType_t ) ( pxWorker - xWorkers );
+    TaskPoolDeque_t * pxDeque;
+
+    taskENTER_CRITICAL();
+    {
+        for( uxLane = 0; ( uxLane < taskpoolNUM_LANES ) && ( xFound == pdFALSE ); uxLane++ )
+        {
+            /* The worker's own queue, from the front. */
+            pxDeque = &( pxWorker->xDeques[ uxLane ] );
+
+            if( pxDeque->uxCount > 0U )
+            {
+                *pxJob = pxDeque->xJobs[ pxDeque->uxFront ];
+                pxDeque->uxFront = ( pxDeque->uxFront + 1U ) % taskpoolconfigQUEUE_LENGTH;
+                pxDeque->uxCount--;
+                xFound = pdTRUE;
+            }
+
+            /* The other workers' queues, from the back.  A pinned job at the
+             * back of a queue means there is nothing to steal from it. */
+            for( uxOffset = 1; ( uxOffset < taskpoolconfigNUM_WORKERS ) && ( xFound == pdFALSE ); uxOffset++ )
+            {
+                pxDeque = &( xWorkers[ ( uxSelf + uxOffset ) % taskpoolconfigNUM_WORKERS ].xDeques[ uxLane ] );
+
+                if( pxDeque->uxCount > 0U )
+                {
+                    uxIndex = ( pxDeque->uxFront + pxDeque->uxCount - 1U ) % taskpoolconfigQUEUE_LENGTH;
+
+                    if( pxDeque->xJobs[ uxIndex ].xPinned == pdFALSE )
+                    {
+                        *pxJob = pxDeque->xJobs[ uxIndex ];
+                        pxDeque->uxCount--;
+                        xStats.ulJobsStolen++;
+                        xFound = pdTRUE;
+                    }
+                }
+            }
+        }
+
+        pxWorker->xIdle = ( xFound == pdFALSE ) ? pdTRUE : pdFALSE;
+    }
+    taskEXIT_CRITICAL();
+
+    return xFound;
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvQueueJob( const TaskPoolJob_t * pxJob,
+                               UBaseType_t uxWorker,
+                               TaskPoolLane_t eLane,
+                               TaskHandle_t * pxTaskToNotify )
+{
+    BaseType_t xReturn = pdFAIL;
+    TaskPoolWorker_t * pxWorker = NULL;
+    TaskPoolDeque_t * pxDeque;
+    TaskHandle_t xCurrentTask;
+    UBaseType_t x;
+
+    if( uxWorker < ( UBaseType_t ) taskpoolconfigNUM_WORKERS )
+    {
+        /* The caller chose the worker. */
+        if( xWorkers[ uxWorker ].xDeques[ eLane ].uxCount < ( UBaseType_t ) taskpoolconfigQUEUE_LENGTH )
+        {
+            pxWorker = &( xWorkers[ uxWorker ] );
+        }
+    }
+    else
+    {
+        /* A job submitted by a job stays on the same worker, where it is
+         * likely to find its data in the cache, unless it is stolen.  Other
+         * jobs are spread over the workers in turn. */
+        xCurrentTask = xTaskGetCurrentTaskHandle();
+
+        for( x = 0; x < ( UBaseType_t ) taskpoolconfigNUM_WORKERS; x++ )
+        {
+            if( xWorkers[ x ].xTask == xCurrentTask )
+            {
+                uxNextWorker = x;
+                break;
+            }
+        }
+
+        for( x = 0; ( x < ( UBaseType_t ) taskpoolconfigNUM_WORKERS ) && ( pxWorker == NULL ); x++ )
+        {
+            uxWorker = ( uxNextWorker + x ) % taskpoolconfigNUM_WORKERS;
+
+            if( xWorkers[ uxWorker ].xDeques[ eLane ].uxCount < ( UBaseType_t ) taskpoolconfigQUEUE_LENGTH )
+            {
+                pxWorker = &( xWorkers[ uxWorker ] );
+            }
+        }
+
+        uxNextWorker = ( uxWorker + 1U ) % taskpoolconfigNUM_WORKERS;
+    }
+
+    if( pxWorker != NULL )
+    {
+        pxDeque = &( pxWorker->xDeques[ eLane ] );
+        pxDeque->xJobs[ ( pxDeque->uxFront + pxDeque->uxCount ) % taskpoolconfigQUEUE_LENGTH ] = *pxJob;
+        pxDeque->uxCount++;
+
+        /* Wake the worker the job was queued on, or if that worker is busy
+         * and the job can be stolen, any idle worker. */
+        *pxTaskToNotify = NULL;
+
+        if( pxWorker->xIdle != pdFALSE )
+        {
+            pxWorker->xIdle = pdFALSE;
+            *pxTaskToNotify = pxWorker->xTask;
+        }
+        else if( pxJob->xPinned == pdFALSE )
+        {
+            for( x = 0; x < ( UBaseType_t ) taskpoolconfigNUM_WORKERS; x++ )
+            {
+                if( xWorkers[ x ].xIdle != pdFALSE )
+                {
+                    xWorkers[ x ].xIdle = pdFALSE;
+                    *pxTaskToNotify = xWorkers[ x ].xTask;
+                    break;
+                }
+            }
+        }
+
+        xReturn = pdPASS;
+    }
+    else
+    {
+        xStats.ulJobsRejected++;
+    }
+
+    return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvSubmit( UBaseType_t uxWorker,
+                             TaskPoolFunction_t pxFunction,
+                             void * pvParameter1,
+                             uint32_t ulParameter2,
+                             TaskPoolLane_t eLane )
+{
+    BaseType_t xReturn;
+    TaskPoolJob_t xJob;
+    TaskHandle_t xTaskToNotify = NULL;
+
+    configASSERT( xPoolInitialized == pdTRUE );
+    configASSERT( pxFunction != NULL );
+    configASSERT( ( UBaseType_t ) eLane < ( UBaseType_t ) taskpoolNUM_LANES );
+
+    xJob.pxFunction = pxFunction;
+    xJob.pvParameter1 = pvParameter1;
+    xJob.ulParameter2 = ulParameter2;
+    xJob.xPinned = ( uxWorker < ( UBaseType_t ) taskpoolconfigNUM_WORKERS ) ? pdTRUE : pdFALSE;
+
+    taskENTER_CRITICAL();
+    {
+        xReturn = prvQueueJob( &xJob, uxWorker, eLane, &xTaskToNotify );
+    }
+    taskEXIT_CRITICAL();
+
+    if( xTaskToNotify != NULL )
+    {
+        ( void ) xTaskNotifyGiveIndexed( xTaskToNotify, taskpoolconfigNOTIFICATION_INDEX );
+    }
+
+    return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t TASKPOOL_Init( void )
+{
+    BaseType_t xReturn = pdPASS;
+    UBaseType_t x;
+
+    if( xPoolInitialized == pdFALSE )
+    {
+        memset( xWorkers, 0, sizeof( xWorkers ) );
+        memset( &xStats, 0, sizeof( xStats ) );
+
+        /* The workers start busy and mark themselves idle once they find
+         * nothing to do. */
+        for( x = 0; x < ( UBaseType_t ) taskpoolconfigNUM_WORKERS; x++ )
+        {
+            #if ( configSUPPORT_STATIC_ALLOCATION == 1 )
+                xWorkers[ x ].xTask = xTaskCreateStatic( prvWorkerTask,
+                                                         "TaskPool",
+                                                         taskpoolconfigWORKER_STACK_DEPTH,
+                                                         &( xWorkers[ x ] ),
+                                                         taskpoolconfigWORKER_PRIORITY,
+                                                         xWorkers[ x ].xStack,
+                                                         &( xWorkers[ x ].xTaskBuffer ) );
+            #else
+                ( void ) xTaskCreate( prvWorkerTask,
+                                      "TaskPool",
+                                      taskpoolconfigWORKER_STACK_DEPTH,
+                                      &( xWorkers[ x ] ),
+                                      taskpoolconfigWORKER_PRIORITY,
+                                      &( xWorkers[ x ].xTask ) );
+            #endif
+
+            if( xWorkers[ x ].xTask == NULL )
+            {
+                xReturn = pdFAIL;
+            }
+        }
+
+        xPoolInitialized = pdTRUE;
+    }
+
+    return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t TASKPOOL_Submit( TaskPoolFunction_t pxFunction,
+                            void * pvParameter1,
+                            uint32_t ulParameter2,
+                            TaskPoolLane_t eLane )
+{
+    return prvSubmit( ( UBaseType_t ) taskpoolconfigNUM_WORKERS, pxFunction, pvParameter1, ulParameter2, eLane );
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t TASKPOOL_SubmitToWorker( UBaseType_t uxWorker,
+                                    TaskPoolFunction_t pxFunction,
+                                    void * pvParameter1,
+                                    uint32_t ulParameter2,
+                                    TaskPoolLane_t eLane )
+{
+    configASSERT( uxWorker < ( UBaseType_t ) taskpoolconfigNUM_WORKERS );
+
+    return prvSubmit( uxWorker, pxFunction, pvParameter1, ulParameter2, eLane );
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t TASKPOOL_SubmitFromISR( TaskPoolFunction_t pxFunction,
+                                   void * pvParameter1,
+                                   uint32_t ulParameter2,
+                                   TaskPoolLane_t eLane,
+                                   BaseType_t * pxHigherPriorityTaskWoken )
+{
+    BaseType_t xReturn;
+    TaskPoolJob_t xJob;
+    TaskHandle_t xTaskToNotify = NULL;
+    UBaseType_t uxSavedInterruptStatus;
+
+    configASSERT( xPoolInitialized == pdTRUE );
+    configASSERT( pxFunction != NULL );
+    configASSERT( ( UBaseType_t ) eLane < ( UBaseType_t ) taskpoolNUM_LANES );
+
+    xJob.pxFunction = pxFunction;
+    xJob.pvParameter1 = pvParameter1;
+    xJob.ulParameter2 = ulParameter2;
+    xJob.xPinned = pdFALSE;
+
+    uxSavedInterruptStatus = taskENTER_CRITICAL_FROM_ISR();
+    {
+        xReturn = prvQueueJob( &xJob, ( UBaseType_t ) taskpoolconfigNUM_WORKERS, eLane, &xTaskToNotify );
+    }
+    taskEXIT_CRITICAL_FROM_ISR( uxSavedInterruptStatus );
+
+    if( xTaskToNotify != NULL )
+    {
+        vTaskNotifyGiveIndexedFromISR( xTaskToNotify, taskpoolconfigNOTIFICATION_INDEX, pxHigherPriorityTaskWoken );
+    }
+
+    return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+void TASKPOOL_GetStats( TaskPoolStats_t * pxStats )
+{
+    taskENTER_CRITICAL();
+    {
+        *pxStats = xStats;
+    }
+    taskEXIT_CRITICAL();
+}
+/*-----------------------------------------------------------*/
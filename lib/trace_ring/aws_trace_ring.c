@@ -0,0 +1,284 @@
+/*
+ * Amazon FreeRTOS
+ * Copyright (C) 2018 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+/**
+ * @file aws_trace_ring.c
+ * @brief An implementation of the Trace Ring interface on a statically
+ * allocated array of records.
+ *
+ * A record is claimed and filled in with interrupts masked, which only takes
+ * a few instructions, so the ring can be written from the scheduler and from
+ * interrupts without a lock.
+ */
+
+/* Standard includes. */
+#include <string.h>
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+
+/* Trace ring includes. */
+#include "aws_trace_ring.h"
+#include "aws_trace_ring_config.h"
+#include "aws_trace_ring_config_defaults.h"
+
+#if ( configUSE_TRACE_FACILITY != 1 )
+    #error "The trace ring needs configUSE_TRACE_FACILITY set to 1, to number the tasks."
+#endif
+
+#if ( ( INCLUDE_xTaskGetCurrentTaskHandle != 1 ) && ( configUSE_MUTEXES != 1 ) )
+    #error "The trace ring needs INCLUDE_xTaskGetCurrentTaskHandle set to 1."
+#endif
+
+#if ( ( traceringconfigNUM_RECORDS & ( traceringconfigNUM_RECORDS - 1 ) ) != 0 )
+    #error "traceringconfigNUM_RECORDS must be a power of two."
+#endif
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief The records, written in a circle.
+ */
+static TraceRingRecord_t xRecords[ traceringconfigNUM_RECORDS ];
+
+/**
+ * @brief The index of the record written next.
+ */
+static UBaseType_t uxNextRecord = 0;
+
+/**
+ * @brief Set once every record has been written at least once, after which
+ * uxNextRecord is also the index of the oldest record.
+ */
+static BaseType_t xRingFull = pdFALSE;
+
+/**
+ * @brief Records overwritten or dropped since the ring was last cleared.
+ */
+static uint32_t ulRecordsLost = 0;
+
+/**
+ * @brief Set while TRACERING_Dump() reads the ring.
+ */
+static BaseType_t xRecordingPaused = pdFALSE;
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Starts or stops recording.
+ *
+ * @param[in] xPaused pdTRUE to stop recording, pdFALSE to start again.
+ */
+static void prvSetPaused( BaseType_t xPaused );
+
+/**
+ * @brief Passes the records to a writer, oldest first.
+ *
+ * @param[in] pxWriter The writer.
+ * @param[in] pvContext Passed to pxWriter as it is.
+ *
+ * @return The result of the last call to pxWriter.
+ */
+static BaseType_t prvWriteRecords( TraceRingWriter_t pxWriter,
+                                   void * pvContext );
+/*-----------------------------------------------------------*/
+
+static void prvSetPaused( BaseType_t xPaused )
+{
+    taskENTER_CRITICAL();
+    {
+        xRecordingPaused = xPaused;
+    }
+    taskEXIT_CRITICAL();
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvWriteRecords( TraceRingWriter_t pxWriter,
+                                   void * pvContext )
+{
+    BaseType_t xResult = pdPASS;
+
+    /* Once the ring has wrapped, the oldest records are the ones from the next
+     * record to the end of the array. */
+    if( xRingFull == pdTRUE )
+    {
+        xResult = pxWriter( pvContext,
+                            &xRecords[ uxNextRecord ],
+                            ( traceringconfigNUM_RECORDS - uxNextRecord ) * sizeof( TraceRingRecord_t ) );
+    }
+
+    if( ( xResult == pdPASS ) && ( uxNextRecord > 0 ) )
+    {
+        xResult = pxWriter( pvContext,
+                            &xRecords[ 0 ],
+                            uxNextRecord * sizeof( TraceRingRecord_t ) );
+    }
+
+    return xResult;
+}
+/*-----------------------------------------------------------*/
+
+void TRACERING_Record( uint8_t ucEvent,
+                       void * pvTask,
+                       uint32_t ulArg1,
+                       uint32_t ulArg2 )
+{
+    TraceRingRecord_t * pxRecord;
+    TaskHandle_t xTask = ( TaskHandle_t ) pvTask;
+    UBaseType_t uxSavedInterruptStatus;
+
+    if( xTask == NULL )
+    {
+        xTask = xTaskGetCurrentTaskHandle();
+    }
+
+    uxSavedInterruptStatus = portSET_INTERRUPT_MASK_FROM_ISR();
+    {
+        if( xRecordingPaused == pdFALSE )
+        {
+            if( xRingFull == pdTRUE )
+            {
+                ulRecordsLost++;
+            }
+
+            pxRecord = &xRecords[ uxNextRecord ];
+            uxNextRecord = ( uxNextRecord + 1 ) & ( traceringconfigNUM_RECORDS - 1 );
+
+            if( uxNextRecord == 0 )
+            {
+                xRingFull = pdTRUE;
+            }
+
+            pxRecord->ulTimestamp = traceringconfigGET_TIMESTAMP();
+            pxRecord->usTask = ( uint16_t ) uxTaskGetTaskNumber( xTask );
+            pxRecord->ucEvent = ucEvent;
+            pxRecord->ucReserved = 0;
+            pxRecord->ulArg1 = ulArg1;
+            pxRecord->ulArg2 = ulArg2;
+        }
+        else
+        {
+            ulRecordsLost++;
+        }
+    }
+    portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedInterruptStatus );
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t TRACERING_Dump( TraceRingWriter_t pxWriter,
+                           void * pvContext )
+{
+    BaseType_t xResult = pdPASS;
+    TraceRingHeader_t xHeader;
+    TraceRingTask_t xTaskDescription;
+    TaskStatus_t * pxTaskStatus;
+    UBaseType_t uxTasks, uxIndex;
+    char cName[ configMAX_TASK_NAME_LEN ];
+
+    configASSERT( pxWriter != NULL );
+
+    /* List the tasks before recording stops, so that the allocation is
+     * recorded like any other. */
+    uxTasks = uxTaskGetNumberOfTasks();
+    pxTaskStatus = pvPortMalloc( uxTasks * sizeof( TaskStatus_t ) );
+
+    if( pxTaskStatus == NULL )
+    {
+        xResult = pdFAIL;
+    }
+    else
+    {
+        /* Returns 0 if a task was created since the array was allocated. */
+        uxTasks = uxTaskGetSystemState( pxTaskStatus, uxTasks, NULL );
+
+        if( uxTasks == 0 )
+        {
+            xResult = pdFAIL;
+        }
+    }
+
+    if( xResult == pdPASS )
+    {
+        prvSetPaused( pdTRUE );
+
+        xHeader.ulMagic = traceringMAGIC;
+        xHeader.usVersion = traceringVERSION;
+        xHeader.usRecordSize = ( uint16_t ) sizeof( TraceRingRecord_t );
+        xHeader.ulTimestampHz = ( uint32_t ) traceringconfigTIMESTAMP_HZ;
+        xHeader.ulRecordCount = ( xRingFull == pdTRUE ) ? traceringconfigNUM_RECORDS : ( uint32_t ) uxNextRecord;
+        xHeader.ulRecordsLost = ulRecordsLost;
+        xHeader.usTaskCount = ( uint16_t ) uxTasks;
+        xHeader.usTaskNameLength = ( uint16_t ) configMAX_TASK_NAME_LEN;
+
+        xResult = pxWriter( pvContext, &xHeader, sizeof( xHeader ) );
+
+        for( uxIndex = 0; ( uxIndex < uxTasks ) && ( xResult == pdPASS ); uxIndex++ )
+        {
+            xTaskDescription.ulTaskNumber = ( uint32_t ) pxTaskStatus[ uxIndex ].xTaskNumber;
+            #if ( configUSE_MUTEXES == 1 )
+                xTaskDescription.ulPriority = ( uint32_t ) pxTaskStatus[ uxIndex ].uxBasePriority;
+            #else
+                xTaskDescription.ulPriority = ( uint32_t ) pxTaskStatus[ uxIndex ].uxCurrentPriority;
+            #endif
+
+            /* Pad the name with zeros, rather than writing whatever follows
+             * the terminator in the TCB. */
+            memset( cName, 0x00, sizeof( cName ) );
+            strncpy( cName, pxTaskStatus[ uxIndex ].pcTaskName, sizeof( cName ) - 1 );
+
+            xResult = pxWriter( pvContext, &xTaskDescription, sizeof( xTaskDescription ) );
+
+            if( xResult == pdPASS )
+            {
+                xResult = pxWriter( pvContext, cName, sizeof( cName ) );
+            }
+        }
+
+        if( xResult == pdPASS )
+        {
+            xResult = prvWriteRecords( pxWriter, pvContext );
+        }
+
+        prvSetPaused( pdFALSE );
+    }
+
+    if( pxTaskStatus != NULL )
+    {
+        vPortFree( pxTaskStatus );
+    }
+
+    return xResult;
+}
+/*-----------------------------------------------------------*/
+
+void TRACERING_Clear( void )
+{
+    taskENTER_CRITICAL();
+    {
+        uxNextRecord = 0;
+        xRingFull = pdFALSE;
+        ulRecordsLost = 0;
+    }
+    taskEXIT_CRITICAL();
+}
@@ -586,6 +586,7 @@ TEST( Full_DEFENDER, endpoint_accepts_report_from_agent )
     DefenderMetric_t xMetricsList[] =
     {
         xDefenderTCPConnections,
+        xDefenderListeningTCPPorts,
     };
 
     ( void ) DEFENDER_MetricsInit( xMetricsList );
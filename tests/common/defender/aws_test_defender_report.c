@@ -0,0 +1,118 @@
+/*
+ * Amazon FreeRTOS Device Defender Agent V1.1.2
+ * Copyright (C) 2018 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+/* Tests of the Device Defender report encoder.  Unlike the tests in
+ * aws_test_defender.c, they need neither the agent nor a connection to the
+ * service. */
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+#include "aws_defender_internals.h"
+#include "unity_fixture.h"
+
+/**
+ * @brief The number of reports built by the heap test.
+ */
+#define defenderREPORT_COUNT    10
+
+TEST_GROUP( Full_DEFENDER_REPORT );
+
+TEST_SETUP( Full_DEFENDER_REPORT )
+{
+}
+
+TEST_TEAR_DOWN( Full_DEFENDER_REPORT )
+{
+}
+
+TEST_GROUP_RUNNER( Full_DEFENDER_REPORT )
+{
+    RUN_TEST_CASE( Full_DEFENDER_REPORT, CreateReport_does_not_use_heap );
+    RUN_TEST_CASE( Full_DEFENDER_REPORT, CreateReport_fails_when_buffer_too_small );
+}
+
+/*----------------------------------------------------------------------------*/
+
+TEST( Full_DEFENDER_REPORT, CreateReport_does_not_use_heap )
+{
+    #ifdef configHEAP_ALLOCATION_COUNT
+        DefenderMetric_t xMetricsList[] =
+        {
+            xDefenderTCPConnections,
+            xDefenderListeningTCPPorts,
+        };
+        static uint8_t ucReport[ DEFENDER_REPORT_MAX_SIZE ];
+        size_t xReportSize = 0;
+        CborError eErr = CborNoError;
+        uint32_t ulAllocations;
+
+        ( void ) DEFENDER_MetricsInit( xMetricsList );
+
+        /* Taking the snapshot waits for the IP task, so it can not be done
+         * with the scheduler suspended. */
+        UpdateMetrics();
+
+        /* Keep other tasks from using the heap while the reports are built. */
+        vTaskSuspendAll();
+        {
+            ulAllocations = configHEAP_ALLOCATION_COUNT();
+
+            for( int32_t lI = 0; lI < defenderREPORT_COUNT; lI++ )
+            {
+                eErr |= CreateReport( ucReport, sizeof( ucReport ), &xReportSize );
+            }
+
+            ulAllocations = configHEAP_ALLOCATION_COUNT() - ulAllocations;
+        }
+        ( void ) xTaskResumeAll();
+
+        TEST_ASSERT_EQUAL( CborNoError, eErr );
+        TEST_ASSERT_GREATER_THAN( 0, xReportSize );
+        TEST_ASSERT_EQUAL_UINT32_MESSAGE( 0, ulAllocations,
+                                          "Report creation used the heap" );
+    #else /* ifdef configHEAP_ALLOCATION_COUNT */
+        /* The free heap size does not show an allocation that is freed again,
+         * so without a count of the allocations nothing can be checked. */
+        TEST_IGNORE_MESSAGE( "configHEAP_ALLOCATION_COUNT() is not defined" );
+    #endif /* ifdef configHEAP_ALLOCATION_COUNT */
+}
+
+TEST( Full_DEFENDER_REPORT, CreateReport_fails_when_buffer_too_small )
+{
+    DefenderMetric_t xMetricsList[] =
+    {
+        xDefenderTCPConnections,
+    };
+    uint8_t ucReport[ 8 ];
+    size_t xReportSize = 0;
+
+    ( void ) DEFENDER_MetricsInit( xMetricsList );
+
+    CborError eErr = CreateReport( ucReport, sizeof( ucReport ), &xReportSize );
+
+    TEST_ASSERT_EQUAL( CborErrorOutOfMemory, eErr );
+    TEST_ASSERT_EQUAL( 0, xReportSize );
+}
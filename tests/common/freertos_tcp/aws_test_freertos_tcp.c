@@ -33,7 +33,11 @@
 #include "list.h"
 #include "FreeRTOS_IP.h"
 #include "FreeRTOS_IP_Private.h"
+#include "FreeRTOS_ARP.h"
 #include "FreeRTOS_DNS.h"
+#include "FreeRTOS_DHCP.h"
+#include "FreeRTOS_Sockets.h"
+#include "NetworkBufferManagement.h"
 
 /* Test includes. */
 #include "unity_fixture.h"
@@ -43,6 +47,67 @@
 /**
  * @brief Configuration for this test group.
  */
+#define tcptestTIMER_IDLE_SOCKETS     64
+#define tcptestTIMER_WAKEUPS          200
+#define tcptestTIMER_FIRST_PORT       50200
+#define tcptestCHECKSUM_ITERATIONS    2000
+#define tcptestCHECKSUM_MAX_SIZE      1460
+#define tcptestBUFFER_ITERATIONS      2000
+#define tcptestBUFFER_BATCH           4
+#define tcptestNETWORK_UP_TIMEOUT     pdMS_TO_TICKS( 60000 )
+#define tcptestLOOPBACK_PORT          50400
+#define tcptestLOOPBACK_TIMEOUT       pdMS_TO_TICKS( 5000 )
+#define tcptestLOOPBACK_DATA_SIZE     5000
+#define tcptestZERO_COPY_SEGMENTS     200
+#define tcptestRX_CHAIN_SEGMENTS      4
+#define tcptestRX_CHAIN_LENGTH        100
+#define tcptestRX_CHAIN_RCVBUF        1600
+#define tcptestRX_BURST_FRAMES        16
+#define tcptestRX_BURST_ROUNDS        50
+#define tcptestDNS_TIMEOUT            pdMS_TO_TICKS( 5000 )
+#define tcptestDNS_LOOKUPS            ( ipconfigDNS_RESOLVER_QUERIES + 1 )
+#define tcptestDNS_HEADER_SIZE        12
+#define tcptestDHCP_SERVER_PORT       67
+#define tcptestDHCP_CLIENT_PORT       68
+#define tcptestDHCP_BOOT_REQUEST      1
+#define tcptestDHCP_BOOT_REPLY        2
+#define tcptestDHCP_YIADDR_OFFSET     16
+#define tcptestDHCP_OPTIONS_OFFSET    240
+#define tcptestDHCP_MESSAGE_TYPE      53
+#define tcptestDHCP_DISCOVER          1
+#define tcptestDHCP_OFFER             2
+#define tcptestDHCP_REQUEST           3
+#define tcptestDHCP_ACK               5
+
+/* The zero-copy, linked RX and resolver tests talk to sockets of the stack
+ * itself, which needs a network interface that returns the frames sent to the
+ * own MAC address. */
+#if defined( configLINUX_NETWORK_LOOPBACK )
+    #define tcptestLOOPBACK_ENABLED    1
+#else
+    #define tcptestLOOPBACK_ENABLED    0
+#endif
+
+#if ( ipconfigTCP_ZERO_COPY_TX != 0 ) && ( tcptestLOOPBACK_ENABLED != 0 )
+    #define tcptestZERO_COPY_ENABLED    1
+#else
+    #define tcptestZERO_COPY_ENABLED    0
+#endif
+
+#if ( ipconfigDNS_USE_RESOLVER != 0 ) && ( tcptestLOOPBACK_ENABLED != 0 )
+    #define tcptestRESOLVER_ENABLED    1
+#else
+    #define tcptestRESOLVER_ENABLED    0
+#endif
+
+/* The DHCP test runs a DHCP server on the stack itself, and keeps the runner
+ * from using DHCP at start-up with xApplicationDHCPHook(). */
+#if ( ipconfigUSE_DHCP != 0 ) && ( ipconfigDHCP_USE_LEASE_STORE != 0 ) && \
+    ( ipconfigUSE_DHCP_HOOK != 0 ) && ( tcptestLOOPBACK_ENABLED != 0 )
+    #define tcptestDHCP_ENABLED    1
+#else
+    #define tcptestDHCP_ENABLED    0
+#endif
 
 /*
  * @brief Test group definition.
@@ -53,8 +118,35 @@ TEST_SETUP( Full_FREERTOS_TCP )
 {
 }
 
+#if ( tcptestLOOPBACK_ENABLED != 0 )
+    static void prvLoopbackClose( void );
+#endif
+
+#if ( tcptestRESOLVER_ENABLED != 0 )
+    static void prvDNSServerClose( void );
+#endif
+
+#if ( tcptestDHCP_ENABLED != 0 )
+    static void prvDHCPServerStop( void );
+#endif
+
 TEST_TEAR_DOWN( Full_FREERTOS_TCP )
 {
+    #if ( tcptestLOOPBACK_ENABLED != 0 )
+        /* A failing test may leave its connection open and frames dropped or
+         * held. */
+        vLinuxNetworkDropFrames( 0 );
+        vLinuxNetworkHoldFrames( 0 );
+        prvLoopbackClose();
+    #endif
+
+    #if ( tcptestRESOLVER_ENABLED != 0 )
+        prvDNSServerClose();
+    #endif
+
+    #if ( tcptestDHCP_ENABLED != 0 )
+        prvDHCPServerStop();
+    #endif
 }
 
 TEST_GROUP_RUNNER( Full_FREERTOS_TCP )
@@ -62,14 +154,382 @@ TEST_GROUP_RUNNER( Full_FREERTOS_TCP )
     /* Run a parser test. */
     RUN_TEST_CASE( Full_FREERTOS_TCP, prvParseDnsResponse );
     RUN_TEST_CASE( Full_FREERTOS_TCP, ulDNSHandlePacket );
+    RUN_TEST_CASE( Full_FREERTOS_TCP, DNSCache_stores_reply_addresses );
 
     /* prvCheckOptions test. */
     RUN_TEST_CASE( Full_FREERTOS_TCP, prvCheckOptions );
 
     /* xProcessReceivedUDPPacket test. */
     RUN_TEST_CASE( Full_FREERTOS_TCP, UDPPacketLength );
+
+    /* FreeRTOS_GetTCPConnections test. */
+    RUN_TEST_CASE( Full_FREERTOS_TCP, GetTCPConnections_lists_listening_socket );
+
+    /* xTCPTimerCheck benchmark. */
+    RUN_TEST_CASE( Full_FREERTOS_TCP, TCPTimerCheck_idle_sockets_cost );
+
+    /* FreeRTOS_select ready list test. */
+    RUN_TEST_CASE( Full_FREERTOS_TCP, select_returns_only_ready_sockets );
+
+    /* Checksum tests and benchmark. */
+    RUN_TEST_CASE( Full_FREERTOS_TCP, usChecksumUpdate16_matches_full_checksum );
+    RUN_TEST_CASE( Full_FREERTOS_TCP, usGenerateChecksum_sizes_and_alignments );
+
+    /* Network buffer allocator benchmark. */
+    RUN_TEST_CASE( Full_FREERTOS_TCP, network_buffer_alloc_free_throughput );
+
+    /* Zero-copy transmission over a loopback connection. */
+    #if ( tcptestZERO_COPY_ENABLED != 0 )
+        RUN_TEST_CASE( Full_FREERTOS_TCP, zero_copy_send_mixed_with_normal_send );
+        RUN_TEST_CASE( Full_FREERTOS_TCP, zero_copy_retransmits_from_segment_buffer );
+        RUN_TEST_CASE( Full_FREERTOS_TCP, zero_copy_close_and_abort_with_queued_buffers );
+        #if ( configGENERATE_RUN_TIME_STATS == 1 )
+            RUN_TEST_CASE( Full_FREERTOS_TCP, zero_copy_send_cost );
+        #endif
+    #endif
+
+    /* Chains of received frames, ipconfigUSE_LINKED_RX_MESSAGES. */
+    #if ( tcptestLOOPBACK_ENABLED != 0 )
+        RUN_TEST_CASE( Full_FREERTOS_TCP, TCP_rx_chain_sends_one_ACK_per_socket );
+        #if ( configGENERATE_RUN_TIME_STATS == 1 )
+            RUN_TEST_CASE( Full_FREERTOS_TCP, linked_rx_frames_per_second );
+        #endif
+    #endif
+
+    /* DNS resolver of the IP-task, against a DNS server on the loopback. */
+    #if ( tcptestRESOLVER_ENABLED != 0 )
+        RUN_TEST_CASE( Full_FREERTOS_TCP, DNS_resolver_joins_lookups_of_one_name );
+        RUN_TEST_CASE( Full_FREERTOS_TCP, DNS_resolver_shares_socket_between_names );
+        RUN_TEST_CASE( Full_FREERTOS_TCP, DNS_resolver_gives_up_after_request_attempts );
+        RUN_TEST_CASE( Full_FREERTOS_TCP, DNS_resolver_falls_back_when_slots_are_full );
+        RUN_TEST_CASE( Full_FREERTOS_TCP, DNS_resolver_cancel_races_reply );
+    #endif
+
+    /* DHCP INIT-REBOOT benchmark. */
+    #if ( tcptestDHCP_ENABLED != 0 )
+        RUN_TEST_CASE( Full_FREERTOS_TCP, DHCP_time_to_ip_up_with_stored_lease );
+    #endif
+}
+
+/* A straightforward checksum, summing one 16-bit word at a time, to compare
+ * usGenerateChecksum() with.  Returns the sum in host order, not inverted. */
+static uint16_t prvReferenceChecksum( const uint8_t * pucData,
+                                      size_t uxLength )
+{
+    uint32_t ulSum = 0;
+    size_t uxIndex;
+
+    for( uxIndex = 0; ( uxIndex + 1 ) < uxLength; uxIndex += 2 )
+    {
+        ulSum += ( ( uint32_t ) pucData[ uxIndex ] << 8 ) | pucData[ uxIndex + 1 ];
+    }
+
+    if( ( uxLength & 1 ) != 0 )
+    {
+        ulSum += ( uint32_t ) pucData[ uxLength - 1 ] << 8;
+    }
+
+    while( ( ulSum >> 16 ) != 0 )
+    {
+        ulSum = ( ulSum & 0xffffu ) + ( ulSum >> 16 );
+    }
+
+    return ( uint16_t ) ulSum;
 }
 
+#if ( configGENERATE_RUN_TIME_STATS == 1 )
+
+    /* The loop that usGenerateChecksum() used before ullChecksumSumWords():
+     * four 32-bit additions at a time into a 32-bit sum, counting the carries.
+     * Kept to compare the run time of both.  Returns the sum folded into 16
+     * bits, in the byte order of the words. */
+    static uint16_t prvCarryCountingSumWords( const uint32_t * pulWords,
+                                              size_t uxWordCount )
+    {
+        uint32_t ulSum = 0, ulSum2, ulCarry = 0;
+
+        while( uxWordCount >= 4u )
+        {
+            ulSum2 = ulSum + pulWords[ 0 ];
+
+            if( ulSum2 < ulSum )
+            {
+                ulCarry++;
+            }
+
+            ulSum = ulSum2 + pulWords[ 1 ];
+
+            if( ulSum2 > ulSum )
+            {
+                ulCarry++;
+            }
+
+            ulSum2 = ulSum + pulWords[ 2 ];
+
+            if( ulSum2 < ulSum )
+            {
+                ulCarry++;
+            }
+
+            ulSum = ulSum2 + pulWords[ 3 ];
+
+            if( ulSum2 > ulSum )
+            {
+                ulCarry++;
+            }
+
+            pulWords += 4;
+            uxWordCount -= 4u;
+        }
+
+        while( uxWordCount > 0u )
+        {
+            ulSum2 = ulSum + pulWords[ 0 ];
+
+            if( ulSum2 < ulSum )
+            {
+                ulCarry++;
+            }
+
+            ulSum = ulSum2;
+            pulWords++;
+            uxWordCount--;
+        }
+
+        ulSum = ( ulSum & 0xffffu ) + ( ulSum >> 16 ) + ulCarry;
+
+        while( ( ulSum >> 16 ) != 0 )
+        {
+            ulSum = ( ulSum & 0xffffu ) + ( ulSum >> 16 );
+        }
+
+        return ( uint16_t ) ulSum;
+    }
+
+    /* Fold the sum that ullChecksumSumWords() returns into 16 bits. */
+    static uint16_t prvFoldSum( uint64_t ullSum )
+    {
+        while( ( ullSum >> 16 ) != 0 )
+        {
+            ullSum = ( ullSum & 0xffffu ) + ( ullSum >> 16 );
+        }
+
+        return ( uint16_t ) ullSum;
+    }
+
+    /* Return the run time counter of the task called 'pcTaskName', or 0 if it
+     * can not be found. */
+    static uint32_t prvTaskRunTime( const char * pcTaskName )
+    {
+        TaskStatus_t * pxTaskStatus;
+        UBaseType_t uxCount, uxIndex;
+        uint32_t ulRunTime = 0;
+
+        /* Leave some room for tasks that get created in the mean time. */
+        uxCount = uxTaskGetNumberOfTasks() + 4;
+        pxTaskStatus = pvPortMalloc( uxCount * sizeof( TaskStatus_t ) );
+
+        if( pxTaskStatus != NULL )
+        {
+            uxCount = uxTaskGetSystemState( pxTaskStatus, uxCount, NULL );
+
+            for( uxIndex = 0; uxIndex < uxCount; uxIndex++ )
+            {
+                if( strcmp( pxTaskStatus[ uxIndex ].pcTaskName, pcTaskName ) == 0 )
+                {
+                    ulRunTime = pxTaskStatus[ uxIndex ].ulRunTimeCounter;
+                    break;
+                }
+            }
+
+            vPortFree( pxTaskStatus );
+        }
+
+        return ulRunTime;
+    }
+
+    /* Wake up the IP-task many times, letting it call xTCPTimerCheck() each time,
+     * and return the run time it used. */
+    static uint32_t prvMeasureTCPTimerCheck( void )
+    {
+        uint32_t ulStart;
+        BaseType_t xIndex;
+
+        ulStart = prvTaskRunTime( "IP-task" );
+
+        for( xIndex = 0; xIndex < tcptestTIMER_WAKEUPS; xIndex++ )
+        {
+            ( void ) xSendEventToIPTask( eTCPTimerEvent );
+            vTaskDelay( 1 );
+        }
+
+        return prvTaskRunTime( "IP-task" ) - ulStart;
+    }
+
+#endif /* if ( configGENERATE_RUN_TIME_STATS == 1 ) */
+
+#if ( tcptestLOOPBACK_ENABLED != 0 )
+
+    /* The loopback back-end drops broadcasts, so an ARP request for the own IP
+     * address is never answered.  Enter the address in the cache. */
+    static void prvAddOwnARPEntry( void )
+    {
+        MACAddress_t xOwnMAC;
+
+        memcpy( xOwnMAC.ucBytes, ipLOCAL_MAC_ADDRESS, sizeof( xOwnMAC.ucBytes ) );
+        vARPRefreshCacheEntry( &xOwnMAC, *ipLOCAL_IP_ADDRESS_POINTER );
+    }
+
+    /* The sockets of a connection to the own IP address, and of a second
+     * connection accepted by the same listener. */
+    static Socket_t xLoopbackListener = FREERTOS_INVALID_SOCKET;
+    static Socket_t xLoopbackClient = FREERTOS_INVALID_SOCKET;
+    static Socket_t xLoopbackServer = FREERTOS_INVALID_SOCKET;
+    static Socket_t xLoopbackSecondClient = FREERTOS_INVALID_SOCKET;
+    static Socket_t xLoopbackSecondServer = FREERTOS_INVALID_SOCKET;
+
+    static uint8_t ucLoopbackData[ tcptestLOOPBACK_DATA_SIZE ];
+    static uint8_t ucLoopbackReceived[ tcptestLOOPBACK_DATA_SIZE ];
+
+    /* Connect a new client socket to xLoopbackListener, which listens on
+     * 'usPort', and accept the connection. */
+    static void prvLoopbackAccept( uint16_t usPort,
+                                   Socket_t * pxClient,
+                                   Socket_t * pxServer )
+    {
+        struct freertos_sockaddr xAddress;
+        TickType_t xTimeout = tcptestLOOPBACK_TIMEOUT;
+
+        memset( &xAddress, 0, sizeof( xAddress ) );
+        xAddress.sin_port = FreeRTOS_htons( usPort );
+        xAddress.sin_addr = FreeRTOS_GetIPAddress();
+
+        *pxClient = FreeRTOS_socket( FREERTOS_AF_INET, FREERTOS_SOCK_STREAM, FREERTOS_IPPROTO_TCP );
+        TEST_ASSERT_NOT_EQUAL( FREERTOS_INVALID_SOCKET, *pxClient );
+        ( void ) FreeRTOS_setsockopt( *pxClient, 0, FREERTOS_SO_RCVTIMEO, &xTimeout, sizeof( xTimeout ) );
+        ( void ) FreeRTOS_setsockopt( *pxClient, 0, FREERTOS_SO_SNDTIMEO, &xTimeout, sizeof( xTimeout ) );
+
+        TEST_ASSERT_EQUAL( 0, FreeRTOS_connect( *pxClient, &xAddress, sizeof( xAddress ) ) );
+
+        *pxServer = FreeRTOS_accept( xLoopbackListener, NULL, NULL );
+
+        if( *pxServer == NULL )
+        {
+            *pxServer = FREERTOS_INVALID_SOCKET;
+        }
+
+        TEST_ASSERT_NOT_EQUAL( FREERTOS_INVALID_SOCKET, *pxServer );
+        ( void ) FreeRTOS_setsockopt( *pxServer, 0, FREERTOS_SO_RCVTIMEO, &xTimeout, sizeof( xTimeout ) );
+    }
+
+    /* Connect xLoopbackClient to xLoopbackServer, through the own IP address,
+     * and fill ucLoopbackData with a pattern. */
+    static void prvLoopbackConnect( uint16_t usPort )
+    {
+        struct freertos_sockaddr xAddress;
+        TickType_t xTimeout = tcptestLOOPBACK_TIMEOUT;
+        size_t uxIndex;
+
+        for( uxIndex = 0; uxIndex < sizeof( ucLoopbackData ); uxIndex++ )
+        {
+            ucLoopbackData[ uxIndex ] = ( uint8_t ) ( ( uxIndex * 7 ) + ( uxIndex >> 8 ) + 1 );
+        }
+
+        prvAddOwnARPEntry();
+
+        memset( &xAddress, 0, sizeof( xAddress ) );
+        xAddress.sin_port = FreeRTOS_htons( usPort );
+
+        xLoopbackListener = FreeRTOS_socket( FREERTOS_AF_INET, FREERTOS_SOCK_STREAM, FREERTOS_IPPROTO_TCP );
+        TEST_ASSERT_NOT_EQUAL( FREERTOS_INVALID_SOCKET, xLoopbackListener );
+        ( void ) FreeRTOS_setsockopt( xLoopbackListener, 0, FREERTOS_SO_RCVTIMEO, &xTimeout, sizeof( xTimeout ) );
+        TEST_ASSERT_EQUAL( 0, FreeRTOS_bind( xLoopbackListener, &xAddress, sizeof( xAddress ) ) );
+        TEST_ASSERT_EQUAL( 0, FreeRTOS_listen( xLoopbackListener, 2 ) );
+
+        prvLoopbackAccept( usPort, &xLoopbackClient, &xLoopbackServer );
+    }
+
+    static void prvLoopbackClose( void )
+    {
+        Socket_t * const pxSockets[] =
+        {
+            &xLoopbackClient, &xLoopbackServer, &xLoopbackSecondClient, &xLoopbackSecondServer, &xLoopbackListener
+        };
+        BaseType_t xIndex, xClosed = pdFALSE;
+
+        for( xIndex = 0; xIndex < ( BaseType_t ) ( sizeof( pxSockets ) / sizeof( pxSockets[ 0 ] ) ); xIndex++ )
+        {
+            if( *pxSockets[ xIndex ] != FREERTOS_INVALID_SOCKET )
+            {
+                ( void ) FreeRTOS_closesocket( *pxSockets[ xIndex ] );
+                *pxSockets[ xIndex ] = FREERTOS_INVALID_SOCKET;
+                xClosed = pdTRUE;
+            }
+        }
+
+        if( xClosed != pdFALSE )
+        {
+            /* Let the IP-task free the sockets and their buffers. */
+            vTaskDelay( pdMS_TO_TICKS( 100 ) );
+        }
+    }
+
+    /* Receive 'uxLength' bytes on xLoopbackServer into ucLoopbackReceived. */
+    static size_t prvLoopbackReceive( size_t uxLength )
+    {
+        size_t uxReceived = 0;
+        BaseType_t xResult;
+
+        while( uxReceived < uxLength )
+        {
+            xResult = FreeRTOS_recv( xLoopbackServer, &ucLoopbackReceived[ uxReceived ], uxLength - uxReceived, 0 );
+
+            if( xResult <= 0 )
+            {
+                break;
+            }
+
+            uxReceived += ( size_t ) xResult;
+        }
+
+        return uxReceived;
+    }
+
+#endif /* if ( tcptestLOOPBACK_ENABLED != 0 ) */
+
+#if ( tcptestZERO_COPY_ENABLED != 0 )
+
+    /* Send 'uxLength' bytes on xLoopbackClient, from a buffer obtained with
+     * FreeRTOS_GetTCPPayloadBuffer(), which the producer fills in place. */
+    static void prvZeroCopySend( const uint8_t * pucData,
+                                 size_t uxLength )
+    {
+        void * pvBuffer;
+        size_t uxMaxLength;
+
+        pvBuffer = FreeRTOS_GetTCPPayloadBuffer( xLoopbackClient, &uxMaxLength, tcptestLOOPBACK_TIMEOUT );
+        TEST_ASSERT_NOT_NULL( pvBuffer );
+        TEST_ASSERT_TRUE( uxLength <= uxMaxLength );
+
+        memcpy( pvBuffer, pucData, uxLength );
+        TEST_ASSERT_EQUAL( ( BaseType_t ) uxLength, FreeRTOS_send( xLoopbackClient, pvBuffer, uxLength, FREERTOS_ZERO_COPY ) );
+    }
+
+    /* Return the maximum length of a zero-copy send on xLoopbackClient. */
+    static size_t prvZeroCopyMaxLength( void )
+    {
+        void * pvBuffer;
+        size_t uxMaxLength = 0;
+
+        pvBuffer = FreeRTOS_GetTCPPayloadBuffer( xLoopbackClient, &uxMaxLength, tcptestLOOPBACK_TIMEOUT );
+        TEST_ASSERT_NOT_NULL( pvBuffer );
+        FreeRTOS_ReleaseTCPPayloadBuffer( pvBuffer );
+
+        return uxMaxLength;
+    }
+
+#endif /* if ( tcptestZERO_COPY_ENABLED != 0 ) */
+
 TEST( Full_FREERTOS_TCP, prvParseDnsResponse )
 {
     uint8_t ucGoodDnsResponse[] =
@@ -302,6 +762,60 @@ TEST( Full_FREERTOS_TCP, ulDNSHandlePacket )
     TEST_ASSERT_EQUAL_UINT32( 0, ulResult );
 }
 
+TEST( Full_FREERTOS_TCP, DNSCache_stores_reply_addresses )
+{
+    #if ( ipconfigUSE_DNS_CACHE == 1 )
+        /* A reply for "peer.example" with two A records, 192.168.0.10 and
+         * 192.168.0.11, both with a TTL of 60 seconds. */
+        uint8_t ucDnsResponse[] =
+        {
+            0x12, 0x34, 0x81, 0x80, 0x00, 0x01, 0x00, 0x02, 0x00, 0x00, 0x00, 0x00, 0x04, 0x70, 0x65, 0x65,
+            0x72, 0x07, 0x65, 0x78, 0x61, 0x6d, 0x70, 0x6c, 0x65, 0x00, 0x00, 0x01, 0x00, 0x01, 0xc0, 0x0c,
+            0x00, 0x01, 0x00, 0x01, 0x00, 0x00, 0x00, 0x3c, 0x00, 0x04, 0xc0, 0xa8, 0x00, 0x0a, 0xc0, 0x0c,
+            0x00, 0x01, 0x00, 0x01, 0x00, 0x00, 0x00, 0x3c, 0x00, 0x04, 0xc0, 0xa8, 0x00, 0x0b
+        };
+        const uint32_t ulFirstAddress = FreeRTOS_inet_addr_quick( 192, 168, 0, 10 );
+        const uint32_t ulSecondAddress = FreeRTOS_inet_addr_quick( 192, 168, 0, 11 );
+        uint32_t ulAddress;
+
+        #if ( ipconfigCACHE_STATS != 0 )
+            IPCacheStats_t xBefore, xAfter;
+
+            FreeRTOS_GetDNSCacheStats( &xBefore );
+        #endif
+
+        ulAddress = TEST_FreeRTOS_TCP_prvParseDNSReply( ucDnsResponse,
+                                                        sizeof( ucDnsResponse ),
+                                                        *( uint16_t * ) ucDnsResponse );
+        TEST_ASSERT_EQUAL_UINT32( ulFirstAddress, ulAddress );
+
+        ulAddress = FreeRTOS_dnslookup( "peer.example" );
+        TEST_ASSERT_TRUE( ( ulAddress == ulFirstAddress ) || ( ulAddress == ulSecondAddress ) );
+
+        #if ( ipconfigDNS_CACHE_ADDRESSES_PER_ENTRY > 1 )
+            /* The addresses are handed out in turn. */
+            TEST_ASSERT_NOT_EQUAL( ulAddress, FreeRTOS_dnslookup( "peer.example" ) );
+        #endif
+
+        TEST_ASSERT_EQUAL_UINT32( 0, FreeRTOS_dnslookup( "other.example" ) );
+
+        #if ( ipconfigCACHE_STATS != 0 )
+            FreeRTOS_GetDNSCacheStats( &xAfter );
+            TEST_ASSERT_TRUE( ( xAfter.ulLookups - xBefore.ulLookups ) >= 3 );
+
+            /* Only the first A record is stored when an entry holds a single
+             * address, so only the look-up of "peer.example" hits. */
+            #if ( ipconfigDNS_CACHE_ADDRESSES_PER_ENTRY > 1 )
+                TEST_ASSERT_TRUE( ( xAfter.ulHits - xBefore.ulHits ) >= 2 );
+            #else
+                TEST_ASSERT_TRUE( ( xAfter.ulHits - xBefore.ulHits ) >= 1 );
+            #endif
+        #endif
+    #else /* if ( ipconfigUSE_DNS_CACHE == 1 ) */
+        TEST_IGNORE_MESSAGE( "ipconfigUSE_DNS_CACHE is required" );
+    #endif /* if ( ipconfigUSE_DNS_CACHE == 1 ) */
+}
+
 TEST( Full_FREERTOS_TCP, prvCheckOptions )
 {
     uint8_t ucDivideByZero[] =
@@ -359,4 +873,1415 @@ TEST( Full_FREERTOS_TCP, UDPPacketLength )
     xNetworkBuffer.xDataLength = sizeof( ucBadUdpPacketB );
     xReturn = xProcessReceivedUDPPacket( &xNetworkBuffer, usPort );
     TEST_ASSERT_EQUAL_UINT32( pdFAIL, xReturn );
-}
\ No newline at end of file
+}
+
+TEST( Full_FREERTOS_TCP, GetTCPConnections_lists_listening_socket )
+{
+    const uint16_t usPort = 50123;
+    TCPConnectionInfo_t xTable[ 16 ];
+    struct freertos_sockaddr xBindAddress;
+    Socket_t xSocket;
+    BaseType_t xCount, xIndex, xFound = pdFALSE;
+
+    xSocket = FreeRTOS_socket( FREERTOS_AF_INET, FREERTOS_SOCK_STREAM, FREERTOS_IPPROTO_TCP );
+    TEST_ASSERT_NOT_EQUAL( FREERTOS_INVALID_SOCKET, xSocket );
+
+    xBindAddress.sin_port = FreeRTOS_htons( usPort );
+    TEST_ASSERT_EQUAL( 0, FreeRTOS_bind( xSocket, &xBindAddress, sizeof( xBindAddress ) ) );
+    TEST_ASSERT_EQUAL( 0, FreeRTOS_listen( xSocket, 1 ) );
+
+    xCount = FreeRTOS_GetTCPConnections( xTable, 16, pdMS_TO_TICKS( 1000 ) );
+    TEST_ASSERT_GREATER_THAN( 0, xCount );
+
+    for( xIndex = 0; ( xIndex < xCount ) && ( xIndex < 16 ); xIndex++ )
+    {
+        if( ( xTable[ xIndex ].usLocalPort == usPort ) &&
+            ( xTable[ xIndex ].ucTCPState == ( uint8_t ) eTCP_LISTEN ) )
+        {
+            xFound = pdTRUE;
+        }
+    }
+
+    #if ( ipconfigTCP_CONNECTION_STATS != 0 )
+        {
+            TCPConnectionStats_t xStats;
+
+            /* Nothing has been sent or received on the listening socket. */
+            TEST_ASSERT_EQUAL( 0, FreeRTOS_GetTCPStats( xSocket, &xStats ) );
+            TEST_ASSERT_EQUAL_UINT32( 0, xStats.ulSegmentsIn );
+            TEST_ASSERT_EQUAL_UINT32( 0, xStats.ulSegmentsOut );
+        }
+    #endif
+
+    ( void ) FreeRTOS_closesocket( xSocket );
+
+    TEST_ASSERT_TRUE_MESSAGE( xFound, "Listening socket missing from snapshot" );
+}
+
+TEST( Full_FREERTOS_TCP, TCPTimerCheck_idle_sockets_cost )
+{
+    #if ( configGENERATE_RUN_TIME_STATS == 1 )
+        Socket_t xSockets[ tcptestTIMER_IDLE_SOCKETS ];
+        struct freertos_sockaddr xBindAddress;
+        FreeRTOS_Socket_t * pxSocket;
+        uint32_t ulOneSocket = 0, ulManySockets;
+        BaseType_t xIndex, xCreated = 0;
+
+        for( xIndex = 0; xIndex < tcptestTIMER_IDLE_SOCKETS; xIndex++ )
+        {
+            xSockets[ xIndex ] = FreeRTOS_socket( FREERTOS_AF_INET, FREERTOS_SOCK_STREAM, FREERTOS_IPPROTO_TCP );
+
+            if( xSockets[ xIndex ] == FREERTOS_INVALID_SOCKET )
+            {
+                break;
+            }
+
+            xCreated++;
+            xBindAddress.sin_port = FreeRTOS_htons( ( uint16_t ) ( tcptestTIMER_FIRST_PORT + xIndex ) );
+
+            if( ( FreeRTOS_bind( xSockets[ xIndex ], &xBindAddress, sizeof( xBindAddress ) ) != 0 ) ||
+                ( FreeRTOS_listen( xSockets[ xIndex ], 1 ) != 0 ) )
+            {
+                break;
+            }
+
+            if( xIndex == 0 )
+            {
+                ulOneSocket = prvMeasureTCPTimerCheck();
+            }
+        }
+
+        if( xCreated == tcptestTIMER_IDLE_SOCKETS )
+        {
+            ulManySockets = prvMeasureTCPTimerCheck();
+
+            configPRINTF( ( "xTCPTimerCheck: IP-task run time for %d wake-ups: %u with 1 socket, %u with %d idle sockets\r\n",
+                            tcptestTIMER_WAKEUPS,
+                            ( unsigned ) ulOneSocket,
+                            ( unsigned ) ulManySockets,
+                            tcptestTIMER_IDLE_SOCKETS ) );
+        }
+
+        for( xIndex = 0; xIndex < xCreated; xIndex++ )
+        {
+            /* A listening socket has no timer, so the IP-task never visits it. */
+            pxSocket = ( FreeRTOS_Socket_t * ) xSockets[ xIndex ];
+            TEST_ASSERT_NULL( listLIST_ITEM_CONTAINER( &( pxSocket->u.xTCP.xTimerListItem ) ) );
+        }
+
+        for( xIndex = 0; xIndex < xCreated; xIndex++ )
+        {
+            ( void ) FreeRTOS_closesocket( xSockets[ xIndex ] );
+        }
+
+        TEST_ASSERT_EQUAL_MESSAGE( tcptestTIMER_IDLE_SOCKETS, xCreated, "Could not create all idle sockets" );
+    #else /* if ( configGENERATE_RUN_TIME_STATS == 1 ) */
+        TEST_IGNORE_MESSAGE( "configGENERATE_RUN_TIME_STATS is required" );
+    #endif /* if ( configGENERATE_RUN_TIME_STATS == 1 ) */
+}
+
+TEST( Full_FREERTOS_TCP, select_returns_only_ready_sockets )
+{
+    #if ( ipconfigSUPPORT_SELECT_FUNCTION == 1 )
+        SocketSet_t xSocketSet;
+        Socket_t xWriteSocket, xReadSocket;
+        Socket_t xReady[ 2 ];
+        struct freertos_sockaddr xBindAddress;
+        BaseType_t xResult;
+
+        xSocketSet = FreeRTOS_CreateSocketSet();
+        TEST_ASSERT_NOT_NULL( xSocketSet );
+
+        xWriteSocket = FreeRTOS_socket( FREERTOS_AF_INET, FREERTOS_SOCK_STREAM, FREERTOS_IPPROTO_TCP );
+        TEST_ASSERT_NOT_EQUAL( FREERTOS_INVALID_SOCKET, xWriteSocket );
+        xReadSocket = FreeRTOS_socket( FREERTOS_AF_INET, FREERTOS_SOCK_STREAM, FREERTOS_IPPROTO_TCP );
+        TEST_ASSERT_NOT_EQUAL( FREERTOS_INVALID_SOCKET, xReadSocket );
+
+        xBindAddress.sin_port = FreeRTOS_htons( 50301 );
+        TEST_ASSERT_EQUAL( 0, FreeRTOS_bind( xWriteSocket, &xBindAddress, sizeof( xBindAddress ) ) );
+        xBindAddress.sin_port = FreeRTOS_htons( 50302 );
+        TEST_ASSERT_EQUAL( 0, FreeRTOS_bind( xReadSocket, &xBindAddress, sizeof( xBindAddress ) ) );
+
+        /* A socket with space in its transmit stream is writable, a socket
+         * without data is not readable. */
+        FreeRTOS_FD_SET( xWriteSocket, xSocketSet, eSELECT_WRITE );
+        FreeRTOS_FD_SET( xReadSocket, xSocketSet, eSELECT_READ );
+
+        xResult = FreeRTOS_select( xSocketSet, 0 );
+        TEST_ASSERT_NOT_EQUAL( 0, xResult & eSELECT_WRITE );
+        TEST_ASSERT_EQUAL( 1, FreeRTOS_GetReadySockets( xSocketSet, xReady, 2 ) );
+        TEST_ASSERT_EQUAL_PTR( xWriteSocket, xReady[ 0 ] );
+        TEST_ASSERT_EQUAL( 0, FreeRTOS_FD_ISSET( xReadSocket, xSocketSet ) );
+
+        /* Once removed from the set, the socket is not reported anymore. */
+        FreeRTOS_FD_CLR( xWriteSocket, xSocketSet, eSELECT_WRITE );
+        ( void ) FreeRTOS_select( xSocketSet, 0 );
+        TEST_ASSERT_EQUAL( 0, FreeRTOS_GetReadySockets( xSocketSet, xReady, 2 ) );
+
+        ( void ) FreeRTOS_closesocket( xWriteSocket );
+        ( void ) FreeRTOS_closesocket( xReadSocket );
+
+        /* Give the IP-task time to close the sockets before the set is gone. */
+        vTaskDelay( pdMS_TO_TICKS( 100 ) );
+        FreeRTOS_DeleteSocketSet( xSocketSet );
+    #else /* if ( ipconfigSUPPORT_SELECT_FUNCTION == 1 ) */
+        TEST_IGNORE_MESSAGE( "ipconfigSUPPORT_SELECT_FUNCTION is required" );
+    #endif /* if ( ipconfigSUPPORT_SELECT_FUNCTION == 1 ) */
+}
+
+TEST( Full_FREERTOS_TCP, usChecksumUpdate16_matches_full_checksum )
+{
+    uint8_t ucHeader[ 20 ];
+    uint16_t usChecksum, usOld, usNew, usExpected;
+    uint32_t ulOld, ulNew;
+    BaseType_t xIndex;
+
+    for( xIndex = 0; xIndex < ( BaseType_t ) sizeof( ucHeader ); xIndex++ )
+    {
+        ucHeader[ xIndex ] = ( uint8_t ) ( 0x5Au + ( xIndex * 37 ) );
+    }
+
+    /* The checksum as it would be stored in the packet. */
+    usChecksum = FreeRTOS_htons( ( uint16_t ) ~usGenerateChecksum( 0UL, ucHeader, sizeof( ucHeader ) ) );
+
+    /* Change a 16-bit field, e.g. the window size. */
+    memcpy( &usOld, &ucHeader[ 14 ], sizeof( usOld ) );
+    usNew = FreeRTOS_htons( 0x1234u );
+    memcpy( &ucHeader[ 14 ], &usNew, sizeof( usNew ) );
+    usChecksum = usChecksumUpdate16( usChecksum, usOld, usNew );
+    usExpected = FreeRTOS_htons( ( uint16_t ) ~usGenerateChecksum( 0UL, ucHeader, sizeof( ucHeader ) ) );
+    TEST_ASSERT_EQUAL_HEX16( usExpected, usChecksum );
+
+    /* Change a 32-bit field, e.g. the acknowledgement number. */
+    memcpy( &ulOld, &ucHeader[ 8 ], sizeof( ulOld ) );
+    ulNew = FreeRTOS_htonl( 0xFFFF0001uL );
+    memcpy( &ucHeader[ 8 ], &ulNew, sizeof( ulNew ) );
+    usChecksum = usChecksumUpdate32( usChecksum, ulOld, ulNew );
+    usExpected = FreeRTOS_htons( ( uint16_t ) ~usGenerateChecksum( 0UL, ucHeader, sizeof( ucHeader ) ) );
+    TEST_ASSERT_EQUAL_HEX16( usExpected, usChecksum );
+}
+
+TEST( Full_FREERTOS_TCP, usGenerateChecksum_sizes_and_alignments )
+{
+    static uint32_t ulBuffer[ ( tcptestCHECKSUM_MAX_SIZE / sizeof( uint32_t ) ) + 1 ];
+    uint8_t * const ucBuffer = ( uint8_t * ) ulBuffer;
+    const size_t uxSizes[] = { 20, 64, 576, tcptestCHECKSUM_MAX_SIZE };
+    size_t uxSizeIndex, uxAlign, uxIndex;
+
+    #if ( configGENERATE_RUN_TIME_STATS == 1 )
+        volatile uint16_t usResult = 0;
+        uint32_t ulStart, ulElapsed, ulBulk, ulPrevious;
+        size_t uxWordCount;
+        BaseType_t xIteration;
+    #endif
+
+    for( uxIndex = 0; uxIndex < sizeof( ulBuffer ); uxIndex++ )
+    {
+        ucBuffer[ uxIndex ] = ( uint8_t ) ( ( uxIndex * 131 ) ^ ( uxIndex >> 3 ) );
+    }
+
+    for( uxSizeIndex = 0; uxSizeIndex < ( sizeof( uxSizes ) / sizeof( uxSizes[ 0 ] ) ); uxSizeIndex++ )
+    {
+        for( uxAlign = 0; uxAlign < sizeof( uint32_t ); uxAlign++ )
+        {
+            /* Also check an odd length, which leaves a single byte. */
+            TEST_ASSERT_EQUAL_HEX16( prvReferenceChecksum( &ucBuffer[ uxAlign ], uxSizes[ uxSizeIndex ] ),
+                                     usGenerateChecksum( 0UL, &ucBuffer[ uxAlign ], uxSizes[ uxSizeIndex ] ) );
+            TEST_ASSERT_EQUAL_HEX16( prvReferenceChecksum( &ucBuffer[ uxAlign ], uxSizes[ uxSizeIndex ] - 1 ),
+                                     usGenerateChecksum( 0UL, &ucBuffer[ uxAlign ], uxSizes[ uxSizeIndex ] - 1 ) );
+
+            #if ( configGENERATE_RUN_TIME_STATS == 1 )
+                ulStart = ( uint32_t ) portGET_RUN_TIME_COUNTER_VALUE();
+
+                for( xIteration = 0; xIteration < tcptestCHECKSUM_ITERATIONS; xIteration++ )
+                {
+                    usResult += usGenerateChecksum( 0UL, &ucBuffer[ uxAlign ], uxSizes[ uxSizeIndex ] );
+                }
+
+                ulElapsed = ( uint32_t ) portGET_RUN_TIME_COUNTER_VALUE() - ulStart;
+
+                configPRINTF( ( "usGenerateChecksum: %u bytes, alignment %u: run time %u for %d iterations\r\n",
+                                ( unsigned ) uxSizes[ uxSizeIndex ],
+                                ( unsigned ) uxAlign,
+                                ( unsigned ) ulElapsed,
+                                tcptestCHECKSUM_ITERATIONS ) );
+            #endif /* if ( configGENERATE_RUN_TIME_STATS == 1 ) */
+        }
+
+        #if ( configGENERATE_RUN_TIME_STATS == 1 )
+        {
+            /* Compare the word loop with the previous one, on the same words. */
+            uxWordCount = uxSizes[ uxSizeIndex ] / sizeof( uint32_t );
+            TEST_ASSERT_EQUAL_HEX16( prvCarryCountingSumWords( ulBuffer, uxWordCount ),
+                                     prvFoldSum( ullChecksumSumWords( 0ull, ulBuffer, uxWordCount ) ) );
+
+            ulStart = ( uint32_t ) portGET_RUN_TIME_COUNTER_VALUE();
+
+            for( xIteration = 0; xIteration < tcptestCHECKSUM_ITERATIONS; xIteration++ )
+            {
+                usResult += ( uint16_t ) ullChecksumSumWords( 0ull, ulBuffer, uxWordCount );
+            }
+
+            ulBulk = ( uint32_t ) portGET_RUN_TIME_COUNTER_VALUE() - ulStart;
+            ulStart = ( uint32_t ) portGET_RUN_TIME_COUNTER_VALUE();
+
+            for( xIteration = 0; xIteration < tcptestCHECKSUM_ITERATIONS; xIteration++ )
+            {
+                usResult += prvCarryCountingSumWords( ulBuffer, uxWordCount );
+            }
+
+            ulPrevious = ( uint32_t ) portGET_RUN_TIME_COUNTER_VALUE() - ulStart;
+
+            configPRINTF( ( "Checksum word loop: %u bytes: run time %u against %u for the carry-counting loop, %d iterations\r\n",
+                            ( unsigned ) ( uxWordCount * sizeof( uint32_t ) ),
+                            ( unsigned ) ulBulk,
+                            ( unsigned ) ulPrevious,
+                            tcptestCHECKSUM_ITERATIONS ) );
+        }
+        #endif /* if ( configGENERATE_RUN_TIME_STATS == 1 ) */
+    }
+
+    #if ( configGENERATE_RUN_TIME_STATS == 1 )
+        ( void ) usResult;
+    #endif
+}
+
+TEST( Full_FREERTOS_TCP, network_buffer_alloc_free_throughput )
+{
+    const size_t uxSizes[] = { 64, 576, ipTOTAL_ETHERNET_FRAME_SIZE };
+    NetworkBufferDescriptor_t * pxBuffer;
+    UBaseType_t uxFreeBefore;
+    size_t uxSizeIndex;
+    BaseType_t xIteration;
+
+    #if ( configGENERATE_RUN_TIME_STATS == 1 )
+        uint32_t ulStart, ulElapsed;
+    #endif
+
+    #if ( ipconfigBUFFER_ALLOCATION_SLABS != 0 )
+        NetworkBufferDescriptor_t * pxBuffers[ tcptestBUFFER_BATCH ];
+        UBaseType_t uxCount;
+    #endif
+
+    uxFreeBefore = uxGetNumberOfFreeNetworkBuffers();
+
+    for( uxSizeIndex = 0; uxSizeIndex < ( sizeof( uxSizes ) / sizeof( uxSizes[ 0 ] ) ); uxSizeIndex++ )
+    {
+        #if ( configGENERATE_RUN_TIME_STATS == 1 )
+            ulStart = ( uint32_t ) portGET_RUN_TIME_COUNTER_VALUE();
+        #endif
+
+        for( xIteration = 0; xIteration < tcptestBUFFER_ITERATIONS; xIteration++ )
+        {
+            pxBuffer = pxGetNetworkBufferWithDescriptor( uxSizes[ uxSizeIndex ], 0 );
+            TEST_ASSERT_NOT_NULL( pxBuffer );
+            vReleaseNetworkBufferAndDescriptor( pxBuffer );
+        }
+
+        #if ( configGENERATE_RUN_TIME_STATS == 1 )
+            ulElapsed = ( uint32_t ) portGET_RUN_TIME_COUNTER_VALUE() - ulStart;
+
+            configPRINTF( ( "Network buffers, %s: %u bytes: run time %u for %d get/release pairs\r\n",
+                            ( ipconfigBUFFER_ALLOCATION_SLABS != 0 ) ? "slabs" : "heap",
+                            ( unsigned ) uxSizes[ uxSizeIndex ],
+                            ( unsigned ) ulElapsed,
+                            tcptestBUFFER_ITERATIONS ) );
+        #endif
+    }
+
+    #if ( ipconfigBUFFER_ALLOCATION_SLABS != 0 )
+        #if ( configGENERATE_RUN_TIME_STATS == 1 )
+            ulStart = ( uint32_t ) portGET_RUN_TIME_COUNTER_VALUE();
+        #endif
+
+        for( xIteration = 0; xIteration < tcptestBUFFER_ITERATIONS; xIteration++ )
+        {
+            uxCount = uxGetNetworkBuffersWithDescriptor( pxBuffers, tcptestBUFFER_BATCH, ipTOTAL_ETHERNET_FRAME_SIZE );
+            TEST_ASSERT_EQUAL( tcptestBUFFER_BATCH, uxCount );
+            vReleaseNetworkBuffersAndDescriptors( pxBuffers, uxCount );
+        }
+
+        #if ( configGENERATE_RUN_TIME_STATS == 1 )
+            ulElapsed = ( uint32_t ) portGET_RUN_TIME_COUNTER_VALUE() - ulStart;
+
+            configPRINTF( ( "Network buffers, slabs: run time %u for %d batches of %d\r\n",
+                            ( unsigned ) ulElapsed,
+                            tcptestBUFFER_ITERATIONS,
+                            tcptestBUFFER_BATCH ) );
+        #endif
+    #endif /* if ( ipconfigBUFFER_ALLOCATION_SLABS != 0 ) */
+
+    /* Other tasks may hold buffers for a while, but none may be lost here. */
+    TEST_ASSERT_TRUE( uxGetNumberOfFreeNetworkBuffers() >= uxFreeBefore - tcptestBUFFER_BATCH );
+}
+
+#if ( ipconfigUSE_DHCP != 0 ) && ( ipconfigDHCP_USE_LEASE_STORE != 0 )
+
+    /* The lease store of the test application.  The lease is always stored,
+     * but only handed out when xLeaseStoreEnabled is set. */
+    static DHCPLease_t xStoredLease;
+    static BaseType_t xLeaseStored = pdFALSE;
+    static BaseType_t xLeaseStoreEnabled = pdFALSE;
+
+    /* Set while the test DHCP server runs on the stack itself. */
+    static volatile BaseType_t xDHCPServerRunning = pdFALSE;
+
+    void vApplicationDHCPStoreLease( const DHCPLease_t * pxLease )
+    {
+        if( pxLease != NULL )
+        {
+            xStoredLease = *pxLease;
+            xLeaseStored = pdTRUE;
+        }
+        else
+        {
+            xLeaseStored = pdFALSE;
+        }
+    }
+
+    BaseType_t xApplicationDHCPLoadLease( DHCPLease_t * pxLease )
+    {
+        BaseType_t xReturn = pdFALSE;
+
+        if( ( xLeaseStoreEnabled != pdFALSE ) && ( xLeaseStored != pdFALSE ) )
+        {
+            *pxLease = xStoredLease;
+            xReturn = pdTRUE;
+        }
+
+        return xReturn;
+    }
+
+    #if ( ipconfigUSE_DHCP_HOOK != 0 )
+
+        /* No DHCP server can be reached when the runner starts, so it boots
+         * with the static address.  DHCP only runs against the server of the
+         * test. */
+        eDHCPCallbackAnswer_t xApplicationDHCPHook( eDHCPCallbackPhase_t eDHCPPhase,
+                                                    uint32_t ulIPAddress )
+        {
+            ( void ) eDHCPPhase;
+            ( void ) ulIPAddress;
+
+            return ( xDHCPServerRunning != pdFALSE ) ? eDHCPContinue : eDHCPUseDefaults;
+        }
+
+    #endif /* if ( ipconfigUSE_DHCP_HOOK != 0 ) */
+
+    #if ( configGENERATE_RUN_TIME_STATS == 1 )
+        #define tcptestDHCP_CLOCK()    ( ( uint32_t ) portGET_RUN_TIME_COUNTER_VALUE() )
+        #define tcptestDHCP_UNIT       "us"
+    #else
+        #define tcptestDHCP_CLOCK()    ( ( uint32_t ) xTaskGetTickCount() )
+        #define tcptestDHCP_UNIT       "ticks"
+    #endif
+
+    /* Take the network down and return the time until it is up again, or
+     * UINT32_MAX if that did not happen in time. */
+    static uint32_t prvTimeToNetworkUp( void )
+    {
+        TickType_t xStart;
+        uint32_t ulStart, ulTime = UINT32_MAX;
+
+        ulStart = tcptestDHCP_CLOCK();
+        xStart = xTaskGetTickCount();
+
+        FreeRTOS_NetworkDown();
+
+        /* Wait until the IP-task has processed the network-down event. */
+        while( ( FreeRTOS_IsNetworkUp() != pdFALSE ) &&
+               ( ( xTaskGetTickCount() - xStart ) < tcptestNETWORK_UP_TIMEOUT ) )
+        {
+            taskYIELD();
+        }
+
+        while( ( xTaskGetTickCount() - xStart ) < tcptestNETWORK_UP_TIMEOUT )
+        {
+            if( FreeRTOS_IsNetworkUp() != pdFALSE )
+            {
+                ulTime = tcptestDHCP_CLOCK() - ulStart;
+                break;
+            }
+
+            taskYIELD();
+        }
+
+        return ulTime;
+    }
+
+    #if ( ipconfigUSE_DHCP_HOOK != 0 ) && ( tcptestLOOPBACK_ENABLED != 0 )
+
+        /* A minimal DHCP server on the stack itself, which the loopback
+         * back-end reaches when it returns broadcasts.  It offers the address
+         * that the stack already has, so the other tests are not disturbed. */
+        static Socket_t xDHCPServer = FREERTOS_INVALID_SOCKET;
+        static TaskHandle_t xDHCPServerWaiter;
+        static uint32_t ulDHCPOfferedAddress;
+        static uint32_t ulDHCPNetMask;
+        static uint32_t ulDHCPGateway;
+        static uint32_t ulDHCPDNSServer;
+        static volatile uint32_t ulDHCPDiscovers;
+        static volatile uint32_t ulDHCPRequests;
+
+        static void prvDHCPServerTask( void * pvParameters )
+        {
+            uint8_t ucMessage[ 576 ];
+            struct freertos_sockaddr xAddress;
+            uint32_t ulAddressLength = sizeof( xAddress );
+            int32_t lLength;
+            size_t uxIndex;
+            uint8_t ucType;
+
+            ( void ) pvParameters;
+
+            while( xDHCPServerRunning != pdFALSE )
+            {
+                lLength = FreeRTOS_recvfrom( xDHCPServer, ucMessage, sizeof( ucMessage ), 0, &xAddress, &ulAddressLength );
+
+                if( ( lLength < ( int32_t ) ( tcptestDHCP_OPTIONS_OFFSET + 3 ) ) || ( ucMessage[ 0 ] != tcptestDHCP_BOOT_REQUEST ) )
+                {
+                    continue;
+                }
+
+                /* The clients of this stack send the message type first. */
+                if( ucMessage[ tcptestDHCP_OPTIONS_OFFSET ] != tcptestDHCP_MESSAGE_TYPE )
+                {
+                    continue;
+                }
+
+                ucType = ucMessage[ tcptestDHCP_OPTIONS_OFFSET + 2 ];
+
+                if( ucType == tcptestDHCP_DISCOVER )
+                {
+                    ulDHCPDiscovers++;
+                    ucType = tcptestDHCP_OFFER;
+                }
+                else if( ucType == tcptestDHCP_REQUEST )
+                {
+                    ulDHCPRequests++;
+                    ucType = tcptestDHCP_ACK;
+                }
+                else
+                {
+                    continue;
+                }
+
+                /* Reply with the header of the request, as a boot reply that
+                 * hands out the address. */
+                ucMessage[ 0 ] = tcptestDHCP_BOOT_REPLY;
+                memcpy( &( ucMessage[ tcptestDHCP_YIADDR_OFFSET ] ), &ulDHCPOfferedAddress, sizeof( uint32_t ) );
+
+                uxIndex = tcptestDHCP_OPTIONS_OFFSET;
+                ucMessage[ uxIndex++ ] = tcptestDHCP_MESSAGE_TYPE;
+                ucMessage[ uxIndex++ ] = 1;
+                ucMessage[ uxIndex++ ] = ucType;
+
+                /* Server identifier, subnet mask, router and DNS server. */
+                ucMessage[ uxIndex++ ] = 54;
+                ucMessage[ uxIndex++ ] = 4;
+                memcpy( &( ucMessage[ uxIndex ] ), &ulDHCPGateway, sizeof( uint32_t ) );
+                uxIndex += sizeof( uint32_t );
+                ucMessage[ uxIndex++ ] = 1;
+                ucMessage[ uxIndex++ ] = 4;
+                memcpy( &( ucMessage[ uxIndex ] ), &ulDHCPNetMask, sizeof( uint32_t ) );
+                uxIndex += sizeof( uint32_t );
+                ucMessage[ uxIndex++ ] = 3;
+                ucMessage[ uxIndex++ ] = 4;
+                memcpy( &( ucMessage[ uxIndex ] ), &ulDHCPGateway, sizeof( uint32_t ) );
+                uxIndex += sizeof( uint32_t );
+                ucMessage[ uxIndex++ ] = 6;
+                ucMessage[ uxIndex++ ] = 4;
+                memcpy( &( ucMessage[ uxIndex ] ), &ulDHCPDNSServer, sizeof( uint32_t ) );
+                uxIndex += sizeof( uint32_t );
+
+                /* A lease of an hour, no renewal happens while the tests run. */
+                ucMessage[ uxIndex++ ] = 51;
+                ucMessage[ uxIndex++ ] = 4;
+                ucMessage[ uxIndex++ ] = 0x00;
+                ucMessage[ uxIndex++ ] = 0x00;
+                ucMessage[ uxIndex++ ] = 0x0e;
+                ucMessage[ uxIndex++ ] = 0x10;
+                ucMessage[ uxIndex++ ] = 0xff;
+
+                xAddress.sin_addr = ipBROADCAST_IP_ADDRESS;
+                xAddress.sin_port = FreeRTOS_htons( tcptestDHCP_CLIENT_PORT );
+                ( void ) FreeRTOS_sendto( xDHCPServer, ucMessage, uxIndex, 0, &xAddress, sizeof( xAddress ) );
+            }
+
+            ( void ) FreeRTOS_closesocket( xDHCPServer );
+            xDHCPServer = FREERTOS_INVALID_SOCKET;
+            xTaskNotifyGive( xDHCPServerWaiter );
+            vTaskDelete( NULL );
+        }
+
+        static void prvDHCPServerStart( void )
+        {
+            struct freertos_sockaddr xAddress;
+            TickType_t xTimeout = pdMS_TO_TICKS( 50 );
+
+            FreeRTOS_GetAddressConfiguration( &ulDHCPOfferedAddress, &ulDHCPNetMask, &ulDHCPGateway, &ulDHCPDNSServer );
+            ulDHCPDiscovers = 0;
+            ulDHCPRequests = 0;
+
+            xDHCPServer = FreeRTOS_socket( FREERTOS_AF_INET, FREERTOS_SOCK_DGRAM, FREERTOS_IPPROTO_UDP );
+            TEST_ASSERT_NOT_EQUAL( FREERTOS_INVALID_SOCKET, xDHCPServer );
+            ( void ) FreeRTOS_setsockopt( xDHCPServer, 0, FREERTOS_SO_RCVTIMEO, &xTimeout, sizeof( xTimeout ) );
+
+            memset( &xAddress, 0, sizeof( xAddress ) );
+            xAddress.sin_port = FreeRTOS_htons( tcptestDHCP_SERVER_PORT );
+            TEST_ASSERT_EQUAL( 0, FreeRTOS_bind( xDHCPServer, &xAddress, sizeof( xAddress ) ) );
+
+            xDHCPServerWaiter = xTaskGetCurrentTaskHandle();
+            xDHCPServerRunning = pdTRUE;
+            vLinuxNetworkLoopBroadcasts( 1 );
+            TEST_ASSERT_EQUAL( pdPASS, xTaskCreate( prvDHCPServerTask, "DHCPd", configMINIMAL_STACK_SIZE * 4, NULL,
+                                                    uxTaskPriorityGet( NULL ) + 1, NULL ) );
+        }
+
+        static void prvDHCPServerStop( void )
+        {
+            if( xDHCPServerRunning != pdFALSE )
+            {
+                xDHCPServerRunning = pdFALSE;
+                ( void ) ulTaskNotifyTake( pdTRUE, pdMS_TO_TICKS( 1000 ) );
+                vLinuxNetworkLoopBroadcasts( 0 );
+            }
+        }
+
+        TEST( Full_FREERTOS_TCP, DHCP_time_to_ip_up_with_stored_lease )
+        {
+            uint32_t ulWithout, ulWith;
+            uint32_t ulFirstAddress;
+
+            prvDHCPServerStart();
+
+            /* The full discover/offer/request/ack exchange. */
+            xLeaseStoreEnabled = pdFALSE;
+            ulWithout = prvTimeToNetworkUp();
+            TEST_ASSERT_NOT_EQUAL( UINT32_MAX, ulWithout );
+            TEST_ASSERT_TRUE( xLeaseStored );
+            TEST_ASSERT_EQUAL_UINT32( 1, ulDHCPDiscovers );
+            TEST_ASSERT_EQUAL_UINT32( 1, ulDHCPRequests );
+            ulFirstAddress = FreeRTOS_GetIPAddress();
+            TEST_ASSERT_EQUAL_UINT32( ulDHCPOfferedAddress, ulFirstAddress );
+
+            /* Only request the stored address. */
+            xLeaseStoreEnabled = pdTRUE;
+            ulWith = prvTimeToNetworkUp();
+            xLeaseStoreEnabled = pdFALSE;
+            TEST_ASSERT_NOT_EQUAL( UINT32_MAX, ulWith );
+            TEST_ASSERT_EQUAL_UINT32( 1, ulDHCPDiscovers );
+            TEST_ASSERT_EQUAL_UINT32( 2, ulDHCPRequests );
+            TEST_ASSERT_EQUAL_UINT32( ulFirstAddress, FreeRTOS_GetIPAddress() );
+
+            prvDHCPServerStop();
+
+            configPRINTF( ( "DHCP: %u %s to IP-up without a stored lease, %u %s with\r\n",
+                            ( unsigned ) ulWithout, tcptestDHCP_UNIT,
+                            ( unsigned ) ulWith, tcptestDHCP_UNIT ) );
+        }
+
+    #endif /* if ( ipconfigUSE_DHCP_HOOK != 0 ) && ( tcptestLOOPBACK_ENABLED != 0 ) */
+
+#endif /* if ( ipconfigUSE_DHCP != 0 ) && ( ipconfigDHCP_USE_LEASE_STORE != 0 ) */
+
+#if ( tcptestZERO_COPY_ENABLED != 0 )
+
+    TEST( Full_FREERTOS_TCP, zero_copy_send_mixed_with_normal_send )
+    {
+        const size_t uxPlan[] = { 100, 0, 3000, 1, 7, 500 };
+        const BaseType_t xZeroCopy[] = { pdFALSE, pdTRUE, pdFALSE, pdTRUE, pdFALSE, pdTRUE };
+        TCPConnectionStats_t xStats;
+        UBaseType_t uxFreeBefore;
+        size_t uxIndex, uxLength, uxOffset = 0;
+
+        uxFreeBefore = uxGetNumberOfFreeNetworkBuffers();
+        prvLoopbackConnect( tcptestLOOPBACK_PORT );
+
+        for( uxIndex = 0; uxIndex < ( sizeof( uxPlan ) / sizeof( uxPlan[ 0 ] ) ); uxIndex++ )
+        {
+            /* A length of 0 stands for a full segment. */
+            uxLength = ( uxPlan[ uxIndex ] != 0 ) ? uxPlan[ uxIndex ] : prvZeroCopyMaxLength();
+            TEST_ASSERT_TRUE( uxOffset + uxLength <= sizeof( ucLoopbackData ) );
+
+            if( xZeroCopy[ uxIndex ] != pdFALSE )
+            {
+                prvZeroCopySend( &ucLoopbackData[ uxOffset ], uxLength );
+            }
+            else
+            {
+                TEST_ASSERT_EQUAL( ( BaseType_t ) uxLength, FreeRTOS_send( xLoopbackClient, &ucLoopbackData[ uxOffset ], uxLength, 0 ) );
+            }
+
+            uxOffset += uxLength;
+        }
+
+        /* The stream arrives in the order it was sent, whichever way each
+         * part was handed to the socket. */
+        TEST_ASSERT_EQUAL( uxOffset, prvLoopbackReceive( uxOffset ) );
+        TEST_ASSERT_EQUAL_MEMORY( ucLoopbackData, ucLoopbackReceived, uxOffset );
+
+        TEST_ASSERT_EQUAL( 0, FreeRTOS_GetTCPStats( xLoopbackClient, &xStats ) );
+        TEST_ASSERT_EQUAL_UINT32( 0, xStats.ulRetransmits );
+
+        prvLoopbackClose();
+        TEST_ASSERT_TRUE( uxGetNumberOfFreeNetworkBuffers() >= uxFreeBefore );
+    }
+
+    TEST( Full_FREERTOS_TCP, zero_copy_retransmits_from_segment_buffer )
+    {
+        TCPConnectionStats_t xStats;
+        UBaseType_t uxFreeBefore;
+        size_t uxLength;
+
+        uxFreeBefore = uxGetNumberOfFreeNetworkBuffers();
+        prvLoopbackConnect( tcptestLOOPBACK_PORT + 1 );
+        uxLength = prvZeroCopyMaxLength();
+
+        /* Let the hand-shake settle before the first data segment is lost. */
+        vTaskDelay( pdMS_TO_TICKS( 50 ) );
+        vLinuxNetworkDropFrames( 1 );
+        prvZeroCopySend( ucLoopbackData, uxLength );
+
+        /* The bytes of a zero-copy send are never written to the stream
+         * buffer, so they can only arrive when the retransmission was sent
+         * from the buffer that the segment holds. */
+        TEST_ASSERT_EQUAL( uxLength, prvLoopbackReceive( uxLength ) );
+        TEST_ASSERT_EQUAL_MEMORY( ucLoopbackData, ucLoopbackReceived, uxLength );
+
+        TEST_ASSERT_EQUAL( 0, FreeRTOS_GetTCPStats( xLoopbackClient, &xStats ) );
+        TEST_ASSERT_TRUE( xStats.ulRetransmits >= 1u );
+
+        prvLoopbackClose();
+        TEST_ASSERT_TRUE( uxGetNumberOfFreeNetworkBuffers() >= uxFreeBefore );
+    }
+
+    TEST( Full_FREERTOS_TCP, zero_copy_close_and_abort_with_queued_buffers )
+    {
+        UBaseType_t uxFreeBefore;
+        size_t uxLength;
+        void * pvBuffer;
+        BaseType_t xRound, xIndex;
+
+        uxFreeBefore = uxGetNumberOfFreeNetworkBuffers();
+
+        /* Round 0 shuts the connection down before closing it, round 1 closes
+         * it right away. */
+        for( xRound = 0; xRound < 2; xRound++ )
+        {
+            prvLoopbackConnect( tcptestLOOPBACK_PORT + 2 + ( uint16_t ) xRound );
+            uxLength = prvZeroCopyMaxLength();
+            vTaskDelay( pdMS_TO_TICKS( 50 ) );
+
+            /* Nothing is acknowledged, the segments keep their buffers. */
+            vLinuxNetworkDropFrames( 1000 );
+
+            for( xIndex = 0; xIndex < 3; xIndex++ )
+            {
+                prvZeroCopySend( ucLoopbackData, uxLength );
+            }
+
+            /* A buffer that the producer never sends. */
+            pvBuffer = FreeRTOS_GetTCPPayloadBuffer( xLoopbackClient, &uxLength, tcptestLOOPBACK_TIMEOUT );
+            TEST_ASSERT_NOT_NULL( pvBuffer );
+            FreeRTOS_ReleaseTCPPayloadBuffer( pvBuffer );
+
+            if( xRound == 0 )
+            {
+                ( void ) FreeRTOS_shutdown( xLoopbackClient, FREERTOS_SHUT_RDWR );
+            }
+
+            prvLoopbackClose();
+            vLinuxNetworkDropFrames( 0 );
+        }
+
+        TEST_ASSERT_TRUE( uxGetNumberOfFreeNetworkBuffers() >= uxFreeBefore );
+    }
+
+    #if ( configGENERATE_RUN_TIME_STATS == 1 )
+
+        static size_t uxLoopbackExpected;
+        static TaskHandle_t xLoopbackWaiter;
+
+        /* Receive uxLoopbackExpected bytes on xLoopbackServer and notify the
+         * waiting task. */
+        static void prvLoopbackReceiveTask( void * pvParameters )
+        {
+            size_t uxReceived = 0;
+            BaseType_t xResult;
+
+            ( void ) pvParameters;
+
+            while( uxReceived < uxLoopbackExpected )
+            {
+                xResult = FreeRTOS_recv( xLoopbackServer, ucLoopbackReceived, sizeof( ucLoopbackReceived ), 0 );
+
+                if( xResult <= 0 )
+                {
+                    break;
+                }
+
+                uxReceived += ( size_t ) xResult;
+            }
+
+            xTaskNotifyGive( xLoopbackWaiter );
+            vTaskDelete( NULL );
+        }
+
+        TEST( Full_FREERTOS_TCP, zero_copy_send_cost )
+        {
+            TaskStatus_t xStatus;
+            uint32_t ulElapsed[ 2 ], ulIPTask[ 2 ], ulSender[ 2 ];
+            uint32_t ulStart, ulIPStart, ulSenderStart;
+            size_t uxLength;
+            BaseType_t xZeroCopy, xIndex;
+
+            xLoopbackWaiter = xTaskGetCurrentTaskHandle();
+
+            for( xZeroCopy = pdFALSE; xZeroCopy <= pdTRUE; xZeroCopy++ )
+            {
+                prvLoopbackConnect( tcptestLOOPBACK_PORT + 4 + ( uint16_t ) xZeroCopy );
+                uxLength = prvZeroCopyMaxLength();
+                uxLoopbackExpected = uxLength * tcptestZERO_COPY_SEGMENTS;
+
+                TEST_ASSERT_EQUAL( pdPASS, xTaskCreate( prvLoopbackReceiveTask, "Loopback", configMINIMAL_STACK_SIZE * 4, NULL,
+                                                        uxTaskPriorityGet( NULL ), NULL ) );
+
+                vTaskGetInfo( NULL, &xStatus, pdFALSE, eInvalid );
+                ulSenderStart = xStatus.ulRunTimeCounter;
+                ulIPStart = prvTaskRunTime( "IP-task" );
+                ulStart = ( uint32_t ) portGET_RUN_TIME_COUNTER_VALUE();
+
+                for( xIndex = 0; xIndex < tcptestZERO_COPY_SEGMENTS; xIndex++ )
+                {
+                    if( xZeroCopy != pdFALSE )
+                    {
+                        prvZeroCopySend( ucLoopbackData, uxLength );
+                    }
+                    else
+                    {
+                        TEST_ASSERT_EQUAL( ( BaseType_t ) uxLength, FreeRTOS_send( xLoopbackClient, ucLoopbackData, uxLength, 0 ) );
+                    }
+                }
+
+                TEST_ASSERT_NOT_EQUAL( 0, ulTaskNotifyTake( pdTRUE, tcptestLOOPBACK_TIMEOUT ) );
+
+                ulElapsed[ xZeroCopy ] = ( uint32_t ) portGET_RUN_TIME_COUNTER_VALUE() - ulStart;
+                ulIPTask[ xZeroCopy ] = prvTaskRunTime( "IP-task" ) - ulIPStart;
+                vTaskGetInfo( NULL, &xStatus, pdFALSE, eInvalid );
+                ulSender[ xZeroCopy ] = xStatus.ulRunTimeCounter - ulSenderStart;
+
+                prvLoopbackClose();
+            }
+
+            configPRINTF( ( "TCP send of %d segments, copied against zero-copy: elapsed %u against %u, "
+                            "IP-task %u against %u, sender %u against %u\r\n",
+                            tcptestZERO_COPY_SEGMENTS,
+                            ( unsigned ) ulElapsed[ 0 ], ( unsigned ) ulElapsed[ 1 ],
+                            ( unsigned ) ulIPTask[ 0 ], ( unsigned ) ulIPTask[ 1 ],
+                            ( unsigned ) ulSender[ 0 ], ( unsigned ) ulSender[ 1 ] ) );
+        }
+
+    #endif /* if ( configGENERATE_RUN_TIME_STATS == 1 ) */
+
+#endif /* if ( tcptestZERO_COPY_ENABLED != 0 ) */
+
+#if ( tcptestLOOPBACK_ENABLED != 0 )
+
+    /* Give xServer a receive buffer of less than two MSS, so that every data
+     * segment it receives must be acknowledged at once, and let the ACK of a
+     * first byte advertise the small window. */
+    static void prvRxChainPrepare( Socket_t xClient,
+                                   Socket_t xServer )
+    {
+        uint32_t ulBufferSize = tcptestRX_CHAIN_RCVBUF;
+        uint8_t ucByte;
+
+        TEST_ASSERT_EQUAL( 0, FreeRTOS_setsockopt( xServer, 0, FREERTOS_SO_RCVBUF, &ulBufferSize, sizeof( ulBufferSize ) ) );
+        TEST_ASSERT_EQUAL( 1, FreeRTOS_send( xClient, ucLoopbackData, 1, 0 ) );
+        TEST_ASSERT_EQUAL( 1, FreeRTOS_recv( xServer, &ucByte, 1, 0 ) );
+
+        /* The first byte gets a delayed ACK. */
+        vTaskDelay( pdMS_TO_TICKS( 50 ) );
+    }
+
+    TEST( Full_FREERTOS_TCP, TCP_rx_chain_sends_one_ACK_per_socket )
+    {
+        Socket_t xClients[ 2 ], xServers[ 2 ];
+        TCPConnectionStats_t xBefore[ 2 ], xAfter[ 2 ];
+        uint32_t ulExpectedACKs;
+        uint8_t ucBuffer[ tcptestRX_CHAIN_SEGMENTS * tcptestRX_CHAIN_LENGTH ];
+        BaseType_t xIndex, xSegment, xResult;
+        size_t uxReceived;
+
+        prvLoopbackConnect( tcptestLOOPBACK_PORT + 8 );
+        prvLoopbackAccept( tcptestLOOPBACK_PORT + 8, &xLoopbackSecondClient, &xLoopbackSecondServer );
+
+        xClients[ 0 ] = xLoopbackClient;
+        xServers[ 0 ] = xLoopbackServer;
+        xClients[ 1 ] = xLoopbackSecondClient;
+        xServers[ 1 ] = xLoopbackSecondServer;
+
+        for( xIndex = 0; xIndex < 2; xIndex++ )
+        {
+            prvRxChainPrepare( xClients[ xIndex ], xServers[ xIndex ] );
+            TEST_ASSERT_EQUAL( 0, FreeRTOS_GetTCPStats( xServers[ xIndex ], &xBefore[ xIndex ] ) );
+        }
+
+        /* Send the segments of both connections, interleaved, while the
+         * network interface holds them back.  Once released, they reach the
+         * IP-task together. */
+        vLinuxNetworkHoldFrames( 1 );
+
+        for( xSegment = 0; xSegment < tcptestRX_CHAIN_SEGMENTS; xSegment++ )
+        {
+            for( xIndex = 0; xIndex < 2; xIndex++ )
+            {
+                TEST_ASSERT_EQUAL( tcptestRX_CHAIN_LENGTH, FreeRTOS_send( xClients[ xIndex ], ucLoopbackData, tcptestRX_CHAIN_LENGTH, 0 ) );
+                vTaskDelay( 1 );
+            }
+        }
+
+        vTaskDelay( pdMS_TO_TICKS( 20 ) );
+        vLinuxNetworkHoldFrames( 0 );
+        vTaskDelay( pdMS_TO_TICKS( 50 ) );
+
+        /* Without a chain, every segment is acknowledged on its own. */
+        #if ( ipconfigUSE_LINKED_RX_MESSAGES != 0 )
+            ulExpectedACKs = 1;
+        #else
+            ulExpectedACKs = tcptestRX_CHAIN_SEGMENTS;
+        #endif
+
+        for( xIndex = 0; xIndex < 2; xIndex++ )
+        {
+            /* Take the counters before reading, which may send a window
+             * update. */
+            TEST_ASSERT_EQUAL( 0, FreeRTOS_GetTCPStats( xServers[ xIndex ], &xAfter[ xIndex ] ) );
+            TEST_ASSERT_EQUAL( tcptestRX_CHAIN_SEGMENTS, xAfter[ xIndex ].ulSegmentsIn - xBefore[ xIndex ].ulSegmentsIn );
+            TEST_ASSERT_EQUAL( ulExpectedACKs, xAfter[ xIndex ].ulSegmentsOut - xBefore[ xIndex ].ulSegmentsOut );
+        }
+
+        for( xIndex = 0; xIndex < 2; xIndex++ )
+        {
+            for( uxReceived = 0; uxReceived < sizeof( ucBuffer ); uxReceived += ( size_t ) xResult )
+            {
+                xResult = FreeRTOS_recv( xServers[ xIndex ], &ucBuffer[ uxReceived ], sizeof( ucBuffer ) - uxReceived, 0 );
+                TEST_ASSERT_TRUE( xResult > 0 );
+            }
+        }
+
+        prvLoopbackClose();
+    }
+
+    #if ( configGENERATE_RUN_TIME_STATS == 1 )
+
+        /* Pass bursts of UDP frames to the stack at once, and report how many
+         * frames per second of run time the IP-task and the network interface
+         * task handle together.  Build the runner with LINKED_RX=0 and with
+         * LINKED_RX=1 to compare single messages with chains. */
+        TEST( Full_FREERTOS_TCP, linked_rx_frames_per_second )
+        {
+            Socket_t xSocket;
+            struct freertos_sockaddr xAddress;
+            TickType_t xTimeout = tcptestLOOPBACK_TIMEOUT;
+            uint8_t ucPayload[ 64 ];
+            uint32_t ulIPStart, ulMACStart, ulIPTask = 0, ulMACTask = 0, ulRunTime;
+            BaseType_t xRound, xFrame;
+
+            prvAddOwnARPEntry();
+            memset( ucPayload, 0x5a, sizeof( ucPayload ) );
+
+            memset( &xAddress, 0, sizeof( xAddress ) );
+            xAddress.sin_port = FreeRTOS_htons( tcptestLOOPBACK_PORT + 9 );
+
+            xSocket = FreeRTOS_socket( FREERTOS_AF_INET, FREERTOS_SOCK_DGRAM, FREERTOS_IPPROTO_UDP );
+            TEST_ASSERT_NOT_EQUAL( FREERTOS_INVALID_SOCKET, xSocket );
+            ( void ) FreeRTOS_setsockopt( xSocket, 0, FREERTOS_SO_RCVTIMEO, &xTimeout, sizeof( xTimeout ) );
+            TEST_ASSERT_EQUAL( 0, FreeRTOS_bind( xSocket, &xAddress, sizeof( xAddress ) ) );
+
+            xAddress.sin_addr = FreeRTOS_GetIPAddress();
+
+            for( xRound = 0; xRound < tcptestRX_BURST_ROUNDS; xRound++ )
+            {
+                /* Queue a burst of frames in the network interface. */
+                vLinuxNetworkHoldFrames( 1 );
+
+                for( xFrame = 0; xFrame < tcptestRX_BURST_FRAMES; xFrame++ )
+                {
+                    if( FreeRTOS_sendto( xSocket, ucPayload, sizeof( ucPayload ), 0, &xAddress, sizeof( xAddress ) ) != ( int32_t ) sizeof( ucPayload ) )
+                    {
+                        break;
+                    }
+                }
+
+                vTaskDelay( pdMS_TO_TICKS( 5 ) );
+
+                ulIPStart = prvTaskRunTime( "IP-task" );
+                ulMACStart = prvTaskRunTime( "MAC_ISR" );
+                vLinuxNetworkHoldFrames( 0 );
+
+                for( xFrame = 0; xFrame < tcptestRX_BURST_FRAMES; xFrame++ )
+                {
+                    if( FreeRTOS_recvfrom( xSocket, ucPayload, sizeof( ucPayload ), 0, NULL, NULL ) != ( int32_t ) sizeof( ucPayload ) )
+                    {
+                        break;
+                    }
+                }
+
+                ulIPTask += prvTaskRunTime( "IP-task" ) - ulIPStart;
+                ulMACTask += prvTaskRunTime( "MAC_ISR" ) - ulMACStart;
+
+                if( xFrame < tcptestRX_BURST_FRAMES )
+                {
+                    break;
+                }
+            }
+
+            ( void ) FreeRTOS_closesocket( xSocket );
+            TEST_ASSERT_EQUAL( tcptestRX_BURST_ROUNDS, xRound );
+
+            ulRunTime = ulIPTask + ulMACTask;
+            configPRINTF( ( "Linked RX %s: %d frames in bursts of %d: IP-task %u, MAC_ISR %u, %u frames/sec of run time\r\n",
+                            ( ipconfigUSE_LINKED_RX_MESSAGES != 0 ) ? "on" : "off",
+                            tcptestRX_BURST_ROUNDS * tcptestRX_BURST_FRAMES,
+                            tcptestRX_BURST_FRAMES,
+                            ( unsigned ) ulIPTask,
+                            ( unsigned ) ulMACTask,
+                            ( unsigned ) ( ( ulRunTime != 0 ) ?
+                                           ( ( ( uint64_t ) tcptestRX_BURST_ROUNDS * tcptestRX_BURST_FRAMES * 1000000u ) / ulRunTime ) : 0 ) ) );
+        }
+
+    #endif /* if ( configGENERATE_RUN_TIME_STATS == 1 ) */
+
+#endif /* if ( tcptestLOOPBACK_ENABLED != 0 ) */
+
+#if ( tcptestRESOLVER_ENABLED != 0 )
+
+    /* A task that calls FreeRTOS_gethostbyname(). */
+    typedef struct xDNS_LOOKUP
+    {
+        const char * pcName;
+        volatile uint32_t ulIPAddress;
+        volatile BaseType_t xNotificationKept; /* A notification on the default index survived the look-up. */
+        volatile BaseType_t xDone;
+    } DNSLookup_t;
+
+    /* A DNS query as seen by the test server. */
+    typedef struct xDNS_SEEN_QUERY
+    {
+        uint16_t usIdentifier; /* In the byte order of the message. */
+        uint16_t usPort;       /* The source port, in network byte order. */
+        char pcName[ ipconfigDNS_CACHE_NAME_LENGTH ];
+    } DNSSeenQuery_t;
+
+    /* A DNS server on the own IP address, which the stack uses while a
+     * resolver test runs. */
+    static Socket_t xDNSServer = FREERTOS_INVALID_SOCKET;
+    static uint32_t ulSavedDNSServer;
+
+    /* Static, as the tasks may still be running when a test fails. */
+    static DNSLookup_t xDNSLookups[ tcptestDNS_LOOKUPS ];
+
+    static void prvDNSServerOpen( void )
+    {
+        struct freertos_sockaddr xAddress;
+        uint32_t ulIPAddress;
+
+        prvAddOwnARPEntry();
+
+        xDNSServer = FreeRTOS_socket( FREERTOS_AF_INET, FREERTOS_SOCK_DGRAM, FREERTOS_IPPROTO_UDP );
+        TEST_ASSERT_NOT_EQUAL( FREERTOS_INVALID_SOCKET, xDNSServer );
+
+        memset( &xAddress, 0, sizeof( xAddress ) );
+        xAddress.sin_port = FreeRTOS_htons( ipDNS_PORT );
+        TEST_ASSERT_EQUAL( 0, FreeRTOS_bind( xDNSServer, &xAddress, sizeof( xAddress ) ) );
+
+        FreeRTOS_GetAddressConfiguration( &ulIPAddress, NULL, NULL, &ulSavedDNSServer );
+        FreeRTOS_SetAddressConfiguration( NULL, NULL, NULL, &ulIPAddress );
+    }
+
+    static void prvDNSServerClose( void )
+    {
+        if( xDNSServer != FREERTOS_INVALID_SOCKET )
+        {
+            FreeRTOS_SetAddressConfiguration( NULL, NULL, NULL, &ulSavedDNSServer );
+            ( void ) FreeRTOS_closesocket( xDNSServer );
+            xDNSServer = FREERTOS_INVALID_SOCKET;
+        }
+    }
+
+    /* Wait up to 'xTimeout' for a query, returns pdFALSE if none arrived. */
+    static BaseType_t prvDNSServerReceive( DNSSeenQuery_t * pxQuery,
+                                           TickType_t xTimeout )
+    {
+        uint8_t ucMessage[ 256 ];
+        struct freertos_sockaddr xAddress;
+        uint32_t ulAddressLength = sizeof( xAddress );
+        int32_t lLength;
+        size_t uxIndex = tcptestDNS_HEADER_SIZE, uxOut = 0;
+        uint8_t ucLabel;
+
+        ( void ) FreeRTOS_setsockopt( xDNSServer, 0, FREERTOS_SO_RCVTIMEO, &xTimeout, sizeof( xTimeout ) );
+        lLength = FreeRTOS_recvfrom( xDNSServer, ucMessage, sizeof( ucMessage ), 0, &xAddress, &ulAddressLength );
+
+        if( lLength < tcptestDNS_HEADER_SIZE )
+        {
+            return pdFALSE;
+        }
+
+        memcpy( &( pxQuery->usIdentifier ), ucMessage, sizeof( pxQuery->usIdentifier ) );
+        pxQuery->usPort = xAddress.sin_port;
+
+        /* Turn the labels of the question back into a dotted name. */
+        while( ( uxIndex < ( size_t ) lLength ) && ( ucMessage[ uxIndex ] != 0u ) )
+        {
+            ucLabel = ucMessage[ uxIndex++ ];
+            TEST_ASSERT_TRUE( uxIndex + ucLabel < ( size_t ) lLength );
+            TEST_ASSERT_TRUE( uxOut + ucLabel + 1u < sizeof( pxQuery->pcName ) );
+
+            if( uxOut != 0u )
+            {
+                pxQuery->pcName[ uxOut++ ] = '.';
+            }
+
+            memcpy( &( pxQuery->pcName[ uxOut ] ), &( ucMessage[ uxIndex ] ), ucLabel );
+            uxOut += ucLabel;
+            uxIndex += ucLabel;
+        }
+
+        pxQuery->pcName[ uxOut ] = '\0';
+
+        return pdTRUE;
+    }
+
+    /* Answer a query with a single A record. */
+    static void prvDNSServerReply( const DNSSeenQuery_t * pxQuery,
+                                   uint32_t ulIPAddress )
+    {
+        static const uint8_t ucHeader[] = { 0x81, 0x80, 0x00, 0x01, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00 };
+        static const uint8_t ucAnswer[] = { 0x00, 0x01, 0x00, 0x01, 0xc0, 0x0c, 0x00, 0x01, 0x00, 0x01,
+                                            0x00, 0x00, 0x00, 0x3c, 0x00, 0x04 };
+        uint8_t ucMessage[ 256 ];
+        struct freertos_sockaddr xAddress;
+        const char * pcLabel = pxQuery->pcName;
+        size_t uxLength = 0, uxLabel;
+
+        memcpy( &( ucMessage[ uxLength ] ), &( pxQuery->usIdentifier ), sizeof( pxQuery->usIdentifier ) );
+        uxLength += sizeof( pxQuery->usIdentifier );
+        memcpy( &( ucMessage[ uxLength ] ), ucHeader, sizeof( ucHeader ) );
+        uxLength += sizeof( ucHeader );
+
+        for( ; ; )
+        {
+            uxLabel = strcspn( pcLabel, "." );
+            ucMessage[ uxLength++ ] = ( uint8_t ) uxLabel;
+            memcpy( &( ucMessage[ uxLength ] ), pcLabel, uxLabel );
+            uxLength += uxLabel;
+
+            if( pcLabel[ uxLabel ] == '\0' )
+            {
+                break;
+            }
+
+            pcLabel += uxLabel + 1u;
+        }
+
+        ucMessage[ uxLength++ ] = 0u;
+
+        /* The type and class of the question, then the answer. */
+        memcpy( &( ucMessage[ uxLength ] ), ucAnswer, sizeof( ucAnswer ) );
+        uxLength += sizeof( ucAnswer );
+        memcpy( &( ucMessage[ uxLength ] ), &ulIPAddress, sizeof( ulIPAddress ) );
+        uxLength += sizeof( ulIPAddress );
+
+        memset( &xAddress, 0, sizeof( xAddress ) );
+        xAddress.sin_addr = FreeRTOS_GetIPAddress();
+        xAddress.sin_port = pxQuery->usPort;
+        TEST_ASSERT_EQUAL( ( int32_t ) uxLength, FreeRTOS_sendto( xDNSServer, ucMessage, uxLength, 0, &xAddress, sizeof( xAddress ) ) );
+    }
+
+    static void prvLookupTask( void * pvParameters )
+    {
+        DNSLookup_t * pxLookup = ( DNSLookup_t * ) pvParameters;
+
+        /* The application's notification must not be taken by the wait. */
+        ( void ) xTaskNotifyGive( xTaskGetCurrentTaskHandle() );
+        pxLookup->ulIPAddress = FreeRTOS_gethostbyname( pxLookup->pcName );
+        pxLookup->xNotificationKept = ( ulTaskNotifyTake( pdTRUE, 0 ) == 1u ) ? pdTRUE : pdFALSE;
+        pxLookup->xDone = pdTRUE;
+
+        vTaskDelete( NULL );
+    }
+
+    static void prvStartLookup( DNSLookup_t * pxLookup,
+                                const char * pcName )
+    {
+        pxLookup->pcName = pcName;
+        pxLookup->ulIPAddress = 0;
+        pxLookup->xNotificationKept = pdFALSE;
+        pxLookup->xDone = pdFALSE;
+
+        TEST_ASSERT_EQUAL( pdPASS, xTaskCreate( prvLookupTask, "Lookup", configMINIMAL_STACK_SIZE * 4, pxLookup,
+                                                uxTaskPriorityGet( NULL ), NULL ) );
+    }
+
+    /* Returns pdFALSE if the look-up did not return in time. */
+    static BaseType_t prvWaitLookup( const DNSLookup_t * pxLookup )
+    {
+        TickType_t xStart = xTaskGetTickCount();
+
+        while( ( pxLookup->xDone == pdFALSE ) && ( ( xTaskGetTickCount() - xStart ) < tcptestDNS_TIMEOUT ) )
+        {
+            vTaskDelay( 1 );
+        }
+
+        return pxLookup->xDone;
+    }
+
+    static DNSLookup_t * prvFindLookup( const char * pcName )
+    {
+        BaseType_t xIndex;
+
+        for( xIndex = 0; xIndex < tcptestDNS_LOOKUPS; xIndex++ )
+        {
+            if( ( xDNSLookups[ xIndex ].pcName != NULL ) && ( strcmp( xDNSLookups[ xIndex ].pcName, pcName ) == 0 ) )
+            {
+                return &( xDNSLookups[ xIndex ] );
+            }
+        }
+
+        return NULL;
+    }
+
+    TEST( Full_FREERTOS_TCP, DNS_resolver_joins_lookups_of_one_name )
+    {
+        const uint32_t ulAddress = FreeRTOS_inet_addr_quick( 10, 0, 0, 1 );
+        DNSSeenQuery_t xQuery, xOther;
+
+        memset( xDNSLookups, 0, sizeof( xDNSLookups ) );
+        prvDNSServerOpen();
+
+        prvStartLookup( &( xDNSLookups[ 0 ] ), "join.resolver.test" );
+        prvStartLookup( &( xDNSLookups[ 1 ] ), "join.resolver.test" );
+
+        TEST_ASSERT_TRUE( prvDNSServerReceive( &xQuery, tcptestDNS_TIMEOUT ) );
+        TEST_ASSERT_EQUAL_STRING( "join.resolver.test", xQuery.pcName );
+
+        /* Both tasks are waiting now.  The second one joined the first query,
+         * a query of its own would arrive here. */
+        TEST_ASSERT_FALSE( prvDNSServerReceive( &xOther, pdMS_TO_TICKS( 100 ) ) );
+
+        prvDNSServerReply( &xQuery, ulAddress );
+
+        TEST_ASSERT_TRUE( prvWaitLookup( &( xDNSLookups[ 0 ] ) ) );
+        TEST_ASSERT_TRUE( prvWaitLookup( &( xDNSLookups[ 1 ] ) ) );
+        TEST_ASSERT_EQUAL_UINT32( ulAddress, xDNSLookups[ 0 ].ulIPAddress );
+        TEST_ASSERT_EQUAL_UINT32( ulAddress, xDNSLookups[ 1 ].ulIPAddress );
+        TEST_ASSERT_TRUE( xDNSLookups[ 0 ].xNotificationKept );
+        TEST_ASSERT_TRUE( xDNSLookups[ 1 ].xNotificationKept );
+
+        prvDNSServerClose();
+    }
+
+    TEST( Full_FREERTOS_TCP, DNS_resolver_shares_socket_between_names )
+    {
+        const char * const pcNames[] = { "a.resolver.test", "b.resolver.test", "c.resolver.test" };
+        const BaseType_t xCount = ( BaseType_t ) ( sizeof( pcNames ) / sizeof( pcNames[ 0 ] ) );
+        DNSSeenQuery_t xQueries[ sizeof( pcNames ) / sizeof( pcNames[ 0 ] ) ];
+        DNSLookup_t * pxLookup;
+        BaseType_t xIndex;
+
+        memset( xDNSLookups, 0, sizeof( xDNSLookups ) );
+        prvDNSServerOpen();
+
+        for( xIndex = 0; xIndex < xCount; xIndex++ )
+        {
+            prvStartLookup( &( xDNSLookups[ xIndex ] ), pcNames[ xIndex ] );
+        }
+
+        for( xIndex = 0; xIndex < xCount; xIndex++ )
+        {
+            TEST_ASSERT_TRUE( prvDNSServerReceive( &( xQueries[ xIndex ] ), tcptestDNS_TIMEOUT ) );
+            TEST_ASSERT_NOT_NULL( prvFindLookup( xQueries[ xIndex ].pcName ) );
+
+            /* All queries leave from the one socket of the resolver, each with
+             * an identifier of its own. */
+            TEST_ASSERT_EQUAL_UINT16( xQueries[ 0 ].usPort, xQueries[ xIndex ].usPort );
+
+            if( xIndex > 0 )
+            {
+                TEST_ASSERT_NOT_EQUAL( xQueries[ xIndex - 1 ].usIdentifier, xQueries[ xIndex ].usIdentifier );
+            }
+        }
+
+        /* Answer in the reverse order, each name with an address of its own. */
+        for( xIndex = xCount - 1; xIndex >= 0; xIndex-- )
+        {
+            pxLookup = prvFindLookup( xQueries[ xIndex ].pcName );
+            prvDNSServerReply( &( xQueries[ xIndex ] ), FreeRTOS_inet_addr_quick( 10, 0, 1, ( uint8_t ) ( pxLookup - xDNSLookups ) + 1u ) );
+        }
+
+        for( xIndex = 0; xIndex < xCount; xIndex++ )
+        {
+            TEST_ASSERT_TRUE( prvWaitLookup( &( xDNSLookups[ xIndex ] ) ) );
+            TEST_ASSERT_EQUAL_UINT32( FreeRTOS_inet_addr_quick( 10, 0, 1, ( uint8_t ) xIndex + 1u ), xDNSLookups[ xIndex ].ulIPAddress );
+        }
+
+        prvDNSServerClose();
+    }
+
+    TEST( Full_FREERTOS_TCP, DNS_resolver_gives_up_after_request_attempts )
+    {
+        DNSSeenQuery_t xQuery;
+        BaseType_t xQueries = 0;
+        TickType_t xStart;
+
+        memset( xDNSLookups, 0, sizeof( xDNSLookups ) );
+        prvDNSServerOpen();
+
+        xStart = xTaskGetTickCount();
+        prvStartLookup( &( xDNSLookups[ 0 ] ), "lost.resolver.test" );
+
+        /* Count the queries, without answering any. */
+        while( ( xDNSLookups[ 0 ].xDone == pdFALSE ) && ( ( xTaskGetTickCount() - xStart ) < tcptestDNS_TIMEOUT ) )
+        {
+            if( prvDNSServerReceive( &xQuery, pdMS_TO_TICKS( 50 ) ) != pdFALSE )
+            {
+                TEST_ASSERT_EQUAL_STRING( "lost.resolver.test", xQuery.pcName );
+                xQueries++;
+            }
+        }
+
+        TEST_ASSERT_TRUE( xDNSLookups[ 0 ].xDone );
+        TEST_ASSERT_EQUAL_UINT32( 0, xDNSLookups[ 0 ].ulIPAddress );
+        TEST_ASSERT_EQUAL( ipconfigDNS_REQUEST_ATTEMPTS, xQueries );
+
+        /* The resolver gives up one retry period after the last attempt. */
+        TEST_ASSERT_TRUE( ( xTaskGetTickCount() - xStart ) >= pdMS_TO_TICKS( ipconfigDNS_RESOLVER_RETRY_MS * ipconfigDNS_REQUEST_ATTEMPTS ) );
+        TEST_ASSERT_FALSE( prvDNSServerReceive( &xQuery, pdMS_TO_TICKS( ipconfigDNS_RESOLVER_RETRY_MS ) ) );
+
+        prvDNSServerClose();
+    }
+
+    TEST( Full_FREERTOS_TCP, DNS_resolver_falls_back_when_slots_are_full )
+    {
+        static char pcNames[ ipconfigDNS_RESOLVER_QUERIES ][ 24 ];
+        DNSSeenQuery_t xQueries[ ipconfigDNS_RESOLVER_QUERIES ], xExtra;
+        BaseType_t xIndex;
+
+        memset( xDNSLookups, 0, sizeof( xDNSLookups ) );
+        prvDNSServerOpen();
+
+        /* Occupy every query slot of the resolver. */
+        for( xIndex = 0; xIndex < ipconfigDNS_RESOLVER_QUERIES; xIndex++ )
+        {
+            strcpy( pcNames[ xIndex ], "slot-a.resolver.test" );
+            pcNames[ xIndex ][ 5 ] = ( char ) ( 'a' + xIndex );
+            prvStartLookup( &( xDNSLookups[ xIndex ] ), pcNames[ xIndex ] );
+        }
+
+        for( xIndex = 0; xIndex < ipconfigDNS_RESOLVER_QUERIES; xIndex++ )
+        {
+            TEST_ASSERT_TRUE( prvDNSServerReceive( &( xQueries[ xIndex ] ), tcptestDNS_TIMEOUT ) );
+            TEST_ASSERT_EQUAL_UINT16( xQueries[ 0 ].usPort, xQueries[ xIndex ].usPort );
+        }
+
+        /* The next look-up sends its request from a socket of its own.
+         * Queries re-sent by the resolver may arrive in between. */
+        prvStartLookup( &( xDNSLookups[ ipconfigDNS_RESOLVER_QUERIES ] ), "extra.resolver.test" );
+
+        do
+        {
+            TEST_ASSERT_TRUE( prvDNSServerReceive( &xExtra, tcptestDNS_TIMEOUT ) );
+        } while( strcmp( xExtra.pcName, "extra.resolver.test" ) != 0 );
+
+        TEST_ASSERT_NOT_EQUAL( xQueries[ 0 ].usPort, xExtra.usPort );
+
+        prvDNSServerReply( &xExtra, FreeRTOS_inet_addr_quick( 10, 0, 2, 100 ) );
+
+        for( xIndex = 0; xIndex < ipconfigDNS_RESOLVER_QUERIES; xIndex++ )
+        {
+            prvDNSServerReply( &( xQueries[ xIndex ] ), FreeRTOS_inet_addr_quick( 10, 0, 2, ( uint8_t ) xIndex + 1u ) );
+        }
+
+        for( xIndex = 0; xIndex < tcptestDNS_LOOKUPS; xIndex++ )
+        {
+            TEST_ASSERT_TRUE( prvWaitLookup( &( xDNSLookups[ xIndex ] ) ) );
+        }
+
+        TEST_ASSERT_EQUAL_UINT32( FreeRTOS_inet_addr_quick( 10, 0, 2, 100 ), xDNSLookups[ ipconfigDNS_RESOLVER_QUERIES ].ulIPAddress );
+
+        for( xIndex = 0; xIndex < ipconfigDNS_RESOLVER_QUERIES; xIndex++ )
+        {
+            TEST_ASSERT_EQUAL_UINT32( FreeRTOS_inet_addr_quick( 10, 0, 2, ( uint8_t ) xIndex + 1u ), prvFindLookup( xQueries[ xIndex ].pcName )->ulIPAddress );
+        }
+
+        prvDNSServerClose();
+    }
+
+    static volatile UBaseType_t uxDNSCallbacks;
+
+    static void prvCountDNSCallback( const char * pcName,
+                                     void * pvSearchID,
+                                     uint32_t ulIPAddress )
+    {
+        ( void ) pcName;
+        ( void ) pvSearchID;
+        ( void ) ulIPAddress;
+
+        uxDNSCallbacks++;
+    }
+
+    TEST( Full_FREERTOS_TCP, DNS_resolver_cancel_races_reply )
+    {
+        char pcName[] = "cancel-a.resolver.test";
+        DNSSeenQuery_t xQuery;
+        UBaseType_t uxAtCancel, uxCalled = 0;
+        uint16_t usResolverPort = 0;
+        BaseType_t xIndex;
+
+        prvDNSServerOpen();
+
+        /* Reply to each query and cancel the look-up at a slightly later
+         * moment every time, so that the IP-task handles the reply before,
+         * during or after the cancellation. */
+        for( xIndex = 0; xIndex < 20; xIndex++ )
+        {
+            pcName[ 7 ] = ( char ) ( 'a' + xIndex );
+            uxDNSCallbacks = 0;
+
+            TEST_ASSERT_EQUAL_UINT32( 0, FreeRTOS_gethostbyname_a( pcName, prvCountDNSCallback, ( void * ) &uxDNSCallbacks, 2000 ) );
+            TEST_ASSERT_TRUE( prvDNSServerReceive( &xQuery, tcptestDNS_TIMEOUT ) );
+
+            /* Every query is sent by the resolver, so every slot was freed. */
+            if( xIndex == 0 )
+            {
+                usResolverPort = xQuery.usPort;
+            }
+
+            TEST_ASSERT_EQUAL_UINT16( usResolverPort, xQuery.usPort );
+
+            prvDNSServerReply( &xQuery, FreeRTOS_inet_addr_quick( 10, 0, 3, 1 ) );
+
+            if( ( xIndex % 4 ) != 0 )
+            {
+                vTaskDelay( ( TickType_t ) ( xIndex % 4 ) - 1 );
+            }
+
+            FreeRTOS_gethostbyname_cancel( ( void * ) &uxDNSCallbacks );
+            uxAtCancel = uxDNSCallbacks;
+
+            /* No call-back may arrive after the cancellation returned. */
+            vTaskDelay( pdMS_TO_TICKS( 50 ) );
+            TEST_ASSERT_TRUE( uxAtCancel <= 1u );
+            TEST_ASSERT_EQUAL( uxAtCancel, uxDNSCallbacks );
+            uxCalled += uxAtCancel;
+        }
+
+        configPRINTF( ( "DNS resolver: %u of 20 replies arrived before the cancellation\r\n", ( unsigned ) uxCalled ) );
+
+        prvDNSServerClose();
+    }
+
+#endif /* if ( tcptestRESOLVER_ENABLED != 0 ) */
@@ -60,6 +60,7 @@ static const char cMY_CORE_ARN[] = "myGreenGrassCoreArn";
 
 static jsmntok_t pxTok[ ggdTestJSON_MAX_TOKENS ];
 static Socket_t xSocket;
+static GGD_DiscoveryCache_t xCache;
 
 TEST_GROUP( Full_GGD );
 
@@ -92,6 +93,8 @@ TEST_GROUP_RUNNER( Full_GGD )
     RUN_TEST_CASE( Full_GGD, GetCore );
     RUN_TEST_CASE( Full_GGD, prvIsIPvalid );
     RUN_TEST_CASE( Full_GGD, GetGGCIPandCertificate );
+    RUN_TEST_CASE( Full_GGD, CacheFromJSON );
+    RUN_TEST_CASE( Full_GGD, GetGGCIPandCertificateCached );
 }
 
 TEST( Full_GGD, JSONRequestAbort )
@@ -219,6 +222,144 @@ TEST( Full_GGD, GetGGCIPandCertificate )
 }
 
 
+TEST( Full_GGD, GetGGCIPandCertificateCached )
+{
+    BaseType_t i;
+    BaseType_t xStatus;
+    GGD_HostAddressData_t xHostAddressData;
+    uint32_t ulBufferSize = testrunnerBUFFER_SIZE;
+
+    if( TEST_PROTECT() )
+    {
+        /** @brief Check the first call fills the cache, and the next calls
+         * connect from it.
+         *  @{
+         */
+        GGD_CacheInvalidate( &xCache );
+
+        for( i = 0; i < ggdTestLOOP_NUMBER; i++ )
+        {
+            xStatus = GGD_GetGGCIPandCertificateCached( cBuffer, /*lint !e971 can use char without signed/unsigned. */
+                                                        ulBufferSize,
+                                                        &xCache,
+                                                        &xHostAddressData );
+            TEST_ASSERT_EQUAL_INT32( pdPASS, xStatus );
+            TEST_ASSERT_EQUAL_INT32( pdTRUE, GGD_CacheIsValid( &xCache ) );
+            TEST_ASSERT_EQUAL_STRING( xCache.xHosts[ 0 ].cHostAddress, xHostAddressData.pcHostAddress );
+            TEST_ASSERT_EQUAL_INT32( xCache.ulCertificateSize, xHostAddressData.ulCertificateSize );
+        }
+
+        /** @}*/
+    }
+    else
+    {
+        TEST_FAIL();
+    }
+
+    /** @brief Check stability.
+     *
+     *  @{
+     */
+    if( TEST_PROTECT() )
+    {
+        xStatus = GGD_GetGGCIPandCertificateCached( cBuffer,
+                                                    ulBufferSize,
+                                                    NULL,
+                                                    &xHostAddressData );
+        TEST_FAIL();
+    }
+
+    if( TEST_PROTECT() )
+    {
+        xStatus = GGD_GetGGCIPandCertificateCached( cBuffer,
+                                                    ulBufferSize,
+                                                    &xCache,
+                                                    NULL );
+        TEST_FAIL();
+    }
+
+    /** @}*/
+}
+
+TEST( Full_GGD, CacheFromJSON )
+{
+    BaseType_t xStatus;
+    char cBadJSON[] = "{\"GGGroups\":[]}";
+
+    if( TEST_PROTECT() )
+    {
+        /** @brief Check every IPv4 host and the certificate are kept.
+         *  @{
+         */
+        memcpy( cBuffer, cJSON_FILE, sizeof( cJSON_FILE ) );
+        xStatus = GGD_CacheFromJSON( cBuffer,
+                                     strlen( cJSON_FILE ),
+                                     &xCache );
+        TEST_ASSERT_EQUAL_INT32( pdPASS, xStatus );
+        TEST_ASSERT_EQUAL_INT32( pdTRUE, GGD_CacheIsValid( &xCache ) );
+        TEST_ASSERT_EQUAL_INT32( 2, xCache.ulHostCount );
+        TEST_ASSERT_EQUAL_STRING( cIP_ADDRESS_1, xCache.xHosts[ 0 ].cHostAddress );
+        TEST_ASSERT_EQUAL_INT32( ggdTestJSON_PORT_ADRESS_1, xCache.xHosts[ 0 ].usPort );
+        TEST_ASSERT_EQUAL_STRING( cIP_ADDRESS_3, xCache.xHosts[ 1 ].cHostAddress );
+        TEST_ASSERT_EQUAL_INT32( ggdTestJSON_PORT_ADRESS_3, xCache.xHosts[ 1 ].usPort );
+        TEST_ASSERT_EQUAL_INT32( strlen( cCERTIFICATE ) + 1, xCache.ulCertificateSize );
+        TEST_ASSERT_EQUAL_MEMORY( cCERTIFICATE, xCache.cCertificate, strlen( cCERTIFICATE ) );
+        /** @}*/
+
+        /** @brief Check a modified or invalidated cache is not used.
+         *  @{
+         */
+        xCache.xHosts[ 0 ].usPort++;
+        TEST_ASSERT_EQUAL_INT32( pdFALSE, GGD_CacheIsValid( &xCache ) );
+
+        memcpy( cBuffer, cJSON_FILE, sizeof( cJSON_FILE ) );
+        xStatus = GGD_CacheFromJSON( cBuffer,
+                                     strlen( cJSON_FILE ),
+                                     &xCache );
+        TEST_ASSERT_EQUAL_INT32( pdPASS, xStatus );
+        GGD_CacheInvalidate( &xCache );
+        TEST_ASSERT_EQUAL_INT32( pdFALSE, GGD_CacheIsValid( &xCache ) );
+        /** @}*/
+
+        /** @brief Check the cache is invalid if no host is found.
+         *  @{
+         */
+        xStatus = GGD_CacheFromJSON( cBadJSON,
+                                     strlen( cBadJSON ),
+                                     &xCache );
+        TEST_ASSERT_EQUAL_INT32( pdFAIL, xStatus );
+        TEST_ASSERT_EQUAL_INT32( pdFALSE, GGD_CacheIsValid( &xCache ) );
+        /** @}*/
+    }
+    else
+    {
+        TEST_FAIL();
+    }
+
+    /** @brief Check stability.
+     *
+     *  @{
+     */
+    if( TEST_PROTECT() )
+    {
+        xStatus = GGD_CacheFromJSON( NULL,
+                                     strlen( cJSON_FILE ),
+                                     &xCache );
+        TEST_FAIL();
+    }
+
+    if( TEST_PROTECT() )
+    {
+        memcpy( cBuffer, cJSON_FILE, sizeof( cJSON_FILE ) );
+        xStatus = GGD_CacheFromJSON( cBuffer,
+                                     strlen( cJSON_FILE ),
+                                     NULL );
+        TEST_FAIL();
+    }
+
+    /** @}*/
+}
+
 TEST( Full_GGD, GetIPandCertificateFromJSON )
 {
     uint32_t ulJSONFileSize = strlen( cJSON_FILE );
@@ -44,6 +44,7 @@ TEST_GROUP_RUNNER( Full_GGD_Helper )
 {
     RUN_TEST_CASE( Full_GGD_Helper, SecureConnect_Connect_Disconnect );
     RUN_TEST_CASE( Full_GGD_Helper, SecureConnect_Send );
+    RUN_TEST_CASE( Full_GGD_Helper, SecureConnect_ConnectFirst );
 }
 
 TEST( Full_GGD_Helper, SecureConnect_Connect_Disconnect )
@@ -149,3 +150,66 @@ TEST( Full_GGD_Helper, SecureConnect_Send )
 
     /** @}*/
 }
+
+TEST( Full_GGD_Helper, SecureConnect_ConnectFirst )
+{
+    GGD_HostAddressData_t xHostAddressData[ 2 ] = { 0 };
+    BaseType_t xConnectFailed[ 2 ];
+    Socket_t xSocket;
+    BaseType_t xWinner;
+
+    /* The first host does not answer, so the race is won by the second. */
+    xHostAddressData[ 0 ].pcHostAddress = "192.0.2.1";
+    xHostAddressData[ 0 ].usPort = clientcredentialMQTT_BROKER_PORT;
+    xHostAddressData[ 1 ].pcHostAddress = clientcredentialMQTT_BROKER_ENDPOINT;
+    xHostAddressData[ 1 ].usPort = clientcredentialMQTT_BROKER_PORT;
+
+    if( TEST_PROTECT() )
+    {
+        /** @brief Check the host that answers is connected to.
+         *  @{
+         */
+        xWinner = GGD_SecureConnect_ConnectFirst( xHostAddressData,
+                                                  2,
+                                                  &xSocket,
+                                                  xConnectFailed,
+                                                  ggdconfigTCP_RECEIVE_TIMEOUT_MS,
+                                                  ggdconfigTCP_SEND_TIMEOUT_MS );
+        TEST_ASSERT_EQUAL_INT32( 1, xWinner );
+        TEST_ASSERT_EQUAL_INT32( pdFALSE, xConnectFailed[ 1 ] );
+
+        GGD_SecureConnect_Disconnect( &xSocket );
+        /** @}*/
+    }
+    else
+    {
+        TEST_FAIL();
+    }
+
+    /** @brief Check Statility by passing in NULL pointers.
+     *  @{
+     */
+    if( TEST_PROTECT() )
+    {
+        xWinner = GGD_SecureConnect_ConnectFirst( xHostAddressData,
+                                                  2,
+                                                  NULL,
+                                                  xConnectFailed,
+                                                  ggdconfigTCP_RECEIVE_TIMEOUT_MS,
+                                                  ggdconfigTCP_SEND_TIMEOUT_MS );
+        TEST_FAIL();
+    }
+
+    if( TEST_PROTECT() )
+    {
+        xWinner = GGD_SecureConnect_ConnectFirst( NULL,
+                                                  2,
+                                                  &xSocket,
+                                                  xConnectFailed,
+                                                  ggdconfigTCP_RECEIVE_TIMEOUT_MS,
+                                                  ggdconfigTCP_SEND_TIMEOUT_MS );
+        TEST_FAIL();
+    }
+
+    /** @}*/
+}
@@ -0,0 +1,398 @@
+/*
+ * Amazon FreeRTOS
+ * Copyright (C) 2018 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+/**
+ * @file aws_test_kernel_delay.c
+ * @brief Tests for the delayed task lists and the delayed task wheel.
+ */
+
+/* Standard includes. */
+#include <stdint.h>
+#include <string.h>
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+
+/* Test includes. */
+#include "unity_fixture.h"
+#include "unity.h"
+
+/**
+ * @brief Configuration for this test group.
+ */
+#define kerneltestDELAY_TIMEOUT           pdMS_TO_TICKS( 1000 )
+#define kerneltestDELAY_LONG              ( ( TickType_t ) configDELAYED_TASK_WHEEL_SIZE + 20 )
+#define kerneltestDELAY_ABORTED           pdMS_TO_TICKS( 100 )
+#define kerneltestBENCH_ITERATIONS        200
+#define kerneltestBENCH_DELAY             pdMS_TO_TICKS( 200 )
+#define kerneltestBENCH_MAX_SLEEPERS      256
+
+/*
+ * @brief Test group definition.
+ */
+TEST_GROUP( Full_KERNEL_DELAY );
+
+TEST_SETUP( Full_KERNEL_DELAY )
+{
+    ( void ) ulTaskNotifyTake( pdTRUE, 0 );
+}
+
+TEST_TEAR_DOWN( Full_KERNEL_DELAY )
+{
+}
+
+TEST_GROUP_RUNNER( Full_KERNEL_DELAY )
+{
+    RUN_TEST_CASE( Full_KERNEL_DELAY, tasks_wake_in_wake_time_order );
+    RUN_TEST_CASE( Full_KERNEL_DELAY, blocked_task_is_visible_and_can_leave_early );
+    RUN_TEST_CASE( Full_KERNEL_DELAY, block_time_vs_blocked_tasks );
+}
+
+/*-----------------------------------------------------------*/
+
+typedef struct DelayRecord
+{
+    TickType_t xTimeToWake;
+    TickType_t xTimeWoken;
+} DelayRecord_t;
+
+static const TickType_t xDelays[] = { 3, 1, 7, 3, 12, kerneltestDELAY_LONG, 1, 5 };
+#define kerneltestDELAY_TASKS    ( sizeof( xDelays ) / sizeof( xDelays[ 0 ] ) )
+
+static TaskHandle_t xTestTask;
+static DelayRecord_t xRecords[ kerneltestDELAY_TASKS ];
+static volatile UBaseType_t uxRecords;
+
+/*-----------------------------------------------------------*/
+
+static void prvDelayTask( void * pvParameters )
+{
+    const TickType_t xDelay = *( ( const TickType_t * ) pvParameters );
+    TickType_t xLastWakeTime = xTaskGetTickCount();
+
+    /* vTaskDelayUntil() is used so the wake time is known exactly. */
+    vTaskDelayUntil( &xLastWakeTime, xDelay );
+
+    taskENTER_CRITICAL();
+    {
+        xRecords[ uxRecords ].xTimeToWake = xLastWakeTime;
+        xRecords[ uxRecords ].xTimeWoken = xTaskGetTickCount();
+        uxRecords++;
+    }
+    taskEXIT_CRITICAL();
+
+    xTaskNotifyGive( xTestTask );
+    vTaskDelete( NULL );
+}
+
+/*-----------------------------------------------------------*/
+
+TEST( Full_KERNEL_DELAY, tasks_wake_in_wake_time_order )
+{
+    UBaseType_t uxTask;
+    uint32_t ulNotified, ulWoken = 0;
+
+    xTestTask = xTaskGetCurrentTaskHandle();
+    uxRecords = 0;
+
+    /* The tasks have a higher priority, so block as soon as they are created.
+     * The long delay does not fit in the delayed task wheel. */
+    for( uxTask = 0; uxTask < kerneltestDELAY_TASKS; uxTask++ )
+    {
+        TEST_ASSERT_EQUAL( pdPASS, xTaskCreate( prvDelayTask,
+                                                "Delay",
+                                                configMINIMAL_STACK_SIZE * 2,
+                                                ( void * ) &( xDelays[ uxTask ] ),
+                                                uxTaskPriorityGet( NULL ) + 1,
+                                                NULL ) );
+    }
+
+    while( ulWoken < kerneltestDELAY_TASKS )
+    {
+        ulNotified = ulTaskNotifyTake( pdTRUE, kerneltestDELAY_TIMEOUT );
+        TEST_ASSERT_NOT_EQUAL( 0, ulNotified );
+        ulWoken += ulNotified;
+    }
+
+    TEST_ASSERT_EQUAL( kerneltestDELAY_TASKS, uxRecords );
+
+    /* No task woke early, and no task woke before one due to wake earlier. */
+    for( uxTask = 0; uxTask < kerneltestDELAY_TASKS; uxTask++ )
+    {
+        TEST_ASSERT_TRUE( ( TickType_t ) ( xRecords[ uxTask ].xTimeWoken - xRecords[ uxTask ].xTimeToWake ) < kerneltestDELAY_TIMEOUT );
+
+        if( uxTask > 0 )
+        {
+            TEST_ASSERT_TRUE( ( TickType_t ) ( xRecords[ uxTask ].xTimeToWake - xRecords[ uxTask - 1 ].xTimeToWake ) < kerneltestDELAY_TIMEOUT );
+        }
+    }
+
+    /* Let the idle task free the delay tasks. */
+    vTaskDelay( pdMS_TO_TICKS( 10 ) );
+}
+
+/*-----------------------------------------------------------*/
+
+static void prvBlockedTask( void * pvParameters )
+{
+    TickType_t xStart = xTaskGetTickCount();
+
+    ( void ) pvParameters;
+
+    vTaskDelay( kerneltestDELAY_ABORTED );
+
+    xRecords[ 0 ].xTimeToWake = xStart + kerneltestDELAY_ABORTED;
+    xRecords[ 0 ].xTimeWoken = xTaskGetTickCount();
+    xTaskNotifyGive( xTestTask );
+
+    /* Block again so the test can resume this task from the suspended state. */
+    vTaskDelay( kerneltestDELAY_ABORTED );
+    xTaskNotifyGive( xTestTask );
+    vTaskDelete( NULL );
+}
+
+/*-----------------------------------------------------------*/
+
+TEST( Full_KERNEL_DELAY, blocked_task_is_visible_and_can_leave_early )
+{
+    TaskHandle_t xBlocked = NULL;
+    TaskStatus_t * pxStatus;
+    UBaseType_t uxTasks, uxTask;
+    BaseType_t xFound = pdFALSE;
+
+    xTestTask = xTaskGetCurrentTaskHandle();
+    memset( xRecords, 0, sizeof( xRecords ) );
+
+    TEST_ASSERT_EQUAL( pdPASS, xTaskCreate( prvBlockedTask,
+                                            "DelayBlocked",
+                                            configMINIMAL_STACK_SIZE * 2,
+                                            NULL,
+                                            uxTaskPriorityGet( NULL ) + 1,
+                                            &xBlocked ) );
+
+    /* The blocked task is found wherever the kernel holds it. */
+    TEST_ASSERT_EQUAL( eBlocked, eTaskGetState( xBlocked ) );
+    #if ( INCLUDE_xTaskGetHandle == 1 )
+        TEST_ASSERT_EQUAL_PTR( xBlocked, xTaskGetHandle( "DelayBlocked" ) );
+    #endif
+
+    pxStatus = pvPortMalloc( ( uxTaskGetNumberOfTasks() + 4 ) * sizeof( TaskStatus_t ) );
+    TEST_ASSERT_NOT_NULL( pxStatus );
+    uxTasks = uxTaskGetSystemState( pxStatus, uxTaskGetNumberOfTasks() + 4, NULL );
+
+    for( uxTask = 0; uxTask < uxTasks; uxTask++ )
+    {
+        if( pxStatus[ uxTask ].xHandle == xBlocked )
+        {
+            TEST_ASSERT_EQUAL( eBlocked, pxStatus[ uxTask ].eCurrentState );
+            xFound = pdTRUE;
+        }
+    }
+
+    vPortFree( pxStatus );
+    TEST_ASSERT_EQUAL( pdTRUE, xFound );
+
+    /* Aborting the delay removes the task from the delayed list or wheel. */
+    TEST_ASSERT_EQUAL( pdPASS, xTaskAbortDelay( xBlocked ) );
+    TEST_ASSERT_EQUAL_UINT32( 1, ulTaskNotifyTake( pdTRUE, kerneltestDELAY_TIMEOUT ) );
+    TEST_ASSERT_TRUE( ( TickType_t ) ( xRecords[ 0 ].xTimeToWake - xRecords[ 0 ].xTimeWoken ) > 0 );
+    TEST_ASSERT_TRUE( ( TickType_t ) ( xRecords[ 0 ].xTimeToWake - xRecords[ 0 ].xTimeWoken ) <= kerneltestDELAY_ABORTED );
+
+    /* A task suspended while delayed is not woken by its wake time. */
+    TEST_ASSERT_EQUAL( eBlocked, eTaskGetState( xBlocked ) );
+    vTaskSuspend( xBlocked );
+    TEST_ASSERT_EQUAL( eSuspended, eTaskGetState( xBlocked ) );
+    TEST_ASSERT_EQUAL_UINT32( 0, ulTaskNotifyTake( pdTRUE, kerneltestDELAY_ABORTED + 10 ) );
+    vTaskResume( xBlocked );
+    TEST_ASSERT_EQUAL_UINT32( 1, ulTaskNotifyTake( pdTRUE, kerneltestDELAY_TIMEOUT ) );
+
+    /* Let the idle task free the blocked task. */
+    vTaskDelay( pdMS_TO_TICKS( 10 ) );
+}
+
+/*-----------------------------------------------------------*/
+
+/*
+ * The benchmark measures how long the scheduler stays suspended while a task
+ * enters the Blocked state, from traceTASK_DELAY() in vTaskDelay() to
+ * traceTASK_SWITCHED_OUT() as the task is switched out.  The test configuration
+ * of a port defines those trace macros to call the functions below.
+ */
+static TaskHandle_t xBenchTask;
+static volatile BaseType_t xBenchStarted;
+static volatile uint32_t ulBenchStart;
+static volatile uint32_t ulBenchTotal;
+static volatile uint32_t ulBenchWorst;
+static volatile uint32_t ulBenchSamples;
+
+void vKernelTestTraceTaskDelay( void )
+{
+    #if ( configGENERATE_RUN_TIME_STATS == 1 )
+        if( ( xBenchTask != NULL ) && ( xTaskGetCurrentTaskHandle() == xBenchTask ) )
+        {
+            ulBenchStart = ( uint32_t ) portGET_RUN_TIME_COUNTER_VALUE();
+            xBenchStarted = pdTRUE;
+        }
+    #endif
+}
+
+/*-----------------------------------------------------------*/
+
+void vKernelTestTraceTaskSwitchedOut( void )
+{
+    #if ( configGENERATE_RUN_TIME_STATS == 1 )
+        uint32_t ulElapsed;
+
+        if( ( xBenchStarted != pdFALSE ) && ( xTaskGetCurrentTaskHandle() == xBenchTask ) )
+        {
+            ulElapsed = ( uint32_t ) portGET_RUN_TIME_COUNTER_VALUE() - ulBenchStart;
+            ulBenchTotal += ulElapsed;
+            ulBenchSamples++;
+
+            if( ulElapsed > ulBenchWorst )
+            {
+                ulBenchWorst = ulElapsed;
+            }
+
+            xBenchStarted = pdFALSE;
+        }
+    #endif
+}
+
+/*-----------------------------------------------------------*/
+
+static void prvSleeperTask( void * pvParameters )
+{
+    /* Every sleeper wakes before the benchmark task would, so the benchmark
+     * task's wake time is the latest of all the blocked tasks. */
+    const TickType_t xDelay = ( kerneltestBENCH_DELAY / 2 ) +
+                              ( ( TickType_t ) ( uintptr_t ) pvParameters % ( kerneltestBENCH_DELAY / 2 ) );
+
+    for( ; ; )
+    {
+        vTaskDelay( xDelay );
+    }
+}
+
+/*-----------------------------------------------------------*/
+
+static void prvAbortDelayTask( void * pvParameters )
+{
+    ( void ) pvParameters;
+
+    /* Runs once the benchmark task has blocked, and wakes it again. */
+    for( ; ; )
+    {
+        ( void ) ulTaskNotifyTake( pdTRUE, portMAX_DELAY );
+        ( void ) xTaskAbortDelay( xBenchTask );
+    }
+}
+
+/*-----------------------------------------------------------*/
+
+TEST( Full_KERNEL_DELAY, block_time_vs_blocked_tasks )
+{
+    #if ( configGENERATE_RUN_TIME_STATS == 1 )
+        static const UBaseType_t uxSleeperCounts[] = { 0, 16, 64, kerneltestBENCH_MAX_SLEEPERS };
+        static TaskHandle_t xSleepers[ kerneltestBENCH_MAX_SLEEPERS ];
+        const UBaseType_t uxPriority = uxTaskPriorityGet( NULL );
+        TaskHandle_t xAbortTask = NULL;
+        UBaseType_t uxCount, uxSleeper, uxIteration;
+        uint32_t ulMean;
+
+        /* Sleepers < abort task < this task. */
+        vTaskPrioritySet( NULL, uxPriority + 3 );
+        TEST_ASSERT_EQUAL( pdPASS, xTaskCreate( prvAbortDelayTask,
+                                                "DelayAbort",
+                                                configMINIMAL_STACK_SIZE * 2,
+                                                NULL,
+                                                uxPriority + 2,
+                                                &xAbortTask ) );
+
+        for( uxCount = 0; uxCount < ( sizeof( uxSleeperCounts ) / sizeof( uxSleeperCounts[ 0 ] ) ); uxCount++ )
+        {
+            for( uxSleeper = 0; uxSleeper < uxSleeperCounts[ uxCount ]; uxSleeper++ )
+            {
+                TEST_ASSERT_EQUAL( pdPASS, xTaskCreate( prvSleeperTask,
+                                                        "DelaySleeper",
+                                                        configMINIMAL_STACK_SIZE,
+                                                        ( void * ) ( uintptr_t ) ( uxSleeper * 7U ),
+                                                        uxPriority + 1,
+                                                        &( xSleepers[ uxSleeper ] ) ) );
+            }
+
+            /* Let the sleepers block. */
+            vTaskDelay( pdMS_TO_TICKS( 20 ) );
+
+            taskENTER_CRITICAL();
+            {
+                ulBenchTotal = 0;
+                ulBenchWorst = 0;
+                ulBenchSamples = 0;
+                xBenchStarted = pdFALSE;
+                xBenchTask = xTaskGetCurrentTaskHandle();
+            }
+            taskEXIT_CRITICAL();
+
+            for( uxIteration = 0; uxIteration < kerneltestBENCH_ITERATIONS; uxIteration++ )
+            {
+                xTaskNotifyGive( xAbortTask );
+                vTaskDelay( kerneltestBENCH_DELAY );
+            }
+
+            xBenchTask = NULL;
+
+            for( uxSleeper = 0; uxSleeper < uxSleeperCounts[ uxCount ]; uxSleeper++ )
+            {
+                vTaskDelete( xSleepers[ uxSleeper ] );
+            }
+
+            if( ulBenchSamples != 0 )
+            {
+                ulMean = ( ulBenchTotal * 100UL ) / ulBenchSamples;
+                configPRINTF( ( "Delayed task insertion with %u other tasks blocked: run time %u.%02u mean, %u worst over %u samples\r\n",
+                                ( unsigned ) uxSleeperCounts[ uxCount ],
+                                ( unsigned ) ( ulMean / 100UL ),
+                                ( unsigned ) ( ulMean % 100UL ),
+                                ( unsigned ) ulBenchWorst,
+                                ( unsigned ) ulBenchSamples ) );
+            }
+        }
+
+        vTaskDelete( xAbortTask );
+        vTaskPrioritySet( NULL, uxPriority );
+
+        /* Let the idle task free the sleepers. */
+        vTaskDelay( pdMS_TO_TICKS( 10 ) );
+
+        if( ulBenchSamples == 0 )
+        {
+            TEST_IGNORE_MESSAGE( "traceTASK_DELAY and traceTASK_SWITCHED_OUT are not hooked" );
+        }
+    #else /* if ( configGENERATE_RUN_TIME_STATS == 1 ) */
+        TEST_IGNORE_MESSAGE( "configGENERATE_RUN_TIME_STATS is required" );
+    #endif /* if ( configGENERATE_RUN_TIME_STATS == 1 ) */
+}
@@ -0,0 +1,486 @@
+/*
+ * Amazon FreeRTOS
+ * Copyright (C) 2018 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+/**
+ * @file aws_test_kernel_queue.c
+ * @brief Tests for the kernel queue batch send and receive functions.
+ */
+
+/* Standard includes. */
+#include <stdint.h>
+#include <string.h>
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+
+/* Test includes. */
+#include "unity_fixture.h"
+#include "unity.h"
+
+/**
+ * @brief Configuration for this test group.
+ */
+#define kerneltestQUEUE_LENGTH            8
+#define kerneltestRECEIVER_TASKS          3
+#define kerneltestTASK_TIMEOUT            pdMS_TO_TICKS( 1000 )
+#define kerneltestBENCH_QUEUE_LENGTH      64
+#define kerneltestBENCH_ITEMS             4096
+#define kerneltestBENCH_MAX_ITEM_SIZE     128
+
+/*
+ * @brief Test group definition.
+ */
+TEST_GROUP( Full_KERNEL_QUEUE );
+
+TEST_SETUP( Full_KERNEL_QUEUE )
+{
+}
+
+TEST_TEAR_DOWN( Full_KERNEL_QUEUE )
+{
+}
+
+TEST_GROUP_RUNNER( Full_KERNEL_QUEUE )
+{
+    RUN_TEST_CASE( Full_KERNEL_QUEUE, SendMultiple_ReceiveMultiple_keep_order_across_wrap );
+    RUN_TEST_CASE( Full_KERNEL_QUEUE, SendMultiple_ReceiveMultiple_move_partial_batches );
+    RUN_TEST_CASE( Full_KERNEL_QUEUE, SendMultiple_mixes_with_single_item_calls );
+    RUN_TEST_CASE( Full_KERNEL_QUEUE, SendMultiple_wakes_one_receiver_per_item );
+    RUN_TEST_CASE( Full_KERNEL_QUEUE, ReceiveMultiple_wakes_blocked_sender );
+    RUN_TEST_CASE( Full_KERNEL_QUEUE, MultipleFromISR );
+    RUN_TEST_CASE( Full_KERNEL_QUEUE, throughput_single_vs_batch );
+}
+
+/*-----------------------------------------------------------*/
+
+static QueueHandle_t xReceiverQueue;
+static TaskHandle_t xTestTask;
+static volatile uint32_t ulItemsReceived;
+static volatile uint32_t ulItemsSent;
+
+static uint8_t ucBenchItems[ kerneltestBENCH_QUEUE_LENGTH * kerneltestBENCH_MAX_ITEM_SIZE ];
+static uint8_t ucBenchBuffer[ kerneltestBENCH_QUEUE_LENGTH * kerneltestBENCH_MAX_ITEM_SIZE ];
+
+/*-----------------------------------------------------------*/
+
+static void prvReceiverTask( void * pvParameters )
+{
+    uint32_t ulItem;
+
+    ( void ) pvParameters;
+
+    if( xQueueReceive( xReceiverQueue, &ulItem, kerneltestTASK_TIMEOUT ) == pdPASS )
+    {
+        taskENTER_CRITICAL();
+        ulItemsReceived++;
+        taskEXIT_CRITICAL();
+    }
+
+    xTaskNotifyGive( xTestTask );
+    vTaskDelete( NULL );
+}
+
+/*-----------------------------------------------------------*/
+
+static void prvSenderTask( void * pvParameters )
+{
+    const uint32_t * pulItems = ( const uint32_t * ) pvParameters;
+
+    ulItemsSent = ( uint32_t ) xQueueSendMultiple( xReceiverQueue, pulItems, 2, kerneltestTASK_TIMEOUT );
+
+    xTaskNotifyGive( xTestTask );
+    vTaskDelete( NULL );
+}
+
+/*-----------------------------------------------------------*/
+
+TEST( Full_KERNEL_QUEUE, SendMultiple_ReceiveMultiple_keep_order_across_wrap )
+{
+    QueueHandle_t xQueue;
+    uint32_t ulItems[ kerneltestQUEUE_LENGTH ];
+    uint32_t ulBuffer[ kerneltestQUEUE_LENGTH ];
+    uint32_t ulNext = 0, ulExpected = 0;
+    uint32_t ulIndex, ulRound;
+    size_t xCount;
+
+    xQueue = xQueueCreate( kerneltestQUEUE_LENGTH, sizeof( uint32_t ) );
+    TEST_ASSERT_NOT_NULL( xQueue );
+
+    if( TEST_PROTECT() )
+    {
+        /* Batches of five through a queue of eight move the read and write
+         * positions to every offset, so most batches wrap around. */
+        for( ulRound = 0; ulRound < ( kerneltestQUEUE_LENGTH * 2 ); ulRound++ )
+        {
+            for( ulIndex = 0; ulIndex < 5; ulIndex++ )
+            {
+                ulItems[ ulIndex ] = ulNext++;
+            }
+
+            xCount = xQueueSendMultiple( xQueue, ulItems, 5, 0 );
+            TEST_ASSERT_EQUAL( 5, xCount );
+            TEST_ASSERT_EQUAL( 5, uxQueueMessagesWaiting( xQueue ) );
+
+            memset( ulBuffer, 0, sizeof( ulBuffer ) );
+            xCount = xQueueReceiveMultiple( xQueue, ulBuffer, kerneltestQUEUE_LENGTH, 0 );
+            TEST_ASSERT_EQUAL( 5, xCount );
+
+            for( ulIndex = 0; ulIndex < 5; ulIndex++ )
+            {
+                TEST_ASSERT_EQUAL_UINT32( ulExpected++, ulBuffer[ ulIndex ] );
+            }
+
+            TEST_ASSERT_EQUAL( 0, uxQueueMessagesWaiting( xQueue ) );
+        }
+    }
+
+    vQueueDelete( xQueue );
+}
+
+/*-----------------------------------------------------------*/
+
+TEST( Full_KERNEL_QUEUE, SendMultiple_ReceiveMultiple_move_partial_batches )
+{
+    QueueHandle_t xQueue;
+    uint32_t ulItems[ kerneltestQUEUE_LENGTH * 2 ];
+    uint32_t ulBuffer[ kerneltestQUEUE_LENGTH * 2 ];
+    uint32_t ulIndex;
+
+    for( ulIndex = 0; ulIndex < ( kerneltestQUEUE_LENGTH * 2 ); ulIndex++ )
+    {
+        ulItems[ ulIndex ] = ulIndex;
+    }
+
+    xQueue = xQueueCreate( kerneltestQUEUE_LENGTH, sizeof( uint32_t ) );
+    TEST_ASSERT_NOT_NULL( xQueue );
+
+    if( TEST_PROTECT() )
+    {
+        /* Only as many items as there is space for are posted. */
+        TEST_ASSERT_EQUAL( 3, xQueueSendMultiple( xQueue, ulItems, 3, 0 ) );
+        TEST_ASSERT_EQUAL( kerneltestQUEUE_LENGTH - 3,
+                           xQueueSendMultiple( xQueue, &( ulItems[ 3 ] ), kerneltestQUEUE_LENGTH * 2, 0 ) );
+
+        /* A full queue times out without posting anything. */
+        TEST_ASSERT_EQUAL( 0, xQueueSendMultiple( xQueue, ulItems, 1, 1 ) );
+        TEST_ASSERT_EQUAL( 0, xQueueSendMultiple( xQueue, ulItems, 0, 0 ) );
+
+        /* Only as many items as the buffer can hold are received. */
+        TEST_ASSERT_EQUAL( 2, xQueueReceiveMultiple( xQueue, ulBuffer, 2, 0 ) );
+        TEST_ASSERT_EQUAL_UINT32( 0, ulBuffer[ 0 ] );
+        TEST_ASSERT_EQUAL_UINT32( 1, ulBuffer[ 1 ] );
+
+        /* Only as many items as are available are received. */
+        TEST_ASSERT_EQUAL( kerneltestQUEUE_LENGTH - 2,
+                           xQueueReceiveMultiple( xQueue, ulBuffer, kerneltestQUEUE_LENGTH * 2, 0 ) );
+
+        for( ulIndex = 0; ulIndex < ( kerneltestQUEUE_LENGTH - 2 ); ulIndex++ )
+        {
+            TEST_ASSERT_EQUAL_UINT32( ulIndex + 2, ulBuffer[ ulIndex ] );
+        }
+
+        /* An empty queue times out without receiving anything. */
+        TEST_ASSERT_EQUAL( 0, xQueueReceiveMultiple( xQueue, ulBuffer, 1, 1 ) );
+        TEST_ASSERT_EQUAL( 0, xQueueReceiveMultiple( xQueue, ulBuffer, 0, 0 ) );
+    }
+
+    vQueueDelete( xQueue );
+}
+
+/*-----------------------------------------------------------*/
+
+TEST( Full_KERNEL_QUEUE, SendMultiple_mixes_with_single_item_calls )
+{
+    QueueHandle_t xQueue;
+    uint32_t ulItems[ kerneltestQUEUE_LENGTH ];
+    uint32_t ulBuffer[ kerneltestQUEUE_LENGTH ];
+    uint32_t ulItem, ulNext = 0, ulExpected = 0;
+    uint32_t ulIndex, ulRound;
+
+    xQueue = xQueueCreate( kerneltestQUEUE_LENGTH, sizeof( uint32_t ) );
+    TEST_ASSERT_NOT_NULL( xQueue );
+
+    if( TEST_PROTECT() )
+    {
+        for( ulRound = 0; ulRound < ( kerneltestQUEUE_LENGTH * 2 ); ulRound++ )
+        {
+            /* One item in, three in a batch, then one more in. */
+            ulItem = ulNext++;
+            TEST_ASSERT_EQUAL( pdPASS, xQueueSend( xQueue, &ulItem, 0 ) );
+
+            for( ulIndex = 0; ulIndex < 3; ulIndex++ )
+            {
+                ulItems[ ulIndex ] = ulNext++;
+            }
+
+            TEST_ASSERT_EQUAL( 3, xQueueSendMultiple( xQueue, ulItems, 3, 0 ) );
+            ulItem = ulNext++;
+            TEST_ASSERT_EQUAL( pdPASS, xQueueSend( xQueue, &ulItem, 0 ) );
+
+            /* Peek and receive one item, then the rest in a batch. */
+            TEST_ASSERT_EQUAL( pdPASS, xQueuePeek( xQueue, &ulItem, 0 ) );
+            TEST_ASSERT_EQUAL_UINT32( ulExpected, ulItem );
+            TEST_ASSERT_EQUAL( pdPASS, xQueueReceive( xQueue, &ulItem, 0 ) );
+            TEST_ASSERT_EQUAL_UINT32( ulExpected++, ulItem );
+            TEST_ASSERT_EQUAL( 4, xQueueReceiveMultiple( xQueue, ulBuffer, kerneltestQUEUE_LENGTH, 0 ) );
+
+            for( ulIndex = 0; ulIndex < 4; ulIndex++ )
+            {
+                TEST_ASSERT_EQUAL_UINT32( ulExpected++, ulBuffer[ ulIndex ] );
+            }
+        }
+    }
+
+    vQueueDelete( xQueue );
+}
+
+/*-----------------------------------------------------------*/
+
+TEST( Full_KERNEL_QUEUE, SendMultiple_wakes_one_receiver_per_item )
+{
+    uint32_t ulItems[ kerneltestRECEIVER_TASKS ] = { 0 };
+    uint32_t ulTask, ulNotified = 0;
+
+    /* Earlier test groups may have left a notification pending. */
+    xTestTask = xTaskGetCurrentTaskHandle();
+    ( void ) ulTaskNotifyTake( pdTRUE, 0 );
+    ulItemsReceived = 0;
+    xReceiverQueue = xQueueCreate( kerneltestQUEUE_LENGTH, sizeof( uint32_t ) );
+    TEST_ASSERT_NOT_NULL( xReceiverQueue );
+
+    if( TEST_PROTECT() )
+    {
+        /* The receivers have a higher priority, so each blocks on the empty
+         * queue as soon as it is created. */
+        for( ulTask = 0; ulTask < kerneltestRECEIVER_TASKS; ulTask++ )
+        {
+            TEST_ASSERT_EQUAL( pdPASS, xTaskCreate( prvReceiverTask,
+                                                    "QRx",
+                                                    configMINIMAL_STACK_SIZE * 2,
+                                                    NULL,
+                                                    uxTaskPriorityGet( NULL ) + 1,
+                                                    NULL ) );
+        }
+
+        /* A single batch must unblock every one of them, not just the first. */
+        TEST_ASSERT_EQUAL( kerneltestRECEIVER_TASKS,
+                           xQueueSendMultiple( xReceiverQueue, ulItems, kerneltestRECEIVER_TASKS, 0 ) );
+
+        for( ulTask = 0; ( ulTask < kerneltestRECEIVER_TASKS ) && ( ulNotified < kerneltestRECEIVER_TASKS ); ulTask++ )
+        {
+            ulNotified += ulTaskNotifyTake( pdTRUE, kerneltestTASK_TIMEOUT * 2 );
+        }
+
+        TEST_ASSERT_EQUAL( kerneltestRECEIVER_TASKS, ulNotified );
+        TEST_ASSERT_EQUAL( kerneltestRECEIVER_TASKS, ulItemsReceived );
+        TEST_ASSERT_EQUAL( 0, uxQueueMessagesWaiting( xReceiverQueue ) );
+    }
+
+    /* Let the idle task free the receivers before the queue is deleted. */
+    vTaskDelay( pdMS_TO_TICKS( 10 ) );
+    vQueueDelete( xReceiverQueue );
+}
+
+/*-----------------------------------------------------------*/
+
+TEST( Full_KERNEL_QUEUE, ReceiveMultiple_wakes_blocked_sender )
+{
+    uint32_t ulItems[ kerneltestQUEUE_LENGTH ] = { 0 };
+    uint32_t ulBuffer[ kerneltestQUEUE_LENGTH ];
+    static const uint32_t ulSenderItems[ 2 ] = { 0x5a5a0001UL, 0x5a5a0002UL };
+
+    /* Earlier test groups may have left a notification pending. */
+    xTestTask = xTaskGetCurrentTaskHandle();
+    ( void ) ulTaskNotifyTake( pdTRUE, 0 );
+    ulItemsSent = 0;
+    xReceiverQueue = xQueueCreate( kerneltestQUEUE_LENGTH, sizeof( uint32_t ) );
+    TEST_ASSERT_NOT_NULL( xReceiverQueue );
+
+    if( TEST_PROTECT() )
+    {
+        TEST_ASSERT_EQUAL( kerneltestQUEUE_LENGTH,
+                           xQueueSendMultiple( xReceiverQueue, ulItems, kerneltestQUEUE_LENGTH, 0 ) );
+
+        /* The sender blocks on the full queue as soon as it is created. */
+        TEST_ASSERT_EQUAL( pdPASS, xTaskCreate( prvSenderTask,
+                                                "QTx",
+                                                configMINIMAL_STACK_SIZE * 2,
+                                                ( void * ) ulSenderItems,
+                                                uxTaskPriorityGet( NULL ) + 1,
+                                                NULL ) );
+        TEST_ASSERT_EQUAL( 0, ulItemsSent );
+
+        /* Making space for three items lets the sender post both of its
+         * items in one go. */
+        TEST_ASSERT_EQUAL( 3, xQueueReceiveMultiple( xReceiverQueue, ulBuffer, 3, 0 ) );
+        TEST_ASSERT_EQUAL( 1, ulTaskNotifyTake( pdTRUE, kerneltestTASK_TIMEOUT * 2 ) );
+        TEST_ASSERT_EQUAL( 2, ulItemsSent );
+
+        TEST_ASSERT_EQUAL( kerneltestQUEUE_LENGTH - 1,
+                           xQueueReceiveMultiple( xReceiverQueue, ulBuffer, kerneltestQUEUE_LENGTH, 0 ) );
+        TEST_ASSERT_EQUAL_UINT32( ulSenderItems[ 0 ], ulBuffer[ kerneltestQUEUE_LENGTH - 3 ] );
+        TEST_ASSERT_EQUAL_UINT32( ulSenderItems[ 1 ], ulBuffer[ kerneltestQUEUE_LENGTH - 2 ] );
+    }
+
+    vTaskDelay( pdMS_TO_TICKS( 10 ) );
+    vQueueDelete( xReceiverQueue );
+}
+
+/*-----------------------------------------------------------*/
+
+TEST( Full_KERNEL_QUEUE, MultipleFromISR )
+{
+    QueueHandle_t xQueue;
+    uint32_t ulItems[ kerneltestQUEUE_LENGTH + 2 ];
+    uint32_t ulBuffer[ kerneltestQUEUE_LENGTH + 2 ];
+    BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+    size_t xSent, xReceived, xSentWhenFull, xReceivedWhenEmpty;
+    uint32_t ulIndex;
+
+    for( ulIndex = 0; ulIndex < ( kerneltestQUEUE_LENGTH + 2 ); ulIndex++ )
+    {
+        ulItems[ ulIndex ] = ulIndex * 3;
+    }
+
+    xQueue = xQueueCreate( kerneltestQUEUE_LENGTH, sizeof( uint32_t ) );
+    TEST_ASSERT_NOT_NULL( xQueue );
+
+    if( TEST_PROTECT() )
+    {
+        /* The critical section stands in for an interrupt. */
+        taskENTER_CRITICAL();
+        {
+            xSent = xQueueSendMultipleFromISR( xQueue, ulItems, kerneltestQUEUE_LENGTH + 2, &xHigherPriorityTaskWoken );
+            xSentWhenFull = xQueueSendMultipleFromISR( xQueue, ulItems, 1, &xHigherPriorityTaskWoken );
+            xReceived = xQueueReceiveMultipleFromISR( xQueue, ulBuffer, kerneltestQUEUE_LENGTH + 2, &xHigherPriorityTaskWoken );
+            xReceivedWhenEmpty = xQueueReceiveMultipleFromISR( xQueue, ulBuffer, 1, NULL );
+        }
+        taskEXIT_CRITICAL();
+
+        TEST_ASSERT_EQUAL( kerneltestQUEUE_LENGTH, xSent );
+        TEST_ASSERT_EQUAL( 0, xSentWhenFull );
+        TEST_ASSERT_EQUAL( kerneltestQUEUE_LENGTH, xReceived );
+        TEST_ASSERT_EQUAL( 0, xReceivedWhenEmpty );
+        TEST_ASSERT_EQUAL( pdFALSE, xHigherPriorityTaskWoken );
+        TEST_ASSERT_EQUAL_UINT32_ARRAY( ulItems, ulBuffer, kerneltestQUEUE_LENGTH );
+    }
+
+    vQueueDelete( xQueue );
+}
+
+/*-----------------------------------------------------------*/
+
+#if ( configGENERATE_RUN_TIME_STATS == 1 )
+
+/*
+ * Moves kerneltestBENCH_ITEMS items through xQueue in rounds of xBatch items,
+ * either one item per call or one batch per call, and returns the elapsed
+ * run time counter.
+ */
+    static uint32_t prvMeasureQueueThroughput( QueueHandle_t xQueue,
+                                               size_t xItemSize,
+                                               size_t xBatch,
+                                               BaseType_t xUseBatchCalls )
+    {
+        uint32_t ulStart, ulRound, ulItem;
+        size_t xMoved;
+
+        ulStart = ( uint32_t ) portGET_RUN_TIME_COUNTER_VALUE();
+
+        for( ulRound = 0; ulRound < ( kerneltestBENCH_ITEMS / xBatch ); ulRound++ )
+        {
+            if( xUseBatchCalls != pdFALSE )
+            {
+                xMoved = xQueueSendMultiple( xQueue, ucBenchItems, xBatch, 0 );
+                xMoved = xQueueReceiveMultiple( xQueue, ucBenchBuffer, xMoved, 0 );
+            }
+            else
+            {
+                xMoved = 0;
+
+                for( ulItem = 0; ulItem < xBatch; ulItem++ )
+                {
+                    xMoved += ( size_t ) xQueueSend( xQueue, &( ucBenchItems[ ulItem * xItemSize ] ), 0 );
+                }
+
+                for( ulItem = 0; ulItem < xBatch; ulItem++ )
+                {
+                    ( void ) xQueueReceive( xQueue, &( ucBenchBuffer[ ulItem * xItemSize ] ), 0 );
+                }
+            }
+
+            configASSERT( xMoved == xBatch );
+        }
+
+        return ( uint32_t ) portGET_RUN_TIME_COUNTER_VALUE() - ulStart;
+    }
+
+#endif /* if ( configGENERATE_RUN_TIME_STATS == 1 ) */
+
+/*-----------------------------------------------------------*/
+
+TEST( Full_KERNEL_QUEUE, throughput_single_vs_batch )
+{
+    #if ( configGENERATE_RUN_TIME_STATS == 1 )
+        static const size_t xItemSizes[] = { 4, 32, kerneltestBENCH_MAX_ITEM_SIZE };
+        static const size_t xBatchSizes[] = { 1, 4, 16, kerneltestBENCH_QUEUE_LENGTH };
+        QueueHandle_t xQueue;
+        uint32_t ulSingle, ulBatch;
+        size_t xSize, xBatch, xIndex;
+
+        for( xIndex = 0; xIndex < sizeof( ucBenchItems ); xIndex++ )
+        {
+            ucBenchItems[ xIndex ] = ( uint8_t ) xIndex;
+        }
+
+        for( xSize = 0; xSize < ( sizeof( xItemSizes ) / sizeof( xItemSizes[ 0 ] ) ); xSize++ )
+        {
+            xQueue = xQueueCreate( kerneltestBENCH_QUEUE_LENGTH, xItemSizes[ xSize ] );
+            TEST_ASSERT_NOT_NULL( xQueue );
+
+            for( xBatch = 0; xBatch < ( sizeof( xBatchSizes ) / sizeof( xBatchSizes[ 0 ] ) ); xBatch++ )
+            {
+                ulSingle = prvMeasureQueueThroughput( xQueue, xItemSizes[ xSize ], xBatchSizes[ xBatch ], pdFALSE );
+                ulBatch = prvMeasureQueueThroughput( xQueue, xItemSizes[ xSize ], xBatchSizes[ xBatch ], pdTRUE );
+
+                configPRINTF( ( "Queue throughput: %u items of %u bytes in batches of %u: run time %u one at a time, %u batched\r\n",
+                                ( unsigned ) kerneltestBENCH_ITEMS,
+                                ( unsigned ) xItemSizes[ xSize ],
+                                ( unsigned ) xBatchSizes[ xBatch ],
+                                ( unsigned ) ulSingle,
+                                ( unsigned ) ulBatch ) );
+            }
+
+            /* The last batch must have arrived intact. */
+            TEST_ASSERT_EQUAL_MEMORY( ucBenchItems, ucBenchBuffer, kerneltestBENCH_QUEUE_LENGTH * xItemSizes[ xSize ] );
+            TEST_ASSERT_EQUAL( 0, uxQueueMessagesWaiting( xQueue ) );
+            vQueueDelete( xQueue );
+        }
+    #else /* if ( configGENERATE_RUN_TIME_STATS == 1 ) */
+        TEST_IGNORE_MESSAGE( "configGENERATE_RUN_TIME_STATS is required" );
+    #endif /* if ( configGENERATE_RUN_TIME_STATS == 1 ) */
+}
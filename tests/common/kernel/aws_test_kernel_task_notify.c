@@ -0,0 +1,205 @@
+/*
+ * Amazon FreeRTOS
+ * Copyright (C) 2018 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+/**
+ * @file aws_test_kernel_task_notify.c
+ * @brief Tests for indexed task notifications.
+ */
+
+/* Standard includes. */
+#include <stdint.h>
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+
+/* Test includes. */
+#include "unity_fixture.h"
+#include "unity.h"
+
+/**
+ * @brief Configuration for this test group.
+ */
+#define kerneltestNOTIFY_INDEX        ( configTASK_NOTIFICATION_ARRAY_ENTRIES - 1 )
+#define kerneltestNOTIFY_TIMEOUT      pdMS_TO_TICKS( 1000 )
+#define kerneltestNOTIFY_VALUE        0x5a5a0000UL
+
+/*
+ * @brief Test group definition.
+ */
+TEST_GROUP( Full_KERNEL_TASK_NOTIFY );
+
+TEST_SETUP( Full_KERNEL_TASK_NOTIFY )
+{
+    UBaseType_t uxIndex;
+
+    /* Earlier test groups may have left notifications pending. */
+    for( uxIndex = 0; uxIndex < configTASK_NOTIFICATION_ARRAY_ENTRIES; uxIndex++ )
+    {
+        ( void ) xTaskNotifyStateClearIndexed( NULL, uxIndex );
+        ( void ) ulTaskNotifyValueClearIndexed( NULL, uxIndex, UINT32_MAX );
+    }
+}
+
+TEST_TEAR_DOWN( Full_KERNEL_TASK_NOTIFY )
+{
+}
+
+TEST_GROUP_RUNNER( Full_KERNEL_TASK_NOTIFY )
+{
+    #if ( configTASK_NOTIFICATION_ARRAY_ENTRIES > 1 )
+        RUN_TEST_CASE( Full_KERNEL_TASK_NOTIFY, indices_hold_separate_values );
+        RUN_TEST_CASE( Full_KERNEL_TASK_NOTIFY, waiter_ignores_other_indices );
+        RUN_TEST_CASE( Full_KERNEL_TASK_NOTIFY, IndexedFromISR );
+    #endif
+    RUN_TEST_CASE( Full_KERNEL_TASK_NOTIFY, ValueClear_returns_previous_value );
+}
+
+/*-----------------------------------------------------------*/
+
+#if ( configTASK_NOTIFICATION_ARRAY_ENTRIES > 1 )
+
+    static TaskHandle_t xWaitingTask;
+    static volatile BaseType_t xWaitResult;
+    static volatile uint32_t ulWaitValue;
+
+/*-----------------------------------------------------------*/
+
+    static void prvWaitOnIndexTask( void * pvParameters )
+    {
+        uint32_t ulValue = 0;
+
+        ( void ) pvParameters;
+
+        xWaitResult = xTaskNotifyWaitIndexed( kerneltestNOTIFY_INDEX, 0UL, UINT32_MAX, &ulValue, kerneltestNOTIFY_TIMEOUT );
+        ulWaitValue = ulValue;
+
+        xTaskNotifyGive( xWaitingTask );
+        vTaskDelete( NULL );
+    }
+
+/*-----------------------------------------------------------*/
+
+    TEST( Full_KERNEL_TASK_NOTIFY, indices_hold_separate_values )
+    {
+        TaskHandle_t xSelf = xTaskGetCurrentTaskHandle();
+        uint32_t ulPrevious = 0;
+
+        /* A count given on the private index is not seen on the default index. */
+        TEST_ASSERT_EQUAL( pdPASS, xTaskNotifyGiveIndexed( xSelf, kerneltestNOTIFY_INDEX ) );
+        TEST_ASSERT_EQUAL( pdPASS, xTaskNotifyGiveIndexed( xSelf, kerneltestNOTIFY_INDEX ) );
+        TEST_ASSERT_EQUAL_UINT32( 0, ulTaskNotifyTake( pdTRUE, 0 ) );
+        TEST_ASSERT_EQUAL_UINT32( 2, ulTaskNotifyTakeIndexed( kerneltestNOTIFY_INDEX, pdFALSE, 0 ) );
+        TEST_ASSERT_EQUAL_UINT32( 1, ulTaskNotifyTakeIndexed( kerneltestNOTIFY_INDEX, pdFALSE, 0 ) );
+        TEST_ASSERT_EQUAL_UINT32( 0, ulTaskNotifyTakeIndexed( kerneltestNOTIFY_INDEX, pdFALSE, 0 ) );
+
+        /* eSetValueWithoutOverwrite only fails on the index that is pending. */
+        TEST_ASSERT_EQUAL( pdPASS, xTaskNotifyIndexed( xSelf, kerneltestNOTIFY_INDEX, kerneltestNOTIFY_VALUE, eSetValueWithoutOverwrite ) );
+        TEST_ASSERT_EQUAL( pdFAIL, xTaskNotifyIndexed( xSelf, kerneltestNOTIFY_INDEX, 1, eSetValueWithoutOverwrite ) );
+        TEST_ASSERT_EQUAL( pdPASS, xTaskNotify( xSelf, 1, eSetValueWithoutOverwrite ) );
+        TEST_ASSERT_EQUAL( pdPASS, xTaskNotifyAndQueryIndexed( xSelf, kerneltestNOTIFY_INDEX, 0x3UL, eSetBits, &ulPrevious ) );
+        TEST_ASSERT_EQUAL_HEX32( kerneltestNOTIFY_VALUE, ulPrevious );
+
+        /* Clearing the state of one index leaves the other pending. */
+        TEST_ASSERT_EQUAL( pdTRUE, xTaskNotifyStateClearIndexed( NULL, kerneltestNOTIFY_INDEX ) );
+        TEST_ASSERT_EQUAL( pdFALSE, xTaskNotifyWaitIndexed( kerneltestNOTIFY_INDEX, 0UL, 0UL, &ulPrevious, 0 ) );
+        TEST_ASSERT_EQUAL_HEX32( kerneltestNOTIFY_VALUE | 0x3UL, ulPrevious );
+        TEST_ASSERT_EQUAL( pdTRUE, xTaskNotifyWait( 0UL, UINT32_MAX, &ulPrevious, 0 ) );
+        TEST_ASSERT_EQUAL_UINT32( 1, ulPrevious );
+    }
+
+/*-----------------------------------------------------------*/
+
+    TEST( Full_KERNEL_TASK_NOTIFY, waiter_ignores_other_indices )
+    {
+        TaskHandle_t xWaiter = NULL;
+
+        xWaitingTask = xTaskGetCurrentTaskHandle();
+        xWaitResult = pdFAIL;
+        ulWaitValue = 0;
+
+        /* The waiter has a higher priority, so blocks as soon as it is created. */
+        TEST_ASSERT_EQUAL( pdPASS, xTaskCreate( prvWaitOnIndexTask,
+                                                "NtfyWait",
+                                                configMINIMAL_STACK_SIZE * 2,
+                                                NULL,
+                                                uxTaskPriorityGet( NULL ) + 1,
+                                                &xWaiter ) );
+        TEST_ASSERT_EQUAL( eBlocked, eTaskGetState( xWaiter ) );
+
+        /* A notification on the default index leaves the waiter blocked. */
+        TEST_ASSERT_EQUAL( pdPASS, xTaskNotify( xWaiter, 1, eSetValueWithOverwrite ) );
+        TEST_ASSERT_EQUAL( eBlocked, eTaskGetState( xWaiter ) );
+
+        /* A notification on the index it waits on unblocks it immediately. */
+        TEST_ASSERT_EQUAL( pdPASS, xTaskNotifyIndexed( xWaiter, kerneltestNOTIFY_INDEX, kerneltestNOTIFY_VALUE, eSetBits ) );
+        TEST_ASSERT_EQUAL_UINT32( 1, ulTaskNotifyTake( pdTRUE, kerneltestNOTIFY_TIMEOUT * 2 ) );
+        TEST_ASSERT_EQUAL( pdTRUE, xWaitResult );
+        TEST_ASSERT_EQUAL_HEX32( kerneltestNOTIFY_VALUE, ulWaitValue );
+
+        /* Let the idle task free the waiter. */
+        vTaskDelay( pdMS_TO_TICKS( 10 ) );
+    }
+
+/*-----------------------------------------------------------*/
+
+    TEST( Full_KERNEL_TASK_NOTIFY, IndexedFromISR )
+    {
+        TaskHandle_t xSelf = xTaskGetCurrentTaskHandle();
+        BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+        uint32_t ulPrevious = 0;
+
+        /* The critical section stands in for an interrupt. */
+        taskENTER_CRITICAL();
+        {
+            vTaskNotifyGiveIndexedFromISR( xSelf, kerneltestNOTIFY_INDEX, &xHigherPriorityTaskWoken );
+            ( void ) xTaskNotifyAndQueryIndexedFromISR( xSelf, kerneltestNOTIFY_INDEX, 0x10UL, eSetBits, &ulPrevious, &xHigherPriorityTaskWoken );
+        }
+        taskEXIT_CRITICAL();
+
+        TEST_ASSERT_EQUAL( pdFALSE, xHigherPriorityTaskWoken );
+        TEST_ASSERT_EQUAL_UINT32( 1, ulPrevious );
+        TEST_ASSERT_EQUAL_UINT32( 0, ulTaskNotifyTake( pdTRUE, 0 ) );
+        TEST_ASSERT_EQUAL_UINT32( 0x11UL, ulTaskNotifyTakeIndexed( kerneltestNOTIFY_INDEX, pdTRUE, 0 ) );
+    }
+
+#endif /* if ( configTASK_NOTIFICATION_ARRAY_ENTRIES > 1 ) */
+
+/*-----------------------------------------------------------*/
+
+TEST( Full_KERNEL_TASK_NOTIFY, ValueClear_returns_previous_value )
+{
+    TaskHandle_t xSelf = xTaskGetCurrentTaskHandle();
+
+    TEST_ASSERT_EQUAL( pdPASS, xTaskNotify( xSelf, 0xf0UL, eSetBits ) );
+
+    /* Clearing bits does not consume the notification. */
+    TEST_ASSERT_EQUAL_HEX32( 0xf0UL, ulTaskNotifyValueClear( NULL, 0x30UL ) );
+    TEST_ASSERT_EQUAL_HEX32( 0xc0UL, ulTaskNotifyValueClear( xSelf, 0UL ) );
+    TEST_ASSERT_EQUAL( pdTRUE, xTaskNotifyStateClear( NULL ) );
+    TEST_ASSERT_EQUAL( pdFALSE, xTaskNotifyStateClear( NULL ) );
+    TEST_ASSERT_EQUAL_HEX32( 0xc0UL, ulTaskNotifyValueClear( NULL, UINT32_MAX ) );
+    TEST_ASSERT_EQUAL_UINT32( 0, ulTaskNotifyTake( pdTRUE, 0 ) );
+}
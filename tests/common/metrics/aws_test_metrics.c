@@ -0,0 +1,305 @@
+/*
+ * Amazon FreeRTOS
+ * Copyright (C) 2018 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+/**
+ * @file aws_test_metrics.c
+ * @brief Tests for the metrics reports.
+ */
+
+/* Standard includes. */
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+
+/* Metrics includes. */
+#include "aws_metrics_config.h"
+#include "aws_metrics_config_defaults.h"
+#include "aws_metrics_report.h"
+
+/* CBOR parser. */
+#include "cbor.h"
+
+/* Test includes. */
+#include "unity_fixture.h"
+#include "unity.h"
+
+/**
+ * @brief Configuration for this test group.
+ */
+#define metricstestTIMEOUT        pdMS_TO_TICKS( 1000 )
+#define metricstestSPIN_TICKS     pdMS_TO_TICKS( 50 )
+#define metricstestTASK_NAME      "MetricsSpin"
+#define metricstestBUFFER_SIZE    ( 2048 )
+
+/*
+ * @brief Test group definition.
+ */
+TEST_GROUP( Full_METRICS );
+
+TEST_SETUP( Full_METRICS )
+{
+}
+
+TEST_TEAR_DOWN( Full_METRICS )
+{
+}
+
+TEST_GROUP_RUNNER( Full_METRICS )
+{
+    RUN_TEST_CASE( Full_METRICS, report_gives_cpu_deltas );
+    RUN_TEST_CASE( Full_METRICS, small_buffer_fails );
+    RUN_TEST_CASE( Full_METRICS, failed_report_keeps_cpu_deltas );
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief The figures of one task, as found in a report.
+ */
+typedef struct TaskFigures
+{
+    uint64_t ullRunTime;
+    uint64_t ullStackHighWaterMark;
+} TaskFigures_t;
+
+static uint8_t ucReport[ metricstestBUFFER_SIZE ];
+static TaskHandle_t xTestTask;
+
+/*-----------------------------------------------------------*/
+
+static void prvSpinTask( void * pvParameters )
+{
+    TickType_t xStart;
+
+    ( void ) pvParameters;
+
+    for( ; ; )
+    {
+        ( void ) ulTaskNotifyTake( pdTRUE, portMAX_DELAY );
+
+        /* Keep the CPU busy, so that the run time of this task grows. */
+        xStart = xTaskGetTickCount();
+
+        while( ( xTaskGetTickCount() - xStart ) < metricstestSPIN_TICKS )
+        {
+        }
+
+        xTaskNotifyGive( xTestTask );
+    }
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Checks the header entries of a report and finds a task in it.
+ *
+ * @param[in] xReportSize The size of the report in ucReport.
+ * @param[in] pcName The name of the task to find.
+ * @param[out] pxFigures The figures of the task.
+ *
+ * @return pdTRUE if the task is listed, pdFALSE otherwise.
+ */
+static BaseType_t prvFindTask( size_t xReportSize,
+                               const char * pcName,
+                               TaskFigures_t * pxFigures )
+{
+    CborParser xParser;
+    CborValue xMap, xValue, xTasks, xTask;
+    uint64_t ullValue;
+    char cName[ configMAX_TASK_NAME_LEN + 1 ];
+    size_t xNameLength;
+    BaseType_t xFound = pdFALSE;
+
+    TEST_ASSERT_EQUAL( CborNoError, cbor_parser_init( ucReport, xReportSize, 0, &xParser, &xMap ) );
+    TEST_ASSERT_TRUE( cbor_value_is_map( &xMap ) );
+
+    TEST_ASSERT_EQUAL( CborNoError, cbor_value_map_find_value( &xMap, metricsKEY_VERSION, &xValue ) );
+    TEST_ASSERT_EQUAL( CborNoError, cbor_value_get_uint64( &xValue, &ullValue ) );
+    TEST_ASSERT_EQUAL( metricsREPORT_VERSION, ullValue );
+
+    TEST_ASSERT_EQUAL( CborNoError, cbor_value_map_find_value( &xMap, metricsKEY_UPTIME, &xValue ) );
+    TEST_ASSERT_TRUE( cbor_value_is_unsigned_integer( &xValue ) );
+
+    TEST_ASSERT_EQUAL( CborNoError, cbor_value_map_find_value( &xMap, metricsKEY_RUN_TIME, &xValue ) );
+    TEST_ASSERT_TRUE( cbor_value_is_unsigned_integer( &xValue ) );
+
+    #if ( metricsconfigINCLUDE_NETWORK_BUFFERS == 1 )
+        TEST_ASSERT_EQUAL( CborNoError, cbor_value_map_find_value( &xMap, metricsKEY_NETWORK_BUFFERS, &xValue ) );
+        TEST_ASSERT_TRUE( cbor_value_is_array( &xValue ) );
+    #endif
+
+    TEST_ASSERT_EQUAL( CborNoError, cbor_value_map_find_value( &xMap, metricsKEY_TASKS, &xTasks ) );
+    TEST_ASSERT_TRUE( cbor_value_is_array( &xTasks ) );
+    TEST_ASSERT_EQUAL( CborNoError, cbor_value_enter_container( &xTasks, &xTask ) );
+
+    while( cbor_value_at_end( &xTask ) == false )
+    {
+        TEST_ASSERT_TRUE( cbor_value_is_array( &xTask ) );
+        TEST_ASSERT_EQUAL( CborNoError, cbor_value_enter_container( &xTask, &xValue ) );
+
+        xNameLength = sizeof( cName );
+        TEST_ASSERT_EQUAL( CborNoError, cbor_value_copy_text_string( &xValue, cName, &xNameLength, &xValue ) );
+
+        if( strcmp( cName, pcName ) == 0 )
+        {
+            TEST_ASSERT_EQUAL( CborNoError, cbor_value_get_uint64( &xValue, &pxFigures->ullRunTime ) );
+            TEST_ASSERT_EQUAL( CborNoError, cbor_value_advance( &xValue ) );
+            TEST_ASSERT_EQUAL( CborNoError, cbor_value_get_uint64( &xValue, &pxFigures->ullStackHighWaterMark ) );
+            xFound = pdTRUE;
+        }
+
+        /* Skip to the next task. */
+        while( cbor_value_at_end( &xValue ) == false )
+        {
+            TEST_ASSERT_EQUAL( CborNoError, cbor_value_advance( &xValue ) );
+        }
+
+        TEST_ASSERT_EQUAL( CborNoError, cbor_value_leave_container( &xTask, &xValue ) );
+    }
+
+    return xFound;
+}
+
+/*-----------------------------------------------------------*/
+
+TEST( Full_METRICS, report_gives_cpu_deltas )
+{
+    TaskHandle_t xSpinTask = NULL;
+    TaskFigures_t xFigures;
+    size_t xReportSize = 0;
+
+    xTestTask = xTaskGetCurrentTaskHandle();
+    TEST_ASSERT_EQUAL( pdPASS, xTaskCreate( prvSpinTask,
+                                            metricstestTASK_NAME,
+                                            configMINIMAL_STACK_SIZE,
+                                            NULL,
+                                            uxTaskPriorityGet( NULL ) + 1,
+                                            &xSpinTask ) );
+
+    if( TEST_PROTECT() )
+    {
+        /* Start the deltas from here. */
+        TEST_ASSERT_EQUAL( pdPASS, METRICS_CreateReport( ucReport, sizeof( ucReport ), &xReportSize ) );
+
+        xTaskNotifyGive( xSpinTask );
+        TEST_ASSERT_NOT_EQUAL( 0, ulTaskNotifyTake( pdTRUE, metricstestTIMEOUT ) );
+
+        TEST_ASSERT_EQUAL( pdPASS, METRICS_CreateReport( ucReport, sizeof( ucReport ), &xReportSize ) );
+        configPRINTF( ( "Metrics report of %u tasks: %u bytes.\r\n",
+                        ( unsigned ) uxTaskGetNumberOfTasks(), ( unsigned ) xReportSize ) );
+
+        TEST_ASSERT_EQUAL( pdTRUE, prvFindTask( xReportSize, metricstestTASK_NAME, &xFigures ) );
+        TEST_ASSERT_TRUE( xFigures.ullStackHighWaterMark > 0 );
+
+        #if ( configGENERATE_RUN_TIME_STATS == 1 )
+        {
+            uint64_t ullSpinRunTime = xFigures.ullRunTime;
+            TaskStatus_t xStatus;
+
+            TEST_ASSERT_TRUE( ullSpinRunTime > 0 );
+
+            /* The task has been blocked since, so the next delta is small. */
+            TEST_ASSERT_EQUAL( pdPASS, METRICS_CreateReport( ucReport, sizeof( ucReport ), &xReportSize ) );
+            TEST_ASSERT_EQUAL( pdTRUE, prvFindTask( xReportSize, metricstestTASK_NAME, &xFigures ) );
+            configPRINTF( ( "Metrics run time deltas of the spinning task: %u, then %u blocked.\r\n",
+                            ( unsigned ) ullSpinRunTime, ( unsigned ) xFigures.ullRunTime ) );
+            TEST_ASSERT_TRUE( xFigures.ullRunTime < ullSpinRunTime / 10 );
+
+            /* The reports carry deltas rather than totals, so together they
+             * account for no more than the total the kernel keeps. */
+            vTaskGetInfo( xSpinTask, &xStatus, pdFALSE, eInvalid );
+            TEST_ASSERT_TRUE( ( ullSpinRunTime + xFigures.ullRunTime ) <= ( uint64_t ) xStatus.ulRunTimeCounter );
+        }
+        #endif
+    }
+
+    vTaskDelete( xSpinTask );
+}
+
+/*-----------------------------------------------------------*/
+
+TEST( Full_METRICS, small_buffer_fails )
+{
+    size_t xReportSize = 0;
+
+    TEST_ASSERT_EQUAL( pdPASS, METRICS_CreateReport( ucReport, sizeof( ucReport ), &xReportSize ) );
+    TEST_ASSERT_TRUE( xReportSize > 0 );
+
+    /* The encoding stops at the end of the buffer rather than overflowing. */
+    TEST_ASSERT_EQUAL( pdFAIL, METRICS_CreateReport( ucReport, xReportSize / 2, &xReportSize ) );
+}
+
+/*-----------------------------------------------------------*/
+
+TEST( Full_METRICS, failed_report_keeps_cpu_deltas )
+{
+    #if ( configGENERATE_RUN_TIME_STATS == 1 )
+        TaskHandle_t xSpinTask = NULL;
+        TaskFigures_t xFigures;
+        TaskStatus_t xStatus;
+        size_t xReportSize = 0;
+        uint32_t ulRunTimeBefore;
+
+        xTestTask = xTaskGetCurrentTaskHandle();
+        TEST_ASSERT_EQUAL( pdPASS, xTaskCreate( prvSpinTask,
+                                                metricstestTASK_NAME,
+                                                configMINIMAL_STACK_SIZE,
+                                                NULL,
+                                                uxTaskPriorityGet( NULL ) + 1,
+                                                &xSpinTask ) );
+
+        if( TEST_PROTECT() )
+        {
+            /* Start the deltas from here.  The spinning task is blocked
+             * whenever this task runs, so its run time counter only moves
+             * while it spins. */
+            TEST_ASSERT_EQUAL( pdPASS, METRICS_CreateReport( ucReport, sizeof( ucReport ), &xReportSize ) );
+            vTaskGetInfo( xSpinTask, &xStatus, pdFALSE, eInvalid );
+            ulRunTimeBefore = xStatus.ulRunTimeCounter;
+
+            xTaskNotifyGive( xSpinTask );
+            TEST_ASSERT_NOT_EQUAL( 0, ulTaskNotifyTake( pdTRUE, metricstestTIMEOUT ) );
+
+            /* A report that does not fit is not sent, so its figures must
+             * not become the baselines of the next one. */
+            TEST_ASSERT_EQUAL( pdFAIL, METRICS_CreateReport( ucReport, xReportSize / 2, &xReportSize ) );
+
+            TEST_ASSERT_EQUAL( pdPASS, METRICS_CreateReport( ucReport, sizeof( ucReport ), &xReportSize ) );
+            TEST_ASSERT_EQUAL( pdTRUE, prvFindTask( xReportSize, metricstestTASK_NAME, &xFigures ) );
+
+            vTaskGetInfo( xSpinTask, &xStatus, pdFALSE, eInvalid );
+            TEST_ASSERT_TRUE( xFigures.ullRunTime > 0 );
+            TEST_ASSERT_EQUAL_UINT32( xStatus.ulRunTimeCounter - ulRunTimeBefore, ( uint32_t ) xFigures.ullRunTime );
+        }
+
+        vTaskDelete( xSpinTask );
+    #else /* if ( configGENERATE_RUN_TIME_STATS == 1 ) */
+        TEST_IGNORE_MESSAGE( "configGENERATE_RUN_TIME_STATS is required" );
+    #endif /* if ( configGENERATE_RUN_TIME_STATS == 1 ) */
+}
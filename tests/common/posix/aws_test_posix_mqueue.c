@@ -91,6 +91,7 @@ TEST_GROUP_RUNNER( Full_POSIX_MQUEUE )
     RUN_TEST_CASE( Full_POSIX_MQUEUE, mq_unlink_invalid_params );
     RUN_TEST_CASE( Full_POSIX_MQUEUE, mq_getattr );
     RUN_TEST_CASE( Full_POSIX_MQUEUE, mq_send_receive );
+    RUN_TEST_CASE( Full_POSIX_MQUEUE, mq_send_receive_priority );
     /*RUN_TEST_CASE( Full_POSIX_MQUEUE, mq_send_receive_invalidParams ); */
     RUN_TEST_CASE( Full_POSIX_MQUEUE, mq_send_receive_nonblock );
 }
@@ -451,6 +452,60 @@ TEST( Full_POSIX_MQUEUE, mq_send_receive )
 
 /*-----------------------------------------------------------*/
 
+TEST( Full_POSIX_MQUEUE, mq_send_receive_priority )
+{
+    int iStatus = 0;
+    unsigned uPriority = 0;
+    volatile mqd_t xMqId = posixtestMQ_INVALID_MQD;
+    char pcReceiveBuffer[ posixtestMQ_SMALL_MESSAGE_SIZE ] = { 0 };
+
+    if( TEST_PROTECT() )
+    {
+        /* Create queue with default parameters. */
+        xMqId = mq_open( posixtestMQ_DEFAULT_NAME,
+                         O_CREAT | O_RDWR,
+                         posixtestMQ_DEFAULT_MODE,
+                         &xDefaultQueueAttr );
+        TEST_ASSERT_NOT_EQUAL( posixtestMQ_INVALID_MQD, xMqId );
+
+        /* Priorities of MQ_PRIO_MAX and above are not supported. */
+        iStatus = mq_send( xMqId, "A", sizeof( "A" ), MQ_PRIO_MAX );
+        TEST_ASSERT_EQUAL_INT( -1, iStatus );
+        TEST_ASSERT_EQUAL_INT( EINVAL, errno );
+
+        /* Send two low priority messages around a high priority one. */
+        iStatus = mq_send( xMqId, "A", sizeof( "A" ), 1 );
+        TEST_ASSERT_EQUAL_INT( 0, iStatus );
+        iStatus = mq_send( xMqId, "B", sizeof( "B" ), MQ_PRIO_MAX - 1 );
+        TEST_ASSERT_EQUAL_INT( 0, iStatus );
+        iStatus = mq_send( xMqId, "C", sizeof( "C" ), 1 );
+        TEST_ASSERT_EQUAL_INT( 0, iStatus );
+
+        /* The high priority message must be received first. */
+        iStatus = ( int ) mq_receive( xMqId, pcReceiveBuffer, posixtestMQ_SMALL_MESSAGE_SIZE, &uPriority );
+        TEST_ASSERT_EQUAL_INT( sizeof( "B" ), iStatus );
+        TEST_ASSERT_EQUAL_STRING( "B", pcReceiveBuffer );
+        TEST_ASSERT_EQUAL_UINT( MQ_PRIO_MAX - 1, uPriority );
+
+        /* Messages of the same priority must be received in the order sent. */
+        iStatus = ( int ) mq_receive( xMqId, pcReceiveBuffer, posixtestMQ_SMALL_MESSAGE_SIZE, &uPriority );
+        TEST_ASSERT_EQUAL_INT( sizeof( "A" ), iStatus );
+        TEST_ASSERT_EQUAL_STRING( "A", pcReceiveBuffer );
+        TEST_ASSERT_EQUAL_UINT( 1, uPriority );
+
+        iStatus = ( int ) mq_receive( xMqId, pcReceiveBuffer, posixtestMQ_SMALL_MESSAGE_SIZE, &uPriority );
+        TEST_ASSERT_EQUAL_INT( sizeof( "C" ), iStatus );
+        TEST_ASSERT_EQUAL_STRING( "C", pcReceiveBuffer );
+        TEST_ASSERT_EQUAL_UINT( 1, uPriority );
+    }
+
+    /* Close and unlink the message queue. */
+    ( void ) mq_close( xMqId );
+    ( void ) mq_unlink( posixtestMQ_DEFAULT_NAME );
+}
+
+/*-----------------------------------------------------------*/
+
 TEST( Full_POSIX_MQUEUE, mq_send_receive_invalid_params )
 {
     int iStatus = 0;
@@ -48,6 +48,7 @@
 /**@{ */
 #define posixtestPTHREAD_DETACHED_WAIT_MILLISECONDS          ( 100000000 ) /**< How long to wait for a detached thread to finish. */
 #define posixtestPTHREAD_COND_BROADCAST_NUMBER_OF_THREADS    ( 4 )         /**< Number of threads that wait on a pthread_cond_broadcast. */
+#define posixtestPTHREAD_RWLOCK_WRITER_WAIT_MILLISECONDS     ( 100 )       /**< How long to wait for a writer thread to block in pthread_rwlock_wrlock. */
 /**@} */
 
 /**
@@ -93,6 +94,28 @@ static void * prvUnlockMutexThread( void * pvArgs )
 
 /*-----------------------------------------------------------*/
 
+static void * prvWriteLockThread( void * pvArgs )
+{
+    pthread_rwlock_t * pxRwlock = ( pthread_rwlock_t * ) pvArgs;
+    intptr_t xStatus = 0;
+
+    /* Lock the read-write lock for writing, then unlock it and exit. */
+    xStatus = ( intptr_t ) pthread_rwlock_wrlock( pxRwlock );
+
+    if( xStatus == 0 )
+    {
+        xStatus = ( intptr_t ) pthread_rwlock_unlock( pxRwlock );
+    }
+
+    pthread_exit( ( void * ) xStatus );
+
+    /* Silence compiler warnings about return values. This line will never be
+     * reached. */
+    return NULL;
+}
+
+/*-----------------------------------------------------------*/
+
 static void * prvBarrierThread( void * pvArgs )
 {
     pthread_barrier_t * pxBarrier = ( pthread_barrier_t * ) pvArgs;
@@ -289,6 +312,8 @@ TEST_GROUP_RUNNER( Full_POSIX_PTHREAD )
     RUN_TEST_CASE( Full_POSIX_PTHREAD, pthread_attr_init_destroy );
     RUN_TEST_CASE( Full_POSIX_PTHREAD, pthread_mutex_lock_unlock );
     RUN_TEST_CASE( Full_POSIX_PTHREAD, pthread_mutex_trylock_timedlock );
+    RUN_TEST_CASE( Full_POSIX_PTHREAD, pthread_rwlock_rdlock_wrlock );
+    RUN_TEST_CASE( Full_POSIX_PTHREAD, pthread_rwlock_writer_preference );
     RUN_TEST_CASE( Full_POSIX_PTHREAD, pthread_barrier );
     RUN_TEST_CASE( Full_POSIX_PTHREAD, pthread_cond_signal );
     RUN_TEST_CASE( Full_POSIX_PTHREAD, pthread_cond_broadcast );
@@ -471,6 +496,143 @@ TEST( Full_POSIX_PTHREAD, pthread_mutex_trylock_timedlock )
 
 /*-----------------------------------------------------------*/
 
+TEST( Full_POSIX_PTHREAD, pthread_rwlock_rdlock_wrlock )
+{
+    int iStatus = 0;
+    volatile BaseType_t xRwlockCreated = pdFALSE;
+    pthread_rwlock_t xRwlock;
+    pthread_rwlock_t xStaticRwlock = PTHREAD_RWLOCK_INITIALIZER;
+    struct timespec xTimeout;
+
+    /* Check a statically initialized read-write lock can be locked and
+     * unlocked. */
+    iStatus = pthread_rwlock_wrlock( &xStaticRwlock );
+    TEST_ASSERT_EQUAL_INT( 0, iStatus );
+    iStatus = pthread_rwlock_unlock( &xStaticRwlock );
+    TEST_ASSERT_EQUAL_INT( 0, iStatus );
+
+    if( TEST_PROTECT() )
+    {
+        iStatus = pthread_rwlock_init( &xRwlock, NULL );
+        TEST_ASSERT_EQUAL_INT( 0, iStatus );
+        xRwlockCreated = pdTRUE;
+
+        /* Unlocking a read-write lock that isn't held fails. */
+        iStatus = pthread_rwlock_unlock( &xRwlock );
+        TEST_ASSERT_EQUAL_INT( EPERM, iStatus );
+
+        /* Any number of read locks may be held at once. */
+        iStatus = pthread_rwlock_rdlock( &xRwlock );
+        TEST_ASSERT_EQUAL_INT( 0, iStatus );
+        iStatus = pthread_rwlock_tryrdlock( &xRwlock );
+        TEST_ASSERT_EQUAL_INT( 0, iStatus );
+
+        /* The write lock can't be taken while a read lock is held. */
+        iStatus = pthread_rwlock_trywrlock( &xRwlock );
+        TEST_ASSERT_EQUAL_INT( EBUSY, iStatus );
+
+        /* Set an absolute timeout of 100 ms. */
+        ( void ) clock_gettime( CLOCK_REALTIME, &xTimeout );
+        ( void ) UTILS_TimespecAddNanoseconds( &xTimeout, &xTimeout, 100000000LL );
+
+        iStatus = pthread_rwlock_timedwrlock( &xRwlock, &xTimeout );
+        TEST_ASSERT_EQUAL_INT( ETIMEDOUT, iStatus );
+
+        /* A read-write lock that is held can't be destroyed. */
+        iStatus = pthread_rwlock_destroy( &xRwlock );
+        TEST_ASSERT_EQUAL_INT( EBUSY, iStatus );
+
+        /* Once both read locks are released, the write lock can be taken. */
+        iStatus = pthread_rwlock_unlock( &xRwlock );
+        TEST_ASSERT_EQUAL_INT( 0, iStatus );
+        iStatus = pthread_rwlock_unlock( &xRwlock );
+        TEST_ASSERT_EQUAL_INT( 0, iStatus );
+
+        iStatus = pthread_rwlock_trywrlock( &xRwlock );
+        TEST_ASSERT_EQUAL_INT( 0, iStatus );
+
+        /* No other lock can be taken while the write lock is held. */
+        iStatus = pthread_rwlock_tryrdlock( &xRwlock );
+        TEST_ASSERT_EQUAL_INT( EBUSY, iStatus );
+
+        iStatus = pthread_rwlock_wrlock( &xRwlock );
+        TEST_ASSERT_EQUAL_INT( EDEADLK, iStatus );
+
+        ( void ) clock_gettime( CLOCK_REALTIME, &xTimeout );
+        ( void ) UTILS_TimespecAddNanoseconds( &xTimeout, &xTimeout, 100000000LL );
+
+        iStatus = pthread_rwlock_timedrdlock( &xRwlock, &xTimeout );
+        TEST_ASSERT_EQUAL_INT( ETIMEDOUT, iStatus );
+
+        /* Unlock the read-write lock so it can be destroyed. */
+        iStatus = pthread_rwlock_unlock( &xRwlock );
+        TEST_ASSERT_EQUAL_INT( 0, iStatus );
+    }
+
+    if( xRwlockCreated == pdTRUE )
+    {
+        iStatus = pthread_rwlock_destroy( &xRwlock );
+        TEST_ASSERT_EQUAL_INT( 0, iStatus );
+    }
+}
+
+/*-----------------------------------------------------------*/
+
+TEST( Full_POSIX_PTHREAD, pthread_rwlock_writer_preference )
+{
+    int iStatus = 0;
+    intptr_t xThreadReturnValue = 0;
+    volatile BaseType_t xThreadCreated = pdFALSE;
+    pthread_rwlock_t xRwlock;
+    pthread_t xNewThread;
+
+    iStatus = pthread_rwlock_init( &xRwlock, NULL );
+    TEST_ASSERT_EQUAL_INT( 0, iStatus );
+
+    if( TEST_PROTECT() )
+    {
+        iStatus = pthread_rwlock_rdlock( &xRwlock );
+        TEST_ASSERT_EQUAL_INT( 0, iStatus );
+
+        /* Create a thread that blocks waiting for the write lock. */
+        iStatus = pthread_create( &xNewThread, NULL, prvWriteLockThread, ( void * ) &xRwlock );
+        TEST_ASSERT_EQUAL_INT( 0, iStatus );
+        xThreadCreated = pdTRUE;
+
+        vTaskDelay( pdMS_TO_TICKS( posixtestPTHREAD_RWLOCK_WRITER_WAIT_MILLISECONDS ) );
+
+        /* New readers are refused while a writer is waiting, even though only
+         * read locks are held. */
+        iStatus = pthread_rwlock_tryrdlock( &xRwlock );
+        TEST_ASSERT_EQUAL_INT( EBUSY, iStatus );
+
+        /* Release the read lock, which lets prvWriteLockThread finish. */
+        iStatus = pthread_rwlock_unlock( &xRwlock );
+        TEST_ASSERT_EQUAL_INT( 0, iStatus );
+
+        TEST_ASSERT_EQUAL_INT( 0, pthread_join( xNewThread, ( void ** ) &xThreadReturnValue ) );
+        xThreadCreated = pdFALSE;
+        TEST_ASSERT_EQUAL_INT( 0, ( int ) xThreadReturnValue );
+
+        /* The read-write lock is free again. */
+        iStatus = pthread_rwlock_tryrdlock( &xRwlock );
+        TEST_ASSERT_EQUAL_INT( 0, iStatus );
+        iStatus = pthread_rwlock_unlock( &xRwlock );
+        TEST_ASSERT_EQUAL_INT( 0, iStatus );
+    }
+
+    if( xThreadCreated == pdTRUE )
+    {
+        ( void ) pthread_rwlock_unlock( &xRwlock );
+        ( void ) pthread_join( xNewThread, NULL );
+    }
+
+    iStatus = pthread_rwlock_destroy( &xRwlock );
+    TEST_ASSERT_EQUAL_INT( 0, iStatus );
+}
+
+/*-----------------------------------------------------------*/
+
 TEST( Full_POSIX_PTHREAD, pthread_barrier )
 {
     int iStatus = 0;
@@ -566,10 +728,20 @@ TEST( Full_POSIX_PTHREAD, pthread_cond_signal )
         ( void ) clock_gettime( CLOCK_REALTIME, &xWaitTime );
         ( void ) UTILS_TimespecAddNanoseconds( &xWaitTime, &xWaitTime, 100000000LL );
 
+        /* A notification the application sends to the waiting thread is
+         * neither taken for a signal nor consumed by the wait. */
+        #if ( configTASK_NOTIFICATION_ARRAY_ENTRIES > 1 )
+            ( void ) xTaskNotifyGive( xTaskGetCurrentTaskHandle() );
+        #endif
+
         /* Waiting on a condition variable that is never signaled should time out. */
         iStatus = pthread_cond_timedwait( &xCond, &xMutex, &xWaitTime );
         TEST_ASSERT_EQUAL_INT( ETIMEDOUT, iStatus );
 
+        #if ( configTASK_NOTIFICATION_ARRAY_ENTRIES > 1 )
+            TEST_ASSERT_EQUAL_UINT32( 1, ulTaskNotifyTake( pdTRUE, 0 ) );
+        #endif
+
         /* Create a thread that will signal the condition variable. */
         xThreadArgs.pxCond = &xCond;
         iStatus = pthread_create( &xNewThread, NULL, prvSignalCondThread, &xThreadArgs );
@@ -58,6 +58,16 @@
 #define posixtestMQUEUE_STRESS_TIMEOUT_SECONDS      ( 1 )                                    /**< Relative timeout for mqueue functions. */
 /**@} */
 
+/**
+ * @defgroup Configuration constants for the mqueue priority latency test.
+ */
+/**@{ */
+#define posixtestMQUEUE_PRIORITY_MESSAGES              ( 40 )                                             /**< Number of messages sent by the producer. */
+#define posixtestMQUEUE_PRIORITY_INTERVAL              ( 10 )                                             /**< Every nth message sent is high priority. */
+#define posixtestMQUEUE_PRIORITY_RECEIVE_DELAY_MS      ( 50 )                                             /**< Delay of the consumer before each receive. */
+#define posixtestMQUEUE_PRIORITY_MAX_LATENCY_MS        ( 3 * posixtestMQUEUE_PRIORITY_RECEIVE_DELAY_MS ) /**< Maximum latency of a high priority message. */
+/**@} */
+
 /**
  * @defgroup Configuration constants for the mutex stress test.
  */
@@ -66,6 +76,31 @@
 #define posixtestMUTEX_STRESS_NUMBER_OF_THREADS    ( 12 ) /**< Number of mutex test threads. */
 /**@} */
 
+/**
+ * @defgroup Configuration constants for the mutex benchmark.
+ */
+/**@{ */
+#define posixtestMUTEX_BENCHMARK_CYCLES    ( 100000 ) /**< Number of lock/unlock cycles timed for each path. */
+/**@} */
+
+/**
+ * @defgroup Configuration constants for the read-write lock stress test.
+ */
+/**@{ */
+#define posixtestRWLOCK_STRESS_NUMBER_OF_READERS    ( 8 )  /**< Number of reader threads. */
+#define posixtestRWLOCK_STRESS_NUMBER_OF_WRITERS    ( 4 )  /**< Number of writer threads. */
+#define posixtestRWLOCK_STRESS_LOCKS_PER_THREAD     ( 50 ) /**< How many times each thread takes the lock. */
+/**@} */
+
+/**
+ * @defgroup Configuration constants for the condition variable benchmark.
+ */
+/**@{ */
+#define posixtestCOND_BENCHMARK_NUMBER_OF_THREADS    ( 4 )    /**< Number of threads passing the token around. */
+#define posixtestCOND_BENCHMARK_HANDOFFS             ( 1000 ) /**< Total number of times the token is passed. */
+#define posixtestCOND_BENCHMARK_TIMEOUT_SECONDS      ( 10 )   /**< Relative timeout for each wait. */
+/**@} */
+
 /**
  * @defgroup Configuration constants for the barrier stress test.
  */
@@ -92,6 +127,15 @@ typedef struct MutexTestThreadArgs
     pthread_mutex_t * pxMutex;       /**< Mutex which protects the shared variable. */
 } MutexTestThreadArgs_t;
 
+/**
+ * @brief The arguments to all of the read-write lock test threads.
+ */
+typedef struct RwlockTestThreadArgs
+{
+    volatile int * piSharedVariable; /**< Pointer to the shared variable; always even while unlocked. */
+    pthread_rwlock_t * pxRwlock;     /**< Read-write lock which protects the shared variable. */
+} RwlockTestThreadArgs_t;
+
 /**
  * @brief The arguments to all of the barrier test threads.
  */
@@ -101,6 +145,26 @@ typedef struct BarrierTestThreadArgs
     volatile int * piWaitingThreads; /**< How many threads are waiting on pxBarrier. */
 } BarrierTestThreadArgs_t;
 
+/**
+ * @brief The state shared by the condition variable benchmark threads.
+ */
+typedef struct CondBenchmarkShared
+{
+    pthread_mutex_t * pxMutex; /**< Mutex which protects this struct. */
+    pthread_cond_t * pxCond;   /**< Condition variable broadcast on every handoff. */
+    int iTurn;                 /**< Index of the thread that holds the token. */
+    int iHandoffs;             /**< Number of handoffs so far. */
+} CondBenchmarkShared_t;
+
+/**
+ * @brief The arguments to prvCondBenchmarkThread.
+ */
+typedef struct CondBenchmarkThreadArgs
+{
+    CondBenchmarkShared_t * pxShared; /**< State shared by all threads. */
+    int iIndex;                       /**< Index of this thread. */
+} CondBenchmarkThreadArgs_t;
+
 /*-----------------------------------------------------------*/
 
 static void * prvChangeErrnoThread( void * pvArgs )
@@ -244,6 +308,95 @@ static void * prvQueueReceiverThread( void * pvArgs )
 
 /*-----------------------------------------------------------*/
 
+static void * prvQueuePriorityProducerThread( void * pvArgs )
+{
+    int i = 0;
+    intptr_t iStatus = 0;
+    mqd_t xMqId = *( ( mqd_t * ) pvArgs );
+    struct timespec xTimeout = { 0 };
+    TickType_t xSendTime = 0;
+    unsigned uPriority = 0;
+
+    for( i = 0; i < posixtestMQUEUE_PRIORITY_MESSAGES; i++ )
+    {
+        /* Set the timeout for sending. */
+        ( void ) clock_gettime( CLOCK_REALTIME, &xTimeout );
+        xTimeout.tv_sec += posixtestMQUEUE_STRESS_TIMEOUT_SECONDS;
+
+        /* Keep the queue full of low priority messages, with an occasional
+         * high priority one. */
+        if( ( i % posixtestMQUEUE_PRIORITY_INTERVAL ) == ( posixtestMQUEUE_PRIORITY_INTERVAL - 1 ) )
+        {
+            uPriority = MQ_PRIO_MAX - 1;
+        }
+        else
+        {
+            uPriority = 0;
+        }
+
+        /* The message carries the time at which it was sent. */
+        xSendTime = xTaskGetTickCount();
+
+        if( mq_timedsend( xMqId,
+                          ( const char * ) &xSendTime,
+                          sizeof( xSendTime ),
+                          uPriority,
+                          &xTimeout ) == -1 )
+        {
+            break;
+        }
+    }
+
+    /* If all messages successfully sent, set status to success. */
+    if( i == posixtestMQUEUE_PRIORITY_MESSAGES )
+    {
+        iStatus = 1;
+    }
+
+    return ( void * ) iStatus;
+}
+
+/*-----------------------------------------------------------*/
+
+static void * prvCondBenchmarkThread( void * pvArgs )
+{
+    intptr_t iResult = 1;
+    CondBenchmarkThreadArgs_t * pxArgs = ( CondBenchmarkThreadArgs_t * ) pvArgs;
+    CondBenchmarkShared_t * pxShared = pxArgs->pxShared;
+    struct timespec xTimeout = { 0 };
+
+    ( void ) pthread_mutex_lock( pxShared->pxMutex );
+
+    while( pxShared->iHandoffs < posixtestCOND_BENCHMARK_HANDOFFS )
+    {
+        if( pxShared->iTurn == pxArgs->iIndex )
+        {
+            /* Pass the token to the next thread. Every thread is woken, but
+             * only one of them can make progress. */
+            pxShared->iTurn = ( pxShared->iTurn + 1 ) % posixtestCOND_BENCHMARK_NUMBER_OF_THREADS;
+            pxShared->iHandoffs++;
+            ( void ) pthread_cond_broadcast( pxShared->pxCond );
+        }
+        else
+        {
+            ( void ) clock_gettime( CLOCK_REALTIME, &xTimeout );
+            xTimeout.tv_sec += posixtestCOND_BENCHMARK_TIMEOUT_SECONDS;
+
+            if( pthread_cond_timedwait( pxShared->pxCond, pxShared->pxMutex, &xTimeout ) != 0 )
+            {
+                iResult = 0;
+                break;
+            }
+        }
+    }
+
+    ( void ) pthread_mutex_unlock( pxShared->pxMutex );
+
+    return ( void * ) iResult;
+}
+
+/*-----------------------------------------------------------*/
+
 static void * prvMutexTestThread( void * pvArgs )
 {
     intptr_t iResult = 0;
@@ -275,6 +428,73 @@ static void * prvMutexTestThread( void * pvArgs )
 
 /*-----------------------------------------------------------*/
 
+static void * prvRwlockReaderThread( void * pvArgs )
+{
+    intptr_t iResult = 1;
+    int i = 0, iValue = 0;
+    RwlockTestThreadArgs_t * pxArgs = ( RwlockTestThreadArgs_t * ) pvArgs;
+
+    for( i = 0; ( i < posixtestRWLOCK_STRESS_LOCKS_PER_THREAD ) && ( iResult == 1 ); i++ )
+    {
+        if( pthread_rwlock_rdlock( pxArgs->pxRwlock ) != 0 )
+        {
+            iResult = 0;
+            break;
+        }
+
+        /* A writer leaves the shared variable odd while it holds the lock. */
+        iValue = *( pxArgs->piSharedVariable );
+
+        if( ( iValue % 2 ) != 0 )
+        {
+            iResult = 0;
+        }
+
+        /* Yield the processor to give writers a chance to change the shared
+         * variable, which they must not. */
+        ( void ) sched_yield();
+
+        if( *( pxArgs->piSharedVariable ) != iValue )
+        {
+            iResult = 0;
+        }
+
+        ( void ) pthread_rwlock_unlock( pxArgs->pxRwlock );
+    }
+
+    return ( void * ) iResult;
+}
+
+/*-----------------------------------------------------------*/
+
+static void * prvRwlockWriterThread( void * pvArgs )
+{
+    intptr_t iResult = 1;
+    int i = 0;
+    RwlockTestThreadArgs_t * pxArgs = ( RwlockTestThreadArgs_t * ) pvArgs;
+
+    for( i = 0; i < posixtestRWLOCK_STRESS_LOCKS_PER_THREAD; i++ )
+    {
+        if( pthread_rwlock_wrlock( pxArgs->pxRwlock ) != 0 )
+        {
+            iResult = 0;
+            break;
+        }
+
+        /* Leave the shared variable odd while yielding, so that a reader
+         * running at the same time would notice. */
+        ( *( pxArgs->piSharedVariable ) )++;
+        ( void ) sched_yield();
+        ( *( pxArgs->piSharedVariable ) )++;
+
+        ( void ) pthread_rwlock_unlock( pxArgs->pxRwlock );
+    }
+
+    return ( void * ) iResult;
+}
+
+/*-----------------------------------------------------------*/
+
 static void * prvBarrierTestThread( void * pvArgs )
 {
     intptr_t iResult = 0;
@@ -322,7 +542,11 @@ TEST_GROUP_RUNNER( Full_POSIX_STRESS )
 {
     RUN_TEST_CASE( Full_POSIX_STRESS, errno_multithreaded );
     RUN_TEST_CASE( Full_POSIX_STRESS, mqueue );
+    RUN_TEST_CASE( Full_POSIX_STRESS, mqueue_priority_latency );
     RUN_TEST_CASE( Full_POSIX_STRESS, pthread_mutex );
+    RUN_TEST_CASE( Full_POSIX_STRESS, pthread_mutex_benchmark );
+    RUN_TEST_CASE( Full_POSIX_STRESS, pthread_rwlock );
+    RUN_TEST_CASE( Full_POSIX_STRESS, pthread_cond_benchmark );
     RUN_TEST_CASE( Full_POSIX_STRESS, pthread_barrier_overflow );
 }
 
@@ -473,6 +697,89 @@ TEST( Full_POSIX_STRESS, mqueue )
 
 /*-----------------------------------------------------------*/
 
+TEST( Full_POSIX_STRESS, mqueue_priority_latency )
+{
+    int i = 0, iHighPriorityMessages = 0;
+    mqd_t xMqId = ( mqd_t ) -1;
+    pthread_t xProducer = ( pthread_t ) NULL;
+    intptr_t xProducerStatus = 0;
+    struct timespec xTimeout = { 0 };
+    ssize_t xMessageSize = 0;
+    TickType_t xSendTime = 0, xLatency = 0, xMaxLatency = 0;
+    unsigned uPriority = 0;
+
+    struct mq_attr xQueueAttributes =
+    {
+        .mq_flags   =                         0,
+        .mq_maxmsg  = posixconfigMQ_MAX_MESSAGES,
+        .mq_msgsize = sizeof( TickType_t ),
+        .mq_curmsgs = 0
+    };
+
+    /* Create a message queue. */
+    xMqId = mq_open( "/myqueue",
+                     O_CREAT | O_RDWR,
+                     0600,
+                     &xQueueAttributes );
+    TEST_ASSERT_NOT_EQUAL( ( mqd_t ) -1, xMqId );
+
+    if( TEST_PROTECT() )
+    {
+        /* Spawn the producer, which keeps the queue saturated. */
+        TEST_ASSERT_EQUAL_INT( 0,
+                               pthread_create( &xProducer, NULL, prvQueuePriorityProducerThread, &xMqId ) );
+
+        /* Consume slower than the producer sends. A high priority message must
+         * overtake the full queue of low priority messages ahead of it. */
+        for( i = 0; i < posixtestMQUEUE_PRIORITY_MESSAGES; i++ )
+        {
+            vTaskDelay( pdMS_TO_TICKS( posixtestMQUEUE_PRIORITY_RECEIVE_DELAY_MS ) );
+
+            /* Set the timeout for receiving. */
+            ( void ) clock_gettime( CLOCK_REALTIME, &xTimeout );
+            xTimeout.tv_sec += posixtestMQUEUE_STRESS_TIMEOUT_SECONDS;
+
+            xMessageSize = mq_timedreceive( xMqId,
+                                            ( char * ) &xSendTime,
+                                            sizeof( xSendTime ),
+                                            &uPriority,
+                                            &xTimeout );
+            TEST_ASSERT_EQUAL_INT( sizeof( xSendTime ), xMessageSize );
+
+            if( uPriority == MQ_PRIO_MAX - 1 )
+            {
+                xLatency = xTaskGetTickCount() - xSendTime;
+
+                if( xLatency > xMaxLatency )
+                {
+                    xMaxLatency = xLatency;
+                }
+
+                iHighPriorityMessages++;
+            }
+        }
+    }
+
+    /* Join the producer. */
+    if( xProducer != ( pthread_t ) NULL )
+    {
+        ( void ) pthread_join( xProducer, ( void ** ) &xProducerStatus );
+    }
+
+    /* Close and unlink message queue. */
+    ( void ) mq_close( xMqId );
+    ( void ) mq_unlink( "/myqueue" );
+
+    /* Check results. */
+    TEST_ASSERT_EQUAL_INT( 1, xProducerStatus );
+    TEST_ASSERT_EQUAL_INT( posixtestMQUEUE_PRIORITY_MESSAGES / posixtestMQUEUE_PRIORITY_INTERVAL,
+                           iHighPriorityMessages );
+    TEST_ASSERT_LESS_THAN_UINT32( pdMS_TO_TICKS( posixtestMQUEUE_PRIORITY_MAX_LATENCY_MS ),
+                                  xMaxLatency );
+}
+
+/*-----------------------------------------------------------*/
+
 TEST( Full_POSIX_STRESS, pthread_mutex )
 {
     int i = 0, j = 0;
@@ -520,6 +827,163 @@ TEST( Full_POSIX_STRESS, pthread_mutex )
 
 /*-----------------------------------------------------------*/
 
+TEST( Full_POSIX_STRESS, pthread_mutex_benchmark )
+{
+    int i = 0;
+    pthread_mutex_t xMutex;
+    StaticSemaphore_t xSemaphoreBuffer;
+    SemaphoreHandle_t xSemaphore = NULL;
+    TickType_t xStartTime = 0, xMutexTime = 0, xSemaphoreTime = 0;
+    BaseType_t xSemaphoreResult = pdPASS;
+    int iMutexResult = 0;
+
+    TEST_ASSERT_EQUAL_INT( 0, pthread_mutex_init( &xMutex, NULL ) );
+    xSemaphore = xSemaphoreCreateMutexStatic( &xSemaphoreBuffer );
+
+    /* Time uncontended lock/unlock cycles of a pthread mutex, which wraps a
+     * FreeRTOS mutex. */
+    xStartTime = xTaskGetTickCount();
+
+    for( i = 0; i < posixtestMUTEX_BENCHMARK_CYCLES; i++ )
+    {
+        iMutexResult |= pthread_mutex_lock( &xMutex );
+        iMutexResult |= pthread_mutex_unlock( &xMutex );
+    }
+
+    xMutexTime = xTaskGetTickCount() - xStartTime;
+
+    /* Time the same cycles through the FreeRTOS queue functions. */
+    xStartTime = xTaskGetTickCount();
+
+    for( i = 0; i < posixtestMUTEX_BENCHMARK_CYCLES; i++ )
+    {
+        xSemaphoreResult &= xSemaphoreTake( xSemaphore, portMAX_DELAY );
+        xSemaphoreResult &= xSemaphoreGive( xSemaphore );
+    }
+
+    xSemaphoreTime = xTaskGetTickCount() - xStartTime;
+
+    configPRINTF( ( "%d uncontended lock/unlock cycles: pthread mutex %u ms, FreeRTOS queue functions %u ms.\r\n",
+                    posixtestMUTEX_BENCHMARK_CYCLES,
+                    ( unsigned ) ( xMutexTime * portTICK_PERIOD_MS ),
+                    ( unsigned ) ( xSemaphoreTime * portTICK_PERIOD_MS ) ) );
+
+    vSemaphoreDelete( xSemaphore );
+    ( void ) pthread_mutex_destroy( &xMutex );
+
+    /* Check results. */
+    TEST_ASSERT_EQUAL_INT( 0, iMutexResult );
+    TEST_ASSERT_EQUAL( pdPASS, xSemaphoreResult );
+}
+
+/*-----------------------------------------------------------*/
+
+TEST( Full_POSIX_STRESS, pthread_rwlock )
+{
+    int i = 0;
+    volatile int iSharedVariable = 0;
+    pthread_rwlock_t xRwlock;
+    pthread_t xThreads[ posixtestRWLOCK_STRESS_NUMBER_OF_READERS + posixtestRWLOCK_STRESS_NUMBER_OF_WRITERS ] = { ( pthread_t ) NULL };
+    intptr_t xThreadStatus[ posixtestRWLOCK_STRESS_NUMBER_OF_READERS + posixtestRWLOCK_STRESS_NUMBER_OF_WRITERS ] = { 0 };
+    RwlockTestThreadArgs_t xThreadArguments = { 0 };
+
+    /* Set the arguments for the test threads. */
+    xThreadArguments.piSharedVariable = &iSharedVariable;
+    xThreadArguments.pxRwlock = &xRwlock;
+
+    TEST_ASSERT_EQUAL_INT( 0, pthread_rwlock_init( &xRwlock, NULL ) );
+
+    /* Create the writer threads, then the reader threads. */
+    for( i = 0; i < posixtestRWLOCK_STRESS_NUMBER_OF_READERS + posixtestRWLOCK_STRESS_NUMBER_OF_WRITERS; i++ )
+    {
+        ( void ) pthread_create( &xThreads[ i ],
+                                 NULL,
+                                 ( i < posixtestRWLOCK_STRESS_NUMBER_OF_WRITERS ) ? prvRwlockWriterThread : prvRwlockReaderThread,
+                                 &xThreadArguments );
+    }
+
+    /* Wait for all test threads to finish. */
+    for( i = 0; i < posixtestRWLOCK_STRESS_NUMBER_OF_READERS + posixtestRWLOCK_STRESS_NUMBER_OF_WRITERS; i++ )
+    {
+        if( xThreads[ i ] != ( pthread_t ) NULL )
+        {
+            ( void ) pthread_join( xThreads[ i ], ( void ** ) &xThreadStatus[ i ] );
+        }
+    }
+
+    ( void ) pthread_rwlock_destroy( &xRwlock );
+
+    /* Check results. Each writer adds 2 every time it takes the lock. */
+    TEST_ASSERT_EQUAL_INT( 2 * posixtestRWLOCK_STRESS_NUMBER_OF_WRITERS * posixtestRWLOCK_STRESS_LOCKS_PER_THREAD,
+                           iSharedVariable );
+
+    for( i = 0; i < posixtestRWLOCK_STRESS_NUMBER_OF_READERS + posixtestRWLOCK_STRESS_NUMBER_OF_WRITERS; i++ )
+    {
+        TEST_ASSERT_EQUAL_INT( 1, xThreadStatus[ i ] );
+    }
+}
+
+/*-----------------------------------------------------------*/
+
+TEST( Full_POSIX_STRESS, pthread_cond_benchmark )
+{
+    int i = 0;
+    pthread_mutex_t xMutex;
+    pthread_cond_t xCond;
+    CondBenchmarkShared_t xShared = { 0 };
+    CondBenchmarkThreadArgs_t xThreadArgs[ posixtestCOND_BENCHMARK_NUMBER_OF_THREADS ] = { { 0 } };
+    pthread_t xThreads[ posixtestCOND_BENCHMARK_NUMBER_OF_THREADS ] = { ( pthread_t ) NULL };
+    intptr_t xThreadStatus[ posixtestCOND_BENCHMARK_NUMBER_OF_THREADS ] = { 0 };
+    TickType_t xStartTime = 0, xElapsedTime = 0;
+
+    /* pthread_mutex_destroy frees the mutex, so it must not be statically
+     * initialized. */
+    TEST_ASSERT_EQUAL_INT( 0, pthread_mutex_init( &xMutex, NULL ) );
+    TEST_ASSERT_EQUAL_INT( 0, pthread_cond_init( &xCond, NULL ) );
+
+    xShared.pxMutex = &xMutex;
+    xShared.pxCond = &xCond;
+
+    xStartTime = xTaskGetTickCount();
+
+    /* Create the threads that pass the token around. */
+    for( i = 0; i < posixtestCOND_BENCHMARK_NUMBER_OF_THREADS; i++ )
+    {
+        xThreadArgs[ i ].pxShared = &xShared;
+        xThreadArgs[ i ].iIndex = i;
+        ( void ) pthread_create( &xThreads[ i ], NULL, prvCondBenchmarkThread, &xThreadArgs[ i ] );
+    }
+
+    /* Wait for all threads to finish. */
+    for( i = 0; i < posixtestCOND_BENCHMARK_NUMBER_OF_THREADS; i++ )
+    {
+        if( xThreads[ i ] != ( pthread_t ) NULL )
+        {
+            ( void ) pthread_join( xThreads[ i ], ( void ** ) &xThreadStatus[ i ] );
+        }
+    }
+
+    xElapsedTime = xTaskGetTickCount() - xStartTime;
+
+    configPRINTF( ( "%d cond handoffs between %d threads took %u ms.\r\n",
+                    posixtestCOND_BENCHMARK_HANDOFFS,
+                    posixtestCOND_BENCHMARK_NUMBER_OF_THREADS,
+                    ( unsigned ) ( xElapsedTime * portTICK_PERIOD_MS ) ) );
+
+    ( void ) pthread_cond_destroy( &xCond );
+    ( void ) pthread_mutex_destroy( &xMutex );
+
+    /* Check results. */
+    TEST_ASSERT_EQUAL_INT( posixtestCOND_BENCHMARK_HANDOFFS, xShared.iHandoffs );
+
+    for( i = 0; i < posixtestCOND_BENCHMARK_NUMBER_OF_THREADS; i++ )
+    {
+        TEST_ASSERT_EQUAL_INT( 1, xThreadStatus[ i ] );
+    }
+}
+
+/*-----------------------------------------------------------*/
+
 TEST( Full_POSIX_STRESS, pthread_barrier_overflow )
 {
     int iResult = 0, i = 0;
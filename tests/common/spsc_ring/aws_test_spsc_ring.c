@@ -0,0 +1,450 @@
+/*
+ * Amazon FreeRTOS
+ * Copyright (C) 2018 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+/**
+ * @file aws_test_spsc_ring.c
+ * @brief Tests for the SPSC ring.
+ */
+
+/* Standard includes. */
+#include <stdint.h>
+#include <string.h>
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+#include "stream_buffer.h"
+
+/* SPSC ring includes. */
+#include "aws_spsc_ring.h"
+
+/* Test includes. */
+#include "unity_fixture.h"
+#include "unity.h"
+
+/**
+ * @brief Configuration for this test group.
+ */
+#define spscringtestTIMEOUT          pdMS_TO_TICKS( 1000 )
+#define spscringtestSLOTS            ( 8 )
+#define spscringtestTHRESHOLD        ( 4 )
+#define spscringtestBENCH_BURST      ( 256 )
+#define spscringtestBENCH_BURSTS     ( 500 )
+#define spscringtestBENCH_ROUNDS     ( 5 )
+
+/*
+ * @brief Test group definition.
+ */
+TEST_GROUP( Full_SPSC_RING );
+
+TEST_SETUP( Full_SPSC_RING )
+{
+}
+
+TEST_TEAR_DOWN( Full_SPSC_RING )
+{
+}
+
+TEST_GROUP_RUNNER( Full_SPSC_RING )
+{
+    RUN_TEST_CASE( Full_SPSC_RING, wraps_in_order );
+    RUN_TEST_CASE( Full_SPSC_RING, wakes_consumer_at_threshold );
+    RUN_TEST_CASE( Full_SPSC_RING, wait_times_out );
+    RUN_TEST_CASE( Full_SPSC_RING, isr_handoff_cost );
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief The mechanisms compared by the benchmark.
+ */
+typedef enum
+{
+    eHandoffQueue = 0,
+    eHandoffStreamBuffer,
+    eHandoffRing,
+    eHandoffCount
+} Handoff_t;
+
+static SPSCRing_t xRing;
+static uint32_t ulSlots[ spscringtestBENCH_BURST ];
+static volatile uint32_t ulWakeups;
+static volatile uint32_t ulWokenCount;
+static volatile uint32_t ulConsumed;
+static QueueHandle_t xQueue;
+static StreamBufferHandle_t xStreamBuffer;
+
+/*-----------------------------------------------------------*/
+
+static void prvRingConsumerTask( void * pvParameters )
+{
+    uint32_t ulCount;
+
+    ( void ) pvParameters;
+
+    SPSCRING_SetConsumer( &xRing, xTaskGetCurrentTaskHandle(), tskDEFAULT_INDEX_TO_NOTIFY, spscringtestTHRESHOLD );
+
+    for( ; ; )
+    {
+        ulCount = SPSCRING_Wait( &xRing, portMAX_DELAY );
+        ulWokenCount = ulCount;
+        ulWakeups++;
+
+        while( SPSCRING_AcquireRead( &xRing ) != NULL )
+        {
+            SPSCRING_ReleaseRead( &xRing );
+        }
+    }
+}
+
+/*-----------------------------------------------------------*/
+
+static void prvBenchConsumerTask( void * pvParameters )
+{
+    Handoff_t eHandoff = ( Handoff_t ) ( uintptr_t ) pvParameters;
+    uint32_t ulItems[ spscringtestBENCH_BURST ];
+    size_t xReceived;
+
+    if( eHandoff == eHandoffRing )
+    {
+        SPSCRING_SetConsumer( &xRing, xTaskGetCurrentTaskHandle(), tskDEFAULT_INDEX_TO_NOTIFY, 1 );
+    }
+
+    for( ; ; )
+    {
+        switch( eHandoff )
+        {
+            case eHandoffQueue:
+
+                if( xQueueReceive( xQueue, &ulItems[ 0 ], portMAX_DELAY ) == pdPASS )
+                {
+                    ulConsumed++;
+
+                    while( xQueueReceive( xQueue, &ulItems[ 0 ], 0 ) == pdPASS )
+                    {
+                        ulConsumed++;
+                    }
+                }
+
+                break;
+
+            case eHandoffStreamBuffer:
+                xReceived = xStreamBufferReceive( xStreamBuffer, ulItems, sizeof( ulItems ), portMAX_DELAY );
+                ulConsumed += ( uint32_t ) ( xReceived / sizeof( uint32_t ) );
+                break;
+
+            default:
+                ( void ) SPSCRING_Wait( &xRing, portMAX_DELAY );
+
+                while( SPSCRING_AcquireRead( &xRing ) != NULL )
+                {
+                    SPSCRING_ReleaseRead( &xRing );
+                    ulConsumed++;
+                }
+
+                break;
+        }
+    }
+}
+
+/*-----------------------------------------------------------*/
+
+static void prvCommit( uint32_t ulValue )
+{
+    uint32_t * pulSlot = ( uint32_t * ) SPSCRING_AcquireWrite( &xRing );
+
+    TEST_ASSERT_NOT_NULL( pulSlot );
+    *pulSlot = ulValue;
+    SPSCRING_CommitWrite( &xRing );
+}
+
+/*-----------------------------------------------------------*/
+
+TEST( Full_SPSC_RING, wraps_in_order )
+{
+    uint32_t ulWritten = 0, ulRead = 0, ulRound, ulBatch, x;
+    uint32_t * pulSlot;
+
+    SPSCRING_Init( &xRing, ulSlots, sizeof( uint32_t ), spscringtestSLOTS );
+
+    /* Batches of every size, so that the slots are used at every offset
+     * from the end of the storage. */
+    for( ulRound = 0; ulRound < 100; ulRound++ )
+    {
+        ulBatch = ( ulRound % spscringtestSLOTS ) + 1;
+
+        for( x = 0; x < ulBatch; x++ )
+        {
+            pulSlot = ( uint32_t * ) SPSCRING_AcquireWrite( &xRing );
+            TEST_ASSERT_NOT_NULL( pulSlot );
+            *pulSlot = ulWritten++;
+        }
+
+        if( ulBatch == spscringtestSLOTS )
+        {
+            TEST_ASSERT_NULL( SPSCRING_AcquireWrite( &xRing ) );
+        }
+
+        /* Nothing is visible until the batch is committed. */
+        TEST_ASSERT_EQUAL_UINT32( 0, SPSCRING_GetCount( &xRing ) );
+        TEST_ASSERT_NULL( SPSCRING_AcquireRead( &xRing ) );
+        SPSCRING_CommitWrite( &xRing );
+        TEST_ASSERT_EQUAL_UINT32( ulBatch, SPSCRING_GetCount( &xRing ) );
+
+        for( x = 0; x < ulBatch; x++ )
+        {
+            pulSlot = ( uint32_t * ) SPSCRING_AcquireRead( &xRing );
+            TEST_ASSERT_NOT_NULL( pulSlot );
+            TEST_ASSERT_EQUAL_UINT32( ulRead++, *pulSlot );
+            SPSCRING_ReleaseRead( &xRing );
+        }
+
+        TEST_ASSERT_NULL( SPSCRING_AcquireRead( &xRing ) );
+    }
+
+    /* Slots are only handed out in place, never copied. */
+    prvCommit( ulWritten );
+    pulSlot = ( uint32_t * ) SPSCRING_AcquireRead( &xRing );
+    TEST_ASSERT_TRUE( ( pulSlot >= &ulSlots[ 0 ] ) && ( pulSlot < &ulSlots[ spscringtestSLOTS ] ) );
+}
+
+/*-----------------------------------------------------------*/
+
+TEST( Full_SPSC_RING, wakes_consumer_at_threshold )
+{
+    TaskHandle_t xConsumer = NULL;
+    BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+    uint32_t x, ulWakeupsBefore;
+    uint32_t * pulSlot;
+
+    SPSCRING_Init( &xRing, ulSlots, sizeof( uint32_t ), spscringtestSLOTS );
+    ulWakeups = 0;
+
+    /* Above the priority of this task, so that it runs as soon as it is
+     * woken. */
+    TEST_ASSERT_EQUAL( pdPASS, xTaskCreate( prvRingConsumerTask,
+                                            "RingConsumer",
+                                            configMINIMAL_STACK_SIZE,
+                                            NULL,
+                                            uxTaskPriorityGet( NULL ) + 1,
+                                            &xConsumer ) );
+
+    if( TEST_PROTECT() )
+    {
+        /* From a task. */
+        for( x = 1; x < spscringtestTHRESHOLD; x++ )
+        {
+            prvCommit( x );
+            TEST_ASSERT_EQUAL_UINT32( 0, ulWakeups );
+        }
+
+        prvCommit( x );
+        TEST_ASSERT_EQUAL_UINT32( 1, ulWakeups );
+        TEST_ASSERT_EQUAL_UINT32( spscringtestTHRESHOLD, ulWokenCount );
+        TEST_ASSERT_EQUAL_UINT32( 0, SPSCRING_GetCount( &xRing ) );
+
+        /* From an interrupt, for which the critical section stands in. */
+        ulWakeupsBefore = ulWakeups;
+
+        taskENTER_CRITICAL();
+        {
+            for( x = 0; x < spscringtestTHRESHOLD; x++ )
+            {
+                TEST_ASSERT_EQUAL( pdFALSE, xHigherPriorityTaskWoken );
+                pulSlot = ( uint32_t * ) SPSCRING_AcquireWrite( &xRing );
+                TEST_ASSERT_NOT_NULL( pulSlot );
+                *pulSlot = x;
+                SPSCRING_CommitWriteFromISR( &xRing, &xHigherPriorityTaskWoken );
+            }
+        }
+        taskEXIT_CRITICAL();
+
+        TEST_ASSERT_EQUAL( pdTRUE, xHigherPriorityTaskWoken );
+        portYIELD_FROM_ISR( xHigherPriorityTaskWoken );
+        TEST_ASSERT_EQUAL_UINT32( ulWakeupsBefore + 1, ulWakeups );
+        TEST_ASSERT_EQUAL_UINT32( 0, SPSCRING_GetCount( &xRing ) );
+    }
+
+    vTaskDelete( xConsumer );
+}
+
+/*-----------------------------------------------------------*/
+
+TEST( Full_SPSC_RING, wait_times_out )
+{
+    SPSCRING_Init( &xRing, ulSlots, sizeof( uint32_t ), spscringtestSLOTS );
+    SPSCRING_SetConsumer( &xRing, xTaskGetCurrentTaskHandle(), tskDEFAULT_INDEX_TO_NOTIFY, 2 );
+
+    prvCommit( 1 );
+    TEST_ASSERT_EQUAL_UINT32( 1, SPSCRING_Wait( &xRing, pdMS_TO_TICKS( 20 ) ) );
+
+    /* A notification from elsewhere ends the wait below the threshold. */
+    ( void ) xTaskNotifyGive( xTaskGetCurrentTaskHandle() );
+    TEST_ASSERT_EQUAL_UINT32( 1, SPSCRING_Wait( &xRing, portMAX_DELAY ) );
+
+    prvCommit( 2 );
+    TEST_ASSERT_EQUAL_UINT32( 2, SPSCRING_Wait( &xRing, 0 ) );
+
+    /* No notification is left behind for the next user of the index. */
+    TEST_ASSERT_EQUAL_UINT32( 0, ulTaskNotifyTake( pdTRUE, 0 ) );
+}
+
+/*-----------------------------------------------------------*/
+
+TEST( Full_SPSC_RING, isr_handoff_cost )
+{
+    #if ( configGENERATE_RUN_TIME_STATS == 1 )
+        static const char * const pcHandoffs[ eHandoffCount ] = { "queue", "stream buffer", "SPSC ring" };
+        uint32_t ulTimes[ eHandoffCount ], ulBest[ eHandoffCount ];
+        uint32_t ulBurst, x, ulStart, ulElapsed, ulRound;
+        uint32_t ulBurstItems[ spscringtestBENCH_BURST ];
+        uint32_t * pulSlot;
+        BaseType_t xHigherPriorityTaskWoken;
+        TaskHandle_t xConsumer;
+        Handoff_t eHandoff;
+
+        xQueue = xQueueCreate( spscringtestBENCH_BURST, sizeof( uint32_t ) );
+        xStreamBuffer = xStreamBufferCreate( spscringtestBENCH_BURST * sizeof( uint32_t ), 1 );
+        TEST_ASSERT_NOT_NULL( xQueue );
+        TEST_ASSERT_NOT_NULL( xStreamBuffer );
+
+        for( eHandoff = eHandoffQueue; eHandoff < eHandoffCount; eHandoff++ )
+        {
+            SPSCRING_Init( &xRing, ulSlots, sizeof( uint32_t ), spscringtestBENCH_BURST );
+            ulConsumed = 0;
+            ulTimes[ eHandoff ] = 0;
+            ulBest[ eHandoff ] = UINT32_MAX;
+            ulRound = 0;
+
+            /* The consumer blocks at once, so each burst unblocks it, and it
+             * drains the burst as soon as the "interrupt" exits. */
+            TEST_ASSERT_EQUAL( pdPASS, xTaskCreate( prvBenchConsumerTask,
+                                                    "RingBench",
+                                                    configMINIMAL_STACK_SIZE,
+                                                    ( void * ) ( uintptr_t ) eHandoff,
+                                                    uxTaskPriorityGet( NULL ) + 1,
+                                                    &xConsumer ) );
+
+            for( ulBurst = 0; ulBurst < spscringtestBENCH_BURSTS; ulBurst++ )
+            {
+                xHigherPriorityTaskWoken = pdFALSE;
+
+                taskENTER_CRITICAL();
+                {
+                    ulStart = ( uint32_t ) portGET_RUN_TIME_COUNTER_VALUE();
+
+                    /* As an interrupt that empties a receive FIFO would:
+                     * the queue takes the items one by one, the stream
+                     * buffer takes a copy of them all, and the ring has them
+                     * written in place and committed together. */
+                    switch( eHandoff )
+                    {
+                        case eHandoffQueue:
+
+                            for( x = 0; x < spscringtestBENCH_BURST; x++ )
+                            {
+                                ( void ) xQueueSendFromISR( xQueue, &x, &xHigherPriorityTaskWoken );
+                            }
+
+                            break;
+
+                        case eHandoffStreamBuffer:
+
+                            for( x = 0; x < spscringtestBENCH_BURST; x++ )
+                            {
+                                ulBurstItems[ x ] = x;
+                            }
+
+                            ( void ) xStreamBufferSendFromISR( xStreamBuffer, ulBurstItems, sizeof( ulBurstItems ), &xHigherPriorityTaskWoken );
+                            break;
+
+                        default:
+
+                            for( x = 0; x < spscringtestBENCH_BURST; x++ )
+                            {
+                                pulSlot = ( uint32_t * ) SPSCRING_AcquireWrite( &xRing );
+
+                                if( pulSlot != NULL )
+                                {
+                                    *pulSlot = x;
+                                }
+                            }
+
+                            SPSCRING_CommitWriteFromISR( &xRing, &xHigherPriorityTaskWoken );
+                            break;
+                    }
+
+                    ulElapsed = ( uint32_t ) portGET_RUN_TIME_COUNTER_VALUE() - ulStart;
+                }
+                taskEXIT_CRITICAL();
+
+                ulTimes[ eHandoff ] += ulElapsed;
+                ulRound += ulElapsed;
+
+                /* The host may preempt the simulated interrupt, which adds
+                 * far more than a burst costs.  The best round is kept, as
+                 * such outliers rarely hit every round. */
+                if( ( ( ulBurst + 1 ) % ( spscringtestBENCH_BURSTS / spscringtestBENCH_ROUNDS ) ) == 0 )
+                {
+                    if( ulRound < ulBest[ eHandoff ] )
+                    {
+                        ulBest[ eHandoff ] = ulRound;
+                    }
+
+                    ulRound = 0;
+                }
+
+                portYIELD_FROM_ISR( xHigherPriorityTaskWoken );
+            }
+
+            TEST_ASSERT_EQUAL_UINT32( spscringtestBENCH_BURST * spscringtestBENCH_BURSTS, ulConsumed );
+            vTaskDelete( xConsumer );
+
+            configPRINTF( ( "ISR handoff with %s: run time %u in total, %u for the best of %u rounds of %u bursts of %u items\r\n",
+                            pcHandoffs[ eHandoff ],
+                            ( unsigned ) ulTimes[ eHandoff ],
+                            ( unsigned ) ulBest[ eHandoff ],
+                            ( unsigned ) spscringtestBENCH_ROUNDS,
+                            ( unsigned ) ( spscringtestBENCH_BURSTS / spscringtestBENCH_ROUNDS ),
+                            ( unsigned ) spscringtestBENCH_BURST ) );
+        }
+
+        vStreamBufferDelete( xStreamBuffer );
+        vQueueDelete( xQueue );
+
+        /* One barrier and one wake up for the whole burst, against a
+         * critical section and a look at the waiting tasks for each item.
+         * The stream buffer is not asserted against: it copies the burst with
+         * one memcpy(), while the ring is written slot by slot, and on this
+         * port the stream buffer is the cheaper of the two. */
+        TEST_ASSERT_LESS_THAN_UINT32( ulBest[ eHandoffQueue ], ulBest[ eHandoffRing ] );
+
+        /* Let the idle task free the consumer tasks. */
+        vTaskDelay( pdMS_TO_TICKS( 10 ) );
+    #else /* if ( configGENERATE_RUN_TIME_STATS == 1 ) */
+        TEST_IGNORE_MESSAGE( "configGENERATE_RUN_TIME_STATS is required" );
+    #endif /* if ( configGENERATE_RUN_TIME_STATS == 1 ) */
+}
@@ -0,0 +1,448 @@
+/*
+ * Amazon FreeRTOS
+ * Copyright (C) 2018 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+/**
+ * @file aws_test_taskpool.c
+ * @brief Tests for the task pool.
+ */
+
+/* Standard includes. */
+#include <stdint.h>
+#include <string.h>
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+
+/* Task pool includes. */
+#include "aws_taskpool.h"
+#include "aws_taskpool_config.h"
+#include "aws_taskpool_config_defaults.h"
+
+/* Test includes. */
+#include "unity_fixture.h"
+#include "unity.h"
+
+/**
+ * @brief Configuration for this test group.
+ */
+#define taskpooltestTIMEOUT              pdMS_TO_TICKS( 1000 )
+#define taskpooltestMAX_RECORDS          ( taskpoolconfigQUEUE_LENGTH * 2 )
+#define taskpooltestCHILD_JOBS           ( taskpoolconfigQUEUE_LENGTH / 2 )
+#define taskpooltestBENCH_PACKETS        40
+#define taskpooltestBENCH_PERIOD         pdMS_TO_TICKS( 5 )
+#define taskpooltestBENCH_CALLBACK       pdMS_TO_TICKS( 8 )
+
+/*
+ * @brief Test group definition.
+ */
+TEST_GROUP( Full_TASKPOOL );
+
+TEST_SETUP( Full_TASKPOOL )
+{
+    TEST_ASSERT_EQUAL( pdPASS, TASKPOOL_Init() );
+    ( void ) ulTaskNotifyTake( pdTRUE, 0 );
+}
+
+TEST_TEAR_DOWN( Full_TASKPOOL )
+{
+}
+
+TEST_GROUP_RUNNER( Full_TASKPOOL )
+{
+    RUN_TEST_CASE( Full_TASKPOOL, high_lane_runs_first );
+    RUN_TEST_CASE( Full_TASKPOOL, full_lane_rejects_job );
+    RUN_TEST_CASE( Full_TASKPOOL, idle_worker_steals_jobs );
+    RUN_TEST_CASE( Full_TASKPOOL, SubmitFromISR );
+    RUN_TEST_CASE( Full_TASKPOOL, network_latency_vs_slow_callbacks );
+}
+
+/*-----------------------------------------------------------*/
+
+static TaskHandle_t xTestTask;
+static TaskHandle_t xBlockedWorker;
+static uint32_t ulRecords[ taskpooltestMAX_RECORDS ];
+static TaskHandle_t xRecordWorkers[ taskpooltestMAX_RECORDS ];
+static volatile UBaseType_t uxRecords;
+
+/*-----------------------------------------------------------*/
+
+static void prvBlockingJob( void * pvParameter1,
+                            uint32_t ulParameter2 )
+{
+    ( void ) pvParameter1;
+    ( void ) ulParameter2;
+
+    /* Keeps the worker busy until the test releases it. */
+    xBlockedWorker = xTaskGetCurrentTaskHandle();
+    ( void ) ulTaskNotifyTake( pdTRUE, taskpooltestTIMEOUT );
+    xBlockedWorker = NULL;
+}
+
+/*-----------------------------------------------------------*/
+
+static void prvRecordJob( void * pvParameter1,
+                          uint32_t ulParameter2 )
+{
+    ( void ) pvParameter1;
+
+    taskENTER_CRITICAL();
+    {
+        if( uxRecords < taskpooltestMAX_RECORDS )
+        {
+            ulRecords[ uxRecords ] = ulParameter2;
+            xRecordWorkers[ uxRecords ] = xTaskGetCurrentTaskHandle();
+        }
+
+        uxRecords++;
+    }
+    taskEXIT_CRITICAL();
+
+    xTaskNotifyGive( xTestTask );
+}
+
+/*-----------------------------------------------------------*/
+
+static void prvStartRecording( void )
+{
+    xTestTask = xTaskGetCurrentTaskHandle();
+    uxRecords = 0;
+    memset( ulRecords, 0, sizeof( ulRecords ) );
+    memset( xRecordWorkers, 0, sizeof( xRecordWorkers ) );
+}
+
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvWaitForRecords( UBaseType_t uxExpected )
+{
+    while( uxRecords < uxExpected )
+    {
+        if( ulTaskNotifyTake( pdTRUE, taskpooltestTIMEOUT ) == 0 )
+        {
+            break;
+        }
+    }
+
+    return ( uxRecords == uxExpected ) ? pdTRUE : pdFALSE;
+}
+
+/*-----------------------------------------------------------*/
+
+static void prvBlockWorker( UBaseType_t uxWorker )
+{
+    /* The workers have a higher priority than the test, so the job starts and
+     * blocks before the submit call returns. */
+    TEST_ASSERT_EQUAL( pdPASS, TASKPOOL_SubmitToWorker( uxWorker, prvBlockingJob, NULL, 0, eTaskPoolLaneHigh ) );
+    TEST_ASSERT_NOT_NULL( xBlockedWorker );
+}
+
+/*-----------------------------------------------------------*/
+
+TEST( Full_TASKPOOL, high_lane_runs_first )
+{
+    static const uint32_t ulExpected[] = { 3, 4, 1, 2 };
+
+    prvStartRecording();
+    prvBlockWorker( 0 );
+
+    TEST_ASSERT_EQUAL( pdPASS, TASKPOOL_SubmitToWorker( 0, prvRecordJob, NULL, 1, eTaskPoolLaneNormal ) );
+    TEST_ASSERT_EQUAL( pdPASS, TASKPOOL_SubmitToWorker( 0, prvRecordJob, NULL, 2, eTaskPoolLaneNormal ) );
+    TEST_ASSERT_EQUAL( pdPASS, TASKPOOL_SubmitToWorker( 0, prvRecordJob, NULL, 3, eTaskPoolLaneHigh ) );
+    TEST_ASSERT_EQUAL( pdPASS, TASKPOOL_SubmitToWorker( 0, prvRecordJob, NULL, 4, eTaskPoolLaneHigh ) );
+
+    /* Pinned jobs are not stolen by the idle workers. */
+    vTaskDelay( pdMS_TO_TICKS( 10 ) );
+    TEST_ASSERT_EQUAL( 0, uxRecords );
+
+    xTaskNotifyGive( xBlockedWorker );
+    TEST_ASSERT_EQUAL( pdTRUE, prvWaitForRecords( 4 ) );
+    TEST_ASSERT_EQUAL_UINT32_ARRAY( ulExpected, ulRecords, 4 );
+}
+
+/*-----------------------------------------------------------*/
+
+TEST( Full_TASKPOOL, full_lane_rejects_job )
+{
+    TaskPoolStats_t xBefore, xAfter;
+    uint32_t ulJob;
+
+    prvStartRecording();
+    prvBlockWorker( 0 );
+    TASKPOOL_GetStats( &xBefore );
+
+    for( ulJob = 0; ulJob < taskpoolconfigQUEUE_LENGTH; ulJob++ )
+    {
+        TEST_ASSERT_EQUAL( pdPASS, TASKPOOL_SubmitToWorker( 0, prvRecordJob, NULL, ulJob, eTaskPoolLaneNormal ) );
+    }
+
+    /* The submission fails without blocking, and the other lane still has
+     * room. */
+    TEST_ASSERT_EQUAL( pdFAIL, TASKPOOL_SubmitToWorker( 0, prvRecordJob, NULL, ulJob, eTaskPoolLaneNormal ) );
+    TEST_ASSERT_EQUAL( pdPASS, TASKPOOL_SubmitToWorker( 0, prvRecordJob, NULL, ulJob, eTaskPoolLaneHigh ) );
+
+    TASKPOOL_GetStats( &xAfter );
+    TEST_ASSERT_EQUAL_UINT32( xBefore.ulJobsRejected + 1, xAfter.ulJobsRejected );
+
+    xTaskNotifyGive( xBlockedWorker );
+    TEST_ASSERT_EQUAL( pdTRUE, prvWaitForRecords( taskpoolconfigQUEUE_LENGTH + 1 ) );
+
+    /* The jobs of each lane ran in the order in which they were queued. */
+    for( ulJob = 0; ulJob <= taskpoolconfigQUEUE_LENGTH; ulJob++ )
+    {
+        TEST_ASSERT_EQUAL_UINT32( ( ulJob + taskpoolconfigQUEUE_LENGTH ) % ( taskpoolconfigQUEUE_LENGTH + 1 ), ulRecords[ ulJob ] );
+    }
+
+    TASKPOOL_GetStats( &xBefore );
+    TEST_ASSERT_EQUAL_UINT32( xAfter.ulJobsRun + taskpoolconfigQUEUE_LENGTH + 2, xBefore.ulJobsRun );
+}
+
+/*-----------------------------------------------------------*/
+
+static void prvParentJob( void * pvParameter1,
+                          uint32_t ulParameter2 )
+{
+    uint32_t ulJob;
+
+    ( void ) pvParameter1;
+    ( void ) ulParameter2;
+
+    /* The children are queued on this worker, which then stays busy. */
+    for( ulJob = 0; ulJob < taskpooltestCHILD_JOBS; ulJob++ )
+    {
+        configASSERT( TASKPOOL_Submit( prvRecordJob, xTaskGetCurrentTaskHandle(), ulJob, eTaskPoolLaneNormal ) == pdPASS );
+    }
+
+    xBlockedWorker = xTaskGetCurrentTaskHandle();
+    vTaskDelay( pdMS_TO_TICKS( 50 ) );
+}
+
+/*-----------------------------------------------------------*/
+
+TEST( Full_TASKPOOL, idle_worker_steals_jobs )
+{
+    TaskPoolStats_t xBefore, xAfter;
+    UBaseType_t uxRecord;
+    BaseType_t xRanElsewhere = pdFALSE;
+
+    prvStartRecording();
+    xBlockedWorker = NULL;
+    TASKPOOL_GetStats( &xBefore );
+
+    TEST_ASSERT_EQUAL( pdPASS, TASKPOOL_Submit( prvParentJob, NULL, 0, eTaskPoolLaneNormal ) );
+    TEST_ASSERT_EQUAL( pdTRUE, prvWaitForRecords( taskpooltestCHILD_JOBS ) );
+
+    TASKPOOL_GetStats( &xAfter );
+
+    for( uxRecord = 0; uxRecord < taskpooltestCHILD_JOBS; uxRecord++ )
+    {
+        if( xRecordWorkers[ uxRecord ] != xBlockedWorker )
+        {
+            xRanElsewhere = pdTRUE;
+        }
+    }
+
+    #if ( taskpoolconfigNUM_WORKERS > 1 )
+        TEST_ASSERT_EQUAL( pdTRUE, xRanElsewhere );
+        TEST_ASSERT_EQUAL_UINT32( xBefore.ulJobsStolen + taskpooltestCHILD_JOBS, xAfter.ulJobsStolen );
+    #else
+        TEST_ASSERT_EQUAL( pdFALSE, xRanElsewhere );
+    #endif
+
+    /* Let the parent job return. */
+    vTaskDelay( pdMS_TO_TICKS( 60 ) );
+}
+
+/*-----------------------------------------------------------*/
+
+TEST( Full_TASKPOOL, SubmitFromISR )
+{
+    BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+    BaseType_t xSubmitted;
+
+    prvStartRecording();
+
+    /* The critical section stands in for an interrupt. */
+    taskENTER_CRITICAL();
+    {
+        xSubmitted = TASKPOOL_SubmitFromISR( prvRecordJob, NULL, 7, eTaskPoolLaneHigh, &xHigherPriorityTaskWoken );
+    }
+    taskEXIT_CRITICAL();
+
+    TEST_ASSERT_EQUAL( pdPASS, xSubmitted );
+    TEST_ASSERT_EQUAL( pdTRUE, xHigherPriorityTaskWoken );
+    portYIELD_FROM_ISR( xHigherPriorityTaskWoken );
+
+    TEST_ASSERT_EQUAL( pdTRUE, prvWaitForRecords( 1 ) );
+    TEST_ASSERT_EQUAL_UINT32( 7, ulRecords[ 0 ] );
+}
+
+/*-----------------------------------------------------------*/
+
+/*
+ * The benchmark stands in for the MQTT agent.  A producer task timestamps a
+ * packet every taskpooltestBENCH_PERIOD and a network task, which runs at the
+ * same priority as the workers, receives the packets and invokes a callback
+ * that takes longer than the packet period.  The time from a packet being sent
+ * to the network task receiving it is measured with the callbacks invoked
+ * inline and then with the callbacks dispatched to the task pool.
+ */
+static QueueHandle_t xPacketQueue;
+static volatile uint32_t ulCallbacksRun;
+static BaseType_t xUseTaskPool;
+static uint32_t ulLatencyTotal;
+static uint32_t ulLatencyWorst;
+
+/*-----------------------------------------------------------*/
+
+static void prvSlowCallback( void * pvParameter1,
+                             uint32_t ulParameter2 )
+{
+    ( void ) pvParameter1;
+    ( void ) ulParameter2;
+
+    vTaskDelay( taskpooltestBENCH_CALLBACK );
+
+    taskENTER_CRITICAL();
+    {
+        ulCallbacksRun++;
+    }
+    taskEXIT_CRITICAL();
+}
+
+/*-----------------------------------------------------------*/
+
+static void prvProducerTask( void * pvParameters )
+{
+    TickType_t xLastWakeTime = xTaskGetTickCount();
+    uint32_t ulPacket, ulStamp;
+
+    ( void ) pvParameters;
+
+    for( ulPacket = 0; ulPacket < taskpooltestBENCH_PACKETS; ulPacket++ )
+    {
+        vTaskDelayUntil( &xLastWakeTime, taskpooltestBENCH_PERIOD );
+        ulStamp = ( uint32_t ) portGET_RUN_TIME_COUNTER_VALUE();
+        configASSERT( xQueueSend( xPacketQueue, &ulStamp, 0 ) == pdPASS );
+    }
+
+    vTaskDelete( NULL );
+}
+
+/*-----------------------------------------------------------*/
+
+static void prvNetworkTask( void * pvParameters )
+{
+    uint32_t ulPacket, ulStamp, ulLatency;
+
+    ( void ) pvParameters;
+
+    for( ulPacket = 0; ulPacket < taskpooltestBENCH_PACKETS; ulPacket++ )
+    {
+        configASSERT( xQueueReceive( xPacketQueue, &ulStamp, taskpooltestTIMEOUT ) == pdPASS );
+        ulLatency = ( uint32_t ) portGET_RUN_TIME_COUNTER_VALUE() - ulStamp;
+        ulLatencyTotal += ulLatency;
+
+        if( ulLatency > ulLatencyWorst )
+        {
+            ulLatencyWorst = ulLatency;
+        }
+
+        /* As the MQTT agent does, fall back to invoking the callback inline
+         * if the task pool is busy. */
+        if( ( xUseTaskPool == pdFALSE ) ||
+            ( TASKPOOL_Submit( prvSlowCallback, NULL, ulPacket, eTaskPoolLaneNormal ) != pdPASS ) )
+        {
+            prvSlowCallback( NULL, ulPacket );
+        }
+    }
+
+    xTaskNotifyGive( xTestTask );
+    vTaskDelete( NULL );
+}
+
+/*-----------------------------------------------------------*/
+
+TEST( Full_TASKPOOL, network_latency_vs_slow_callbacks )
+{
+    #if ( configGENERATE_RUN_TIME_STATS == 1 )
+        static const char * const pcModes[] = { "inline", "task pool" };
+        uint32_t ulMeans[ 2 ];
+        TickType_t xWaited;
+
+        xTestTask = xTaskGetCurrentTaskHandle();
+        xPacketQueue = xQueueCreate( taskpooltestBENCH_PACKETS, sizeof( uint32_t ) );
+        TEST_ASSERT_NOT_NULL( xPacketQueue );
+
+        for( xUseTaskPool = pdFALSE; xUseTaskPool <= pdTRUE; xUseTaskPool++ )
+        {
+            ulCallbacksRun = 0;
+            ulLatencyTotal = 0;
+            ulLatencyWorst = 0;
+
+            TEST_ASSERT_EQUAL( pdPASS, xTaskCreate( prvNetworkTask,
+                                                    "PoolNetwork",
+                                                    configMINIMAL_STACK_SIZE * 2,
+                                                    NULL,
+                                                    taskpoolconfigWORKER_PRIORITY,
+                                                    NULL ) );
+            TEST_ASSERT_EQUAL( pdPASS, xTaskCreate( prvProducerTask,
+                                                    "PoolProducer",
+                                                    configMINIMAL_STACK_SIZE * 2,
+                                                    NULL,
+                                                    taskpoolconfigWORKER_PRIORITY + 1,
+                                                    NULL ) );
+
+            TEST_ASSERT_NOT_EQUAL( 0, ulTaskNotifyTake( pdTRUE, taskpooltestTIMEOUT ) );
+
+            /* Every callback ran, either inline or on a worker. */
+            for( xWaited = 0; ( ulCallbacksRun < taskpooltestBENCH_PACKETS ) && ( xWaited < taskpooltestTIMEOUT ); xWaited++ )
+            {
+                vTaskDelay( 1 );
+            }
+
+            TEST_ASSERT_EQUAL_UINT32( taskpooltestBENCH_PACKETS, ulCallbacksRun );
+
+            ulMeans[ xUseTaskPool ] = ulLatencyTotal / taskpooltestBENCH_PACKETS;
+            configPRINTF( ( "Network latency with slow callbacks %s: run time %u mean, %u worst over %u packets\r\n",
+                            pcModes[ xUseTaskPool ],
+                            ( unsigned ) ulMeans[ xUseTaskPool ],
+                            ( unsigned ) ulLatencyWorst,
+                            ( unsigned ) taskpooltestBENCH_PACKETS ) );
+        }
+
+        vQueueDelete( xPacketQueue );
+
+        /* Inline, the packets queue up behind the callbacks and wait for
+         * several callback periods; with the task pool they wait for little
+         * more than a context switch.  The margin leaves room for slow hosts. */
+        TEST_ASSERT_LESS_THAN_UINT32( ulMeans[ 0 ] / 10, ulMeans[ 1 ] );
+
+        /* Let the idle task free the benchmark tasks. */
+        vTaskDelay( pdMS_TO_TICKS( 10 ) );
+    #else /* if ( configGENERATE_RUN_TIME_STATS == 1 ) */
+        TEST_IGNORE_MESSAGE( "configGENERATE_RUN_TIME_STATS is required" );
+    #endif /* if ( configGENERATE_RUN_TIME_STATS == 1 ) */
+}
@@ -137,6 +137,10 @@ static void RunTests( void )
         RUN_TEST_GROUP( Full_DEFENDER );
     #endif
 
+    #if ( testrunnerFULL_DEFENDER_REPORT_ENABLED == 1 )
+        RUN_TEST_GROUP( Full_DEFENDER_REPORT );
+    #endif
+
     #if ( testrunnerFULL_POSIX_ENABLED == 1 )
         RUN_TEST_GROUP( Full_POSIX_CLOCK );
         RUN_TEST_GROUP( Full_POSIX_MQUEUE );
@@ -151,6 +155,28 @@ static void RunTests( void )
         RUN_TEST_GROUP( Full_FREERTOS_TCP );
     #endif
 
+    #if ( testrunnerFULL_KERNEL_ENABLED == 1 )
+        RUN_TEST_GROUP( Full_KERNEL_QUEUE );
+        RUN_TEST_GROUP( Full_KERNEL_TASK_NOTIFY );
+        RUN_TEST_GROUP( Full_KERNEL_DELAY );
+    #endif
+
+    #if ( testrunnerFULL_TASKPOOL_ENABLED == 1 )
+        RUN_TEST_GROUP( Full_TASKPOOL );
+    #endif
+
+    #if ( testrunnerFULL_TRACE_RING_ENABLED == 1 )
+        RUN_TEST_GROUP( Full_TRACE_RING );
+    #endif
+
+    #if ( testrunnerFULL_METRICS_ENABLED == 1 )
+        RUN_TEST_GROUP( Full_METRICS );
+    #endif
+
+    #if ( testrunnerFULL_SPSC_RING_ENABLED == 1 )
+        RUN_TEST_GROUP( Full_SPSC_RING );
+    #endif
+
     #if ( testrunnerOTA_END_TO_END_ENABLED == 1 )
         extern void vStartOTAUpdateDemoTask( void );
         vStartOTAUpdateDemoTask();
@@ -160,6 +186,8 @@ static void RunTests( void )
 
 void TEST_RUNNER_RunTests_task( void * pvParameters )
 {
+    int iFailures;
+
     /* Initialize unity. */
     UnityFixture.Verbose = 1;
     UnityFixture.GroupFilter = 0;
@@ -194,7 +222,14 @@ void TEST_RUNNER_RunTests_task( void * pvParameters )
     #endif /* if ( testrunnerFULL_MEMORYLEAK_ENABLED == 1 ) */
 
     /* Currently disabled. Will be enabled after cleanup. */
-    UNITY_END();
+    iFailures = UNITY_END();
+
+    /* Host builds can end the process here to report the result. */
+    #ifdef testrunnerEXIT_WHEN_DONE
+        testrunnerEXIT_WHEN_DONE( iFailures );
+    #else
+        ( void ) iFailures;
+    #endif
 
     #ifdef CODE_COVERAGE
         exit( 0 );
@@ -0,0 +1,396 @@
+/*
+ * Amazon FreeRTOS
+ * Copyright (C) 2018 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+/**
+ * @file aws_test_trace_ring.c
+ * @brief Tests for the trace ring.
+ */
+
+/* Standard includes. */
+#include <stdint.h>
+#include <string.h>
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+
+/* Trace ring includes. */
+#include "aws_trace_ring.h"
+#include "aws_trace_ring_config.h"
+#include "aws_trace_ring_config_defaults.h"
+
+/* Test includes. */
+#include "unity_fixture.h"
+#include "unity.h"
+
+/**
+ * @brief Configuration for this test group.
+ */
+#define traceringtestTIMEOUT           pdMS_TO_TICKS( 1000 )
+#define traceringtestMAX_TASKS         ( 32 )
+#define traceringtestBENCH_RECORDS     ( 100000UL )
+#define traceringtestDUMP_SIZE                                                                        \
+    ( sizeof( TraceRingHeader_t ) +                                                                   \
+      traceringtestMAX_TASKS * ( sizeof( TraceRingTask_t ) + configMAX_TASK_NAME_LEN ) +            \
+      traceringconfigNUM_RECORDS * sizeof( TraceRingRecord_t ) )
+
+/*
+ * @brief Test group definition.
+ */
+TEST_GROUP( Full_TRACE_RING );
+
+TEST_SETUP( Full_TRACE_RING )
+{
+    TRACERING_Clear();
+}
+
+TEST_TEAR_DOWN( Full_TRACE_RING )
+{
+}
+
+TEST_GROUP_RUNNER( Full_TRACE_RING )
+{
+    RUN_TEST_CASE( Full_TRACE_RING, records_queue_handoff );
+    RUN_TEST_CASE( Full_TRACE_RING, overwrites_oldest_records );
+    RUN_TEST_CASE( Full_TRACE_RING, failed_dump_resumes_recording );
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Where the dumps are written.
+ */
+typedef struct DumpBuffer
+{
+    uint8_t ucData[ traceringtestDUMP_SIZE ];
+    size_t xLength;
+} DumpBuffer_t;
+
+static DumpBuffer_t xDump;
+static TaskHandle_t xTestTask;
+
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvBufferWriter( void * pvContext,
+                                   const void * pvData,
+                                   size_t xLength )
+{
+    DumpBuffer_t * pxDump = ( DumpBuffer_t * ) pvContext;
+    BaseType_t xResult = pdFAIL;
+
+    if( xLength <= sizeof( pxDump->ucData ) - pxDump->xLength )
+    {
+        memcpy( &pxDump->ucData[ pxDump->xLength ], pvData, xLength );
+        pxDump->xLength += xLength;
+        xResult = pdPASS;
+    }
+
+    return xResult;
+}
+
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvFailingWriter( void * pvContext,
+                                    const void * pvData,
+                                    size_t xLength )
+{
+    ( void ) pvContext;
+    ( void ) pvData;
+    ( void ) xLength;
+
+    return pdFAIL;
+}
+
+/*-----------------------------------------------------------*/
+
+static void prvReceiverTask( void * pvParameters )
+{
+    QueueHandle_t xQueue = ( QueueHandle_t ) pvParameters;
+    uint32_t ulValue;
+
+    ( void ) xQueueReceive( xQueue, &ulValue, traceringtestTIMEOUT );
+    xTaskNotifyGive( xTestTask );
+    vTaskDelete( NULL );
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Dumps the ring into xDump and checks the header.
+ *
+ * @param[out] pxHeader The header of the dump.
+ *
+ * @return The offset of the first record.
+ */
+static size_t prvDump( TraceRingHeader_t * pxHeader )
+{
+    size_t xRecordsOffset;
+
+    xDump.xLength = 0;
+    TEST_ASSERT_EQUAL( pdPASS, TRACERING_Dump( prvBufferWriter, &xDump ) );
+    TEST_ASSERT_TRUE( xDump.xLength >= sizeof( TraceRingHeader_t ) );
+
+    memcpy( pxHeader, xDump.ucData, sizeof( TraceRingHeader_t ) );
+    TEST_ASSERT_EQUAL_UINT32( traceringMAGIC, pxHeader->ulMagic );
+    TEST_ASSERT_EQUAL( traceringVERSION, pxHeader->usVersion );
+    TEST_ASSERT_EQUAL( sizeof( TraceRingRecord_t ), pxHeader->usRecordSize );
+    TEST_ASSERT_EQUAL_UINT32( traceringconfigTIMESTAMP_HZ, pxHeader->ulTimestampHz );
+    TEST_ASSERT_EQUAL( configMAX_TASK_NAME_LEN, pxHeader->usTaskNameLength );
+
+    xRecordsOffset = sizeof( TraceRingHeader_t ) +
+                     pxHeader->usTaskCount * ( sizeof( TraceRingTask_t ) + pxHeader->usTaskNameLength );
+    TEST_ASSERT_EQUAL( xRecordsOffset + pxHeader->ulRecordCount * sizeof( TraceRingRecord_t ), xDump.xLength );
+
+    return xRecordsOffset;
+}
+
+/*-----------------------------------------------------------*/
+
+static void prvGetRecord( size_t xRecordsOffset,
+                          uint32_t ulIndex,
+                          TraceRingRecord_t * pxRecord )
+{
+    /* Task names have any length, so the records are not aligned. */
+    memcpy( pxRecord,
+            &xDump.ucData[ xRecordsOffset + ulIndex * sizeof( TraceRingRecord_t ) ],
+            sizeof( TraceRingRecord_t ) );
+}
+
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvDumpListsTask( const TraceRingHeader_t * pxHeader,
+                                    uint32_t ulTaskNumber,
+                                    const char * pcName )
+{
+    TraceRingTask_t xTask;
+    size_t xOffset = sizeof( TraceRingHeader_t );
+    uint16_t usTask;
+    BaseType_t xFound = pdFALSE;
+
+    for( usTask = 0; ( usTask < pxHeader->usTaskCount ) && ( xFound == pdFALSE ); usTask++ )
+    {
+        memcpy( &xTask, &xDump.ucData[ xOffset ], sizeof( xTask ) );
+        xOffset += sizeof( xTask );
+
+        if( ( xTask.ulTaskNumber == ulTaskNumber ) &&
+            ( strncmp( ( const char * ) &xDump.ucData[ xOffset ], pcName, pxHeader->usTaskNameLength ) == 0 ) )
+        {
+            xFound = pdTRUE;
+        }
+
+        xOffset += pxHeader->usTaskNameLength;
+    }
+
+    return xFound;
+}
+
+/*-----------------------------------------------------------*/
+
+TEST( Full_TRACE_RING, records_queue_handoff )
+{
+    TraceRingHeader_t xHeader;
+    TraceRingRecord_t xRecord, xPrevious;
+    QueueHandle_t xQueue = NULL;
+    TaskHandle_t xReceiver;
+    uint32_t ulIndex, ulValue = 0, ulTestTask, ulReceiver, ulQueue;
+    size_t xRecordsOffset;
+    UBaseType_t uxExpected = 0;
+
+    /* The order in which the events of a hand off through a queue must
+     * appear, with the task and the argument expected. */
+    struct
+    {
+        uint8_t ucEvent;
+        uint32_t * pulTask;
+    }
+    xExpected[] =
+    {
+        { traceringEVENT_BLOCKING_ON_QUEUE_RECEIVE, &ulReceiver },
+        { traceringEVENT_QUEUE_SEND,                &ulTestTask },
+        { traceringEVENT_TASK_READY,                &ulReceiver },
+        { traceringEVENT_TASK_SWITCHED_IN,          &ulReceiver }
+    };
+
+    xTestTask = xTaskGetCurrentTaskHandle();
+    ( void ) ulTaskNotifyTake( pdTRUE, 0 );
+    ulTestTask = ( uint32_t ) uxTaskGetTaskNumber( xTestTask );
+
+    if( TEST_PROTECT() )
+    {
+        xQueue = xQueueCreate( 1, sizeof( uint32_t ) );
+        TEST_ASSERT_NOT_NULL( xQueue );
+        ulQueue = traceringADDRESS( xQueue );
+
+        /* The receiver has the higher priority, so it blocks on the queue
+         * before xTaskCreate() returns, and runs again as soon as the value is
+         * sent. */
+        TEST_ASSERT_EQUAL( pdPASS, xTaskCreate( prvReceiverTask,
+                                                "TraceRx",
+                                                configMINIMAL_STACK_SIZE * 4,
+                                                xQueue,
+                                                uxTaskPriorityGet( NULL ) + 1,
+                                                &xReceiver ) );
+        ulReceiver = ( uint32_t ) uxTaskGetTaskNumber( xReceiver );
+        TEST_ASSERT_NOT_EQUAL( 0, ulReceiver );
+        TEST_ASSERT_EQUAL( pdPASS, xQueueSend( xQueue, &ulValue, 0 ) );
+        TEST_ASSERT_NOT_EQUAL( 0, ulTaskNotifyTake( pdTRUE, traceringtestTIMEOUT ) );
+
+        xRecordsOffset = prvDump( &xHeader );
+        TEST_ASSERT_EQUAL_UINT32( 0, xHeader.ulRecordsLost );
+        TEST_ASSERT_EQUAL( pdTRUE, prvDumpListsTask( &xHeader, ulTestTask, pcTaskGetName( NULL ) ) );
+
+        memset( &xPrevious, 0x00, sizeof( xPrevious ) );
+
+        for( ulIndex = 0; ulIndex < xHeader.ulRecordCount; ulIndex++ )
+        {
+            prvGetRecord( xRecordsOffset, ulIndex, &xRecord );
+            TEST_ASSERT_TRUE( xRecord.ulTimestamp >= xPrevious.ulTimestamp );
+
+            if( ( uxExpected < sizeof( xExpected ) / sizeof( xExpected[ 0 ] ) ) &&
+                ( xRecord.ucEvent == xExpected[ uxExpected ].ucEvent ) &&
+                ( xRecord.usTask == *xExpected[ uxExpected ].pulTask ) )
+            {
+                /* The queue events carry the queue, the task events the
+                 * priority. */
+                if( ( xRecord.ucEvent == traceringEVENT_TASK_READY ) ||
+                    ( xRecord.ucEvent == traceringEVENT_TASK_SWITCHED_IN ) )
+                {
+                    TEST_ASSERT_EQUAL_UINT32( uxTaskPriorityGet( NULL ) + 1, xRecord.ulArg1 );
+                }
+                else
+                {
+                    TEST_ASSERT_EQUAL_UINT32( ulQueue, xRecord.ulArg1 );
+                }
+
+                uxExpected++;
+            }
+
+            xPrevious = xRecord;
+        }
+
+        TEST_ASSERT_EQUAL( sizeof( xExpected ) / sizeof( xExpected[ 0 ] ), uxExpected );
+    }
+
+    if( xQueue != NULL )
+    {
+        /* Let the idle task free the receiver before the queue goes. */
+        vTaskDelay( pdMS_TO_TICKS( 10 ) );
+        vQueueDelete( xQueue );
+    }
+}
+
+/*-----------------------------------------------------------*/
+
+TEST( Full_TRACE_RING, overwrites_oldest_records )
+{
+    TraceRingHeader_t xHeader;
+    TraceRingRecord_t xRecord, xPrevious;
+    uint32_t ulIndex, ulStart, ulEnd;
+    uint32_t ulLastSize = traceringconfigNUM_RECORDS + 10;
+    size_t xRecordsOffset;
+    BaseType_t xLastFound = pdFALSE;
+    void * pvBlock;
+
+    /* Two records per block, so the first records written are overwritten. */
+    for( ulIndex = 1; ulIndex <= ulLastSize; ulIndex++ )
+    {
+        pvBlock = pvPortMalloc( ulIndex );
+        TEST_ASSERT_NOT_NULL( pvBlock );
+        vPortFree( pvBlock );
+    }
+
+    xRecordsOffset = prvDump( &xHeader );
+    TEST_ASSERT_EQUAL_UINT32( traceringconfigNUM_RECORDS, xHeader.ulRecordCount );
+    TEST_ASSERT_TRUE( xHeader.ulRecordsLost >= 2 * ulLastSize - traceringconfigNUM_RECORDS );
+
+    memset( &xPrevious, 0x00, sizeof( xPrevious ) );
+
+    for( ulIndex = 0; ulIndex < xHeader.ulRecordCount; ulIndex++ )
+    {
+        prvGetRecord( xRecordsOffset, ulIndex, &xRecord );
+
+        /* Oldest first, also across the end of the array. */
+        TEST_ASSERT_TRUE( xRecord.ulTimestamp >= xPrevious.ulTimestamp );
+
+        if( xRecord.ucEvent == traceringEVENT_MALLOC )
+        {
+            TEST_ASSERT_NOT_EQUAL( 1, xRecord.ulArg2 );
+
+            if( xRecord.ulArg2 == ulLastSize )
+            {
+                xLastFound = pdTRUE;
+            }
+        }
+
+        xPrevious = xRecord;
+    }
+
+    TEST_ASSERT_EQUAL( pdTRUE, xLastFound );
+
+    /* The cost of a record, as seen by the kernel. */
+    ulStart = traceringconfigGET_TIMESTAMP();
+
+    for( ulIndex = 0; ulIndex < traceringtestBENCH_RECORDS; ulIndex++ )
+    {
+        TRACERING_Record( traceringEVENT_QUEUE_SEND, NULL, ulIndex, 0 );
+    }
+
+    ulEnd = traceringconfigGET_TIMESTAMP();
+
+    configPRINTF( ( "Trace ring: %u records in %u timestamp units at %u Hz.\r\n",
+                    ( unsigned ) traceringtestBENCH_RECORDS,
+                    ( unsigned ) ( ulEnd - ulStart ),
+                    ( unsigned ) traceringconfigTIMESTAMP_HZ ) );
+}
+
+/*-----------------------------------------------------------*/
+
+TEST( Full_TRACE_RING, failed_dump_resumes_recording )
+{
+    TraceRingHeader_t xHeader;
+    TraceRingRecord_t xRecord;
+    uint32_t ulIndex;
+    size_t xRecordsOffset;
+    BaseType_t xFound = pdFALSE;
+
+    TEST_ASSERT_EQUAL( pdFAIL, TRACERING_Dump( prvFailingWriter, NULL ) );
+
+    TRACERING_Record( traceringEVENT_QUEUE_SEND, NULL, 0x1234, 0 );
+
+    xRecordsOffset = prvDump( &xHeader );
+
+    for( ulIndex = 0; ulIndex < xHeader.ulRecordCount; ulIndex++ )
+    {
+        prvGetRecord( xRecordsOffset, ulIndex, &xRecord );
+
+        if( ( xRecord.ucEvent == traceringEVENT_QUEUE_SEND ) && ( xRecord.ulArg1 == 0x1234 ) )
+        {
+            xFound = pdTRUE;
+        }
+    }
+
+    TEST_ASSERT_EQUAL( pdTRUE, xFound );
+}
@@ -0,0 +1,364 @@
+/*
+ * Amazon FreeRTOS
+ * Copyright (C) 2017 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+/**
+ * @file main.c
+ * @brief Implements the main function.
+ */
+
+
+/* Standard includes. */
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <string.h>
+#include <strings.h>
+#include <time.h>
+#include <unistd.h>
+
+/* FreeRTOS include. */
+#include <FreeRTOS.h>
+#include "task.h"
+
+/* Test runner includes. */
+#include "aws_test_runner.h"
+
+/* AWS System application includes. */
+#include "FreeRTOS_IP.h"
+#include "FreeRTOS_Sockets.h"
+
+/* Define a name that will be used for LLMNR and NBNS searches. Once running,
+ * you can "ping RTOSDemo" instead of pinging the IP address, which is useful when
+ * using DHCP. */
+#define mainHOST_NAME                  "TestRunner"
+#define mainDEVICE_NICK_NAME           "linux_TestRunner"
+
+#define TEST_RUNNER_TASK_STACK_SIZE    10000
+
+/*-----------------------------------------------------------*/
+
+/* The number of failed tests, returned by main() as the exit status. */
+static int iTestFailures = 0;
+
+/* State of the pseudo random number generator, seeded in main(). */
+static uint32_t ulNextRand;
+
+/* The number of calls to pvPortMalloc(), see configHEAP_ALLOCATION_COUNT(). */
+uint32_t ulHeapAllocationCount = 0;
+
+/* Default MAC address configuration.  The test runner creates a virtual network
+ * connection that uses this MAC address, see configLINUX_NETWORK_BACKEND in
+ * FreeRTOSConfig.h for the ways in which frames are exchanged with the host. */
+const uint8_t ucMACAddress[ 6 ] =
+{
+    configMAC_ADDR0,
+    configMAC_ADDR1,
+    configMAC_ADDR2,
+    configMAC_ADDR3,
+    configMAC_ADDR4,
+    configMAC_ADDR5
+};
+
+/* The default IP and MAC address used by the demo.  The address configuration
+ * defined here will be used if ipconfigUSE_DHCP is 0, or if ipconfigUSE_DHCP is
+ * 1 but a DHCP server could not be contacted.  See the online documentation for
+ * more information.  In both cases the node can be discovered using
+ * "ping RTOSDemo". */
+static const uint8_t ucIPAddress[ 4 ] =
+{
+    configIP_ADDR0,
+    configIP_ADDR1,
+    configIP_ADDR2,
+    configIP_ADDR3
+};
+static const uint8_t ucNetMask[ 4 ] =
+{
+    configNET_MASK0,
+    configNET_MASK1,
+    configNET_MASK2,
+    configNET_MASK3
+};
+static const uint8_t ucGatewayAddress[ 4 ] =
+{
+    configGATEWAY_ADDR0,
+    configGATEWAY_ADDR1,
+    configGATEWAY_ADDR2,
+    configGATEWAY_ADDR3
+};
+static const uint8_t ucDNSServerAddress[ 4 ] =
+{
+    configDNS_SERVER_ADDR0,
+    configDNS_SERVER_ADDR1,
+    configDNS_SERVER_ADDR2,
+    configDNS_SERVER_ADDR3
+};
+
+/*-----------------------------------------------------------*/
+
+int main( void )
+{
+    ulNextRand = ( uint32_t ) time( NULL ) ^ ( ( uint32_t ) getpid() << 16 );
+
+    /* Initialize the network interface.
+     *
+     ***NOTE*** Tasks that use the network are created in the network event hook
+     * when the network is connected and ready for use (see the definition of
+     * vApplicationIPNetworkEventHook() below).  The address values passed in here
+     * are used if ipconfigUSE_DHCP is set to 0, or if ipconfigUSE_DHCP is set to 1
+     * but a DHCP server cannot be contacted. */
+    FreeRTOS_printf( ( "FreeRTOS_IPInit\n" ) );
+    FreeRTOS_IPInit(
+        ucIPAddress,
+        ucNetMask,
+        ucGatewayAddress,
+        ucDNSServerAddress,
+        ucMACAddress );
+
+    /* Only returns when the test runner called vTestRunnerExit(). */
+    vTaskStartScheduler();
+
+    return iTestFailures;
+}
+/*-----------------------------------------------------------*/
+
+void vTestRunnerExit( int iFailures )
+{
+    /* Let main() return the result, so that the process can be used in scripts
+     * and by tools that wrap it, such as perf or valgrind. */
+    iTestFailures = ( iFailures != 0 ) ? EXIT_FAILURE : EXIT_SUCCESS;
+    vTaskEndScheduler();
+}
+/*-----------------------------------------------------------*/
+
+void vApplicationIPNetworkEventHook( eIPCallbackEvent_t eNetworkEvent )
+{
+    static BaseType_t xTasksAlreadyCreated = pdFALSE;
+
+    /* If the network has just come up...*/
+    if( ( eNetworkEvent == eNetworkUp ) && ( xTasksAlreadyCreated == pdFALSE ) )
+    {
+        xTaskCreate( TEST_RUNNER_RunTests_task,
+                     "TestRunner",
+                     TEST_RUNNER_TASK_STACK_SIZE,
+                     NULL,
+                     tskIDLE_PRIORITY, NULL );
+
+        xTasksAlreadyCreated = pdTRUE;
+    }
+}
+/*-----------------------------------------------------------*/
+
+#if ( ( ipconfigUSE_LLMNR != 0 ) || \
+    ( ipconfigUSE_NBNS != 0 ) ||    \
+    ( ipconfigDHCP_REGISTER_HOSTNAME == 1 ) )
+
+    const char * pcApplicationHostnameHook( void )
+    {
+        /* This function will be called during the DHCP: the machine will be registered
+         * with an IP address plus this name. */
+        return mainHOST_NAME;
+    }
+
+#endif /* if ( ( ipconfigUSE_LLMNR != 0 ) || ( ipconfigUSE_NBNS != 0 ) || ( ipconfigDHCP_REGISTER_HOSTNAME == 1 ) ) */
+/*-----------------------------------------------------------*/
+
+#if ( ipconfigUSE_LLMNR != 0 ) || ( ipconfigUSE_NBNS != 0 )
+
+    BaseType_t xApplicationDNSQueryHook( const char * pcName )
+    {
+        BaseType_t xReturn;
+
+        /* Determine if a name lookup is for this node.  Two names are given
+         * to this node: that returned by pcApplicationHostnameHook() and that set
+         * by mainDEVICE_NICK_NAME. */
+        if( strcasecmp( pcName, pcApplicationHostnameHook() ) == 0 )
+        {
+            xReturn = pdPASS;
+        }
+        else if( strcasecmp( pcName, mainDEVICE_NICK_NAME ) == 0 )
+        {
+            xReturn = pdPASS;
+        }
+        else
+        {
+            xReturn = pdFAIL;
+        }
+
+        return xReturn;
+    }
+
+#endif /* if ( ipconfigUSE_LLMNR != 0 ) || ( ipconfigUSE_NBNS != 0 ) */
+/*-----------------------------------------------------------*/
+
+void vApplicationIdleHook( void )
+{
+    const useconds_t xMicroSecondsToSleep = 1000;
+
+    /* vApplicationIdleHook() will only be called if configUSE_IDLE_HOOK is set
+     * to 1 in FreeRTOSConfig.h.  It must *NOT* attempt to block in the FreeRTOS
+     * sense.  Sleeping in the host thread is allowed: the next tick interrupts
+     * the sleep.  In this case the idle task just sleeps to lower the CPU usage,
+     * which also keeps the idle task out of profiles taken with perf. */
+    usleep( xMicroSecondsToSleep );
+}
+/*-----------------------------------------------------------*/
+
+void vAssertCalled( const char * pcFile,
+                    uint32_t ulLine )
+{
+    taskDISABLE_INTERRUPTS();
+    printf( "vAssertCalled %s, %ld\n", pcFile, ( long ) ulLine );
+    fflush( stdout );
+
+    /* End the process, so that a debugger or a sanitizer reports where the
+     * assertion failed. */
+    abort();
+}
+/*-----------------------------------------------------------*/
+
+void vApplicationMallocFailedHook()
+{
+    /* The TCP tests will test behavior when the entire heap is allocated. In
+     * order to avoid interfering with those tests, this function does nothing. */
+}
+/*-----------------------------------------------------------*/
+
+void vLoggingPrintf( const char * pcFormat,
+                     ... )
+{
+    va_list xArgs;
+
+    /* A task can be switched out at any point, see the notes about configPRINTF()
+     * in FreeRTOSConfig.h. */
+    va_start( xArgs, pcFormat );
+    taskENTER_CRITICAL();
+    {
+        vprintf( pcFormat, xArgs );
+        fflush( stdout );
+    }
+    taskEXIT_CRITICAL();
+    va_end( xArgs );
+}
+/*-----------------------------------------------------------*/
+
+void vLoggingPrint( const char * pcMessage )
+{
+    taskENTER_CRITICAL();
+    {
+        fputs( pcMessage, stdout );
+        fflush( stdout );
+    }
+    taskEXIT_CRITICAL();
+}
+/*-----------------------------------------------------------*/
+
+uint32_t ulRand( void )
+{
+    uint32_t ulReturn;
+
+    /* A xorshift generator.  The functions of the C library that produce random
+     * numbers take a lock, which a task must not hold when it is switched out. */
+    taskENTER_CRITICAL();
+    {
+        ulNextRand ^= ulNextRand << 13;
+        ulNextRand ^= ulNextRand >> 17;
+        ulNextRand ^= ulNextRand << 5;
+        ulReturn = ulNextRand;
+    }
+    taskEXIT_CRITICAL();
+
+    return ulReturn;
+}
+/*-----------------------------------------------------------*/
+
+uint32_t ulApplicationGetNextSequenceNumber( uint32_t ulSourceAddress,
+                                             uint16_t usSourcePort,
+                                             uint32_t ulDestinationAddress,
+                                             uint16_t usDestinationPort )
+{
+    ( void ) ulSourceAddress;
+    ( void ) usSourcePort;
+    ( void ) ulDestinationAddress;
+    ( void ) usDestinationPort;
+
+    /* The test runner does not connect to other hosts, so a random number is
+     * good enough as an initial sequence number. */
+    return ulRand();
+}
+/*-----------------------------------------------------------*/
+
+/* configUSE_STATIC_ALLOCATION is set to 1, so the application must provide an
+ * implementation of vApplicationGetIdleTaskMemory() to provide the memory that is
+ * used by the Idle task. */
+void vApplicationGetIdleTaskMemory( StaticTask_t ** ppxIdleTaskTCBBuffer,
+                                    StackType_t ** ppxIdleTaskStackBuffer,
+                                    uint32_t * pulIdleTaskStackSize )
+{
+    /* If the buffers to be provided to the Idle task are declared inside this
+     * function then they must be declared static - otherwise they will be allocated on
+     * the stack and so not exists after this function exits. */
+    static StaticTask_t xIdleTaskTCB;
+    static StackType_t uxIdleTaskStack[ configMINIMAL_STACK_SIZE ];
+
+    /* Pass out a pointer to the StaticTask_t structure in which the Idle
+     * task's state will be stored. */
+    *ppxIdleTaskTCBBuffer = &xIdleTaskTCB;
+
+    /* Pass out the array that will be used as the Idle task's stack. */
+    *ppxIdleTaskStackBuffer = uxIdleTaskStack;
+
+    /* Pass out the size of the array pointed to by *ppxIdleTaskStackBuffer.
+     * Note that, as the array is necessarily of type StackType_t,
+     * configMINIMAL_STACK_SIZE is specified in words, not bytes. */
+    *pulIdleTaskStackSize = configMINIMAL_STACK_SIZE;
+}
+/*-----------------------------------------------------------*/
+
+/* configUSE_STATIC_ALLOCATION and configUSE_TIMERS are both set to 1, so the
+ * application must provide an implementation of vApplicationGetTimerTaskMemory()
+ * to provide the memory that is used by the Timer service task. */
+void vApplicationGetTimerTaskMemory( StaticTask_t ** ppxTimerTaskTCBBuffer,
+                                     StackType_t ** ppxTimerTaskStackBuffer,
+                                     uint32_t * pulTimerTaskStackSize )
+{
+    /* If the buffers to be provided to the Timer task are declared inside this
+     * function then they must be declared static - otherwise they will be allocated on
+     * the stack and so not exists after this function exits. */
+    static StaticTask_t xTimerTaskTCB;
+    static StackType_t uxTimerTaskStack[ configTIMER_TASK_STACK_DEPTH ];
+
+    /* Pass out a pointer to the StaticTask_t structure in which the Timer
+     * task's state will be stored. */
+    *ppxTimerTaskTCBBuffer = &xTimerTaskTCB;
+
+    /* Pass out the array that will be used as the Timer task's stack. */
+    *ppxTimerTaskStackBuffer = uxTimerTaskStack;
+
+    /* Pass out the size of the array pointed to by *ppxTimerTaskStackBuffer.
+     * Note that, as the array is necessarily of type StackType_t,
+     * configTIMER_TASK_STACK_DEPTH is specified in words, not bytes. */
+    *pulTimerTaskStackSize = configTIMER_TASK_STACK_DEPTH;
+}
+/*-----------------------------------------------------------*/
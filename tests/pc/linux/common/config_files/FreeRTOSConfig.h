@@ -0,0 +1,268 @@
+/*
+ * FreeRTOS Kernel V10.0.1
+ * Copyright (C) 2017 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+#ifndef FREERTOS_CONFIG_H
+#define FREERTOS_CONFIG_H
+
+#include "unity_internals.h"
+
+/*-----------------------------------------------------------
+* Application specific definitions.
+*
+* These definitions should be adjusted for your particular hardware and
+* application requirements.
+*
+* THESE PARAMETERS ARE DESCRIBED WITHIN THE 'CONFIGURATION' SECTION OF THE
+* FreeRTOS API DOCUMENTATION AVAILABLE ON THE FreeRTOS.org WEB SITE.
+* http://www.freertos.org/a00110.html
+*
+* The bottom of this file contains some constants specific to running the UDP
+* stack in this demo.  Constants specific to FreeRTOS+TCP itself (rather than
+* the demo) are contained in FreeRTOSIPConfig.h.
+*----------------------------------------------------------*/
+#define configENABLE_BACKWARD_COMPATIBILITY        0
+#define configUSE_PREEMPTION                       1
+#define configUSE_PORT_OPTIMISED_TASK_SELECTION    1
+#define configMAX_PRIORITIES                       ( 7 )
+#define configTICK_RATE_HZ                         ( 1000 )                   /* The tick is driven by a host interval timer, which is accurate to well below a millisecond. */
+#define configMINIMAL_STACK_SIZE                   ( ( unsigned short ) 256 ) /* In this simulated case, the stack only has to hold one small structure as the real stack is part of the host thread. */
+#define configTOTAL_HEAP_SIZE                      ( ( size_t ) ( 2048U * 1024U ) )
+#define configMAX_TASK_NAME_LEN                    ( 15 )
+#define configUSE_TRACE_FACILITY                   1
+#define configUSE_16_BIT_TICKS                     0
+#define configIDLE_SHOULD_YIELD                    1
+#define configUSE_CO_ROUTINES                      0
+#define configUSE_MUTEXES                          1
+#define configUSE_RECURSIVE_MUTEXES                1
+#define configQUEUE_REGISTRY_SIZE                  0
+#define configUSE_APPLICATION_TASK_TAG             1
+#define configUSE_COUNTING_SEMAPHORES              1
+#define configUSE_ALTERNATIVE_API                  0
+#define configNUM_THREAD_LOCAL_STORAGE_POINTERS    3
+#define configTASK_NOTIFICATION_ARRAY_ENTRIES      3 /* Index 1 is used by the MQTT agent, index 2 by the task pool. */
+#define configRECORD_STACK_HIGH_ADDRESS            1
+#define configUSE_DELAYED_TASK_WHEEL               1
+#define configDELAYED_TASK_WHEEL_SIZE              256
+
+/* Hook function related definitions. */
+#define configUSE_TICK_HOOK                        0
+#define configUSE_IDLE_HOOK                        1
+#define configUSE_MALLOC_FAILED_HOOK               1
+#define configCHECK_FOR_STACK_OVERFLOW             0 /* Not applicable to the POSIX port. */
+
+/* Software timer related definitions. */
+#define configUSE_TIMERS                           1
+#define configTIMER_TASK_PRIORITY                  ( configMAX_PRIORITIES - 1 )
+#define configTIMER_QUEUE_LENGTH                   5
+#define configTIMER_TASK_STACK_DEPTH               ( configMINIMAL_STACK_SIZE * 2 )
+
+/* Event group related definitions. */
+#define configUSE_EVENT_GROUPS                     1
+
+/* Run time stats gathering definitions.  The POSIX port counts microseconds of
+ * the host's monotonic clock, see portGET_RUN_TIME_COUNTER_VALUE(). */
+#define configGENERATE_RUN_TIME_STATS              1
+
+/* The kernel delay tests time how long the scheduler stays suspended while a
+ * task enters the Blocked state. */
+extern void vKernelTestTraceTaskDelay( void );
+extern void vKernelTestTraceTaskSwitchedOut( void );
+#define traceTASK_DELAY()                          vKernelTestTraceTaskDelay()
+#define traceTASK_SWITCHED_OUT()                   vKernelTestTraceTaskSwitchedOut()
+
+/* Co-routine definitions. */
+#define configUSE_CO_ROUTINES                      0
+#define configMAX_CO_ROUTINE_PRIORITIES            ( 2 )
+
+/* Currently the TCP/IP stack is using dynamic allocation, and the MQTT task is
+ * using static allocation. */
+#define configSUPPORT_DYNAMIC_ALLOCATION           1
+#define configSUPPORT_STATIC_ALLOCATION            1
+
+/* Set the following definitions to 1 to include the API function, or zero
+ * to exclude the API function. */
+#define INCLUDE_vTaskPrioritySet                   1
+#define INCLUDE_uxTaskPriorityGet                  1
+#define INCLUDE_vTaskDelete                        1
+#define INCLUDE_vTaskCleanUpResources              0
+#define INCLUDE_vTaskSuspend                       1
+#define INCLUDE_vTaskDelayUntil                    1
+#define INCLUDE_vTaskDelay                         1
+#define INCLUDE_uxTaskGetStackHighWaterMark        1
+#define INCLUDE_xTaskGetSchedulerState             1
+#define INCLUDE_xTimerGetTimerTaskHandle           0
+#define INCLUDE_xTaskGetIdleTaskHandle             0
+#define INCLUDE_xQueueGetMutexHolder               1
+#define INCLUDE_eTaskGetState                      1
+#define INCLUDE_xEventGroupSetBitsFromISR          1
+#define INCLUDE_xTimerPendFunctionCall             1
+#define INCLUDE_xTaskGetCurrentTaskHandle          1
+#define INCLUDE_xTaskAbortDelay                    1
+
+/* This demo makes use of one or more example stats formatting functions.  These
+ * format the raw data provided by the uxTaskGetSystemState() function in to human
+ * readable ASCII form.  See the notes in the implementation of vTaskList() within
+ * FreeRTOS/Source/tasks.c for limitations. */
+#define configUSE_STATS_FORMATTING_FUNCTIONS       1
+
+/* Assert call defined for debug builds. */
+void vAssertCalled( const char * pcFile,
+                    uint32_t ulLine );
+
+#define configASSERT( x )    if( ( x ) == 0 ) TEST_ABORT()
+
+/* The function that implements FreeRTOS printf style output, and the macro
+ * that maps the configPRINTF() macros to that function.  Every task runs in its
+ * own host thread, and a task can be switched out at any point, so the output
+ * functions write to stdout from within a critical section.  Otherwise a task
+ * could be switched out while it holds the lock of stdout. */
+void vLoggingPrintf( char const * pcFormat,
+                     ... );
+#define configPRINTF( X )    vLoggingPrintf X
+
+/* Non-format version thread-safe print. */
+extern void vLoggingPrint( const char * pcMessage );
+#define configPRINT( X )    vLoggingPrint( X )
+
+/* Application specific definitions follow. **********************************/
+
+/* If configINCLUDE_DEMO_DEBUG_STATS is set to one, then a few basic IP trace
+ * macros are defined to gather some UDP stack statistics that can then be viewed
+ * through the CLI interface. */
+#define configINCLUDE_DEMO_DEBUG_STATS             1
+
+/* The size of the global output buffer that is available for use when there
+ * are multiple command interpreters running at once (for example, one on a UART
+ * and one on TCP/IP).  This is done to prevent an output buffer being defined by
+ * each implementation - which would waste RAM.  In this case, there is only one
+ * command interpreter running, and it has its own local output buffer, so the
+ * global buffer is just set to be one byte long as it is not used and should not
+ * take up unnecessary RAM. */
+#define configCOMMAND_INT_MAX_OUTPUT_SIZE           1
+
+/* Defines the priority of the task used to simulate Ethernet interrupts. */
+#define configMAC_ISR_SIMULATOR_PRIORITY           ( configMAX_PRIORITIES - 1 )
+
+/* The Linux network interface exchanges frames through one of several
+ * back-ends, see portable/NetworkInterface/linux/NetworkInterface.c.  The test
+ * runner uses the loopback back-end (3), which needs no network and no special
+ * privileges: frames sent to the own MAC address are returned to the stack.
+ * Select the TAP back-end (0) and set configLINUX_NETWORK_INTERFACE_NAME to run
+ * the tests that need a real network. */
+#ifndef configLINUX_NETWORK_BACKEND
+    #define configLINUX_NETWORK_BACKEND            3
+#endif
+#define configLINUX_NETWORK_INTERFACE_NAME         "tap0"
+
+/* With the loopback back-end, the TCP tests connect to sockets of the stack
+ * itself.  Frames are never lost there, so the tests drop frames with
+ * vLinuxNetworkDropFrames() to provoke retransmissions.  Broadcasts are only
+ * returned after vLinuxNetworkLoopBroadcasts( 1 ), for the DHCP test.  With
+ * vLinuxNetworkHoldFrames() a test queues up frames that the stack must then
+ * receive in a single chain. */
+#if ( configLINUX_NETWORK_BACKEND == 3 )
+    #define configLINUX_NETWORK_LOOPBACK           1
+#endif
+extern void vLinuxNetworkDropFrames( uint32_t ulCount );
+extern void vLinuxNetworkLoopBroadcasts( uint32_t ulEnable );
+extern void vLinuxNetworkHoldFrames( uint32_t ulHold );
+
+/* The address of an echo server that will be used by the two demo echo client
+ * tasks:
+ * http://www.freertos.org/FreeRTOS-Plus/FreeRTOS_Plus_TCP/TCP_Echo_Clients.html,
+ * http://www.freertos.org/FreeRTOS-Plus/FreeRTOS_Plus_TCP/UDP_Echo_Clients.html. */
+#define configECHO_SERVER_ADDR0                    192
+#define configECHO_SERVER_ADDR1                    168
+#define configECHO_SERVER_ADDR2                    2
+#define configECHO_SERVER_ADDR3                    6
+#define configTCP_ECHO_CLIENT_PORT                 7
+
+/* Default MAC address configuration. */
+#define configMAC_ADDR0                            0x00
+#define configMAC_ADDR1                            0x11
+#define configMAC_ADDR2                            0x22
+#define configMAC_ADDR3                            0x33
+#define configMAC_ADDR4                            0x44
+#define configMAC_ADDR5                            0x12
+
+/* Default IP address configuration.  Used in ipconfigUSE_DHCP is set to 0, or
+ * ipconfigUSE_DHCP is set to 1 but a DNS server cannot be contacted. */
+#define configIP_ADDR0                             192
+#define configIP_ADDR1                             168
+#define configIP_ADDR2                             0
+#define configIP_ADDR3                             105
+
+/* Default gateway IP address configuration.  Used in ipconfigUSE_DHCP is set to
+ * 0, or ipconfigUSE_DHCP is set to 1 but a DNS server cannot be contacted. */
+#define configGATEWAY_ADDR0                        192
+#define configGATEWAY_ADDR1                        168
+#define configGATEWAY_ADDR2                        0
+#define configGATEWAY_ADDR3                        1
+
+/* Default DNS server configuration.  OpenDNS addresses are 208.67.222.222 and
+ * 208.67.220.220.  Used in ipconfigUSE_DHCP is set to 0, or ipconfigUSE_DHCP is
+ * set to 1 but a DNS server cannot be contacted.*/
+#define configDNS_SERVER_ADDR0                     208
+#define configDNS_SERVER_ADDR1                     67
+#define configDNS_SERVER_ADDR2                     222
+#define configDNS_SERVER_ADDR3                     222
+
+/* Default netmask configuration.  Used in ipconfigUSE_DHCP is set to 0, or
+ * ipconfigUSE_DHCP is set to 1 but a DNS server cannot be contacted. */
+#define configNET_MASK0                            255
+#define configNET_MASK1                            255
+#define configNET_MASK2                            255
+#define configNET_MASK3                            0
+
+/* The UDP port to which print messages are sent. */
+#define configPRINT_PORT                           ( 15000 )
+
+#define configPROFILING                            ( 0 )
+
+/* Pseudo random number generater used by some demo tasks. */
+extern uint32_t ulRand();
+#define configRAND32()    ulRand()
+
+/* The platform that FreeRTOS is running on. */
+#define configPLATFORM_NAME    "LinuxSim"
+
+/* Count the calls to pvPortMalloc(), so that tests can check that a code path
+ * does not use the heap at all.  A balanced allocation and free leaves the
+ * free heap size unchanged, the count does not miss it.  The trace ring still
+ * records the allocation. */
+extern uint32_t ulHeapAllocationCount;
+#define configHEAP_ALLOCATION_COUNT()    ( ulHeapAllocationCount )
+#define traceMALLOC( pvAddress, uiSize )                                            \
+    do {                                                                            \
+        ulHeapAllocationCount++;                                                    \
+        TRACERING_Record( traceringEVENT_MALLOC, NULL,                              \
+                          traceringADDRESS( pvAddress ), ( uint32_t ) ( uiSize ) ); \
+    } while( 0 )
+
+/* Record scheduler, queue and heap events in the trace ring, see
+ * aws_trace_ring.h. */
+#include "aws_trace_ring_hooks.h"
+
+#endif /* FREERTOS_CONFIG_H */
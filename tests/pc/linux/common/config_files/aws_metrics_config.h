@@ -0,0 +1,49 @@
+/*
+ * Amazon FreeRTOS
+ * Copyright (C) 2018 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+/**
+ * @file aws_metrics_config.h
+ * @brief Metrics publisher config options.
+ */
+
+#ifndef _AWS_METRICS_CONFIG_H_
+#define _AWS_METRICS_CONFIG_H_
+
+/**
+ * @brief The largest number of tasks listed in a report, enough for the tests
+ * to find their own tasks next to those of the IP stack and the test runner.
+ */
+#define metricsconfigMAX_TASKS    ( 24 )
+
+/**
+ * @brief The figures included in a report.  The heap figures need heap_4 or
+ * heap_5, and this build does not include the MQTT and OTA agents.
+ */
+#define metricsconfigINCLUDE_HEAP               ( 0 )
+#define metricsconfigINCLUDE_NETWORK_BUFFERS    ( 1 )
+#define metricsconfigINCLUDE_MQTT               ( 0 )
+#define metricsconfigINCLUDE_OTA                ( 0 )
+
+#endif /* _AWS_METRICS_CONFIG_H_ */
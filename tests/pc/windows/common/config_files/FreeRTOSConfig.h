@@ -61,6 +61,7 @@
 #define configUSE_COUNTING_SEMAPHORES              1
 #define configUSE_ALTERNATIVE_API                  0
 #define configNUM_THREAD_LOCAL_STORAGE_POINTERS    3      /* FreeRTOS+FAT requires 2 pointers if a CWD is supported. */
+#define configTASK_NOTIFICATION_ARRAY_ENTRIES      3      /* Index 1 is used by the MQTT agent, index 2 by the task pool. */
 #define configRECORD_STACK_HIGH_ADDRESS            1
 
 /* Hook function related definitions. */
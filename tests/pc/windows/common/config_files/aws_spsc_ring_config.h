@@ -0,0 +1,43 @@
+/*
+ * Amazon FreeRTOS
+ * Copyright (C) 2018 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+/**
+ * @file aws_spsc_ring_config.h
+ * @brief SPSC ring config options.
+ */
+
+#ifndef _AWS_SPSC_RING_CONFIG_H_
+#define _AWS_SPSC_RING_CONFIG_H_
+
+/**
+ * @brief The barriers.  x86 keeps loads and stores in order except for a
+ * store followed by a load, so only the full barrier needs an instruction.
+ * Windows.h is included by portmacro.h.
+ */
+#define spscringconfigACQUIRE_BARRIER()    _ReadWriteBarrier()
+#define spscringconfigRELEASE_BARRIER()    _ReadWriteBarrier()
+#define spscringconfigMEMORY_BARRIER()     MemoryBarrier()
+
+#endif /* _AWS_SPSC_RING_CONFIG_H_ */
@@ -41,8 +41,11 @@
 #define testrunnerFULL_CRYPTO_ENABLED              0
 #define testrunnerFULL_FREERTOS_TCP_ENABLED        0
 #define testrunnerFULL_DEFENDER_ENABLED            0
+#define testrunnerFULL_DEFENDER_REPORT_ENABLED     0
 #define testrunnerFULL_GGD_ENABLED                 0
 #define testrunnerFULL_GGD_HELPER_ENABLED          0
+#define testrunnerFULL_KERNEL_ENABLED              0
+#define testrunnerFULL_METRICS_ENABLED             0
 #define testrunnerFULL_MQTT_AGENT_ENABLED          0
 #define testrunnerFULL_MQTT_ALPN_ENABLED           0
 #define testrunnerFULL_MQTT_ENABLED                0
@@ -50,6 +53,9 @@
 #define testrunnerFULL_PKCS11_ENABLED              0
 #define testrunnerFULL_POSIX_ENABLED               0
 #define testrunnerFULL_SHADOW_ENABLED              0
+#define testrunnerFULL_SPSC_RING_ENABLED           0
+#define testrunnerFULL_TASKPOOL_ENABLED            0
+#define testrunnerFULL_TRACE_RING_ENABLED          0
 #define testrunnerFULL_TCP_ENABLED                 1
 #define testrunnerFULL_TLS_ENABLED                 0
 #define testrunnerFULL_MEMORYLEAK_ENABLED          0
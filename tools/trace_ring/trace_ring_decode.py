@@ -0,0 +1,303 @@
+#!/usr/bin/env python
+
+"""Decodes a dump written by TRACERING_Dump(), see lib/include/aws_trace_ring.h.
+
+Prints, for the time covered by the dump:
+  * the scheduler latency, from a task becoming ready to it running, as a
+    histogram per priority,
+  * the longest delays of a preemption, where a task became ready with a
+    higher priority than the running task but did not run at once, which
+    points at long critical sections and long periods with the scheduler
+    suspended,
+  * the blocking periods during which a mutex holder inherited the priority
+    of the blocked task, with the tasks that ran in the meantime,
+  * the CPU time of each task, and a timeline of it.
+"""
+
+import argparse
+import collections
+import struct
+import sys
+
+MAGIC = 0x52545246
+
+EVENT_TASK_SWITCHED_IN = 1
+EVENT_TASK_READY = 2
+EVENT_QUEUE_SEND = 3
+EVENT_BLOCKING_ON_QUEUE_RECEIVE = 4
+EVENT_BLOCKING_ON_QUEUE_PEEK = 5
+EVENT_BLOCKING_ON_QUEUE_SEND = 6
+EVENT_BLOCKING_ON_STREAM_BUFFER_RECEIVE = 7
+EVENT_BLOCKING_ON_STREAM_BUFFER_SEND = 8
+EVENT_MALLOC = 9
+EVENT_FREE = 10
+EVENT_PRIORITY_INHERIT = 11
+EVENT_PRIORITY_DISINHERIT = 12
+
+BLOCKING_EVENTS = (
+    EVENT_BLOCKING_ON_QUEUE_RECEIVE,
+    EVENT_BLOCKING_ON_QUEUE_PEEK,
+    EVENT_BLOCKING_ON_QUEUE_SEND,
+    EVENT_BLOCKING_ON_STREAM_BUFFER_RECEIVE,
+    EVENT_BLOCKING_ON_STREAM_BUFFER_SEND,
+)
+
+# Shades used by the timeline, from idle to busy.
+TIMELINE_SHADES = ' .:-=#'
+
+Record = collections.namedtuple('Record', 'time task event arg1 arg2')
+
+
+class Dump():
+
+    def __init__(self, data):
+        if len(data) < 24:
+            raise ValueError('dump too short for a header')
+
+        if struct.unpack_from('<I', data)[0] == MAGIC:
+            order = '<'
+        elif struct.unpack_from('>I', data)[0] == MAGIC:
+            order = '>'
+        else:
+            raise ValueError('not a trace ring dump')
+
+        (_, version, record_size, self.hz, record_count, self.lost,
+         task_count, name_length) = struct.unpack_from(order + 'IHHIIIHH', data)
+        if version != 1 or record_size != 16:
+            raise ValueError('unsupported dump version %d' % version)
+
+        offset = 24
+        self.names = {0: '(none)'}
+        self.priorities = {}
+        for _ in range(task_count):
+            number, priority = struct.unpack_from(order + 'II', data, offset)
+            offset += 8
+            name = data[offset:offset + name_length].split(b'\0')[0]
+            offset += name_length
+            self.names[number] = name.decode('ascii', 'replace')
+            self.priorities[number] = priority
+
+        if len(data) < offset + record_count * record_size:
+            raise ValueError('dump truncated')
+
+        self.records = []
+        for _ in range(record_count):
+            time, task, event, _, arg1, arg2 = struct.unpack_from(order + 'IHBBII', data, offset)
+            offset += record_size
+            self.records.append(Record(time, task, event, arg1, arg2))
+
+        # Timestamps are 32 bits and wrap, so make them relative to the first
+        # record and monotonic.
+        if self.records:
+            start = self.records[0].time
+            elapsed = 0
+            previous = start
+            unwrapped = []
+            for record in self.records:
+                elapsed += (record.time - previous) & 0xFFFFFFFF
+                previous = record.time
+                unwrapped.append(record._replace(time=elapsed))
+            self.records = unwrapped
+
+    def name(self, task):
+        return self.names.get(task, '#%d' % task)
+
+    def microseconds(self, ticks):
+        return ticks * 1000000.0 / self.hz
+
+
+def latency_histograms(dump):
+    """Ready to running latency, keyed by the priority of the ready task."""
+    ready_since = {}
+    histograms = collections.defaultdict(collections.Counter)
+    worst = {}
+    running = None
+
+    for record in dump.records:
+        # A running task is moved within the ready lists when its priority
+        # changes, which is not a wakeup.
+        if record.event == EVENT_TASK_READY and record.task != running:
+            ready_since.setdefault(record.task, (record.time, record.arg1))
+        elif record.event == EVENT_TASK_SWITCHED_IN:
+            running = record.task
+            if record.task not in ready_since:
+                continue
+            time, priority = ready_since.pop(record.task)
+            latency = dump.microseconds(record.time - time)
+            bucket = 0
+            while (1 << bucket) <= latency:
+                bucket += 1
+            histograms[priority][bucket] += 1
+            if latency > worst.get(priority, (-1, 0))[0]:
+                worst[priority] = (latency, record.task)
+
+    return histograms, worst
+
+
+def preemption_delays(dump):
+    """Ready events that should have preempted the running task at once."""
+    delays = []
+    running = None
+    running_priority = 0
+    pending = {}
+
+    for record in dump.records:
+        if record.event == EVENT_TASK_SWITCHED_IN:
+            running = record.task
+            running_priority = record.arg1
+            if record.task in pending:
+                time, blocker = pending.pop(record.task)
+                delays.append((dump.microseconds(record.time - time), record.task, blocker))
+        elif record.event == EVENT_TASK_READY and running is not None and record.task != running:
+            if record.arg1 > running_priority and record.task not in pending:
+                pending[record.task] = (record.time, running)
+        elif record.event == EVENT_PRIORITY_INHERIT and record.task == running:
+            running_priority = record.arg1
+
+    delays.sort(reverse=True)
+    return delays
+
+
+def inversions(dump):
+    """Blocking periods during which the blocked task's priority was lent."""
+    blocked = {}
+    found = []
+    running = None
+    running_since = 0
+
+    for record in dump.records:
+        if record.event == EVENT_TASK_SWITCHED_IN:
+            for state in blocked.values():
+                if running is not None:
+                    state['ran'][running] += record.time - max(running_since, state['since'])
+            running = record.task
+            running_since = record.time
+        elif record.event in BLOCKING_EVENTS:
+            blocked[record.task] = {'since': record.time, 'object': record.arg1,
+                                    'holder': None, 'ran': collections.Counter()}
+        elif record.event == EVENT_PRIORITY_INHERIT:
+            # The inheritance happens in the context of the task that blocks.
+            if running in blocked:
+                blocked[running]['holder'] = record.task
+        elif record.event == EVENT_TASK_READY and record.task in blocked:
+            state = blocked.pop(record.task)
+            if state['holder'] is not None:
+                if running is not None:
+                    state['ran'][running] += record.time - max(running_since, state['since'])
+                found.append((dump.microseconds(record.time - state['since']),
+                              record.task, state))
+
+    found.sort(key=lambda item: item[0], reverse=True)
+    return found
+
+
+def cpu_time(dump, width):
+    """Run time of each task, in total and in width equal slices."""
+    totals = collections.Counter()
+    slices = collections.defaultdict(lambda: [0] * width)
+    switches = [record for record in dump.records if record.event == EVENT_TASK_SWITCHED_IN]
+    if len(switches) < 2:
+        return totals, slices, 0
+
+    start = switches[0].time
+    span = max(switches[-1].time - start, 1)
+    slice_length = float(span) / width
+
+    for current, following in zip(switches, switches[1:]):
+        totals[current.task] += following.time - current.time
+        begin = current.time - start
+        end = following.time - start
+        while begin < end:
+            index = min(int(begin / slice_length), width - 1)
+            boundary = min(end, (index + 1) * slice_length)
+            if boundary <= begin:
+                boundary = end
+            slices[current.task][index] += boundary - begin
+            begin = boundary
+
+    return totals, slices, span
+
+
+def print_report(dump, top, width):
+    print('%d records, %d lost, %.0f us covered' % (
+        len(dump.records), dump.lost,
+        dump.microseconds(dump.records[-1].time) if dump.records else 0))
+
+    histograms, worst = latency_histograms(dump)
+    print('\nScheduler latency, ready to running, in microseconds:')
+    for priority in sorted(histograms, reverse=True):
+        histogram = histograms[priority]
+        total = sum(histogram.values())
+        latency, task = worst[priority]
+        print('  priority %d: %d wakeups, worst %.0f (%s)' % (priority, total, latency, dump.name(task)))
+        for bucket in sorted(histogram):
+            low = 0 if bucket == 0 else 1 << (bucket - 1)
+            bar = '*' * max(1, 40 * histogram[bucket] // total)
+            print('    %7d - %-7d %6d %s' % (low, 1 << bucket, histogram[bucket], bar))
+
+    print('\nLongest preemption delays, in microseconds:')
+    for latency, task, blocker in preemption_delays(dump)[:top]:
+        print('  %10.0f  %s waited for %s' % (latency, dump.name(task), dump.name(blocker)))
+
+    print('\nBlocking with priority inheritance, in microseconds:')
+    for latency, task, state in inversions(dump)[:top]:
+        ran = ', '.join('%s %.0f' % (dump.name(other), dump.microseconds(ticks))
+                        for other, ticks in state['ran'].most_common() if other != task)
+        print('  %10.0f  %s on 0x%08x held by %s; ran meanwhile: %s' % (
+            latency, dump.name(task), state['object'], dump.name(state['holder']), ran or 'none'))
+
+    totals, slices, span = cpu_time(dump, width)
+    if span:
+        print('\nCPU time per task, and over time (%.0f us per column):' % (dump.microseconds(span) / width))
+        slice_length = float(span) / width
+        for task, ticks in totals.most_common():
+            line = ''.join(TIMELINE_SHADES[min(int(share / slice_length * (len(TIMELINE_SHADES) - 1) + 0.999),
+                                               len(TIMELINE_SHADES) - 1)]
+                           for share in slices[task])
+            print('  %-16s %5.1f%% |%s|' % (dump.name(task), 100.0 * ticks / span, line))
+
+
+def print_records(dump):
+    names = {
+        EVENT_TASK_SWITCHED_IN: 'switched in',
+        EVENT_TASK_READY: 'ready',
+        EVENT_QUEUE_SEND: 'queue send',
+        EVENT_BLOCKING_ON_QUEUE_RECEIVE: 'block on queue receive',
+        EVENT_BLOCKING_ON_QUEUE_PEEK: 'block on queue peek',
+        EVENT_BLOCKING_ON_QUEUE_SEND: 'block on queue send',
+        EVENT_BLOCKING_ON_STREAM_BUFFER_RECEIVE: 'block on stream buffer receive',
+        EVENT_BLOCKING_ON_STREAM_BUFFER_SEND: 'block on stream buffer send',
+        EVENT_MALLOC: 'malloc',
+        EVENT_FREE: 'free',
+        EVENT_PRIORITY_INHERIT: 'priority inherit',
+        EVENT_PRIORITY_DISINHERIT: 'priority disinherit',
+    }
+    for record in dump.records:
+        print('%12.1f  %-16s %-30s 0x%08x %d' % (
+            dump.microseconds(record.time), dump.name(record.task),
+            names.get(record.event, 'event %d' % record.event), record.arg1, record.arg2))
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Decode a trace ring dump.')
+    parser.add_argument('dump', help='the binary dump written by TRACERING_Dump()')
+    parser.add_argument('--records', action='store_true', help='list every record instead of the report')
+    parser.add_argument('--top', type=int, default=10, help='entries in the lists of worst cases')
+    parser.add_argument('--width', type=int, default=64, help='columns in the timeline')
+    args = parser.parse_args()
+
+    with open(args.dump, 'rb') as file:
+        try:
+            dump = Dump(file.read())
+        except ValueError as error:
+            print('%s: %s' % (args.dump, error))
+            sys.exit(1)
+
+    if args.records:
+        print_records(dump)
+    else:
+        print_report(dump, args.top, args.width)
+
+
+if __name__ == '__main__':
+    main()